@@ -26,6 +26,7 @@
 #define ACTIONS_MAP_H
 
 
+#include <string>
 #include <unordered_map>
 #include <vector>
 
@@ -34,6 +35,60 @@
 
 #include "../states/state.h"
 
+class ActionsMap;
+
+/**
+ * An iterator over the actions of an ActionsMap, in the order they were added. Each action is obtained
+ * from ActionsMap::get_action(), so sets of actions which are not stored explicitly may create them on demand.
+ */
+class ActionsMapIterator {
+public:
+	/**
+	 * The constructor for the ActionsMapIterator class.
+	 * @param	actionsMap	The set of actions.
+	 * @param	index		The index of the current action.
+	 */
+	ActionsMapIterator(const ActionsMap *actionsMap, unsigned int index);
+
+	/**
+	 * Get the current action.
+	 * @return	The current action.
+	 */
+	Action *operator*() const;
+
+	/**
+	 * Move to the next action.
+	 * @return	This iterator.
+	 */
+	ActionsMapIterator &operator++();
+
+	/**
+	 * Check if two iterators refer to the same action of the same set.
+	 * @param	other	The other iterator.
+	 * @return	Returns @code{true} if they are equal; @code{false} otherwise.
+	 */
+	bool operator==(const ActionsMapIterator &other) const;
+
+	/**
+	 * Check if two iterators refer to different actions.
+	 * @param	other	The other iterator.
+	 * @return	Returns @code{true} if they are different; @code{false} otherwise.
+	 */
+	bool operator!=(const ActionsMapIterator &other) const;
+
+private:
+	/**
+	 * The set of actions.
+	 */
+	const ActionsMap *actionsMap;
+
+	/**
+	 * The index of the current action.
+	 */
+	unsigned int index;
+
+};
+
 /**
  * A class for finite sets of actions in an MDP-like object. Informally, there are two basic ways to
  * store finite actions: a vector of actions or a generator function based on a state. In both cases,
@@ -43,6 +98,9 @@
  * If you want to create a generator function-based FiniteActions class, please create a child class
  * which implements the function in the virtual functions described below. You will likely ignore the
  * internal actions vector variable here.
+ *
+ * The lookup functions are virtual, and iteration goes through get_action(), so that a child class may
+ * describe its actions implicitly (e.g., JointActionsMap) instead of storing them.
  */
 class ActionsMap : virtual public Actions {
 public:
@@ -87,7 +145,7 @@ public:
 	 * @param	action		The action to check if it is created or not.
 	 * @return	Returns @code{true} if the action exists in the actions hash; @code{false} otherwise.
 	 */
-	bool exists(Action *action) const;
+	virtual bool exists(Action *action) const;
 
 	/**
 	 * Get an action with a particular hash value.
@@ -95,20 +153,59 @@ public:
 	 * @throw	ActionException		There are no actions with the hash value specified.
 	 * @return	The action with the particular hash value specified.
 	 */
-	Action *get(unsigned int hash);
+	virtual Action *get(unsigned int hash);
+
+	/**
+	 * Get a action by its name. The name of a joint action is the names of its parts separated by spaces.
+	 * Names are recorded as actions are added, so this lookup takes constant time.
+	 * @param	name				The name of the action.
+	 * @throw	ActionException		There is no action with the name specified.
+	 * @return	The action with the name specified.
+	 */
+	virtual Action *get_by_name(const std::string &name) const;
 
 	/**
 	 * Return the number of actions.
 	 * @return	The number of actions.
 	 */
-	unsigned int get_num_actions() const;
+	virtual unsigned int get_num_actions() const;
 
 	/**
-	 * Return a list of the actions available given a state.
+	 * Get the action with a particular index, i.e., its position in the order the actions were added.
+	 * @param	index				The index of the action, in 0, ..., m-1.
+	 * @throw	ActionException		The index is out of bounds.
+	 * @return	The action with the index specified.
+	 */
+	virtual Action *get_action(unsigned int index) const;
+
+	/**
+	 * Return a list of the actions available given a state. This is the list set by set_available
+	 * for the state, or all of the actions otherwise. No copy is made, so solvers may call this for
+	 * every backup; the list remains valid until the actions or the state's available actions change.
 	 * @param	state	The current state.
 	 * @return	Return a list of available actions.
 	 */
-	virtual std::unordered_map<unsigned int, Action *> available(State *state);
+	virtual const std::vector<Action *> &available(State *state);
+
+	/**
+	 * Set the actions available in a state, for models in which not every action may be taken in every
+	 * state. By default, every action is available in every state.
+	 * @param	state				The state.
+	 * @param	availableActions	The actions available in the state, each of which must exist.
+	 * @throw	ActionException		An action was not in the set of actions.
+	 */
+	void set_available(State *state, const std::vector<Action *> &availableActions);
+
+	/**
+	 * Check if the available actions of any state have been restricted by set_available.
+	 * @return	Returns @code{true} if some state has its own available actions; @code{false} otherwise.
+	 */
+	bool has_state_dependent_actions() const;
+
+	/**
+	 * Make every action available in every state again, undoing set_available.
+	 */
+	void reset_available();
 
 	/**
 	 * Reset the actions, clearing the internal list.
@@ -116,16 +213,17 @@ public:
 	virtual void reset();
 
 	/**
-	 * To facilitate easy iteration, return a constant beginning of the actions vector.
-	 * @return	The iterator which points to a constant beginning of the actions vector.
+	 * To facilitate easy iteration, return an iterator to the first action. Actions are visited in
+	 * the order they were added.
+	 * @return	The iterator which points to the first action.
 	 */
-	std::unordered_map<unsigned int, Action *>::iterator begin();
+	ActionsMapIterator begin() const;
 
 	/**
-	 * To facilitate easy iteration, return a constant end of the actions vector.
-	 * @return	The iterator which points to a constant end of the actions vector.
+	 * To facilitate easy iteration, return an iterator past the last action.
+	 * @return	The iterator which points past the last action.
 	 */
-	std::unordered_map<unsigned int, Action *>::iterator end();
+	ActionsMapIterator end() const;
 
 protected:
 	/**
@@ -133,6 +231,42 @@ protected:
 	 */
 	std::unordered_map<unsigned int, Action *> actions;
 
+	/**
+	 * The list of all the actions, in the order they were added, returned by available for any state
+	 * without its own list.
+	 */
+	std::vector<Action *> allActions;
+
+	/**
+	 * The lists of actions available in particular states, set by set_available.
+	 */
+	std::unordered_map<State *, std::vector<Action *> > stateActions;
+
+
+	/**
+	 * Record the name of a action, if it has one, so that it can be found with get_by_name().
+	 * @param	action	The action to record.
+	 */
+	void add_name(Action *action);
+
+	/**
+	 * Forget the name of a action, if it was recorded.
+	 * @param	action	The action to forget.
+	 */
+	void remove_name(Action *action);
+
+	/**
+	 * Compute the name of a action. Only a NamedAction, or a JointAction made of them, has a name.
+	 * @param	action	The action to name.
+	 * @param	name	The name of the action. This will be modified.
+	 * @return	Returns @code{true} if the action has a name; @code{false} otherwise.
+	 */
+	static bool get_name(Action *action, std::string &name);
+
+	/**
+	 * The mapping of names to actions.
+	 */
+	std::unordered_map<std::string, Action *> names;
 };
 
 /**
@@ -147,6 +281,18 @@ Action *resolve(std::unordered_map<unsigned int, Action *>::value_type &actionIt
  */
 unsigned int hash_value(std::unordered_map<unsigned int, Action *>::value_type &actionIterator);
 
+/**
+ * Get the action pointer of an action iterator.
+ * @param	actionIterator	The action iterator to retrieve the action pointer from.
+ */
+Action *resolve(Action *actionIterator);
+
+/**
+ * Get the hash of an action iterator.
+ * @param	actionIterator	The action iterator to retrieve the hash value from.
+ */
+unsigned int hash_value(Action *actionIterator);
+
 
 
 #endif // ACTIONS_MAP_H
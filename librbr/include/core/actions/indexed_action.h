@@ -30,9 +30,12 @@
 
 #include "action.h"
 
+#include "../indexer.h"
+
 /**
  * An action object identified by a unique index which is determined using a static variable,
- * incremented each time a new IndexedAction is created.
+ * incremented each time a new IndexedAction is created, or using an Indexer
+ * provided to the constructor.
  */
 class IndexedAction : virtual public Action {
 public:
@@ -41,6 +44,20 @@ public:
 	 */
 	IndexedAction();
 
+	/**
+	 * The constructor of the IndexedAction object which takes its index from an indexer owned by the
+	 * caller, such as one per model, instead of the shared static indexer.
+	 * @param	modelIndexer	The indexer which assigns the index of this action.
+	 */
+	IndexedAction(Indexer &modelIndexer);
+
+	/**
+	 * The constructor of the IndexedAction object which uses a specific index. The static indexer
+	 * is not modified.
+	 * @param	initialIndex	The index of this action.
+	 */
+	IndexedAction(unsigned int initialIndex);
+
 	/**
 	 * The copy constructor of the IndexedAction object.
 	 * @param	other		The action to copy.
@@ -96,9 +113,10 @@ protected:
 	unsigned int index;
 
 	/**
-	 * A static variable which assigns indexes to the actions. This defaults to zero.
+	 * A static variable which assigns indexes to the actions. This defaults to zero. Prefer an
+	 * indexer owned by the model when several models may be created at once.
 	 */
-	static unsigned int indexer;
+	static Indexer indexer;
 
 };
 
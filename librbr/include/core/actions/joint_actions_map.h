@@ -31,6 +31,13 @@
 #include "action.h"
 #include "actions.h"
 #include "actions_map.h"
+#include "joint_action.h"
+
+#include <string>
+#include <unordered_map>
+#include <mutex>
+
+#include "../../utilities/lazy_table.h"
 
 /**
  * A class for finite sets of joint actions in an MDP-like object. Informally, there are two basic ways to
@@ -42,7 +49,14 @@
  * implements the function in the virtual functions described below. You will likely ignore the internal
  * states vector variable here.
  *
- * Note: The protected "states" variable implicitly must only store JointState objects, not State objects.
+ * The joint actions are never stored as a full cross product. Each is identified by a compact
+ * mixed-radix index over the factors, with the first factor the most significant, and the parts of a
+ * joint action are decoded from its index arithmetically. Iteration and lookups work on the index;
+ * a JointAction object is created the first time a particular joint action is returned, and kept (so
+ * pointers to it remain valid) until the next update() or reset(). The created joint actions are held in
+ * a lock-free table, so they may be looked up and created by several threads at once.
+ *
+ * Note that iterating over the joint actions materializes every joint action visited.
  */
 class JointActionsMap : virtual public ActionsMap {
 public:
@@ -98,18 +112,82 @@ public:
 	Action *get(unsigned int factorIndex, unsigned int actionIndex);
 
 	/**
-	 * Update the internal actions list which holds all permutations of joint actions in an efficient structure.
+	 * Update the description of the joint actions, i.e., the index of each action within its factor.
 	 * Note: This *must* be called after sequences of add(), remove(), and/or set() calls.
-	 * @throw	ActionException		If a action factor has not been defined.
+	 * @throw	ActionException		A factor has not been defined, or there are too many joint actions.
 	 */
 	void update();
 
+	/**
+	 * Check if a joint action is one of these joint actions, i.e., each of its parts is in its factor.
+	 * @param	action		The action to check.
+	 * @return	Returns @code{true} if the joint action exists; @code{false} otherwise.
+	 */
+	virtual bool exists(Action *action) const;
+
+	/**
+	 * Get a joint action with a particular hash value, without creating the joint actions which do not
+	 * match. As in FactoredStatesMap, the factors are split into a prefix and a suffix with about the
+	 * square root of the number of joint actions each, and the suffix of each prefix is solved for in a
+	 * table of the suffix hashes.
+	 * @param	hash				The hash of the joint action.
+	 * @throw	ActionException		There are no joint actions with the hash value specified.
+	 * @return	The joint action with the lowest index and the particular hash value specified.
+	 */
+	virtual Action *get(unsigned int hash);
+
+	/**
+	 * Get a joint action by its name, i.e., the names of its parts separated by spaces.
+	 * @param	name				The name of the joint action.
+	 * @throw	ActionException		There is no joint action with the name specified.
+	 * @return	The joint action with the name specified.
+	 */
+	virtual Action *get_by_name(const std::string &name) const;
+
+	/**
+	 * Get the mixed-radix index of a joint action.
+	 * @param	action				The joint action to find.
+	 * @throw	ActionException		The action is not a joint action with each part in its factor.
+	 * @return	The index of the joint action.
+	 */
+	unsigned int get_index(const Action *action) const;
+
+	/**
+	 * Get the joint action with a particular mixed-radix index, creating it if needed.
+	 * @param	index				The index of the joint action.
+	 * @throw	ActionException		The index is out of bounds.
+	 * @return	The joint action with the index specified.
+	 */
+	virtual Action *get_action(unsigned int index) const;
+
+	/**
+	 * Return the number of joint actions, i.e., the product of the factor sizes.
+	 * @return	The number of joint actions.
+	 */
+	virtual unsigned int get_num_actions() const;
+
+	/**
+	 * Return the list of available actions, given the state. Unlike the other lookups, this requires a
+	 * list of every joint action, so it is only created (once) the first time it is called.
+	 * @param	state	The state to get the available actions.
+	 * @return	The list of available actions.
+	 */
+	virtual const std::vector<Action *> &available(State *state);
+
 	/**
 	 * Get the number of factored actions.
 	 * @return	The number of factored actions.
 	 */
 	unsigned int get_num_factors();
 
+	/**
+	 * Get the list of actions available in a particular factor, in the order they were added.
+	 * @param	factorIndex			The index of the factor.
+	 * @throw	ActionException		The index was invalid.
+	 * @return	The list of actions within the factor.
+	 */
+	const std::vector<Action *> &get_factor(unsigned int factorIndex);
+
 	/**
 	 * Reset the joint actions, clearing the internal list and freeing the memory.
 	 */
@@ -123,11 +201,34 @@ protected:
 
 private:
 	/**
-	 * A helper function for updating the internal "actions" variable as part of the update() function.
-	 * @param	currentJointAction		The current (incomplete) joint action as a vector of actions.
-	 * @param	currentFactorIndex		The current factor index.
+	 * Free the joint actions which have been created, without freeing the actions of the factors.
+	 */
+	void clear_created();
+
+	/**
+	 * For each factor, the index of each of its actions.
+	 */
+	std::vector<std::unordered_map<const Action *, unsigned int> > factorIndexes;
+
+	/**
+	 * For each factor, the index of each of its actions by name.
+	 */
+	std::vector<std::unordered_map<std::string, unsigned int> > factorNames;
+
+	/**
+	 * The number of joint actions, as of the last update().
+	 */
+	unsigned int numJointActions;
+
+	/**
+	 * The joint actions which have been created, by index, in a lock-free table.
+	 */
+	mutable LazyTable<JointAction> created;
+
+	/**
+	 * A mutex which protects the list of all joint actions while it is created in available().
 	 */
-	void update_step(std::vector<Action *> currentJointAction, unsigned int currentFactorIndex);
+	std::mutex availableMutex;
 
 };
 
@@ -0,0 +1,87 @@
+/**
+ *  The MIT License (MIT)
+ *
+ *  Copyright (c) 2014 Kyle Hollins Wray, University of Massachusetts
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy of
+ *  this software and associated documentation files (the "Software"), to deal in
+ *  the Software without restriction, including without limitation the rights to
+ *  use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ *  the Software, and to permit persons to whom the Software is furnished to do so,
+ *  subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included in all
+ *  copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ *  FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ *  COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ *  IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ *  CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+
+#ifndef INDEXER_H
+#define INDEXER_H
+
+
+#include <atomic>
+
+/**
+ * An allocator of consecutive indexes 0, 1, 2, ..., used to number indexed states, actions, and
+ * observations. Each model (or any other registry of objects) may own its own indexer, so that models
+ * can be created concurrently in different threads. Allocation is thread-safe.
+ */
+class Indexer {
+public:
+	/**
+	 * The default constructor for the Indexer class. The first index allocated is zero.
+	 */
+	Indexer();
+
+	/**
+	 * The default deconstructor for the Indexer class.
+	 */
+	virtual ~Indexer();
+
+	/**
+	 * Allocate the next index.
+	 * @return	The next index.
+	 */
+	unsigned int next();
+
+	/**
+	 * Get the number of indexes which have been allocated.
+	 * @return	The number of indexes which have been allocated.
+	 */
+	unsigned int get_num_indexes() const;
+
+	/**
+	 * Reset the indexer so that the next index allocated is zero.
+	 */
+	void reset();
+
+private:
+	/**
+	 * Indexers may not be copied, since two copies would allocate the same indexes.
+	 * @param	other	The indexer to copy.
+	 */
+	Indexer(const Indexer &other);
+
+	/**
+	 * Indexers may not be assigned, since two copies would allocate the same indexes.
+	 * @param	other	The indexer to copy.
+	 * @return	This indexer.
+	 */
+	Indexer &operator=(const Indexer &other);
+
+	/**
+	 * The next index to allocate.
+	 */
+	std::atomic<unsigned int> counter;
+
+};
+
+
+#endif // INDEXER_H
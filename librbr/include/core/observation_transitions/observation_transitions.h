@@ -33,6 +33,8 @@
 
 #include "../states/state.h"
 #include "../actions/action.h"
+#include "../actions/actions.h"
+#include "../states/states.h"
 
 /**
  * An abstract class which defines how to interact with a observation transitions object.
@@ -69,7 +71,7 @@ public:
 	 * @param	observation			The next observation to which we assign a probability.
 	 * @return	The probability of the observation given we took the action and landed in the state given.
 	 */
-	virtual double get(Action *previousAction, State *state, Observation *observation) = 0;
+	virtual double get(Action *previousAction, State *state, Observation *observation) const = 0;
 
 	/**
 	 * Return a list of the observations available given a previous state and the action taken there.
@@ -80,6 +82,23 @@ public:
 	 */
 	virtual const std::vector<Observation *> &available(Observations *Z, Action *previousAction, State *state) = 0;
 
+	/**
+	 * Freeze the observation transitions so that they are read-only. Every lazily computed list of available
+	 * observations is computed now, in parallel, so afterwards get() and available() never modify the object
+	 * and may be called from many threads at once. Modifying a frozen object throws; reset() unfreezes it.
+	 * @param	Z		The set of observations.
+	 * @param	A		The set of actions.
+	 * @param	S		The set of states.
+	 * @throw	ObservationTransitionException	An error occurred. Please see child class definitions for specifics.
+	 */
+	virtual void freeze(Observations *Z, Actions *A, States *S) = 0;
+
+	/**
+	 * Check if the observation transitions have been frozen.
+	 * @return	Returns @code{true} if the observation transitions are read-only; @code{false} otherwise.
+	 */
+	virtual bool is_frozen() const = 0;
+
 };
 
 
@@ -39,6 +39,7 @@
 
 #include "../actions/action.h"
 #include "../actions/indexed_action.h"
+#include "../actions/actions.h"
 
 /**
  * A class for finite observation transitions in an MDP-like object. Informally, there are two basic ways to
@@ -87,7 +88,7 @@ public:
 	 * @throw	ObservationTransitionException	Either the state, action, or observation was invalid.
 	 * @return	The probability of the observation given we took the action and landed in the state given.
 	 */
-	virtual double get(Action *previousAction, State *state, Observation *observation);
+	virtual double get(Action *previousAction, State *state, Observation *observation) const;
 
 	/**
 	 * Add an available observation.
@@ -120,6 +121,24 @@ public:
 	 */
 	virtual float *get_observation_transitions();
 
+	/**
+	 * Get the probability of an observation by the indexes of the action, state, and observation. Unlike
+	 * the virtual get(), this does not check the types of the objects or the bounds, so it may be inlined.
+	 * @param	a		The index of the previous action, less than get_num_actions().
+	 * @param	sp		The index of the state, less than get_num_states().
+	 * @param	z		The index of the observation, less than get_num_observations().
+	 * @return	The probability of the observation given that we were in the state and took the action.
+	 */
+	float get(unsigned int a, unsigned int sp, unsigned int z) const;
+
+	/**
+	 * Get the probabilities of each observation, by the indexes of the action and state.
+	 * @param	a		The index of the previous action, less than get_num_actions().
+	 * @param	sp		The index of the state, less than get_num_states().
+	 * @return	A pointer to get_num_observations() probabilities, in the order of the observation indexes.
+	 */
+	const float *get_row(unsigned int a, unsigned int sp) const;
+
 	/**
 	 * Get the number of states used for the observation transitions array.
 	 * @return	The number of states.
@@ -138,6 +157,23 @@ public:
 	 */
 	virtual unsigned int get_num_observations() const;
 
+	/**
+	 * Freeze the observation transitions so that they are read-only. The available observations of every
+	 * action-state pair are computed in parallel. Afterwards, get() and available() do not modify the
+	 * object, and set() or add_available() throw.
+	 * @param	Z								The set of observations.
+	 * @param	A								The set of actions.
+	 * @param	S								The set of states.
+	 * @throw	ObservationTransitionException	The observations, actions, or states are not of a supported type.
+	 */
+	virtual void freeze(Observations *Z, Actions *A, States *S);
+
+	/**
+	 * Check if the observation transitions have been frozen.
+	 * @return	Returns @code{true} if the observation transitions are read-only; @code{false} otherwise.
+	 */
+	virtual bool is_frozen() const;
+
 	/**
 	 * Reset the observation transitions by assigning all probabilities to zero. This does not free memory.
 	 */
@@ -148,10 +184,10 @@ private:
 	 * Compute the available observations for the action and state pair provided, then store the result
 	 * in availableObservations.
 	 * @param	Z							The finite set of observations.
-	 * @param	a							The current action.
-	 * @param	sp							The next state.
+	 * @param	a							The index of the current action.
+	 * @param	sp							The index of the next state.
 	 */
-	virtual void compute_available(ObservationsMap *Z, IndexedAction *a, IndexedState *sp);
+	virtual void compute_available(ObservationsMap *Z, unsigned int a, unsigned int sp);
 
 	/**
 	 * The 3-dimensional array of all action-state-observation transitions. Internally,
@@ -179,7 +215,23 @@ private:
 	 */
 	std::vector<Observation *> *availableObservations;
 
+	/**
+	 * Whether or not the observation transitions are read-only. See freeze().
+	 */
+	bool frozen;
+
 };
 
 
+inline float ObservationTransitionsArray::get(unsigned int a, unsigned int sp, unsigned int z) const
+{
+	return observationTransitions[(a * states + sp) * observations + z];
+}
+
+inline const float *ObservationTransitionsArray::get_row(unsigned int a, unsigned int sp) const
+{
+	return observationTransitions + (a * states + sp) * observations;
+}
+
+
 #endif // OBSERVATION_TRANSITIONS_ARRAY_H
@@ -36,8 +36,10 @@
 #include "../observations/observation.h"
 
 #include "../states/state.h"
+#include "../states/states.h"
 
 #include "../actions/action.h"
+#include "../actions/actions.h"
 
 /**
  * A class for finite observation transitions in an MDP-like object. Informally, there are two basic ways to
@@ -77,7 +79,7 @@ public:
 	 * @param	observation			The next observation to which we assign a probability.
 	 * @return	The probability of the observation given we took the action and landed in the state given.
 	 */
-	virtual double get(Action *previousAction, State *state, Observation *observation);
+	virtual double get(Action *previousAction, State *state, Observation *observation) const;
 
 	/**
 	 * Add an available observation.
@@ -97,6 +99,23 @@ public:
 	 */
 	virtual const std::vector<Observation *> &available(Observations *Z, Action *previousAction, State *state);
 
+	/**
+	 * Freeze the observation transitions so that they are read-only. The available observations of every
+	 * action-state pair are computed in parallel. Afterwards, get() and available() do not modify the
+	 * object, and set() or add_available() throw.
+	 * @param	Z								The set of observations.
+	 * @param	A								The set of actions.
+	 * @param	S								The set of states.
+	 * @throw	ObservationTransitionException	The observations, actions, or states are not of a supported type.
+	 */
+	virtual void freeze(Observations *Z, Actions *A, States *S);
+
+	/**
+	 * Check if the observation transitions have been frozen.
+	 * @return	Returns @code{true} if the observation transitions are read-only; @code{false} otherwise.
+	 */
+	virtual bool is_frozen() const;
+
 	/**
 	 * Reset the observation transitions, clearing the internal mapping.
 	 */
@@ -112,7 +131,7 @@ private:
 	 * @throw	ObservationTransitionException 	The observation transition was not defined.
 	 * @return	The probability of the observation given we took the action and landed in the state given.
 	 */
-	virtual double get_value(Action *previousAction, State *state, Observation *observation);
+	virtual double get_value(Action *previousAction, State *state, Observation *observation) const;
 
 	/**
 	 * Compute the available observations for the action and state pair provided, then store the result
@@ -151,6 +170,11 @@ private:
 	 */
 	std::unordered_map<Action *, std::unordered_map<State *, std::vector<Observation *> > > availableObservations;
 
+	/**
+	 * Whether or not the observation transitions are read-only. See freeze().
+	 */
+	bool frozen;
+
 };
 
 
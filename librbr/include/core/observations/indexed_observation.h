@@ -30,9 +30,12 @@
 
 #include "observation.h"
 
+#include "../indexer.h"
+
 /**
  * A observation object identified by a unique index which is determined using a static variable,
- * incremented each time a new IndexedObservation is created.
+ * incremented each time a new IndexedObservation is created, or using an Indexer
+ * provided to the constructor.
  */
 class IndexedObservation : public Observation {
 public:
@@ -41,6 +44,20 @@ public:
 	 */
 	IndexedObservation();
 
+	/**
+	 * The constructor of the IndexedObservation object which takes its index from an indexer owned by the
+	 * caller, such as one per model, instead of the shared static indexer.
+	 * @param	modelIndexer	The indexer which assigns the index of this observation.
+	 */
+	IndexedObservation(Indexer &modelIndexer);
+
+	/**
+	 * The constructor of the IndexedObservation object which uses a specific index. The static indexer
+	 * is not modified.
+	 * @param	initialIndex	The index of this observation.
+	 */
+	IndexedObservation(unsigned int initialIndex);
+
 	/**
 	 * The copy constructor of the IndexedObservation object.
 	 * @param	other		The observation to copy.
@@ -95,9 +112,10 @@ protected:
 	unsigned int index;
 
 	/**
-	 * A static variable which assigns indexes to the observations. This defaults to zero.
+	 * A static variable which assigns indexes to the observations. This defaults to zero. Prefer an
+	 * indexer owned by the model when several models may be created at once.
 	 */
-	static unsigned int indexer;
+	static Indexer indexer;
 
 };
 
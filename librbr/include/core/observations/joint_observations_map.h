@@ -31,6 +31,12 @@
 #include "observation.h"
 #include "observations.h"
 #include "observations_map.h"
+#include "joint_observation.h"
+
+#include <string>
+#include <unordered_map>
+
+#include "../../utilities/lazy_table.h"
 
 /**
  * A class for finite sets of observations in an MDP-like object. Informally, there are two basic ways to
@@ -42,8 +48,14 @@
  * class which implements the function in the virtual functions described below. You will likely ignore the
  * internal observations vector variable here.
  *
- * Note: The protected "observations" variable implicitly must only store JointObservation objects, not
- * Observation objects.
+ * The joint observations are never stored as a full cross product. Each is identified by a compact
+ * mixed-radix index over the factors, with the first factor the most significant, and the parts of a
+ * joint observation are decoded from its index arithmetically. Iteration and lookups work on the index;
+ * a JointObservation object is created the first time a particular joint observation is returned, and kept (so
+ * pointers to it remain valid) until the next update() or reset(). The created joint observations are held in
+ * a lock-free table, so they may be looked up and created by several threads at once.
+ *
+ * Note that iterating over the joint observations materializes every joint observation visited.
  */
 
 class JointObservationsMap : public ObservationsMap {
@@ -100,17 +112,73 @@ public:
 	Observation *get(unsigned int factorIndex, unsigned int observationIndex);
 
 	/**
-	 * Update the internal observations list which holds all permutations of joint observations in an efficient structure.
+	 * Update the description of the joint observations, i.e., the index of each observation within its factor.
 	 * Note: This *must* be called after sequences of add(), remove(), and/or set() calls.
-	 * @throw	ObservationException	A state factor has not been defined.
+	 * @throw	ObservationException		A factor has not been defined, or there are too many joint observations.
 	 */
 	void update();
 
+	/**
+	 * Check if a joint observation is one of these joint observations, i.e., each of its parts is in its factor.
+	 * @param	observation		The observation to check.
+	 * @return	Returns @code{true} if the joint observation exists; @code{false} otherwise.
+	 */
+	virtual bool exists(Observation *observation);
+
+	/**
+	 * Get a joint observation with a particular hash value, without creating the joint observations which do not
+	 * match. As in FactoredStatesMap, the factors are split into a prefix and a suffix with about the
+	 * square root of the number of joint observations each, and the suffix of each prefix is solved for in a
+	 * table of the suffix hashes.
+	 * @param	hash				The hash of the joint observation.
+	 * @throw	ObservationException		There are no joint observations with the hash value specified.
+	 * @return	The joint observation with the lowest index and the particular hash value specified.
+	 */
+	virtual Observation *get(unsigned int hash);
+
+	/**
+	 * Get a joint observation by its name, i.e., the names of its parts separated by spaces.
+	 * @param	name				The name of the joint observation.
+	 * @throw	ObservationException		There is no joint observation with the name specified.
+	 * @return	The joint observation with the name specified.
+	 */
+	virtual Observation *get_by_name(const std::string &name) const;
+
+	/**
+	 * Get the mixed-radix index of a joint observation.
+	 * @param	observation				The joint observation to find.
+	 * @throw	ObservationException		The observation is not a joint observation with each part in its factor.
+	 * @return	The index of the joint observation.
+	 */
+	unsigned int get_index(const Observation *observation) const;
+
+	/**
+	 * Get the joint observation with a particular mixed-radix index, creating it if needed.
+	 * @param	index				The index of the joint observation.
+	 * @throw	ObservationException		The index is out of bounds.
+	 * @return	The joint observation with the index specified.
+	 */
+	virtual Observation *get_observation(unsigned int index) const;
+
+	/**
+	 * Return the number of joint observations, i.e., the product of the factor sizes.
+	 * @return	The number of joint observations.
+	 */
+	virtual unsigned int get_num_observations() const;
+
 	/**
 	 * Get the number of factored observations.
 	 */
 	unsigned int get_num_factors();
 
+	/**
+	 * Get the list of observations available in a particular factor, in the order they were added.
+	 * @param	factorIndex				The index of the factor.
+	 * @throw	ObservationException	The index was invalid.
+	 * @return	The list of observations within the factor.
+	 */
+	const std::vector<Observation *> &get_factor(unsigned int factorIndex);
+
 	/**
 	 * Reset the joint observations, clearing the internal list and freeing the memory.
 	 */
@@ -124,11 +192,29 @@ protected:
 
 private:
 	/**
-	 * A helper function for updating the internal "observations" variable as part of the update() function.
-	 * @param	currentJointObservation		The current (incomplete) joint observation as a vector of observations.
-	 * @param	currentFactorIndex			The current factor index.
+	 * Free the joint observations which have been created, without freeing the observations of the factors.
+	 */
+	void clear_created();
+
+	/**
+	 * For each factor, the index of each of its observations.
+	 */
+	std::vector<std::unordered_map<const Observation *, unsigned int> > factorIndexes;
+
+	/**
+	 * For each factor, the index of each of its observations by name.
+	 */
+	std::vector<std::unordered_map<std::string, unsigned int> > factorNames;
+
+	/**
+	 * The number of joint observations, as of the last update().
+	 */
+	unsigned int numJointObservations;
+
+	/**
+	 * The joint observations which have been created, by index, in a lock-free table.
 	 */
-	void update_step(std::vector<Observation *> currentJointObservation, unsigned int currentFactorIndex);
+	mutable LazyTable<JointObservation> created;
 
 };
 
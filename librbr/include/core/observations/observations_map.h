@@ -26,6 +26,7 @@
 #define OBSERVATIONS_MAP_H
 
 
+#include <string>
 #include <unordered_map>
 #include <vector>
 
@@ -35,6 +36,60 @@
 #include "../states/state.h"
 #include "../actions/action.h"
 
+class ObservationsMap;
+
+/**
+ * An iterator over the observations of an ObservationsMap, in the order they were added. Each observation is obtained
+ * from ObservationsMap::get_observation(), so sets of observations which are not stored explicitly may create them on demand.
+ */
+class ObservationsMapIterator {
+public:
+	/**
+	 * The constructor for the ObservationsMapIterator class.
+	 * @param	observationsMap	The set of observations.
+	 * @param	index		The index of the current observation.
+	 */
+	ObservationsMapIterator(const ObservationsMap *observationsMap, unsigned int index);
+
+	/**
+	 * Get the current observation.
+	 * @return	The current observation.
+	 */
+	Observation *operator*() const;
+
+	/**
+	 * Move to the next observation.
+	 * @return	This iterator.
+	 */
+	ObservationsMapIterator &operator++();
+
+	/**
+	 * Check if two iterators refer to the same observation of the same set.
+	 * @param	other	The other iterator.
+	 * @return	Returns @code{true} if they are equal; @code{false} otherwise.
+	 */
+	bool operator==(const ObservationsMapIterator &other) const;
+
+	/**
+	 * Check if two iterators refer to different observations.
+	 * @param	other	The other iterator.
+	 * @return	Returns @code{true} if they are different; @code{false} otherwise.
+	 */
+	bool operator!=(const ObservationsMapIterator &other) const;
+
+private:
+	/**
+	 * The set of observations.
+	 */
+	const ObservationsMap *observationsMap;
+
+	/**
+	 * The index of the current observation.
+	 */
+	unsigned int index;
+
+};
+
 /**
  * A class for finite sets of observations in an MDP-like object. Informally, there are two basic ways to
  * store finite observations: a vector of observations or a generator function based on a state and action.
@@ -44,6 +99,9 @@
  * If you want to create a generator function-based FiniteObservations class, please create a child class which
  * implements the function in the virtual functions described below. You will likely ignore the internal
  * observations vector variable here.
+ *
+ * The lookup functions are virtual, and iteration goes through get_observation(), so that a child class
+ * may describe its observations implicitly (e.g., JointObservationsMap) instead of storing them.
  */
 class ObservationsMap : public Observations {
 public:
@@ -88,7 +146,7 @@ public:
 	 * @param	observation		The observation to check if it is created or not.
 	 * @return	Returns @code{true} if the observation exists in the observations hash; @code{false} otherwise.
 	 */
-	bool exists(Observation *observation);
+	virtual bool exists(Observation *observation);
 
 	/**
 	 * Get an observation with a particular hash value.
@@ -96,30 +154,48 @@ public:
 	 * @throw	ObservationException	There are no observations with the hash value specified.
 	 * @return	The observation with the particular hash value specified.
 	 */
-	Observation *get(unsigned int hash);
+	virtual Observation *get(unsigned int hash);
+
+	/**
+	 * Get a observation by its name. The name of a joint observation is the names of its parts separated by spaces.
+	 * Names are recorded as observations are added, so this lookup takes constant time.
+	 * @param	name				The name of the observation.
+	 * @throw	ObservationException		There is no observation with the name specified.
+	 * @return	The observation with the name specified.
+	 */
+	virtual Observation *get_by_name(const std::string &name) const;
 
 	/**
 	 * Return the number of observations.
 	 * @return	The number of observations.
 	 */
-	unsigned int get_num_observations() const;
+	virtual unsigned int get_num_observations() const;
+
+	/**
+	 * Get the observation with a particular index, i.e., its position in the order the observations were added.
+	 * @param	index					The index of the observation, in 0, ..., z-1.
+	 * @throw	ObservationException	The index is out of bounds.
+	 * @return	The observation with the index specified.
+	 */
+	virtual Observation *get_observation(unsigned int index) const;
 
 	/**
 	 * Reset the observations, clearing the internal list and freeing the memory.
 	 */
-	void reset();
+	virtual void reset();
 
 	/**
-	 * To facilitate easy iteration, return a constant beginning of the observations vector.
-	 * @return	The iterator which points to a constant beginning of the observations vector.
+	 * To facilitate easy iteration, return an iterator to the first observation. Observations are
+	 * visited in the order they were added.
+	 * @return	The iterator which points to the first observation.
 	 */
-	std::unordered_map<unsigned int, Observation *>::iterator begin();
+	ObservationsMapIterator begin() const;
 
 	/**
-	 * To facilitate easy iteration, return a constant end of the observations vector.
-	 * @return	The iterator which points to a constant end of the observations vector.
+	 * To facilitate easy iteration, return an iterator past the last observation.
+	 * @return	The iterator which points past the last observation.
 	 */
-	std::unordered_map<unsigned int, Observation *>::iterator end();
+	ObservationsMapIterator end() const;
 
 protected:
 	/**
@@ -128,6 +204,36 @@ protected:
 	 */
 	std::unordered_map<unsigned int, Observation *> observations;
 
+	/**
+	 * The list of all the observations, in the order they were added.
+	 */
+	std::vector<Observation *> allObservations;
+
+
+	/**
+	 * Record the name of a observation, if it has one, so that it can be found with get_by_name().
+	 * @param	observation	The observation to record.
+	 */
+	void add_name(Observation *observation);
+
+	/**
+	 * Forget the name of a observation, if it was recorded.
+	 * @param	observation	The observation to forget.
+	 */
+	void remove_name(Observation *observation);
+
+	/**
+	 * Compute the name of a observation. Only a NamedObservation, or a JointObservation made of them, has a name.
+	 * @param	observation	The observation to name.
+	 * @param	name	The name of the observation. This will be modified.
+	 * @return	Returns @code{true} if the observation has a name; @code{false} otherwise.
+	 */
+	static bool get_name(Observation *observation, std::string &name);
+
+	/**
+	 * The mapping of names to observations.
+	 */
+	std::unordered_map<std::string, Observation *> names;
 };
 
 /**
@@ -142,5 +248,17 @@ Observation *resolve(std::unordered_map<unsigned int, Observation *>::value_type
  */
 unsigned int hash_value(std::unordered_map<unsigned int, Observation *>::value_type &observationIterator);
 
+/**
+ * Get the observation pointer of an observation iterator.
+ * @param	observationIterator		The observation iterator to retrieve the observation pointer from.
+ */
+Observation *resolve(Observation *observationIterator);
+
+/**
+ * Get the hash of an observation iterator.
+ * @param	observationIterator		The observation iterator to retrieve the hash value from.
+ */
+unsigned int hash_value(Observation *observationIterator);
+
 
 #endif // OBSERVATIONS_MAP_H
@@ -72,7 +72,7 @@ public:
 	 * @param	state		Get the value of this state.
 	 * @return	The alpha vector's value of the state.
 	 */
-	virtual double get(State *state);
+	virtual double get(State *state) const;
 
 	/**
 	 * Set the action to take if this alpha vector is optimal for a belief state.
@@ -83,7 +83,7 @@ public:
 	 * Get the action to take at this alpha vector.
 	 * @return	The action to take if this alpha vector is optimal for a belief state.
 	 */
-	virtual Action *get_action();
+	virtual Action *get_action() const;
 
 	/**
 	 * Get the dimension of this alpha vector (which is the number of states).
@@ -96,7 +96,7 @@ public:
 	 * @param	belief		The belief state 'beta' vector.
 	 * @return	The value of the belief state provided.
 	 */
-	virtual double compute_value(BeliefState *belief);
+	virtual double compute_value(BeliefState *belief) const;
 
 	/**
 	 * Overload the equals operator to set this alpha vector equal to the alpha vector provided.
@@ -29,6 +29,7 @@
 #include <vector>
 #include <string>
 #include <map>
+#include <cstdint>
 
 #include "policy.h"
 #include "policy_alpha_vector.h"
@@ -180,6 +181,31 @@ public:
 	 */
 	virtual bool save(std::string filename, StatesMap *states);
 
+	/**
+	 * Load a binary policy file, which may be memory mapped. The file must have been saved for the same
+	 * model fingerprint and the same state and action index tables; states and actions are resolved
+	 * by index instead of by name.
+	 * @param	filename		The name and path of the file to load.
+	 * @param	states			The states object which contains the actual state objects to be mapped.
+	 * @param	actions			The actions object which contains the actual action objects to be mapped.
+	 * @param	horizon			The horizons object to ensure valid policy creation.
+	 * @param	fingerprint		The fingerprint of the model.
+	 * @return	Return @code{true} if an error occurred, @code{false} otherwise.
+	 */
+	virtual bool load_binary(std::string filename, StatesMap *states, ActionsMap *actions, Horizon *horizon,
+			uint64_t fingerprint);
+
+	/**
+	 * Save a binary policy file, storing each alpha vector as its action index followed by its dense
+	 * values over the states.
+	 * @param	filename		The name and path of the file to save.
+	 * @param	states			The states object which contains the actual state objects to be mapped.
+	 * @param	actions			The actions object which contains the actual action objects to be mapped.
+	 * @param	fingerprint		The fingerprint of the model.
+	 * @return	Return @code{true} if an error occurred, @code{false} otherwise.
+	 */
+	virtual bool save_binary(std::string filename, StatesMap *states, ActionsMap *actions, uint64_t fingerprint);
+
 	/**
 	 * Reset the alpha vectors, freeing the memory.
 	 */
@@ -0,0 +1,192 @@
+/**
+ *  The MIT License (MIT)
+ *
+ *  Copyright (c) 2014 Kyle Hollins Wray, University of Massachusetts
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy of
+ *  this software and associated documentation files (the "Software"), to deal in
+ *  the Software without restriction, including without limitation the rights to
+ *  use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ *  the Software, and to permit persons to whom the Software is furnished to do so,
+ *  subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included in all
+ *  copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ *  FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ *  COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ *  IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ *  CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+
+#ifndef POLICY_BINARY_H
+#define POLICY_BINARY_H
+
+
+#include <vector>
+#include <string>
+#include <fstream>
+#include <cstdint>
+
+#include "../states/state.h"
+#include "../states/states_map.h"
+#include "../actions/action.h"
+#include "../actions/actions_map.h"
+#include "../observations/observation.h"
+#include "../observations/observations_map.h"
+
+#include "../../management/mapped_file.h"
+
+/**
+ * The version of the binary policy format. Files with another version are rejected.
+ */
+#define POLICY_BINARY_VERSION 1
+
+/**
+ * The value of an index which refers to no action, e.g., an unset node of a policy tree.
+ */
+#define POLICY_BINARY_NONE 0xFFFFFFFF
+
+/**
+ * An enumeration for the types of policies stored in a binary policy file.
+ */
+enum PolicyBinaryType {
+	PolicyBinaryMap,
+	PolicyBinaryAlphaVectors,
+	PolicyBinaryTree,
+	NumPolicyBinaryTypes
+};
+
+/**
+ * The header at the start of a binary policy file (64 bytes). States, actions, and observations
+ * are referred to by their position in the index tables built by order_policy_states,
+ * order_policy_actions, and order_policy_observations. Everything after the header is aligned
+ * to 8 bytes, so a memory mapped file is read in place.
+ */
+struct PolicyBinaryHeader {
+	/**
+	 * The magic bytes identifying the file: "LIBRBR" followed by 'P' and a zero byte.
+	 */
+	char magic[8];
+
+	/**
+	 * The version of the format.
+	 */
+	uint32_t version;
+
+	/**
+	 * The value 0x01020304 as written by the saving machine, used to detect a different byte order.
+	 */
+	uint32_t byteOrder;
+
+	/**
+	 * The type of policy, from PolicyBinaryType.
+	 */
+	uint32_t type;
+
+	/**
+	 * The number of horizons stored.
+	 */
+	uint32_t numHorizons;
+
+	/**
+	 * The fingerprint of the model the policy was computed for, as provided by the caller.
+	 */
+	uint64_t fingerprint;
+
+	/**
+	 * The hash of the names in the state, action, and observation index tables.
+	 */
+	uint64_t tableHash;
+
+	/**
+	 * The number of states in the index table.
+	 */
+	uint32_t numStates;
+
+	/**
+	 * The number of actions in the index table.
+	 */
+	uint32_t numActions;
+
+	/**
+	 * The number of observations in the index table.
+	 */
+	uint32_t numObservations;
+
+	/**
+	 * Unused; zero.
+	 */
+	uint32_t reserved;
+
+	/**
+	 * The number of bytes which follow the header.
+	 */
+	uint64_t size;
+};
+
+/**
+ * Order the states into the index table used by binary policy files and model files. Indexed
+ * states are placed at their index; otherwise, states keep the order of iteration.
+ * @param	states	The finite set of states.
+ * @return	The states in index order.
+ */
+std::vector<State *> order_policy_states(StatesMap *states);
+
+/**
+ * Order the actions into the index table used by binary policy files and model files. Indexed
+ * actions are placed at their index; otherwise, actions keep the order of iteration, which for
+ * joint actions is their mixed-radix index.
+ * @param	actions		The finite set of actions.
+ * @return	The actions in index order.
+ */
+std::vector<Action *> order_policy_actions(ActionsMap *actions);
+
+/**
+ * Order the observations into the index table used by binary policy files and model files.
+ * Indexed observations are placed at their index; otherwise, observations keep the order of
+ * iteration, which for joint observations is their mixed-radix index.
+ * @param	observations	The finite set of observations.
+ * @return	The observations in index order.
+ */
+std::vector<Observation *> order_policy_observations(ObservationsMap *observations);
+
+/**
+ * Hash the names of the states, actions, and observations in index order (64-bit FNV-1a).
+ * @param	states			The states in index order.
+ * @param	actions			The actions in index order.
+ * @param	observations	The observations in index order.
+ * @return	The hash of the index tables.
+ */
+uint64_t hash_policy_tables(const std::vector<State *> &states, const std::vector<Action *> &actions,
+		const std::vector<Observation *> &observations);
+
+/**
+ * Write the header of a binary policy file.
+ * @param	file			The output file, opened in binary mode.
+ * @param	header			The header to write; the magic bytes, version, and byte order are set here.
+ */
+void write_policy_header(std::ofstream &file, PolicyBinaryHeader &header);
+
+/**
+ * Read and validate the header of a memory mapped binary policy file against the model's index
+ * tables, logging the reason for any failure.
+ * @param	file			The memory mapped file.
+ * @param	type			The type of policy expected.
+ * @param	fingerprint		The fingerprint of the model expected.
+ * @param	tableHash		The hash of the model's index tables.
+ * @param	numStates		The number of states expected.
+ * @param	numActions		The number of actions expected.
+ * @param	numObservations	The number of observations expected.
+ * @param	function		The name of the calling function, for logging.
+ * @return	The header within the mapped file, or nullptr if the file is invalid.
+ */
+const PolicyBinaryHeader *read_policy_header(MappedFile &file, PolicyBinaryType type, uint64_t fingerprint,
+		uint64_t tableHash, unsigned int numStates, unsigned int numActions, unsigned int numObservations,
+		std::string function);
+
+
+#endif // POLICY_BINARY_H
@@ -30,6 +30,8 @@
 #include <string>
 #include <map>
 #include <fstream>
+#include <unordered_map>
+#include <cstdint>
 
 #include "policy.h"
 
@@ -100,6 +102,15 @@ public:
 	 */
 	PolicyTree(ObservationsMap *observations, Horizon *horizon);
 
+	/**
+	 * A constructor for a PolicyTree object which specifies the horizon, branching over a list of
+	 * observations. This is used for an individual agent's tree in a Dec-POMDP, since each agent
+	 * only observes its own factor of the joint observations.
+	 * @param	observations	The list of observations (branching factor).
+	 * @param	horizon 		The horizon of the problem.
+	 */
+	PolicyTree(const std::vector<Observation *> &observations, unsigned int horizon);
+
 	/**
 	 * A virtual deconstructor to prevent errors upon the deletion of a child object.
 	 */
@@ -138,6 +149,32 @@ public:
 	 */
 	virtual bool save(std::string filename);
 
+	/**
+	 * Load a binary policy file, which may be memory mapped. The file must have been saved for the same
+	 * model fingerprint and the same action and observation index tables; actions and observations are
+	 * resolved by index instead of by name.
+	 * @param	filename		The name and path of the file to load.
+	 * @param	actions			The actions object which contains the actual action objects to be mapped.
+	 * @param	observations	The observations object which contains the actual observation objects to be mapped.
+	 * @param	horizon			The horizons object to ensure valid policy creation.
+	 * @param	fingerprint		The fingerprint of the model.
+	 * @return	Return @code{true} if an error occurred, @code{false} otherwise.
+	 */
+	virtual bool load_binary(std::string filename, ActionsMap *actions, ObservationsMap *observations,
+			Horizon *horizon, uint64_t fingerprint);
+
+	/**
+	 * Save a binary policy file, storing the nodes in depth-first order as an action index followed
+	 * by the observation index of each child.
+	 * @param	filename		The name and path of the file to save.
+	 * @param	actions			The actions object which contains the actual action objects to be mapped.
+	 * @param	observations	The observations object which contains the actual observation objects to be mapped.
+	 * @param	fingerprint		The fingerprint of the model.
+	 * @return	Return @code{true} if an error occurred, @code{false} otherwise.
+	 */
+	virtual bool save_binary(std::string filename, ActionsMap *actions, ObservationsMap *observations,
+			uint64_t fingerprint);
+
 	/**
 	 * A function which follows the defined policy, having the current state stored internally,
 	 * and returns the action to select next.
@@ -145,6 +182,12 @@ public:
 	 */
 	virtual Action *next(Observation *observation);
 
+	/**
+	 * Get the root node of the policy tree, e.g., for walking the tree directly.
+	 * @return	The root node of the policy tree.
+	 */
+	PolicyTreeNode *get_root();
+
 	/**
 	 * Reset the policy, clearing the entire tree.
 	 */
@@ -159,6 +202,14 @@ private:
 	 */
 	PolicyTreeNode *generate_tree(ObservationsMap *observations, unsigned int horizon);
 
+	/**
+	 * Generate the policy tree recursively, branching over a list of observations.
+	 * @param	observations	The list of observations (branching factor).
+	 * @param	horizon			The remaining horizon value; once zero, recursion terminates.
+	 * @return	The root of this node's subtree.
+	 */
+	PolicyTreeNode *generate_tree(const std::vector<Observation *> &observations, unsigned int horizon);
+
 	/**
 	 * Traverse the tree following the history provided.
 	 * @param	history				The history of observations.
@@ -175,6 +226,31 @@ private:
 	 */
 	void save_tree(std::ofstream &file, PolicyTreeNode *node, std::vector<Observation *> history);
 
+	/**
+	 * Load a subtree of a binary policy file recursively.
+	 * @param	data			The node records of the file.
+	 * @param	size			The number of entries in the node records.
+	 * @param	position		The position of the subtree's node; this is moved past the subtree.
+	 * @param	depth			The number of nodes allowed from this node to a leaf.
+	 * @param	actions			The actions in index order.
+	 * @param	observations	The observations in index order.
+	 * @return	The root of this node's subtree, or nullptr if the records are invalid.
+	 */
+	PolicyTreeNode *load_binary_tree(const uint32_t *data, uint64_t size, uint64_t &position, unsigned int depth,
+			const std::vector<Action *> &actions, const std::vector<Observation *> &observations);
+
+	/**
+	 * Save a subtree as node records for a binary policy file recursively.
+	 * @param	data				The node records, which will be appended to.
+	 * @param	node				The current node.
+	 * @param	actionIndexes		The index of each action.
+	 * @param	observationIndexes	The index of each observation.
+	 * @return	The depth of the subtree, or zero if an action or observation has no index.
+	 */
+	unsigned int save_binary_tree(std::vector<uint32_t> &data, PolicyTreeNode *node,
+			std::unordered_map<Action *, uint32_t> &actionIndexes,
+			std::unordered_map<Observation *, uint32_t> &observationIndexes);
+
 	/**
 	 * Defines the policy itself; it's the internal mapping from states to actions. There is
 	 * one of these mappings for each level.
@@ -130,7 +130,7 @@ public:
 	 * @throw	RewardException	A reward was found which was not of type SARewards.
 	 * @return	The reward from taking the given action in the given state.
 	 */
-	virtual double get(State *state, Action *action);
+	virtual double get(State *state, Action *action) const;
 
 	/**
 	 * The probability of a transition following the state-action-state triple provided.
@@ -141,7 +141,7 @@ public:
 	 * @throw	RewardException	A reward was found which was not of type SASRewards.
 	 * @return	The reward from taking the given action in the given state.
 	 */
-	virtual double get(State *state, Action *action, State *nextState);
+	virtual double get(State *state, Action *action, State *nextState) const;
 
 	/**
 	 * The probability of a transition following the state-action-state-observation quadruple provided.
@@ -154,7 +154,7 @@ public:
 	 * @return	The reward from taking the given action in the given state.
 	 */
 	virtual double get(State *state, Action *action, State *nextState,
-			Observation *observation);
+			Observation *observation) const;
 
 	/**
 	 * Set the weights for the factored weighted rewards.
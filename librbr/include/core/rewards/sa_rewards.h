@@ -93,7 +93,7 @@ public:
 	 * @param	action		The action taken at the current state.
 	 * @return	The reward from taking the given action in the given state.
 	 */
-	virtual double get(State *state, Action *action) = 0;
+	virtual double get(State *state, Action *action) const = 0;
 
 	/**
 	 * The probability of a transition following the state-action-state triple provided.
@@ -102,7 +102,7 @@ public:
 	 * @param	nextState	The next state with which we assign the reward.
 	 * @return	The reward from taking the given action in the given state.
 	 */
-	virtual double get(State *state, Action *action, State *nextState) = 0;
+	virtual double get(State *state, Action *action, State *nextState) const = 0;
 
 	/**
 	 * The probability of a transition following the state-action-state-observation quadruple provided.
@@ -113,7 +113,7 @@ public:
 	 * @return	The reward from taking the given action in the given state.
 	 */
 	virtual double get(State *state, Action *action, State *nextState,
-			Observation *observation) = 0;
+			Observation *observation) const = 0;
 
 	/**
 	 * Get the minimal R-value.
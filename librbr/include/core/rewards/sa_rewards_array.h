@@ -31,6 +31,8 @@
 #include "../states/state.h"
 #include "../actions/action.h"
 
+#include <memory>
+
 /**
  * A class for state-action rewards in an MDP-like object, internally storing
  * the rewards as an array.
@@ -45,6 +47,20 @@ public:
 	 */
 	SARewardsArray(unsigned int numStates, unsigned int numActions);
 
+	/**
+	 * A constructor for the SARewardsArray class which uses an existing 2-dimensional array as the rewards
+	 * without copying it, e.g., a block of a memory-mapped file. The array is not reset; any changes
+	 * are made directly to this memory. The extreme values are given, so the array need not be read.
+	 * @param	numStates		The number of states.
+	 * @param	numActions		The number of actions.
+	 * @param	R				A pointer to the raw rewards data. This must be an array of size n x m.
+	 * @param	minReward		The minimal R-value in the array.
+	 * @param	maxReward		The maximal R-value in the array.
+	 * @param	backing			The owner of the memory (not null), which is kept alive until this object is destroyed.
+	 */
+	SARewardsArray(unsigned int numStates, unsigned int numActions, float *R, double minReward, double maxReward,
+			std::shared_ptr<void> backing);
+
 	/**
 	 * The default deconstructor for the SARewardsArray class.
 	 */
@@ -84,7 +100,7 @@ public:
 	 * @param	action		The action taken at the current state.
 	 * @return	The reward from taking the given action in the given state.
 	 */
-	virtual double get(State *state, Action *action);
+	virtual double get(State *state, Action *action) const;
 
 	/**
 	 * The probability of a transition following the state-action-state triple provided.
@@ -93,7 +109,7 @@ public:
 	 * @param	nextState	The next state with which we assign the reward.
 	 * @return	The reward from taking the given action in the given state.
 	 */
-	virtual double get(State *state, Action *action, State *nextState);
+	virtual double get(State *state, Action *action, State *nextState) const;
 
 	/**
 	 * The probability of a transition following the state-action-state-observation quadruple provided.
@@ -104,7 +120,7 @@ public:
 	 * @return	The reward from taking the given action in the given state.
 	 */
 	virtual double get(State *state, Action *action, State *nextState,
-			Observation *observation);
+			Observation *observation) const;
 
 	/**
 	 * Set the entire 2-dimensional array with the one provided. This only performs a copy.
@@ -155,6 +171,11 @@ private:
 	 */
 	float *rewards;
 
+	/**
+	 * The owner of the rewards array if it was provided externally, or null if this object allocated it.
+	 */
+	std::shared_ptr<void> backing;
+
 	/**
 	 * The number of states, which is the first dimension of the rewards array.
 	 */
@@ -83,7 +83,7 @@ public:
 	 * @param	action		The action taken at the current state.
 	 * @return	The reward from taking the given action in the given state.
 	 */
-	virtual double get(State *state, Action *action);
+	virtual double get(State *state, Action *action) const;
 
 	/**
 	 * The probability of a transition following the state-action-state triple provided.
@@ -92,7 +92,7 @@ public:
 	 * @param	nextState	The next state with which we assign the reward.
 	 * @return	The reward from taking the given action in the given state.
 	 */
-	virtual double get(State *state, Action *action, State *nextState);
+	virtual double get(State *state, Action *action, State *nextState) const;
 
 	/**
 	 * The probability of a transition following the state-action-state-observation quadruple provided.
@@ -103,7 +103,7 @@ public:
 	 * @return	The reward from taking the given action in the given state.
 	 */
 	virtual double get(State *state, Action *action, State *nextState,
-			Observation *observation);
+			Observation *observation) const;
 
 	/**
 	 * Get the minimal R-value.
@@ -131,7 +131,7 @@ private:
 	 * @throw	RewardException		The reward was not defined.
 	 * @return	The reward from taking the given action in the given state.
 	 */
-	virtual double get_value(State *state, Action *action);
+	virtual double get_value(State *state, Action *action) const;
 
 	/**
 	 * The list of all state-action rewards.
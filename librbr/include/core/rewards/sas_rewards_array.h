@@ -31,6 +31,8 @@
 #include "../states/state.h"
 #include "../actions/action.h"
 
+#include <memory>
+
 /**
  * A class for state-action-state rewards in an MDP-like object, internally storing the
  * rewards as an array.
@@ -45,6 +47,20 @@ public:
 	 */
 	SASRewardsArray(unsigned int numStates, unsigned int numActions);
 
+	/**
+	 * A constructor for the SASRewardsArray class which uses an existing 3-dimensional array as the rewards
+	 * without copying it, e.g., a block of a memory-mapped file. The array is not reset; any changes
+	 * are made directly to this memory. The extreme values are given, so the array need not be read.
+	 * @param	numStates		The number of states.
+	 * @param	numActions		The number of actions.
+	 * @param	R				A pointer to the raw rewards data. This must be an array of size n x m x n.
+	 * @param	minReward		The minimal R-value in the array.
+	 * @param	maxReward		The maximal R-value in the array.
+	 * @param	backing			The owner of the memory (not null), which is kept alive until this object is destroyed.
+	 */
+	SASRewardsArray(unsigned int numStates, unsigned int numActions, float *R, double minReward, double maxReward,
+			std::shared_ptr<void> backing);
+
 	/**
 	 * The default deconstructor for the SASRewardsArray class.
 	 */
@@ -77,7 +93,7 @@ public:
 	 * @param	nextState	The next state with which we assign the reward.
 	 * @return	The reward from taking the given action in the given state.
 	 */
-	virtual double get(State *state, Action *action, State *nextState);
+	virtual double get(State *state, Action *action, State *nextState) const;
 
 	/**
 	 * The probability of a transition following the state-action-state-observation quadruple provided.
@@ -88,7 +104,7 @@ public:
 	 * @return	The reward from taking the given action in the given state.
 	 */
 	virtual double get(State *state, Action *action, State *nextState,
-			Observation *observation);
+			Observation *observation) const;
 
 	/**
 	 * Set the entire 3-dimensional array with the one provided. This only performs a copy.
@@ -103,6 +119,24 @@ public:
 	 */
 	virtual float *get_rewards();
 
+	/**
+	 * Get the reward by the indexes of the states and action. Unlike the virtual get(), this does not
+	 * check the types of the objects or the bounds, so it may be inlined.
+	 * @param	s		The index of the current state, less than get_num_states().
+	 * @param	a		The index of the action, less than get_num_actions().
+	 * @param	sp		The index of the next state, less than get_num_states().
+	 * @return	The reward from taking the given action in the given state, then moving to the next state.
+	 */
+	float get(unsigned int s, unsigned int a, unsigned int sp) const;
+
+	/**
+	 * Get the rewards of moving to each next state, by the indexes of the state and action.
+	 * @param	s		The index of the current state, less than get_num_states().
+	 * @param	a		The index of the action, less than get_num_actions().
+	 * @return	A pointer to get_num_states() rewards, in the order of the next state indexes.
+	 */
+	const float *get_row(unsigned int s, unsigned int a) const;
+
 	/**
 	 * Get the number of states used for the rewards array.
 	 * @return	The number of states.
@@ -139,6 +173,11 @@ private:
 	 */
 	float *rewards;
 
+	/**
+	 * The owner of the rewards array if it was provided externally, or null if this object allocated it.
+	 */
+	std::shared_ptr<void> backing;
+
 	/**
 	 * The number of states, which is the first and third dimension of the rewards array.
 	 */
@@ -161,4 +200,14 @@ private:
 
 };
 
+inline float SASRewardsArray::get(unsigned int s, unsigned int a, unsigned int sp) const
+{
+	return rewards[(s * actions + a) * states + sp];
+}
+
+inline const float *SASRewardsArray::get_row(unsigned int s, unsigned int a) const
+{
+	return rewards + (s * actions + a) * states;
+}
+
 #endif // SAS_REWARDS_ARRAY_H
@@ -76,7 +76,7 @@ public:
 	 * @param	nextState	The next state with which we assign the reward.
 	 * @return	The reward from taking the given action in the given state.
 	 */
-	virtual double get(State *state, Action *action, State *nextState);
+	virtual double get(State *state, Action *action, State *nextState) const;
 
 	/**
 	 * The probability of a transition following the state-action-state-observation quadruple provided.
@@ -87,7 +87,7 @@ public:
 	 * @return	The reward from taking the given action in the given state.
 	 */
 	virtual double get(State *state, Action *action, State *nextState,
-			Observation *observation);
+			Observation *observation) const;
 
 	/**
 	 * Get the minimal R-value.
@@ -116,7 +116,7 @@ private:
 	 * @throw	RewardException		The reward was not defined.
 	 * @return	The reward from taking the given action in the given state.
 	 */
-	virtual double get_value(State *state, Action *action, State *nextState);
+	virtual double get_value(State *state, Action *action, State *nextState) const;
 
 	/**
 	 * The list of all state-action-state rewards.
@@ -80,7 +80,7 @@ public:
 	 * @return	The reward from taking the given action in the given state.
 	 */
 	virtual double get(State *state, Action *action, State *nextState,
-			Observation *observation) = 0;
+			Observation *observation) const = 0;
 
 	/**
 	 * Get the minimal R-value.
@@ -70,7 +70,7 @@ public:
 	 * @return	The reward from taking the given action in the given state.
 	 */
 	virtual double get(State *state, Action *action, State *nextState,
-			Observation *observation);
+			Observation *observation) const;
 
 	/**
 	 * Get the minimal R-value.
@@ -101,7 +101,7 @@ private:
 	 * @return	The reward from taking the given action in the given state.
 	 */
 	virtual double get_value(State *state, Action *action, State *nextState,
-			Observation *observation);
+			Observation *observation) const;
 
 	/**
 	 * The list of all state-action-state-observation rewards.
@@ -0,0 +1,291 @@
+/**
+ *  The MIT License (MIT)
+ *
+ *  Copyright (c) 2014 Kyle Hollins Wray, University of Massachusetts
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy of
+ *  this software and associated documentation files (the "Software"), to deal in
+ *  the Software without restriction, including without limitation the rights to
+ *  use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ *  the Software, and to permit persons to whom the Software is furnished to do so,
+ *  subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included in all
+ *  copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ *  FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ *  COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ *  IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ *  CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+
+
+#ifndef FACTORED_STATE_TRANSITIONS_H
+#define FACTORED_STATE_TRANSITIONS_H
+
+
+#include <unordered_map>
+#include <vector>
+#include <random>
+#include <mutex>
+
+#include "state_transitions.h"
+
+#include "../states/states.h"
+#include "../states/factored_states_map.h"
+
+#include "../actions/actions.h"
+
+#include "../states/state.h"
+
+#include "../actions/action.h"
+
+/**
+ * A class for factored state transitions in an MDP-like object, i.e., a dynamic Bayesian network over
+ * the factors of a FactoredStatesMap. Each factor of the next state depends only on the action and on
+ * a (small) set of parent factors of the current state, given by a conditional probability table. The
+ * probability of a transition is the product of one entry of each table, so the size of the model is
+ * linear in the number of factors, instead of exponential as in a StateTransitionsMap.
+ *
+ * Each table holds, for one factor and one action, a row for each assignment to the parents (with the
+ * first parent the most significant) with an entry for each state of the factor. As with the wildcards
+ * of StateTransitionsMap, the table set with the action @code{nullptr} gives each entry which was not
+ * set for a particular action.
+ *
+ * The successors of a state-action pair are only computed when they are first requested, since there
+ * are too many pairs to compute them all; build_successors() does nothing. They may be requested by
+ * several threads at once, even after freeze().
+ */
+class FactoredStateTransitions : virtual public StateTransitions {
+public:
+	/**
+	 * The constructor for the FactoredStateTransitions class. Each factor starts with no parents.
+	 * @param	S							The factored states, which must have been updated with all
+	 * 										of their factors. This does *not* take ownership of them.
+	 * @throw	StateTransitionException	The states were undefined or had no factors.
+	 */
+	FactoredStateTransitions(FactoredStatesMap *S);
+
+	/**
+	 * The default deconstructor for the FactoredStateTransitions class.
+	 */
+	virtual ~FactoredStateTransitions();
+
+	/**
+	 * Set the parents of a factor, i.e., the factors of the current state on which this factor of the
+	 * next state depends. This discards the factor's tables.
+	 * @param	factorIndex					The index of the factor.
+	 * @param	newParents					The indexes of the parent factors, in order.
+	 * @throw	StateTransitionException	An index was invalid, the model is frozen, or the tables would
+	 * 										be too large.
+	 */
+	void set_parents(unsigned int factorIndex, const std::vector<unsigned int> &newParents);
+
+	/**
+	 * Get the parents of a factor.
+	 * @param	factorIndex					The index of the factor.
+	 * @throw	StateTransitionException	The index was invalid.
+	 * @return	The indexes of the parent factors, in order.
+	 */
+	const std::vector<unsigned int> &get_parents(unsigned int factorIndex) const;
+
+	/**
+	 * Set the probability that a factor of the next state has a particular value, given the action and
+	 * the values of its parents in the current state.
+	 * @param	factorIndex					The index of the factor.
+	 * @param	action						The action taken, or @code{nullptr} for every action.
+	 * @param	parentStates				The state of each parent factor, in the order of get_parents().
+	 * @param	nextFactorState				The state of the factor in the next state.
+	 * @param	probability					The probability.
+	 * @throw	StateTransitionException	A factor or state was invalid, or the model is frozen.
+	 */
+	void set(unsigned int factorIndex, Action *action, const std::vector<State *> &parentStates,
+			State *nextFactorState, double probability);
+
+	/**
+	 * Get the probability that a factor of the next state has a particular value, given the action and
+	 * the values of its parents in the current state.
+	 * @param	factorIndex					The index of the factor.
+	 * @param	action						The action taken.
+	 * @param	parentStates				The state of each parent factor, in the order of get_parents().
+	 * @param	nextFactorState				The state of the factor in the next state.
+	 * @throw	StateTransitionException	A factor or state was invalid.
+	 * @return	The probability, or 0 if it was not set for the action or the wildcard.
+	 */
+	double get(unsigned int factorIndex, Action *action, const std::vector<State *> &parentStates,
+			State *nextFactorState) const;
+
+	/**
+	 * A transition of the joint state cannot be set directly; use set_parents() and the factored set().
+	 * @param	state						The current state of the system.
+	 * @param	action						The action taken at the current state.
+	 * @param	nextState					The next state with which we assign the probability.
+	 * @param	probability					The probability.
+	 * @throw	StateTransitionException	Always.
+	 */
+	virtual void set(State *state, Action *action, State *nextState, double probability);
+
+	/**
+	 * The probability of a transition following the state-action-state triple provided, i.e., the
+	 * product over the factors of their conditional probabilities.
+	 * @param	state						The current state of the system.
+	 * @param	action						The action taken at the current state.
+	 * @param	nextState					The next state with which we assign the probability.
+	 * @throw	StateTransitionException	Either of the states was not a factored state of the model.
+	 * @return	The probability of going from the state, taking the action, then moving to the nextState.
+	 */
+	virtual double get(State *state, Action *action, State *nextState) const;
+
+	/**
+	 * Sample a next state, given the current state and the action taken, by sampling each factor from
+	 * its table in turn.
+	 * @param	state						The current state of the system.
+	 * @param	action						The action taken at the current state.
+	 * @param	generator					The random number generator to use.
+	 * @throw	StateTransitionException	The state was not a factored state of the model, or a row of
+	 * 										a table did not sum to a positive value.
+	 * @return	The next state.
+	 */
+	State *sample(State *state, Action *action, std::mt19937 &generator) const;
+
+	/**
+	 * Return a list of the states with a nonzero probability given a previous state and the action taken
+	 * there, in order of their index, computing it if needed.
+	 * @param	S							The set of states.
+	 * @param	state						The previous state.
+	 * @param	action						The action taken at the previous state.
+	 * @throw	StateTransitionException	The state was not a factored state of the model.
+	 * @return	successors					A reference to the list of successor states.
+	 */
+	virtual const std::vector<State *> &successors(States *S, State *state, Action *action);
+
+	/**
+	 * Return the probabilities of the successors of a state-action pair, in the same order as the list
+	 * returned by successors(), computing them if needed.
+	 * @param	S							The set of states.
+	 * @param	state						The previous state.
+	 * @param	action						The action taken at the previous state.
+	 * @throw	StateTransitionException	The state was not a factored state of the model.
+	 * @return	A reference to the list of probabilities of the successor states.
+	 */
+	virtual const std::vector<float> &probabilities(States *S, State *state, Action *action);
+
+	/**
+	 * This does nothing, since the successors are computed as they are requested.
+	 * @param	S							The set of states.
+	 * @param	A							The set of actions.
+	 */
+	virtual void build_successors(States *S, Actions *A);
+
+	/**
+	 * Freeze the state transitions so that they are read-only. Afterwards, set_parents() and set() throw.
+	 * @param	S							The set of states.
+	 * @param	A							The set of actions.
+	 */
+	virtual void freeze(States *S, Actions *A);
+
+	/**
+	 * Check if the state transitions have been frozen.
+	 * @return	Returns @code{true} if the state transitions are read-only; @code{false} otherwise.
+	 */
+	virtual bool is_frozen() const;
+
+	/**
+	 * Get the number of probabilities stored in all of the tables.
+	 * @return	The size of the model.
+	 */
+	unsigned int get_num_parameters() const;
+
+	/**
+	 * Reset the state transitions, clearing the parents and tables of every factor.
+	 */
+	virtual void reset();
+
+private:
+	/**
+	 * Get the index of the row of a factor's tables for the parents' values in a factored state.
+	 * @param	factorIndex					The index of the factor.
+	 * @param	state						The factored state.
+	 * @throw	StateTransitionException	The state was not a factored state of the model.
+	 * @return	The index of the row.
+	 */
+	unsigned int find_row(unsigned int factorIndex, State *state) const;
+
+	/**
+	 * Get an entry of a factor's tables for an action, falling back to the wildcard's table.
+	 * @param	factorIndex					The index of the factor.
+	 * @param	action						The action taken.
+	 * @param	row							The index of the row, for the parents' values.
+	 * @param	column						The index of the factor's state in the next state.
+	 * @return	The probability, or 0 if it was not set for the action or the wildcard.
+	 */
+	double find_probability(unsigned int factorIndex, Action *action, unsigned int row, unsigned int column) const;
+
+	/**
+	 * Compute the successors of a state-action pair, and their probabilities, in order of their index.
+	 * @param	state						The previous state.
+	 * @param	action						The action taken at the previous state.
+	 * @param	succ						The reference to the successors vector.
+	 * @param	prob						The reference to the probabilities vector.
+	 * @throw	StateTransitionException	The state was not a factored state of the model.
+	 */
+	void compute_successors(State *state, Action *action, std::vector<State *> &succ,
+			std::vector<float> &prob) const;
+
+	/**
+	 * Find the computed successors and probabilities of a state-action pair, computing them if needed.
+	 * @param	state						The previous state.
+	 * @param	action						The action taken at the previous state.
+	 * @return	The computed successors.
+	 */
+	std::pair<std::vector<State *>, std::vector<float> > &find_successors(State *state, Action *action);
+
+	/**
+	 * The factored states, which are not owned by this object.
+	 */
+	FactoredStatesMap *states;
+
+	/**
+	 * The number of states in each factor.
+	 */
+	std::vector<unsigned int> factorSizes;
+
+	/**
+	 * The parents of each factor.
+	 */
+	std::vector<std::vector<unsigned int> > parents;
+
+	/**
+	 * The number of rows in the tables of each factor, i.e., the number of assignments to its parents.
+	 */
+	std::vector<unsigned int> numRows;
+
+	/**
+	 * For each factor, a table for each action (or @code{nullptr} for every action) with one probability
+	 * for each row and state of the factor, or -1 for the entries which have not been set.
+	 */
+	std::vector<std::unordered_map<Action *, std::vector<double> > > tables;
+
+	/**
+	 * The successors of the state-action pairs which have been requested, with their probabilities.
+	 */
+	std::unordered_map<State *, std::unordered_map<Action *,
+		std::pair<std::vector<State *>, std::vector<float> > > > successorStates;
+
+	/**
+	 * A mutex which protects the successors, so they may be computed by several threads at once.
+	 */
+	std::mutex successorsMutex;
+
+	/**
+	 * Whether or not the state transitions are read-only. See freeze().
+	 */
+	bool frozen;
+
+};
+
+
+#endif // FACTORED_STATE_TRANSITIONS_H
@@ -32,6 +32,7 @@
 #include "../states/states.h"
 
 #include "../actions/action.h"
+#include "../actions/actions.h"
 
 /**
  * An abstract class which defines how to interact with a state transitions object.
@@ -71,7 +72,7 @@ public:
 	 * @throw	StateTransitionException	An error occurred. Please see child class definitions for specifics.
 	 * @return	The probability of going from the state, taking the action, then moving to the nextState.
 	 */
-	virtual double get(State *state, Action *action, State *nextState) = 0;
+	virtual double get(State *state, Action *action, State *nextState) const = 0;
 
 	/**
 	 * Return a list of the states available given a previous state and the action taken there.
@@ -85,6 +86,43 @@ public:
 	 */
 	virtual const std::vector<State *> &successors(States *S, State *state, Action *action) = 0;
 
+	/**
+	 * Return the probabilities of the successors of a state-action pair, in the same order as the list
+	 * returned by successors().
+	 * @param	S							The set of states.
+	 * @param	state						The previous state.
+	 * @param	action						The action taken at the previous state.
+	 * @throw	StateTransitionException	An error occurred. Please see child class definitions for specifics.
+	 * @return	A reference to the list of probabilities of the successor states.
+	 */
+	virtual const std::vector<float> &probabilities(States *S, State *state, Action *action) = 0;
+
+	/**
+	 * Compute the successors, and their probabilities, of every state-action pair at once, in parallel.
+	 * Pairs which were already computed are kept, so later calls to successors() and probabilities()
+	 * never compute anything.
+	 * @param	S							The set of states.
+	 * @param	A							The set of actions.
+	 * @throw	StateTransitionException	An error occurred. Please see child class definitions for specifics.
+	 */
+	virtual void build_successors(States *S, Actions *A) = 0;
+
+	/**
+	 * Freeze the state transitions so that they are read-only. This calls build_successors(), so afterwards
+	 * get(), successors(), and probabilities() never modify the object and may be called from many threads
+	 * at once. Modifying a frozen object throws; reset() unfreezes it.
+	 * @param	S							The set of states.
+	 * @param	A							The set of actions.
+	 * @throw	StateTransitionException	An error occurred. Please see child class definitions for specifics.
+	 */
+	virtual void freeze(States *S, Actions *A) = 0;
+
+	/**
+	 * Check if the state transitions have been frozen.
+	 * @return	Returns @code{true} if the state transitions are read-only; @code{false} otherwise.
+	 */
+	virtual bool is_frozen() const = 0;
+
 };
 
 
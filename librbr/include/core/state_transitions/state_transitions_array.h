@@ -36,6 +36,9 @@
 
 #include "../actions/action.h"
 #include "../actions/indexed_action.h"
+#include "../actions/actions.h"
+
+#include <memory>
 
 /**
  * A class for finite state transitions in an MDP-like object. Informally, there are two basic ways to
@@ -59,6 +62,17 @@ public:
 	 */
 	StateTransitionsArray(unsigned int numStates, unsigned int numActions);
 
+	/**
+	 * A constructor for the StateTransitionsArray class which uses an existing 3-dimensional array as
+	 * the state transitions without copying it, e.g., a block of a memory-mapped file. The array is
+	 * not reset; any changes are made directly to this memory.
+	 * @param	numStates		The number of states.
+	 * @param	numActions		The number of actions.
+	 * @param	T				A pointer to the raw state transitions data. This must be an array of size n x m x n.
+	 * @param	backing			The owner of the memory (not null), which is kept alive until this object is destroyed.
+	 */
+	StateTransitionsArray(unsigned int numStates, unsigned int numActions, float *T, std::shared_ptr<void> backing);
+
 	/**
 	 * The default deconstructor for the StateTransitionsArray class.
 	 */
@@ -83,7 +97,7 @@ public:
 	 * @throw	StateTransitionException	Either one of the states or the action was invalid.
 	 * @return	The probability of going from the state, taking the action, then moving to the nextState.
 	 */
-	virtual double get(State *state, Action *action, State *nextState);
+	virtual double get(State *state, Action *action, State *nextState) const;
 
 	/**
 	 * Add a successor to a particular state.
@@ -106,6 +120,26 @@ public:
 	 */
 	virtual const std::vector<State *> &successors(States *S, State *state, Action *action);
 
+	/**
+	 * Return the probabilities of the successors of a state-action pair, in the same order as the list
+	 * returned by successors().
+	 * @param	S							The set of states.
+	 * @param	state						The previous state.
+	 * @param	action						The action taken at the previous state.
+	 * @throw	StateTransitionException	The state or action was invalid, or the states are not a StatesMap.
+	 * @return	A reference to the list of probabilities of the successor states.
+	 */
+	virtual const std::vector<float> &probabilities(States *S, State *state, Action *action);
+
+	/**
+	 * Compute the successors, and their probabilities, of every state-action pair at once, in parallel.
+	 * Pairs which were already computed are kept. This does nothing once frozen.
+	 * @param	S							The set of states.
+	 * @param	A							The set of actions.
+	 * @throw	StateTransitionException	The states are not a StatesMap.
+	 */
+	virtual void build_successors(States *S, Actions *A);
+
 	/**
 	 * Set the entire 3-dimensional array with the one provided. This only performs a copy.
 	 * @param	T	A pointer to the new 3-d array of raw state transitions data. This must be
@@ -119,6 +153,24 @@ public:
 	 */
 	virtual float *get_state_transitions();
 
+	/**
+	 * Get the probability of a state transition by the indexes of the states and action. Unlike the
+	 * virtual get(), this does not check the types of the objects or the bounds, so it may be inlined.
+	 * @param	s		The index of the current state, less than get_num_states().
+	 * @param	a		The index of the action, less than get_num_actions().
+	 * @param	sp		The index of the next state, less than get_num_states().
+	 * @return	The probability of going from the state, taking the action, then moving to the next state.
+	 */
+	float get(unsigned int s, unsigned int a, unsigned int sp) const;
+
+	/**
+	 * Get the probabilities of moving to each next state, by the indexes of the state and action.
+	 * @param	s		The index of the current state, less than get_num_states().
+	 * @param	a		The index of the action, less than get_num_actions().
+	 * @return	A pointer to get_num_states() probabilities, in the order of the next state indexes.
+	 */
+	const float *get_row(unsigned int s, unsigned int a) const;
+
 	/**
 	 * Get the number of states used for the state transitions array.
 	 * @return	The number of states.
@@ -131,6 +183,21 @@ public:
 	 */
 	virtual unsigned int get_num_actions() const;
 
+	/**
+	 * Freeze the state transitions so that they are read-only, after calling build_successors(). Afterwards,
+	 * get(), successors(), and probabilities() do not modify the object, and set() or add_successor() throw.
+	 * @param	S							The set of states.
+	 * @param	A							The set of actions.
+	 * @throw	StateTransitionException	The states or actions are not of a supported type.
+	 */
+	virtual void freeze(States *S, Actions *A);
+
+	/**
+	 * Check if the state transitions have been frozen.
+	 * @return	Returns @code{true} if the state transitions are read-only; @code{false} otherwise.
+	 */
+	virtual bool is_frozen() const;
+
 	/**
 	 * Reset the state transitions by assigning all probabilities to zero. This does not free memory.
 	 */
@@ -138,13 +205,14 @@ public:
 
 private:
 	/**
-	 * Compute the successor states for the state and action pair provided, then store the result
-	 * in successorStates.
+	 * Compute the successor states for the state and action pair provided, unless they were added with
+	 * add_successor(), then compute their probabilities. The results are stored in successorStates and
+	 * successorProbabilities.
 	 * @param	S							The finite set of states.
-	 * @param	s							The current state.
-	 * @param	a							The current action.
+	 * @param	s							The index of the current state.
+	 * @param	a							The index of the current action.
 	 */
-	virtual void compute_successors(StatesMap *S, IndexedState *s, IndexedAction *a);
+	virtual void compute_successors(StatesMap *S, unsigned int s, unsigned int a);
 
 	/**
 	 * The 3-dimensional array of all state-action-state transitions. Internally,
@@ -152,6 +220,11 @@ private:
 	 */
 	float *stateTransitions;
 
+	/**
+	 * The owner of the state transitions array if it was provided externally, or null if this object allocated it.
+	 */
+	std::shared_ptr<void> backing;
+
 	/**
 	 * The number of states in the state transitions first and third dimensions.
 	 */
@@ -167,7 +240,33 @@ private:
 	 */
 	std::vector<State *> *successorStates;
 
+	/**
+	 * A mapping from state-action pairs to the probabilities of their successor states.
+	 */
+	std::vector<float> *successorProbabilities;
+
+	/**
+	 * For each state-action pair, whether or not its successors and probabilities have been computed.
+	 */
+	bool *successorsComputed;
+
+	/**
+	 * Whether or not the state transitions are read-only. See freeze().
+	 */
+	bool frozen;
+
 };
 
 
+inline float StateTransitionsArray::get(unsigned int s, unsigned int a, unsigned int sp) const
+{
+	return stateTransitions[(s * actions + a) * states + sp];
+}
+
+inline const float *StateTransitionsArray::get_row(unsigned int s, unsigned int a) const
+{
+	return stateTransitions + (s * actions + a) * states;
+}
+
+
 #endif // STATE_TRANSITIONS_ARRAY_H
@@ -33,6 +33,8 @@
 #include "../states/states.h"
 #include "../states/states_map.h"
 
+#include "../actions/actions.h"
+
 #include "../states/state.h"
 
 #include "../actions/action.h"
@@ -60,7 +62,8 @@ public:
 	virtual ~StateTransitionsMap();
 
 	/**
-	 * Set a state transition from a particular state-action-state triple to a probability.
+	 * Set a state transition from a particular state-action-state triple to a probability. This discards
+	 * the computed successors of the affected state-action pairs.
 	 * @param	state			The current state of the system.
 	 * @param	action			The action taken at the current state.
 	 * @param	nextState		The next state with which we assign the probability.
@@ -76,7 +79,7 @@ public:
 	 * @param	nextState	The next state with which we assign the probability.
 	 * @return	The probability of going from the state, taking the action, then moving to the nextState.
 	 */
-	virtual double get(State *state, Action *action, State *nextState);
+	virtual double get(State *state, Action *action, State *nextState) const;
 
 	/**
 	 * Add a successor to a particular state.
@@ -88,9 +91,8 @@ public:
 	virtual void add_successor(State *state, Action *action, State *successorState);
 
 	/**
-	 * Return a list of the states available given a previous state and the action taken there.
-	 * Note: This list may change (continual planning) if nested inside loops incorrectly. To be safe,
-	 * just call it once unless you know what you are doing.
+	 * Return a list of the states available given a previous state and the action taken there, as given by
+	 * add_successor() or computed by build_successors().
 	 * @param	S							The set of states.
 	 * @param	state						The previous state.
 	 * @param	action						The action taken at the previous state.
@@ -99,6 +101,41 @@ public:
 	 */
 	virtual const std::vector<State *> &successors(States *S, State *state, Action *action);
 
+	/**
+	 * Return the probabilities of the successors of a state-action pair, in the same order as the list
+	 * returned by successors().
+	 * @param	S							The set of states.
+	 * @param	state						The previous state.
+	 * @param	action						The action taken at the previous state.
+	 * @throw	StateTransitionException	The state-action pair could not be found.
+	 * @return	A reference to the list of probabilities of the successor states.
+	 */
+	virtual const std::vector<float> &probabilities(States *S, State *state, Action *action);
+
+	/**
+	 * Compute the successors, and their probabilities, of every state-action pair at once, in parallel.
+	 * Pairs which were already computed are kept. This does nothing once frozen.
+	 * @param	S							The set of states.
+	 * @param	A							The set of actions.
+	 * @throw	StateTransitionException	The states or actions are not of a supported type.
+	 */
+	virtual void build_successors(States *S, Actions *A);
+
+	/**
+	 * Freeze the state transitions so that they are read-only, after calling build_successors(). Afterwards,
+	 * get(), successors(), and probabilities() do not modify the object, and set() or add_successor() throw.
+	 * @param	S							The set of states.
+	 * @param	A							The set of actions.
+	 * @throw	StateTransitionException	The states or actions are not of a supported type.
+	 */
+	virtual void freeze(States *S, Actions *A);
+
+	/**
+	 * Check if the state transitions have been frozen.
+	 * @return	Returns @code{true} if the state transitions are read-only; @code{false} otherwise.
+	 */
+	virtual bool is_frozen() const;
+
 	/**
 	 * Reset the state transitions, clearing the internal mapping.
 	 */
@@ -114,17 +151,27 @@ private:
 	 * @throw	StateTransitionException	The state transition was not defined.
 	 * @return	The probability of going from the state, taking the action, then moving to the nextState.
 	 */
-	virtual double get_value(State *state, Action *action, State *nextState);
+	virtual double get_value(State *state, Action *action, State *nextState) const;
 
 	/**
-	 * Compute the successor states for the state and action pair provided, then store the result
-	 * in successorStates via the 'succ' parameter.
+	 * Compute the successor states for the state and action pair provided, unless they were added with
+	 * add_successor(), then compute their probabilities.
 	 * @param	S							The finite set of states.
 	 * @param	s							The current state.
 	 * @param	a							The current action.
 	 * @param	succ						The reference to the successors vector.
+	 * @param	prob						The reference to the probabilities vector.
+	 */
+	virtual void compute_successors(StatesMap *S, State *s, Action *a, std::vector<State *> &succ,
+			std::vector<float> &prob);
+
+	/**
+	 * Discard the computed successors and probabilities of the state-action pairs affected by a call
+	 * to set(). Lists given by add_successor() which were never computed are kept.
+	 * @param	state						The state, possibly the wildcard.
+	 * @param	action						The action, possibly the wildcard.
 	 */
-	virtual void compute_successors(StatesMap *S, State *s, Action *a, std::vector<State *> &succ);
+	void discard_successors(State *state, Action *action);
 
 	/**
 	 * The list of all state-action-state transitions.
@@ -148,6 +195,17 @@ private:
 	 */
 	std::unordered_map<State *, std::unordered_map<Action *, std::vector<State *> > > successorStates;
 
+	/**
+	 * A mapping from state-action pairs to the probabilities of their successor states. A pair is computed
+	 * once it has an entry here.
+	 */
+	std::unordered_map<State *, std::unordered_map<Action *, std::vector<float> > > successorProbabilities;
+
+	/**
+	 * Whether or not the state transitions are read-only. See freeze().
+	 */
+	bool frozen;
+
 };
 
 
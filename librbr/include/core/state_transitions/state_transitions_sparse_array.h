@@ -0,0 +1,220 @@
+/**
+ *  The MIT License (MIT)
+ *
+ *  Copyright (c) 2014 Kyle Hollins Wray, University of Massachusetts
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy of
+ *  this software and associated documentation files (the "Software"), to deal in
+ *  the Software without restriction, including without limitation the rights to
+ *  use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ *  the Software, and to permit persons to whom the Software is furnished to do so,
+ *  subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included in all
+ *  copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ *  FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ *  COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ *  IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ *  CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+
+#ifndef STATE_TRANSITIONS_SPARSE_ARRAY_H
+#define STATE_TRANSITIONS_SPARSE_ARRAY_H
+
+
+#include "state_transitions.h"
+
+#include "../states/states.h"
+
+#include "../states/state.h"
+#include "../states/indexed_state.h"
+
+#include "../actions/action.h"
+#include "../actions/indexed_action.h"
+#include "../actions/actions.h"
+
+#include <vector>
+
+/**
+ * A class for finite state transitions in an MDP-like object which only stores the nonzero probabilities.
+ * Each state-action pair has a row of its successor states, sorted by their indexes, alongside the
+ * probability of each. The memory used is proportional to the number of state-action pairs plus the number
+ * of nonzero probabilities, and the list of successors is always available without any computation.
+ *
+ * Setting the successors of a row in order of their indexes (e.g., while streaming a sorted file) appends
+ * to the row; otherwise, a binary search finds the location. Setting a probability of zero removes the entry.
+ *
+ * This class requires that states and actions be of types IndexedState and IndexedAction, respectively.
+ */
+class StateTransitionsSparseArray : virtual public StateTransitions {
+public:
+	/**
+	 * The default constructor for the StateTransitionsSparseArray class. This requires the
+	 * number of states and actions to be specified.
+	 * @param	numStates		The number of states.
+	 * @param	numActions		The number of actions.
+	 */
+	StateTransitionsSparseArray(unsigned int numStates, unsigned int numActions);
+
+	/**
+	 * The default deconstructor for the StateTransitionsSparseArray class.
+	 */
+	virtual ~StateTransitionsSparseArray();
+
+	/**
+	 * Set a state transition from a particular state-action-state triple to a probability.
+	 * @param	state						The current state of the system.
+	 * @param	action						The action taken at the current state.
+	 * @param	nextState					The next state with which we assign the probability.
+	 * @param	probability					The probability of going from the state, taking the action, then
+	 * 										moving to the nextState.
+	 * @throw	StateTransitionException	Either one of the states or the action was invalid.
+	 */
+	virtual void set(State *state, Action *action, State *nextState, double probability);
+
+	/**
+	 * The probability of a transition following the state-action-state triple provided.
+	 * @param	state						The current state of the system.
+	 * @param	action						The action taken at the current state.
+	 * @param	nextState					The next state with which we assign the probability.
+	 * @throw	StateTransitionException	Either one of the states or the action was invalid.
+	 * @return	The probability of going from the state, taking the action, then moving to the nextState.
+	 */
+	virtual double get(State *state, Action *action, State *nextState) const;
+
+	/**
+	 * Return a list of the states available given a previous state and the action taken there.
+	 * @param	S							The set of states.
+	 * @param	state						The previous state.
+	 * @param	action						The action taken at the previous state.
+	 * @throw	StateTransitionException	Either the state or the action was invalid.
+	 * @return	successors					A reference to the list of successor states, sorted by index.
+	 */
+	virtual const std::vector<State *> &successors(States *S, State *state, Action *action);
+
+	/**
+	 * Return the probabilities of the successors of a state-action pair, in the same order as the
+	 * list returned by successors().
+	 * @param	state						The previous state.
+	 * @param	action						The action taken at the previous state.
+	 * @throw	StateTransitionException	Either the state or the action was invalid.
+	 * @return	A reference to the list of probabilities.
+	 */
+	virtual const std::vector<float> &probabilities(State *state, Action *action);
+
+	/**
+	 * Return the probabilities of the successors of a state-action pair, in the same order as the
+	 * list returned by successors().
+	 * @param	S							The set of states.
+	 * @param	state						The previous state.
+	 * @param	action						The action taken at the previous state.
+	 * @throw	StateTransitionException	The state or action was invalid.
+	 * @return	A reference to the list of probabilities of the successor states.
+	 */
+	virtual const std::vector<float> &probabilities(States *S, State *state, Action *action);
+
+	/**
+	 * The successors and their probabilities are always stored, so this does nothing.
+	 * @param	S							The set of states.
+	 * @param	A							The set of actions.
+	 */
+	virtual void build_successors(States *S, Actions *A);
+
+	/**
+	 * Get the number of states used for the state transitions.
+	 * @return	The number of states.
+	 */
+	virtual unsigned int get_num_states() const;
+
+	/**
+	 * Get the number of actions used for the state transitions.
+	 * @return	The number of actions.
+	 */
+	virtual unsigned int get_num_actions() const;
+
+	/**
+	 * Get the number of nonzero probabilities stored.
+	 * @return	The number of nonzero probabilities.
+	 */
+	virtual unsigned int get_num_nonzero() const;
+
+	/**
+	 * Freeze the state transitions so that they are read-only. The successors are always stored, so
+	 * nothing is computed. Afterwards, set() throws.
+	 * @param	S							The set of states.
+	 * @param	A							The set of actions.
+	 */
+	virtual void freeze(States *S, Actions *A);
+
+	/**
+	 * Check if the state transitions have been frozen.
+	 * @return	Returns @code{true} if the state transitions are read-only; @code{false} otherwise.
+	 */
+	virtual bool is_frozen() const;
+
+	/**
+	 * Reset the state transitions by removing all of the probabilities, and freeing the memory of each row.
+	 */
+	virtual void reset();
+
+private:
+	/**
+	 * Find the row of a state-action pair.
+	 * @param	state						The state.
+	 * @param	action						The action.
+	 * @throw	StateTransitionException	Either the state or the action was invalid.
+	 * @return	The index of the row.
+	 */
+	unsigned int find_row(State *state, Action *action) const;
+
+	/**
+	 * Find the index of a next state.
+	 * @param	nextState					The next state.
+	 * @throw	StateTransitionException	The next state was invalid.
+	 * @return	The index of the next state.
+	 */
+	unsigned int find_next_state(State *nextState) const;
+
+	/**
+	 * The number of states in the state transitions first and third dimensions.
+	 */
+	unsigned int states;
+
+	/**
+	 * The number of actions in the state transitions second dimension.
+	 */
+	unsigned int actions;
+
+	/**
+	 * The number of nonzero probabilities stored over all rows.
+	 */
+	unsigned int numNonzero;
+
+	/**
+	 * For each state-action pair, the indexes of the successor states in increasing order.
+	 */
+	std::vector<std::vector<unsigned int> > successorIndexes;
+
+	/**
+	 * For each state-action pair, the successor states, in the same order as the indexes.
+	 */
+	std::vector<std::vector<State *> > successorStates;
+
+	/**
+	 * For each state-action pair, the probabilities of the successor states, in the same order as the indexes.
+	 */
+	std::vector<std::vector<float> > successorProbabilities;
+
+	/**
+	 * Whether or not the state transitions are read-only. See freeze().
+	 */
+	bool frozen;
+
+};
+
+
+#endif // STATE_TRANSITIONS_SPARSE_ARRAY_H
@@ -27,10 +27,15 @@
 
 
 #include <vector>
+#include <string>
+#include <unordered_map>
 
 #include "state.h"
 #include "states.h"
 #include "states_map.h"
+#include "factored_state.h"
+
+#include "../../utilities/lazy_table.h"
 
 /**
  * A class for finite sets of factored states in an MDP-like object. Informally, there are two basic ways to
@@ -42,7 +47,15 @@
  * implements the function in the virtual functions described below. You will likely ignore the internal
  * states vector variable here.
  *
- * Note: The protected "states" variable implicitly must only store FactoredState objects, not State objects.
+ * The factored states are never stored as a full cross product. Each is identified by a mixed-radix index
+ * over the factors, with the first factor the most significant, so the description of the states takes
+ * memory proportional to the sum of the factor sizes. Iteration, indexing, and name lookups decode the
+ * index on demand; a FactoredState object is created the first time a particular state is returned, and
+ * kept (so pointers to it remain valid) until the next update() or reset(). The created states are held in
+ * a lock-free table, so they may be looked up and created by several threads at once.
+ *
+ * Note that iterating over the states (or a solver sweeping over them) materializes every state visited,
+ * so a full sweep uses memory proportional to the number of states until the next update() or reset().
  */
 class FactoredStatesMap : virtual public StatesMap {
 public:
@@ -111,18 +124,89 @@ public:
 	State *get(unsigned int factorIndex, unsigned int stateIndex);
 
 	/**
-	 * Update the internal states list which holds all permutations of factored states in an efficient structure.
+	 * Update the description of the factored states, i.e., the index of each state within its factor.
 	 * Note: This *must* be called after sequences of add(), remove(), and/or set() calls.
-	 * @throw	StateException		A state factor has not been defined.
+	 * @throw	StateException		A state factor has not been defined, or there are too many states.
 	 */
 	void update();
 
+	/**
+	 * Check if a factored state is one of these states, i.e., each of its parts is in its factor.
+	 * @param	state		The state to check if it is created or not.
+	 * @return	Returns @code{true} if the state exists; @code{false} otherwise.
+	 */
+	virtual bool exists(const State *state) const;
+
+	/**
+	 * Get a factored state with a particular hash value, without creating the states which do not match.
+	 * The hash of a factored state combines the hashes of its parts, so the factors are split into a prefix
+	 * and a suffix with about the square root of the number of states each, and the suffix of each prefix
+	 * is solved for in a table of the suffix hashes.
+	 * @param	hash				The hash of the state.
+	 * @throw	StateException		There are no states with the hash value specified.
+	 * @return	The state with the lowest index and the particular hash value specified.
+	 */
+	virtual State *get(unsigned int hash);
+
+	/**
+	 * Get a factored state by its name, i.e., the names of its parts separated by spaces.
+	 * @param	name				The name of the state.
+	 * @throw	StateException		There is no state with the name specified.
+	 * @return	The state with the name specified.
+	 */
+	virtual State *get_by_name(const std::string &name) const;
+
+	/**
+	 * Get the mixed-radix index of a factored state.
+	 * @param	state				The state to find.
+	 * @throw	StateException		The state is not a factored state with each part in its factor.
+	 * @return	The index of the state.
+	 */
+	virtual unsigned int get_index(const State *state) const;
+
+	/**
+	 * Get the factored state with a particular mixed-radix index, creating it if needed.
+	 * @param	index				The index of the state, in 0, ..., n-1.
+	 * @throw	StateException		The index is out of bounds.
+	 * @return	The state with the index specified.
+	 */
+	virtual State *get_state(unsigned int index) const;
+
+	/**
+	 * Return the number of factored states, i.e., the product of the factor sizes.
+	 * @return	The number of states.
+	 */
+	virtual unsigned int get_num_states() const;
+
 	/**
 	 * Get the number of factored states.
 	 * @return	The number of factors.
 	 */
 	unsigned int get_num_factors();
 
+	/**
+	 * Get the number of states in a particular factor.
+	 * @param	factorIndex			The index of the factor.
+	 * @throw	StateException		The index was invalid.
+	 * @return	The number of states in the factor.
+	 */
+	unsigned int get_factor_size(unsigned int factorIndex) const;
+
+	/**
+	 * Get the index of a state within a particular factor, as of the last update().
+	 * @param	factorIndex			The index of the factor.
+	 * @param	state				The state within the factor.
+	 * @throw	StateException		The factor index was invalid, or the state is not in the factor.
+	 * @return	The index of the state within the factor.
+	 */
+	unsigned int get_factor_index(unsigned int factorIndex, const State *state) const;
+
+	/**
+	 * Get the number of factored states which have been created so far, since they are only made on demand.
+	 * @return	The number of factored states created.
+	 */
+	unsigned int get_num_created() const;
+
 	/**
 	 * Reset the factored states, clearing the internal list and freeing the memory.
 	 */
@@ -136,11 +220,24 @@ protected:
 
 private:
 	/**
-	 * A helper function for updating the internal "states" variable as part of the update() function.
-	 * @param	currentFactoredState	The current (incomplete) factored state as a vector of states.
-	 * @param	currentFactorIndex		The current factor index.
+	 * For each factor, the index of each of its states.
+	 */
+	std::vector<std::unordered_map<const State *, unsigned int> > factorIndexes;
+
+	/**
+	 * For each factor, the index of each of its states by name.
+	 */
+	std::vector<std::unordered_map<std::string, unsigned int> > factorNames;
+
+	/**
+	 * The number of factored states, as of the last update().
+	 */
+	unsigned int numStates;
+
+	/**
+	 * The factored states which have been created, by index.
 	 */
-	void update_step(std::vector<State *> currentFactoredState, unsigned int currentFactorIndex);
+	mutable LazyTable<FactoredState> created;
 
 };
 
@@ -26,6 +26,7 @@
 #define STATES_MAP_H
 
 
+#include <string>
 #include <unordered_map>
 #include <vector>
 
@@ -34,6 +35,60 @@
 
 #include "../actions/action.h"
 
+class StatesMap;
+
+/**
+ * An iterator over the states of a StatesMap, in order of their index. Each state is obtained from
+ * StatesMap::get_state(), so sets of states which are not stored explicitly may create them on demand.
+ */
+class StatesMapIterator {
+public:
+	/**
+	 * The constructor for the StatesMapIterator class.
+	 * @param	statesMap	The set of states.
+	 * @param	index		The index of the current state.
+	 */
+	StatesMapIterator(const StatesMap *statesMap, unsigned int index);
+
+	/**
+	 * Get the current state.
+	 * @return	The current state.
+	 */
+	State *operator*() const;
+
+	/**
+	 * Move to the next state.
+	 * @return	This iterator.
+	 */
+	StatesMapIterator &operator++();
+
+	/**
+	 * Check if two iterators refer to the same state of the same set.
+	 * @param	other	The other iterator.
+	 * @return	Returns @code{true} if they are equal; @code{false} otherwise.
+	 */
+	bool operator==(const StatesMapIterator &other) const;
+
+	/**
+	 * Check if two iterators refer to different states.
+	 * @param	other	The other iterator.
+	 * @return	Returns @code{true} if they are different; @code{false} otherwise.
+	 */
+	bool operator!=(const StatesMapIterator &other) const;
+
+private:
+	/**
+	 * The set of states.
+	 */
+	const StatesMap *statesMap;
+
+	/**
+	 * The index of the current state.
+	 */
+	unsigned int index;
+
+};
+
 /**
  * A class for finite sets of states in an MDP-like object. Informally, there are two basic ways to
  * store finite states: a vector of states or a generator function based on a state and action. In both
@@ -43,6 +98,13 @@
  * If you want to create a generator function-based StatesMap class, please create a child class which
  * implements the function in the virtual functions described below. You will likely ignore the internal
  * states vector variable here.
+ *
+ * States are interned: each distinct state is stored once, contiguously, and assigned a dense index in
+ * 0, ..., n-1 following the order in which it was added. Two different states which share a hash value
+ * are both kept; states are only considered the same if they have the same type and string representation.
+ *
+ * The lookup functions are virtual, and iteration goes through get_state(), so that a child class may
+ * describe its states implicitly (e.g., FactoredStatesMap) instead of storing them in the states vector.
  */
 class StatesMap : virtual public States {
 public:
@@ -63,13 +125,15 @@ public:
 	virtual ~StatesMap();
 
 	/**
-	 * Add a state to the set of available states.
+	 * Add a state to the set of available states. If an equivalent state already exists, then the new state
+	 * takes its place (and its index); otherwise, it is appended and assigned the next index.
 	 * @param	newState	The new state to include in the set of available states.
 	 */
 	void add(State *newState);
 
 	/**
-	 * Remove a state to the set of available states. This frees the memory.
+	 * Remove a state to the set of available states. This frees the memory. The indexes of all states after
+	 * the one removed are decremented.
 	 * @param	removeState 		The state to remove from the set of available states.
 	 * @throw	StateException		The state was not found in the states list.
 	 */
@@ -87,21 +151,47 @@ public:
 	 * @param	state		The state to check if it is created or not.
 	 * @return	Returns @code{true} if the state exists in the states hash; @code{false} otherwise.
 	 */
-	bool exists(const State *state) const;
+	virtual bool exists(const State *state) const;
 
 	/**
-	 * Get a state with a particular hash value.
+	 * Get a state with a particular hash value. If several states share the hash value, then the one
+	 * with the lowest index is returned.
 	 * @param	hash				The hash of the state.
 	 * @throw	StateException		There are no states with the hash value specified.
 	 * @return	The state with the particular hash value specified.
 	 */
-	State *get(unsigned int hash);
+	virtual State *get(unsigned int hash);
+
+	/**
+	 * Get a state by its name. The name of a factored state is the names of its parts separated by spaces.
+	 * Names are recorded as states are added, so this lookup takes constant time.
+	 * @param	name				The name of the state.
+	 * @throw	StateException		There is no state with the name specified.
+	 * @return	The state with the name specified.
+	 */
+	virtual State *get_by_name(const std::string &name) const;
+
+	/**
+	 * Get the dense index of a state, in 0, ..., n-1.
+	 * @param	state				The state to find.
+	 * @throw	StateException		The state was not found in the states list.
+	 * @return	The index of the state.
+	 */
+	virtual unsigned int get_index(const State *state) const;
+
+	/**
+	 * Get the state with a particular dense index.
+	 * @param	index				The index of the state, in 0, ..., n-1.
+	 * @throw	StateException		The index is out of bounds.
+	 * @return	The state with the index specified.
+	 */
+	virtual State *get_state(unsigned int index) const;
 
 	/**
 	 * Return the number of states.
 	 * @return	The number of states.
 	 */
-	unsigned int get_num_states() const;
+	virtual unsigned int get_num_states() const;
 
 	/**
 	 * Reset the states, clearing the internal list and freeing the memory.
@@ -109,36 +199,93 @@ public:
 	virtual void reset();
 
 	/**
-	 * To facilitate easy iteration, return a constant beginning of the states vector.
-	 * @return	The iterator which points to a constant beginning of the states vector.
+	 * To facilitate easy iteration, return an iterator to the first state. States are visited in order
+	 * of their index.
+	 * @return	The iterator which points to the first state.
 	 */
-	std::unordered_map<unsigned int, State *>::iterator begin();
+	StatesMapIterator begin() const;
 
 	/**
-	 * To facilitate easy iteration, return a constant end of the states vector.
-	 * @return	The iterator which points to a constant end of the states vector.
+	 * To facilitate easy iteration, return an iterator past the last state.
+	 * @return	The iterator which points past the last state.
 	 */
-	std::unordered_map<unsigned int, State *>::iterator end();
+	StatesMapIterator end() const;
 
 protected:
 	/**
-	 * The mapping of state hash values to states. This is the main container of states.
+	 * Clear the internal containers without freeing the memory of the states.
+	 */
+	void clear();
+
+	/**
+	 * Check if two states are the same state: either the same object, or of the same type with the
+	 * same hash value and string representation.
+	 * @param	a	The first state.
+	 * @param	b	The second state.
+	 * @return	Returns @code{true} if the states are equivalent; @code{false} otherwise.
 	 */
-	std::unordered_map<unsigned int, State *> states;
+	static bool equivalent(const State *a, const State *b);
 
+	/**
+	 * Find the index of a state equivalent to the one given.
+	 * @param	state	The state to find.
+	 * @return	The index of the equivalent state, or the number of states if none exists.
+	 */
+	unsigned int find(const State *state) const;
+
+	/**
+	 * The states, stored contiguously in order of their index. This is the main container of states.
+	 */
+	std::vector<State *> states;
+
+	/**
+	 * The mapping of state pointers to their index.
+	 */
+	std::unordered_map<const State *, unsigned int> indices;
+
+	/**
+	 * The mapping of state hash values to the indexes of all states with that hash value.
+	 */
+	std::unordered_multimap<unsigned int, unsigned int> hashes;
+
+
+	/**
+	 * Record the name of a state, if it has one, so that it can be found with get_by_name().
+	 * @param	state	The state to record.
+	 */
+	void add_name(State *state);
+
+	/**
+	 * Forget the name of a state, if it was recorded.
+	 * @param	state	The state to forget.
+	 */
+	void remove_name(State *state);
+
+	/**
+	 * Compute the name of a state. Only a NamedState, or a FactoredState made of them, has a name.
+	 * @param	state	The state to name.
+	 * @param	name	The name of the state. This will be modified.
+	 * @return	Returns @code{true} if the state has a name; @code{false} otherwise.
+	 */
+	static bool get_name(State *state, std::string &name);
+
+	/**
+	 * The mapping of names to states.
+	 */
+	std::unordered_map<std::string, State *> names;
 };
 
 /**
  * Get the state pointer of a state iterator.
  * @param	stateIterator	The state iterator to retrieve the state pointer from.
  */
-State *resolve(std::unordered_map<unsigned int, State *>::value_type &stateIterator);
+State *resolve(State *stateIterator);
 
 /**
  * Get the hash of a state iterator.
  * @param	stateIterator	The state iterator to retrieve the hash value from.
  */
-unsigned int hash_value(std::unordered_map<unsigned int, State *>::value_type &stateIterator);
+unsigned int hash_value(State *stateIterator);
 
 
 #endif // STATES_MAP_H
@@ -0,0 +1,314 @@
+/**
+ *  The MIT License (MIT)
+ *
+ *  Copyright (c) 2014 Kyle Hollins Wray, University of Massachusetts
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy of
+ *  this software and associated documentation files (the "Software"), to deal in
+ *  the Software without restriction, including without limitation the rights to
+ *  use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ *  the Software, and to permit persons to whom the Software is furnished to do so,
+ *  subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included in all
+ *  copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ *  FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ *  COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ *  IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ *  CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+
+#ifndef DEC_POMDP_GMAA_STAR_H
+#define DEC_POMDP_GMAA_STAR_H
+
+
+#include <vector>
+
+#include "dec_pomdp.h"
+
+#include "../core/policy/policy_tree.h"
+
+#include "../core/agents/agents.h"
+#include "../core/states/states_map.h"
+#include "../core/states/belief_state.h"
+#include "../core/actions/joint_actions_map.h"
+#include "../core/observations/joint_observations_map.h"
+#include "../core/state_transitions/state_transitions.h"
+#include "../core/observation_transitions/observation_transitions.h"
+#include "../core/rewards/sas_rewards.h"
+#include "../core/horizon.h"
+
+/**
+ * A small structure for a node in the GMAA* search tree, which is a partial joint policy. A partial
+ * joint policy of depth t assigns an action to every agent's observation history of length less than t.
+ */
+struct DecPOMDPGMAAStarNode {
+	/**
+	 * The number of stages (time steps) which have been assigned actions.
+	 */
+	unsigned int depth;
+
+	/**
+	 * For each agent, the index of the action taken after each of its observation histories. Histories
+	 * are stored stage by stage; within stage k the history (o_1, ..., o_k) has the index
+	 * o_1 * |Z_i|^{k-1} + ... + o_k, offset by the number of histories of all prior stages.
+	 */
+	std::vector<std::vector<unsigned int> > policy;
+
+	/**
+	 * The expected reward obtained over the assigned stages, from the initial belief.
+	 */
+	double g;
+
+	/**
+	 * The upper bound on the value of any completion of this partial joint policy (g plus the heuristic).
+	 */
+	double f;
+
+	/**
+	 * The probability of each (state, joint observation history) pair at the current depth. The joint
+	 * history index is mixed-radix over the agents' local history indices, with agent 0 as the most
+	 * significant digit, and this is stored as [joint history * n + state].
+	 */
+	std::vector<double> occupancy;
+
+	/**
+	 * The children not yet placed on the open list, as pairs of an upper bound and an encoded decision
+	 * rule, sorted from worst to best so the best child can be popped off the back. This is only used
+	 * with incremental expansion.
+	 */
+	std::vector<std::pair<double, unsigned long long> > children;
+
+	/**
+	 * Whether or not the children have been generated.
+	 */
+	bool expanded;
+};
+
+/**
+ * Solve a finite horizon Dec-POMDP optimally via Generalized Multi-Agent A* (GMAA*). The search is
+ * over partial joint policies, adding one stage of decision rules for all agents at each depth. Each
+ * partial joint policy is scored with the QMDP upper bound for the remaining stages: the joint
+ * action taken after each joint observation history is valued with the underlying MDP's Q-values.
+ * This solver has the following requirements:
+ * - Dec-POMDP states must be of type StatesMap.
+ * - Dec-POMDP actions must be of type JointActionsMap.
+ * - Dec-POMDP observations must be of type JointObservationsMap.
+ * - Dec-POMDP state transitions must be of type StateTransitions.
+ * - Dec-POMDP observation transitions must be of type ObservationTransitions.
+ * - Dec-POMDP rewards must be of type SASRewards.
+ * - Dec-POMDP horizon must be finite.
+ *
+ * With incremental expansion (the default), a node's children are scored once and kept as compact
+ * (bound, decision rule) pairs; only the best child is materialized and pushed onto the open list,
+ * and the parent is pushed back with the bound of its next best child. This keeps the open list
+ * small on horizons where plain MAA* generates every child at once.
+ */
+class DecPOMDPGMAAStar {
+public:
+	/**
+	 * The default constructor for the DecPOMDPGMAAStar class. Incremental expansion is enabled.
+	 */
+	DecPOMDPGMAAStar();
+
+	/**
+	 * A constructor for the DecPOMDPGMAAStar class which allows for the specification of incremental
+	 * expansion.
+	 * @param	incrementalExpansion	Whether or not to push only the best child at each expansion.
+	 */
+	DecPOMDPGMAAStar(bool incrementalExpansion);
+
+	/**
+	 * The deconstructor for the DecPOMDPGMAAStar class.
+	 */
+	virtual ~DecPOMDPGMAAStar();
+
+	/**
+	 * Set the initial belief over the states from which the joint policy is executed. If this is
+	 * not set, or it is empty, then a uniform belief over the states is used.
+	 * @param	belief		The initial belief over the states.
+	 */
+	virtual void set_initial_belief(const BeliefState &belief);
+
+	/**
+	 * Set whether or not to use incremental expansion of the best child.
+	 * @param	incrementalExpansion	Whether or not to push only the best child at each expansion.
+	 */
+	virtual void set_incremental_expansion(bool incrementalExpansion);
+
+	/**
+	 * Get whether or not incremental expansion of the best child is used.
+	 * @return	Whether or not incremental expansion is used.
+	 */
+	virtual bool get_incremental_expansion() const;
+
+	/**
+	 * Get the expected value of the optimal joint policy from the initial belief. This is only
+	 * defined after calling 'solve'.
+	 * @return	The expected value of the optimal joint policy.
+	 */
+	virtual double get_value() const;
+
+	/**
+	 * Get the number of nodes expanded during the last call to 'solve'.
+	 * @return	The number of nodes expanded.
+	 */
+	virtual unsigned int get_num_nodes_expanded() const;
+
+	/**
+	 * Get the largest size of the open list during the last call to 'solve'.
+	 * @return	The largest size of the open list.
+	 */
+	virtual unsigned int get_max_open_list_size() const;
+
+	/**
+	 * Solve the Dec-POMDP provided using GMAA*.
+	 * @param	decpomdp							The decentralized partially observable Markov decision process to solve.
+	 * @throw	CoreException						The Dec-POMDP was null, or it had no agents or an infinite horizon.
+	 * @throw	StateException						The Dec-POMDP did not have a StatesMap states object.
+	 * @throw	ActionException						The Dec-POMDP did not have a JointActionsMap actions object.
+	 * @throw	ObservationException				The Dec-POMDP did not have a JointObservationsMap observations object.
+	 * @throw	StateTransitionsException			The Dec-POMDP did not have a StateTransitions state transitions object.
+	 * @throw	ObservationTransitionsException		The Dec-POMDP did not have an ObservationTransitions observation transitions object.
+	 * @throw	RewardException						The Dec-POMDP did not have a SASRewards rewards object.
+	 * @throw	PolicyException						The decision rules were too many to enumerate.
+	 * @return	Return the optimal joint policy as one policy tree per agent, in the order of the agents.
+	 */
+	virtual std::vector<PolicyTree *> solve(DecPOMDP *decpomdp);
+
+protected:
+	/**
+	 * Solve a finite horizon Dec-POMDP using GMAA*.
+	 * @param	N					The agents.
+	 * @param	S					The finite states.
+	 * @param	A					The joint actions.
+	 * @param	Z					The joint observations.
+	 * @param	T					The finite state transition function.
+	 * @param	O					The finite observation transition function.
+	 * @param	R					The state-action-state rewards.
+	 * @param	h					The horizon.
+	 * @throw	PolicyException		The decision rules were too many to enumerate.
+	 * @return	Return the optimal joint policy as one policy tree per agent.
+	 */
+	virtual std::vector<PolicyTree *> solve_finite_horizon(Agents *N, StatesMap *S, JointActionsMap *A,
+			JointObservationsMap *Z, StateTransitions *T, ObservationTransitions *O, SASRewards *R,
+			Horizon *h);
+
+	/**
+	 * Compute the QMDP values for each number of remaining stages, as well as the expected immediate
+	 * rewards, transitions, and observations over the indexed model.
+	 * @param	T	The finite state transition function.
+	 * @param	O	The finite observation transition function.
+	 * @param	R	The state-action-state rewards.
+	 */
+	virtual void compute_model(StateTransitions *T, ObservationTransitions *O, SASRewards *R);
+
+	/**
+	 * Generate the children of a node: score every joint decision rule for the next stage. Children
+	 * whose bound is below the best complete joint policy found so far are discarded. At the final
+	 * stage, only the best child is kept.
+	 * @param	node				The node to expand.
+	 * @param	lowerBound			The value of the best complete joint policy found so far.
+	 * @throw	PolicyException		The decision rules were too many to enumerate.
+	 */
+	virtual void generate_children(DecPOMDPGMAAStarNode *node, double lowerBound);
+
+	/**
+	 * Create a child node from its parent and an encoded decision rule for the parent's stage.
+	 * @param	parent		The parent node.
+	 * @param	rule		The encoded joint decision rule (as produced by generate_children).
+	 * @param	f			The child's upper bound.
+	 * @return	The new child node.
+	 */
+	virtual DecPOMDPGMAAStarNode *create_child(DecPOMDPGMAAStarNode *parent, unsigned long long rule, double f);
+
+	/**
+	 * Whether or not to push only the best child at each expansion.
+	 */
+	bool incremental;
+
+	/**
+	 * The initial belief over the states.
+	 */
+	BeliefState initialBelief;
+
+	/**
+	 * The expected value of the optimal joint policy.
+	 */
+	double value;
+
+	/**
+	 * The number of nodes expanded during the last call to 'solve'.
+	 */
+	unsigned int numNodesExpanded;
+
+	/**
+	 * The largest size of the open list during the last call to 'solve'.
+	 */
+	unsigned int maxOpenListSize;
+
+	/**
+	 * The horizon of the Dec-POMDP being solved.
+	 */
+	unsigned int horizon;
+
+	/**
+	 * The discount factor of the Dec-POMDP being solved.
+	 */
+	double gamma;
+
+	/**
+	 * The states of the Dec-POMDP being solved, in index order.
+	 */
+	std::vector<State *> states;
+
+	/**
+	 * The number of actions of each agent.
+	 */
+	std::vector<unsigned int> numAgentActions;
+
+	/**
+	 * The number of observations of each agent.
+	 */
+	std::vector<unsigned int> numAgentObservations;
+
+	/**
+	 * The joint actions, indexed mixed-radix over the agents' local action indices with agent 0
+	 * as the most significant digit.
+	 */
+	std::vector<Action *> jointActions;
+
+	/**
+	 * The joint observations, indexed mixed-radix over the agents' local observation indices with
+	 * agent 0 as the most significant digit.
+	 */
+	std::vector<Observation *> jointObservations;
+
+	/**
+	 * The state transitions over the indexed model, as [s * m * n + a * n + s'].
+	 */
+	std::vector<double> Tsas;
+
+	/**
+	 * The observation transitions over the indexed model, as [a * n * z + s' * z + o].
+	 */
+	std::vector<double> Oaso;
+
+	/**
+	 * The expected immediate rewards over the indexed model, as [s * m + a].
+	 */
+	std::vector<double> Rsa;
+
+	/**
+	 * The QMDP values [s * m + a] for each number of remaining stages (index 0 is one stage remaining).
+	 */
+	std::vector<std::vector<double> > Q;
+
+};
+
+
+#endif // DEC_POMDP_GMAA_STAR_H
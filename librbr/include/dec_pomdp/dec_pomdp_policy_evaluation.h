@@ -0,0 +1,290 @@
+/**
+ *  The MIT License (MIT)
+ *
+ *  Copyright (c) 2014 Kyle Hollins Wray, University of Massachusetts
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy of
+ *  this software and associated documentation files (the "Software"), to deal in
+ *  the Software without restriction, including without limitation the rights to
+ *  use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ *  the Software, and to permit persons to whom the Software is furnished to do so,
+ *  subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included in all
+ *  copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ *  FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ *  COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ *  IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ *  CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+
+#ifndef DEC_POMDP_POLICY_EVALUATION_H
+#define DEC_POMDP_POLICY_EVALUATION_H
+
+
+#include <vector>
+#include <unordered_map>
+
+#include "dec_pomdp.h"
+
+#include "../core/policy/policy_tree.h"
+
+#include "../core/states/state.h"
+#include "../core/states/belief_state.h"
+#include "../core/actions/action.h"
+#include "../core/observations/observation.h"
+
+/**
+ * A hash for a vector of unsigned integers, used to intern policy tree nodes and joint nodes.
+ */
+struct DecPOMDPPolicyEvaluationKeyHash {
+	/**
+	 * Compute the hash of the key.
+	 * @param	key		The vector of unsigned integers.
+	 * @return	The hash value of the key.
+	 */
+	std::size_t operator()(const std::vector<unsigned int> &key) const;
+};
+
+/**
+ * Evaluate joint policies for a Dec-POMDP, given as one PolicyTree per agent. The value
+ * V(s, q_1, ..., q_n) of each state and joint node is computed by dynamic programming:
+ *
+ * V(s, q) = R(s, a_q) + gamma * sum_{s'} T(s, a_q, s') sum_{o} O(a_q, s', o) V(s', q_o).
+ *
+ * Each agent's tree is compiled into compact node IDs, where identical subtrees (the same action
+ * and the same children) share an ID. A joint node is a tuple of these IDs, itself interned to a
+ * compact joint ID, and the values over all states are memoized per joint ID. Since the IDs are
+ * determined by the subtrees, they remain valid when an agent's tree is replaced with set_policy:
+ * only joint nodes which include a new subtree are evaluated.
+ *
+ * New joint nodes are evaluated bottom-up, one depth at a time, splitting the states among
+ * threads. The Dec-POMDP must satisfy the same requirements as for DecPOMDPGMAAStar, except
+ * that the horizon is only used for its discount factor; the depth of the trees is the horizon.
+ */
+class DecPOMDPPolicyEvaluation {
+public:
+	/**
+	 * The constructor for the DecPOMDPPolicyEvaluation class, using one thread per hardware thread.
+	 * @param	decpomdp							The Dec-POMDP whose joint policies will be evaluated.
+	 * @throw	CoreException						The Dec-POMDP was null, or it had no agents.
+	 * @throw	StateException						The Dec-POMDP did not have a StatesMap states object.
+	 * @throw	ActionException						The Dec-POMDP did not have a JointActionsMap actions object.
+	 * @throw	ObservationException				The Dec-POMDP did not have a JointObservationsMap observations object.
+	 * @throw	StateTransitionsException			The Dec-POMDP did not have a StateTransitions state transitions object.
+	 * @throw	ObservationTransitionsException		The Dec-POMDP did not have an ObservationTransitions observation transitions object.
+	 * @throw	RewardException						The Dec-POMDP did not have a SASRewards rewards object.
+	 */
+	DecPOMDPPolicyEvaluation(DecPOMDP *decpomdp);
+
+	/**
+	 * The constructor for the DecPOMDPPolicyEvaluation class which specifies the number of threads.
+	 * @param	decpomdp							The Dec-POMDP whose joint policies will be evaluated.
+	 * @param	numThreads							The number of threads to use (at least 1).
+	 * @throw	CoreException						The Dec-POMDP was null, or it had no agents.
+	 * @throw	StateException						The Dec-POMDP did not have a StatesMap states object.
+	 * @throw	ActionException						The Dec-POMDP did not have a JointActionsMap actions object.
+	 * @throw	ObservationException				The Dec-POMDP did not have a JointObservationsMap observations object.
+	 * @throw	StateTransitionsException			The Dec-POMDP did not have a StateTransitions state transitions object.
+	 * @throw	ObservationTransitionsException		The Dec-POMDP did not have an ObservationTransitions observation transitions object.
+	 * @throw	RewardException						The Dec-POMDP did not have a SASRewards rewards object.
+	 */
+	DecPOMDPPolicyEvaluation(DecPOMDP *decpomdp, unsigned int numThreads);
+
+	/**
+	 * The deconstructor for the DecPOMDPPolicyEvaluation class.
+	 */
+	virtual ~DecPOMDPPolicyEvaluation();
+
+	/**
+	 * Set the policy trees of all agents.
+	 * @param	policies			The policy trees, one for each agent, in the order of the agents.
+	 * @throw	PolicyException		There was not one policy per agent, or a policy was not defined
+	 * 								over the agent's actions and observations.
+	 */
+	void set_policies(const std::vector<PolicyTree *> &policies);
+
+	/**
+	 * Set the policy tree of a single agent, keeping the others fixed. Previously computed values
+	 * for unchanged subtrees are reused.
+	 * @param	agentIndex			The index of the agent.
+	 * @param	policy				The agent's new policy tree.
+	 * @throw	PolicyException		The agent index was invalid, or the policy was not defined over
+	 * 								the agent's actions and observations.
+	 */
+	void set_policy(unsigned int agentIndex, PolicyTree *policy);
+
+	/**
+	 * Evaluate the joint policy from a start state.
+	 * @param	state				The start state.
+	 * @throw	StateException		The state was not found.
+	 * @throw	PolicyException		The policies of all agents have not been set.
+	 * @return	The expected value of the joint policy from the start state.
+	 */
+	double evaluate(State *state);
+
+	/**
+	 * Evaluate the joint policy from an initial belief.
+	 * @param	belief				The initial belief over the states.
+	 * @throw	PolicyException		The policies of all agents have not been set.
+	 * @return	The expected value of the joint policy from the initial belief.
+	 */
+	double evaluate(const BeliefState &belief);
+
+	/**
+	 * Set the number of threads used to evaluate new joint nodes.
+	 * @param	numThreads		The number of threads to use (at least 1).
+	 */
+	void set_num_threads(unsigned int numThreads);
+
+	/**
+	 * Get the number of threads used to evaluate new joint nodes.
+	 * @return	The number of threads to use.
+	 */
+	unsigned int get_num_threads() const;
+
+	/**
+	 * Get the number of joint nodes whose values have been memoized.
+	 * @return	The number of joint nodes evaluated so far.
+	 */
+	unsigned int get_num_joint_nodes() const;
+
+	/**
+	 * Clear all compiled nodes and memoized values, keeping the model.
+	 */
+	void reset();
+
+protected:
+	/**
+	 * Compile an agent's policy tree into compact node IDs, interning identical subtrees.
+	 * @param	agentIndex			The index of the agent.
+	 * @param	node				The current node of the policy tree.
+	 * @throw	PolicyException		The policy was not defined over the agent's actions and observations.
+	 * @return	The compact ID of the node.
+	 */
+	unsigned int compile(unsigned int agentIndex, PolicyTreeNode *node);
+
+	/**
+	 * Ensure the values of the joint node of the agents' current roots have been computed, evaluating
+	 * all new joint nodes reachable from it.
+	 * @throw	PolicyException		The policies of all agents have not been set.
+	 * @return	The compact joint ID of the root joint node.
+	 */
+	unsigned int update();
+
+	/**
+	 * Get the compact joint ID of a joint node, creating it (unevaluated) if it is new.
+	 * @param	jointNode	The joint node, as one node ID per agent.
+	 * @return	The compact joint ID of the joint node.
+	 */
+	unsigned int intern(const std::vector<unsigned int> &jointNode);
+
+	/**
+	 * Compute the values of a set of joint nodes for the states in a range, assuming the values of
+	 * their children have been computed.
+	 * @param	jointNodes		The compact joint IDs to evaluate.
+	 * @param	first			The first state index.
+	 * @param	last			One past the last state index.
+	 */
+	void compute_values(const std::vector<unsigned int> &jointNodes, unsigned int first, unsigned int last);
+
+	/**
+	 * The number of threads to use.
+	 */
+	unsigned int threads;
+
+	/**
+	 * The discount factor.
+	 */
+	double gamma;
+
+	/**
+	 * The states, in index order.
+	 */
+	std::vector<State *> states;
+
+	/**
+	 * The index of each state.
+	 */
+	std::unordered_map<State *, unsigned int> stateIndices;
+
+	/**
+	 * The local index of each action, for each agent.
+	 */
+	std::vector<std::unordered_map<Action *, unsigned int> > agentActions;
+
+	/**
+	 * The observations of each agent, in local index order.
+	 */
+	std::vector<std::vector<Observation *> > agentObservations;
+
+	/**
+	 * The expected immediate rewards over the indexed model, as [s * m + a], with joint actions
+	 * indexed mixed-radix over the agents' local actions (agent 0 most significant).
+	 */
+	std::vector<double> Rsa;
+
+	/**
+	 * The non-zero state transitions for each [s * m + a], as pairs of a next state index and a probability.
+	 */
+	std::vector<std::vector<std::pair<unsigned int, double> > > successors;
+
+	/**
+	 * The non-zero observation transitions for each [a * n + s'], as pairs of a joint observation index
+	 * (mixed-radix over the agents' local observations) and a probability.
+	 */
+	std::vector<std::vector<std::pair<unsigned int, double> > > observations;
+
+	/**
+	 * For each agent, the intern table from a node's signature (action, then children IDs) to its ID.
+	 */
+	std::vector<std::unordered_map<std::vector<unsigned int>, unsigned int, DecPOMDPPolicyEvaluationKeyHash> > nodeIDs;
+
+	/**
+	 * For each agent, the signature of each node ID.
+	 */
+	std::vector<std::vector<std::vector<unsigned int> > > nodes;
+
+	/**
+	 * The ID of each agent's current root node, or -1 if it is not set.
+	 */
+	std::vector<int> roots;
+
+	/**
+	 * The intern table from a joint node (one node ID per agent) to its joint ID.
+	 */
+	std::unordered_map<std::vector<unsigned int>, unsigned int, DecPOMDPPolicyEvaluationKeyHash> jointNodeIDs;
+
+	/**
+	 * The joint node (one node ID per agent) of each joint ID.
+	 */
+	std::vector<std::vector<unsigned int> > jointNodes;
+
+	/**
+	 * The joint action of each joint ID.
+	 */
+	std::vector<unsigned int> jointActions;
+
+	/**
+	 * The child joint ID of each joint ID following each joint observation; empty for leaves.
+	 */
+	std::vector<std::vector<unsigned int> > jointChildren;
+
+	/**
+	 * Whether or not the values of each joint ID have been computed.
+	 */
+	std::vector<bool> evaluated;
+
+	/**
+	 * The memoized values, as [joint ID * n + s].
+	 */
+	std::vector<double> values;
+
+};
+
+
+#endif // DEC_POMDP_POLICY_EVALUATION_H
@@ -36,6 +36,8 @@
 #include "../mdp/mdp.h"
 #include "../pomdp/pomdp.h"
 
+#include <vector>
+
 /**
  * Convert a map-based MDP to an array-based MDP.
  * @param	mdp				The map-based MDP, which must have map state
@@ -70,5 +72,22 @@ MDP *convert_map_to_array(StatesMap *states, ActionsMap *actions,
  */
 POMDP *convert_map_to_array(POMDP *pomdp);
 
+/**
+ * Convert a map-based POMDP to an array-based POMDP, with indexed states, actions, and observations,
+ * and also provide the original state, action, and observation of each index, e.g., to output a policy
+ * of the array-based POMDP in terms of the original objects. These remain owned by the original POMDP.
+ * The conversion is split by states over as many threads as the hardware supports.
+ * @param	pomdp					The map-based POMDP, whose states, actions, and observations must be maps,
+ * 									and whose rewards must be SASO rewards (SAS rewards are converted to a
+ * 									smaller array).
+ * @param	originalStates			The resulting original state of each state index.
+ * @param	originalActions			The resulting original action of each action index.
+ * @param	originalObservations	The resulting original observation of each observation index.
+ * @throw	CoreException			The POMDP provided was invalid.
+ * @return	The new array-based POMDP, for its rewards and its state and observation transitions.
+ */
+POMDP *convert_map_to_array(POMDP *pomdp, std::vector<State *> &originalStates,
+		std::vector<Action *> &originalActions, std::vector<Observation *> &originalObservations);
+
 
 #endif // CONVERSION_H
@@ -0,0 +1,78 @@
+/**
+ *  The MIT License (MIT)
+ *
+ *  Copyright (c) 2014 Kyle Hollins Wray, University of Massachusetts
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy of
+ *  this software and associated documentation files (the "Software"), to deal in
+ *  the Software without restriction, including without limitation the rights to
+ *  use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ *  the Software, and to permit persons to whom the Software is furnished to do so,
+ *  subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included in all
+ *  copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ *  FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ *  COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ *  IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ *  CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+
+#ifndef FINGERPRINT_H
+#define FINGERPRINT_H
+
+
+#include "../mdp/mdp.h"
+
+#include <string>
+#include <cstdint>
+#include <cstddef>
+
+/**
+ * The offset basis of the 64-bit FNV-1a hash used for fingerprints.
+ */
+#define FINGERPRINT_OFFSET_BASIS 14695981039346656037ULL
+
+/**
+ * The prime of the 64-bit FNV-1a hash used for fingerprints.
+ */
+#define FINGERPRINT_PRIME 1099511628211ULL
+
+/**
+ * Add raw bytes to a 64-bit FNV-1a hash.
+ * @param	hash	The hash so far, which will be modified.
+ * @param	data	The bytes to add.
+ * @param	size	The number of bytes.
+ */
+void fingerprint_bytes(uint64_t &hash, const void *data, size_t size);
+
+/**
+ * Compute a stable fingerprint of *any* MDP, POMDP, or Dec-POMDP, in one streaming pass over the
+ * model. It covers the state, action, and observation names (in the order of order_policy_states,
+ * order_policy_actions, and order_policy_observations), the non-zero state and observation
+ * transitions, the non-zero rewards of reachable successors, and the horizon. Transitions are found through 'successors'
+ * and 'available', so the cost is proportional to the number of non-zero entries, and the same
+ * model stored as maps or arrays has the same fingerprint. The fingerprint does not depend on
+ * memory addresses, so it is the same across processes.
+ * @param	mdp				The MDP, POMDP, or Dec-POMDP.
+ * @throw	CoreException	The model did not have StatesMap states, ActionsMap actions, or
+ * 							ObservationsMap observations, its rewards were not understood, or a
+ * 							successor or available observation was not in the model.
+ * @return	The fingerprint of the model.
+ */
+uint64_t fingerprint_model(MDP *mdp);
+
+/**
+ * Combine a model fingerprint with a key, e.g., a description of a solver and its parameters.
+ * @param	fingerprint		The fingerprint of the model.
+ * @param	key				The key.
+ * @return	The combined fingerprint.
+ */
+uint64_t fingerprint_key(uint64_t fingerprint, const std::string &key);
+
+
+#endif // FINGERPRINT_H
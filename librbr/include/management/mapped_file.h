@@ -0,0 +1,91 @@
+/**
+ *  The MIT License (MIT)
+ *
+ *  Copyright (c) 2014 Kyle Hollins Wray, University of Massachusetts
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy of
+ *  this software and associated documentation files (the "Software"), to deal in
+ *  the Software without restriction, including without limitation the rights to
+ *  use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ *  the Software, and to permit persons to whom the Software is furnished to do so,
+ *  subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included in all
+ *  copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ *  FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ *  COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ *  IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ *  CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+
+#ifndef MAPPED_FILE_H
+#define MAPPED_FILE_H
+
+
+#include <string>
+#include <cstddef>
+
+/**
+ * A read-only file mapped into memory. The mapping is private (copy-on-write): pages are loaded
+ * lazily and shared with every other process mapping the same file, and any writes made through
+ * the data pointer stay local to this process and never reach the file. The file is unmapped
+ * when this object is destroyed.
+ */
+class MappedFile {
+public:
+	/**
+	 * The default constructor for the MappedFile class, which maps the entire file.
+	 * @param	filename		The name of the file to map.
+	 * @throw	CoreException	The file could not be opened or mapped, or it was empty.
+	 */
+	MappedFile(std::string filename);
+
+	/**
+	 * The deconstructor for the MappedFile class, which unmaps the file.
+	 */
+	virtual ~MappedFile();
+
+	/**
+	 * Get the start of the mapped file.
+	 * @return	A pointer to the first byte of the file.
+	 */
+	char *get_data();
+
+	/**
+	 * Get the size of the mapped file.
+	 * @return	The number of bytes in the file.
+	 */
+	std::size_t get_size() const;
+
+private:
+	/**
+	 * The copy constructor for the MappedFile class, which is not allowed.
+	 * @param	other	The mapped file to copy.
+	 */
+	MappedFile(const MappedFile &other);
+
+	/**
+	 * The start of the mapped file.
+	 */
+	char *data;
+
+	/**
+	 * The number of bytes in the file.
+	 */
+	std::size_t size;
+
+#ifdef _WIN32
+	/**
+	 * The handle of the file mapping object.
+	 */
+	void *mapping;
+#endif
+
+};
+
+
+#endif // MAPPED_FILE_H
@@ -0,0 +1,143 @@
+/**
+ *  The MIT License (MIT)
+ *
+ *  Copyright (c) 2014 Kyle Hollins Wray, University of Massachusetts
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy of
+ *  this software and associated documentation files (the "Software"), to deal in
+ *  the Software without restriction, including without limitation the rights to
+ *  use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ *  the Software, and to permit persons to whom the Software is furnished to do so,
+ *  subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included in all
+ *  copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ *  FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ *  COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ *  IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ *  CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+
+#ifndef POLICY_CACHE_H
+#define POLICY_CACHE_H
+
+
+#include "../mdp/mdp.h"
+#include "../pomdp/pomdp.h"
+
+#include "../core/policy/policy_map.h"
+#include "../core/policy/policy_alpha_vectors.h"
+
+#include <string>
+#include <cstdint>
+
+/**
+ * A directory of binary policy files, which solvers consult before solving. Each policy is stored
+ * under the fingerprint of its model combined with a key describing the solver and its parameters,
+ * so a cache hit costs one pass over the model for its fingerprint and a file map, instead of a
+ * full solve. Files are written under a temporary name and then renamed, so a reader never sees a
+ * partially written policy.
+ */
+class PolicyCache {
+public:
+	/**
+	 * The constructor for a PolicyCache object.
+	 * @param	directory	The directory which holds the policy files. It must already exist.
+	 */
+	PolicyCache(std::string directory);
+
+	/**
+	 * The default deconstructor for a PolicyCache object.
+	 */
+	virtual ~PolicyCache();
+
+	/**
+	 * Get the directory which holds the policy files.
+	 * @return	The directory which holds the policy files.
+	 */
+	std::string get_directory() const;
+
+	/**
+	 * Get the name of the policy file for a model fingerprint and solver key.
+	 * @param	fingerprint		The fingerprint of the model.
+	 * @param	key				The description of the solver and its parameters.
+	 * @return	The name and path of the policy file.
+	 */
+	std::string get_filename(uint64_t fingerprint, const std::string &key) const;
+
+	/**
+	 * Load a cached policy map for an MDP.
+	 * @param	mdp				The MDP, which must have StatesMap states and ActionsMap actions.
+	 * @param	fingerprint		The fingerprint of the model.
+	 * @param	key				The description of the solver and its parameters.
+	 * @return	The policy, or nullptr if it was not in the cache.
+	 */
+	PolicyMap *load_policy_map(MDP *mdp, uint64_t fingerprint, const std::string &key);
+
+	/**
+	 * Save a policy map for an MDP into the cache.
+	 * @param	mdp				The MDP, which must have StatesMap states and ActionsMap actions.
+	 * @param	fingerprint		The fingerprint of the model.
+	 * @param	key				The description of the solver and its parameters.
+	 * @param	policy			The policy to save.
+	 * @return	Return @code{true} if an error occurred, @code{false} otherwise.
+	 */
+	bool save_policy_map(MDP *mdp, uint64_t fingerprint, const std::string &key, PolicyMap *policy);
+
+	/**
+	 * Load cached alpha vectors for a POMDP.
+	 * @param	pomdp			The POMDP, which must have StatesMap states and ActionsMap actions.
+	 * @param	fingerprint		The fingerprint of the model.
+	 * @param	key				The description of the solver and its parameters.
+	 * @return	The policy, or nullptr if it was not in the cache.
+	 */
+	PolicyAlphaVectors *load_policy_alpha_vectors(POMDP *pomdp, uint64_t fingerprint, const std::string &key);
+
+	/**
+	 * Save alpha vectors for a POMDP into the cache.
+	 * @param	pomdp			The POMDP, which must have StatesMap states and ActionsMap actions.
+	 * @param	fingerprint		The fingerprint of the model.
+	 * @param	key				The description of the solver and its parameters.
+	 * @param	policy			The policy to save.
+	 * @return	Return @code{true} if an error occurred, @code{false} otherwise.
+	 */
+	bool save_policy_alpha_vectors(POMDP *pomdp, uint64_t fingerprint, const std::string &key,
+			PolicyAlphaVectors *policy);
+
+private:
+	/**
+	 * Check if a file exists, so that a cache miss does not log an error.
+	 * @param	filename	The name and path of the file.
+	 * @return	Return @code{true} if the file exists, @code{false} otherwise.
+	 */
+	bool exists(const std::string &filename) const;
+
+	/**
+	 * Get a temporary file name for a policy file which no other writer uses, so that only the final
+	 * rename is shared between writers saving the same policy, even across processes.
+	 * @param	filename	The final name and path of the file.
+	 * @return	The name and path of the temporary file.
+	 */
+	std::string get_temporary_filename(const std::string &filename) const;
+
+	/**
+	 * Move a temporary file to its final name.
+	 * @param	temporary	The name and path of the temporary file.
+	 * @param	filename	The final name and path of the file.
+	 * @return	Return @code{true} if an error occurred, @code{false} otherwise.
+	 */
+	bool commit(const std::string &temporary, const std::string &filename) const;
+
+	/**
+	 * The directory which holds the policy files.
+	 */
+	std::string directory;
+
+};
+
+
+#endif // POLICY_CACHE_H
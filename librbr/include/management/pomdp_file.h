@@ -31,11 +31,26 @@
 #include "../dec_pomdp/dec_pomdp.h"
 
 #include "../core/states/belief_state.h"
+#include "../core/states/states_map.h"
+#include "../core/actions/actions_map.h"
+#include "../core/observations/observations_map.h"
 
 #include <fstream>
+#include <string>
+#include <vector>
 
 /**
- * A class which provides functionality save a Cassandra POMDP file into a array-based Markovian object.
+ * The number of bytes buffered by POMDPFile before each write to the output file.
+ */
+#define POMDP_FILE_BUFFER_SIZE (1 << 20)
+
+/**
+ * A class which provides functionality save *any* MDP or POMDP as a Cassandra file, and
+ * *any* Dec-POMDP as a MADP-style Dec-POMDP file. States, actions, and observations are
+ * written as their indexes: indexed objects keep their index, and any others are numbered
+ * in the order of iteration. Only non-zero probabilities and rewards are written, found
+ * through 'successors' and 'available', so the file size is proportional to the number
+ * of non-zero entries in the model.
  */
 class POMDPFile {
 public:
@@ -55,29 +70,123 @@ public:
 	 * @param	filename		The name of the output file.
 	 * @throw	CoreException	An error arose trying to save the MDP object. This could be
 	 * 							an invalid mdp was provided, or the filename was invalid.
-	 * ToDo: Implement saving pomdp files.
 	 */
-//	void save_mdp(MDP *mdp, std::string filename);
+	void save_mdp(MDP *mdp, std::string filename);
 
 	/**
 	 * A method which simply saves *any* POMDP object as a Cassandra POMDP file.
 	 * @param	pomdp			The POMDP object to save.
 	 * @param	filename		The name of the output file.
-	 * @param	start			The starting belief state.
+	 * @param	start			The starting belief state, or nullptr for a uniform belief.
 	 * @throw	CoreException	An error arose trying to save the POMDP object. This could
 	 * 							be an invalid mdp was provided, or the filename was invalid.
 	 */
 	void save_pomdp(POMDP *pomdp, std::string filename, BeliefState *start);
 
 	/**
-	 * A method which simply saves *any* Dec-POMDP object as a raw Dec-POMDP file.
+	 * A method which simply saves *any* Dec-POMDP object as a MADP-style Dec-POMDP file. Joint
+	 * actions and joint observations are written as the index of each agent's part.
 	 * @param	decpomdp		The Dec-POMDP object to save.
 	 * @param	filename		The name of the output file.
+	 * @param	start			The starting belief state, or nullptr for a uniform belief.
 	 * @throw	CoreException	An error arose trying to save the Dec-POMDP object. This could
 	 * 							be an invalid mdp was provided, or the filename was invalid.
-	 * ToDo: Implement saving dec-pomdp files.
 	 */
-//	void save_decpomdp(DecPOMDP *decpomdp, std::string filename);
+	void save_decpomdp(DecPOMDP *decpomdp, std::string filename, BeliefState *start);
+
+private:
+	/**
+	 * Write the state transitions, observation transitions, and rewards of a model.
+	 * @param	mdp					The model to save.
+	 * @param	O					The observation transitions; nullptr for an MDP.
+	 * @param	S					The states in index order.
+	 * @param	A					The actions in index order.
+	 * @param	Z					The observations in index order; empty for an MDP.
+	 * @param	actionNames			The name written for each action, in index order.
+	 * @param	observationNames	The name written for each observation, in index order.
+	 * @param	separator			The text written before each value: " " for Cassandra or " : " for MADP.
+	 * @throw	CoreException		The rewards were not SA, SAS, or SASO rewards, or a successor was not a state.
+	 */
+	void save_body(MDP *mdp, ObservationTransitions *O, const std::vector<State *> &S,
+			const std::vector<Action *> &A, const std::vector<Observation *> &Z,
+			const std::vector<std::string> &actionNames, const std::vector<std::string> &observationNames,
+			std::string separator);
+
+	/**
+	 * Get the successors of a state and action, or all states if the successors are not known.
+	 * @param	T			The state transitions.
+	 * @param	states		The states object of the model.
+	 * @param	S			The states in index order.
+	 * @param	state		The current state.
+	 * @param	action		The action taken.
+	 * @return	The states which may have a non-zero probability of following.
+	 */
+	const std::vector<State *> &successors(StateTransitions *T, States *states, const std::vector<State *> &S,
+			State *state, Action *action);
+
+	/**
+	 * Get the available observations of an action and state, or all observations if they are not known.
+	 * @param	O				The observation transitions.
+	 * @param	observations	The observations object of the model.
+	 * @param	Z				The observations in index order.
+	 * @param	action			The previous action.
+	 * @param	state			The resulting state.
+	 * @return	The observations which may have a non-zero probability.
+	 */
+	const std::vector<Observation *> &available(ObservationTransitions *O, Observations *observations,
+			const std::vector<Observation *> &Z, Action *action, State *state);
+
+	/**
+	 * Write the starting belief as one probability per state, or "uniform" if none is given.
+	 * @param	S		The states in index order.
+	 * @param	start	The starting belief state, or nullptr for a uniform belief.
+	 */
+	void save_start(const std::vector<State *> &S, BeliefState *start);
+
+	/**
+	 * Open the output file and prepare the buffer.
+	 * @param	filename		The name of the output file.
+	 * @param	function		The name of the calling function, for logging.
+	 * @throw	CoreException	The file could not be created.
+	 */
+	void open(std::string filename, std::string function);
+
+	/**
+	 * Write any remaining buffered output and close the output file.
+	 */
+	void close();
+
+	/**
+	 * Append text to the output buffer, writing the buffer to the file once it is full.
+	 * @param	text	The text to append.
+	 */
+	void append(const std::string &text);
+
+	/**
+	 * Append a number to the output buffer, using few digits which still read back as the same value.
+	 * @param	value	The number to append.
+	 */
+	void append(double value);
+
+	/**
+	 * The output file.
+	 */
+	std::ofstream file;
+
+	/**
+	 * The output buffer, which is written to the file every POMDP_FILE_BUFFER_SIZE bytes.
+	 */
+	std::string buffer;
+
+	/**
+	 * The last number appended to the buffer.
+	 */
+	double lastValue;
+
+	/**
+	 * The text of the last number appended to the buffer.
+	 */
+	std::string lastText;
 
 };
 
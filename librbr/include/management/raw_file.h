@@ -30,7 +30,17 @@
 #include "../pomdp/pomdp.h"
 #include "../dec_pomdp/dec_pomdp.h"
 
+#include "../core/states/states_map.h"
+#include "../core/actions/actions_map.h"
+#include "../core/actions/joint_actions_map.h"
+#include "../core/observations/observations_map.h"
+#include "../core/observations/joint_observations_map.h"
+
+#include "../utilities/tokenizer.h"
+
 #include <fstream>
+#include <vector>
+#include <cstdint>
 
 /**
  * An enumeration for the types of rewards that are possible.
@@ -43,6 +53,207 @@ enum RawFileRewardsType {
 	NumRawFileRewardsTypes
 };
 
+/**
+ * The version of the binary model format written by RawFile. Files with another version are rejected.
+ */
+#define RAW_FILE_BINARY_VERSION 1
+
+/**
+ * The alignment, in bytes, of every block in a binary model file.
+ */
+#define RAW_FILE_BINARY_ALIGNMENT 64
+
+/**
+ * An enumeration for the types of models stored in a binary model file.
+ */
+enum RawFileBinaryModelType {
+	RawFileBinaryMDP,
+	RawFileBinaryStreamedMDP,
+	NumRawFileBinaryModelTypes
+};
+
+/**
+ * The approximate number of bytes in each block of a streamed MDP file. A block holds whole states,
+ * so it is larger if a single state has more non-zero state transitions than this.
+ */
+#define RAW_FILE_STREAM_BLOCK_SIZE (1 << 24)
+
+/**
+ * An enumeration for the types of blocks in a binary model file.
+ */
+enum RawFileBinaryBlockType {
+	RawFileBinaryStateTransitions,
+	RawFileBinaryRewards,
+	NumRawFileBinaryBlockTypes
+};
+
+/**
+ * An enumeration for the encodings of blocks in a binary model file.
+ */
+enum RawFileBinaryEncoding {
+	RawFileBinaryDense,
+	NumRawFileBinaryEncodings
+};
+
+/**
+ * The header at the start of a binary model file (64 bytes), followed by the table of blocks.
+ */
+struct RawFileBinaryHeader {
+	/**
+	 * The magic bytes identifying the file: "LIBRBR" followed by two zero bytes.
+	 */
+	char magic[8];
+
+	/**
+	 * The version of the format.
+	 */
+	uint32_t version;
+
+	/**
+	 * The value 0x01020304 as written by the saving machine, used to detect a different byte order.
+	 */
+	uint32_t byteOrder;
+
+	/**
+	 * The type of model, from RawFileBinaryModelType.
+	 */
+	uint32_t modelType;
+
+	/**
+	 * The number of states.
+	 */
+	uint32_t numStates;
+
+	/**
+	 * The number of actions.
+	 */
+	uint32_t numActions;
+
+	/**
+	 * The number of reward factors.
+	 */
+	uint32_t numRewardFactors;
+
+	/**
+	 * The type of the rewards, from RawFileRewardsType.
+	 */
+	uint32_t rewardsType;
+
+	/**
+	 * The index of the initial state.
+	 */
+	uint32_t initialState;
+
+	/**
+	 * The horizon; 0 means infinite.
+	 */
+	uint32_t horizon;
+
+	/**
+	 * Unused; zero.
+	 */
+	uint32_t reserved;
+
+	/**
+	 * The discount factor.
+	 */
+	double discountFactor;
+
+	/**
+	 * The number of blocks in the table which follows the header.
+	 */
+	uint64_t numBlocks;
+};
+
+/**
+ * An entry in the table of blocks of a binary model file, describing one array of floats.
+ */
+struct RawFileBinaryBlock {
+	/**
+	 * The type of the block, from RawFileBinaryBlockType.
+	 */
+	uint32_t type;
+
+	/**
+	 * The encoding of the block, from RawFileBinaryEncoding.
+	 */
+	uint32_t encoding;
+
+	/**
+	 * The offset of the block from the start of the file, a multiple of RAW_FILE_BINARY_ALIGNMENT.
+	 */
+	uint64_t offset;
+
+	/**
+	 * The number of floats in the block.
+	 */
+	uint64_t count;
+
+	/**
+	 * The minimal value in the block.
+	 */
+	double min;
+
+	/**
+	 * The maximal value in the block.
+	 */
+	double max;
+};
+
+/**
+ * The header of one block of a streamed MDP file, which holds the non-zero state transitions of
+ * consecutive states. It is followed by the row offsets, (numStates * numActions + 1) uint64_t's where
+ * the entries of state (firstState + i) and action a are from rows[i * numActions + a] up to (but
+ * excluding) rows[i * numActions + a + 1], and then by the entries themselves.
+ */
+struct RawFileStreamBlock {
+	/**
+	 * The index of the first state in the block.
+	 */
+	uint32_t firstState;
+
+	/**
+	 * The number of states in the block.
+	 */
+	uint32_t numStates;
+
+	/**
+	 * The number of entries in the block.
+	 */
+	uint64_t numEntries;
+
+	/**
+	 * The size of the block in bytes, including this header and the padding after the entries, which
+	 * is a multiple of RAW_FILE_BINARY_ALIGNMENT.
+	 */
+	uint64_t size;
+
+	/**
+	 * Unused; zero.
+	 */
+	uint64_t reserved;
+};
+
+/**
+ * A non-zero state transition in a block of a streamed MDP file (12 bytes).
+ */
+struct RawFileStreamEntry {
+	/**
+	 * The index of the successor state.
+	 */
+	uint32_t state;
+
+	/**
+	 * The probability of the state transition.
+	 */
+	float probability;
+
+	/**
+	 * The reward for the state transition.
+	 */
+	float reward;
+};
+
 /**
  * A class which provides functionality load a raw Markovian file into a array-based Markovian object,
  * as well as save *any* Markovian object as a the appropriate raw Markovian file.
@@ -60,7 +271,9 @@ public:
 	virtual ~RawFile();
 
 	/**
-	 * A method which simply loads a raw MDP file into an array-based MDP object.
+	 * A method which simply loads a raw MDP file into an array-based MDP object. If the first line of
+	 * the file is "sparse", then it is a sparse raw MDP file (see save_sparse_raw_mdp), which is streamed
+	 * into a StateTransitionsSparseArray instead, without ever creating a dense array.
 	 * @param	filename		The name of the input file.
 	 * @throw	CoreException	An error arose trying to save the MDP object. This is
 	 * 							either due to an error within the file, or the file itself
@@ -78,46 +291,209 @@ public:
 	void save_raw_mdp(MDP *mdp, std::string filename);
 
 	/**
-	 * A method which simply loads a raw MDP file into an array-based MDP object.
+	 * A method which saves *any* MDP object as a sparse raw MDP file. After the line "sparse" and the usual
+	 * header, there is a line with the number of nonzero state transitions, followed by one "s a s' p" line
+	 * for each. SA rewards are stored as dense blocks, as usual. SAS rewards are stored like the state
+	 * transitions, as a count followed by "s a s' r" lines, but only for the nonzero state transitions.
+	 * States and actions are written in order of their indexes if they are indexed, and in the order of
+	 * iteration otherwise. The time and size are proportional to the number of nonzero state transitions.
+	 * @param	mdp				The MDP object to save.
+	 * @param	filename		The name of the output file.
+	 * @throw	CoreException	An error arose trying to save the MDP object. This could be
+	 * 							an invalid mdp was provided, or the filename was invalid.
+	 */
+	void save_sparse_raw_mdp(MDP *mdp, std::string filename);
+
+	/**
+	 * A method which loads a binary MDP file into an array-based MDP object without copying or parsing
+	 * it: the file is memory-mapped (copy-on-write), and the state transitions and rewards arrays point
+	 * directly into the mapping, which is released once they are destroyed. Pages are read lazily and
+	 * shared by every process which loads the same file.
 	 * @param	filename		The name of the input file.
-	 * @throw	CoreException	An error arose trying to save the POMDP object. This is
+	 * @throw	CoreException	An error arose trying to load the MDP object. This is either due to an
+	 * 							invalid header, block table, or version, or the file itself was not able
+	 * 							to be mapped.
+	 */
+	MDP *load_binary_mdp(std::string filename);
+
+	/**
+	 * A method which saves *any* MDP object as a binary MDP file, with dense blocks. States and actions are
+	 * written in order of their indexes if they are indexed, and in the order of iteration otherwise.
+	 * @param	mdp				The MDP object to save.
+	 * @param	filename		The name of the output file.
+	 * @throw	CoreException	An error arose trying to save the MDP object. This could be
+	 * 							an invalid mdp was provided, or the filename was invalid.
+	 */
+	void save_binary_mdp(MDP *mdp, std::string filename);
+
+	/**
+	 * A method which saves *any* MDP object with SAS rewards as a streamed MDP file, which is solved
+	 * out-of-core by MDPValueIteration::solve_out_of_core. After the header (with a model type of
+	 * RawFileBinaryStreamedMDP and no table of blocks), the file is a sequence of blocks, each aligned
+	 * and described by a RawFileStreamBlock, which together hold the non-zero state transitions of every
+	 * state in order, with the SAS reward of each. States and actions are in the order of
+	 * order_policy_states and order_policy_actions. Only one block is held in memory at a time, so the
+	 * time is proportional to the number of non-zero state transitions.
+	 * @param	mdp				The MDP object to save.
+	 * @param	filename		The name of the output file.
+	 * @throw	CoreException	An error arose trying to save the MDP object. This could be
+	 * 							an invalid mdp was provided, or the filename was invalid.
+	 */
+	void save_streamed_mdp(MDP *mdp, std::string filename);
+
+	/**
+	 * A method which loads a raw POMDP file into an array-based POMDP object. The header is
+	 * "n m z k r s0 h g", i.e., the MDP header with the number of observations following the number of
+	 * actions. The state transitions are as in a raw MDP file, followed by the observation transitions: for
+	 * each action, one row for each next state over the observations. Finally, for each reward factor, SA
+	 * and SAS rewards are as in a raw MDP file, and SASO rewards have one row for each state, action, and
+	 * next state, over the observations.
+	 * @param	filename		The name of the input file.
+	 * @throw	CoreException	An error arose trying to load the POMDP object. This is
 	 * 							either due to an error within the file, or the file itself
 	 * 							was not able to be loaded.
-	 * ToDo: Implement loading raw pomdp files.
 	 */
-//	POMDP *load_raw_pomdp(std::string filename);
+	POMDP *load_raw_pomdp(std::string filename);
 
 	/**
-	 * A method which simply saves *any* POMDP object as a raw POMDP file.
+	 * A method which saves *any* POMDP object as a raw POMDP file. States, actions, and observations are
+	 * written in order of their indexes if they are indexed, and in the order of iteration otherwise.
 	 * @param	pomdp			The POMDP object to save.
 	 * @param	filename		The name of the output file.
 	 * @throw	CoreException	An error arose trying to save the POMDP object. This could
-	 * 							be an invalid mdp was provided, or the filename was invalid.
-	 * ToDo: Implement saving raw pomdp files.
+	 * 							be an invalid pomdp was provided, or the filename was invalid.
 	 */
-//	void save_raw_pomdp(POMDP *pomdp, std::string filename);
+	void save_raw_pomdp(POMDP *pomdp, std::string filename);
 
 	/**
-	 * A method which simply loads a raw MDP file into an array-based MDP object.
+	 * A method which loads a raw Dec-POMDP file into a Dec-POMDP object. The header is "N n k r s0 h g",
+	 * with the number of agents (N) in place of the numbers of actions and observations, which follow on two
+	 * lines with one number for each agent. The rest is exactly a raw POMDP file over the joint actions and
+	 * joint observations, whose indexes are mixed-radix, with the first agent's the most significant. Agents,
+	 * and their actions and observations, are named by their indexes. Joint actions and observations are not
+	 * indexed, so the state transitions, observation transitions, and rewards are stored in maps.
 	 * @param	filename		The name of the input file.
-	 * @throw	CoreException	An error arose trying to save the Dec-POMDP object. This is
+	 * @throw	CoreException	An error arose trying to load the Dec-POMDP object. This is
 	 * 							either due to an error within the file, or the file itself
 	 * 							was not able to be loaded.
-	 * ToDo: Implement loading raw dec-pomdp files.
 	 */
-//	DecPOMDP *load_raw_decpomdp(std::string filename);
+	DecPOMDP *load_raw_decpomdp(std::string filename);
 
 	/**
-	 * A method which simply saves *any* Dec-POMDP object as a raw Dec-POMDP file.
+	 * A method which saves *any* Dec-POMDP object, with joint actions and joint observations, as a raw
+	 * Dec-POMDP file. States are written in order of their indexes if they are indexed, and in the order
+	 * of iteration otherwise; each agent's actions and observations are in the order of their factor.
 	 * @param	decpomdp		The Dec-POMDP object to save.
 	 * @param	filename		The name of the output file.
 	 * @throw	CoreException	An error arose trying to save the Dec-POMDP object. This could
-	 * 							be an invalid mdp was provided, or the filename was invalid.
-	 * ToDo: Implement saving raw dec-pomdp files.
+	 * 							be an invalid decpomdp was provided, or the filename was invalid.
 	 */
-//	void save_raw_decpomdp(DecPOMDP *decpomdp, std::string filename);
+	void save_raw_decpomdp(DecPOMDP *decpomdp, std::string filename);
 
 private:
+	/**
+	 * Load a sparse raw MDP file, streaming the nonzero state transitions directly into a
+	 * StateTransitionsSparseArray, and the SAS rewards into an SASRewardsMap.
+	 * @param	filename		The name of the input file.
+	 * @throw	CoreException	Either an error within the file, or the file was not able to be loaded.
+	 * @return	The MDP object.
+	 */
+	MDP *load_sparse_raw_mdp(std::string filename);
+
+	/**
+	 * Read the next non-empty line of a file and split it into exactly the number of items requested.
+	 * @param	tokenizer		The tokenizer over the file.
+	 * @param	row				The current row of the file, which is incremented for each line read.
+	 * @param	items			The resulting items.
+	 * @param	numItems		The number of items requested.
+	 * @return	Returns @code{true} if there were no more lines, or the number of items differed;
+	 * 			@code{false} otherwise.
+	 */
+	bool next_items(Tokenizer &tokenizer, unsigned int &row, Token *items, unsigned int numItems);
+
+	/**
+	 * Read the next non-empty line of a file, which must contain exactly the number of non-negative integers
+	 * requested, optionally followed by a discount factor.
+	 * @param	tokenizer		The tokenizer over the file.
+	 * @param	row				The current row of the file, which is incremented for each line read.
+	 * @param	values			The resulting integers.
+	 * @param	numValues		The number of integers requested.
+	 * @param	g				The resulting discount factor, or null if the line does not have one.
+	 * @return	Returns @code{true} if an error occurred, @code{false} otherwise.
+	 */
+	bool next_values(Tokenizer &tokenizer, unsigned int &row, unsigned int *values, unsigned int numValues,
+			double *g);
+
+	/**
+	 * Load a matrix of data from the next non-empty lines of a file, into the 1-d array provided.
+	 * @param	tokenizer		The tokenizer over the file.
+	 * @param	row				The current row of the file, which is incremented for each line read.
+	 * @param	rows			The number of rows to read.
+	 * @param	cols			The number of columns to read for each row.
+	 * @param	array			The array to modify, of size rows x cols.
+	 * @return	Returns @code{true} if an error occurred, @code{false} otherwise.
+	 */
+	bool load_block(Tokenizer &tokenizer, unsigned int &row, unsigned int rows, unsigned int cols, float *array);
+
+	/**
+	 * Collect the factors of some rewards, and determine the most compact type of raw rewards shared by them.
+	 * @param	R				The rewards, which may be factored.
+	 * @param	factors			The resulting reward factors.
+	 * @throw	CoreException	A factor was not SASO rewards.
+	 * @return	The type of the rewards, from RawFileRewardsType.
+	 */
+	unsigned int find_rewards_type(Rewards *R, std::vector<Rewards *> &factors);
+
+	/**
+	 * Write the observation transitions and the rewards of a POMDP-like object as dense blocks.
+	 * @param	file			The file stream.
+	 * @param	O				The observation transitions.
+	 * @param	factors			The reward factors.
+	 * @param	r				The type of the rewards, from RawFileRewardsType.
+	 * @param	states			The states, in order.
+	 * @param	actions			The actions, in order.
+	 * @param	observations	The observations, in order.
+	 */
+	void save_pomdp_blocks(std::ofstream &file, ObservationTransitions *O, const std::vector<Rewards *> &factors,
+			unsigned int r, const std::vector<State *> &states, const std::vector<Action *> &actions,
+			const std::vector<Observation *> &observations);
+
+	/**
+	 * Check that the header variables of a raw file are valid. Note that SASO rewards are valid here,
+	 * but not for MDPs.
+	 * @param	filename		The name of the file, for logging.
+	 * @param	n				The number of states.
+	 * @param	m				The number of actions.
+	 * @param	k				The number of reward factors.
+	 * @param	r				The type of the rewards.
+	 * @param	s0				The initial state.
+	 * @param	g				The discount factor.
+	 * @throw	CoreException	One of the header variables was invalid.
+	 */
+	void check_header(std::string filename, unsigned int n, unsigned int m, unsigned int k, unsigned int r,
+			unsigned int s0, double g);
+
+	/**
+	 * Create the indexed states of a raw MDP file.
+	 * @param	n	The number of states.
+	 * @return	The states, with indexes 0 to n - 1.
+	 */
+	StatesMap *create_states(unsigned int n);
+
+	/**
+	 * Create the indexed actions of a raw MDP file.
+	 * @param	m	The number of actions.
+	 * @return	The actions, with indexes 0 to m - 1.
+	 */
+	ActionsMap *create_actions(unsigned int m);
+
+	/**
+	 * Create the indexed observations of a raw POMDP file.
+	 * @param	z	The number of observations.
+	 * @return	The observations, with indexes 0 to z - 1.
+	 */
+	ObservationsMap *create_observations(unsigned int z);
+
 	/**
 	 * Load a matrix of data to into the 1-d array provided, given the offset provided.
 	 * @param	file			The file stream.
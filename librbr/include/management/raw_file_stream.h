@@ -0,0 +1,168 @@
+/**
+ *  The MIT License (MIT)
+ *
+ *  Copyright (c) 2014 Kyle Hollins Wray, University of Massachusetts
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy of
+ *  this software and associated documentation files (the "Software"), to deal in
+ *  the Software without restriction, including without limitation the rights to
+ *  use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ *  the Software, and to permit persons to whom the Software is furnished to do so,
+ *  subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included in all
+ *  copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ *  FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ *  COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ *  IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ *  CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+
+#ifndef RAW_FILE_STREAM_H
+#define RAW_FILE_STREAM_H
+
+
+#include "raw_file.h"
+
+#include <fstream>
+#include <string>
+#include <thread>
+#include <vector>
+#include <cstdint>
+
+/**
+ * A reader of the blocks of a streamed MDP file (see RawFile::save_streamed_mdp), in order, which
+ * holds at most two blocks in memory. The blocks are double buffered: while the caller processes one
+ * block, the next is read by another thread, so reading the file overlaps the computation.
+ */
+class RawFileStream {
+public:
+	/**
+	 * The constructor for the RawFileStream class, which opens the file, checks its header, and
+	 * starts reading the first block.
+	 * @param	filename		The name of the streamed MDP file.
+	 * @throw	CoreException	The file could not be opened, or it was not a streamed MDP file.
+	 */
+	RawFileStream(std::string filename);
+
+	/**
+	 * The deconstructor for the RawFileStream class, which waits for any block being read.
+	 */
+	virtual ~RawFileStream();
+
+	/**
+	 * Get the header of the file.
+	 * @return	The header of the file.
+	 */
+	const RawFileBinaryHeader &get_header() const;
+
+	/**
+	 * Start again from the first block, e.g., for another sweep over the states.
+	 * @throw	CoreException	The file could not be read.
+	 */
+	void rewind();
+
+	/**
+	 * Get the next block, waiting until it has been read. The block remains valid until the
+	 * following call to next or rewind.
+	 * @throw	CoreException	The block could not be read, or it was invalid.
+	 * @return	The next block, or nullptr after the last block.
+	 */
+	const RawFileStreamBlock *next();
+
+	/**
+	 * Get the row offsets of a block.
+	 * @param	block	The block.
+	 * @return	The (numStates * numActions + 1) row offsets of the block.
+	 */
+	const uint64_t *get_rows(const RawFileStreamBlock *block) const;
+
+	/**
+	 * Get the entries of a block.
+	 * @param	block	The block.
+	 * @return	The numEntries entries of the block.
+	 */
+	const RawFileStreamEntry *get_entries(const RawFileStreamBlock *block) const;
+
+private:
+	/**
+	 * The copy constructor for the RawFileStream class, which is not allowed.
+	 * @param	other	The stream to copy.
+	 */
+	RawFileStream(const RawFileStream &other);
+
+	/**
+	 * Start reading the next block into the buffer which is not in use, on another thread.
+	 */
+	void start();
+
+	/**
+	 * Wait for the block being read, if any.
+	 */
+	void wait();
+
+	/**
+	 * Read the block at the current offset into a buffer, and check it. This runs on the reading
+	 * thread, and it records whether it succeeded.
+	 * @param	buffer	The index of the buffer.
+	 */
+	void read(unsigned int buffer);
+
+	/**
+	 * The name of the file.
+	 */
+	std::string filename;
+
+	/**
+	 * The file, which only the reading thread uses while it runs.
+	 */
+	std::ifstream file;
+
+	/**
+	 * The header of the file.
+	 */
+	RawFileBinaryHeader header;
+
+	/**
+	 * The two buffers, one with the block returned by next and one with the block being read.
+	 */
+	std::vector<uint64_t> buffers[2];
+
+	/**
+	 * The index of the buffer into which the next block is read.
+	 */
+	unsigned int reading;
+
+	/**
+	 * The thread reading the next block, if any.
+	 */
+	std::thread reader;
+
+	/**
+	 * The offset of the next block to read.
+	 */
+	uint64_t offset;
+
+	/**
+	 * The number of blocks which have been read, or are being read, since the last rewind.
+	 */
+	uint64_t numStarted;
+
+	/**
+	 * The index of the next state expected, to check that the blocks cover the states in order.
+	 */
+	uint64_t nextState;
+
+	/**
+	 * If the last block read was valid.
+	 */
+	bool valid;
+
+};
+
+
+#endif // RAW_FILE_STREAM_H
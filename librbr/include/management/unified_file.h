@@ -28,6 +28,9 @@
 
 #include <string>
 #include <vector>
+#include <unordered_map>
+#include <cstddef>
+#include <mutex>
 
 #include "../core/agents/agents.h"
 #include "../core/states/states_map.h"
@@ -37,6 +40,7 @@
 #include "../core/observations/observations_map.h"
 #include "../core/observations/joint_observations_map.h"
 #include "../core/state_transitions/state_transitions_map.h"
+#include "../core/state_transitions/factored_state_transitions.h"
 #include "../core/observation_transitions/observation_transitions_map.h"
 #include "../core/rewards/sas_rewards_map.h"
 #include "../core/initial.h"
@@ -47,6 +51,149 @@
 #include "../dec_pomdp/dec_pomdp.h"
 
 #include "../utilities/string_manipulation.h"
+#include "../utilities/tokenizer.h"
+
+/**
+ * A state transition probability or a reward from a T or R statement, which has been parsed but
+ * not yet set in the model. Any of the pointers may be @code{nullptr} for a wildcard.
+ */
+struct UnifiedFileTransition {
+	/**
+	 * The current state.
+	 */
+	State *state;
+
+	/**
+	 * The action taken.
+	 */
+	Action *action;
+
+	/**
+	 * The next state.
+	 */
+	State *nextState;
+
+	/**
+	 * The probability or reward.
+	 */
+	double value;
+};
+
+/**
+ * An observation probability from an O statement, which has been parsed but not yet set in the
+ * model. Any of the pointers may be @code{nullptr} for a wildcard.
+ */
+struct UnifiedFileObservation {
+	/**
+	 * The action taken.
+	 */
+	Action *action;
+
+	/**
+	 * The next state.
+	 */
+	State *nextState;
+
+	/**
+	 * The observation made.
+	 */
+	Observation *observation;
+
+	/**
+	 * The probability.
+	 */
+	double value;
+};
+
+/**
+ * A line-aligned chunk of the T, O, and R statements of a file, which one thread parses into
+ * lists of entries (in the order they appear) without touching the model.
+ */
+struct UnifiedFileChunk {
+	/**
+	 * The offset of the first line of the chunk in the file. This is always a statement.
+	 */
+	std::size_t start;
+
+	/**
+	 * The offset of the end of the chunk in the file.
+	 */
+	std::size_t end;
+
+	/**
+	 * The offset in the file of a statement other than T, O, or R, at which parsing stopped,
+	 * or the end of the chunk if there was none.
+	 */
+	std::size_t stop;
+
+	/**
+	 * The current line number (primarily for error output purposes). Only the first chunk knows
+	 * its first line number while it is parsed; the others count from zero.
+	 */
+	unsigned int rows;
+
+	/**
+	 * Which vector or matrix the following lines are for: 0 = null, 4 = T vector,
+	 * 5 = T matrix, 6 = O vector, 7 = O matrix, 8 = R vector, 9 = R matrix.
+	 */
+	unsigned int loading;
+
+	/**
+	 * The number of lines of the current vector or matrix which have been loaded.
+	 */
+	unsigned int loadingCounter;
+
+	/**
+	 * A helper state variable for loading vectors or matrices.
+	 */
+	State *loadingState;
+
+	/**
+	 * A helper action variable for loading vectors or matrices.
+	 */
+	Action *loadingAction;
+
+	/**
+	 * A reused buffer for the key of a name lookup, which avoids an allocation for each name.
+	 */
+	std::string lookupKey;
+
+	/**
+	 * If the values are set in the model in batches as they are parsed, which only the first chunk
+	 * may do, since every value before it has already been set.
+	 */
+	bool flush;
+
+	/**
+	 * If a T, O, or R statement was found, even one with no values.
+	 */
+	bool hasStateTransitions, hasObservationTransitions, hasRewards;
+
+	/**
+	 * The state transitions, in the order they appear.
+	 */
+	std::vector<UnifiedFileTransition> stateTransitions;
+
+	/**
+	 * The observation transitions, in the order they appear.
+	 */
+	std::vector<UnifiedFileObservation> observationTransitions;
+
+	/**
+	 * The rewards, in the order they appear, already negated if they are costs.
+	 */
+	std::vector<UnifiedFileTransition> rewards;
+
+	/**
+	 * The class and function which raised an error, or @code{nullptr} if there was none.
+	 */
+	const char *errorSource;
+
+	/**
+	 * A variable which holds the error message.
+	 */
+	char error[1024];
+};
 
 /**
  * A file loading and saving class called UnifiedFile which acts as an intermediate
@@ -73,6 +220,19 @@ public:
 	 */
 	~UnifiedFile();
 
+	/**
+	 * Set the number of threads which parse the T, O, and R statements of large files.
+	 * @param	numThreads		The number of threads.
+	 * @throw	CoreException	The number of threads was zero.
+	 */
+	void set_num_threads(unsigned int numThreads);
+
+	/**
+	 * Get the number of threads which parse the T, O, and R statements of large files.
+	 * @return	The number of threads.
+	 */
+	unsigned int get_num_threads() const;
+
 	/**
 	 * A function which loads any MDP-like file.
 	 * @param	path	The filename and relative path of the MDP-like file to load.
@@ -117,6 +277,62 @@ public:
 	DecPOMDP *get_dec_pomdp();
 
 private:
+	/**
+	 * Load the lines of a file, which must already be reset, alternating between the header
+	 * statements and the (much larger) T, O, and R statements which follow them.
+	 * @param	data	The file's data.
+	 * @param	size	The number of characters in the file.
+	 * @return	Return @code{true} if an error occurred, and @code{false} otherwise.
+	 */
+	bool load_lines(const char *data, std::size_t size);
+
+	/**
+	 * Load the statements other than T, O, and R, e.g., the states and actions, in order.
+	 * @param	data		The file's data.
+	 * @param	size		The number of characters in the file.
+	 * @param	position	The offset of the first line to load. This is advanced to the first
+	 * 						T, O, or R statement, or the end of the file.
+	 * @return	Return @code{true} if an error occurred, and @code{false} otherwise.
+	 */
+	bool load_header(const char *data, std::size_t size, std::size_t &position);
+
+	/**
+	 * Load a run of T, O, and R statements, splitting it into line-aligned chunks which are
+	 * parsed in parallel and then set in the model in order.
+	 * @param	data		The file's data.
+	 * @param	size		The number of characters in the file.
+	 * @param	position	The offset of the first statement to load. This is advanced to the next
+	 * 						statement other than T, O, or R, or the end of the file.
+	 * @return	Return @code{true} if an error occurred, and @code{false} otherwise.
+	 */
+	bool load_body(const char *data, std::size_t size, std::size_t &position);
+
+	/**
+	 * Parse the T, O, and R statements of a chunk. This only reads the shared variables, so many
+	 * chunks may be parsed at once.
+	 * @param	data	The file's data.
+	 * @param	chunk	The chunk to parse.
+	 */
+	void parse_chunk(const char *data, UnifiedFileChunk *chunk);
+
+	/**
+	 * Set the parsed state transitions of a chunk in the model, in order, and remove them from the chunk.
+	 * @param	chunk	The chunk.
+	 */
+	void merge_state_transitions(UnifiedFileChunk *chunk);
+
+	/**
+	 * Set the parsed observation transitions of a chunk in the model, in order, and remove them from the chunk.
+	 * @param	chunk	The chunk.
+	 */
+	void merge_observation_transitions(UnifiedFileChunk *chunk);
+
+	/**
+	 * Set the parsed rewards of a chunk in the model, in order, and remove them from the chunk.
+	 * @param	chunk	The chunk.
+	 */
+	void merge_rewards(UnifiedFileChunk *chunk);
+
 	/**
 	 * Load the horizon from the file's data.
 	 * @param	items		The list of items on the same line.
@@ -145,6 +361,14 @@ private:
 	 */
 	bool load_initial_state_inclusive(std::vector<std::string> items);
 
+	/**
+	 * Load the actions available in a state, from a statement "available: <state> : <action> <action> ...".
+	 * Every action is available in any state without such a statement.
+	 * @param	items		The list of items on the same line.
+	 * @return	Return @code{true} if an error occurred, and @code{false} otherwise.
+	 */
+	bool load_available(std::vector<std::string> items);
+
 	/**
 	 * Load the initial state from the file's data, following the special exclusive structure.
 	 * @param	items		The list of items on the same line.
@@ -218,73 +442,163 @@ private:
 
 	/**
 	 * Load the state transitions from the file's data.
+	 * @param	chunk		The chunk being parsed.
 	 * @param	items		The list of items on the same line.
+	 * @param	numItems	The number of items on the same line.
 	 * @return	Return -1 if an error occurred, 0 if successful, 1 if this begins
 	 * 			loading a vector of state transitions, 2 if this begins loading a
 	 * 			matrix of state transitions.
 	 */
-	int load_state_transition(std::vector<std::string> items);
+	int load_state_transition(UnifiedFileChunk *chunk, const Token *items, unsigned int numItems);
 
 	/**
 	 * Load a state transition vector from the file's data.
+	 * @param	chunk		The chunk being parsed.
 	 * @param	line		The line to parse containing a vector of probabilities.
 	 * @return	Return @code{true} if an error occurred, @code{false} otherwise.
 	 */
-	bool load_state_transition_vector(std::string line);
+	bool load_state_transition_vector(UnifiedFileChunk *chunk, const Token &line);
 
 	/**
 	 * Load a state transition matrix from the file's data.
+	 * @param	chunk			The chunk being parsed.
 	 * @param	stateIndex		The current state index for the start state.
 	 * @param	line			The line to parse containing a vector of probabilities.
 	 * @return	Return @code{true} if an error occurred, @code{false} otherwise.
 	 */
-	bool load_state_transition_matrix(unsigned int stateIndex, std::string line);
+	bool load_state_transition_matrix(UnifiedFileChunk *chunk, unsigned int stateIndex, const Token &line);
+
+	/**
+	 * Load the parents of a factor of the factored state transitions from the file's data, i.e.,
+	 * "T parents: factor : parent factors".
+	 * @param	items		The list of items on the same line.
+	 * @return	Return @code{true} if an error occurred, @code{false} otherwise.
+	 */
+	bool load_factored_state_transition_parents(std::vector<std::string> items);
+
+	/**
+	 * Load a conditional probability of a factor of the factored state transitions from the file's data,
+	 * i.e., "T factor: factor : action : parent states : next state : probability", where the parent
+	 * states are omitted if the factor has no parents.
+	 * @param	items		The list of items on the same line.
+	 * @return	Return -1 if an error occurred, 0 if successful, and 1 if this begins
+	 * 			loading a vector of probabilities for each state of the factor.
+	 */
+	int load_factored_state_transition(std::vector<std::string> items);
+
+	/**
+	 * Load a vector of conditional probabilities of a factor of the factored state transitions.
+	 * @param	line		The line string from the file.
+	 * @return	Return @code{true} if an error occurred, @code{false} otherwise.
+	 */
+	bool load_factored_state_transition_vector(std::string line);
+
+	/**
+	 * Get the factored state transitions, creating them if they have not been made yet.
+	 * @param	source		The name of the function loading them, for error output.
+	 * @return	The factored state transitions, or @code{nullptr} if an error occurred.
+	 */
+	FactoredStateTransitions *get_factored_state_transitions(const char *source);
+
+	/**
+	 * Find a state by name within one factor of the factored states.
+	 * @param	factorIndex		The index of the factor.
+	 * @param	name			The name of the state.
+	 * @return	The state, or @code{nullptr} if the factor has no state with this name.
+	 */
+	State *find_factor_state(unsigned int factorIndex, const std::string &name);
+
+	/**
+	 * Create the ordered list of states, unless it has already been made. The factored states are only
+	 * listed when a vector or matrix requires it. This is safe to call from the chunk threads.
+	 */
+	void order_states();
 
 	/**
 	 * Load the observation transitions from the file's data.
+	 * @param	chunk		The chunk being parsed.
 	 * @param	items		The list of items on the same line.
+	 * @param	numItems	The number of items on the same line.
 	 * @return	Return -1 if an error occurred, 0 if successful, and 1 if this begins
 	 * 			loading a matrix of observation transitions.
 	 */
-	int load_observation_transition(std::vector<std::string> items);
+	int load_observation_transition(UnifiedFileChunk *chunk, const Token *items, unsigned int numItems);
 
 	/**
 	 * Load a observation transition vector from the file's data.
+	 * @param	chunk		The chunk being parsed.
 	 * @param	line		The line to parse containing a vector of probabilities.
 	 * @return	Return @code{true} if an error occurred, @code{false} otherwise.
 	 */
-	bool load_observation_transition_vector(std::string line);
+	bool load_observation_transition_vector(UnifiedFileChunk *chunk, const Token &line);
 
 	/**
 	 * Load a state transition matrix from the file's data.
+	 * @param	chunk			The chunk being parsed.
 	 * @param	stateIndex		The current state index for the end state.
 	 * @param	line			The line to parse containing a vector of probabilities.
 	 * @return	Return @code{true} if an error occurred, @code{false} otherwise.
 	 */
-	bool load_observation_transition_matrix(unsigned int stateIndex, std::string line);
+	bool load_observation_transition_matrix(UnifiedFileChunk *chunk, unsigned int stateIndex, const Token &line);
 
 	/**
 	 * Load the rewards from the file's data.
+	 * @param	chunk		The chunk being parsed.
 	 * @param	items		The list of items on the same line.
+	 * @param	numItems	The number of items on the same line.
 	 * @return	Return -1 if an error occurred, 0 if successful, and 1 if this begins
 	 * 			loading a matrix of rewards.
 	 */
-	int load_reward(std::vector<std::string> items);
+	int load_reward(UnifiedFileChunk *chunk, const Token *items, unsigned int numItems);
 
 	/**
 	 * Load a reward vector from the file's data.
+	 * @param	chunk		The chunk being parsed.
 	 * @param	line		The line to parse containing a vector of rewards or costs.
 	 * @return	Return @code{true} if an error occurred, @code{false} otherwise.
 	 */
-	bool load_reward_vector(std::string line);
+	bool load_reward_vector(UnifiedFileChunk *chunk, const Token &line);
 
 	/**
 	 * Load a reward matrix from the file's data.
+	 * @param	chunk			The chunk being parsed.
 	 * @param	stateIndex		The current state index for the end state.
 	 * @param	line			The line to parse containing a vector of rewards or costs.
 	 * @return	Return @code{true} if an error occurred, @code{false} otherwise.
 	 */
-	bool load_reward_matrix(unsigned int stateIndex, std::string line);
+	bool load_reward_matrix(UnifiedFileChunk *chunk, unsigned int stateIndex, const Token &line);
+
+	/**
+	 * Find a state by name, using the states' own index of names.
+	 * @param	name	The name of the state; for factored states, the names of its factors separated by spaces.
+	 * @param	key		A buffer for the lookup key.
+	 * @return	The state, or @code{nullptr} if no state has this name.
+	 */
+	State *lookup_state(const Token &name, std::string &key) const;
+
+	/**
+	 * Find an action by name, using the actions' own index of names.
+	 * @param	name	The name of the action; for joint actions, the names of its actions separated by spaces.
+	 * @param	key		A buffer for the lookup key.
+	 * @return	The action, or @code{nullptr} if no action has this name.
+	 */
+	Action *lookup_action(const Token &name, std::string &key) const;
+
+	/**
+	 * Find an observation by name, using the observations' own index of names.
+	 * @param	name	The name of the observation; for joint observations, the names of its observations
+	 * 					separated by spaces.
+	 * @param	key		A buffer for the lookup key.
+	 * @return	The observation, or @code{nullptr} if no observation has this name.
+	 */
+	Observation *lookup_observation(const Token &name, std::string &key) const;
+
+	/**
+	 * Set a lookup key to a name, with each run of spaces replaced by a single space.
+	 * @param	name	The name.
+	 * @param	key		The lookup key, whose memory is reused.
+	 */
+	static void set_lookup_key(const Token &name, std::string &key);
 
 	/**
 	 * Release control over the memory of the variables.
@@ -312,9 +626,10 @@ private:
 	ObservationsMap *observations;
 
 	/**
-	 * The state transition function in the MDP-like object; e.g., a three-dimensional array mapping to a double.
+	 * The state transition function in the MDP-like object; e.g., a three-dimensional array mapping to a double,
+	 * or a factored state transitions object over factored states.
 	 */
-	StateTransitionsMap *stateTransitions;
+	StateTransitions *stateTransitions;
 
 	/**
 	 * The observation transition function in the MDP-like object; e.g., a three-dimensional array mapping to a double.
@@ -371,16 +686,36 @@ private:
 	 */
 	Observation *loadingObservation;
 
+	/**
+	 * A helper factor index for loading vectors of factored state transitions.
+	 */
+	unsigned int loadingFactor;
+
+	/**
+	 * A helper list of the states of a factor's parents for loading vectors of factored state transitions.
+	 */
+	std::vector<State *> loadingParents;
+
 	/**
 	 * An ordered list of states for use in loading vectors or matrices.
 	 */
 	std::vector<State *> orderedStates;
 
+	/**
+	 * Guards the creation of the ordered list of states, since chunks are parsed in parallel.
+	 */
+	std::mutex orderedStatesMutex;
+
 	/**
 	 * An ordered list of observations for use in loading vectors or matrices.
 	 */
 	std::vector<Observation *> orderedObservations;
 
+	/**
+	 * The number of threads which parse the T, O, and R statements of large files.
+	 */
+	unsigned int numThreads;
+
 };
 
 
@@ -88,6 +88,20 @@ public:
 	 */
 	Horizon *get_horizon();
 
+	/**
+	 * Freeze the MDP so that it is read-only. All lazily computed data (e.g., the successors of each
+	 * state-action pair) is computed now, in parallel, so that one MDP may be shared by many solver and
+	 * query threads at once without copies or locks. Resetting the state transitions unfreezes them.
+	 * @throw	StateTransitionException	The state transitions could not be frozen.
+	 */
+	virtual void freeze();
+
+	/**
+	 * Check if the MDP has been frozen.
+	 * @return	Returns @code{true} if the MDP is read-only; @code{false} otherwise.
+	 */
+	virtual bool is_frozen() const;
+
 protected:
 	/**
 	 * The states in the MDP; e.g., an array of strings.
@@ -32,17 +32,23 @@
 
 #include "../core/states/states_map.h"
 #include "../core/actions/actions_map.h"
-#include "../core/state_transitions/state_transitions_map.h"
+#include "../core/state_transitions/state_transitions.h"
+#include "../core/state_transitions/state_transitions_array.h"
 #include "../core/rewards/sas_rewards.h"
+#include "../core/rewards/sas_rewards_array.h"
 #include "../core/horizon.h"
 
+#include "../management/policy_cache.h"
+
 /**
  * Solve an MDP via policy iteration (infinite horizon) with either the exact or modified
  * version. This solver has the following requirements:
  * - MDP states must be of type FiniteStates.
  * - MDP actions must be of type FiniteActions.
- * - MDP state transitions must be of type FiniteStateTransitions.
+ * - MDP state transitions must be of type StateTransitions.
  * - MDP rewards must be of type SASRewards.
+ * Models stored as StateTransitionsArray and SASRewardsArray over indexed states and actions are
+ * solved entirely by index.
  */
 class MDPPolicyIteration {
 public:
@@ -69,13 +75,27 @@ public:
 	 * @param	mdp							The Markov decision process to solve.
 	 * @throw	StateException				The MDP did not have a FiniteStates states object.
 	 * @throw	ActionException				The MDP did not have a FiniteActions actions object.
-	 * @throw	StateTransitionsException	The MDP did not have a FiniteStateTransitions state transitions object.
+	 * @throw	StateTransitionsException	The MDP did not have a StateTransitions state transitions object.
 	 * @throw	RewardException				The MDP did not have a SASRewards rewards object.
 	 * @throw	PolicyException				An error occurred computing the policy.
 	 * @return	Return the optimal policy.
 	 */
 	PolicyMap *solve(MDP *mdp);
 
+	/**
+	 * Set the policy cache which is consulted before solving, keyed by the fingerprint of the model
+	 * and k, and which receives each new policy. The solver does not take ownership of the cache.
+	 * @param	policyCache		The policy cache, or nullptr to always solve.
+	 */
+	void set_policy_cache(PolicyCache *policyCache);
+
+	/**
+	 * Get the values of the states' mapping, as of the last solve. This is empty if the last policy
+	 * came from the policy cache, since the cache only stores policies.
+	 * @return	The mapping from states to values.
+	 */
+	const std::unordered_map<State *, double> &get_V() const;
+
 private:
 	/**
 	 * Solve an infinite horizon MDP using exact policy iteration.
@@ -87,7 +107,7 @@ private:
 	 * @throw	PolicyException		An error occurred computing the policy.
 	 * @return	Return the optimal policy.
 	 */
-	PolicyMap *solve_exact(StatesMap *S, ActionsMap *A, StateTransitionsMap *T,
+	PolicyMap *solve_exact(StatesMap *S, ActionsMap *A, StateTransitions *T,
 			SASRewards *R, Horizon *h);
 
 	/**
@@ -100,15 +120,39 @@ private:
 	 * @throws	PolicyException		An error occurred computing the policy.
 	 * @return	Return the optimal policy.
 	 */
-	PolicyMap *solve_modified(StatesMap *S, ActionsMap *A, StateTransitionsMap *T,
+	PolicyMap *solve_modified(StatesMap *S, ActionsMap *A, StateTransitions *T,
 			SASRewards *R, Horizon *h);
 
+	/**
+	 * Solve an infinite horizon MDP stored as arrays using exact or modified policy iteration, entirely
+	 * by the indexes of the states and actions. The policy is evaluated and improved in the same order
+	 * as the other versions.
+	 * @param	S					The finite indexed states.
+	 * @param	A					The finite indexed actions; only those available in a state are considered.
+	 * @param	T					The state transitions array.
+	 * @param	R					The state-action-state rewards array.
+	 * @param	h					The horizon.
+	 * @return	Return the optimal policy, or nullptr if the states and actions do not index the arrays.
+	 */
+	PolicyMap *solve_array(StatesMap *S, ActionsMap *A, StateTransitionsArray *T,
+			SASRewardsArray *R, Horizon *h);
+
 	/**
 	 * The number of times to iterate in the modified version. Disable the modified version of
 	 * policy iteration by setting k = 0.
 	 */
 	unsigned int modifiedK;
 
+	/**
+	 * The policy cache consulted before solving, or nullptr if there is none.
+	 */
+	PolicyCache *cache;
+
+	/**
+	 * The value of the states under the last policy.
+	 */
+	std::unordered_map<State *, double> V;
+
 };
 
 
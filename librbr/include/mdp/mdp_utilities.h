@@ -33,7 +33,9 @@
 #include "../core/states/states_map.h"
 #include "../core/actions/actions_map.h"
 #include "../core/state_transitions/state_transitions.h"
+#include "../core/state_transitions/state_transitions_array.h"
 #include "../core/rewards/sas_rewards.h"
+#include "../core/rewards/sas_rewards_array.h"
 #include "../core/rewards/factored_rewards.h"
 #include "../core/horizon.h"
 #include "../core/policy/policy_map.h"
@@ -54,9 +56,42 @@ void bellman_update(StatesMap *S, ActionsMap *A, StateTransitions *T,
 		SASRewards *R, Horizon *h, State *s,
 		std::unordered_map<State *, double> &V, Action *&aBest);
 
+/**
+ * Compute the Bellman update/backup for a given state of an MDP stored as arrays, entirely by the
+ * indexes of the states and actions, and compute the action which achieves the highest Q(s, a).
+ * @param	T			The state transitions array.
+ * @param	R			The state-action-state rewards array.
+ * @param	gamma		The discount factor.
+ * @param	s			The index of the current state being examined, i.e., V(s).
+ * @param	available	The indexes of the actions available in the state.
+ * @param	V			The current Bellman backup, by state index. This will be updated.
+ * @param	aBest		The index of the action which produced the maximum V(s) value. This will be updated.
+ */
+void bellman_update(StateTransitionsArray *T, SASRewardsArray *R, double gamma, unsigned int s,
+		const std::vector<unsigned int> &available, std::vector<double> &V, unsigned int &aBest);
+
+/**
+ * Index the states and actions of an MDP stored as arrays, for the solvers which work entirely by
+ * the indexes of the arrays. Each state must be an IndexedState with a unique index, one for each
+ * state of the arrays, and each action an IndexedAction with a unique index within the arrays.
+ * @param	S				The finite states.
+ * @param	A				The finite actions.
+ * @param	T				The state transitions array.
+ * @param	R				The state-action-state rewards array.
+ * @param	states			The states, in the order of iteration. This will be updated.
+ * @param	stateIndexes	The index of each of the states. This will be updated.
+ * @param	actions			The action of each index, or nullptr if there is none. This will be updated.
+ * @param	available		The indexes of the actions available in each of the states, in the order
+ * 							of A->available. This will be updated.
+ * @return	Returns @code{true} if the states and actions index the arrays; @code{false} otherwise.
+ */
+bool index_mdp_arrays(StatesMap *S, ActionsMap *A, StateTransitionsArray *T, SASRewardsArray *R,
+		std::vector<State *> &states, std::vector<unsigned int> &stateIndexes, std::vector<Action *> &actions,
+		std::vector<std::vector<unsigned int> > &available);
+
 /**
  * Compute the value of states (V^\pi), following the Bellman's equation, given a policy. This assumes
- * a single reward function.
+ * a single reward function. Models stored as arrays are evaluated by index.
  * @param	S 			The finite states.
  * @param	A 			The finite actions.
  * @param	T 			The finite state transition function.
@@ -33,10 +33,15 @@
 #include "../core/states/states_map.h"
 #include "../core/actions/actions_map.h"
 #include "../core/state_transitions/state_transitions.h"
+#include "../core/state_transitions/state_transitions_array.h"
 #include "../core/rewards/sas_rewards.h"
+#include "../core/rewards/sas_rewards_array.h"
 #include "../core/horizon.h"
 
+#include "../management/policy_cache.h"
+
 #include <unordered_map>
+#include <string>
 
 /**
  * Solve an MDP via value iteration (finite or infinite horizon). This solver has the
@@ -78,7 +83,33 @@ public:
 	PolicyMap *solve(MDP *mdp);
 
 	/**
-	 * Get the values of the states' mapping.
+	 * Set the policy cache which is consulted before solving, keyed by the fingerprint of the model
+	 * and the parameters of the solver, and which receives each new policy. The solver does not
+	 * take ownership of the cache.
+	 * @param	policyCache		The policy cache, or nullptr to always solve.
+	 */
+	void set_policy_cache(PolicyCache *policyCache);
+
+	/**
+	 * Solve an MDP stored as a streamed MDP file (see RawFile::save_streamed_mdp) using value iteration,
+	 * out-of-core. Only two value vectors and the best action of each state are kept in memory; the state
+	 * transitions are streamed from the file once per iteration, with the next block read while the
+	 * current one is used. The values are updated from the previous iteration's, so this converges like
+	 * solve, though not necessarily in the same number of iterations. The horizon and discount factor are
+	 * those in the file.
+	 * @param	filename			The name of the streamed MDP file.
+	 * @param	S					The states, which must be in the order of the file when ordered by
+	 * 								order_policy_states.
+	 * @param	A					The actions, which must be in the order of the file when ordered by
+	 * 								order_policy_actions.
+	 * @throw	CoreException		The file could not be read, or it did not match the states and actions.
+	 * @return	Return the optimal policy.
+	 */
+	PolicyMap *solve_out_of_core(std::string filename, StatesMap *S, ActionsMap *A);
+
+	/**
+	 * Get the values of the states' mapping. This is empty if the last policy came from the policy
+	 * cache, since the cache only stores policies.
 	 * @return	The mapping from states to values.
 	 */
 	const std::unordered_map<State *, double> &get_V() const;
@@ -110,6 +141,20 @@ private:
 	PolicyMap *solve_infinite_horizon(StatesMap *S, ActionsMap *A, StateTransitions *T,
 			SASRewards *R, Horizon *h);
 
+	/**
+	 * Solve a finite or infinite horizon MDP stored as arrays using value iteration, entirely by the
+	 * indexes of the states and actions. The states and actions are swept in the same order as the
+	 * other versions, so the policy and values are the same.
+	 * @param	S					The finite indexed states.
+	 * @param	A					The finite indexed actions; only those available in a state are considered.
+	 * @param	T					The state transitions array.
+	 * @param	R					The state-action-state rewards array.
+	 * @param	h					The horizon.
+	 * @return	Return the optimal policy, or nullptr if the states and actions do not index the arrays.
+	 */
+	PolicyMap *solve_array(StatesMap *S, ActionsMap *A, StateTransitionsArray *T,
+			SASRewardsArray *R, Horizon *h);
+
 	/**
 	 * The value of a states and state's actions.
 	 */
@@ -120,6 +165,11 @@ private:
 	 */
 	double epsilon;
 
+	/**
+	 * The policy cache consulted before solving, or nullptr if there is none.
+	 */
+	PolicyCache *cache;
+
 };
 
 
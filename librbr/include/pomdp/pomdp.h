@@ -77,6 +77,20 @@ public:
 	 */
 	ObservationTransitions *get_observation_transitions();
 
+	/**
+	 * Freeze the POMDP so that it is read-only. This freezes both the state transitions and the
+	 * observation transitions.
+	 * @throw	StateTransitionException		The state transitions could not be frozen.
+	 * @throw	ObservationTransitionException	The observation transitions could not be frozen.
+	 */
+	virtual void freeze();
+
+	/**
+	 * Check if the POMDP has been frozen.
+	 * @return	Returns @code{true} if the POMDP is read-only; @code{false} otherwise.
+	 */
+	virtual bool is_frozen() const;
+
 protected:
 	/**
 	 * The observations in the POMDP; e.g., factored vectors of strings.
@@ -39,6 +39,8 @@
 #include "../core/rewards/saso_rewards.h"
 #include "../core/horizon.h"
 
+#include "../management/policy_cache.h"
+
 /**
  * List the possible expansion rules available while using PBVI.
  */
@@ -173,6 +175,14 @@ public:
 	 */
 	virtual PolicyAlphaVectors *solve(POMDP *pomdp);
 
+	/**
+	 * Set the policy cache which is consulted before solving, keyed by the fingerprint of the model
+	 * and the parameters of the solver, and which receives each new policy. The solver does not
+	 * take ownership of the cache. On a cache hit, no belief states are expanded.
+	 * @param	policyCache		The policy cache, or nullptr to always solve.
+	 */
+	virtual void set_policy_cache(PolicyCache *policyCache);
+
 	/**
 	 * Reset this POMDP PBVI solver. This method frees all the belief state memory.
 	 */
@@ -294,6 +304,11 @@ protected:
 	 */
 	std::vector<BeliefState *> B;
 
+	/**
+	 * The policy cache consulted before solving, or nullptr if there is none.
+	 */
+	PolicyCache *cache;
+
 };
 
 
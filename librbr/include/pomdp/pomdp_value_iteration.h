@@ -34,14 +34,16 @@
 #include "../core/states/states_map.h"
 #include "../core/actions/actions_map.h"
 #include "../core/observations/observations_map.h"
-#include "../core/state_transitions/state_transitions_map.h"
-#include "../core/observation_transitions/observation_transitions_map.h"
+#include "../core/state_transitions/state_transitions.h"
+#include "../core/observation_transitions/observation_transitions.h"
 //#include "../core/rewards/s_rewards.h"
 #include "../core/rewards/sa_rewards.h"
 #include "../core/rewards/sas_rewards.h"
 #include "../core/rewards/saso_rewards.h"
 #include "../core/horizon.h"
 
+#include "../management/policy_cache.h"
+
 /**
  * Solve an POMDP via value iteration (finite or infinite horizon). This solver has the
  * following requirements:
@@ -108,6 +110,14 @@ public:
 	 */
 	PolicyAlphaVectors *solve(POMDP *pomdp);
 
+	/**
+	 * Set the policy cache which is consulted before solving, keyed by the fingerprint of the model
+	 * and the parameters of the solver, and which receives each new policy. The solver does not
+	 * take ownership of the cache.
+	 * @param	policyCache		The policy cache, or nullptr to always solve.
+	 */
+	void set_policy_cache(PolicyCache *policyCache);
+
 private:
 	/**
 	 * Solve a finite horizon POMDP using value iteration.
@@ -122,7 +132,7 @@ private:
 	 * @return	Return the optimal policy as a collection of alpha vectors.
 	 */
 	PolicyAlphaVectors *solve_finite_horizon(StatesMap *S, ActionsMap *A, ObservationsMap *Z,
-			StateTransitionsMap *T, ObservationTransitionsMap *O, Rewards *R,
+			StateTransitions *T, ObservationTransitions *O, Rewards *R,
 			Horizon *h);
 
 	/**
@@ -138,7 +148,7 @@ private:
 	 * @return	Return the optimal policy as a collection of alpha vectors.
 	 */
 	PolicyAlphaVectors *solve_infinite_horizon(StatesMap *S, ActionsMap *A, ObservationsMap *Z,
-			StateTransitionsMap *T, ObservationTransitionsMap *O, Rewards *R,
+			StateTransitions *T, ObservationTransitions *O, Rewards *R,
 			Horizon *h);
 
 	/**
@@ -146,6 +156,11 @@ private:
 	 */
 	unsigned int iterations;
 
+	/**
+	 * The policy cache consulted before solving, or nullptr if there is none.
+	 */
+	PolicyCache *cache;
+
 };
 
 
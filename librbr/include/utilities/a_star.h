@@ -27,22 +27,34 @@
 
 
 #include <vector>
-#include <map>
+#include <functional>
+#include <unordered_map>
+
+#include "indexed_heap.h"
 
 /**
- * An implementation of the A* search algorithm.
+ * An implementation of the A* search algorithm. The open list is a d-ary indexed heap with
+ * decrease-key, and each node generated has a record (found by hashing the node) holding its
+ * cost so far, heuristic value, parent, and whether or not it has been expanded. Nodes are
+ * reopened if a cheaper path to an expanded node is found, so inconsistent (but admissible)
+ * heuristics still produce optimal paths.
+ *
+ * The node type must be copyable and comparable with '=='. The hash defaults to std::hash;
+ * provide one for node types without it (e.g., std::pair).
  */
-template <typename T>
+template <typename T, typename Hash = std::hash<T> >
 class AStar {
 public:
 	/**
 	 * The default constructor for the AStar class. It requires the specification of all
-	 * relevant variables.
+	 * relevant variables. Any function pointer, lambda, or functor with a matching signature
+	 * may be given.
 	 * @param	heuristic		The heuristic function estimating the distance from a node to the goal.
 	 * @param	cost			The cost from the immediate transition from one node to another.
 	 * @param	successors		Generate the list of successors nodes.
 	 */
-	AStar(double (*heuristic)(T node, T goal), double (*cost)(T n1, T n2), std::vector<T> (*successors)(T node));
+	AStar(std::function<double(T node, T goal)> heuristic, std::function<double(T n1, T n2)> cost,
+			std::function<std::vector<T>(T node)> successors);
 
 	/**
 	 * The deconstructor for the AStar class.
@@ -63,42 +75,102 @@ public:
 	 */
 	const std::vector<T> &get_path();
 
+	/**
+	 * Get the cost of the solution path which was computed from the last call of solve.
+	 * @return	The cost of the solution path.
+	 */
+	double get_path_cost();
+
 	/**
 	 * Get the number of nodes expanded from the last call of solve.
 	 * @return	The number of nodes expanded.
 	 */
 	int get_num_nodes_expanded();
 
+	/**
+	 * Get the number of nodes generated (given a record) from the last call of solve.
+	 * @return	The number of nodes generated.
+	 */
+	int get_num_nodes_generated();
+
 private:
 	/**
-	 * Reconstruct the path given a collection of maps nodes to parents and store it internally.
-	 * @param	start				The initial node.
-	 * @param	goal				The goal node.
-	 * @param	trace				The trace of all expanded nodes to their parents.
+	 * The record of a node which has been generated.
+	 */
+	struct AStarRecord {
+		/**
+		 * The node itself.
+		 */
+		T node;
+
+		/**
+		 * The cost of the best path found so far from the start to this node.
+		 */
+		double g;
+
+		/**
+		 * The heuristic value of this node.
+		 */
+		double h;
+
+		/**
+		 * The index of the parent record on the best path found so far.
+		 */
+		unsigned int parent;
+
+		/**
+		 * Whether or not the node is expanded (on the closed list).
+		 */
+		bool closed;
+	};
+
+	/**
+	 * Reconstruct the path by following the parents from a record back to the start, and store it internally.
+	 * @param	goal				The index of the goal's record.
 	 * @throw	UtilityException	The trace of the route was corrupt.
 	 */
-	void reconstruct_path(T start, T goal, std::map<T, T> &trace);
+	void reconstruct_path(unsigned int goal);
 
 	/**
 	 * The heuristic function estimating the distance from a node to the goal.
 	 */
-	double (*heuristic)(T node, T goal);
+	std::function<double(T node, T goal)> heuristic;
 
 	/**
 	 * The cost from the immediate transition from one node to another.
 	 */
-	double (*cost)(T n1, T n2);
+	std::function<double(T n1, T n2)> cost;
 
 	/**
 	 * Generate the list of successors nodes.
 	 */
-	std::vector<T> (*successors)(T node);
+	std::function<std::vector<T>(T node)> successors;
+
+	/**
+	 * The records of all nodes generated during the last call of solve.
+	 */
+	std::vector<AStarRecord> records;
+
+	/**
+	 * The index of each generated node's record.
+	 */
+	std::unordered_map<T, unsigned int, Hash> indices;
+
+	/**
+	 * The open list, over the indices of records, ordered by f = g + h (ties broken by larger g).
+	 */
+	IndexedHeap open;
 
 	/**
 	 * The optimal path from the last call of solve.
 	 */
 	std::vector<T> path;
 
+	/**
+	 * The cost of the optimal path from the last call of solve.
+	 */
+	double pathCost;
+
 	/**
 	 * The number of nodes expanded from the last call of solve.
 	 */
@@ -0,0 +1,301 @@
+/**
+ *  The MIT License (MIT)
+ *
+ *  Copyright (c) 2014 Kyle Hollins Wray, University of Massachusetts
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy of
+ *  this software and associated documentation files (the "Software"), to deal in
+ *  the Software without restriction, including without limitation the rights to
+ *  use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ *  the Software, and to permit persons to whom the Software is furnished to do so,
+ *  subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included in all
+ *  copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ *  FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ *  COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ *  IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ *  CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+
+#ifndef ARA_STAR_H
+#define ARA_STAR_H
+
+
+#include <vector>
+#include <functional>
+#include <unordered_map>
+#include <chrono>
+
+#include "indexed_heap.h"
+
+/**
+ * An implementation of Anytime Repairing A* (ARA*). It searches with an inflated heuristic,
+ * f = g + w * h, which quickly finds a path whose cost is at most w times the optimal. The
+ * weight is then decreased and the search repaired, reusing the g values, parents, and all
+ * generated nodes from the previous iterations: only nodes whose g values became inconsistent
+ * are re-expanded. Each improved path is published with its suboptimality bound, computed as
+ * the ratio of its cost to the smallest g + h among nodes which may still be improved.
+ *
+ * The search stops once the weight reaches 1 (the path is optimal), or once the wall-clock
+ * deadline or node budget is reached, keeping the best path found so far.
+ *
+ * The node type must be copyable and comparable with '=='. The hash defaults to std::hash.
+ */
+template <typename T, typename Hash = std::hash<T> >
+class ARAStar {
+public:
+	/**
+	 * The default constructor for the ARAStar class. It requires the specification of all
+	 * relevant variables. The initial weight defaults to 3, decreasing by 0.5 each iteration,
+	 * with no deadline and no node budget.
+	 * @param	heuristic		The admissible heuristic function estimating the distance from a node to the goal.
+	 * @param	cost			The cost from the immediate transition from one node to another.
+	 * @param	successors		Generate the list of successors nodes.
+	 */
+	ARAStar(std::function<double(T node, T goal)> heuristic, std::function<double(T n1, T n2)> cost,
+			std::function<std::vector<T>(T node)> successors);
+
+	/**
+	 * The deconstructor for the ARAStar class.
+	 */
+	virtual ~ARAStar();
+
+	/**
+	 * Set the initial weight on the heuristic and the amount it decreases after each iteration.
+	 * @param	initialWeight		The initial weight (at least 1).
+	 * @param	weightDecrement		The amount the weight decreases each iteration (greater than 0).
+	 * @throw	UtilityException	The weights were invalid.
+	 */
+	void set_weights(double initialWeight, double weightDecrement);
+
+	/**
+	 * Set the wall-clock time limit, measured from the start of each call of solve.
+	 * @param	seconds		The number of seconds until the search stops; 0 means no deadline.
+	 */
+	void set_deadline(double seconds);
+
+	/**
+	 * Set the maximum number of nodes to expand over all iterations of each call of solve.
+	 * @param	budget		The maximum number of nodes expanded; 0 means no budget.
+	 */
+	void set_node_budget(unsigned int budget);
+
+	/**
+	 * Set a function which is called each time an improved path is found or its suboptimality bound
+	 * tightens, given the best path, its cost, and its suboptimality bound.
+	 * @param	callback	The function called with each improved path.
+	 */
+	void set_path_callback(std::function<void(const std::vector<T> &path, double cost, double bound)> callback);
+
+	/**
+	 * Solve the search problem given a starting node, improving the path until it is optimal or
+	 * the deadline or node budget is reached.
+	 * @param	start				The initial node.
+	 * @param	goal				The goal node.
+	 * @throw	UtilityException	No path from the start to the goal was found before stopping.
+	 */
+	void solve(T start, T goal);
+
+	/**
+	 * Get the best path which was computed from the last call of solve.
+	 * @return	The best path from the start node to the goal node.
+	 */
+	const std::vector<T> &get_path();
+
+	/**
+	 * Get the cost of the best path which was computed from the last call of solve.
+	 * @return	The cost of the best path.
+	 */
+	double get_path_cost();
+
+	/**
+	 * Get the suboptimality bound of the best path which was computed from the last call of solve,
+	 * i.e., its cost is at most this factor times the optimal cost.
+	 * @return	The suboptimality bound of the best path.
+	 */
+	double get_suboptimality_bound();
+
+	/**
+	 * Get the number of nodes expanded over all iterations of the last call of solve.
+	 * @return	The number of nodes expanded.
+	 */
+	int get_num_nodes_expanded();
+
+	/**
+	 * Get the number of iterations (weights searched) completed during the last call of solve.
+	 * @return	The number of iterations completed.
+	 */
+	int get_num_iterations();
+
+private:
+	/**
+	 * The record of a node which has been generated.
+	 */
+	struct ARAStarRecord {
+		/**
+		 * The node itself.
+		 */
+		T node;
+
+		/**
+		 * The cost of the best path found so far from the start to this node.
+		 */
+		double g;
+
+		/**
+		 * The heuristic value of this node.
+		 */
+		double h;
+
+		/**
+		 * The index of the parent record on the best path found so far.
+		 */
+		unsigned int parent;
+
+		/**
+		 * The iteration in which this node was last expanded; it is closed if this is the current iteration.
+		 */
+		int closed;
+
+		/**
+		 * Whether or not this node is inconsistent: its g value decreased after it was expanded
+		 * in the current iteration.
+		 */
+		bool inconsistent;
+	};
+
+	/**
+	 * Expand nodes with the current weight until the goal cannot be improved by any node on the open list.
+	 * @param	goal	The goal node.
+	 * @return	Returns @code{true} if the deadline or node budget was reached, @code{false} otherwise.
+	 */
+	bool improve_path(const T &goal);
+
+	/**
+	 * Check if the deadline or node budget has been reached.
+	 * @return	Returns @code{true} if the search must stop, @code{false} otherwise.
+	 */
+	bool out_of_resources();
+
+	/**
+	 * Compute a lower bound on the optimal cost from the open and inconsistent nodes.
+	 * @return	The lower bound on the optimal cost; infinity if no node remains.
+	 */
+	double compute_lower_bound();
+
+	/**
+	 * Reconstruct the path by following the parents from the goal back to the start, compute its
+	 * cost, keep it if it improves on the best path, and tighten the suboptimality bound. Either change
+	 * is published to the path callback.
+	 * @param	goalIndex			The index of the goal's record.
+	 * @param	stopped				Whether the iteration was cut short by the deadline or node budget.
+	 * @throw	UtilityException	The trace of the route was corrupt.
+	 */
+	void publish_path(unsigned int goalIndex, bool stopped);
+
+	/**
+	 * The heuristic function estimating the distance from a node to the goal.
+	 */
+	std::function<double(T node, T goal)> heuristic;
+
+	/**
+	 * The cost from the immediate transition from one node to another.
+	 */
+	std::function<double(T n1, T n2)> cost;
+
+	/**
+	 * Generate the list of successors nodes.
+	 */
+	std::function<std::vector<T>(T node)> successors;
+
+	/**
+	 * The function called with each improved path.
+	 */
+	std::function<void(const std::vector<T> &path, double cost, double bound)> pathCallback;
+
+	/**
+	 * The initial weight on the heuristic.
+	 */
+	double initialWeight;
+
+	/**
+	 * The amount the weight decreases each iteration.
+	 */
+	double weightDecrement;
+
+	/**
+	 * The current weight on the heuristic.
+	 */
+	double weight;
+
+	/**
+	 * The wall-clock time limit in seconds; 0 means no deadline.
+	 */
+	double deadline;
+
+	/**
+	 * The maximum number of nodes expanded; 0 means no budget.
+	 */
+	unsigned int nodeBudget;
+
+	/**
+	 * The time at which the last call of solve started.
+	 */
+	std::chrono::steady_clock::time_point startTime;
+
+	/**
+	 * The records of all nodes generated during the last call of solve.
+	 */
+	std::vector<ARAStarRecord> records;
+
+	/**
+	 * The index of each generated node's record.
+	 */
+	std::unordered_map<T, unsigned int, Hash> indices;
+
+	/**
+	 * The open list, over the indices of records, ordered by g + weight * h (ties broken by larger g).
+	 */
+	IndexedHeap open;
+
+	/**
+	 * The indices of records of inconsistent nodes, which are added to the open list for the next iteration.
+	 */
+	std::vector<unsigned int> incons;
+
+	/**
+	 * The current iteration.
+	 */
+	int iteration;
+
+	/**
+	 * The best path from the last call of solve.
+	 */
+	std::vector<T> path;
+
+	/**
+	 * The cost of the best path from the last call of solve.
+	 */
+	double pathCost;
+
+	/**
+	 * The suboptimality bound of the best path from the last call of solve.
+	 */
+	double bound;
+
+	/**
+	 * The number of nodes expanded from the last call of solve.
+	 */
+	unsigned int numNodesExpanded;
+
+};
+
+#include "../../src/utilities/ara_star.tpp"
+
+
+#endif // ARA_STAR_H
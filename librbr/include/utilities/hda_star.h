@@ -0,0 +1,341 @@
+/**
+ *  The MIT License (MIT)
+ *
+ *  Copyright (c) 2014 Kyle Hollins Wray, University of Massachusetts
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy of
+ *  this software and associated documentation files (the "Software"), to deal in
+ *  the Software without restriction, including without limitation the rights to
+ *  use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ *  the Software, and to permit persons to whom the Software is furnished to do so,
+ *  subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included in all
+ *  copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ *  FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ *  COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ *  IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ *  CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+
+#ifndef HDA_STAR_H
+#define HDA_STAR_H
+
+
+#include <vector>
+#include <functional>
+#include <unordered_map>
+#include <atomic>
+#include <mutex>
+
+#include "indexed_heap.h"
+#include "mpsc_queue.h"
+
+/**
+ * An implementation of Hash Distributed A* (HDA*), a parallel A* search. Each node is owned by
+ * one thread, chosen by its hash, and each thread has its own records, hash table, and open list
+ * (as in AStar). When a thread expands a node, successors owned by other threads are batched and
+ * sent to them over lock-free queues; the owner computes the heuristic and inserts or improves
+ * the record, reopening it if it was already expanded.
+ *
+ * Once the goal is expanded its cost becomes the incumbent, and threads only expand nodes with
+ * f = g + h below it. The search ends when every thread is idle and no messages are in flight,
+ * tracked with a single counter of busy threads plus unprocessed messages: senders count their
+ * messages before pushing them, and receivers mark themselves busy before uncounting them, so
+ * the counter only reaches zero once no work can ever appear again. With an admissible heuristic
+ * the path is optimal.
+ *
+ * The callbacks are called concurrently from all threads, so they must be thread-safe and must
+ * not throw. The node type must be copyable, default constructible, and comparable with '=='.
+ */
+template <typename T, typename Hash = std::hash<T> >
+class HDAStar {
+public:
+	/**
+	 * The default constructor for the HDAStar class. It requires the specification of all
+	 * relevant variables, with the same signatures as AStar. The number of threads defaults
+	 * to the number of hardware threads.
+	 * @param	heuristic		The heuristic function estimating the distance from a node to the goal.
+	 * @param	cost			The cost from the immediate transition from one node to another.
+	 * @param	successors		Generate the list of successors nodes.
+	 */
+	HDAStar(std::function<double(T node, T goal)> heuristic, std::function<double(T n1, T n2)> cost,
+			std::function<std::vector<T>(T node)> successors);
+
+	/**
+	 * A constructor for the HDAStar class which also sets the number of threads.
+	 * @param	heuristic			The heuristic function estimating the distance from a node to the goal.
+	 * @param	cost				The cost from the immediate transition from one node to another.
+	 * @param	successors			Generate the list of successors nodes.
+	 * @param	numThreads			The number of threads to search with.
+	 * @throw	UtilityException	The number of threads was zero.
+	 */
+	HDAStar(std::function<double(T node, T goal)> heuristic, std::function<double(T n1, T n2)> cost,
+			std::function<std::vector<T>(T node)> successors, unsigned int numThreads);
+
+	/**
+	 * The deconstructor for the HDAStar class.
+	 */
+	virtual ~HDAStar();
+
+	/**
+	 * Set the number of threads to search with.
+	 * @param	numThreads			The number of threads.
+	 * @throw	UtilityException	The number of threads was zero.
+	 */
+	void set_num_threads(unsigned int numThreads);
+
+	/**
+	 * Get the number of threads to search with.
+	 * @return	The number of threads.
+	 */
+	unsigned int get_num_threads();
+
+	/**
+	 * Solve the search problem given a starting node.
+	 * @param	start				The initial node.
+	 * @param	goal				The goal node.
+	 * @throw	UtilityException	Either there is no path from the start to goal, or path reconstruction failed.
+	 */
+	void solve(T start, T goal);
+
+	/**
+	 * Get the solution path which was computed from the last call of solve.
+	 * @return	The solution path from the start node to the goal node.
+	 */
+	const std::vector<T> &get_path();
+
+	/**
+	 * Get the cost of the solution path which was computed from the last call of solve.
+	 * @return	The cost of the solution path.
+	 */
+	double get_path_cost();
+
+	/**
+	 * Get the number of nodes expanded, over all threads, from the last call of solve.
+	 * @return	The number of nodes expanded.
+	 */
+	int get_num_nodes_expanded();
+
+	/**
+	 * Get the number of nodes generated (given a record), over all threads, from the last call of solve.
+	 * @return	The number of nodes generated.
+	 */
+	int get_num_nodes_generated();
+
+private:
+	/**
+	 * The record of a node which has been generated, stored by the thread which owns it.
+	 */
+	struct HDAStarRecord {
+		/**
+		 * The node itself.
+		 */
+		T node;
+
+		/**
+		 * The cost of the best path found so far from the start to this node.
+		 */
+		double g;
+
+		/**
+		 * The heuristic value of this node.
+		 */
+		double h;
+
+		/**
+		 * The thread which owns the parent record on the best path found so far.
+		 */
+		unsigned int parentThread;
+
+		/**
+		 * The index of the parent record, within its thread's records.
+		 */
+		unsigned int parent;
+
+		/**
+		 * Whether or not the node is expanded (on the closed list).
+		 */
+		bool closed;
+	};
+
+	/**
+	 * A generated successor sent to the thread which owns it.
+	 */
+	struct HDAStarMessage {
+		/**
+		 * The successor node.
+		 */
+		T node;
+
+		/**
+		 * The cost of the path to the successor through its parent.
+		 */
+		double g;
+
+		/**
+		 * The thread which owns the parent's record.
+		 */
+		unsigned int parentThread;
+
+		/**
+		 * The index of the parent's record, within its thread's records.
+		 */
+		unsigned int parent;
+	};
+
+	/**
+	 * The state of one thread of the search.
+	 */
+	struct HDAStarWorker {
+		/**
+		 * The records of all nodes owned by this thread.
+		 */
+		std::vector<HDAStarRecord> records;
+
+		/**
+		 * The index of each owned node's record.
+		 */
+		std::unordered_map<T, unsigned int, Hash> indices;
+
+		/**
+		 * The open list, over the indices of records, ordered by f = g + h (ties broken by larger g).
+		 */
+		IndexedHeap open;
+
+		/**
+		 * The batches of messages sent to this thread.
+		 */
+		MPSCQueue<std::vector<HDAStarMessage> > inbox;
+
+		/**
+		 * The batches of messages being built for each other thread during an expansion.
+		 */
+		std::vector<std::vector<HDAStarMessage> > outbox;
+
+		/**
+		 * The number of nodes expanded by this thread.
+		 */
+		unsigned int numNodesExpanded;
+	};
+
+	/**
+	 * Get the thread which owns a node.
+	 * @param	node	The node.
+	 * @return	The index of the owning thread.
+	 */
+	unsigned int owner(const T &node);
+
+	/**
+	 * Run the search for one thread until the search terminates.
+	 * @param	thread	The index of the thread.
+	 * @param	goal	The goal node.
+	 */
+	void run(unsigned int thread, T goal);
+
+	/**
+	 * Insert or improve a node's record in the thread which owns it.
+	 * @param	thread		The index of the thread which owns the node.
+	 * @param	message		The generated node, its cost, and its parent.
+	 * @param	goal		The goal node.
+	 */
+	void receive(unsigned int thread, const HDAStarMessage &message, const T &goal);
+
+	/**
+	 * Expand the best node on a thread's open list, or record it as the incumbent if it is the goal.
+	 * @param	thread		The index of the thread.
+	 * @param	goal		The goal node.
+	 */
+	void expand(unsigned int thread, const T &goal);
+
+	/**
+	 * Reconstruct the path by following the parents from the goal back to the start, and store it internally.
+	 * @throw	UtilityException	The trace of the route was corrupt.
+	 */
+	void reconstruct_path();
+
+	/**
+	 * The heuristic function estimating the distance from a node to the goal.
+	 */
+	std::function<double(T node, T goal)> heuristic;
+
+	/**
+	 * The cost from the immediate transition from one node to another.
+	 */
+	std::function<double(T n1, T n2)> cost;
+
+	/**
+	 * Generate the list of successors nodes.
+	 */
+	std::function<std::vector<T>(T node)> successors;
+
+	/**
+	 * The number of threads to search with.
+	 */
+	unsigned int numThreads;
+
+	/**
+	 * The state of each thread during the last call of solve.
+	 */
+	std::vector<HDAStarWorker *> workers;
+
+	/**
+	 * The number of busy threads plus the number of messages sent but not yet processed.
+	 */
+	std::atomic<long long> work;
+
+	/**
+	 * Whether or not the search has terminated.
+	 */
+	std::atomic<bool> done;
+
+	/**
+	 * The cost of the best path to the goal found so far (the incumbent).
+	 */
+	std::atomic<double> incumbent;
+
+	/**
+	 * The thread which owns the goal's record, once the goal has been expanded.
+	 */
+	unsigned int goalThread;
+
+	/**
+	 * The index of the goal's record, within its thread's records.
+	 */
+	unsigned int goalIndex;
+
+	/**
+	 * Guards updates of the incumbent and the goal's record location.
+	 */
+	std::mutex incumbentMutex;
+
+	/**
+	 * The optimal path from the last call of solve.
+	 */
+	std::vector<T> path;
+
+	/**
+	 * The cost of the optimal path from the last call of solve.
+	 */
+	double pathCost;
+
+	/**
+	 * The number of nodes expanded from the last call of solve.
+	 */
+	unsigned int numNodesExpanded;
+
+	/**
+	 * The number of nodes generated from the last call of solve.
+	 */
+	unsigned int numNodesGenerated;
+
+};
+
+#include "../../src/utilities/hda_star.tpp"
+
+
+#endif // HDA_STAR_H
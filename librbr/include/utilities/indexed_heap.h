@@ -0,0 +1,206 @@
+/**
+ *  The MIT License (MIT)
+ *
+ *  Copyright (c) 2014 Kyle Hollins Wray, University of Massachusetts
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy of
+ *  this software and associated documentation files (the "Software"), to deal in
+ *  the Software without restriction, including without limitation the rights to
+ *  use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ *  the Software, and to permit persons to whom the Software is furnished to do so,
+ *  subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included in all
+ *  copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ *  FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ *  COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ *  IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ *  CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+
+#ifndef INDEXED_HEAP_H
+#define INDEXED_HEAP_H
+
+
+#include <vector>
+
+/**
+ * A d-ary min-heap over integer identifiers which supports changing an identifier's priority
+ * in place (e.g., decrease-key). Identifiers index a position table, so they should be small
+ * and dense, such as indices into an array of records. Ties in priority are broken in favor
+ * of the smaller tie value.
+ */
+class IndexedHeap {
+public:
+	/**
+	 * The default constructor for the IndexedHeap class. The arity defaults to 4.
+	 */
+	IndexedHeap();
+
+	/**
+	 * A constructor for the IndexedHeap class which specifies the arity.
+	 * @param	arity				The number of children of each node in the heap (at least 2).
+	 * @throw	UtilityException	The arity was less than 2.
+	 */
+	IndexedHeap(unsigned int arity);
+
+	/**
+	 * The deconstructor for the IndexedHeap class.
+	 */
+	virtual ~IndexedHeap();
+
+	/**
+	 * Add an identifier to the heap.
+	 * @param	id					The identifier to add.
+	 * @param	priority			The priority of the identifier; smaller values come first.
+	 * @param	tie					The tie value of the identifier; smaller values come first among equal priorities.
+	 * @throw	UtilityException	The identifier is already in the heap.
+	 */
+	void push(unsigned int id, double priority, double tie);
+
+	/**
+	 * Change the priority of an identifier in the heap, moving it up or down as required.
+	 * @param	id					The identifier to update.
+	 * @param	priority			The new priority of the identifier.
+	 * @param	tie					The new tie value of the identifier.
+	 * @throw	UtilityException	The identifier is not in the heap.
+	 */
+	void update(unsigned int id, double priority, double tie);
+
+	/**
+	 * Remove and return the identifier with the smallest priority.
+	 * @throw	UtilityException	The heap is empty.
+	 * @return	The identifier with the smallest priority.
+	 */
+	unsigned int pop();
+
+	/**
+	 * Get the identifier with the smallest priority.
+	 * @throw	UtilityException	The heap is empty.
+	 * @return	The identifier with the smallest priority.
+	 */
+	unsigned int top() const;
+
+	/**
+	 * Get the smallest priority in the heap.
+	 * @throw	UtilityException	The heap is empty.
+	 * @return	The smallest priority.
+	 */
+	double top_priority() const;
+
+	/**
+	 * Check if an identifier is in the heap.
+	 * @param	id		The identifier to check.
+	 * @return	Returns @code{true} if the identifier is in the heap, @code{false} otherwise.
+	 */
+	bool contains(unsigned int id) const;
+
+	/**
+	 * Get the priority of an identifier in the heap.
+	 * @param	id					The identifier.
+	 * @throw	UtilityException	The identifier is not in the heap.
+	 * @return	The priority of the identifier.
+	 */
+	double get_priority(unsigned int id) const;
+
+	/**
+	 * Get the identifier stored at a position in the heap's array. Iterating over all positions
+	 * visits every identifier in the heap, in no particular order.
+	 * @param	position			The position in the heap's array.
+	 * @throw	UtilityException	The position is out of bounds.
+	 * @return	The identifier at the position.
+	 */
+	unsigned int get(unsigned int position) const;
+
+	/**
+	 * Get the number of identifiers in the heap.
+	 * @return	The number of identifiers in the heap.
+	 */
+	unsigned int size() const;
+
+	/**
+	 * Check if the heap is empty.
+	 * @return	Returns @code{true} if the heap is empty, @code{false} otherwise.
+	 */
+	bool empty() const;
+
+	/**
+	 * Get the arity of the heap.
+	 * @return	The number of children of each node in the heap.
+	 */
+	unsigned int get_arity() const;
+
+	/**
+	 * Remove all identifiers from the heap.
+	 */
+	void clear();
+
+private:
+	/**
+	 * An entry in the heap.
+	 */
+	struct IndexedHeapEntry {
+		/**
+		 * The identifier.
+		 */
+		unsigned int id;
+
+		/**
+		 * The priority of the identifier.
+		 */
+		double priority;
+
+		/**
+		 * The tie value of the identifier.
+		 */
+		double tie;
+	};
+
+	/**
+	 * Check if one entry should come before another.
+	 * @param	a	The first entry.
+	 * @param	b	The second entry.
+	 * @return	Returns @code{true} if the first entry comes strictly before the second.
+	 */
+	bool before(const IndexedHeapEntry &a, const IndexedHeapEntry &b) const;
+
+	/**
+	 * Move the entry at a heap position up until the heap property holds.
+	 * @param	position	The position in the heap.
+	 */
+	void sift_up(unsigned int position);
+
+	/**
+	 * Move the entry at a heap position down until the heap property holds.
+	 * @param	position	The position in the heap.
+	 */
+	void sift_down(unsigned int position);
+
+	/**
+	 * The number of children of each node in the heap.
+	 */
+	unsigned int d;
+
+	/**
+	 * The heap itself, stored as an array.
+	 */
+	std::vector<IndexedHeapEntry> heap;
+
+	/**
+	 * The position of each identifier in the heap, or IndexedHeap::absent if it is not in the heap.
+	 */
+	std::vector<unsigned int> positions;
+
+	/**
+	 * The position value of identifiers which are not in the heap.
+	 */
+	static const unsigned int absent;
+
+};
+
+
+#endif // INDEXED_HEAP_H
@@ -0,0 +1,126 @@
+/**
+ *  The MIT License (MIT)
+ *
+ *  Copyright (c) 2014 Kyle Hollins Wray, University of Massachusetts
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy of
+ *  this software and associated documentation files (the "Software"), to deal in
+ *  the Software without restriction, including without limitation the rights to
+ *  use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ *  the Software, and to permit persons to whom the Software is furnished to do so,
+ *  subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included in all
+ *  copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ *  FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ *  COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ *  IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ *  CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+
+#ifndef LAZY_TABLE_H
+#define LAZY_TABLE_H
+
+
+#include <atomic>
+
+/**
+ * The number of slots in each page of a lazy table.
+ */
+#define LAZY_TABLE_PAGE_SIZE 1024
+
+/**
+ * A table of objects by index which are created on demand, e.g., the states of a factored state space.
+ * Lookups and insertions are lock-free: the slots are atomic pointers, grouped into pages which are
+ * only allocated once one of their slots is used, and both pages and objects are installed with a
+ * compare-and-swap. An object stays in the table (so pointers to it remain valid) until the table is
+ * cleared or resized, which must not happen while other threads use it.
+ *
+ * The table owns its objects and frees them with delete.
+ */
+template <typename T>
+class LazyTable {
+public:
+	/**
+	 * The default constructor for the LazyTable class, with no slots.
+	 */
+	LazyTable();
+
+	/**
+	 * The deconstructor for the LazyTable class, which frees the objects in the table.
+	 */
+	virtual ~LazyTable();
+
+	/**
+	 * Free the objects in the table and set its number of slots. Only the list of pages is allocated.
+	 * @param	size	The number of slots.
+	 */
+	void resize(unsigned int size);
+
+	/**
+	 * Free the objects in the table and remove all of its slots.
+	 */
+	void clear();
+
+	/**
+	 * Get the object at an index. This may be called by any number of threads at once.
+	 * @param	index	The index of the slot, which must be less than the size.
+	 * @return	The object at the index, or nullptr if none has been inserted.
+	 */
+	T *get(unsigned int index) const;
+
+	/**
+	 * Insert an object at an index, unless another is already there. This may be called by any
+	 * number of threads at once; if another thread inserted an object first, the object given is
+	 * freed and the other one is returned.
+	 * @param	index	The index of the slot, which must be less than the size.
+	 * @param	object	The new object, owned by the table from now on.
+	 * @return	The object at the index after the insertion.
+	 */
+	T *insert(unsigned int index, T *object);
+
+	/**
+	 * Get the number of objects which have been inserted.
+	 * @return	The number of objects in the table.
+	 */
+	unsigned int get_num_objects() const;
+
+private:
+	/**
+	 * The copy constructor for the LazyTable class, which is not allowed.
+	 * @param	other	The table to copy.
+	 */
+	LazyTable(const LazyTable<T> &other);
+
+	/**
+	 * Get the page of slots for an index, allocating it if needed.
+	 * @param	index	The index of the slot.
+	 * @return	The page which holds the slot.
+	 */
+	std::atomic<T *> *find_page(unsigned int index);
+
+	/**
+	 * The pages of slots, each nullptr until one of its slots is used.
+	 */
+	std::atomic<std::atomic<T *> *> *pages;
+
+	/**
+	 * The number of pages.
+	 */
+	unsigned int numPages;
+
+	/**
+	 * The number of objects which have been inserted.
+	 */
+	std::atomic<unsigned int> numObjects;
+
+};
+
+#include "../../src/utilities/lazy_table.tpp"
+
+
+#endif // LAZY_TABLE_H
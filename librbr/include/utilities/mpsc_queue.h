@@ -0,0 +1,103 @@
+/**
+ *  The MIT License (MIT)
+ *
+ *  Copyright (c) 2014 Kyle Hollins Wray, University of Massachusetts
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy of
+ *  this software and associated documentation files (the "Software"), to deal in
+ *  the Software without restriction, including without limitation the rights to
+ *  use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ *  the Software, and to permit persons to whom the Software is furnished to do so,
+ *  subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included in all
+ *  copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ *  FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ *  COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ *  IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ *  CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+
+#ifndef MPSC_QUEUE_H
+#define MPSC_QUEUE_H
+
+
+#include <atomic>
+
+/**
+ * An unbounded lock-free queue with many producers and a single consumer. It is a linked list
+ * with a stub node: producers atomically exchange the head and then link the previous head to
+ * their new node (a wait-free push), and the consumer follows the links from the tail. A value
+ * pushed is visible to the consumer once its link is stored, so a pop may briefly miss a value
+ * whose push is still in progress.
+ *
+ * The value type must be default constructible and movable.
+ */
+template <typename T>
+class MPSCQueue {
+public:
+	/**
+	 * The default constructor for the MPSCQueue class.
+	 */
+	MPSCQueue();
+
+	/**
+	 * The deconstructor for the MPSCQueue class, which frees any values still in the queue.
+	 */
+	virtual ~MPSCQueue();
+
+	/**
+	 * Push a value onto the queue. This may be called by any number of threads at once.
+	 * @param	value	The value to push, which is moved into the queue.
+	 */
+	void push(T &&value);
+
+	/**
+	 * Pop the oldest value from the queue. This must only be called by one thread at a time.
+	 * @param	value	The value popped, moved out of the queue. This is only assigned on success.
+	 * @return	Returns @code{true} if a value was popped, @code{false} if the queue was empty.
+	 */
+	bool try_pop(T &value);
+
+private:
+	/**
+	 * A node in the linked list.
+	 */
+	struct MPSCQueueNode {
+		/**
+		 * The next (newer) node in the list.
+		 */
+		std::atomic<MPSCQueueNode *> next;
+
+		/**
+		 * The value stored in the node.
+		 */
+		T value;
+	};
+
+	/**
+	 * The copy constructor for the MPSCQueue class, which is not allowed.
+	 * @param	other	The queue to copy.
+	 */
+	MPSCQueue(const MPSCQueue<T> &other);
+
+	/**
+	 * The newest node in the list, which producers exchange.
+	 */
+	std::atomic<MPSCQueueNode *> head;
+
+	/**
+	 * The oldest node in the list (a stub whose value was already popped), owned by the consumer.
+	 */
+	MPSCQueueNode *tail;
+
+};
+
+#include "../../src/utilities/mpsc_queue.tpp"
+
+
+#endif // MPSC_QUEUE_H
@@ -0,0 +1,85 @@
+/**
+ *  The MIT License (MIT)
+ *
+ *  Copyright (c) 2014 Kyle Hollins Wray, University of Massachusetts
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy of
+ *  this software and associated documentation files (the "Software"), to deal in
+ *  the Software without restriction, including without limitation the rights to
+ *  use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ *  the Software, and to permit persons to whom the Software is furnished to do so,
+ *  subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included in all
+ *  copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ *  FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ *  COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ *  IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ *  CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+
+#ifndef TABLE_INDEX_H
+#define TABLE_INDEX_H
+
+
+#include <vector>
+#include <unordered_map>
+
+/**
+ * The position of each object in a table, e.g., the states in the order of order_policy_states. If
+ * every object is an Indexed object at its own index, then an object's position is simply its index;
+ * otherwise, the positions are looked up in a hash table built once.
+ */
+template <typename Indexed, typename T>
+class TableIndex {
+public:
+	/**
+	 * The constructor for the TableIndex class.
+	 * @param	table	The objects in order, which must remain valid while the positions are looked up.
+	 */
+	TableIndex(const std::vector<T *> &table);
+
+	/**
+	 * The deconstructor for the TableIndex class.
+	 */
+	virtual ~TableIndex();
+
+	/**
+	 * Find the position of an object in the table.
+	 * @param	object	The object to find.
+	 * @return	The position of the object, or the size of the table if it is not in the table.
+	 */
+	unsigned int find(T *object) const;
+
+	/**
+	 * Return if every object is an Indexed object at its own index.
+	 * @return	Returns @code{true} if the objects are stored by index, and @code{false} otherwise.
+	 */
+	bool is_indexed() const;
+
+private:
+	/**
+	 * The number of objects in the table.
+	 */
+	unsigned int size;
+
+	/**
+	 * If every object is an Indexed object at its own index.
+	 */
+	bool indexed;
+
+	/**
+	 * The position of each object, only if the objects are not stored by index.
+	 */
+	std::unordered_map<T *, unsigned int> positions;
+
+};
+
+#include "../../src/utilities/table_index.tpp"
+
+
+#endif // TABLE_INDEX_H
@@ -0,0 +1,166 @@
+/**
+ *  The MIT License (MIT)
+ *
+ *  Copyright (c) 2014 Kyle Hollins Wray, University of Massachusetts
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy of
+ *  this software and associated documentation files (the "Software"), to deal in
+ *  the Software without restriction, including without limitation the rights to
+ *  use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ *  the Software, and to permit persons to whom the Software is furnished to do so,
+ *  subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included in all
+ *  copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ *  FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ *  COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ *  IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ *  CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+
+#ifndef TOKENIZER_H
+#define TOKENIZER_H
+
+
+#include <string>
+#include <cstddef>
+
+/**
+ * A view of a sequence of characters within a buffer. It does not own the characters, so it is
+ * only valid while the buffer is.
+ */
+struct Token {
+	/**
+	 * The first character.
+	 */
+	const char *data;
+
+	/**
+	 * The number of characters.
+	 */
+	unsigned int length;
+};
+
+/**
+ * Check if a token is equal to a null-terminated string.
+ * @param	token	The token.
+ * @param	text	The string.
+ * @return	Returns @code{true} if the token has exactly the characters of the string, @code{false} otherwise.
+ */
+bool token_equals(const Token &token, const char *text);
+
+/**
+ * Copy a token into a string.
+ * @param	token	The token.
+ * @return	The string with the token's characters.
+ */
+std::string token_to_string(const Token &token);
+
+/**
+ * A single-pass tokenizer over a buffer of text, e.g., a memory-mapped file. It splits the buffer
+ * into lines and lines into items, all as tokens pointing into the buffer, and parses numbers
+ * in place, so it never allocates memory.
+ */
+class Tokenizer {
+public:
+	/**
+	 * The default constructor for the Tokenizer class.
+	 * @param	data	The buffer of text, which must remain valid while tokens are used.
+	 * @param	size	The number of characters in the buffer.
+	 */
+	Tokenizer(const char *data, std::size_t size);
+
+	/**
+	 * The default deconstructor for the Tokenizer class.
+	 */
+	virtual ~Tokenizer();
+
+	/**
+	 * Get the next line, without its line ending (either "\n" or "\r\n").
+	 * @param	line	The next line. This is only assigned on success.
+	 * @return	Returns @code{true} if there was another line, @code{false} otherwise.
+	 */
+	bool next_line(Token &line);
+
+	/**
+	 * Remove a comment, i.e., everything from the first '#', from a line.
+	 * @param	line	The line to modify.
+	 */
+	static void strip_comment(Token &line);
+
+	/**
+	 * Check if a line contains a character.
+	 * @param	line	The line.
+	 * @param	c		The character.
+	 * @return	Returns @code{true} if the character is in the line, @code{false} otherwise.
+	 */
+	static bool contains(const Token &line, char c);
+
+	/**
+	 * Split a line by colons, trimming the spaces around each item and skipping empty items, as
+	 * split_string_by_colon does.
+	 * @param	line		The line.
+	 * @param	items		The array of items to assign.
+	 * @param	maxItems	The size of the items array; any further items are counted but not stored.
+	 * @return	The number of items in the line.
+	 */
+	static unsigned int split_by_colon(const Token &line, Token *items, unsigned int maxItems);
+
+	/**
+	 * Get the next item separated by spaces (or tabs), as split_string_by_space does. An item
+	 * starting with '<' continues until the next '>', and excludes both brackets.
+	 * @param	remaining	The rest of the line, which is advanced past the item.
+	 * @param	item		The next item. This is only assigned on success.
+	 * @return	Returns @code{true} if there was another item, @code{false} otherwise.
+	 */
+	static bool next_item(Token &remaining, Token &item);
+
+	/**
+	 * Count the items separated by spaces (or tabs) in a line, as next_item would find them.
+	 * @param	line	The line.
+	 * @return	The number of items.
+	 */
+	static unsigned int count_items(const Token &line);
+
+	/**
+	 * Parse a number, with the same result as std::stod: the longest valid prefix is converted,
+	 * and it is correctly rounded. Common decimals are converted directly; anything else
+	 * (e.g., long mantissas, large exponents, or "inf") is handed to strtod.
+	 * @param	token	The token.
+	 * @param	value	The number. This is only assigned on success.
+	 * @return	Returns @code{true} if the token starts with a number, @code{false} otherwise.
+	 */
+	static bool parse_double(const Token &token, double &value);
+
+	/**
+	 * Parse an integer, with the same result as std::stoi: the longest valid prefix is converted.
+	 * @param	token	The token.
+	 * @param	value	The integer. This is only assigned on success.
+	 * @return	Returns @code{true} if the token starts with an integer in range, @code{false} otherwise.
+	 */
+	static bool parse_int(const Token &token, int &value);
+
+private:
+	/**
+	 * The buffer of text.
+	 */
+	const char *data;
+
+	/**
+	 * The number of characters in the buffer.
+	 */
+	std::size_t size;
+
+	/**
+	 * The position of the start of the next line.
+	 */
+	std::size_t position;
+
+};
+
+
+#endif // TOKENIZER_H
@@ -23,48 +23,8 @@
 
 
 #include "../../../include/core/actions/action_utilities.h"
-#include "../../../include/core/actions/action_exception.h"
-
-#include "../../../include/core/actions/named_action.h"
-#include "../../../include/core/actions/joint_action.h"
 
 Action *find_action(ActionsMap *A, std::string actionName)
 {
-	for (auto act : *A) {
-		Action *action = resolve(act);
-
-		// Try to cast the action as a NamedAction. If it fails, it may still be a joint action.
-	    NamedAction *a = dynamic_cast<NamedAction *>(action);
-	    if (a == nullptr) {
-	    	// Try to cast it as a JointAction.
-	    	JointAction *ja = dynamic_cast<JointAction *>(action);
-		    if (ja == nullptr) {
-		    	throw ActionException();
-		    }
-
-		    // Construct the joint action name from the component names, separated by spaces.
-		    std::string jaName = "";
-	    	for (unsigned int i = 0; i < ja->get_num_actions(); i++) {
-	    		a = dynamic_cast<NamedAction *>(ja->get(i));
-	    		if (a == nullptr) {
-	    			throw ActionException();
-	    		}
-
-	    		jaName += a->get_name();
-	    		if (i < ja->get_num_actions() - 1) {
-	    			jaName += " ";
-	    		}
-	    	}
-
-    		if (jaName.compare(actionName) == 0) {
-	    		return ja;
-    		}
-	    } else {
-			if (a->get_name().compare(actionName) == 0) {
-				return action;
-			}
-	    }
-	}
-
-	throw ActionException();
+	return A->get_by_name(actionName);
 }
@@ -25,6 +25,9 @@
 #include "../../../include/core/actions/actions_map.h"
 #include "../../../include/core/actions/action_exception.h"
 
+#include "../../../include/core/actions/named_action.h"
+#include "../../../include/core/actions/joint_action.h"
+
 #include <algorithm>
 
 ActionsMap::ActionsMap()
@@ -42,7 +45,17 @@ ActionsMap::~ActionsMap()
 
 void ActionsMap::add(Action *newAction)
 {
-	actions[newAction->hash_value()] = newAction;
+	// An action with the same hash value is replaced, in place, in the list of all actions.
+	std::unordered_map<unsigned int, Action *>::iterator result = actions.find(newAction->hash_value());
+	if (result != actions.end()) {
+		std::replace(allActions.begin(), allActions.end(), result->second, newAction);
+		remove_name(result->second);
+		result->second = newAction;
+	} else {
+		actions[newAction->hash_value()] = newAction;
+		allActions.push_back(newAction);
+	}
+	add_name(newAction);
 }
 
 void ActionsMap::remove(Action *removeAction)
@@ -53,6 +66,12 @@ void ActionsMap::remove(Action *removeAction)
 	}
 
 	actions.erase(removeAction->hash_value());
+	remove_name(removeAction);
+	allActions.erase(std::remove(allActions.begin(), allActions.end(), removeAction), allActions.end());
+	for (auto &state : stateActions) {
+		state.second.erase(std::remove(state.second.begin(), state.second.end(), removeAction), state.second.end());
+	}
+
 	delete removeAction;
 }
 
@@ -60,7 +79,7 @@ void ActionsMap::set(const std::vector<Action *> &newActions)
 {
 	reset();
 	for (Action *action : newActions) {
-		actions[action->hash_value()] = action;
+		add(action);
 	}
 }
 
@@ -88,9 +107,46 @@ unsigned int ActionsMap::get_num_actions() const
 	return actions.size();
 }
 
-std::unordered_map<unsigned int, Action *> ActionsMap::available(State *state)
+Action *ActionsMap::get_action(unsigned int index) const
+{
+	if (index >= allActions.size()) {
+		throw ActionException();
+	}
+	return allActions[index];
+}
+
+const std::vector<Action *> &ActionsMap::available(State *state)
+{
+	if (stateActions.empty()) {
+		return allActions;
+	}
+
+	std::unordered_map<State *, std::vector<Action *> >::const_iterator result = stateActions.find(state);
+	if (result == stateActions.end()) {
+		return allActions;
+	}
+	return result->second;
+}
+
+void ActionsMap::set_available(State *state, const std::vector<Action *> &availableActions)
+{
+	for (Action *action : availableActions) {
+		if (!exists(action)) {
+			throw ActionException();
+		}
+	}
+
+	stateActions[state] = availableActions;
+}
+
+bool ActionsMap::has_state_dependent_actions() const
+{
+	return !stateActions.empty();
+}
+
+void ActionsMap::reset_available()
 {
-	return actions;
+	stateActions.clear();
 }
 
 void ActionsMap::reset()
@@ -99,16 +155,107 @@ void ActionsMap::reset()
 		delete resolve(action);
 	}
 	actions.clear();
+	allActions.clear();
+	stateActions.clear();
+	names.clear();
+}
+
+ActionsMapIterator ActionsMap::begin() const
+{
+	return ActionsMapIterator(this, 0);
+}
+
+ActionsMapIterator ActionsMap::end() const
+{
+	return ActionsMapIterator(this, get_num_actions());
 }
 
-std::unordered_map<unsigned int, Action *>::iterator ActionsMap::begin()
+Action *ActionsMap::get_by_name(const std::string &name) const
 {
-	return actions.begin();
+	std::unordered_map<std::string, Action *>::const_iterator result = names.find(name);
+	if (result == names.end()) {
+		throw ActionException();
+	}
+	return result->second;
 }
 
-std::unordered_map<unsigned int, Action *>::iterator ActionsMap::end()
+void ActionsMap::add_name(Action *action)
 {
-	return actions.end();
+	// The first action with a particular name is kept, matching the order of a linear search.
+	std::string name;
+	if (get_name(action, name)) {
+		names.insert(std::make_pair(name, action));
+	}
+}
+
+void ActionsMap::remove_name(Action *action)
+{
+	std::string name;
+	if (!get_name(action, name)) {
+		return;
+	}
+
+	std::unordered_map<std::string, Action *>::iterator result = names.find(name);
+	if (result != names.end() && result->second == action) {
+		names.erase(result);
+	}
+}
+
+bool ActionsMap::get_name(Action *action, std::string &name)
+{
+	NamedAction *n = dynamic_cast<NamedAction *>(action);
+	if (n != nullptr) {
+		name = n->get_name();
+		return true;
+	}
+
+	JointAction *j = dynamic_cast<JointAction *>(action);
+	if (j == nullptr) {
+		return false;
+	}
+
+	// Construct the name from the component names, separated by spaces.
+	name = "";
+	for (unsigned int i = 0; i < j->get_num_actions(); i++) {
+		n = dynamic_cast<NamedAction *>(j->get(i));
+		if (n == nullptr) {
+			return false;
+		}
+
+		name += n->get_name();
+		if (i < j->get_num_actions() - 1) {
+			name += " ";
+		}
+	}
+
+	return true;
+}
+
+ActionsMapIterator::ActionsMapIterator(const ActionsMap *actionsMap, unsigned int index)
+{
+	this->actionsMap = actionsMap;
+	this->index = index;
+}
+
+Action *ActionsMapIterator::operator*() const
+{
+	return actionsMap->get_action(index);
+}
+
+ActionsMapIterator &ActionsMapIterator::operator++()
+{
+	index++;
+	return *this;
+}
+
+bool ActionsMapIterator::operator==(const ActionsMapIterator &other) const
+{
+	return actionsMap == other.actionsMap && index == other.index;
+}
+
+bool ActionsMapIterator::operator!=(const ActionsMapIterator &other) const
+{
+	return !(*this == other);
 }
 
 Action *resolve(std::unordered_map<unsigned int, Action *>::value_type &actionIterator)
@@ -120,3 +267,13 @@ unsigned int hash_value(std::unordered_map<unsigned int, Action *>::value_type &
 {
 	return actionIterator.first;
 }
+
+Action *resolve(Action *actionIterator)
+{
+	return actionIterator;
+}
+
+unsigned int hash_value(Action *actionIterator)
+{
+	return actionIterator->hash_value();
+}
@@ -25,15 +25,23 @@
 #include "../../../include/core/actions/indexed_action.h"
 #include "../../../include/core/actions/action_exception.h"
 
-unsigned int IndexedAction::indexer = 0;
+Indexer IndexedAction::indexer;
 
 IndexedAction::IndexedAction()
 {
-	// Assign the index of the action equal to the current value of
-	// indexer. Then, increment the indexer variable in preparation
-	// for the next one.
-	index = indexer;
-	indexer++;
+	// Assign the index of the action from the static indexer, which also increments it
+	// in preparation for the next one.
+	index = indexer.next();
+}
+
+IndexedAction::IndexedAction(Indexer &modelIndexer)
+{
+	index = modelIndexer.next();
+}
+
+IndexedAction::IndexedAction(unsigned int initialIndex)
+{
+	index = initialIndex;
 }
 
 IndexedAction::IndexedAction(const IndexedAction &other)
@@ -71,10 +79,10 @@ unsigned int IndexedAction::hash_value() const
 
 unsigned int IndexedAction::get_num_actions()
 {
-	return indexer;
+	return indexer.get_num_indexes();
 }
 
 void IndexedAction::reset_indexer()
 {
-	indexer = 0;
+	indexer.reset();
 }
@@ -27,6 +27,7 @@
 #include "../../../include/core/actions/action_exception.h"
 
 #include <algorithm>
+#include <limits>
 
 JointActionsMap::JointActionsMap(unsigned int numFactors)
 {
@@ -34,6 +35,8 @@ JointActionsMap::JointActionsMap(unsigned int numFactors)
 		numFactors = 1;
 	}
 	factoredActions.resize(numFactors);
+
+	numJointActions = 0;
 }
 
 JointActionsMap::~JointActionsMap()
@@ -99,10 +102,187 @@ void JointActionsMap::update()
 		}
 	}
 
-	actions.clear();
+	clear_created();
+
+	factorIndexes.clear();
+	factorIndexes.resize(factoredActions.size());
+	factorNames.clear();
+	factorNames.resize(factoredActions.size());
+
+	numJointActions = 1;
+
+	for (unsigned int i = 0; i < factoredActions.size(); i++) {
+		if (numJointActions > std::numeric_limits<unsigned int>::max() / factoredActions[i].size()) {
+			numJointActions = 0;
+			throw ActionException();
+		}
+		numJointActions *= factoredActions[i].size();
+
+		// The first action with a particular name is kept, as in ActionsMap.
+		for (unsigned int j = 0; j < factoredActions[i].size(); j++) {
+			factorIndexes[i][factoredActions[i][j]] = j;
+
+			std::string name;
+			if (get_name(factoredActions[i][j], name)) {
+				factorNames[i].insert(std::make_pair(name, j));
+			}
+		}
+	}
+
+	created.resize(numJointActions);
+}
+
+bool JointActionsMap::exists(Action *action) const
+{
+	try {
+		get_index(action);
+	} catch (const ActionException &err) {
+		return false;
+	}
+	return true;
+}
+
+Action *JointActionsMap::get(unsigned int hash)
+{
+	if (numJointActions == 0) {
+		throw ActionException();
+	}
+
+	// Continue a hash, as JointAction computes it, over the parts in the factors from first to last
+	// (exclusive) given by a mixed-radix index over only those factors.
+	auto hash_parts = [this](unsigned int first, unsigned int last, unsigned int index, unsigned int h) {
+		std::vector<unsigned int> digits(last - first, 0);
+		for (unsigned int i = last; i > first; i--) {
+			digits[i - 1 - first] = index % factoredActions[i - 1].size();
+			index /= factoredActions[i - 1].size();
+		}
+		for (unsigned int i = first; i < last; i++) {
+			h = 31 * h + factoredActions[i][digits[i - first]]->hash_value();
+		}
+		return h;
+	};
+
+	// The hash is prefix * 31^k + suffix (modulo 2^32) for the k factors in the suffix, so grow the suffix
+	// to about the square root of the number of joint actions, and tabulate the hash of each suffix.
+	unsigned int split = factoredActions.size() - 1;
+	unsigned long long numSuffixes = factoredActions[split].size();
+	while (split > 0 && numSuffixes * factoredActions[split - 1].size() *
+			numSuffixes * factoredActions[split - 1].size() <= numJointActions) {
+		split--;
+		numSuffixes *= factoredActions[split].size();
+	}
+
+	unsigned int multiplier = 1;
+	for (unsigned int i = split; i < factoredActions.size(); i++) {
+		multiplier *= 31;
+	}
+
+	// The first suffix with a particular hash is kept, so the lowest index is found.
+	std::unordered_map<unsigned int, unsigned int> suffixes;
+	for (unsigned int j = 0; j < numSuffixes; j++) {
+		suffixes.insert(std::make_pair(hash_parts(split, factoredActions.size(), j, 0), j));
+	}
+
+	unsigned int numPrefixes = numJointActions / numSuffixes;
+	for (unsigned int i = 0; i < numPrefixes; i++) {
+		std::unordered_map<unsigned int, unsigned int>::const_iterator result =
+				suffixes.find(hash - hash_parts(0, split, i, 7) * multiplier);
+		if (result != suffixes.end()) {
+			return get_action(i * numSuffixes + result->second);
+		}
+	}
+
+	throw ActionException();
+}
+
+Action *JointActionsMap::get_by_name(const std::string &name) const
+{
+	unsigned int index = 0;
+	std::size_t start = 0;
+
+	for (unsigned int i = 0; i < factorNames.size(); i++) {
+		std::size_t stop = name.find(' ', start);
+		if ((stop == std::string::npos) != (i == factorNames.size() - 1)) {
+			throw ActionException();
+		}
+
+		std::unordered_map<std::string, unsigned int>::const_iterator result =
+				factorNames[i].find(name.substr(start, stop - start));
+		if (result == factorNames[i].end()) {
+			throw ActionException();
+		}
+
+		index = index * factoredActions[i].size() + result->second;
+		start = stop + 1;
+	}
+
+	return get_action(index);
+}
+
+unsigned int JointActionsMap::get_index(const Action *action) const
+{
+	const JointAction *j = dynamic_cast<const JointAction *>(action);
+	if (j == nullptr || numJointActions == 0 || j->get_num_actions() != (unsigned int)factorIndexes.size()) {
+		throw ActionException();
+	}
+
+	unsigned int index = 0;
+
+	for (unsigned int i = 0; i < factorIndexes.size(); i++) {
+		std::unordered_map<const Action *, unsigned int>::const_iterator result =
+				factorIndexes[i].find(const_cast<JointAction *>(j)->get(i));
+		if (result == factorIndexes[i].end()) {
+			throw ActionException();
+		}
+
+		index = index * factoredActions[i].size() + result->second;
+	}
 
-	std::vector<Action *> create;
-	update_step(create, 0);
+	return index;
+}
+
+Action *JointActionsMap::get_action(unsigned int index) const
+{
+	if (index >= numJointActions) {
+		throw ActionException();
+	}
+
+	JointAction *jointAction = created.get(index);
+	if (jointAction != nullptr) {
+		return jointAction;
+	}
+
+	// Decode the mixed-radix index, starting from the last (least significant) factor.
+	std::vector<Action *> parts(factoredActions.size(), nullptr);
+	unsigned int remainder = index;
+	for (int i = (int)factoredActions.size() - 1; i >= 0; i--) {
+		parts[i] = factoredActions[i][remainder % factoredActions[i].size()];
+		remainder /= factoredActions[i].size();
+	}
+
+	// If another thread creates the joint action first, its joint action is returned instead.
+	return created.insert(index, new JointAction(parts));
+}
+
+unsigned int JointActionsMap::get_num_actions() const
+{
+	return numJointActions;
+}
+
+const std::vector<Action *> &JointActionsMap::available(State *state)
+{
+	// The list of all joint actions is only created the first time it is needed.
+	std::lock_guard<std::mutex> lock(availableMutex);
+
+	if (allActions.size() != numJointActions) {
+		allActions.clear();
+		allActions.reserve(numJointActions);
+		for (unsigned int i = 0; i < numJointActions; i++) {
+			allActions.push_back(get_action(i));
+		}
+	}
+
+	return ActionsMap::available(state);
 }
 
 unsigned int JointActionsMap::get_num_factors()
@@ -110,6 +290,15 @@ unsigned int JointActionsMap::get_num_factors()
 	return factoredActions.size();
 }
 
+const std::vector<Action *> &JointActionsMap::get_factor(unsigned int factorIndex)
+{
+	if (factorIndex >= factoredActions.size()) {
+		throw ActionException();
+	}
+
+	return factoredActions[factorIndex];
+}
+
 void JointActionsMap::reset()
 {
 	for (std::vector<Action *> &factor : factoredActions) {
@@ -119,26 +308,17 @@ void JointActionsMap::reset()
 		factor.clear();
 	}
 
-	actions.clear();
+	clear_created();
+	factorIndexes.clear();
+	factorNames.clear();
+	numJointActions = 0;
+
+	ActionsMap::reset();
 }
 
-void JointActionsMap::update_step(std::vector<Action *> currentJointAction, unsigned int currentFactorIndex)
+void JointActionsMap::clear_created()
 {
-	// At the final factor index, we need to create a bunch of joint actions.
-	for (Action *action : factoredActions[currentFactorIndex]) {
-		// Begin by pushing a current factor's action on the vector (tuple).
-		currentJointAction.push_back(action);
+	created.clear();
 
-		// If this is the final index, then create a joint action object and append it to the list of actions.
-		// Otherwise, recurse to the next index, using the new currentJointAction object.
-		if (currentFactorIndex == factoredActions.size() - 1) {
-			JointAction *newAction = new JointAction(currentJointAction);
-			actions[newAction->hash_value()] = newAction;
-		} else {
-			update_step(currentJointAction, currentFactorIndex + 1);
-		}
-
-		// Pop off the action that was just appended, to prepare for the next loop.
-		currentJointAction.pop_back();
-	}
+	allActions.clear();
 }
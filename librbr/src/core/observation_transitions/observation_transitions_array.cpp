@@ -25,6 +25,8 @@
 #include "../../../include/core/observation_transitions/observation_transitions_array.h"
 #include "../../../include/core/observation_transitions/observation_transition_exception.h"
 
+#include "../../../include/utilities/parallel_for.h"
+
 #include <algorithm>
 
 ObservationTransitionsArray::ObservationTransitionsArray(unsigned int numStates,
@@ -60,6 +62,10 @@ ObservationTransitionsArray::~ObservationTransitionsArray()
 void ObservationTransitionsArray::set(Action *previousAction, State *state,
 		Observation *observation, double probability)
 {
+	if (frozen) {
+		throw ObservationTransitionException();
+	}
+
 	IndexedAction *a = dynamic_cast<IndexedAction *>(previousAction);
 	IndexedState *s = dynamic_cast<IndexedState *>(state);
 	IndexedObservation *z = dynamic_cast<IndexedObservation *>(observation);
@@ -79,7 +85,7 @@ void ObservationTransitionsArray::set(Action *previousAction, State *state,
 }
 
 double ObservationTransitionsArray::get(Action *previousAction, State *state,
-		Observation *observation)
+		Observation *observation) const
 {
 	IndexedAction *a = dynamic_cast<IndexedAction *>(previousAction);
 	IndexedState *s = dynamic_cast<IndexedState *>(state);
@@ -100,6 +106,10 @@ double ObservationTransitionsArray::get(Action *previousAction, State *state,
 
 void ObservationTransitionsArray::add_available(Action *previousAction, State *state, Observation *availableObservation)
 {
+	if (frozen) {
+		throw ObservationTransitionException();
+	}
+
 	IndexedAction *a = dynamic_cast<IndexedAction *>(previousAction);
 	IndexedState *s = dynamic_cast<IndexedState *>(state);
 
@@ -127,13 +137,13 @@ const std::vector<Observation *> &ObservationTransitionsArray::available(Observa
 		throw ObservationTransitionException();
 	}
 
-	if (availableObservations[a->get_index() * states + sp->get_index()].size() == 0) {
+	if (!frozen && availableObservations[a->get_index() * states + sp->get_index()].size() == 0) {
 		ObservationsMap *Zmap = dynamic_cast<ObservationsMap *>(Z);
 		if (Zmap == nullptr) {
 			throw ObservationTransitionException();
 		}
 
-		compute_available(Zmap, a, sp);
+		compute_available(Zmap, a->get_index(), sp->get_index());
 	}
 
 	return availableObservations[a->get_index() * states + sp->get_index()];
@@ -141,6 +151,10 @@ const std::vector<Observation *> &ObservationTransitionsArray::available(Observa
 
 void ObservationTransitionsArray::set_observation_transitions(const float *O)
 {
+	if (frozen) {
+		throw ObservationTransitionException();
+	}
+
 	for (unsigned int a = 0; a < actions; a++) {
 		for (unsigned int sp = 0; sp < states; sp++) {
 			for (unsigned int z = 0; z < observations; z++) {
@@ -171,8 +185,32 @@ unsigned int ObservationTransitionsArray::get_num_observations() const
 	return observations;
 }
 
+void ObservationTransitionsArray::freeze(Observations *Z, Actions *, States *)
+{
+	ObservationsMap *Zmap = dynamic_cast<ObservationsMap *>(Z);
+	if (Zmap == nullptr) {
+		throw ObservationTransitionException();
+	}
+
+	// Each action-state pair owns its own list of available observations, so the rows may be computed in parallel.
+	parallel_for(actions * states, [&](unsigned int i) {
+		if (availableObservations[i].size() == 0) {
+			compute_available(Zmap, i / states, i % states);
+		}
+	});
+
+	frozen = true;
+}
+
+bool ObservationTransitionsArray::is_frozen() const
+{
+	return frozen;
+}
+
 void ObservationTransitionsArray::reset()
 {
+	frozen = false;
+
 	for (unsigned int a = 0; a < actions; a++) {
 		for (unsigned int sp = 0; sp < states; sp++) {
 			for (unsigned int z = 0; z < observations; z++) {
@@ -186,13 +224,13 @@ void ObservationTransitionsArray::reset()
 	}
 }
 
-void ObservationTransitionsArray::compute_available(ObservationsMap *Z, IndexedAction *a, IndexedState *sp)
+void ObservationTransitionsArray::compute_available(ObservationsMap *Z, unsigned int a, unsigned int sp)
 {
-	availableObservations[a->get_index() * states + sp->get_index()].clear();
+	availableObservations[a * states + sp].clear();
 
 	for (unsigned int z = 0; z < observations; z++) {
-		if (observationTransitions[a->get_index() * states * observations + sp->get_index() * observations + z] > 0.0f) {
-			availableObservations[a->get_index() * states + sp->get_index()].push_back(Z->get(z));
+		if (observationTransitions[a * states * observations + sp * observations + z] > 0.0f) {
+			availableObservations[a * states + sp].push_back(Z->get(z));
 		}
 	}
 }
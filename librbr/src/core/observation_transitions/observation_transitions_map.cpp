@@ -29,6 +29,11 @@
 #include "../../../include/core/actions/named_action.h"
 #include "../../../include/core/observations/named_observation.h"
 
+#include "../../../include/core/states/states_map.h"
+#include "../../../include/core/actions/actions_map.h"
+
+#include "../../../include/utilities/parallel_for.h"
+
 #include <algorithm>
 
 ObservationTransitionsMap::ObservationTransitionsMap()
@@ -36,6 +41,8 @@ ObservationTransitionsMap::ObservationTransitionsMap()
 	stateWildcard = new NamedState("*");
 	actionWildcard = new NamedAction("*");
 	observationWildcard = new NamedObservation("*");
+
+	frozen = false;
 }
 
 ObservationTransitionsMap::~ObservationTransitionsMap()
@@ -50,6 +57,10 @@ ObservationTransitionsMap::~ObservationTransitionsMap()
 void ObservationTransitionsMap::set(Action *previousAction, State *state,
 		Observation *observation, double probability)
 {
+	if (frozen) {
+		throw ObservationTransitionException();
+	}
+
 	if (previousAction == nullptr) {
 		previousAction = actionWildcard;
 	}
@@ -64,7 +75,7 @@ void ObservationTransitionsMap::set(Action *previousAction, State *state,
 }
 
 double ObservationTransitionsMap::get(Action *previousAction, State *state,
-		Observation *observation)
+		Observation *observation) const
 {
 	// Iterate over all possible configurations of wildcards in the get statement.
 	// For each, use the get_value() function to check if the value exists. If it
@@ -96,6 +107,10 @@ double ObservationTransitionsMap::get(Action *previousAction, State *state,
 
 void ObservationTransitionsMap::add_available(Action *previousAction, State *state, Observation *availableObservation)
 {
+	if (frozen) {
+		throw ObservationTransitionException();
+	}
+
 	availableObservations[previousAction][state].push_back(availableObservation);
 }
 
@@ -114,7 +129,7 @@ const std::vector<Observation *> &ObservationTransitionsMap::available(Observati
 		throw ObservationTransitionException();
 	}
 
-	if (beta->second.size() == 0) {
+	if (!frozen && beta->second.size() == 0) {
 		ObservationsMap *Zmap = dynamic_cast<ObservationsMap *>(Z);
 		if (Zmap == nullptr) {
 			throw ObservationTransitionException();
@@ -126,14 +141,52 @@ const std::vector<Observation *> &ObservationTransitionsMap::available(Observati
 	return beta->second;
 }
 
+void ObservationTransitionsMap::freeze(Observations *Z, Actions *A, States *S)
+{
+	ObservationsMap *Zmap = dynamic_cast<ObservationsMap *>(Z);
+	ActionsMap *Amap = dynamic_cast<ActionsMap *>(A);
+	StatesMap *Smap = dynamic_cast<StatesMap *>(S);
+	if (Zmap == nullptr || Amap == nullptr || Smap == nullptr) {
+		throw ObservationTransitionException();
+	}
+
+	// Create every missing row first, so that the maps do not change while the rows are filled in parallel.
+	std::vector<Action *> rowActions;
+	std::vector<State *> rowStates;
+	std::vector<std::vector<Observation *> *> rows;
+
+	for (auto action : *Amap) {
+		for (auto state : *Smap) {
+			std::vector<Observation *> &avail = availableObservations[resolve(action)][resolve(state)];
+			if (avail.size() == 0) {
+				rowActions.push_back(resolve(action));
+				rowStates.push_back(resolve(state));
+				rows.push_back(&avail);
+			}
+		}
+	}
+
+	parallel_for(rows.size(), [&](unsigned int i) {
+		compute_available(Zmap, rowActions[i], rowStates[i], *rows[i]);
+	});
+
+	frozen = true;
+}
+
+bool ObservationTransitionsMap::is_frozen() const
+{
+	return frozen;
+}
+
 void ObservationTransitionsMap::reset()
 {
 	observationTransitions.clear();
 	availableObservations.clear();
+	frozen = false;
 }
 
 double ObservationTransitionsMap::get_value(Action *previousAction, State *state,
-		Observation *observation)
+		Observation *observation) const
 {
 	std::unordered_map<Action *,
 		std::unordered_map<State *,
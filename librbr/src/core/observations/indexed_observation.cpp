@@ -24,15 +24,23 @@
 
 #include "../../../include/core/observations/indexed_observation.h"
 
-unsigned int IndexedObservation::indexer = 0;
+Indexer IndexedObservation::indexer;
 
 IndexedObservation::IndexedObservation()
 {
-	// Assign the index of the observation equal to the current value of
-	// indexer. Then, increment the indexer variable in preparation
-	// for the next one.
-	index = indexer;
-	indexer++;
+	// Assign the index of the observation from the static indexer, which also increments it
+	// in preparation for the next one.
+	index = indexer.next();
+}
+
+IndexedObservation::IndexedObservation(Indexer &modelIndexer)
+{
+	index = modelIndexer.next();
+}
+
+IndexedObservation::IndexedObservation(unsigned int initialIndex)
+{
+	index = initialIndex;
 }
 
 IndexedObservation::IndexedObservation(const IndexedObservation &other)
@@ -67,10 +75,10 @@ unsigned int IndexedObservation::hash_value() const
 
 unsigned int IndexedObservation::get_num_observations()
 {
-	return indexer;
+	return indexer.get_num_indexes();
 }
 
 void IndexedObservation::reset_indexer()
 {
-	indexer = 0;
+	indexer.reset();
 }
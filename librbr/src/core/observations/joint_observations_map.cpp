@@ -27,6 +27,7 @@
 #include "../../../include/core/observations/observation_exception.h"
 
 #include <algorithm>
+#include <limits>
 
 JointObservationsMap::JointObservationsMap(unsigned int numFactors)
 {
@@ -34,6 +35,8 @@ JointObservationsMap::JointObservationsMap(unsigned int numFactors)
 		numFactors = 1;
 	}
 	factoredObservations.resize(numFactors);
+
+	numJointObservations = 0;
 }
 
 JointObservationsMap::~JointObservationsMap()
@@ -100,10 +103,171 @@ void JointObservationsMap::update()
 		}
 	}
 
-	observations.clear();
+	clear_created();
+
+	factorIndexes.clear();
+	factorIndexes.resize(factoredObservations.size());
+	factorNames.clear();
+	factorNames.resize(factoredObservations.size());
+
+	numJointObservations = 1;
+
+	for (unsigned int i = 0; i < factoredObservations.size(); i++) {
+		if (numJointObservations > std::numeric_limits<unsigned int>::max() / factoredObservations[i].size()) {
+			numJointObservations = 0;
+			throw ObservationException();
+		}
+		numJointObservations *= factoredObservations[i].size();
+
+		// The first observation with a particular name is kept, as in ObservationsMap.
+		for (unsigned int j = 0; j < factoredObservations[i].size(); j++) {
+			factorIndexes[i][factoredObservations[i][j]] = j;
+
+			std::string name;
+			if (get_name(factoredObservations[i][j], name)) {
+				factorNames[i].insert(std::make_pair(name, j));
+			}
+		}
+	}
+
+	created.resize(numJointObservations);
+}
+
+bool JointObservationsMap::exists(Observation *observation)
+{
+	try {
+		get_index(observation);
+	} catch (const ObservationException &err) {
+		return false;
+	}
+	return true;
+}
+
+Observation *JointObservationsMap::get(unsigned int hash)
+{
+	if (numJointObservations == 0) {
+		throw ObservationException();
+	}
+
+	// Continue a hash, as JointObservation computes it, over the parts in the factors from first to last
+	// (exclusive) given by a mixed-radix index over only those factors.
+	auto hash_parts = [this](unsigned int first, unsigned int last, unsigned int index, unsigned int h) {
+		std::vector<unsigned int> digits(last - first, 0);
+		for (unsigned int i = last; i > first; i--) {
+			digits[i - 1 - first] = index % factoredObservations[i - 1].size();
+			index /= factoredObservations[i - 1].size();
+		}
+		for (unsigned int i = first; i < last; i++) {
+			h = 31 * h + factoredObservations[i][digits[i - first]]->hash_value();
+		}
+		return h;
+	};
+
+	// The hash is prefix * 31^k + suffix (modulo 2^32) for the k factors in the suffix, so grow the suffix
+	// to about the square root of the number of joint observations, and tabulate the hash of each suffix.
+	unsigned int split = factoredObservations.size() - 1;
+	unsigned long long numSuffixes = factoredObservations[split].size();
+	while (split > 0 && numSuffixes * factoredObservations[split - 1].size() *
+			numSuffixes * factoredObservations[split - 1].size() <= numJointObservations) {
+		split--;
+		numSuffixes *= factoredObservations[split].size();
+	}
+
+	unsigned int multiplier = 1;
+	for (unsigned int i = split; i < factoredObservations.size(); i++) {
+		multiplier *= 31;
+	}
+
+	// The first suffix with a particular hash is kept, so the lowest index is found.
+	std::unordered_map<unsigned int, unsigned int> suffixes;
+	for (unsigned int j = 0; j < numSuffixes; j++) {
+		suffixes.insert(std::make_pair(hash_parts(split, factoredObservations.size(), j, 0), j));
+	}
+
+	unsigned int numPrefixes = numJointObservations / numSuffixes;
+	for (unsigned int i = 0; i < numPrefixes; i++) {
+		std::unordered_map<unsigned int, unsigned int>::const_iterator result =
+				suffixes.find(hash - hash_parts(0, split, i, 7) * multiplier);
+		if (result != suffixes.end()) {
+			return get_observation(i * numSuffixes + result->second);
+		}
+	}
+
+	throw ObservationException();
+}
+
+Observation *JointObservationsMap::get_by_name(const std::string &name) const
+{
+	unsigned int index = 0;
+	std::size_t start = 0;
+
+	for (unsigned int i = 0; i < factorNames.size(); i++) {
+		std::size_t stop = name.find(' ', start);
+		if ((stop == std::string::npos) != (i == factorNames.size() - 1)) {
+			throw ObservationException();
+		}
+
+		std::unordered_map<std::string, unsigned int>::const_iterator result =
+				factorNames[i].find(name.substr(start, stop - start));
+		if (result == factorNames[i].end()) {
+			throw ObservationException();
+		}
+
+		index = index * factoredObservations[i].size() + result->second;
+		start = stop + 1;
+	}
+
+	return get_observation(index);
+}
+
+unsigned int JointObservationsMap::get_index(const Observation *observation) const
+{
+	const JointObservation *j = dynamic_cast<const JointObservation *>(observation);
+	if (j == nullptr || numJointObservations == 0 || j->get_num_observations() != (int)factorIndexes.size()) {
+		throw ObservationException();
+	}
+
+	unsigned int index = 0;
+
+	for (unsigned int i = 0; i < factorIndexes.size(); i++) {
+		std::unordered_map<const Observation *, unsigned int>::const_iterator result =
+				factorIndexes[i].find(const_cast<JointObservation *>(j)->get(i));
+		if (result == factorIndexes[i].end()) {
+			throw ObservationException();
+		}
+
+		index = index * factoredObservations[i].size() + result->second;
+	}
+
+	return index;
+}
+
+Observation *JointObservationsMap::get_observation(unsigned int index) const
+{
+	if (index >= numJointObservations) {
+		throw ObservationException();
+	}
+
+	JointObservation *jointObservation = created.get(index);
+	if (jointObservation != nullptr) {
+		return jointObservation;
+	}
+
+	// Decode the mixed-radix index, starting from the last (least significant) factor.
+	std::vector<Observation *> parts(factoredObservations.size(), nullptr);
+	unsigned int remainder = index;
+	for (int i = (int)factoredObservations.size() - 1; i >= 0; i--) {
+		parts[i] = factoredObservations[i][remainder % factoredObservations[i].size()];
+		remainder /= factoredObservations[i].size();
+	}
 
-	std::vector<Observation *> create;
-	update_step(create, 0);
+	// If another thread creates the joint observation first, its joint observation is returned instead.
+	return created.insert(index, new JointObservation(parts));
+}
+
+unsigned int JointObservationsMap::get_num_observations() const
+{
+	return numJointObservations;
 }
 
 unsigned int JointObservationsMap::get_num_factors()
@@ -111,6 +275,15 @@ unsigned int JointObservationsMap::get_num_factors()
 	return factoredObservations.size();
 }
 
+const std::vector<Observation *> &JointObservationsMap::get_factor(unsigned int factorIndex)
+{
+	if (factorIndex >= factoredObservations.size()) {
+		throw ObservationException();
+	}
+
+	return factoredObservations[factorIndex];
+}
+
 void JointObservationsMap::reset()
 {
 	for (std::vector<Observation *> &factor : factoredObservations) {
@@ -120,26 +293,15 @@ void JointObservationsMap::reset()
 		factor.clear();
 	}
 
-	observations.clear();
+	clear_created();
+	factorIndexes.clear();
+	factorNames.clear();
+	numJointObservations = 0;
+
+	ObservationsMap::reset();
 }
 
-void JointObservationsMap::update_step(std::vector<Observation *> currentJointObservation, unsigned int currentFactorIndex)
+void JointObservationsMap::clear_created()
 {
-	// At the final factor index, we need to create a bunch of joint observations.
-	for (Observation *observation : factoredObservations[currentFactorIndex]) {
-		// Begin by pushing a current factor's observation on the vector (tuple).
-		currentJointObservation.push_back(observation);
-
-		// If this is the final index, then create a joint observation object and append it to the list of observations.
-		// Otherwise, recurse to the next index, using the new currentJointObservation object.
-		if (currentFactorIndex == factoredObservations.size() - 1) {
-			JointObservation *newObservation = new JointObservation(currentJointObservation);
-			observations[newObservation->hash_value()] = newObservation;
-		} else {
-			update_step(currentJointObservation, currentFactorIndex + 1);
-		}
-
-		// Pop off the observation that was just appended, to prepare for the next loop.
-		currentJointObservation.pop_back();
-	}
+	created.clear();
 }
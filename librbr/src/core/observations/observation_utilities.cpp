@@ -23,48 +23,8 @@
 
 
 #include "../../../include/core/observations/observation_utilities.h"
-#include "../../../include/core/observations/observation_exception.h"
-
-#include "../../../include/core/observations/named_observation.h"
-#include "../../../include/core/observations/joint_observation.h"
 
 Observation *find_observation(ObservationsMap *Z, std::string observationName)
 {
-	for (auto z : *Z) {
-		Observation *observation = resolve(z);
-
-		// Try to cast the observation as a NamedObservation. If it fails, it may still be a joint observation.
-	    NamedObservation *o = dynamic_cast<NamedObservation *>(observation);
-	    if (o == nullptr) {
-	    	// Try to cast it as a JointObservation.
-	    	JointObservation *jo = dynamic_cast<JointObservation *>(observation);
-		    if (jo == nullptr) {
-		    	throw ObservationException();
-		    }
-
-		    // Construct the joint observation name from the component names, separated by spaces.
-		    std::string joName = "";
-	    	for (int i = 0; i < jo->get_num_observations(); i++) {
-	    		o = dynamic_cast<NamedObservation *>(jo->get(i));
-	    		if (o == nullptr) {
-	    			throw ObservationException();
-	    		}
-
-	    		joName += o->get_name();
-	    		if (i < jo->get_num_observations() - 1) {
-	    			joName += " ";
-	    		}
-	    	}
-
-    		if (joName.compare(observationName) == 0) {
-	    		return jo;
-    		}
-	    } else {
-			if (o->get_name().compare(observationName) == 0) {
-				return observation;
-			}
-	    }
-	}
-
-	throw ObservationException();
+	return Z->get_by_name(observationName);
 }
@@ -25,6 +25,9 @@
 #include "../../../include/core/observations/observations_map.h"
 #include "../../../include/core/observations/observation_exception.h"
 
+#include "../../../include/core/observations/named_observation.h"
+#include "../../../include/core/observations/joint_observation.h"
+
 #include <algorithm>
 
 ObservationsMap::ObservationsMap()
@@ -42,7 +45,17 @@ ObservationsMap::~ObservationsMap()
 
 void ObservationsMap::add(Observation *newObservation)
 {
-	observations[newObservation->hash_value()] = newObservation;
+	// An observation with the same hash value is replaced, in place, in the list of all observations.
+	std::unordered_map<unsigned int, Observation *>::iterator result = observations.find(newObservation->hash_value());
+	if (result != observations.end()) {
+		std::replace(allObservations.begin(), allObservations.end(), result->second, newObservation);
+		remove_name(result->second);
+		result->second = newObservation;
+	} else {
+		observations[newObservation->hash_value()] = newObservation;
+		allObservations.push_back(newObservation);
+	}
+	add_name(newObservation);
 }
 
 void ObservationsMap::remove(Observation *removeObservation)
@@ -54,6 +67,9 @@ void ObservationsMap::remove(Observation *removeObservation)
 	}
 
 	observations.erase(removeObservation->hash_value());
+	remove_name(removeObservation);
+	allObservations.erase(std::remove(allObservations.begin(), allObservations.end(), removeObservation),
+			allObservations.end());
 	delete removeObservation;
 }
 
@@ -61,7 +77,7 @@ void ObservationsMap::set(const std::vector<Observation *> &newObservations)
 {
 	reset();
 	for (Observation *observation : newObservations) {
-		observations[observation->hash_value()] = observation;
+		add(observation);
 	}
 }
 
@@ -89,22 +105,120 @@ unsigned int ObservationsMap::get_num_observations() const
 	return observations.size();
 }
 
+Observation *ObservationsMap::get_observation(unsigned int index) const
+{
+	if (index >= allObservations.size()) {
+		throw ObservationException();
+	}
+	return allObservations[index];
+}
+
 void ObservationsMap::reset()
 {
 	for (auto observation : observations) {
 		delete resolve(observation);
 	}
 	observations.clear();
+	allObservations.clear();
+	names.clear();
+}
+
+ObservationsMapIterator ObservationsMap::begin() const
+{
+	return ObservationsMapIterator(this, 0);
+}
+
+ObservationsMapIterator ObservationsMap::end() const
+{
+	return ObservationsMapIterator(this, get_num_observations());
+}
+
+Observation *ObservationsMap::get_by_name(const std::string &name) const
+{
+	std::unordered_map<std::string, Observation *>::const_iterator result = names.find(name);
+	if (result == names.end()) {
+		throw ObservationException();
+	}
+	return result->second;
+}
+
+void ObservationsMap::add_name(Observation *observation)
+{
+	// The first observation with a particular name is kept, matching the order of a linear search.
+	std::string name;
+	if (get_name(observation, name)) {
+		names.insert(std::make_pair(name, observation));
+	}
+}
+
+void ObservationsMap::remove_name(Observation *observation)
+{
+	std::string name;
+	if (!get_name(observation, name)) {
+		return;
+	}
+
+	std::unordered_map<std::string, Observation *>::iterator result = names.find(name);
+	if (result != names.end() && result->second == observation) {
+		names.erase(result);
+	}
+}
+
+bool ObservationsMap::get_name(Observation *observation, std::string &name)
+{
+	NamedObservation *n = dynamic_cast<NamedObservation *>(observation);
+	if (n != nullptr) {
+		name = n->get_name();
+		return true;
+	}
+
+	JointObservation *j = dynamic_cast<JointObservation *>(observation);
+	if (j == nullptr) {
+		return false;
+	}
+
+	// Construct the name from the component names, separated by spaces.
+	name = "";
+	for (int i = 0; i < j->get_num_observations(); i++) {
+		n = dynamic_cast<NamedObservation *>(j->get(i));
+		if (n == nullptr) {
+			return false;
+		}
+
+		name += n->get_name();
+		if (i < j->get_num_observations() - 1) {
+			name += " ";
+		}
+	}
+
+	return true;
 }
 
-std::unordered_map<unsigned int, Observation *>::iterator ObservationsMap::begin()
+ObservationsMapIterator::ObservationsMapIterator(const ObservationsMap *observationsMap, unsigned int index)
 {
-	return observations.begin();
+	this->observationsMap = observationsMap;
+	this->index = index;
 }
 
-std::unordered_map<unsigned int, Observation *>::iterator ObservationsMap::end()
+Observation *ObservationsMapIterator::operator*() const
 {
-	return observations.end();
+	return observationsMap->get_observation(index);
+}
+
+ObservationsMapIterator &ObservationsMapIterator::operator++()
+{
+	index++;
+	return *this;
+}
+
+bool ObservationsMapIterator::operator==(const ObservationsMapIterator &other) const
+{
+	return observationsMap == other.observationsMap && index == other.index;
+}
+
+bool ObservationsMapIterator::operator!=(const ObservationsMapIterator &other) const
+{
+	return !(*this == other);
 }
 
 Observation *resolve(std::unordered_map<unsigned int, Observation *>::value_type &observationIterator)
@@ -116,3 +230,13 @@ unsigned int hash_value(std::unordered_map<unsigned int, Observation *>::value_t
 {
 	return observationIterator.first;
 }
+
+Observation *resolve(Observation *observationIterator)
+{
+	return observationIterator;
+}
+
+unsigned int hash_value(Observation *observationIterator)
+{
+	return observationIterator->hash_value();
+}
@@ -51,7 +51,7 @@ void PolicyAlphaVector::set(State *state, double value)
 	alphaVector[state] = value;
 }
 
-double PolicyAlphaVector::get(State *state)
+double PolicyAlphaVector::get(State *state) const
 {
 	std::map<State *, double>::const_iterator result = alphaVector.find(state);
 	if (result == alphaVector.end()) {
@@ -66,7 +66,7 @@ void PolicyAlphaVector::set_action(Action *action)
 	alphaVectorAction = action;
 }
 
-Action *PolicyAlphaVector::get_action()
+Action *PolicyAlphaVector::get_action() const
 {
 	return alphaVectorAction;
 }
@@ -76,12 +76,13 @@ int PolicyAlphaVector::get_dimension() const
 	return alphaVector.size();
 }
 
-double PolicyAlphaVector::compute_value(BeliefState *belief)
+double PolicyAlphaVector::compute_value(BeliefState *belief) const
 {
-	// Perform the dot product: dot(beta, alpha), but do so with map objects.
+	// Perform the dot product: dot(beta, alpha), but do so with map objects. Unset values are
+	// looked up without inserting them, so that many threads may evaluate the same alpha vector.
 	double value = 0.0;
 	for (State *s : belief->get_states()) {
-		value += alphaVector[s] * belief->get(s);
+		value += get(s) * belief->get(s);
 	}
 //	for (std::map<State *, double>::value_type alpha : alphaVector) {
 //		value += alpha.second * belief->get(alpha.first);
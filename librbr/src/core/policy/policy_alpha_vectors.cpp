@@ -24,9 +24,14 @@
 
 #include <iostream>
 #include <fstream>
+#include <algorithm>
+#include <unordered_map>
 
 #include "../../../include/core/policy/policy_alpha_vectors.h"
 #include "../../../include/core/policy/policy_alpha_vector.h"
+#include "../../../include/core/policy/policy_binary.h"
+
+#include "../../../include/core/core_exception.h"
 
 #include "../../../include/core/actions/action_exception.h"
 #include "../../../include/core/states/state_exception.h"
@@ -360,6 +365,168 @@ bool PolicyAlphaVectors::save(std::string filename, StatesMap *states)
 	return false;
 }
 
+bool PolicyAlphaVectors::load_binary(std::string filename, StatesMap *states, ActionsMap *actions,
+		Horizon *horizon, uint64_t fingerprint)
+{
+	reset();
+
+	char error[1024];
+
+	std::vector<State *> S = order_policy_states(states);
+	std::vector<Action *> A = order_policy_actions(actions);
+	unsigned int n = S.size();
+
+	MappedFile *file = nullptr;
+	try {
+		file = new MappedFile(filename);
+	} catch (const CoreException &err) {
+		sprintf(error, "Failed to open file '%s'.", filename.c_str());
+		log_message("PolicyAlphaVectors::load_binary", error);
+		return true;
+	}
+
+	const PolicyBinaryHeader *header = read_policy_header(*file, PolicyBinaryAlphaVectors, fingerprint,
+			hash_policy_tables(S, A, std::vector<Observation *>()), n, A.size(), 0,
+			"PolicyAlphaVectors::load_binary");
+
+	unsigned int numHorizons = std::max(1u, horizon->get_horizon());
+	const uint64_t *counts = nullptr;
+
+	// The body is the number of alpha vectors at each horizon, followed by every alpha vector as an
+	// action index and n values.
+	if (header != nullptr) {
+		counts = (const uint64_t *)(file->get_data() + sizeof(PolicyBinaryHeader));
+
+		uint64_t size = (uint64_t)numHorizons * sizeof(uint64_t);
+		for (unsigned int h = 0; header->numHorizons == numHorizons && h < numHorizons && size <= header->size; h++) {
+			size += counts[h] * (sizeof(uint64_t) + (uint64_t)n * sizeof(double));
+		}
+
+		if (header->numHorizons != numHorizons || size != header->size) {
+			log_message("PolicyAlphaVectors::load_binary", "The binary policy has an invalid horizon or size.");
+			header = nullptr;
+		}
+	}
+	if (header == nullptr) {
+		delete file;
+		return true;
+	}
+
+	// Inserting the states in order of their address keeps each insertion at the end of the alpha vector's map.
+	std::vector<unsigned int> byAddress(n);
+	for (unsigned int i = 0; i < n; i++) {
+		byAddress[i] = i;
+	}
+	std::sort(byAddress.begin(), byAddress.end(), [&S](unsigned int a, unsigned int b) {
+		return std::less<State *>()(S[a], S[b]);
+	});
+
+	const char *data = (const char *)(counts + numHorizons);
+
+	alphaVectors.resize(numHorizons);
+	for (unsigned int h = 0; h < numHorizons; h++) {
+		alphaVectors[h].reserve(counts[h]);
+
+		for (uint64_t j = 0; j < counts[h]; j++) {
+			uint64_t a = *(const uint64_t *)data;
+			const double *values = (const double *)(data + sizeof(uint64_t));
+			data += sizeof(uint64_t) + (uint64_t)n * sizeof(double);
+
+			if (a >= A.size()) {
+				sprintf(error, "Invalid action index %llu in file '%s'.", (unsigned long long)a, filename.c_str());
+				log_message("PolicyAlphaVectors::load_binary", error);
+				reset();
+				delete file;
+				return true;
+			}
+
+			PolicyAlphaVector *alpha = new PolicyAlphaVector(A[a]);
+			for (unsigned int i : byAddress) {
+				alpha->set(S[i], values[i]);
+			}
+			alphaVectors[h].push_back(alpha);
+		}
+	}
+
+	delete file;
+
+	return false;
+}
+
+bool PolicyAlphaVectors::save_binary(std::string filename, StatesMap *states, ActionsMap *actions,
+		uint64_t fingerprint)
+{
+	char error[1024];
+
+	if (alphaVectors.size() == 0) {
+		sprintf(error, "Failed to save file '%s'. No policy was defined.", filename.c_str());
+		log_message("PolicyAlphaVectors::save_binary", error);
+		return true;
+	}
+
+	std::vector<State *> S = order_policy_states(states);
+	std::vector<Action *> A = order_policy_actions(actions);
+
+	std::unordered_map<Action *, uint64_t> actionIndexes;
+	for (unsigned int i = 0; i < A.size(); i++) {
+		actionIndexes[A[i]] = i;
+	}
+
+	std::vector<uint64_t> counts;
+	for (std::vector<PolicyAlphaVector *> &alphaVectorSet : alphaVectors) {
+		counts.push_back(alphaVectorSet.size());
+
+		for (PolicyAlphaVector *alpha : alphaVectorSet) {
+			if (actionIndexes.find(alpha->get_action()) == actionIndexes.end()) {
+				sprintf(error, "Failed to save file '%s'. Action '%s' is not in the actions provided.",
+						filename.c_str(), alpha->get_action()->to_string().c_str());
+				log_message("PolicyAlphaVectors::save_binary", error);
+				return true;
+			}
+		}
+	}
+
+	std::ofstream file(filename, std::ios::out | std::ios::binary);
+	if (!file.is_open()) {
+		sprintf(error, "Failed to open the file '%s' for saving.", filename.c_str());
+		log_message("PolicyAlphaVectors::save_binary", error);
+		return true;
+	}
+
+	PolicyBinaryHeader header;
+	header.type = PolicyBinaryAlphaVectors;
+	header.numHorizons = alphaVectors.size();
+	header.fingerprint = fingerprint;
+	header.tableHash = hash_policy_tables(S, A, std::vector<Observation *>());
+	header.numStates = S.size();
+	header.numActions = A.size();
+	header.numObservations = 0;
+	header.size = counts.size() * sizeof(uint64_t);
+	for (uint64_t count : counts) {
+		header.size += count * (sizeof(uint64_t) + S.size() * sizeof(double));
+	}
+
+	write_policy_header(file, header);
+	file.write((const char *)counts.data(), counts.size() * sizeof(uint64_t));
+
+	std::vector<double> values(S.size());
+	for (std::vector<PolicyAlphaVector *> &alphaVectorSet : alphaVectors) {
+		for (PolicyAlphaVector *alpha : alphaVectorSet) {
+			uint64_t a = actionIndexes[alpha->get_action()];
+			for (unsigned int i = 0; i < S.size(); i++) {
+				values[i] = alpha->get(S[i]);
+			}
+
+			file.write((const char *)&a, sizeof(uint64_t));
+			file.write((const char *)values.data(), values.size() * sizeof(double));
+		}
+	}
+
+	file.close();
+
+	return false;
+}
+
 void PolicyAlphaVectors::reset()
 {
 	for (unsigned int t = 0; t < alphaVectors.size(); t++) {
@@ -0,0 +1,169 @@
+/**
+ *  The MIT License (MIT)
+ *
+ *  Copyright (c) 2014 Kyle Hollins Wray, University of Massachusetts
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy of
+ *  this software and associated documentation files (the "Software"), to deal in
+ *  the Software without restriction, including without limitation the rights to
+ *  use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ *  the Software, and to permit persons to whom the Software is furnished to do so,
+ *  subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included in all
+ *  copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ *  FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ *  COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ *  IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ *  CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+
+#include <cstring>
+
+#include "../../../include/core/policy/policy_binary.h"
+
+#include "../../../include/core/states/indexed_state.h"
+#include "../../../include/core/actions/indexed_action.h"
+#include "../../../include/core/observations/indexed_observation.h"
+
+#include "../../../include/utilities/log.h"
+
+/**
+ * Order the objects of a finite set into an index table. If every object is indexed, with unique
+ * indexes below the number of objects, then each is placed at its index. Otherwise, the objects
+ * keep the order of iteration, which is the order they were added (or the mixed-radix index of
+ * joint objects).
+ * @param	objects		The finite set of objects.
+ * @param	n			The number of objects.
+ * @return	The objects in index order.
+ */
+template <typename Indexed, typename T, typename Map>
+std::vector<T *> order_policy_table(Map *objects, unsigned int n)
+{
+	std::vector<T *> result(n, nullptr);
+
+	bool indexed = true;
+	for (auto object : *objects) {
+		Indexed *o = dynamic_cast<Indexed *>(resolve(object));
+		if (o == nullptr || o->get_index() >= n || result[o->get_index()] != nullptr) {
+			indexed = false;
+			break;
+		}
+		result[o->get_index()] = o;
+	}
+
+	if (!indexed) {
+		result.clear();
+		for (auto object : *objects) {
+			result.push_back(resolve(object));
+		}
+	}
+
+	return result;
+}
+
+/**
+ * Add the name of each object to a 64-bit FNV-1a hash, separating names by a zero byte and each
+ * table by its size.
+ * @param	hash		The hash so far, which will be modified.
+ * @param	objects		The objects in index order.
+ */
+template <typename T>
+void hash_policy_table(uint64_t &hash, const std::vector<T *> &objects)
+{
+	uint64_t n = objects.size();
+	for (unsigned int i = 0; i < sizeof(uint64_t); i++) {
+		hash = (hash ^ ((n >> (8 * i)) & 0xFF)) * 1099511628211ULL;
+	}
+
+	for (T *object : objects) {
+		for (char c : object->to_string()) {
+			hash = (hash ^ (unsigned char)c) * 1099511628211ULL;
+		}
+		hash = hash * 1099511628211ULL;
+	}
+}
+
+std::vector<State *> order_policy_states(StatesMap *states)
+{
+	return order_policy_table<IndexedState, State>(states, states->get_num_states());
+}
+
+std::vector<Action *> order_policy_actions(ActionsMap *actions)
+{
+	return order_policy_table<IndexedAction, Action>(actions, actions->get_num_actions());
+}
+
+std::vector<Observation *> order_policy_observations(ObservationsMap *observations)
+{
+	return order_policy_table<IndexedObservation, Observation>(observations, observations->get_num_observations());
+}
+
+uint64_t hash_policy_tables(const std::vector<State *> &states, const std::vector<Action *> &actions,
+		const std::vector<Observation *> &observations)
+{
+	uint64_t hash = 14695981039346656037ULL;
+	hash_policy_table(hash, states);
+	hash_policy_table(hash, actions);
+	hash_policy_table(hash, observations);
+	return hash;
+}
+
+void write_policy_header(std::ofstream &file, PolicyBinaryHeader &header)
+{
+	std::memcpy(header.magic, "LIBRBRP\0", 8);
+	header.version = POLICY_BINARY_VERSION;
+	header.byteOrder = 0x01020304;
+	header.reserved = 0;
+
+	file.write((const char *)&header, sizeof(PolicyBinaryHeader));
+}
+
+const PolicyBinaryHeader *read_policy_header(MappedFile &file, PolicyBinaryType type, uint64_t fingerprint,
+		uint64_t tableHash, unsigned int numStates, unsigned int numActions, unsigned int numObservations,
+		std::string function)
+{
+	if (file.get_size() < sizeof(PolicyBinaryHeader)) {
+		log_message(function, "The file is too small to be a binary policy.");
+		return nullptr;
+	}
+
+	const PolicyBinaryHeader *header = (const PolicyBinaryHeader *)file.get_data();
+
+	if (std::memcmp(header->magic, "LIBRBRP\0", 8) != 0) {
+		log_message(function, "The file is not a binary policy.");
+		return nullptr;
+	}
+
+	if (header->version != POLICY_BINARY_VERSION || header->byteOrder != 0x01020304) {
+		log_message(function, "The binary policy was written with another version or byte order.");
+		return nullptr;
+	}
+
+	if (header->type != (uint32_t)type) {
+		log_message(function, "The binary policy is of a different type.");
+		return nullptr;
+	}
+
+	if (header->fingerprint != fingerprint) {
+		log_message(function, "The binary policy was computed for a different model.");
+		return nullptr;
+	}
+
+	if (header->tableHash != tableHash || header->numStates != numStates ||
+			header->numActions != numActions || header->numObservations != numObservations) {
+		log_message(function, "The binary policy does not match the model's states, actions, or observations.");
+		return nullptr;
+	}
+
+	if (header->size != file.get_size() - sizeof(PolicyBinaryHeader)) {
+		log_message(function, "The binary policy is truncated or has trailing data.");
+		return nullptr;
+	}
+
+	return header;
+}
@@ -24,8 +24,13 @@
 
 #include <iostream>
 #include <fstream>
+#include <algorithm>
+#include <unordered_map>
 
 #include "../../../include/core/policy/policy_map.h"
+#include "../../../include/core/policy/policy_binary.h"
+
+#include "../../../include/core/core_exception.h"
 
 #include "../../../include/core/actions/action_exception.h"
 #include "../../../include/core/states/state_exception.h"
@@ -230,6 +235,135 @@ bool PolicyMap::save(std::string filename)
 	return false;
 }
 
+bool PolicyMap::load_binary(std::string filename, StatesMap *states, ActionsMap *actions, Horizon *horizon,
+		uint64_t fingerprint)
+{
+	reset();
+
+	char error[1024];
+
+	std::vector<State *> S = order_policy_states(states);
+	std::vector<Action *> A = order_policy_actions(actions);
+	unsigned int n = S.size();
+
+	MappedFile *file = nullptr;
+	try {
+		file = new MappedFile(filename);
+	} catch (const CoreException &err) {
+		sprintf(error, "Failed to open file '%s'.", filename.c_str());
+		log_message("PolicyMap::load_binary", error);
+		return true;
+	}
+
+	const PolicyBinaryHeader *header = read_policy_header(*file, PolicyBinaryMap, fingerprint,
+			hash_policy_tables(S, A, std::vector<Observation *>()), n, A.size(), 0, "PolicyMap::load_binary");
+
+	unsigned int numHorizons = std::max(1u, horizon->get_horizon());
+	if (header != nullptr && (header->numHorizons != numHorizons ||
+			header->size != (((uint64_t)numHorizons * n * sizeof(uint32_t) + 7) & ~(uint64_t)7))) {
+		log_message("PolicyMap::load_binary", "The binary policy has an invalid horizon or size.");
+		header = nullptr;
+	}
+	if (header == nullptr) {
+		delete file;
+		return true;
+	}
+
+	// Inserting the states in order of their address allows each map to be built in linear time.
+	std::vector<unsigned int> byAddress(n);
+	for (unsigned int i = 0; i < n; i++) {
+		byAddress[i] = i;
+	}
+	std::sort(byAddress.begin(), byAddress.end(), [&S](unsigned int a, unsigned int b) {
+		return std::less<State *>()(S[a], S[b]);
+	});
+
+	const uint32_t *data = (const uint32_t *)(file->get_data() + sizeof(PolicyBinaryHeader));
+
+	policy.resize(numHorizons);
+	for (unsigned int h = 0; h < numHorizons; h++) {
+		for (unsigned int i : byAddress) {
+			uint32_t a = data[(uint64_t)h * n + i];
+			if (a == POLICY_BINARY_NONE) {
+				continue;
+			} else if (a >= A.size()) {
+				sprintf(error, "Invalid action index %u in file '%s'.", a, filename.c_str());
+				log_message("PolicyMap::load_binary", error);
+				reset();
+				delete file;
+				return true;
+			}
+			policy[h].emplace_hint(policy[h].end(), S[i], A[a]);
+		}
+	}
+
+	delete file;
+
+	return false;
+}
+
+bool PolicyMap::save_binary(std::string filename, StatesMap *states, ActionsMap *actions, uint64_t fingerprint)
+{
+	char error[1024];
+
+	if (policy.size() == 0) {
+		sprintf(error, "Failed to save file '%s'. No policy was defined.", filename.c_str());
+		log_message("PolicyMap::save_binary", error);
+		return true;
+	}
+
+	std::ofstream file(filename, std::ios::out | std::ios::binary);
+	if (!file.is_open()) {
+		sprintf(error, "Failed to open the file '%s' for saving.", filename.c_str());
+		log_message("PolicyMap::save_binary", error);
+		return true;
+	}
+
+	std::vector<State *> S = order_policy_states(states);
+	std::vector<Action *> A = order_policy_actions(actions);
+
+	std::unordered_map<Action *, uint32_t> actionIndexes;
+	for (unsigned int i = 0; i < A.size(); i++) {
+		actionIndexes[A[i]] = i;
+	}
+
+	// Each horizon is a row of action indexes, one for each state.
+	std::vector<uint32_t> data(policy.size() * S.size() + (policy.size() * S.size()) % 2, POLICY_BINARY_NONE);
+	for (unsigned int h = 0; h < policy.size(); h++) {
+		for (unsigned int i = 0; i < S.size(); i++) {
+			std::map<State *, Action *>::const_iterator result = policy[h].find(S[i]);
+			if (result == policy[h].end()) {
+				continue;
+			}
+
+			std::unordered_map<Action *, uint32_t>::const_iterator a = actionIndexes.find(result->second);
+			if (a == actionIndexes.end()) {
+				sprintf(error, "Failed to save file '%s'. Action '%s' is not in the actions provided.",
+						filename.c_str(), result->second->to_string().c_str());
+				log_message("PolicyMap::save_binary", error);
+				return true;
+			}
+			data[(uint64_t)h * S.size() + i] = a->second;
+		}
+	}
+
+	PolicyBinaryHeader header;
+	header.type = PolicyBinaryMap;
+	header.numHorizons = policy.size();
+	header.fingerprint = fingerprint;
+	header.tableHash = hash_policy_tables(S, A, std::vector<Observation *>());
+	header.numStates = S.size();
+	header.numActions = A.size();
+	header.numObservations = 0;
+	header.size = data.size() * sizeof(uint32_t);
+
+	write_policy_header(file, header);
+	file.write((const char *)data.data(), header.size);
+	file.close();
+
+	return false;
+}
+
 void PolicyMap::reset()
 {
 	policy.clear();
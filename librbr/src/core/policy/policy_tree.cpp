@@ -23,9 +23,13 @@
 
 
 #include <iostream>
+#include <algorithm>
 
 #include "../../../include/core/policy/policy_tree.h"
 #include "../../../include/core/policy/policy_exception.h"
+#include "../../../include/core/policy/policy_binary.h"
+
+#include "../../../include/core/core_exception.h"
 
 #include "../../../include/core/actions/action_exception.h"
 #include "../../../include/core/observations/observation_exception.h"
@@ -69,6 +73,12 @@ PolicyTree::PolicyTree(ObservationsMap *observations, Horizon *horizon)
 	current = root;
 }
 
+PolicyTree::PolicyTree(const std::vector<Observation *> &observations, unsigned int horizon)
+{
+	root = generate_tree(observations, horizon);
+	current = root;
+}
+
 PolicyTree::~PolicyTree()
 {
 	reset();
@@ -211,6 +221,122 @@ bool PolicyTree::save(std::string filename)
 	return false;
 }
 
+bool PolicyTree::load_binary(std::string filename, ActionsMap *actions, ObservationsMap *observations,
+		Horizon *horizon, uint64_t fingerprint)
+{
+	reset();
+
+	char error[1024];
+
+	std::vector<Action *> A = order_policy_actions(actions);
+	std::vector<Observation *> Z = order_policy_observations(observations);
+
+	MappedFile *file = nullptr;
+	try {
+		file = new MappedFile(filename);
+	} catch (const CoreException &err) {
+		sprintf(error, "Failed to open file '%s'.", filename.c_str());
+		log_message("PolicyTree::load_binary", error);
+		return true;
+	}
+
+	const PolicyBinaryHeader *header = read_policy_header(*file, PolicyBinaryTree, fingerprint,
+			hash_policy_tables(std::vector<State *>(), A, Z), 0, A.size(), Z.size(), "PolicyTree::load_binary");
+
+	unsigned int numHorizons = 0;
+	if (horizon->is_finite()) {
+		numHorizons = horizon->get_horizon();
+	}
+
+	if (header != nullptr && (header->numHorizons != numHorizons || header->size % sizeof(uint64_t) != 0)) {
+		log_message("PolicyTree::load_binary", "The binary policy has an invalid horizon or size.");
+		header = nullptr;
+	}
+	if (header == nullptr) {
+		delete file;
+		return true;
+	}
+
+	const uint32_t *data = (const uint32_t *)(file->get_data() + sizeof(PolicyBinaryHeader));
+	uint64_t size = header->size / sizeof(uint32_t);
+	uint64_t position = 0;
+
+	if (numHorizons > 0) {
+		root = load_binary_tree(data, size, position, numHorizons, A, Z);
+
+		// The records may only be followed by a single entry of padding.
+		if (root == nullptr || position + 1 < size) {
+			sprintf(error, "Invalid policy tree in file '%s'.", filename.c_str());
+			log_message("PolicyTree::load_binary", error);
+			reset();
+			delete file;
+			return true;
+		}
+	}
+	current = root;
+
+	delete file;
+
+	return false;
+}
+
+bool PolicyTree::save_binary(std::string filename, ActionsMap *actions, ObservationsMap *observations,
+		uint64_t fingerprint)
+{
+	char error[1024];
+
+	std::vector<Action *> A = order_policy_actions(actions);
+	std::vector<Observation *> Z = order_policy_observations(observations);
+
+	std::unordered_map<Action *, uint32_t> actionIndexes;
+	for (unsigned int i = 0; i < A.size(); i++) {
+		actionIndexes[A[i]] = i;
+	}
+
+	std::unordered_map<Observation *, uint32_t> observationIndexes;
+	for (unsigned int i = 0; i < Z.size(); i++) {
+		observationIndexes[Z[i]] = i;
+	}
+
+	std::vector<uint32_t> data;
+	unsigned int depth = 0;
+	if (root != nullptr) {
+		depth = save_binary_tree(data, root, actionIndexes, observationIndexes);
+		if (depth == 0) {
+			sprintf(error, "Failed to save file '%s'. The tree has actions or observations which were not provided.",
+					filename.c_str());
+			log_message("PolicyTree::save_binary", error);
+			return true;
+		}
+	}
+	if (data.size() % 2 != 0) {
+		data.push_back(POLICY_BINARY_NONE);
+	}
+
+	std::ofstream file(filename, std::ios::out | std::ios::binary);
+	if (!file.is_open()) {
+		sprintf(error, "Failed to open the file '%s' for saving.", filename.c_str());
+		log_message("PolicyTree::save_binary", error);
+		return true;
+	}
+
+	PolicyBinaryHeader header;
+	header.type = PolicyBinaryTree;
+	header.numHorizons = depth;
+	header.fingerprint = fingerprint;
+	header.tableHash = hash_policy_tables(std::vector<State *>(), A, Z);
+	header.numStates = 0;
+	header.numActions = A.size();
+	header.numObservations = Z.size();
+	header.size = data.size() * sizeof(uint32_t);
+
+	write_policy_header(file, header);
+	file.write((const char *)data.data(), header.size);
+	file.close();
+
+	return false;
+}
+
 Action *PolicyTree::next(Observation *observation)
 {
 	Action *action = current->action;
@@ -218,6 +344,11 @@ Action *PolicyTree::next(Observation *observation)
 	return action;
 }
 
+PolicyTreeNode *PolicyTree::get_root()
+{
+	return root;
+}
+
 void PolicyTree::reset()
 {
 	for (PolicyTreeNode *node : nodes) {
@@ -247,6 +378,25 @@ PolicyTreeNode *PolicyTree::generate_tree(ObservationsMap *observations, unsigne
 	return node;
 }
 
+PolicyTreeNode *PolicyTree::generate_tree(const std::vector<Observation *> &observations, unsigned int horizon)
+{
+	// Create the new node regardless.
+	PolicyTreeNode *node = new PolicyTreeNode();
+	nodes.push_back(node);
+
+	// Return immediately if this is a leaf node.
+	if (horizon == 1) {
+		return node;
+	}
+
+	// Otherwise, just generate the subtree normally and return.
+	for (Observation *z : observations) {
+		node->next[z] = generate_tree(observations, horizon - 1);
+	}
+
+	return node;
+}
+
 PolicyTreeNode *PolicyTree::traverse(const std::vector<Observation *> &history)
 {
 	// Traverse the policy tree, following the history path, until the node is reached.
@@ -265,6 +415,88 @@ PolicyTreeNode *PolicyTree::traverse(const std::vector<Observation *> &history)
 	return node;
 }
 
+PolicyTreeNode *PolicyTree::load_binary_tree(const uint32_t *data, uint64_t size, uint64_t &position,
+		unsigned int depth, const std::vector<Action *> &actions, const std::vector<Observation *> &observations)
+{
+	// Each record is the action index, the number of children, and the observation index of each child.
+	if (depth == 0 || position + 2 > size) {
+		return nullptr;
+	}
+
+	uint32_t a = data[position];
+	uint32_t numChildren = data[position + 1];
+	if ((a != POLICY_BINARY_NONE && a >= actions.size()) || numChildren > observations.size() ||
+			position + 2 + numChildren > size || (depth == 1 && numChildren > 0)) {
+		return nullptr;
+	}
+
+	PolicyTreeNode *node = new PolicyTreeNode();
+	nodes.push_back(node);
+	if (a != POLICY_BINARY_NONE) {
+		node->action = actions[a];
+	}
+
+	const uint32_t *children = data + position + 2;
+	position += 2 + numChildren;
+
+	// The children's subtrees follow in the order of their observations.
+	for (uint32_t i = 0; i < numChildren; i++) {
+		if (children[i] >= observations.size()) {
+			return nullptr;
+		}
+
+		PolicyTreeNode *child = load_binary_tree(data, size, position, depth - 1, actions, observations);
+		if (child == nullptr) {
+			return nullptr;
+		}
+		node->next[observations[children[i]]] = child;
+	}
+
+	return node;
+}
+
+unsigned int PolicyTree::save_binary_tree(std::vector<uint32_t> &data, PolicyTreeNode *node,
+		std::unordered_map<Action *, uint32_t> &actionIndexes,
+		std::unordered_map<Observation *, uint32_t> &observationIndexes)
+{
+	uint32_t a = POLICY_BINARY_NONE;
+	if (node->action != nullptr) {
+		std::unordered_map<Action *, uint32_t>::const_iterator result = actionIndexes.find(node->action);
+		if (result == actionIndexes.end()) {
+			return 0;
+		}
+		a = result->second;
+	}
+
+	data.push_back(a);
+	data.push_back(node->next.size());
+
+	std::vector<std::pair<uint32_t, PolicyTreeNode *> > children;
+	for (std::map<Observation *, PolicyTreeNode *>::value_type child : node->next) {
+		std::unordered_map<Observation *, uint32_t>::const_iterator result = observationIndexes.find(child.first);
+		if (result == observationIndexes.end()) {
+			return 0;
+		}
+		children.push_back(std::pair<uint32_t, PolicyTreeNode *>(result->second, child.second));
+	}
+	std::sort(children.begin(), children.end());
+
+	for (std::pair<uint32_t, PolicyTreeNode *> &child : children) {
+		data.push_back(child.first);
+	}
+
+	unsigned int depth = 0;
+	for (std::pair<uint32_t, PolicyTreeNode *> &child : children) {
+		unsigned int childDepth = save_binary_tree(data, child.second, actionIndexes, observationIndexes);
+		if (childDepth == 0) {
+			return 0;
+		}
+		depth = std::max(depth, childDepth);
+	}
+
+	return depth + 1;
+}
+
 void PolicyTree::save_tree(std::ofstream &file, PolicyTreeNode *node, std::vector<Observation *> history)
 {
 	if (node == nullptr) {
@@ -92,7 +92,7 @@ void FactoredWeightedRewards::set(State *state, Action *action, State *nextState
 	}
 }
 
-double FactoredWeightedRewards::get(State *state, Action *action)
+double FactoredWeightedRewards::get(State *state, Action *action) const
 {
 	double weightedAverage = 0.0;
 
@@ -108,7 +108,7 @@ double FactoredWeightedRewards::get(State *state, Action *action)
 	return weightedAverage;
 }
 
-double FactoredWeightedRewards::get(State *state, Action *action, State *nextState)
+double FactoredWeightedRewards::get(State *state, Action *action, State *nextState) const
 {
 	double weightedAverage = 0.0;
 
@@ -125,7 +125,7 @@ double FactoredWeightedRewards::get(State *state, Action *action, State *nextSta
 }
 
 double FactoredWeightedRewards::get(State *state, Action *action, State *nextState,
-		Observation *observation)
+		Observation *observation) const
 {
 	double weightedAverage = 0.0;
 
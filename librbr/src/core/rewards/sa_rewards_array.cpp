@@ -47,9 +47,31 @@ SARewardsArray::SARewardsArray(unsigned int numStates, unsigned int numActions)
 	reset();
 }
 
+SARewardsArray::SARewardsArray(unsigned int numStates, unsigned int numActions, float *R, double minReward,
+		double maxReward, std::shared_ptr<void> backing)
+{
+	states = numStates;
+	if (states == 0) {
+		states = 1;
+	}
+
+	actions = numActions;
+	if (actions == 0) {
+		actions = 1;
+	}
+
+	rewards = R;
+	this->backing = backing;
+
+	Rmin = minReward;
+	Rmax = maxReward;
+}
+
 SARewardsArray::~SARewardsArray()
 {
-	delete [] rewards;
+	if (backing == nullptr) {
+		delete [] rewards;
+	}
 }
 
 void SARewardsArray::set(State *state, Action *action, double reward)
@@ -86,7 +108,7 @@ void SARewardsArray::set(State *state, Action *action, State *nextState,
 	set(state, action, reward);
 }
 
-double SARewardsArray::get(State *state, Action *action)
+double SARewardsArray::get(State *state, Action *action) const
 {
 	IndexedState *s = dynamic_cast<IndexedState *>(state);
 	IndexedAction *a = dynamic_cast<IndexedAction *>(action);
@@ -102,13 +124,13 @@ double SARewardsArray::get(State *state, Action *action)
 	return rewards[s->get_index() * actions + a->get_index()];
 }
 
-double SARewardsArray::get(State *state, Action *action, State *nextState)
+double SARewardsArray::get(State *state, Action *action, State *nextState) const
 {
 	return get(state, action);
 }
 
 double SARewardsArray::get(State *state, Action *action, State *nextState,
-		Observation *observation)
+		Observation *observation) const
 {
 	return get(state, action);
 }
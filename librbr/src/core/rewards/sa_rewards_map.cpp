@@ -77,7 +77,7 @@ void SARewardsMap::set(State *state, Action *action, State *nextState,
 	set(state, action, reward);
 }
 
-double SARewardsMap::get(State *state, Action *action)
+double SARewardsMap::get(State *state, Action *action) const
 {
 	// Iterate over all possible configurations of wildcards in the get statement.
 	// For each, use the get_value() function to check if the value exists. If it
@@ -102,13 +102,13 @@ double SARewardsMap::get(State *state, Action *action)
 	return 0.0;
 }
 
-double SARewardsMap::get(State *state, Action *action, State *nextState)
+double SARewardsMap::get(State *state, Action *action, State *nextState) const
 {
 	return get(state, action);
 }
 
 double SARewardsMap::get(State *state, Action *action, State *nextState,
-		Observation *observation)
+		Observation *observation) const
 {
 	return get(state, action);
 }
@@ -120,7 +120,7 @@ void SARewardsMap::reset()
 	Rmax = std::numeric_limits<double>::lowest();
 }
 
-double SARewardsMap::get_value(State *state, Action *action)
+double SARewardsMap::get_value(State *state, Action *action) const
 {
 	std::unordered_map<State *,
 		std::unordered_map<Action *, double> >::const_iterator alpha =
@@ -47,9 +47,31 @@ SASRewardsArray::SASRewardsArray(unsigned int numStates, unsigned int numActions
 	reset();
 }
 
+SASRewardsArray::SASRewardsArray(unsigned int numStates, unsigned int numActions, float *R, double minReward,
+		double maxReward, std::shared_ptr<void> backing)
+{
+	states = numStates;
+	if (states == 0) {
+		states = 1;
+	}
+
+	actions = numActions;
+	if (actions == 0) {
+		actions = 1;
+	}
+
+	rewards = R;
+	this->backing = backing;
+
+	Rmin = minReward;
+	Rmax = maxReward;
+}
+
 SASRewardsArray::~SASRewardsArray()
 {
-	delete [] rewards;
+	if (backing == nullptr) {
+		delete [] rewards;
+	}
 }
 
 void SASRewardsArray::set(State *state, Action *action, State *nextState, double reward)
@@ -85,7 +107,7 @@ void SASRewardsArray::set(State *state, Action *action, State *nextState,
 	set(state, action, nextState, reward);
 }
 
-double SASRewardsArray::get(State *state, Action *action, State *nextState)
+double SASRewardsArray::get(State *state, Action *action, State *nextState) const
 {
 	IndexedState *s = dynamic_cast<IndexedState *>(state);
 	IndexedAction *a = dynamic_cast<IndexedAction *>(action);
@@ -106,7 +128,7 @@ double SASRewardsArray::get(State *state, Action *action, State *nextState)
 }
 
 double SASRewardsArray::get(State *state, Action *action, State *nextState,
-		Observation *observation)
+		Observation *observation) const
 {
 	return get(state, action, nextState);
 }
@@ -75,7 +75,7 @@ void SASRewardsMap::set(State *state, Action *action, State *nextState,
 	set(state, action, nextState, reward);
 }
 
-double SASRewardsMap::get(State *state, Action *action, State *nextState)
+double SASRewardsMap::get(State *state, Action *action, State *nextState) const
 {
 	// Iterate over all possible configurations of wildcards in the get statement.
 	// For each, use the get_value() function to check if the value exists. If it
@@ -106,7 +106,7 @@ double SASRewardsMap::get(State *state, Action *action, State *nextState)
 }
 
 double SASRewardsMap::get(State *state, Action *action, State *nextState,
-		Observation *observation)
+		Observation *observation) const
 {
 	return get(state, action, nextState);
 }
@@ -118,7 +118,7 @@ void SASRewardsMap::reset()
 	Rmax = std::numeric_limits<double>::lowest();
 }
 
-double SASRewardsMap::get_value(State *state, Action *action, State *nextState)
+double SASRewardsMap::get_value(State *state, Action *action, State *nextState) const
 {
 	std::unordered_map<State *,
 		std::unordered_map<Action *,
@@ -89,7 +89,7 @@ void SASORewardsArray::set(State *state, Action *action, State *nextState,
 }
 
 double SASORewardsArray::get(State *state, Action *action, State *nextState,
-		Observation *observation)
+		Observation *observation) const
 {
 	IndexedState *s = dynamic_cast<IndexedState *>(state);
 	IndexedAction *a = dynamic_cast<IndexedAction *>(action);
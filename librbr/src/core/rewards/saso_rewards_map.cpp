@@ -77,7 +77,7 @@ void SASORewardsMap::set(State *state, Action *action, State *nextState,
 }
 
 double SASORewardsMap::get(State *state, Action *action, State *nextState,
-		Observation *observation)
+		Observation *observation) const
 {
 	// Iterate over all possible configurations of wildcards in the get statement.
 	// For each, use the get_value() function to check if the value exists. If it
@@ -120,7 +120,7 @@ void SASORewardsMap::reset()
 }
 
 double SASORewardsMap::get_value(State *state, Action *action, State *nextState,
-		Observation *observation)
+		Observation *observation) const
 {
 	std::unordered_map<State *,
 		std::unordered_map<Action *,
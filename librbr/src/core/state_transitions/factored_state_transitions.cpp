@@ -0,0 +1,379 @@
+/**
+ *  The MIT License (MIT)
+ *
+ *  Copyright (c) 2014 Kyle Hollins Wray, University of Massachusetts
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy of
+ *  this software and associated documentation files (the "Software"), to deal in
+ *  the Software without restriction, including without limitation the rights to
+ *  use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ *  the Software, and to permit persons to whom the Software is furnished to do so,
+ *  subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included in all
+ *  copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ *  FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ *  COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ *  IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ *  CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+
+
+#include "../../../include/core/state_transitions/factored_state_transitions.h"
+#include "../../../include/core/state_transitions/state_transition_exception.h"
+
+#include "../../../include/core/states/factored_state.h"
+#include "../../../include/core/states/state_exception.h"
+
+#include <algorithm>
+#include <limits>
+
+FactoredStateTransitions::FactoredStateTransitions(FactoredStatesMap *S)
+{
+	if (S == nullptr || S->get_num_factors() == 0 || S->get_num_states() == 0) {
+		throw StateTransitionException();
+	}
+
+	states = S;
+
+	for (unsigned int i = 0; i < S->get_num_factors(); i++) {
+		factorSizes.push_back(S->get_factor_size(i));
+	}
+
+	parents.resize(factorSizes.size());
+	numRows.resize(factorSizes.size(), 1);
+	tables.resize(factorSizes.size());
+
+	frozen = false;
+}
+
+FactoredStateTransitions::~FactoredStateTransitions()
+{
+	reset();
+}
+
+void FactoredStateTransitions::set_parents(unsigned int factorIndex, const std::vector<unsigned int> &newParents)
+{
+	if (frozen || factorIndex >= factorSizes.size()) {
+		throw StateTransitionException();
+	}
+
+	// Each table has a row for every assignment to the parents, and a column for every state of the factor.
+	unsigned int rows = 1;
+
+	for (unsigned int parent : newParents) {
+		if (parent >= factorSizes.size() ||
+				rows > std::numeric_limits<unsigned int>::max() / factorSizes[parent] / factorSizes[factorIndex]) {
+			throw StateTransitionException();
+		}
+		rows *= factorSizes[parent];
+	}
+
+	parents[factorIndex] = newParents;
+	numRows[factorIndex] = rows;
+	tables[factorIndex].clear();
+
+	std::lock_guard<std::mutex> lock(successorsMutex);
+	successorStates.clear();
+}
+
+const std::vector<unsigned int> &FactoredStateTransitions::get_parents(unsigned int factorIndex) const
+{
+	if (factorIndex >= factorSizes.size()) {
+		throw StateTransitionException();
+	}
+
+	return parents[factorIndex];
+}
+
+void FactoredStateTransitions::set(unsigned int factorIndex, Action *action,
+		const std::vector<State *> &parentStates, State *nextFactorState, double probability)
+{
+	if (frozen || factorIndex >= factorSizes.size() || parentStates.size() != parents[factorIndex].size()) {
+		throw StateTransitionException();
+	}
+
+	unsigned int row = 0;
+	unsigned int column = 0;
+
+	try {
+		for (unsigned int i = 0; i < parentStates.size(); i++) {
+			unsigned int parent = parents[factorIndex][i];
+			row = row * factorSizes[parent] + states->get_factor_index(parent, parentStates[i]);
+		}
+		column = states->get_factor_index(factorIndex, nextFactorState);
+	} catch (const StateException &err) {
+		throw StateTransitionException();
+	}
+
+	std::vector<double> &table = tables[factorIndex][action];
+	if (table.empty()) {
+		table.resize(numRows[factorIndex] * factorSizes[factorIndex], -1.0);
+	}
+
+	table[row * factorSizes[factorIndex] + column] = std::max(0.0, std::min(1.0, probability));
+
+	std::lock_guard<std::mutex> lock(successorsMutex);
+	successorStates.clear();
+}
+
+double FactoredStateTransitions::get(unsigned int factorIndex, Action *action,
+		const std::vector<State *> &parentStates, State *nextFactorState) const
+{
+	if (factorIndex >= factorSizes.size() || parentStates.size() != parents[factorIndex].size()) {
+		throw StateTransitionException();
+	}
+
+	unsigned int row = 0;
+	unsigned int column = 0;
+
+	try {
+		for (unsigned int i = 0; i < parentStates.size(); i++) {
+			unsigned int parent = parents[factorIndex][i];
+			row = row * factorSizes[parent] + states->get_factor_index(parent, parentStates[i]);
+		}
+		column = states->get_factor_index(factorIndex, nextFactorState);
+	} catch (const StateException &err) {
+		throw StateTransitionException();
+	}
+
+	return find_probability(factorIndex, action, row, column);
+}
+
+void FactoredStateTransitions::set(State *, Action *, State *, double)
+{
+	throw StateTransitionException();
+}
+
+double FactoredStateTransitions::get(State *state, Action *action, State *nextState) const
+{
+	FactoredState *next = dynamic_cast<FactoredState *>(nextState);
+	if (next == nullptr || next->get_num_states() != (int)factorSizes.size()) {
+		throw StateTransitionException();
+	}
+
+	double probability = 1.0;
+
+	for (unsigned int i = 0; i < factorSizes.size() && probability > 0.0; i++) {
+		unsigned int column = 0;
+		try {
+			column = states->get_factor_index(i, next->get(i));
+		} catch (const StateException &err) {
+			throw StateTransitionException();
+		}
+
+		probability *= find_probability(i, action, find_row(i, state), column);
+	}
+
+	return probability;
+}
+
+State *FactoredStateTransitions::sample(State *state, Action *action, std::mt19937 &generator) const
+{
+	unsigned int index = 0;
+
+	std::vector<double> row;
+
+	for (unsigned int i = 0; i < factorSizes.size(); i++) {
+		unsigned int r = find_row(i, state);
+
+		row.resize(factorSizes[i]);
+		double total = 0.0;
+		for (unsigned int j = 0; j < factorSizes[i]; j++) {
+			row[j] = find_probability(i, action, r, j);
+			total += row[j];
+		}
+		if (total <= 0.0) {
+			throw StateTransitionException();
+		}
+
+		// Walk along the row until the target is passed, falling back to the last nonzero entry in case
+		// rounding leaves the target just beyond the sum.
+		double target = std::uniform_real_distribution<double>(0.0, total)(generator);
+		unsigned int value = factorSizes[i];
+
+		for (unsigned int j = 0; j < factorSizes[i]; j++) {
+			if (row[j] > 0.0) {
+				value = j;
+				target -= row[j];
+				if (target < 0.0) {
+					break;
+				}
+			}
+		}
+
+		index = index * factorSizes[i] + value;
+	}
+
+	return states->get_state(index);
+}
+
+const std::vector<State *> &FactoredStateTransitions::successors(States *, State *state, Action *action)
+{
+	return find_successors(state, action).first;
+}
+
+const std::vector<float> &FactoredStateTransitions::probabilities(States *, State *state, Action *action)
+{
+	return find_successors(state, action).second;
+}
+
+void FactoredStateTransitions::build_successors(States *, Actions *)
+{ }
+
+void FactoredStateTransitions::freeze(States *, Actions *)
+{
+	frozen = true;
+}
+
+bool FactoredStateTransitions::is_frozen() const
+{
+	return frozen;
+}
+
+unsigned int FactoredStateTransitions::get_num_parameters() const
+{
+	unsigned int numParameters = 0;
+
+	for (const std::unordered_map<Action *, std::vector<double> > &factorTables : tables) {
+		for (const auto &table : factorTables) {
+			numParameters += table.second.size();
+		}
+	}
+
+	return numParameters;
+}
+
+void FactoredStateTransitions::reset()
+{
+	for (unsigned int i = 0; i < factorSizes.size(); i++) {
+		parents[i].clear();
+		numRows[i] = 1;
+		tables[i].clear();
+	}
+
+	std::lock_guard<std::mutex> lock(successorsMutex);
+	successorStates.clear();
+
+	frozen = false;
+}
+
+unsigned int FactoredStateTransitions::find_row(unsigned int factorIndex, State *state) const
+{
+	FactoredState *fs = dynamic_cast<FactoredState *>(state);
+	if (fs == nullptr || fs->get_num_states() != (int)factorSizes.size()) {
+		throw StateTransitionException();
+	}
+
+	unsigned int row = 0;
+
+	try {
+		for (unsigned int parent : parents[factorIndex]) {
+			row = row * factorSizes[parent] + states->get_factor_index(parent, fs->get(parent));
+		}
+	} catch (const StateException &err) {
+		throw StateTransitionException();
+	}
+
+	return row;
+}
+
+double FactoredStateTransitions::find_probability(unsigned int factorIndex, Action *action, unsigned int row,
+		unsigned int column) const
+{
+	unsigned int entry = row * factorSizes[factorIndex] + column;
+
+	std::unordered_map<Action *, std::vector<double> >::const_iterator result = tables[factorIndex].find(action);
+	if (result != tables[factorIndex].end() && result->second[entry] >= 0.0) {
+		return result->second[entry];
+	}
+
+	result = tables[factorIndex].find(nullptr);
+	if (result != tables[factorIndex].end() && result->second[entry] >= 0.0) {
+		return result->second[entry];
+	}
+
+	return 0.0;
+}
+
+void FactoredStateTransitions::compute_successors(State *state, Action *action, std::vector<State *> &succ,
+		std::vector<float> &prob) const
+{
+	// The nonzero entries of each factor's row, which are combined below in every way.
+	std::vector<std::vector<unsigned int> > values(factorSizes.size());
+	std::vector<std::vector<double> > factorProbabilities(factorSizes.size());
+
+	for (unsigned int i = 0; i < factorSizes.size(); i++) {
+		unsigned int row = find_row(i, state);
+
+		for (unsigned int j = 0; j < factorSizes[i]; j++) {
+			double p = find_probability(i, action, row, j);
+			if (p > 0.0) {
+				values[i].push_back(j);
+				factorProbabilities[i].push_back(p);
+			}
+		}
+
+		if (values[i].empty()) {
+			return;
+		}
+	}
+
+	// Count through the combinations with one digit per factor, the first the most significant, so the
+	// successors are in order of their index.
+	std::vector<unsigned int> digits(factorSizes.size(), 0);
+
+	while (true) {
+		unsigned int index = 0;
+		double p = 1.0;
+
+		for (unsigned int i = 0; i < factorSizes.size(); i++) {
+			index = index * factorSizes[i] + values[i][digits[i]];
+			p *= factorProbabilities[i][digits[i]];
+		}
+
+		succ.push_back(states->get_state(index));
+		prob.push_back((float)p);
+
+		int i = (int)factorSizes.size() - 1;
+		for (; i >= 0; i--) {
+			digits[i]++;
+			if (digits[i] < values[i].size()) {
+				break;
+			}
+			digits[i] = 0;
+		}
+
+		if (i < 0) {
+			break;
+		}
+	}
+}
+
+std::pair<std::vector<State *>, std::vector<float> > &FactoredStateTransitions::find_successors(State *state,
+		Action *action)
+{
+	std::lock_guard<std::mutex> lock(successorsMutex);
+
+	std::unordered_map<Action *, std::pair<std::vector<State *>, std::vector<float> > > &row = successorStates[state];
+
+	std::unordered_map<Action *, std::pair<std::vector<State *>, std::vector<float> > >::iterator result =
+			row.find(action);
+	if (result != row.end()) {
+		return result->second;
+	}
+
+	std::vector<State *> succ;
+	std::vector<float> prob;
+	compute_successors(state, action, succ, prob);
+
+	std::pair<std::vector<State *>, std::vector<float> > &entry = row[action];
+	entry.first.swap(succ);
+	entry.second.swap(prob);
+
+	return entry;
+}
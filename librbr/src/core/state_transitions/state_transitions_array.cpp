@@ -25,6 +25,8 @@
 #include "../../../include/core/state_transitions/state_transitions_array.h"
 #include "../../../include/core/state_transitions/state_transition_exception.h"
 
+#include "../../../include/utilities/parallel_for.h"
+
 #include <algorithm>
 
 StateTransitionsArray::StateTransitionsArray(unsigned int numStates, unsigned int numActions)
@@ -41,18 +43,55 @@ StateTransitionsArray::StateTransitionsArray(unsigned int numStates, unsigned in
 
 	stateTransitions = new float[states * actions * states];
 	successorStates = new std::vector<State *>[states * actions];
+	successorProbabilities = new std::vector<float>[states * actions];
+	successorsComputed = new bool[states * actions];
 
 	reset();
 }
 
+StateTransitionsArray::StateTransitionsArray(unsigned int numStates, unsigned int numActions, float *T,
+		std::shared_ptr<void> backing)
+{
+	states = numStates;
+	if (states == 0) {
+		states = 1;
+	}
+
+	actions = numActions;
+	if (actions == 0) {
+		actions = 1;
+	}
+
+	stateTransitions = T;
+	this->backing = backing;
+
+	successorStates = new std::vector<State *>[states * actions];
+	successorProbabilities = new std::vector<float>[states * actions];
+	successorsComputed = new bool[states * actions];
+
+	for (unsigned int i = 0; i < states * actions; i++) {
+		successorsComputed[i] = false;
+	}
+
+	frozen = false;
+}
+
 StateTransitionsArray::~StateTransitionsArray()
 {
-	delete [] stateTransitions;
+	if (backing == nullptr) {
+		delete [] stateTransitions;
+	}
 	delete [] successorStates;
+	delete [] successorProbabilities;
+	delete [] successorsComputed;
 }
 
 void StateTransitionsArray::set(State *state, Action *action, State *nextState, double probability)
 {
+	if (frozen) {
+		throw StateTransitionException();
+	}
+
 	IndexedState *s = dynamic_cast<IndexedState *>(state);
 	IndexedAction *a = dynamic_cast<IndexedAction *>(action);
 	IndexedState *sp = dynamic_cast<IndexedState *>(nextState);
@@ -68,9 +107,17 @@ void StateTransitionsArray::set(State *state, Action *action, State *nextState,
 	stateTransitions[s->get_index() * actions * states +
 	                 a->get_index() * states +
 	                 sp->get_index()] = (float)std::max(0.0, std::min(1.0, probability));
+
+	// The computed successors of this pair may have changed, so compute them again when needed.
+	unsigned int i = s->get_index() * actions + a->get_index();
+	if (successorsComputed[i]) {
+		successorStates[i].clear();
+		successorProbabilities[i].clear();
+		successorsComputed[i] = false;
+	}
 }
 
-double StateTransitionsArray::get(State *state, Action *action, State *nextState)
+double StateTransitionsArray::get(State *state, Action *action, State *nextState) const
 {
 	IndexedState *s = dynamic_cast<IndexedState *>(state);
 	IndexedAction *a = dynamic_cast<IndexedAction *>(action);
@@ -91,6 +138,10 @@ double StateTransitionsArray::get(State *state, Action *action, State *nextState
 
 void StateTransitionsArray::add_successor(State *state, Action *action, State *successorState)
 {
+	if (frozen) {
+		throw StateTransitionException();
+	}
+
 	IndexedState *s = dynamic_cast<IndexedState *>(state);
 	IndexedAction *a = dynamic_cast<IndexedAction *>(action);
 
@@ -103,6 +154,7 @@ void StateTransitionsArray::add_successor(State *state, Action *action, State *s
 	}
 
 	successorStates[s->get_index() * actions + a->get_index()].push_back(successorState);
+	successorsComputed[s->get_index() * actions + a->get_index()] = false;
 }
 
 const std::vector<State *> &StateTransitionsArray::successors(States *S, State *state, Action *action)
@@ -118,26 +170,56 @@ const std::vector<State *> &StateTransitionsArray::successors(States *S, State *
 		throw StateTransitionException();
 	}
 
-	if (successorStates[s->get_index() * actions + a->get_index()].size() == 0) {
+	unsigned int i = s->get_index() * actions + a->get_index();
+	if (!frozen && !successorsComputed[i]) {
 		StatesMap *Smap = dynamic_cast<StatesMap *>(S);
-		if (Smap == nullptr) {
+		if (Smap == nullptr && successorStates[i].size() == 0) {
 			throw StateTransitionException();
 		}
 
-		compute_successors(Smap, s, a);
+		compute_successors(Smap, s->get_index(), a->get_index());
+	}
+
+	return successorStates[i];
+}
+
+const std::vector<float> &StateTransitionsArray::probabilities(States *S, State *state, Action *action)
+{
+	IndexedState *s = dynamic_cast<IndexedState *>(state);
+	IndexedAction *a = dynamic_cast<IndexedAction *>(action);
+
+	if (s == nullptr || a == nullptr) {
+		throw StateTransitionException();
 	}
 
-	return successorStates[s->get_index() * actions + a->get_index()];
+	if (s->get_index() >= states || a->get_index() >= actions) {
+		throw StateTransitionException();
+	}
+
+	// Computing the successors also computes their probabilities.
+	successors(S, state, action);
+
+	return successorProbabilities[s->get_index() * actions + a->get_index()];
 }
 
 void StateTransitionsArray::set_state_transitions(const float *T)
 {
+	if (frozen) {
+		throw StateTransitionException();
+	}
+
 	for (unsigned int s = 0; s < states; s++) {
 		for (unsigned int a = 0; a < actions; a++) {
 			for (unsigned int sp = 0; sp < states; sp++) {
 				stateTransitions[s * actions * states + a * states + sp] =
 						T[s * actions * states + a * states + sp];
 			}
+
+			if (successorsComputed[s * actions + a]) {
+				successorStates[s * actions + a].clear();
+				successorProbabilities[s * actions + a].clear();
+				successorsComputed[s * actions + a] = false;
+			}
 		}
 	}
 }
@@ -157,8 +239,41 @@ unsigned int StateTransitionsArray::get_num_actions() const
 	return actions;
 }
 
+void StateTransitionsArray::build_successors(States *S, Actions *)
+{
+	if (frozen) {
+		return;
+	}
+
+	StatesMap *Smap = dynamic_cast<StatesMap *>(S);
+	if (Smap == nullptr) {
+		throw StateTransitionException();
+	}
+
+	// Each state-action pair owns its own successors list, so the rows may be computed in parallel.
+	parallel_for(states * actions, [&](unsigned int i) {
+		if (!successorsComputed[i]) {
+			compute_successors(Smap, i / actions, i % actions);
+		}
+	});
+}
+
+void StateTransitionsArray::freeze(States *S, Actions *A)
+{
+	build_successors(S, A);
+
+	frozen = true;
+}
+
+bool StateTransitionsArray::is_frozen() const
+{
+	return frozen;
+}
+
 void StateTransitionsArray::reset()
 {
+	frozen = false;
+
 	for (unsigned int s = 0; s < states; s++) {
 		for (unsigned int a = 0; a < actions; a++) {
 			for (unsigned int sp = 0; sp < states; sp++) {
@@ -168,17 +283,38 @@ void StateTransitionsArray::reset()
 			}
 
 			successorStates[s * actions + a].clear();
+			successorProbabilities[s * actions + a].clear();
+			successorsComputed[s * actions + a] = false;
 		}
 	}
 }
 
-void StateTransitionsArray::compute_successors(StatesMap *S, IndexedState *s, IndexedAction *a)
+void StateTransitionsArray::compute_successors(StatesMap *S, unsigned int s, unsigned int a)
 {
-	successorStates[s->get_index() * actions + a->get_index()].clear();
+	std::vector<State *> &succ = successorStates[s * actions + a];
+	std::vector<float> &prob = successorProbabilities[s * actions + a];
+
+	prob.clear();
 
-	for (unsigned int sp = 0; sp < states; sp++) {
-		if (stateTransitions[s->get_index() * actions * states + a->get_index() * states + sp] > 0.0f) {
-			successorStates[s->get_index() * actions + a->get_index()].push_back(S->get(sp));
+	if (succ.size() == 0) {
+		for (unsigned int sp = 0; sp < states; sp++) {
+			float p = stateTransitions[s * actions * states + a * states + sp];
+			if (p > 0.0f) {
+				succ.push_back(S->get(sp));
+				prob.push_back(p);
+			}
+		}
+	} else {
+		prob.reserve(succ.size());
+		for (State *sp : succ) {
+			IndexedState *isp = dynamic_cast<IndexedState *>(sp);
+			if (isp != nullptr && isp->get_index() < states) {
+				prob.push_back(stateTransitions[s * actions * states + a * states + isp->get_index()]);
+			} else {
+				prob.push_back(0.0f);
+			}
 		}
 	}
+
+	successorsComputed[s * actions + a] = true;
 }
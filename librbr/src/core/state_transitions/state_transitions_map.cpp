@@ -27,6 +27,9 @@
 
 #include "../../../include/core/states/named_state.h"
 #include "../../../include/core/actions/named_action.h"
+#include "../../../include/core/actions/actions_map.h"
+
+#include "../../../include/utilities/parallel_for.h"
 
 #include <algorithm>
 
@@ -34,6 +37,8 @@ StateTransitionsMap::StateTransitionsMap()
 {
 	stateWildcard = new NamedState("*");
 	actionWildcard = new NamedAction("*");
+
+	frozen = false;
 }
 
 StateTransitionsMap::~StateTransitionsMap()
@@ -46,6 +51,10 @@ StateTransitionsMap::~StateTransitionsMap()
 
 void StateTransitionsMap::set(State *state, Action *action, State *nextState, double probability)
 {
+	if (frozen) {
+		throw StateTransitionException();
+	}
+
 	if (state == nullptr) {
 		state = stateWildcard;
 	}
@@ -57,9 +66,11 @@ void StateTransitionsMap::set(State *state, Action *action, State *nextState, do
 	}
 
 	stateTransitions[state][action][nextState] = std::max(0.0, std::min(1.0, probability));
+
+	discard_successors(state, action);
 }
 
-double StateTransitionsMap::get(State *state, Action *action, State *nextState)
+double StateTransitionsMap::get(State *state, Action *action, State *nextState) const
 {
 	// Iterate over all possible configurations of wildcards in the get statement.
 	// For each, use the get_value() function to check if the value exists. If it
@@ -91,7 +102,18 @@ double StateTransitionsMap::get(State *state, Action *action, State *nextState)
 
 void StateTransitionsMap::add_successor(State *state, Action *action, State *successorState)
 {
+	if (frozen) {
+		throw StateTransitionException();
+	}
+
 	successorStates[state][action].push_back(successorState);
+
+	std::unordered_map<State *,
+		std::unordered_map<Action *,
+		std::vector<float> > >::iterator alpha = successorProbabilities.find(state);
+	if (alpha != successorProbabilities.end()) {
+		alpha->second.erase(action);
+	}
 }
 
 const std::vector<State *> &StateTransitionsMap::successors(States *S, State *state, Action *action)
@@ -109,25 +131,99 @@ const std::vector<State *> &StateTransitionsMap::successors(States *S, State *st
 		throw StateTransitionException();
 	}
 
-	if (beta->second.size() == 0) {
-		StatesMap *Smap = dynamic_cast<StatesMap *>(S);
-		if (Smap == nullptr) {
-			throw StateTransitionException();
+	return beta->second;
+}
+
+const std::vector<float> &StateTransitionsMap::probabilities(States *S, State *state, Action *action)
+{
+	std::unordered_map<State *,
+		std::unordered_map<Action *,
+		std::vector<float> > >::iterator alpha = successorProbabilities.find(state);
+	if (alpha != successorProbabilities.end()) {
+		std::unordered_map<Action *,
+			std::vector<float> >::iterator beta = alpha->second.find(action);
+		if (beta != alpha->second.end()) {
+			return beta->second;
 		}
+	}
+
+	if (frozen) {
+		throw StateTransitionException();
+	}
 
-		compute_successors(Smap, state, action, beta->second);
+	// The successors were given by add_successor(), so only their probabilities are missing.
+	const std::vector<State *> &succ = successors(S, state, action);
+	std::vector<float> &prob = successorProbabilities[state][action];
+
+	for (State *sp : succ) {
+		prob.push_back((float)get(state, action, sp));
 	}
 
-	return beta->second;
+	return prob;
+}
+
+void StateTransitionsMap::build_successors(States *S, Actions *A)
+{
+	if (frozen) {
+		return;
+	}
+
+	StatesMap *Smap = dynamic_cast<StatesMap *>(S);
+	ActionsMap *Amap = dynamic_cast<ActionsMap *>(A);
+	if (Smap == nullptr || Amap == nullptr) {
+		throw StateTransitionException();
+	}
+
+	// Create every missing row first, so that the maps do not change while the rows are filled in parallel.
+	std::vector<State *> rowStates;
+	std::vector<Action *> rowActions;
+	std::vector<std::vector<State *> *> rows;
+	std::vector<std::vector<float> *> rowProbabilities;
+
+	for (auto state : *Smap) {
+		State *s = resolve(state);
+
+		for (auto action : *Amap) {
+			Action *a = resolve(action);
+
+			std::unordered_map<Action *, std::vector<float> > &probs = successorProbabilities[s];
+			if (probs.find(a) != probs.end()) {
+				continue;
+			}
+
+			rowStates.push_back(s);
+			rowActions.push_back(a);
+			rows.push_back(&successorStates[s][a]);
+			rowProbabilities.push_back(&probs[a]);
+		}
+	}
+
+	parallel_for(rows.size(), [&](unsigned int i) {
+		compute_successors(Smap, rowStates[i], rowActions[i], *rows[i], *rowProbabilities[i]);
+	});
+}
+
+void StateTransitionsMap::freeze(States *S, Actions *A)
+{
+	build_successors(S, A);
+
+	frozen = true;
+}
+
+bool StateTransitionsMap::is_frozen() const
+{
+	return frozen;
 }
 
 void StateTransitionsMap::reset()
 {
 	stateTransitions.clear();
 	successorStates.clear();
+	successorProbabilities.clear();
+	frozen = false;
 }
 
-double StateTransitionsMap::get_value(State *state, Action *action, State *nextState)
+double StateTransitionsMap::get_value(State *state, Action *action, State *nextState) const
 {
 	std::unordered_map<State *,
 		std::unordered_map<Action *,
@@ -150,15 +246,42 @@ double StateTransitionsMap::get_value(State *state, Action *action, State *nextS
 	return gamma->second;
 }
 
-void StateTransitionsMap::compute_successors(StatesMap *S, State *s, Action *a, std::vector<State *> &succ)
+void StateTransitionsMap::compute_successors(StatesMap *S, State *s, Action *a, std::vector<State *> &succ,
+		std::vector<float> &prob)
+{
+	if (succ.size() == 0) {
+		for (auto state : *S) {
+			State *sp = resolve(state);
+
+			if (get(s, a, sp) > 0.0) {
+				succ.push_back(sp);
+			}
+		}
+	}
+
+	prob.clear();
+	prob.reserve(succ.size());
+
+	for (State *sp : succ) {
+		prob.push_back((float)get(s, a, sp));
+	}
+}
+
+void StateTransitionsMap::discard_successors(State *state, Action *action)
 {
-	succ.clear();
+	for (auto &alpha : successorProbabilities) {
+		if (state != stateWildcard && alpha.first != state) {
+			continue;
+		}
 
-	for (auto state : *S) {
-		State *sp = resolve(state);
+		for (auto beta = alpha.second.begin(); beta != alpha.second.end(); ) {
+			if (action != actionWildcard && beta->first != action) {
+				beta++;
+				continue;
+			}
 
-		if (get(s, a, sp) > 0.0) {
-			succ.push_back(sp);
+			successorStates[alpha.first].erase(beta->first);
+			beta = alpha.second.erase(beta);
 		}
 	}
 }
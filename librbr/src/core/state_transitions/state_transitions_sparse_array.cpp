@@ -0,0 +1,186 @@
+/**
+ *  The MIT License (MIT)
+ *
+ *  Copyright (c) 2014 Kyle Hollins Wray, University of Massachusetts
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy of
+ *  this software and associated documentation files (the "Software"), to deal in
+ *  the Software without restriction, including without limitation the rights to
+ *  use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ *  the Software, and to permit persons to whom the Software is furnished to do so,
+ *  subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included in all
+ *  copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ *  FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ *  COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ *  IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ *  CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+
+#include "../../../include/core/state_transitions/state_transitions_sparse_array.h"
+#include "../../../include/core/state_transitions/state_transition_exception.h"
+
+#include <algorithm>
+
+StateTransitionsSparseArray::StateTransitionsSparseArray(unsigned int numStates, unsigned int numActions)
+{
+	states = numStates;
+	if (states == 0) {
+		states = 1;
+	}
+
+	actions = numActions;
+	if (actions == 0) {
+		actions = 1;
+	}
+
+	numNonzero = 0;
+	frozen = false;
+
+	successorIndexes.resize(states * actions);
+	successorStates.resize(states * actions);
+	successorProbabilities.resize(states * actions);
+}
+
+StateTransitionsSparseArray::~StateTransitionsSparseArray()
+{ }
+
+void StateTransitionsSparseArray::set(State *state, Action *action, State *nextState, double probability)
+{
+	if (frozen) {
+		throw StateTransitionException();
+	}
+
+	unsigned int row = find_row(state, action);
+	unsigned int sp = find_next_state(nextState);
+
+	float p = (float)std::max(0.0, std::min(1.0, probability));
+
+	std::vector<unsigned int> &indexes = successorIndexes[row];
+
+	// Streaming the successors in order only appends to the row; otherwise, search for the location.
+	std::vector<unsigned int>::iterator location = indexes.end();
+	if (!indexes.empty() && indexes.back() >= sp) {
+		location = std::lower_bound(indexes.begin(), indexes.end(), sp);
+	}
+	unsigned int i = (unsigned int)(location - indexes.begin());
+
+	if (location != indexes.end() && *location == sp) {
+		if (p > 0.0f) {
+			successorProbabilities[row][i] = p;
+		} else {
+			indexes.erase(location);
+			successorStates[row].erase(successorStates[row].begin() + i);
+			successorProbabilities[row].erase(successorProbabilities[row].begin() + i);
+			numNonzero--;
+		}
+	} else if (p > 0.0f) {
+		indexes.insert(location, sp);
+		successorStates[row].insert(successorStates[row].begin() + i, nextState);
+		successorProbabilities[row].insert(successorProbabilities[row].begin() + i, p);
+		numNonzero++;
+	}
+}
+
+double StateTransitionsSparseArray::get(State *state, Action *action, State *nextState) const
+{
+	unsigned int row = find_row(state, action);
+	unsigned int sp = find_next_state(nextState);
+
+	const std::vector<unsigned int> &indexes = successorIndexes[row];
+
+	std::vector<unsigned int>::const_iterator location = std::lower_bound(indexes.begin(), indexes.end(), sp);
+	if (location == indexes.end() || *location != sp) {
+		return 0.0;
+	}
+
+	return successorProbabilities[row][location - indexes.begin()];
+}
+
+const std::vector<State *> &StateTransitionsSparseArray::successors(States *, State *state, Action *action)
+{
+	return successorStates[find_row(state, action)];
+}
+
+const std::vector<float> &StateTransitionsSparseArray::probabilities(State *state, Action *action)
+{
+	return successorProbabilities[find_row(state, action)];
+}
+
+const std::vector<float> &StateTransitionsSparseArray::probabilities(States *, State *state, Action *action)
+{
+	return successorProbabilities[find_row(state, action)];
+}
+
+void StateTransitionsSparseArray::build_successors(States *, Actions *)
+{ }
+
+unsigned int StateTransitionsSparseArray::get_num_states() const
+{
+	return states;
+}
+
+unsigned int StateTransitionsSparseArray::get_num_actions() const
+{
+	return actions;
+}
+
+unsigned int StateTransitionsSparseArray::get_num_nonzero() const
+{
+	return numNonzero;
+}
+
+void StateTransitionsSparseArray::freeze(States *, Actions *)
+{
+	frozen = true;
+}
+
+bool StateTransitionsSparseArray::is_frozen() const
+{
+	return frozen;
+}
+
+void StateTransitionsSparseArray::reset()
+{
+	frozen = false;
+
+	for (unsigned int i = 0; i < states * actions; i++) {
+		std::vector<unsigned int>().swap(successorIndexes[i]);
+		std::vector<State *>().swap(successorStates[i]);
+		std::vector<float>().swap(successorProbabilities[i]);
+	}
+
+	numNonzero = 0;
+}
+
+unsigned int StateTransitionsSparseArray::find_row(State *state, Action *action) const
+{
+	IndexedState *s = dynamic_cast<IndexedState *>(state);
+	IndexedAction *a = dynamic_cast<IndexedAction *>(action);
+
+	if (s == nullptr || a == nullptr) {
+		throw StateTransitionException();
+	}
+
+	if (s->get_index() >= states || a->get_index() >= actions) {
+		throw StateTransitionException();
+	}
+
+	return s->get_index() * actions + a->get_index();
+}
+
+unsigned int StateTransitionsSparseArray::find_next_state(State *nextState) const
+{
+	IndexedState *sp = dynamic_cast<IndexedState *>(nextState);
+
+	if (sp == nullptr || sp->get_index() >= states) {
+		throw StateTransitionException();
+	}
+
+	return sp->get_index();
+}
@@ -27,9 +27,12 @@
 #include "../../../include/core/states/state_exception.h"
 
 #include <algorithm>
+#include <limits>
 
 FactoredStatesMap::FactoredStatesMap()
-{ }
+{
+	numStates = 0;
+}
 
 FactoredStatesMap::FactoredStatesMap(unsigned int numFactors)
 {
@@ -37,6 +40,8 @@ FactoredStatesMap::FactoredStatesMap(unsigned int numFactors)
 		numFactors = 1;
 	}
 	factoredStates.resize(numFactors);
+
+	numStates = 0;
 }
 
 FactoredStatesMap::~FactoredStatesMap()
@@ -117,10 +122,171 @@ void FactoredStatesMap::update()
 		}
 	}
 
-	states.clear();
+	created.clear();
+
+	factorIndexes.clear();
+	factorIndexes.resize(factoredStates.size());
+	factorNames.clear();
+	factorNames.resize(factoredStates.size());
+
+	numStates = 1;
+
+	for (unsigned int i = 0; i < factoredStates.size(); i++) {
+		if (numStates > std::numeric_limits<unsigned int>::max() / factoredStates[i].size()) {
+			numStates = 0;
+			throw StateException();
+		}
+		numStates *= factoredStates[i].size();
+
+		// The first state with a particular name is kept, as in StatesMap.
+		for (unsigned int j = 0; j < factoredStates[i].size(); j++) {
+			factorIndexes[i][factoredStates[i][j]] = j;
+
+			std::string name;
+			if (get_name(factoredStates[i][j], name)) {
+				factorNames[i].insert(std::make_pair(name, j));
+			}
+		}
+	}
+
+	created.resize(numStates);
+}
+
+bool FactoredStatesMap::exists(const State *state) const
+{
+	try {
+		get_index(state);
+	} catch (const StateException &err) {
+		return false;
+	}
+	return true;
+}
+
+State *FactoredStatesMap::get(unsigned int hash)
+{
+	if (numStates == 0) {
+		throw StateException();
+	}
+
+	// Continue a hash, as FactoredState computes it, over the parts in the factors from first to last
+	// (exclusive) given by a mixed-radix index over only those factors.
+	auto hash_parts = [this](unsigned int first, unsigned int last, unsigned int index, unsigned int h) {
+		std::vector<unsigned int> digits(last - first, 0);
+		for (unsigned int i = last; i > first; i--) {
+			digits[i - 1 - first] = index % factoredStates[i - 1].size();
+			index /= factoredStates[i - 1].size();
+		}
+		for (unsigned int i = first; i < last; i++) {
+			h = 31 * h + factoredStates[i][digits[i - first]]->hash_value();
+		}
+		return h;
+	};
+
+	// The hash is prefix * 31^k + suffix (modulo 2^32) for the k factors in the suffix, so grow the suffix
+	// to about the square root of the number of states, and tabulate the hash of each suffix.
+	unsigned int split = factoredStates.size() - 1;
+	unsigned long long numSuffixes = factoredStates[split].size();
+	while (split > 0 && numSuffixes * factoredStates[split - 1].size() *
+			numSuffixes * factoredStates[split - 1].size() <= numStates) {
+		split--;
+		numSuffixes *= factoredStates[split].size();
+	}
+
+	unsigned int multiplier = 1;
+	for (unsigned int i = split; i < factoredStates.size(); i++) {
+		multiplier *= 31;
+	}
+
+	// The first suffix with a particular hash is kept, so the lowest index is found.
+	std::unordered_map<unsigned int, unsigned int> suffixes;
+	for (unsigned int j = 0; j < numSuffixes; j++) {
+		suffixes.insert(std::make_pair(hash_parts(split, factoredStates.size(), j, 0), j));
+	}
+
+	unsigned int numPrefixes = numStates / numSuffixes;
+	for (unsigned int i = 0; i < numPrefixes; i++) {
+		std::unordered_map<unsigned int, unsigned int>::const_iterator result =
+				suffixes.find(hash - hash_parts(0, split, i, 7) * multiplier);
+		if (result != suffixes.end()) {
+			return get_state(i * numSuffixes + result->second);
+		}
+	}
+
+	throw StateException();
+}
+
+State *FactoredStatesMap::get_by_name(const std::string &name) const
+{
+	unsigned int index = 0;
+	std::size_t start = 0;
+
+	for (unsigned int i = 0; i < factorNames.size(); i++) {
+		std::size_t stop = name.find(' ', start);
+		if ((stop == std::string::npos) != (i == factorNames.size() - 1)) {
+			throw StateException();
+		}
+
+		std::unordered_map<std::string, unsigned int>::const_iterator result =
+				factorNames[i].find(name.substr(start, stop - start));
+		if (result == factorNames[i].end()) {
+			throw StateException();
+		}
+
+		index = index * factoredStates[i].size() + result->second;
+		start = stop + 1;
+	}
+
+	return get_state(index);
+}
+
+unsigned int FactoredStatesMap::get_index(const State *state) const
+{
+	const FactoredState *fs = dynamic_cast<const FactoredState *>(state);
+	if (fs == nullptr || numStates == 0 || fs->get_num_states() != (int)factorIndexes.size()) {
+		throw StateException();
+	}
+
+	unsigned int index = 0;
+
+	for (unsigned int i = 0; i < factorIndexes.size(); i++) {
+		std::unordered_map<const State *, unsigned int>::const_iterator result =
+				factorIndexes[i].find(const_cast<FactoredState *>(fs)->get(i));
+		if (result == factorIndexes[i].end()) {
+			throw StateException();
+		}
+
+		index = index * factoredStates[i].size() + result->second;
+	}
+
+	return index;
+}
+
+State *FactoredStatesMap::get_state(unsigned int index) const
+{
+	if (index >= numStates) {
+		throw StateException();
+	}
+
+	FactoredState *state = created.get(index);
+	if (state != nullptr) {
+		return state;
+	}
+
+	// Decode the mixed-radix index, starting from the last (least significant) factor.
+	std::vector<State *> parts(factoredStates.size(), nullptr);
+	unsigned int remainder = index;
+	for (int i = (int)factoredStates.size() - 1; i >= 0; i--) {
+		parts[i] = factoredStates[i][remainder % factoredStates[i].size()];
+		remainder /= factoredStates[i].size();
+	}
+
+	// If another thread creates the state first, its state is returned instead.
+	return created.insert(index, new FactoredState(parts));
+}
 
-	std::vector<State *> create;
-	update_step(create, 0);
+unsigned int FactoredStatesMap::get_num_states() const
+{
+	return numStates;
 }
 
 unsigned int FactoredStatesMap::get_num_factors()
@@ -128,6 +294,34 @@ unsigned int FactoredStatesMap::get_num_factors()
 	return factoredStates.size();
 }
 
+unsigned int FactoredStatesMap::get_factor_size(unsigned int factorIndex) const
+{
+	if (factorIndex >= factoredStates.size()) {
+		throw StateException();
+	}
+
+	return factoredStates[factorIndex].size();
+}
+
+unsigned int FactoredStatesMap::get_num_created() const
+{
+	return created.get_num_objects();
+}
+
+unsigned int FactoredStatesMap::get_factor_index(unsigned int factorIndex, const State *state) const
+{
+	if (factorIndex >= factorIndexes.size()) {
+		throw StateException();
+	}
+
+	std::unordered_map<const State *, unsigned int>::const_iterator result = factorIndexes[factorIndex].find(state);
+	if (result == factorIndexes[factorIndex].end()) {
+		throw StateException();
+	}
+
+	return result->second;
+}
+
 void FactoredStatesMap::reset()
 {
 	for (std::vector<State *> &factor : factoredStates) {
@@ -137,26 +331,11 @@ void FactoredStatesMap::reset()
 		factor.clear();
 	}
 
-	states.clear();
-}
-
-void FactoredStatesMap::update_step(std::vector<State *> currentFactoredState, unsigned int currentFactorIndex)
-{
-	// At the final factor index, we need to create a bunch of factored states.
-	for (State *state : factoredStates[currentFactorIndex]) {
-		// Begin by pushing a current factor's state on the vector (tuple).
-		currentFactoredState.push_back(state);
-
-		// If this is the final index, then create a factored state object and append it to the list of states.
-		// Otherwise, recurse to the next index, using the new currentFactoredState object.
-		if (currentFactorIndex == factoredStates.size() - 1) {
-			FactoredState *newState = new FactoredState(currentFactoredState);
-			states[newState->hash_value()] = newState;
-		} else {
-			update_step(currentFactoredState, currentFactorIndex + 1);
-		}
+	created.clear();
+	factorIndexes.clear();
+	factorNames.clear();
+	numStates = 0;
 
-		// Pop off the state that was just appended, to prepare for the next loop.
-		currentFactoredState.pop_back();
-	}
+	clear();
 }
+
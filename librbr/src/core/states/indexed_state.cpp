@@ -25,15 +25,23 @@
 #include "../../../include/core/states/indexed_state.h"
 #include "../../../include/core/states/state_exception.h"
 
-unsigned int IndexedState::indexer = 0;
+Indexer IndexedState::indexer;
 
 IndexedState::IndexedState()
 {
-	// Assign the index of the state equal to the current value of
-	// indexer. Then, increment the indexer variable in preparation
-	// for the next one.
-	index = indexer;
-	indexer++;
+	// Assign the index of the state from the static indexer, which also increments it
+	// in preparation for the next one.
+	index = indexer.next();
+}
+
+IndexedState::IndexedState(Indexer &modelIndexer)
+{
+	index = modelIndexer.next();
+}
+
+IndexedState::IndexedState(unsigned int initialIndex)
+{
+	index = initialIndex;
 }
 
 IndexedState::IndexedState(const IndexedState &other)
@@ -71,10 +79,10 @@ unsigned int IndexedState::hash_value() const
 
 unsigned int IndexedState::get_num_states()
 {
-	return indexer;
+	return indexer.get_num_indexes();
 }
 
 void IndexedState::reset_indexer()
 {
-	indexer = 0;
+	indexer.reset();
 }
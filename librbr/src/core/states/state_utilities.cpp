@@ -23,48 +23,8 @@
 
 
 #include "../../../include/core/states/state_utilities.h"
-#include "../../../include/core/states/state_exception.h"
-
-#include "../../../include/core/states/named_state.h"
-#include "../../../include/core/states/factored_state.h"
 
 State *find_state(StatesMap *S, std::string stateName)
 {
-	for (auto stateIterator : *S) {
-		State *state = resolve(stateIterator);
-
-		// Try to cast the state as a NamedState. If it fails, it may still be a factored state.
-	    NamedState *s = dynamic_cast<NamedState *>(state);
-	    if (s == nullptr) {
-	    	// Try to cast it as a FactoredState.
-	    	FactoredState *fs = dynamic_cast<FactoredState *>(state);
-		    if (fs == nullptr) {
-		    	throw StateException();
-		    }
-
-		    // Construct the factored state name from the component names, separated by spaces.
-		    std::string fsName = "";
-	    	for (int i = 0; i < fs->get_num_states(); i++) {
-	    		s = dynamic_cast<NamedState *>(fs->get(i));
-	    		if (s == nullptr) {
-	    			throw StateException();
-	    		}
-
-	    		fsName += s->get_name();
-	    		if (i < fs->get_num_states() - 1) {
-	    			fsName += " ";
-	    		}
-	    	}
-
-    		if (fsName.compare(stateName) == 0) {
-	    		return fs;
-    		}
-	    } else {
-			if (s->get_name().compare(stateName) == 0) {
-				return state;
-			}
-	    }
-	}
-
-	throw StateException();
+	return S->get_by_name(stateName);
 }
@@ -25,7 +25,11 @@
 #include "../../../include/core/states/states_map.h"
 #include "../../../include/core/states/state_exception.h"
 
+#include "../../../include/core/states/named_state.h"
+#include "../../../include/core/states/factored_state.h"
+
 #include <algorithm>
+#include <typeinfo>
 
 StatesMap::StatesMap()
 { }
@@ -42,46 +46,91 @@ StatesMap::~StatesMap()
 
 void StatesMap::add(State *newState)
 {
-	states[newState->hash_value()] = newState;
+	// If an equivalent state was already interned, then the new one takes its place.
+	unsigned int index = find(newState);
+	if (index < states.size()) {
+		indices.erase(states[index]);
+		remove_name(states[index]);
+		states[index] = newState;
+		indices[newState] = index;
+		add_name(newState);
+		return;
+	}
+
+	index = states.size();
+	states.push_back(newState);
+	indices[newState] = index;
+	hashes.insert(std::make_pair(newState->hash_value(), index));
+	add_name(newState);
 }
 
 void StatesMap::remove(State *removeState)
 {
-	// Ensure that the element exists in the hash before removing it.
-	std::unordered_map<unsigned int, State *>::const_iterator result = states.find(removeState->hash_value());
-	if (result == states.end()) {
+	// Ensure that the element exists before removing it.
+	unsigned int index = find(removeState);
+	if (index == states.size()) {
 		throw StateException();
 	}
 
-	states.erase(removeState->hash_value());
-	delete removeState;
+	State *state = states[index];
+	states.erase(states.begin() + index);
+	remove_name(state);
+
+	// All states after the removed one shift down by one index, so rebuild the lookup tables.
+	indices.clear();
+	hashes.clear();
+	for (unsigned int i = 0; i < states.size(); i++) {
+		indices[states[i]] = i;
+		hashes.insert(std::make_pair(states[i]->hash_value(), i));
+	}
+
+	delete state;
 }
 
 void StatesMap::set(const std::vector<State *> &newStates)
 {
 	reset();
+	states.reserve(newStates.size());
 	for (State *state : newStates) {
-		states[state->hash_value()] = state;
+		add(state);
 	}
 }
 
 bool StatesMap::exists(const State *state) const
 {
-	try {
-		states.at(state->hash_value());
-	} catch (const std::out_of_range &err) {
-		return false;
-	}
-	return true;
+	return find(state) < states.size();
 }
 
 State *StatesMap::get(unsigned int hash)
 {
-	try {
-		return states.at(hash);
-	} catch (const std::out_of_range &err) {
+	// Equal ranges of a multimap are not ordered, so return the lowest index among them.
+	auto range = hashes.equal_range(hash);
+	if (range.first == range.second) {
+		throw StateException();
+	}
+
+	unsigned int index = range.first->second;
+	for (auto it = range.first; it != range.second; it++) {
+		index = std::min(index, it->second);
+	}
+	return states[index];
+}
+
+unsigned int StatesMap::get_index(const State *state) const
+{
+	unsigned int index = find(state);
+	if (index == states.size()) {
 		throw StateException();
 	}
+	return index;
+}
+
+State *StatesMap::get_state(unsigned int index) const
+{
+	if (index >= states.size()) {
+		throw StateException();
+	}
+	return states[index];
 }
 
 unsigned int StatesMap::get_num_states() const
@@ -91,28 +140,151 @@ unsigned int StatesMap::get_num_states() const
 
 void StatesMap::reset()
 {
-	for (auto state : states) {
-		delete resolve(state);
+	for (State *state : states) {
+		delete state;
 	}
+	clear();
+}
+
+StatesMapIterator StatesMap::begin() const
+{
+	return StatesMapIterator(this, 0);
+}
+
+StatesMapIterator StatesMap::end() const
+{
+	return StatesMapIterator(this, get_num_states());
+}
+
+void StatesMap::clear()
+{
 	states.clear();
+	indices.clear();
+	hashes.clear();
+	names.clear();
+}
+
+bool StatesMap::equivalent(const State *a, const State *b)
+{
+	if (a == b) {
+		return true;
+	}
+	return typeid(*a) == typeid(*b) && a->hash_value() == b->hash_value() && a->to_string() == b->to_string();
+}
+
+unsigned int StatesMap::find(const State *state) const
+{
+	// The common case is looking up a state which is itself interned.
+	std::unordered_map<const State *, unsigned int>::const_iterator result = indices.find(state);
+	if (result != indices.end()) {
+		return result->second;
+	}
+
+	// Otherwise, compare against every state which shares its hash value.
+	auto range = hashes.equal_range(state->hash_value());
+	for (auto it = range.first; it != range.second; it++) {
+		if (equivalent(states[it->second], state)) {
+			return it->second;
+		}
+	}
+
+	return states.size();
+}
+
+State *StatesMap::get_by_name(const std::string &name) const
+{
+	std::unordered_map<std::string, State *>::const_iterator result = names.find(name);
+	if (result == names.end()) {
+		throw StateException();
+	}
+	return result->second;
+}
+
+void StatesMap::add_name(State *state)
+{
+	// The first state with a particular name is kept, matching the order of a linear search.
+	std::string name;
+	if (get_name(state, name)) {
+		names.insert(std::make_pair(name, state));
+	}
+}
+
+void StatesMap::remove_name(State *state)
+{
+	std::string name;
+	if (!get_name(state, name)) {
+		return;
+	}
+
+	std::unordered_map<std::string, State *>::iterator result = names.find(name);
+	if (result != names.end() && result->second == state) {
+		names.erase(result);
+	}
+}
+
+bool StatesMap::get_name(State *state, std::string &name)
+{
+	NamedState *n = dynamic_cast<NamedState *>(state);
+	if (n != nullptr) {
+		name = n->get_name();
+		return true;
+	}
+
+	FactoredState *j = dynamic_cast<FactoredState *>(state);
+	if (j == nullptr) {
+		return false;
+	}
+
+	// Construct the name from the component names, separated by spaces.
+	name = "";
+	for (int i = 0; i < j->get_num_states(); i++) {
+		n = dynamic_cast<NamedState *>(j->get(i));
+		if (n == nullptr) {
+			return false;
+		}
+
+		name += n->get_name();
+		if (i < j->get_num_states() - 1) {
+			name += " ";
+		}
+	}
+
+	return true;
+}
+
+StatesMapIterator::StatesMapIterator(const StatesMap *statesMap, unsigned int index)
+{
+	this->statesMap = statesMap;
+	this->index = index;
+}
+
+State *StatesMapIterator::operator*() const
+{
+	return statesMap->get_state(index);
+}
+
+StatesMapIterator &StatesMapIterator::operator++()
+{
+	index++;
+	return *this;
 }
 
-std::unordered_map<unsigned int, State *>::iterator StatesMap::begin()
+bool StatesMapIterator::operator==(const StatesMapIterator &other) const
 {
-	return states.begin();
+	return statesMap == other.statesMap && index == other.index;
 }
 
-std::unordered_map<unsigned int, State *>::iterator StatesMap::end()
+bool StatesMapIterator::operator!=(const StatesMapIterator &other) const
 {
-	return states.end();
+	return !(*this == other);
 }
 
-State *resolve(std::unordered_map<unsigned int, State *>::value_type &stateIterator)
+State *resolve(State *stateIterator)
 {
-	return stateIterator.second;
+	return stateIterator;
 }
 
-unsigned int hash_value(std::unordered_map<unsigned int, State *>::value_type &stateIterator)
+unsigned int hash_value(State *stateIterator)
 {
-	return stateIterator.first;
+	return stateIterator->hash_value();
 }
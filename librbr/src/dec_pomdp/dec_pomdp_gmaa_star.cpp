@@ -0,0 +1,734 @@
+/**
+ *  The MIT License (MIT)
+ *
+ *  Copyright (c) 2014 Kyle Hollins Wray, University of Massachusetts
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy of
+ *  this software and associated documentation files (the "Software"), to deal in
+ *  the Software without restriction, including without limitation the rights to
+ *  use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ *  the Software, and to permit persons to whom the Software is furnished to do so,
+ *  subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included in all
+ *  copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ *  FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ *  COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ *  IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ *  CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+
+#include "../../include/dec_pomdp/dec_pomdp_gmaa_star.h"
+
+#include "../../include/core/core_exception.h"
+#include "../../include/core/states/state_exception.h"
+#include "../../include/core/actions/action_exception.h"
+#include "../../include/core/actions/joint_action.h"
+#include "../../include/core/observations/observation_exception.h"
+#include "../../include/core/observations/joint_observation.h"
+#include "../../include/core/state_transitions/state_transition_exception.h"
+#include "../../include/core/observation_transitions/observation_transition_exception.h"
+#include "../../include/core/rewards/reward_exception.h"
+#include "../../include/core/policy/policy_exception.h"
+
+#include <algorithm>
+#include <limits>
+#include <math.h>
+
+/**
+ * The ordering of nodes on the open list: the largest upper bound first, breaking ties in favor
+ * of deeper nodes so that complete joint policies are found as early as possible.
+ */
+static bool gmaa_star_node_less(const DecPOMDPGMAAStarNode *a, const DecPOMDPGMAAStarNode *b)
+{
+	if (a->f == b->f) {
+		return a->depth < b->depth;
+	}
+	return a->f < b->f;
+}
+
+DecPOMDPGMAAStar::DecPOMDPGMAAStar()
+{
+	incremental = true;
+	value = 0.0;
+	numNodesExpanded = 0;
+	maxOpenListSize = 0;
+	horizon = 0;
+	gamma = 1.0;
+}
+
+DecPOMDPGMAAStar::DecPOMDPGMAAStar(bool incrementalExpansion)
+{
+	incremental = incrementalExpansion;
+	value = 0.0;
+	numNodesExpanded = 0;
+	maxOpenListSize = 0;
+	horizon = 0;
+	gamma = 1.0;
+}
+
+DecPOMDPGMAAStar::~DecPOMDPGMAAStar()
+{ }
+
+void DecPOMDPGMAAStar::set_initial_belief(const BeliefState &belief)
+{
+	initialBelief = belief;
+}
+
+void DecPOMDPGMAAStar::set_incremental_expansion(bool incrementalExpansion)
+{
+	incremental = incrementalExpansion;
+}
+
+bool DecPOMDPGMAAStar::get_incremental_expansion() const
+{
+	return incremental;
+}
+
+double DecPOMDPGMAAStar::get_value() const
+{
+	return value;
+}
+
+unsigned int DecPOMDPGMAAStar::get_num_nodes_expanded() const
+{
+	return numNodesExpanded;
+}
+
+unsigned int DecPOMDPGMAAStar::get_max_open_list_size() const
+{
+	return maxOpenListSize;
+}
+
+std::vector<PolicyTree *> DecPOMDPGMAAStar::solve(DecPOMDP *decpomdp)
+{
+	// Handle the trivial case.
+	if (decpomdp == nullptr) {
+		throw CoreException();
+	}
+
+	// Ensure there are agents.
+	Agents *N = decpomdp->get_agents();
+	if (N == nullptr || N->get_num_agents() == 0) {
+		throw CoreException();
+	}
+
+	// Attempt to convert the states object into StatesMap.
+	StatesMap *S = dynamic_cast<StatesMap *>(decpomdp->get_states());
+	if (S == nullptr) {
+		throw StateException();
+	}
+
+	// Attempt to convert the actions object into JointActionsMap.
+	JointActionsMap *A = dynamic_cast<JointActionsMap *>(decpomdp->get_actions());
+	if (A == nullptr || A->get_num_factors() != N->get_num_agents()) {
+		throw ActionException();
+	}
+
+	// Attempt to convert the observations object into JointObservationsMap.
+	JointObservationsMap *Z = dynamic_cast<JointObservationsMap *>(decpomdp->get_observations());
+	if (Z == nullptr || Z->get_num_factors() != N->get_num_agents()) {
+		throw ObservationException();
+	}
+
+	// Attempt to get the state transitions.
+	StateTransitions *T = decpomdp->get_state_transitions();
+	if (T == nullptr) {
+		throw StateTransitionException();
+	}
+
+	// Attempt to get the observations transitions.
+	ObservationTransitions *O = decpomdp->get_observation_transitions();
+	if (O == nullptr) {
+		throw ObservationTransitionException();
+	}
+
+	// Attempt to convert the rewards object into SASRewards.
+	SASRewards *R = dynamic_cast<SASRewards *>(decpomdp->get_rewards());
+	if (R == nullptr) {
+		throw RewardException();
+	}
+
+	// GMAA* only applies to finite horizons.
+	Horizon *h = decpomdp->get_horizon();
+	if (h == nullptr || !h->is_finite()) {
+		throw CoreException();
+	}
+
+	return solve_finite_horizon(N, S, A, Z, T, O, R, h);
+}
+
+std::vector<PolicyTree *> DecPOMDPGMAAStar::solve_finite_horizon(Agents *N, StatesMap *S, JointActionsMap *A,
+		JointObservationsMap *Z, StateTransitions *T, ObservationTransitions *O, SASRewards *R,
+		Horizon *h)
+{
+	unsigned int numAgents = N->get_num_agents();
+
+	horizon = h->get_horizon();
+	gamma = h->get_discount_factor();
+
+	value = 0.0;
+	numNodesExpanded = 0;
+	maxOpenListSize = 0;
+
+	// Index the states, and each agent's local actions and observations.
+	states.clear();
+	for (auto s : *S) {
+		states.push_back(resolve(s));
+	}
+
+	numAgentActions.clear();
+	numAgentObservations.clear();
+	for (unsigned int i = 0; i < numAgents; i++) {
+		numAgentActions.push_back(A->get_factor(i).size());
+		numAgentObservations.push_back(Z->get_factor(i).size());
+	}
+
+	// Index the joint actions and joint observations by their agents' local indices.
+	jointActions.clear();
+	jointActions.resize(A->get_num_actions(), nullptr);
+
+	for (auto a : *A) {
+		JointAction *ja = dynamic_cast<JointAction *>(resolve(a));
+		if (ja == nullptr || ja->get_num_actions() != numAgents) {
+			throw ActionException();
+		}
+
+		unsigned int index = 0;
+		for (unsigned int i = 0; i < numAgents; i++) {
+			const std::vector<Action *> &factor = A->get_factor(i);
+			std::vector<Action *>::const_iterator result = std::find(factor.begin(), factor.end(), ja->get(i));
+			if (result == factor.end()) {
+				throw ActionException();
+			}
+			index = index * numAgentActions[i] + (unsigned int)(result - factor.begin());
+		}
+
+		jointActions[index] = ja;
+	}
+
+	jointObservations.clear();
+	jointObservations.resize(Z->get_num_observations(), nullptr);
+
+	for (auto z : *Z) {
+		JointObservation *jz = dynamic_cast<JointObservation *>(resolve(z));
+		if (jz == nullptr || jz->get_num_observations() != (int)numAgents) {
+			throw ObservationException();
+		}
+
+		unsigned int index = 0;
+		for (unsigned int i = 0; i < numAgents; i++) {
+			const std::vector<Observation *> &factor = Z->get_factor(i);
+			std::vector<Observation *>::const_iterator result = std::find(factor.begin(), factor.end(), jz->get(i));
+			if (result == factor.end()) {
+				throw ObservationException();
+			}
+			index = index * numAgentObservations[i] + (unsigned int)(result - factor.begin());
+		}
+
+		jointObservations[index] = jz;
+	}
+
+	compute_model(T, O, R);
+
+	unsigned int n = states.size();
+	unsigned int m = jointActions.size();
+
+	// The root is the empty joint policy; its occupancy is the initial belief.
+	DecPOMDPGMAAStarNode *root = new DecPOMDPGMAAStarNode();
+	root->depth = 0;
+	root->policy.resize(numAgents);
+	root->g = 0.0;
+	root->expanded = false;
+	root->occupancy.resize(n, 0.0);
+
+	if (initialBelief.get_states().size() == 0) {
+		for (unsigned int s = 0; s < n; s++) {
+			root->occupancy[s] = 1.0 / (double)n;
+		}
+	} else {
+		for (unsigned int s = 0; s < n; s++) {
+			root->occupancy[s] = initialBelief.get(states[s]);
+		}
+	}
+
+	root->f = std::numeric_limits<double>::lowest();
+	for (unsigned int a = 0; a < m; a++) {
+		double Qba = 0.0;
+		for (unsigned int s = 0; s < n; s++) {
+			Qba += root->occupancy[s] * Q[horizon - 1][s * m + a];
+		}
+		root->f = std::max(root->f, Qba);
+	}
+
+	// The open list is a max-heap of partial joint policies ordered by their upper bounds.
+	std::vector<DecPOMDPGMAAStarNode *> open;
+	open.push_back(root);
+
+	double lowerBound = std::numeric_limits<double>::lowest();
+	DecPOMDPGMAAStarNode *solution = nullptr;
+
+	while (!open.empty()) {
+		std::pop_heap(open.begin(), open.end(), gmaa_star_node_less);
+		DecPOMDPGMAAStarNode *node = open.back();
+		open.pop_back();
+
+		// A complete joint policy has an exact value, which is at least every other upper bound.
+		if (node->depth == horizon) {
+			solution = node;
+			break;
+		}
+
+		if (!node->expanded) {
+			generate_children(node, lowerBound);
+			node->expanded = true;
+			numNodesExpanded++;
+		}
+
+		// Materialize either only the best child or all of them, discarding those which cannot beat
+		// the best complete joint policy found so far.
+		while (!node->children.empty() && node->children.back().first >= lowerBound) {
+			DecPOMDPGMAAStarNode *child = create_child(node, node->children.back().second,
+					node->children.back().first);
+			node->children.pop_back();
+
+			if (child->depth == horizon) {
+				lowerBound = std::max(lowerBound, child->f);
+			}
+
+			open.push_back(child);
+			std::push_heap(open.begin(), open.end(), gmaa_star_node_less);
+
+			if (incremental) {
+				break;
+			}
+		}
+
+		// With incremental expansion, the parent stands in for its remaining children.
+		if (!node->children.empty() && node->children.back().first >= lowerBound) {
+			node->f = node->children.back().first;
+			open.push_back(node);
+			std::push_heap(open.begin(), open.end(), gmaa_star_node_less);
+		} else {
+			delete node;
+		}
+
+		maxOpenListSize = std::max(maxOpenListSize, (unsigned int)open.size());
+	}
+
+	for (DecPOMDPGMAAStarNode *node : open) {
+		delete node;
+	}
+	open.clear();
+
+	if (solution == nullptr) {
+		throw PolicyException();
+	}
+
+	value = solution->g;
+
+	// Convert the solution into a policy tree for each agent.
+	std::vector<PolicyTree *> policies;
+
+	for (unsigned int i = 0; i < numAgents; i++) {
+		const std::vector<Action *> &agentActions = A->get_factor(i);
+		const std::vector<Observation *> &agentObservations = Z->get_factor(i);
+		unsigned int z = numAgentObservations[i];
+
+		PolicyTree *tree = new PolicyTree(agentObservations, horizon);
+
+		unsigned int offset = 0;
+		unsigned int numHistories = 1;
+
+		for (unsigned int k = 0; k < horizon; k++) {
+			for (unsigned int hi = 0; hi < numHistories; hi++) {
+				// Decode the history index into its sequence of observations, most recent last.
+				std::vector<Observation *> history(k, nullptr);
+				unsigned int remaining = hi;
+				for (int j = (int)k - 1; j >= 0; j--) {
+					history[j] = agentObservations[remaining % z];
+					remaining /= z;
+				}
+
+				tree->set(history, agentActions[solution->policy[i][offset + hi]]);
+			}
+
+			offset += numHistories;
+			numHistories *= z;
+		}
+
+		policies.push_back(tree);
+	}
+
+	delete solution;
+
+	return policies;
+}
+
+void DecPOMDPGMAAStar::compute_model(StateTransitions *T, ObservationTransitions *O, SASRewards *R)
+{
+	unsigned int n = states.size();
+	unsigned int m = jointActions.size();
+	unsigned int z = jointObservations.size();
+
+	Tsas.assign(n * m * n, 0.0);
+	Oaso.assign(m * n * z, 0.0);
+	Rsa.assign(n * m, 0.0);
+
+	for (unsigned int s = 0; s < n; s++) {
+		for (unsigned int a = 0; a < m; a++) {
+			for (unsigned int sp = 0; sp < n; sp++) {
+				double p = T->get(states[s], jointActions[a], states[sp]);
+				Tsas[s * m * n + a * n + sp] = p;
+				Rsa[s * m + a] += p * R->get(states[s], jointActions[a], states[sp]);
+			}
+		}
+	}
+
+	for (unsigned int a = 0; a < m; a++) {
+		for (unsigned int sp = 0; sp < n; sp++) {
+			for (unsigned int o = 0; o < z; o++) {
+				Oaso[a * n * z + sp * z + o] = O->get(jointActions[a], states[sp], jointObservations[o]);
+			}
+		}
+	}
+
+	// Compute the finite horizon MDP Q-values for each number of remaining stages.
+	Q.clear();
+	Q.resize(horizon);
+	Q[0] = Rsa;
+
+	std::vector<double> V(n, 0.0);
+
+	for (unsigned int k = 1; k < horizon; k++) {
+		for (unsigned int s = 0; s < n; s++) {
+			V[s] = std::numeric_limits<double>::lowest();
+			for (unsigned int a = 0; a < m; a++) {
+				V[s] = std::max(V[s], Q[k - 1][s * m + a]);
+			}
+		}
+
+		Q[k].resize(n * m);
+		for (unsigned int s = 0; s < n; s++) {
+			for (unsigned int a = 0; a < m; a++) {
+				double future = 0.0;
+				for (unsigned int sp = 0; sp < n; sp++) {
+					future += Tsas[s * m * n + a * n + sp] * V[sp];
+				}
+				Q[k][s * m + a] = Rsa[s * m + a] + gamma * future;
+			}
+		}
+	}
+}
+
+void DecPOMDPGMAAStar::generate_children(DecPOMDPGMAAStarNode *node, double lowerBound)
+{
+	unsigned int numAgents = numAgentActions.size();
+	unsigned int n = states.size();
+	unsigned int m = jointActions.size();
+	unsigned int t = node->depth;
+
+	// Compute the number of local histories for each agent at this depth, and the number of digits
+	// (one per agent's local history) and total number of joint decision rules.
+	std::vector<unsigned int> numHistories(numAgents, 1);
+	for (unsigned int i = 0; i < numAgents; i++) {
+		for (unsigned int k = 0; k < t; k++) {
+			numHistories[i] *= numAgentObservations[i];
+		}
+	}
+
+	unsigned int numJointHistories = node->occupancy.size() / n;
+
+	// Each joint decision rule is a mixed-radix number with one digit per (agent, local history);
+	// agent 0's first history is the most significant digit. Ensure they can all be encoded.
+	std::vector<unsigned int> radix;
+	std::vector<unsigned int> digitOffset(numAgents, 0);
+	unsigned long long numRules = 1;
+
+	for (unsigned int i = 0; i < numAgents; i++) {
+		digitOffset[i] = radix.size();
+		for (unsigned int hi = 0; hi < numHistories[i]; hi++) {
+			if (numRules > std::numeric_limits<unsigned long long>::max() / numAgentActions[i]) {
+				throw PolicyException();
+			}
+			numRules *= numAgentActions[i];
+			radix.push_back(numAgentActions[i]);
+		}
+	}
+
+	// For each reachable joint history, compute the value of each joint action under the QMDP
+	// bound for the remaining stages, as well as each agent's local history index.
+	double discount = pow(gamma, (double)t);
+
+	std::vector<unsigned int> reachable;
+	std::vector<double> term;
+	std::vector<unsigned int> localHistory;
+
+	for (unsigned int theta = 0; theta < numJointHistories; theta++) {
+		double probability = 0.0;
+		for (unsigned int s = 0; s < n; s++) {
+			probability += node->occupancy[theta * n + s];
+		}
+		if (probability <= 0.0) {
+			continue;
+		}
+
+		reachable.push_back(theta);
+
+		for (unsigned int a = 0; a < m; a++) {
+			double Qba = 0.0;
+			for (unsigned int s = 0; s < n; s++) {
+				Qba += node->occupancy[theta * n + s] * Q[horizon - t - 1][s * m + a];
+			}
+			term.push_back(discount * Qba);
+		}
+
+		unsigned int remaining = theta;
+		std::vector<unsigned int> local(numAgents, 0);
+		for (int i = (int)numAgents - 1; i >= 0; i--) {
+			local[i] = remaining % numHistories[i];
+			remaining /= numHistories[i];
+		}
+		localHistory.insert(localHistory.end(), local.begin(), local.end());
+	}
+
+	unsigned int numReachable = reachable.size();
+
+	// The joint action index is mixed-radix over the agents' local action indices.
+	std::vector<unsigned int> actionWeight(numAgents, 1);
+	for (int i = (int)numAgents - 2; i >= 0; i--) {
+		actionWeight[i] = actionWeight[i + 1] * numAgentActions[i + 1];
+	}
+
+	std::vector<unsigned int> digits(radix.size(), 0);
+
+	node->children.clear();
+
+	if (t + 1 == horizon) {
+		// At the final stage the bound is exact, so only the best child matters. Enumerate the decision
+		// rules of all but the last agent; the last agent's best response decomposes over its local
+		// histories, so it is chosen history by history.
+		unsigned int last = numAgents - 1;
+		unsigned int numPrefixDigits = digitOffset[last];
+
+		double bestValue = std::numeric_limits<double>::lowest();
+		std::vector<unsigned int> bestDigits;
+
+		std::vector<double> response(numHistories[last] * numAgentActions[last], 0.0);
+
+		while (true) {
+			std::fill(response.begin(), response.end(), 0.0);
+
+			for (unsigned int r = 0; r < numReachable; r++) {
+				unsigned int prefix = 0;
+				for (unsigned int i = 0; i < last; i++) {
+					prefix += digits[digitOffset[i] + localHistory[r * numAgents + i]] * actionWeight[i];
+				}
+
+				unsigned int hLast = localHistory[r * numAgents + last];
+				for (unsigned int aLast = 0; aLast < numAgentActions[last]; aLast++) {
+					response[hLast * numAgentActions[last] + aLast] += term[r * m + prefix + aLast];
+				}
+			}
+
+			double total = 0.0;
+			for (unsigned int hLast = 0; hLast < numHistories[last]; hLast++) {
+				unsigned int aBest = 0;
+				for (unsigned int aLast = 1; aLast < numAgentActions[last]; aLast++) {
+					if (response[hLast * numAgentActions[last] + aLast] >
+							response[hLast * numAgentActions[last] + aBest]) {
+						aBest = aLast;
+					}
+				}
+				digits[numPrefixDigits + hLast] = aBest;
+				total += response[hLast * numAgentActions[last] + aBest];
+			}
+
+			if (total > bestValue) {
+				bestValue = total;
+				bestDigits = digits;
+			}
+
+			// Increment the prefix digits; stop once they have all wrapped around.
+			int d = (int)numPrefixDigits - 1;
+			for (; d >= 0; d--) {
+				digits[d]++;
+				if (digits[d] < radix[d]) {
+					break;
+				}
+				digits[d] = 0;
+			}
+			if (d < 0) {
+				break;
+			}
+		}
+
+		double f = node->g + bestValue;
+		if (f >= lowerBound) {
+			unsigned long long rule = 0;
+			for (unsigned int d = 0; d < radix.size(); d++) {
+				rule = rule * radix[d] + bestDigits[d];
+			}
+			node->children.push_back(std::pair<double, unsigned long long>(f, rule));
+		}
+
+		return;
+	}
+
+	// Otherwise, score every joint decision rule for this stage.
+	for (unsigned long long rule = 0; rule < numRules; rule++) {
+		double total = 0.0;
+		for (unsigned int r = 0; r < numReachable; r++) {
+			unsigned int a = 0;
+			for (unsigned int i = 0; i < numAgents; i++) {
+				a += digits[digitOffset[i] + localHistory[r * numAgents + i]] * actionWeight[i];
+			}
+			total += term[r * m + a];
+		}
+
+		double f = node->g + total;
+		if (f >= lowerBound) {
+			node->children.push_back(std::pair<double, unsigned long long>(f, rule));
+		}
+
+		for (int d = (int)radix.size() - 1; d >= 0; d--) {
+			digits[d]++;
+			if (digits[d] < radix[d]) {
+				break;
+			}
+			digits[d] = 0;
+		}
+	}
+
+	// Sort from worst to best, so that the best child is at the back.
+	std::sort(node->children.begin(), node->children.end());
+}
+
+DecPOMDPGMAAStarNode *DecPOMDPGMAAStar::create_child(DecPOMDPGMAAStarNode *parent, unsigned long long rule,
+		double f)
+{
+	unsigned int numAgents = numAgentActions.size();
+	unsigned int n = states.size();
+	unsigned int m = jointActions.size();
+	unsigned int z = jointObservations.size();
+	unsigned int t = parent->depth;
+
+	std::vector<unsigned int> numHistories(numAgents, 1);
+	unsigned int numDigits = 0;
+	for (unsigned int i = 0; i < numAgents; i++) {
+		for (unsigned int k = 0; k < t; k++) {
+			numHistories[i] *= numAgentObservations[i];
+		}
+		numDigits += numHistories[i];
+	}
+
+	// Decode the rule's digits, least significant (the last agent's last history) first.
+	std::vector<unsigned int> digits(numDigits, 0);
+	for (int i = (int)numAgents - 1, d = (int)numDigits - 1; i >= 0; i--) {
+		for (unsigned int hi = 0; hi < numHistories[i]; hi++, d--) {
+			digits[d] = (unsigned int)(rule % numAgentActions[i]);
+			rule /= numAgentActions[i];
+		}
+	}
+
+	DecPOMDPGMAAStarNode *child = new DecPOMDPGMAAStarNode();
+	child->depth = t + 1;
+	child->policy = parent->policy;
+	child->f = f;
+	child->expanded = false;
+
+	unsigned int d = 0;
+	for (unsigned int i = 0; i < numAgents; i++) {
+		child->policy[i].insert(child->policy[i].end(), digits.begin() + d, digits.begin() + d + numHistories[i]);
+		d += numHistories[i];
+	}
+
+	// The stage t decision rule's local actions, and each joint observation's local observations.
+	std::vector<unsigned int> actionWeight(numAgents, 1);
+	for (int i = (int)numAgents - 2; i >= 0; i--) {
+		actionWeight[i] = actionWeight[i + 1] * numAgentActions[i + 1];
+	}
+
+	std::vector<unsigned int> localObservation(z * numAgents, 0);
+	for (unsigned int o = 0; o < z; o++) {
+		unsigned int remaining = o;
+		for (int i = (int)numAgents - 1; i >= 0; i--) {
+			localObservation[o * numAgents + i] = remaining % numAgentObservations[i];
+			remaining /= numAgentObservations[i];
+		}
+	}
+
+	unsigned int numJointHistories = parent->occupancy.size() / n;
+	bool terminal = (child->depth == horizon);
+
+	unsigned int numNextJointHistories = numJointHistories * z;
+	if (!terminal) {
+		child->occupancy.assign(numNextJointHistories * n, 0.0);
+	}
+
+	double discount = pow(gamma, (double)t);
+	double reward = 0.0;
+
+	std::vector<unsigned int> local(numAgents, 0);
+
+	for (unsigned int theta = 0; theta < numJointHistories; theta++) {
+		// Recover each agent's local history, and the joint action it takes.
+		unsigned int remaining = theta;
+		for (int i = (int)numAgents - 1; i >= 0; i--) {
+			local[i] = remaining % numHistories[i];
+			remaining /= numHistories[i];
+		}
+
+		unsigned int a = 0;
+		unsigned int offset = 0;
+		for (unsigned int i = 0; i < numAgents; i++) {
+			a += digits[offset + local[i]] * actionWeight[i];
+			offset += numHistories[i];
+		}
+
+		for (unsigned int s = 0; s < n; s++) {
+			double p = parent->occupancy[theta * n + s];
+			if (p <= 0.0) {
+				continue;
+			}
+
+			reward += p * Rsa[s * m + a];
+
+			if (terminal) {
+				continue;
+			}
+
+			// Propagate this mass through the transition and observation functions. The next local
+			// history of agent i is local[i] * |Z_i| + o_i.
+			for (unsigned int sp = 0; sp < n; sp++) {
+				double pT = p * Tsas[s * m * n + a * n + sp];
+				if (pT <= 0.0) {
+					continue;
+				}
+
+				for (unsigned int o = 0; o < z; o++) {
+					double pO = pT * Oaso[a * n * z + sp * z + o];
+					if (pO <= 0.0) {
+						continue;
+					}
+
+					unsigned int thetap = 0;
+					for (unsigned int i = 0; i < numAgents; i++) {
+						thetap = thetap * numHistories[i] * numAgentObservations[i] +
+								local[i] * numAgentObservations[i] + localObservation[o * numAgents + i];
+					}
+
+					child->occupancy[thetap * n + sp] += pO;
+				}
+			}
+		}
+	}
+
+	child->g = parent->g + discount * reward;
+
+	return child;
+}
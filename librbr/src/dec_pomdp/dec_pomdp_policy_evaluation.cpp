@@ -0,0 +1,490 @@
+/**
+ *  The MIT License (MIT)
+ *
+ *  Copyright (c) 2014 Kyle Hollins Wray, University of Massachusetts
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy of
+ *  this software and associated documentation files (the "Software"), to deal in
+ *  the Software without restriction, including without limitation the rights to
+ *  use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ *  the Software, and to permit persons to whom the Software is furnished to do so,
+ *  subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included in all
+ *  copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ *  FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ *  COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ *  IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ *  CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+
+#include "../../include/dec_pomdp/dec_pomdp_policy_evaluation.h"
+
+#include "../../include/core/core_exception.h"
+#include "../../include/core/states/states_map.h"
+#include "../../include/core/states/state_exception.h"
+#include "../../include/core/actions/joint_actions_map.h"
+#include "../../include/core/actions/joint_action.h"
+#include "../../include/core/actions/action_exception.h"
+#include "../../include/core/observations/joint_observations_map.h"
+#include "../../include/core/observations/joint_observation.h"
+#include "../../include/core/observations/observation_exception.h"
+#include "../../include/core/state_transitions/state_transitions.h"
+#include "../../include/core/state_transitions/state_transition_exception.h"
+#include "../../include/core/observation_transitions/observation_transitions.h"
+#include "../../include/core/observation_transitions/observation_transition_exception.h"
+#include "../../include/core/rewards/sas_rewards.h"
+#include "../../include/core/rewards/reward_exception.h"
+#include "../../include/core/policy/policy_exception.h"
+
+#include <algorithm>
+#include <thread>
+
+/**
+ * The minimum number of (joint node, state) pairs in a depth before it is split among threads.
+ */
+#ifndef DEC_POMDP_POLICY_EVALUATION_MIN_PARALLEL_WORK
+#define DEC_POMDP_POLICY_EVALUATION_MIN_PARALLEL_WORK 4096
+#endif
+
+std::size_t DecPOMDPPolicyEvaluationKeyHash::operator()(const std::vector<unsigned int> &key) const
+{
+	std::size_t hash = 7;
+	for (unsigned int k : key) {
+		hash = 31 * hash + k;
+	}
+	return hash;
+}
+
+DecPOMDPPolicyEvaluation::DecPOMDPPolicyEvaluation(DecPOMDP *decpomdp) :
+		DecPOMDPPolicyEvaluation(decpomdp, std::max(1U, std::thread::hardware_concurrency()))
+{ }
+
+DecPOMDPPolicyEvaluation::DecPOMDPPolicyEvaluation(DecPOMDP *decpomdp, unsigned int numThreads)
+{
+	threads = std::max(1U, numThreads);
+
+	// Handle the trivial case.
+	if (decpomdp == nullptr) {
+		throw CoreException();
+	}
+
+	// Ensure there are agents.
+	Agents *N = decpomdp->get_agents();
+	if (N == nullptr || N->get_num_agents() == 0) {
+		throw CoreException();
+	}
+	unsigned int numAgents = N->get_num_agents();
+
+	// Attempt to convert the states object into StatesMap.
+	StatesMap *S = dynamic_cast<StatesMap *>(decpomdp->get_states());
+	if (S == nullptr) {
+		throw StateException();
+	}
+
+	// Attempt to convert the actions object into JointActionsMap.
+	JointActionsMap *A = dynamic_cast<JointActionsMap *>(decpomdp->get_actions());
+	if (A == nullptr || A->get_num_factors() != numAgents) {
+		throw ActionException();
+	}
+
+	// Attempt to convert the observations object into JointObservationsMap.
+	JointObservationsMap *Z = dynamic_cast<JointObservationsMap *>(decpomdp->get_observations());
+	if (Z == nullptr || Z->get_num_factors() != numAgents) {
+		throw ObservationException();
+	}
+
+	// Attempt to get the state transitions.
+	StateTransitions *T = decpomdp->get_state_transitions();
+	if (T == nullptr) {
+		throw StateTransitionException();
+	}
+
+	// Attempt to get the observations transitions.
+	ObservationTransitions *O = decpomdp->get_observation_transitions();
+	if (O == nullptr) {
+		throw ObservationTransitionException();
+	}
+
+	// Attempt to convert the rewards object into SASRewards.
+	SASRewards *R = dynamic_cast<SASRewards *>(decpomdp->get_rewards());
+	if (R == nullptr) {
+		throw RewardException();
+	}
+
+	gamma = decpomdp->get_horizon()->get_discount_factor();
+
+	// Index the states, and each agent's local actions and observations.
+	for (auto s : *S) {
+		stateIndices[resolve(s)] = states.size();
+		states.push_back(resolve(s));
+	}
+
+	agentActions.resize(numAgents);
+	for (unsigned int i = 0; i < numAgents; i++) {
+		const std::vector<Action *> &factor = A->get_factor(i);
+		for (unsigned int k = 0; k < factor.size(); k++) {
+			agentActions[i][factor[k]] = k;
+		}
+		agentObservations.push_back(Z->get_factor(i));
+	}
+
+	unsigned int n = states.size();
+	unsigned int m = A->get_num_actions();
+	unsigned int z = Z->get_num_observations();
+
+	// Index the joint actions and joint observations by their agents' local indices.
+	std::vector<Action *> orderedJointActions(m, nullptr);
+
+	for (auto a : *A) {
+		JointAction *ja = dynamic_cast<JointAction *>(resolve(a));
+		if (ja == nullptr || ja->get_num_actions() != numAgents) {
+			throw ActionException();
+		}
+
+		unsigned int index = 0;
+		for (unsigned int i = 0; i < numAgents; i++) {
+			std::unordered_map<Action *, unsigned int>::iterator result = agentActions[i].find(ja->get(i));
+			if (result == agentActions[i].end()) {
+				throw ActionException();
+			}
+			index = index * agentActions[i].size() + result->second;
+		}
+
+		orderedJointActions[index] = ja;
+	}
+
+	std::vector<Observation *> orderedJointObservations(z, nullptr);
+
+	for (auto o : *Z) {
+		JointObservation *jz = dynamic_cast<JointObservation *>(resolve(o));
+		if (jz == nullptr || jz->get_num_observations() != (int)numAgents) {
+			throw ObservationException();
+		}
+
+		unsigned int index = 0;
+		for (unsigned int i = 0; i < numAgents; i++) {
+			std::vector<Observation *>::iterator result = std::find(agentObservations[i].begin(),
+					agentObservations[i].end(), jz->get(i));
+			if (result == agentObservations[i].end()) {
+				throw ObservationException();
+			}
+			index = index * agentObservations[i].size() + (unsigned int)(result - agentObservations[i].begin());
+		}
+
+		orderedJointObservations[index] = jz;
+	}
+
+	// Store the expected rewards, and only the non-zero transition and observation probabilities.
+	Rsa.assign(n * m, 0.0);
+	successors.resize(n * m);
+	observations.resize(m * n);
+
+	for (unsigned int s = 0; s < n; s++) {
+		for (unsigned int a = 0; a < m; a++) {
+			for (unsigned int sp = 0; sp < n; sp++) {
+				double p = T->get(states[s], orderedJointActions[a], states[sp]);
+				if (p > 0.0) {
+					successors[s * m + a].push_back(std::pair<unsigned int, double>(sp, p));
+					Rsa[s * m + a] += p * R->get(states[s], orderedJointActions[a], states[sp]);
+				}
+			}
+		}
+	}
+
+	for (unsigned int a = 0; a < m; a++) {
+		for (unsigned int sp = 0; sp < n; sp++) {
+			for (unsigned int o = 0; o < z; o++) {
+				double p = O->get(orderedJointActions[a], states[sp], orderedJointObservations[o]);
+				if (p > 0.0) {
+					observations[a * n + sp].push_back(std::pair<unsigned int, double>(o, p));
+				}
+			}
+		}
+	}
+
+	nodeIDs.resize(numAgents);
+	nodes.resize(numAgents);
+	roots.resize(numAgents, -1);
+}
+
+DecPOMDPPolicyEvaluation::~DecPOMDPPolicyEvaluation()
+{ }
+
+void DecPOMDPPolicyEvaluation::set_policies(const std::vector<PolicyTree *> &policies)
+{
+	if (policies.size() != roots.size()) {
+		throw PolicyException();
+	}
+
+	for (unsigned int i = 0; i < policies.size(); i++) {
+		set_policy(i, policies[i]);
+	}
+}
+
+void DecPOMDPPolicyEvaluation::set_policy(unsigned int agentIndex, PolicyTree *policy)
+{
+	if (agentIndex >= roots.size() || policy == nullptr || policy->get_root() == nullptr) {
+		throw PolicyException();
+	}
+
+	roots[agentIndex] = (int)compile(agentIndex, policy->get_root());
+}
+
+double DecPOMDPPolicyEvaluation::evaluate(State *state)
+{
+	std::unordered_map<State *, unsigned int>::iterator result = stateIndices.find(state);
+	if (result == stateIndices.end()) {
+		throw StateException();
+	}
+
+	unsigned int root = update();
+
+	return values[root * states.size() + result->second];
+}
+
+double DecPOMDPPolicyEvaluation::evaluate(const BeliefState &belief)
+{
+	unsigned int root = update();
+
+	double value = 0.0;
+	for (unsigned int s = 0; s < states.size(); s++) {
+		value += belief.get(states[s]) * values[root * states.size() + s];
+	}
+
+	return value;
+}
+
+void DecPOMDPPolicyEvaluation::set_num_threads(unsigned int numThreads)
+{
+	threads = std::max(1U, numThreads);
+}
+
+unsigned int DecPOMDPPolicyEvaluation::get_num_threads() const
+{
+	return threads;
+}
+
+unsigned int DecPOMDPPolicyEvaluation::get_num_joint_nodes() const
+{
+	return std::count(evaluated.begin(), evaluated.end(), true);
+}
+
+void DecPOMDPPolicyEvaluation::reset()
+{
+	for (unsigned int i = 0; i < roots.size(); i++) {
+		nodeIDs[i].clear();
+		nodes[i].clear();
+		roots[i] = -1;
+	}
+
+	jointNodeIDs.clear();
+	jointNodes.clear();
+	jointActions.clear();
+	jointChildren.clear();
+	evaluated.clear();
+	values.clear();
+}
+
+unsigned int DecPOMDPPolicyEvaluation::compile(unsigned int agentIndex, PolicyTreeNode *node)
+{
+	std::unordered_map<Action *, unsigned int>::iterator action = agentActions[agentIndex].find(node->action);
+	if (action == agentActions[agentIndex].end()) {
+		throw PolicyException();
+	}
+
+	// The signature of a node is its action followed by the IDs of its children, in the order of the
+	// agent's observations. Leaves have no children.
+	std::vector<unsigned int> signature;
+	signature.push_back(action->second);
+
+	if (!node->next.empty()) {
+		for (Observation *o : agentObservations[agentIndex]) {
+			std::map<Observation *, PolicyTreeNode *>::iterator child = node->next.find(o);
+			if (child == node->next.end() || child->second == nullptr) {
+				throw PolicyException();
+			}
+			signature.push_back(compile(agentIndex, child->second));
+		}
+	}
+
+	std::unordered_map<std::vector<unsigned int>, unsigned int, DecPOMDPPolicyEvaluationKeyHash>::iterator result =
+			nodeIDs[agentIndex].find(signature);
+	if (result != nodeIDs[agentIndex].end()) {
+		return result->second;
+	}
+
+	unsigned int id = nodes[agentIndex].size();
+	nodeIDs[agentIndex][signature] = id;
+	nodes[agentIndex].push_back(signature);
+
+	return id;
+}
+
+unsigned int DecPOMDPPolicyEvaluation::update()
+{
+	unsigned int numAgents = roots.size();
+	unsigned int n = states.size();
+
+	std::vector<unsigned int> key(numAgents, 0);
+	for (unsigned int i = 0; i < numAgents; i++) {
+		if (roots[i] < 0) {
+			throw PolicyException();
+		}
+		key[i] = (unsigned int)roots[i];
+	}
+
+	unsigned int root = intern(key);
+	if (evaluated[root]) {
+		return root;
+	}
+
+	std::vector<bool> queued(evaluated.size(), false);
+
+	// Discover the joint nodes which have not been evaluated, one depth at a time. The depth of a joint
+	// node is fixed by its subtrees, so each one appears in exactly one depth.
+	std::vector<std::vector<unsigned int> > depths;
+	depths.push_back(std::vector<unsigned int>(1, root));
+	queued[root] = true;
+
+	unsigned int z = 1;
+	for (unsigned int i = 0; i < numAgents; i++) {
+		z *= agentObservations[i].size();
+	}
+
+	while (!depths.back().empty()) {
+		std::vector<unsigned int> next;
+
+		for (unsigned int j = 0; j < depths.back().size(); j++) {
+			unsigned int jointNode = depths.back()[j];
+
+			// A joint node is a leaf once any agent's policy has ended. Copy its key, since interning
+			// its children may reallocate the table of joint nodes.
+			std::vector<unsigned int> jointNodeKey = jointNodes[jointNode];
+
+			bool leaf = false;
+			for (unsigned int i = 0; i < numAgents; i++) {
+				if (nodes[i][jointNodeKey[i]].size() == 1) {
+					leaf = true;
+				}
+			}
+			if (leaf || !jointChildren[jointNode].empty()) {
+				continue;
+			}
+
+			std::vector<unsigned int> children(z, 0);
+			std::vector<unsigned int> childKey(numAgents, 0);
+
+			for (unsigned int o = 0; o < z; o++) {
+				unsigned int remaining = o;
+				for (int i = (int)numAgents - 1; i >= 0; i--) {
+					unsigned int oi = remaining % agentObservations[i].size();
+					remaining /= agentObservations[i].size();
+					childKey[i] = nodes[i][jointNodeKey[i]][1 + oi];
+				}
+
+				children[o] = intern(childKey);
+				queued.resize(evaluated.size(), false);
+
+				if (!evaluated[children[o]] && !queued[children[o]]) {
+					queued[children[o]] = true;
+					next.push_back(children[o]);
+				}
+			}
+
+			jointChildren[jointNode] = children;
+		}
+
+		depths.push_back(next);
+	}
+
+	// Evaluate from the deepest joint nodes up to the root, splitting the states among threads.
+	for (int d = (int)depths.size() - 1; d >= 0; d--) {
+		const std::vector<unsigned int> &depth = depths[d];
+		if (depth.empty()) {
+			continue;
+		}
+
+		unsigned int numThreads = std::min(threads, n);
+		if (depth.size() * n < DEC_POMDP_POLICY_EVALUATION_MIN_PARALLEL_WORK) {
+			numThreads = 1;
+		}
+
+		if (numThreads == 1) {
+			compute_values(depth, 0, n);
+		} else {
+			std::vector<std::thread> workers;
+			for (unsigned int t = 0; t < numThreads; t++) {
+				workers.push_back(std::thread(&DecPOMDPPolicyEvaluation::compute_values, this,
+						std::cref(depth), t * n / numThreads, (t + 1) * n / numThreads));
+			}
+			for (std::thread &worker : workers) {
+				worker.join();
+			}
+		}
+
+		for (unsigned int jointNode : depth) {
+			evaluated[jointNode] = true;
+		}
+	}
+
+	return root;
+}
+
+unsigned int DecPOMDPPolicyEvaluation::intern(const std::vector<unsigned int> &jointNode)
+{
+	std::unordered_map<std::vector<unsigned int>, unsigned int, DecPOMDPPolicyEvaluationKeyHash>::iterator result =
+			jointNodeIDs.find(jointNode);
+	if (result != jointNodeIDs.end()) {
+		return result->second;
+	}
+
+	unsigned int id = jointNodes.size();
+	jointNodeIDs[jointNode] = id;
+	jointNodes.push_back(jointNode);
+
+	// The joint action is mixed-radix over the agents' local actions.
+	unsigned int a = 0;
+	for (unsigned int i = 0; i < jointNode.size(); i++) {
+		a = a * agentActions[i].size() + nodes[i][jointNode[i]][0];
+	}
+	jointActions.push_back(a);
+	jointChildren.push_back(std::vector<unsigned int>());
+	evaluated.push_back(false);
+	values.resize(values.size() + states.size(), 0.0);
+
+	return id;
+}
+
+void DecPOMDPPolicyEvaluation::compute_values(const std::vector<unsigned int> &jointNodes,
+		unsigned int first, unsigned int last)
+{
+	unsigned int n = states.size();
+	unsigned int m = Rsa.size() / n;
+
+	for (unsigned int jointNode : jointNodes) {
+		unsigned int a = jointActions[jointNode];
+		const std::vector<unsigned int> &children = jointChildren[jointNode];
+
+		for (unsigned int s = first; s < last; s++) {
+			double value = Rsa[s * m + a];
+
+			if (!children.empty()) {
+				double future = 0.0;
+				for (const std::pair<unsigned int, double> &successor : successors[s * m + a]) {
+					unsigned int sp = successor.first;
+					for (const std::pair<unsigned int, double> &observation : observations[a * n + sp]) {
+						future += successor.second * observation.second * values[children[observation.first] * n + sp];
+					}
+				}
+				value += gamma * future;
+			}
+
+			values[jointNode * n + s] = value;
+		}
+	}
+}
@@ -38,9 +38,14 @@
 #include "../../include/core/state_transitions/state_transitions_map.h"
 #include "../../include/core/state_transitions/state_transitions_array.h"
 
+#include "../../include/core/observation_transitions/observation_transitions.h"
+#include "../../include/core/observation_transitions/observation_transitions_array.h"
+
 #include "../../include/core/rewards/sas_rewards.h"
 #include "../../include/core/rewards/sas_rewards_map.h"
 #include "../../include/core/rewards/sas_rewards_array.h"
+#include "../../include/core/rewards/saso_rewards.h"
+#include "../../include/core/rewards/saso_rewards_array.h"
 
 #include "../../include/core/states/named_state.h"
 #include "../../include/core/states/indexed_state.h"
@@ -48,7 +53,12 @@
 #include "../../include/core/actions/named_action.h"
 #include "../../include/core/actions/indexed_action.h"
 
+#include "../../include/core/observations/observations_map.h"
+#include "../../include/core/observations/indexed_observation.h"
+
 #include <unordered_map>
+#include <algorithm>
+#include <thread>
 
 //#include <iostream>   // ToDo: REMOVE ME!
 
@@ -86,9 +96,9 @@ MDP *convert_map_to_array(StatesMap *states, ActionsMap *actions,
 	StatesMap *S = new StatesMap();
 	std::unordered_map<unsigned int, State *> convertStates;
 
-	IndexedState::reset_indexer();
+	Indexer stateIndexer;
 	for (auto state : *states) {
-		State *indexedState = new IndexedState();
+		State *indexedState = new IndexedState(stateIndexer);
 		S->add(indexedState);
 		convertStates[indexedState->hash_value()] = resolve(state);
 	}
@@ -97,9 +107,9 @@ MDP *convert_map_to_array(StatesMap *states, ActionsMap *actions,
 	ActionsMap *A = new ActionsMap();
 	std::unordered_map<unsigned int, Action *> convertActions;
 
-	IndexedAction::reset_indexer();
+	Indexer actionIndexer;
 	for (auto action : *actions) {
-		Action *indexedAction = new IndexedAction();
+		Action *indexedAction = new IndexedAction(actionIndexer);
 		A->add(indexedAction);
 		convertActions[indexedAction->hash_value()] = resolve(action);
 	}
@@ -136,12 +146,169 @@ MDP *convert_map_to_array(StatesMap *states, ActionsMap *actions,
 	} else {
 		h = new Horizon(horizon->get_discount_factor());
 	}
+	h->set_discount_factor(horizon->get_discount_factor());
 
 	return new MDP(S, A, T, R, h);
 }
 
-POMDP *convert_map_to_array(const POMDP *pomdp)
+POMDP *convert_map_to_array(POMDP *pomdp)
+{
+	std::vector<State *> originalStates;
+	std::vector<Action *> originalActions;
+	std::vector<Observation *> originalObservations;
+
+	return convert_map_to_array(pomdp, originalStates, originalActions, originalObservations);
+}
+
+POMDP *convert_map_to_array(POMDP *pomdp, std::vector<State *> &originalStates,
+		std::vector<Action *> &originalActions, std::vector<Observation *> &originalObservations)
 {
-	// ToDo: Implement.
-	return nullptr;
+	if (pomdp == nullptr) {
+		throw CoreException();
+	}
+
+	// Check the validity of the POMDP's components by attempting to cast the states, actions,
+	// observations, and rewards.
+	StatesMap *states = dynamic_cast<StatesMap *>(pomdp->get_states());
+	ActionsMap *actions = dynamic_cast<ActionsMap *>(pomdp->get_actions());
+	ObservationsMap *observations = dynamic_cast<ObservationsMap *>(pomdp->get_observations());
+
+	StateTransitions *stateTransitions = pomdp->get_state_transitions();
+	ObservationTransitions *observationTransitions = pomdp->get_observation_transitions();
+	SASORewards *rewards = dynamic_cast<SASORewards *>(pomdp->get_rewards());
+
+	Horizon *horizon = pomdp->get_horizon();
+
+	if (states == nullptr || states->get_num_states() == 0 || actions == nullptr ||
+			actions->get_num_actions() == 0 || observations == nullptr ||
+			observations->get_num_observations() == 0 || stateTransitions == nullptr ||
+			observationTransitions == nullptr || rewards == nullptr || horizon == nullptr) {
+		throw CoreException();
+	}
+
+	// Create the indexed states, actions, and observations, remembering the original of each index.
+	StatesMap *S = new StatesMap();
+	originalStates.clear();
+
+	Indexer stateIndexer;
+	for (auto state : *states) {
+		S->add(new IndexedState(stateIndexer));
+		originalStates.push_back(resolve(state));
+	}
+
+	ActionsMap *A = new ActionsMap();
+	originalActions.clear();
+
+	Indexer actionIndexer;
+	for (auto action : *actions) {
+		A->add(new IndexedAction(actionIndexer));
+		originalActions.push_back(resolve(action));
+	}
+
+	ObservationsMap *Z = new ObservationsMap();
+	originalObservations.clear();
+
+	Indexer observationIndexer;
+	for (auto observation : *observations) {
+		Z->add(new IndexedObservation(observationIndexer));
+		originalObservations.push_back(resolve(observation));
+	}
+
+	unsigned int n = originalStates.size();
+	unsigned int m = originalActions.size();
+	unsigned int z = originalObservations.size();
+
+	// Create the arrays. SAS rewards do not depend on the observation, so they use the smaller array.
+	StateTransitionsArray *T = new StateTransitionsArray(n, m);
+	ObservationTransitionsArray *O = new ObservationTransitionsArray(n, m, z);
+
+	SASRewards *sasRewards = dynamic_cast<SASRewards *>(rewards);
+	SASRewardsArray *RSAS = nullptr;
+	SASORewardsArray *RSASO = nullptr;
+
+	if (sasRewards != nullptr) {
+		RSAS = new SASRewardsArray(n, m);
+	} else {
+		RSASO = new SASORewardsArray(n, m, z);
+	}
+
+	float *TArray = T->get_state_transitions();
+	float *OArray = O->get_observation_transitions();
+	float *RArray = (RSAS != nullptr) ? RSAS->get_rewards() : RSASO->get_rewards();
+
+	// Each thread converts a range of states: the state transitions and rewards from these states, and
+	// the observation transitions into them. Thus, every thread writes to different parts of the arrays,
+	// and only reads the original POMDP.
+	unsigned int numThreads = std::min(n, std::max(1u, std::thread::hardware_concurrency()));
+	std::vector<char> errors(numThreads, 0);
+
+	auto convert = [&](unsigned int start, unsigned int end, char *error) {
+		try {
+			for (unsigned int s = start; s < end; s++) {
+				for (unsigned int a = 0; a < m; a++) {
+					for (unsigned int sp = 0; sp < n; sp++) {
+						double p = stateTransitions->get(originalStates[s], originalActions[a], originalStates[sp]);
+						TArray[s * m * n + a * n + sp] = (float)std::max(0.0, std::min(1.0, p));
+
+						if (sasRewards != nullptr) {
+							RArray[s * m * n + a * n + sp] = (float)sasRewards->get(originalStates[s],
+									originalActions[a], originalStates[sp]);
+						} else {
+							for (unsigned int o = 0; o < z; o++) {
+								RArray[s * m * n * z + a * n * z + sp * z + o] = (float)rewards->get(originalStates[s],
+										originalActions[a], originalStates[sp], originalObservations[o]);
+							}
+						}
+					}
+
+					for (unsigned int o = 0; o < z; o++) {
+						OArray[a * n * z + s * z + o] = (float)observationTransitions->get(originalActions[a],
+								originalStates[s], originalObservations[o]);
+					}
+				}
+			}
+		} catch (const std::exception &err) {
+			*error = 1;
+		}
+	};
+
+	std::vector<std::thread> threads;
+	for (unsigned int i = 1; i < numThreads; i++) {
+		threads.push_back(std::thread(convert, i * n / numThreads, (i + 1) * n / numThreads, &errors[i]));
+	}
+	convert(0, n / numThreads, &errors[0]);
+
+	for (std::thread &thread : threads) {
+		thread.join();
+	}
+
+	// Setting the rewards to themselves computes their minimum and maximum values.
+	if (RSAS != nullptr) {
+		RSAS->set_rewards(RArray);
+	} else {
+		RSASO->set_rewards(RArray);
+	}
+
+	Rewards *R = (RSAS != nullptr) ? (Rewards *)RSAS : (Rewards *)RSASO;
+
+	if (std::find(errors.begin(), errors.end(), 1) != errors.end()) {
+		delete S;
+		delete A;
+		delete Z;
+		delete T;
+		delete O;
+		delete R;
+		throw CoreException();
+	}
+
+	// Finally, create a copy of the horizon.
+	Horizon *h = nullptr;
+	if (horizon->is_finite()) {
+		h = new Horizon(horizon->get_horizon());
+	} else {
+		h = new Horizon(horizon->get_discount_factor());
+	}
+	h->set_discount_factor(horizon->get_discount_factor());
+
+	return new POMDP(S, A, Z, T, O, R, h);
 }
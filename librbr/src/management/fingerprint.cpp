@@ -0,0 +1,321 @@
+/**
+ *  The MIT License (MIT)
+ *
+ *  Copyright (c) 2014 Kyle Hollins Wray, University of Massachusetts
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy of
+ *  this software and associated documentation files (the "Software"), to deal in
+ *  the Software without restriction, including without limitation the rights to
+ *  use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ *  the Software, and to permit persons to whom the Software is furnished to do so,
+ *  subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included in all
+ *  copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ *  FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ *  COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ *  IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ *  CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+
+#include "../../include/management/fingerprint.h"
+
+#include "../../include/pomdp/pomdp.h"
+
+#include "../../include/utilities/table_index.h"
+
+#include "../../include/core/core_exception.h"
+#include "../../include/core/policy/policy_binary.h"
+#include "../../include/core/states/indexed_state.h"
+#include "../../include/core/observations/indexed_observation.h"
+#include "../../include/core/state_transitions/state_transition_exception.h"
+#include "../../include/core/observation_transitions/observation_transition_exception.h"
+#include "../../include/core/rewards/factored_rewards.h"
+#include "../../include/core/rewards/sa_rewards.h"
+#include "../../include/core/rewards/sas_rewards.h"
+#include "../../include/core/rewards/saso_rewards.h"
+#include "../../include/core/rewards/reward_exception.h"
+
+#include <algorithm>
+#include <cstring>
+#include <utility>
+
+/**
+ * The kinds of reward functions, as they are written to the fingerprint.
+ */
+enum FingerprintRewardType {
+	FingerprintSARewards,
+	FingerprintSASRewards,
+	FingerprintSASORewards
+};
+
+void fingerprint_bytes(uint64_t &hash, const void *data, size_t size)
+{
+	const unsigned char *bytes = (const unsigned char *)data;
+	for (size_t i = 0; i < size; i++) {
+		hash = (hash ^ bytes[i]) * FINGERPRINT_PRIME;
+	}
+}
+
+/**
+ * Add an integer to the hash, byte by byte from the least significant, so the result does not
+ * depend on the byte order of the machine.
+ * @param	hash	The hash so far, which will be modified.
+ * @param	value	The integer.
+ */
+static void fingerprint_integer(uint64_t &hash, uint64_t value)
+{
+	for (unsigned int i = 0; i < sizeof(uint64_t); i++) {
+		hash = (hash ^ ((value >> (8 * i)) & 0xFF)) * FINGERPRINT_PRIME;
+	}
+}
+
+/**
+ * Add a real number to the hash by its bits. Negative zero is added as zero.
+ * @param	hash	The hash so far, which will be modified.
+ * @param	value	The real number.
+ */
+static void fingerprint_real(uint64_t &hash, double value)
+{
+	if (value == 0.0) {
+		value = 0.0;
+	}
+
+	uint64_t bits = 0;
+	std::memcpy(&bits, &value, sizeof(double));
+	fingerprint_integer(hash, bits);
+}
+
+/**
+ * Add the names of the objects to the hash, preceded by the number of objects.
+ * @param	hash		The hash so far, which will be modified.
+ * @param	objects		The objects in index order.
+ */
+template <typename T>
+static void fingerprint_names(uint64_t &hash, const std::vector<T *> &objects)
+{
+	fingerprint_integer(hash, objects.size());
+	for (T *object : objects) {
+		std::string name = object->to_string();
+		fingerprint_bytes(hash, name.c_str(), name.length() + 1);
+	}
+}
+
+/**
+ * Add a row of non-zero (index, value) entries to the hash, in index order, followed by the number
+ * of entries so that consecutive rows are not confused.
+ * @param	hash		The hash so far, which will be modified.
+ * @param	entries		The entries, which will be sorted.
+ */
+static void fingerprint_row(uint64_t &hash, std::vector<std::pair<unsigned int, double> > &entries)
+{
+	std::sort(entries.begin(), entries.end());
+	for (const std::pair<unsigned int, double> &entry : entries) {
+		fingerprint_integer(hash, entry.first);
+		fingerprint_real(hash, entry.second);
+	}
+	fingerprint_integer(hash, entries.size());
+}
+
+uint64_t fingerprint_model(MDP *mdp)
+{
+	if (mdp == nullptr) {
+		throw CoreException();
+	}
+
+	StatesMap *states = dynamic_cast<StatesMap *>(mdp->get_states());
+	ActionsMap *actions = dynamic_cast<ActionsMap *>(mdp->get_actions());
+	StateTransitions *T = mdp->get_state_transitions();
+	if (states == nullptr || actions == nullptr || T == nullptr) {
+		throw CoreException();
+	}
+
+	ObservationsMap *observations = nullptr;
+	ObservationTransitions *O = nullptr;
+
+	POMDP *pomdp = dynamic_cast<POMDP *>(mdp);
+	if (pomdp != nullptr) {
+		observations = dynamic_cast<ObservationsMap *>(pomdp->get_observations());
+		O = pomdp->get_observation_transitions();
+		if (observations == nullptr || O == nullptr) {
+			throw CoreException();
+		}
+	}
+
+	// Each factor of factored rewards is added in turn. Note: SARewards are SASRewards, which are
+	// SASORewards, so the most specific type is checked first.
+	std::vector<Rewards *> rewards;
+	FactoredRewards *RF = dynamic_cast<FactoredRewards *>(mdp->get_rewards());
+	if (RF != nullptr && dynamic_cast<SASORewards *>(mdp->get_rewards()) == nullptr) {
+		try {
+			for (unsigned int i = 0; i < RF->get_num_rewards(); i++) {
+				rewards.push_back(RF->get(i));
+			}
+		} catch (const RewardException &err) {
+			throw CoreException();
+		}
+	} else {
+		rewards.push_back(mdp->get_rewards());
+	}
+
+	std::vector<FingerprintRewardType> rewardTypes;
+	for (Rewards *R : rewards) {
+		if (dynamic_cast<SARewards *>(R) != nullptr) {
+			rewardTypes.push_back(FingerprintSARewards);
+		} else if (dynamic_cast<SASRewards *>(R) != nullptr) {
+			rewardTypes.push_back(FingerprintSASRewards);
+		} else if (dynamic_cast<SASORewards *>(R) != nullptr && O != nullptr) {
+			rewardTypes.push_back(FingerprintSASORewards);
+		} else {
+			throw CoreException();
+		}
+	}
+
+	std::vector<State *> S = order_policy_states(states);
+	std::vector<Action *> A = order_policy_actions(actions);
+	std::vector<Observation *> Z;
+	if (observations != nullptr) {
+		Z = order_policy_observations(observations);
+	}
+
+	uint64_t hash = FINGERPRINT_OFFSET_BASIS;
+
+	fingerprint_integer(hash, (pomdp != nullptr));
+	fingerprint_names(hash, S);
+	fingerprint_names(hash, A);
+	fingerprint_names(hash, Z);
+
+	Horizon *h = mdp->get_horizon();
+	fingerprint_integer(hash, h->get_horizon());
+	fingerprint_real(hash, h->get_discount_factor());
+
+	fingerprint_integer(hash, rewardTypes.size());
+	for (FingerprintRewardType type : rewardTypes) {
+		fingerprint_integer(hash, type);
+	}
+
+	// The index of each state and observation, for successors and available observations.
+	TableIndex<IndexedState, State> stateIndexes(S);
+	TableIndex<IndexedObservation, Observation> observationIndexes(Z);
+
+	// Copy the successors and available observations, since the lists returned may be reused by the
+	// next call. Objects without this information fall back to all states or observations.
+	std::vector<std::pair<State *, unsigned int> > successors;
+	auto find_successors = [&](State *s, Action *a) {
+		successors.clear();
+
+		const std::vector<State *> *list = &S;
+		try {
+			list = &T->successors(states, s, a);
+		} catch (const StateTransitionException &err) { }
+
+		for (State *sp : *list) {
+			unsigned int index = stateIndexes.find(sp);
+			if (index == S.size()) {
+				throw CoreException();
+			}
+			successors.push_back(std::pair<State *, unsigned int>(sp, index));
+		}
+	};
+
+	std::vector<std::pair<Observation *, unsigned int> > available;
+	auto find_available = [&](Action *a, State *sp) {
+		available.clear();
+
+		const std::vector<Observation *> *list = &Z;
+		try {
+			list = &O->available(observations, a, sp);
+		} catch (const ObservationTransitionException &err) { }
+
+		for (Observation *z : *list) {
+			unsigned int index = observationIndexes.find(z);
+			if (index == Z.size()) {
+				throw CoreException();
+			}
+			available.push_back(std::pair<Observation *, unsigned int>(z, index));
+		}
+	};
+
+	// In a single pass over the state-action pairs, add the row of state transitions, the rows of
+	// rewards, and (treating the state as the successor) the row of observation transitions.
+	std::vector<std::pair<unsigned int, double> > row;
+
+	for (unsigned int s = 0; s < S.size(); s++) {
+		for (unsigned int a = 0; a < A.size(); a++) {
+			find_successors(S[s], A[a]);
+
+			// Only the reachable successors are kept, so that the rewards below do not depend on whether
+			// the list of successors was known or fell back to all states.
+			row.clear();
+			unsigned int numReachable = 0;
+			for (const std::pair<State *, unsigned int> &sp : successors) {
+				double probability = T->get(S[s], A[a], sp.first);
+				if (probability != 0.0) {
+					row.push_back(std::pair<unsigned int, double>(sp.second, probability));
+					successors[numReachable++] = sp;
+				}
+			}
+			successors.resize(numReachable);
+			fingerprint_row(hash, row);
+
+			for (unsigned int i = 0; i < rewards.size(); i++) {
+				row.clear();
+
+				if (rewardTypes[i] == FingerprintSARewards) {
+					row.push_back(std::pair<unsigned int, double>(0,
+							dynamic_cast<SARewards *>(rewards[i])->get(S[s], A[a])));
+				} else if (rewardTypes[i] == FingerprintSASRewards) {
+					SASRewards *R = dynamic_cast<SASRewards *>(rewards[i]);
+					for (const std::pair<State *, unsigned int> &sp : successors) {
+						double reward = R->get(S[s], A[a], sp.first);
+						if (reward != 0.0) {
+							row.push_back(std::pair<unsigned int, double>(sp.second, reward));
+						}
+					}
+				} else {
+					// Each (successor, observation) pair is given one index in the row.
+					SASORewards *R = dynamic_cast<SASORewards *>(rewards[i]);
+					for (const std::pair<State *, unsigned int> &sp : successors) {
+						find_available(A[a], sp.first);
+						for (const std::pair<Observation *, unsigned int> &z : available) {
+							double reward = R->get(S[s], A[a], sp.first, z.first);
+							if (reward != 0.0) {
+								row.push_back(std::pair<unsigned int, double>(
+										sp.second * Z.size() + z.second, reward));
+							}
+						}
+					}
+				}
+
+				fingerprint_row(hash, row);
+			}
+
+			if (O != nullptr) {
+				find_available(A[a], S[s]);
+
+				row.clear();
+				for (const std::pair<Observation *, unsigned int> &z : available) {
+					double probability = O->get(A[a], S[s], z.first);
+					if (probability != 0.0) {
+						row.push_back(std::pair<unsigned int, double>(z.second, probability));
+					}
+				}
+				fingerprint_row(hash, row);
+			}
+		}
+	}
+
+	return hash;
+}
+
+uint64_t fingerprint_key(uint64_t fingerprint, const std::string &key)
+{
+	uint64_t hash = FINGERPRINT_OFFSET_BASIS;
+	fingerprint_integer(hash, fingerprint);
+	fingerprint_bytes(hash, key.c_str(), key.length() + 1);
+	return hash;
+}
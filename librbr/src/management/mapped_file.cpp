@@ -0,0 +1,122 @@
+/**
+ *  The MIT License (MIT)
+ *
+ *  Copyright (c) 2014 Kyle Hollins Wray, University of Massachusetts
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy of
+ *  this software and associated documentation files (the "Software"), to deal in
+ *  the Software without restriction, including without limitation the rights to
+ *  use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ *  the Software, and to permit persons to whom the Software is furnished to do so,
+ *  subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included in all
+ *  copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ *  FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ *  COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ *  IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ *  CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+
+#include "../../include/management/mapped_file.h"
+
+#include "../../include/utilities/log.h"
+
+#include "../../include/core/core_exception.h"
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+MappedFile::MappedFile(std::string filename)
+{
+	data = nullptr;
+	size = 0;
+
+#ifdef _WIN32
+	mapping = nullptr;
+
+	HANDLE file = CreateFileA(filename.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+			FILE_ATTRIBUTE_NORMAL, nullptr);
+	if (file == INVALID_HANDLE_VALUE) {
+		log_message("MappedFile::MappedFile", "Failed to open file '" + filename + "'.");
+		throw CoreException();
+	}
+
+	LARGE_INTEGER fileSize;
+	if (!GetFileSizeEx(file, &fileSize) || fileSize.QuadPart == 0) {
+		CloseHandle(file);
+		log_message("MappedFile::MappedFile", "Failed to get the size of file '" + filename + "'.");
+		throw CoreException();
+	}
+	size = (std::size_t)fileSize.QuadPart;
+
+	// The mapping keeps the file open, so the file handle may be closed right away.
+	mapping = CreateFileMappingA(file, nullptr, PAGE_WRITECOPY, 0, 0, nullptr);
+	CloseHandle(file);
+	if (mapping == nullptr) {
+		log_message("MappedFile::MappedFile", "Failed to map file '" + filename + "'.");
+		throw CoreException();
+	}
+
+	data = (char *)MapViewOfFile(mapping, FILE_MAP_COPY, 0, 0, 0);
+	if (data == nullptr) {
+		CloseHandle(mapping);
+		log_message("MappedFile::MappedFile", "Failed to map file '" + filename + "'.");
+		throw CoreException();
+	}
+#else
+	int file = open(filename.c_str(), O_RDONLY);
+	if (file < 0) {
+		log_message("MappedFile::MappedFile", "Failed to open file '" + filename + "'.");
+		throw CoreException();
+	}
+
+	struct stat status;
+	if (fstat(file, &status) != 0 || status.st_size == 0) {
+		close(file);
+		log_message("MappedFile::MappedFile", "Failed to get the size of file '" + filename + "'.");
+		throw CoreException();
+	}
+	size = (std::size_t)status.st_size;
+
+	// The mapping keeps the file open, so the descriptor may be closed right away.
+	void *result = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE, file, 0);
+	close(file);
+	if (result == MAP_FAILED) {
+		log_message("MappedFile::MappedFile", "Failed to map file '" + filename + "'.");
+		throw CoreException();
+	}
+
+	data = (char *)result;
+#endif
+}
+
+MappedFile::~MappedFile()
+{
+#ifdef _WIN32
+	UnmapViewOfFile(data);
+	CloseHandle(mapping);
+#else
+	munmap(data, size);
+#endif
+}
+
+char *MappedFile::get_data()
+{
+	return data;
+}
+
+std::size_t MappedFile::get_size() const
+{
+	return size;
+}
@@ -0,0 +1,180 @@
+/**
+ *  The MIT License (MIT)
+ *
+ *  Copyright (c) 2014 Kyle Hollins Wray, University of Massachusetts
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy of
+ *  this software and associated documentation files (the "Software"), to deal in
+ *  the Software without restriction, including without limitation the rights to
+ *  use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ *  the Software, and to permit persons to whom the Software is furnished to do so,
+ *  subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included in all
+ *  copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ *  FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ *  COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ *  IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ *  CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+
+#include "../../include/management/policy_cache.h"
+#include "../../include/management/fingerprint.h"
+
+#include "../../include/utilities/log.h"
+
+#include <cstdio>
+#include <fstream>
+#include <atomic>
+
+#ifdef _WIN32
+#include <process.h>
+#else
+#include <unistd.h>
+#endif
+
+PolicyCache::PolicyCache(std::string directory)
+{
+	// Remove a trailing separator, so that file names are formed the same way either way.
+	while (directory.length() > 1 && (directory.back() == '/' || directory.back() == '\\')) {
+		directory.pop_back();
+	}
+	this->directory = directory;
+}
+
+PolicyCache::~PolicyCache()
+{ }
+
+std::string PolicyCache::get_directory() const
+{
+	return directory;
+}
+
+std::string PolicyCache::get_filename(uint64_t fingerprint, const std::string &key) const
+{
+	char name[32];
+	std::snprintf(name, sizeof(name), "%016llx.policy",
+			(unsigned long long)fingerprint_key(fingerprint, key));
+	return directory + "/" + name;
+}
+
+PolicyMap *PolicyCache::load_policy_map(MDP *mdp, uint64_t fingerprint, const std::string &key)
+{
+	StatesMap *S = dynamic_cast<StatesMap *>(mdp->get_states());
+	ActionsMap *A = dynamic_cast<ActionsMap *>(mdp->get_actions());
+	if (S == nullptr || A == nullptr) {
+		return nullptr;
+	}
+
+	std::string filename = get_filename(fingerprint, key);
+	if (!exists(filename)) {
+		return nullptr;
+	}
+
+	PolicyMap *policy = new PolicyMap();
+	if (policy->load_binary(filename, S, A, mdp->get_horizon(), fingerprint_key(fingerprint, key))) {
+		delete policy;
+		return nullptr;
+	}
+
+	return policy;
+}
+
+bool PolicyCache::save_policy_map(MDP *mdp, uint64_t fingerprint, const std::string &key, PolicyMap *policy)
+{
+	StatesMap *S = dynamic_cast<StatesMap *>(mdp->get_states());
+	ActionsMap *A = dynamic_cast<ActionsMap *>(mdp->get_actions());
+	if (S == nullptr || A == nullptr || policy == nullptr) {
+		return true;
+	}
+
+	std::string filename = get_filename(fingerprint, key);
+	std::string temporary = get_temporary_filename(filename);
+	if (policy->save_binary(temporary, S, A, fingerprint_key(fingerprint, key))) {
+		std::remove(temporary.c_str());
+		return true;
+	}
+
+	return commit(temporary, filename);
+}
+
+PolicyAlphaVectors *PolicyCache::load_policy_alpha_vectors(POMDP *pomdp, uint64_t fingerprint,
+		const std::string &key)
+{
+	StatesMap *S = dynamic_cast<StatesMap *>(pomdp->get_states());
+	ActionsMap *A = dynamic_cast<ActionsMap *>(pomdp->get_actions());
+	if (S == nullptr || A == nullptr) {
+		return nullptr;
+	}
+
+	std::string filename = get_filename(fingerprint, key);
+	if (!exists(filename)) {
+		return nullptr;
+	}
+
+	PolicyAlphaVectors *policy = new PolicyAlphaVectors();
+	if (policy->load_binary(filename, S, A, pomdp->get_horizon(), fingerprint_key(fingerprint, key))) {
+		delete policy;
+		return nullptr;
+	}
+
+	return policy;
+}
+
+bool PolicyCache::save_policy_alpha_vectors(POMDP *pomdp, uint64_t fingerprint, const std::string &key,
+		PolicyAlphaVectors *policy)
+{
+	StatesMap *S = dynamic_cast<StatesMap *>(pomdp->get_states());
+	ActionsMap *A = dynamic_cast<ActionsMap *>(pomdp->get_actions());
+	if (S == nullptr || A == nullptr || policy == nullptr) {
+		return true;
+	}
+
+	std::string filename = get_filename(fingerprint, key);
+	std::string temporary = get_temporary_filename(filename);
+	if (policy->save_binary(temporary, S, A, fingerprint_key(fingerprint, key))) {
+		std::remove(temporary.c_str());
+		return true;
+	}
+
+	return commit(temporary, filename);
+}
+
+bool PolicyCache::exists(const std::string &filename) const
+{
+	std::ifstream file(filename, std::ios::in | std::ios::binary);
+	return file.is_open();
+}
+
+std::string PolicyCache::get_temporary_filename(const std::string &filename) const
+{
+	// The process identifier separates processes, and the counter separates writers within this process.
+	static std::atomic<unsigned long> counter(0);
+
+#ifdef _WIN32
+	unsigned long pid = (unsigned long)_getpid();
+#else
+	unsigned long pid = (unsigned long)getpid();
+#endif
+
+	return filename + "." + std::to_string(pid) + "." + std::to_string(counter++) + ".tmp";
+}
+
+bool PolicyCache::commit(const std::string &temporary, const std::string &filename) const
+{
+	// On some systems, rename does not replace an existing file.
+	if (std::rename(temporary.c_str(), filename.c_str()) != 0) {
+		std::remove(filename.c_str());
+		if (std::rename(temporary.c_str(), filename.c_str()) != 0) {
+			log_message("PolicyCache::commit", "Failed to move '" + temporary + "' to '" + filename + "'.");
+			std::remove(temporary.c_str());
+			return true;
+		}
+	}
+
+	return false;
+}
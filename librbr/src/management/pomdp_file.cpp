@@ -25,162 +25,485 @@
 #include "../../include/management/pomdp_file.h"
 
 #include "../../include/utilities/log.h"
-#include "../../include/utilities/string_manipulation.h"
+#include "../../include/utilities/table_index.h"
 
 #include "../../include/core/core_exception.h"
 
-#include "../../include/core/states/states_map.h"
 #include "../../include/core/states/indexed_state.h"
 
-#include "../../include/core/actions/actions_map.h"
-#include "../../include/core/actions/indexed_action.h"
+#include "../../include/core/actions/joint_actions_map.h"
 
-#include "../../include/core/observations/observations_map.h"
 #include "../../include/core/observations/indexed_observation.h"
+#include "../../include/core/observations/joint_observations_map.h"
 
-#include "../../include/core/state_transitions/state_transitions_array.h"
+#include "../../include/core/agents/agents.h"
 
-#include "../../include/core/observation_transitions/observation_transitions_array.h"
+#include "../../include/core/policy/policy_binary.h"
+
+#include "../../include/core/state_transitions/state_transition_exception.h"
+
+#include "../../include/core/observation_transitions/observation_transition_exception.h"
 
 #include "../../include/core/rewards/rewards.h"
 #include "../../include/core/rewards/factored_rewards.h"
 #include "../../include/core/rewards/sa_rewards.h"
-#include "../../include/core/rewards/sa_rewards_array.h"
+#include "../../include/core/rewards/sas_rewards.h"
+#include "../../include/core/rewards/saso_rewards.h"
 #include "../../include/core/rewards/reward_exception.h"
 
-#include "../../include/core/initial.h"
 #include "../../include/core/horizon.h"
 
+#include <cstdio>
+#include <cstdlib>
+
 POMDPFile::POMDPFile()
-{ }
+{
+	lastValue = 0.0;
+}
 
 POMDPFile::~POMDPFile()
 { }
 
-
-void POMDPFile::save_pomdp(POMDP *pomdp, std::string filename, BeliefState *start)
+void POMDPFile::save_mdp(MDP *mdp, std::string filename)
 {
-	// Load the file and throw an error if this cannot be done.
-	std::ofstream file(filename);
+	StatesMap *S = dynamic_cast<StatesMap *>(mdp->get_states());
+	ActionsMap *A = dynamic_cast<ActionsMap *>(mdp->get_actions());
+	Horizon *h = mdp->get_horizon();
 
-	if (!file.is_open()) {
-		log_message("POMDPFile::save_pomdp", "Failed to create the file '" + filename + "'.");
+	if (S == nullptr || S->get_num_states() == 0 || A == nullptr || A->get_num_actions() == 0 ||
+			mdp->get_state_transitions() == nullptr || mdp->get_rewards() == nullptr || h == nullptr) {
+		log_message("POMDPFile::save_mdp", "Failed to parse the MDP provided and save the file '" + filename + "'.");
 		throw CoreException();
 	}
 
+	std::vector<State *> states = order_policy_states(S);
+	std::vector<Action *> actions = order_policy_actions(A);
+
+	std::vector<std::string> actionNames;
+	for (unsigned int i = 0; i < actions.size(); i++) {
+		actionNames.push_back(std::to_string(i));
+	}
+
+	open(filename, "POMDPFile::save_mdp");
+
+	// Create the header which contains state, action, and discount information.
+	append("discount: ");
+	append(h->get_discount_factor());
+	append("\nvalues: reward\nstates: " + std::to_string(states.size()) + "\n");
+	append("actions: " + std::to_string(actions.size()) + "\n\n");
+
+	try {
+		save_body(mdp, nullptr, states, actions, std::vector<Observation *>(), actionNames,
+				std::vector<std::string>(), " ");
+	} catch (const CoreException &err) {
+		log_message("POMDPFile::save_mdp", "Failed to save the rewards or transitions to the file '" + filename + "'.");
+		close();
+		throw CoreException();
+	}
+
+	close();
+}
+
+void POMDPFile::save_pomdp(POMDP *pomdp, std::string filename, BeliefState *start)
+{
 	// Note: FactoredStates, and even JointActions, will automatically work, because the
 	// entire set of all possible state tuples should be generated. State transitions will
 	// also already be defined for this. It is different for FactoredRewards, which do *not*
-	// have a 'flattened' representation. They must be treated for each possible case.
-
-	// First, obtain all the objects for easy reference. Also, check to make sure this
-	// is a valid MDP.
+	// have a 'flattened' representation; only the first factor is saved.
 	StatesMap *S = dynamic_cast<StatesMap *>(pomdp->get_states());
 	ActionsMap *A = dynamic_cast<ActionsMap *>(pomdp->get_actions());
 	ObservationsMap *Z = dynamic_cast<ObservationsMap *>(pomdp->get_observations());
-	StateTransitions *T = pomdp->get_state_transitions();
-	ObservationTransitions *O = pomdp->get_observation_transitions();
-	Rewards *R = nullptr;
-	SARewards *Ri = nullptr;
 	Horizon *h = pomdp->get_horizon();
 
-	R = dynamic_cast<FactoredRewards *>(pomdp->get_rewards());
-	if (R == nullptr) {
-		Ri = dynamic_cast<SARewards *>(pomdp->get_rewards());
-		if (Ri == nullptr) {
-			throw CoreException();
-		}
-	} else {
-		FactoredRewards *RF = dynamic_cast<FactoredRewards *>(R);
-		if (RF == nullptr) {
-			throw CoreException();
-		}
+	if (S == nullptr || S->get_num_states() == 0 || A == nullptr || A->get_num_actions() == 0 ||
+			Z == nullptr || Z->get_num_observations() == 0 || pomdp->get_state_transitions() == nullptr ||
+			pomdp->get_observation_transitions() == nullptr || pomdp->get_rewards() == nullptr || h == nullptr) {
+		log_message("POMDPFile::save_pomdp", "Failed to parse the POMDP provided and save the file '" + filename + "'.");
+		throw CoreException();
+	}
 
-		// Note: We attempt to cast the first one, and assume that the rest are of the same class.
-		Rewards *R0 = nullptr;
-		try {
-			R0 = RF->get(0);
-		} catch (const RewardException &err) {
-			log_message("POMDPFile::save_pomdp",
-					"Found null reward, and thus failed to save the file '" + filename + "'.");
-			throw CoreException();
-		}
+	std::vector<State *> states = order_policy_states(S);
+	std::vector<Action *> actions = order_policy_actions(A);
+	std::vector<Observation *> observations = order_policy_observations(Z);
 
-		// We only handle SARewards and only take the first reward factor.
-		Ri = dynamic_cast<SARewards *>(R0);
-		if (Ri == nullptr) {
-			throw CoreException();
-		}
+	std::vector<std::string> actionNames;
+	for (unsigned int i = 0; i < actions.size(); i++) {
+		actionNames.push_back(std::to_string(i));
+	}
+
+	std::vector<std::string> observationNames;
+	for (unsigned int i = 0; i < observations.size(); i++) {
+		observationNames.push_back(std::to_string(i));
 	}
 
+	open(filename, "POMDPFile::save_pomdp");
+
+	// Create the header which contains state, action, observation, and discount information.
+	append("discount: ");
+	append(h->get_discount_factor());
+	append("\nvalues: reward\nstates: " + std::to_string(states.size()) + "\n");
+	append("actions: " + std::to_string(actions.size()) + "\n");
+	append("observations: " + std::to_string(observations.size()) + "\n");
+	save_start(states, start);
+
+	try {
+		save_body(pomdp, pomdp->get_observation_transitions(), states, actions, observations, actionNames,
+				observationNames, " ");
+	} catch (const CoreException &err) {
+		log_message("POMDPFile::save_pomdp", "Failed to save the rewards or transitions to the file '" + filename + "'.");
+		close();
+		throw CoreException();
+	}
+
+	close();
+}
+
+void POMDPFile::save_decpomdp(DecPOMDP *decpomdp, std::string filename, BeliefState *start)
+{
+	StatesMap *S = dynamic_cast<StatesMap *>(decpomdp->get_states());
+	JointActionsMap *A = dynamic_cast<JointActionsMap *>(decpomdp->get_actions());
+	JointObservationsMap *Z = dynamic_cast<JointObservationsMap *>(decpomdp->get_observations());
+	Agents *N = decpomdp->get_agents();
+	Horizon *h = decpomdp->get_horizon();
+
 	if (S == nullptr || S->get_num_states() == 0 || A == nullptr || A->get_num_actions() == 0 ||
-			T == nullptr || O == nullptr || R == nullptr || h == nullptr) {
-		log_message("POMDPFile::save_pomdp",
-				"Failed to parse the MDP provided and save the file '" + filename + "'.");
+			Z == nullptr || Z->get_num_observations() == 0 || N == nullptr ||
+			A->get_num_factors() != N->get_num_agents() || Z->get_num_factors() != N->get_num_agents() ||
+			decpomdp->get_state_transitions() == nullptr || decpomdp->get_observation_transitions() == nullptr ||
+			decpomdp->get_rewards() == nullptr || h == nullptr) {
+		log_message("POMDPFile::save_decpomdp",
+				"Failed to parse the Dec-POMDP provided and save the file '" + filename + "'.");
 		throw CoreException();
 	}
 
-	// Create the header which contains state, action, and horizon information.
-	file << "discount: " << h->get_discount_factor() << std::endl;
-	file << "values: reward" << std::endl;
-	file << "states: " << S->get_num_states() << std::endl;
-	file << "actions: " << A->get_num_actions() << std::endl;
-	file << "observations: " << Z->get_num_observations() << std::endl;
+	std::vector<State *> states = order_policy_states(S);
 
-	// Note: Assume uniform belief over these starting states.
-	file << "start include:" << std::endl;
-	for (State *s : start->get_states()) {
-		file << s->hash_value() << " ";
+	std::vector<Action *> actions = order_policy_actions(A);
+	std::vector<Observation *> observations = order_policy_observations(Z);
+
+	// Joint actions and observations are ordered by their mixed-radix index, with the first agent's as the
+	// most significant, and each is named by the index of every agent's part within its factor.
+	auto joint_name = [](unsigned int index, const std::vector<unsigned int> &sizes) {
+		std::string name = "";
+		for (int i = (int)sizes.size() - 1; i >= 0; i--) {
+			name = std::to_string(index % sizes[i]) + (i + 1 < (int)sizes.size() ? " " : "") + name;
+			index /= sizes[i];
+		}
+		return name;
+	};
+
+	std::vector<unsigned int> actionSizes;
+	for (unsigned int i = 0; i < A->get_num_factors(); i++) {
+		actionSizes.push_back(A->get_factor(i).size());
+	}
+
+	std::vector<std::string> actionNames;
+	for (unsigned int i = 0; i < actions.size(); i++) {
+		actionNames.push_back(joint_name(i, actionSizes));
 	}
 
-	file << std::endl;
+	std::vector<unsigned int> observationSizes;
+	for (unsigned int i = 0; i < Z->get_num_factors(); i++) {
+		observationSizes.push_back(Z->get_factor(i).size());
+	}
 
-	// Write all of the state transition information.
-	for (auto action : *A) {
-		Action *a = resolve(action);
+	std::vector<std::string> observationNames;
+	for (unsigned int i = 0; i < observations.size(); i++) {
+		observationNames.push_back(joint_name(i, observationSizes));
+	}
 
-		for (auto state : *S) {
-			State *s = resolve(state);
+	open(filename, "POMDPFile::save_decpomdp");
 
-			for (State *sp : T->successors(S, s, a)) {
-				file << "T: " << a->hash_value() << " : " << s->hash_value() << " : " << sp->hash_value() << " " << T->get(s, a, sp) << std::endl;
-			}
+	// Create the header which contains agent, state, action, observation, and discount information.
+	append("agents: " + std::to_string(N->get_num_agents()) + "\n");
+	append("discount: ");
+	append(h->get_discount_factor());
+	append("\nvalues: reward\nstates: " + std::to_string(states.size()) + "\n");
+	save_start(states, start);
+
+	append("actions:\n");
+	for (unsigned int i = 0; i < A->get_num_factors(); i++) {
+		append(std::to_string(A->get_factor(i).size()) + "\n");
+	}
+
+	append("observations:\n");
+	for (unsigned int i = 0; i < Z->get_num_factors(); i++) {
+		append(std::to_string(Z->get_factor(i).size()) + "\n");
+	}
+	append("\n");
+
+	try {
+		save_body(decpomdp, decpomdp->get_observation_transitions(), states, actions, observations,
+				actionNames, observationNames, " : ");
+	} catch (const CoreException &err) {
+		log_message("POMDPFile::save_decpomdp",
+				"Failed to save the rewards or transitions to the file '" + filename + "'.");
+		close();
+		throw CoreException();
+	}
+
+	close();
+}
+
+void POMDPFile::save_body(MDP *mdp, ObservationTransitions *O, const std::vector<State *> &S,
+		const std::vector<Action *> &A, const std::vector<Observation *> &Z,
+		const std::vector<std::string> &actionNames, const std::vector<std::string> &observationNames,
+		std::string separator)
+{
+	States *states = mdp->get_states();
+	Observations *observations = nullptr;
+	StateTransitions *T = mdp->get_state_transitions();
+
+	POMDP *pomdp = dynamic_cast<POMDP *>(mdp);
+	if (pomdp != nullptr) {
+		observations = pomdp->get_observations();
+	}
+
+	// Only the first factor of factored rewards is saved, since neither format has reward factors.
+	Rewards *R = mdp->get_rewards();
+	FactoredRewards *RF = dynamic_cast<FactoredRewards *>(R);
+	if (RF != nullptr) {
+		try {
+			R = RF->get(0);
+		} catch (const RewardException &err) {
+			throw CoreException();
 		}
 	}
 
-	file << std::endl;
+	// Note: SARewards are SASRewards, which are SASORewards, so the most specific type is checked first.
+	SARewards *RSA = dynamic_cast<SARewards *>(R);
+	SASRewards *RSAS = dynamic_cast<SASRewards *>(R);
+	SASORewards *RSASO = dynamic_cast<SASORewards *>(R);
+	if (RSASO == nullptr || (RSAS == nullptr && O == nullptr)) {
+		throw CoreException();
+	}
 
-	// Write all of the state transition information.
-	for (auto action : *A) {
-		Action *a = resolve(action);
+	std::vector<std::string> stateNames;
+	for (unsigned int i = 0; i < S.size(); i++) {
+		stateNames.push_back(std::to_string(i));
+	}
 
-		for (auto nextState : *S) {
-			State *sp = resolve(nextState);
+	// The index of each successor state and available observation.
+	TableIndex<IndexedState, State> stateIndexes(S);
+	TableIndex<IndexedObservation, Observation> observationIndexes(Z);
 
-			file << "O: " << a->hash_value() << " : " << sp->hash_value() << std::endl;
+	auto state_index = [&](State *sp) -> unsigned int {
+		unsigned int index = stateIndexes.find(sp);
+		if (index == S.size()) {
+			throw CoreException();
+		}
+		return index;
+	};
 
-			for (auto observation : *Z) {
-				Observation *z = resolve(observation);
+	auto observation_index = [&](Observation *z) -> unsigned int {
+		unsigned int index = observationIndexes.find(z);
+		if (index == Z.size()) {
+			throw CoreException();
+		}
+		return index;
+	};
+
+	// Write only the non-zero state transitions. Each statement is built directly in the buffer.
+	for (unsigned int a = 0; a < A.size(); a++) {
+		for (unsigned int s = 0; s < S.size(); s++) {
+			for (State *sp : successors(T, states, S, S[s], A[a])) {
+				double probability = T->get(S[s], A[a], sp);
+				if (probability == 0.0) {
+					continue;
+				}
+
+				buffer += "T: ";
+				buffer += actionNames[a];
+				buffer += " : ";
+				buffer += stateNames[s];
+				buffer += " : ";
+				buffer += stateNames[state_index(sp)];
+				buffer += separator;
+				append(probability);
+				append("\n");
+			}
+		}
+	}
+	append("\n");
+
+	// Write only the non-zero observation transitions.
+	if (O != nullptr) {
+		for (unsigned int a = 0; a < A.size(); a++) {
+			for (unsigned int sp = 0; sp < S.size(); sp++) {
+				for (Observation *z : available(O, observations, Z, A[a], S[sp])) {
+					double probability = O->get(A[a], S[sp], z);
+					if (probability == 0.0) {
+						continue;
+					}
+
+					buffer += "O: ";
+					buffer += actionNames[a];
+					buffer += " : ";
+					buffer += stateNames[sp];
+					buffer += " : ";
+					buffer += observationNames[observation_index(z)];
+					buffer += separator;
+					append(probability);
+					append("\n");
+				}
+			}
+		}
+		append("\n");
+	}
 
-				 file << O->get(a, sp, z) << " ";
+	// Write only the non-zero rewards, and only for successor states and available observations.
+	for (unsigned int a = 0; a < A.size(); a++) {
+		for (unsigned int s = 0; s < S.size(); s++) {
+			if (RSA != nullptr) {
+				double reward = RSA->get(S[s], A[a]);
+				if (reward != 0.0) {
+					buffer += "R: ";
+					buffer += actionNames[a];
+					buffer += " : ";
+					buffer += stateNames[s];
+					buffer += " : * : *";
+					buffer += separator;
+					append(reward);
+					append("\n");
+				}
+				continue;
 			}
 
-			file << std::endl;
+			for (State *sp : successors(T, states, S, S[s], A[a])) {
+				if (RSAS != nullptr) {
+					double reward = RSAS->get(S[s], A[a], sp);
+					if (reward != 0.0) {
+						buffer += "R: ";
+						buffer += actionNames[a];
+						buffer += " : ";
+						buffer += stateNames[s];
+						buffer += " : ";
+						buffer += stateNames[state_index(sp)];
+						buffer += " : *";
+						buffer += separator;
+						append(reward);
+						append("\n");
+					}
+					continue;
+				}
+
+				for (Observation *z : available(O, observations, Z, A[a], sp)) {
+					double reward = RSASO->get(S[s], A[a], sp, z);
+					if (reward == 0.0) {
+						continue;
+					}
+
+					buffer += "R: ";
+					buffer += actionNames[a];
+					buffer += " : ";
+					buffer += stateNames[s];
+					buffer += " : ";
+					buffer += stateNames[state_index(sp)];
+					buffer += " : ";
+					buffer += observationNames[observation_index(z)];
+					buffer += separator;
+					append(reward);
+					append("\n");
+				}
+			}
 		}
 	}
+}
 
-	file << std::endl;
+const std::vector<State *> &POMDPFile::successors(StateTransitions *T, States *states,
+		const std::vector<State *> &S, State *state, Action *action)
+{
+	try {
+		return T->successors(states, state, action);
+	} catch (const StateTransitionException &err) {
+		return S;
+	}
+}
 
-	// Write all of the reward information.
-	for (auto action : *A) {
-		Action *a = resolve(action);
+const std::vector<Observation *> &POMDPFile::available(ObservationTransitions *O, Observations *observations,
+		const std::vector<Observation *> &Z, Action *action, State *state)
+{
+	try {
+		return O->available(observations, action, state);
+	} catch (const ObservationTransitionException &err) {
+		return Z;
+	}
+}
 
-		for (auto state : *S) {
-			State *s = resolve(state);
+void POMDPFile::save_start(const std::vector<State *> &S, BeliefState *start)
+{
+	if (start == nullptr) {
+		append("start: uniform\n\n");
+		return;
+	}
 
-			file << "R: " << a->hash_value() << " : " << s->hash_value() << " : * : * " << Ri->get(s, a) << std::endl;
-		}
+	append("start:");
+	for (State *s : S) {
+		append(" ");
+		append(start->get(s));
+	}
+	append("\n\n");
+}
+
+void POMDPFile::open(std::string filename, std::string function)
+{
+	file.open(filename, std::ios::out | std::ios::binary);
+	if (!file.is_open()) {
+		log_message(function, "Failed to create the file '" + filename + "'.");
+		throw CoreException();
 	}
 
+	buffer.clear();
+	buffer.reserve(POMDP_FILE_BUFFER_SIZE + 1024);
+
+	lastText.clear();
+}
+
+void POMDPFile::close()
+{
+	file.write(buffer.data(), buffer.size());
 	file.close();
+
+	buffer.clear();
+	buffer.shrink_to_fit();
+}
+
+void POMDPFile::append(const std::string &text)
+{
+	buffer += text;
+
+	if (buffer.size() >= POMDP_FILE_BUFFER_SIZE) {
+		file.write(buffer.data(), buffer.size());
+		buffer.clear();
+	}
+}
+
+void POMDPFile::append(double value)
+{
+	// Probabilities and rewards often repeat, e.g., within a row of a uniform distribution.
+	if (value == lastValue && !lastText.empty()) {
+		append(lastText);
+		return;
+	}
+
+	char number[32];
+
+	// Values held as floats (as in the array classes) use the fewest digits which read back as the same
+	// float. Other values use 15 digits, which reproduce most decimals exactly, or 17, which always do.
+	if (value == (double)(float)value) {
+		snprintf(number, sizeof(number), "%.7g", value);
+		if (std::strtof(number, nullptr) != (float)value) {
+			snprintf(number, sizeof(number), "%.9g", value);
+		}
+	} else {
+		snprintf(number, sizeof(number), "%.15g", value);
+		if (std::strtod(number, nullptr) != value) {
+			snprintf(number, sizeof(number), "%.17g", value);
+		}
+	}
+
+	lastValue = value;
+	lastText = number;
+
+	append(lastText);
 }
@@ -23,9 +23,11 @@
 
 
 #include "../../include/management/raw_file.h"
+#include "../../include/management/mapped_file.h"
 
 #include "../../include/utilities/log.h"
 #include "../../include/utilities/string_manipulation.h"
+#include "../../include/utilities/table_index.h"
 
 #include "../../include/core/core_exception.h"
 
@@ -34,10 +36,24 @@
 
 #include "../../include/core/actions/actions_map.h"
 #include "../../include/core/actions/indexed_action.h"
+#include "../../include/core/actions/named_action.h"
+#include "../../include/core/actions/joint_actions_map.h"
+
+#include "../../include/core/observations/observations_map.h"
+#include "../../include/core/observations/indexed_observation.h"
+#include "../../include/core/observations/named_observation.h"
+#include "../../include/core/observations/joint_observations_map.h"
+
+#include "../../include/core/agents/agents.h"
+#include "../../include/core/agents/agent.h"
 
 #include "../../include/core/state_transitions/state_transitions_array.h"
+#include "../../include/core/state_transitions/state_transitions_sparse_array.h"
+#include "../../include/core/state_transitions/state_transitions_map.h"
+#include "../../include/core/state_transitions/state_transition_exception.h"
 
-//#include "../../include/core/observation_transitions/observation_transitions_array.h"
+#include "../../include/core/observation_transitions/observation_transitions_array.h"
+#include "../../include/core/observation_transitions/observation_transitions_map.h"
 
 #include "../../include/core/rewards/rewards.h"
 #include "../../include/core/rewards/factored_rewards.h"
@@ -45,15 +61,25 @@
 //#include "../../include/core/rewards/s_rewards_array.h"
 #include "../../include/core/rewards/sa_rewards.h"
 #include "../../include/core/rewards/sa_rewards_array.h"
+#include "../../include/core/rewards/sa_rewards_map.h"
 #include "../../include/core/rewards/sas_rewards.h"
 #include "../../include/core/rewards/sas_rewards_array.h"
-//#include "../../include/core/rewards/saso_rewards.h"
-//#include "../../include/core/rewards/saso_rewards_array.h"
+#include "../../include/core/rewards/sas_rewards_map.h"
+#include "../../include/core/rewards/saso_rewards.h"
+#include "../../include/core/rewards/saso_rewards_array.h"
+#include "../../include/core/rewards/saso_rewards_map.h"
 #include "../../include/core/rewards/reward_exception.h"
 
 #include "../../include/core/initial.h"
+#include "../../include/core/policy/policy_binary.h"
 #include "../../include/core/horizon.h"
 
+#include <memory>
+#include <limits>
+#include <cstring>
+#include <algorithm>
+#include <functional>
+
 RawFile::RawFile()
 { }
 
@@ -70,6 +96,16 @@ MDP *RawFile::load_raw_mdp(std::string filename)
 		throw CoreException();
 	}
 
+	// Sparse raw files are streamed in an entirely different manner.
+	std::string firstWord;
+	file >> firstWord;
+	if (firstWord == "sparse") {
+		file.close();
+		return load_sparse_raw_mdp(filename);
+	}
+	file.clear();
+	file.seekg(0);
+
 	// Attempt to read the header information: number of states (n), number of actions (m),
 	// number of reward factors (k), rewards type (r), the initial state (s0), and the horizon (h).
 	unsigned int n = 0;
@@ -94,44 +130,14 @@ MDP *RawFile::load_raw_mdp(std::string filename)
 	}
 
 	// Ensure that all header variables are valid.
-	if (n == 0) {
-		log_message("RawFile::load_raw_mdp",
-				"Invalid number of states in the header for file '" + filename + "'.");
-		throw CoreException();
-	}
-
-	if (m == 0) {
-		log_message("RawFile::load_raw_mdp",
-				"Invalid number of actions in the header for file '" + filename + "'.");
-		throw CoreException();
-	}
+	check_header(filename, n, m, k, r, s0, g);
 
-	if (k == 0) {
-		log_message("RawFile::load_raw_mdp",
-				"Invalid number of reward factors in the header for file '" + filename + "'.");
-		throw CoreException();
-	}
-
-	if (r == RawFileRewardsType::RawFileSASORewards || r >= RawFileRewardsType::NumRawFileRewardsTypes) {
+	if (r == RawFileRewardsType::RawFileSASORewards) {
 		log_message("RawFile::load_raw_mdp",
 				"Invalid rewards type in the header for file '" + filename + "'.");
 		throw CoreException();
 	}
 
-	if (s0 >= n) {
-		log_message("RawFile::load_raw_mdp",
-				"Invalid initial state in the header for file '" + filename + "'.");
-		throw CoreException();
-	}
-
-	// Note: All values of an unsigned int are valid horizon values.
-
-	if (g < 0.0 || g > 1.0) {
-		log_message("RawFile::load_raw_mdp",
-				"Invalid discount factor (gamma) in the header for file '" + filename + "'.");
-		throw CoreException();
-	}
-
 	// Attempt to read in the state transition blocks.
 	float *T = new float[n * m * n];
 	for (unsigned int s = 0; s < n; s++) {
@@ -190,23 +196,9 @@ MDP *RawFile::load_raw_mdp(std::string filename)
 		}
 	};
 
-	// Create the states, and assign the initial state while iterating.
-	IndexedState::reset_indexer();
-
-	StatesMap *states = new StatesMap();
-
-	for (unsigned int i = 0; i < n; i++) {
-		IndexedState *s = new IndexedState();
-		states->add(s);
-	}
-
-	// Create the actions.
-	IndexedAction::reset_indexer();
-
-	ActionsMap *actions = new ActionsMap();
-	for (unsigned int i = 0; i < m; i++) {
-		actions->add(new IndexedAction());
-	}
+	// Create the states and the actions.
+	StatesMap *states = create_states(n);
+	ActionsMap *actions = create_actions(m);
 
 	// Create the state transitions.
 	StateTransitionsArray *stateTransitions = new StateTransitionsArray(n, m);
@@ -358,21 +350,20 @@ void RawFile::save_raw_mdp(MDP *mdp, std::string filename)
 		throw CoreException();
 	}
 
-	// Create the header which contains state, action, and horizon information.
-	file << S->get_num_states() << " " << A->get_num_actions() << " " << k << " " << r << " ";
+	// States and actions are written by index, if possible, so that they match once loaded.
+	std::vector<State *> states = order_policy_states(S);
+	std::vector<Action *> actions = order_policy_actions(A);
+
+	// Create the header which contains state, action, initial state, and horizon information.
+	file << S->get_num_states() << " " << A->get_num_actions() << " " << k << " " << r << " 0 ";
 	file << h->get_horizon() << " " << h->get_discount_factor() << std::endl;
 
 	// Write all of the state transition information.
-	for (auto state : *S) {
-		State *s = resolve(state);
-
-		for (auto action : *A) {
-			Action *a = resolve(action);
+	for (State *s : states) {
+		for (Action *a : actions) {
 			unsigned int i = 0;
 
-			for (auto nextState : *S) {
-				State *sp = resolve(nextState);
-
+			for (State *sp : states) {
 				file << T->get(s, a, sp);
 
 				if (i < S->get_num_states() - 1) {
@@ -410,13 +401,10 @@ void RawFile::save_raw_mdp(MDP *mdp, std::string filename)
 			throw CoreException();
 			break;
 		case RawFileRewardsType::RawFileSARewards:
-			for (auto state : *S) {
-				State *s = resolve(state);
+			for (State *s : states) {
 				unsigned int i = 0;
 
-				for (auto action : *A) {
-					Action *a = resolve(action);
-
+				for (Action *a : actions) {
 					RiSA = dynamic_cast<SARewards *>(Ri);
 					if (RiSA == nullptr) {
 						throw CoreException();
@@ -433,16 +421,11 @@ void RawFile::save_raw_mdp(MDP *mdp, std::string filename)
 			}
 			break;
 		case RawFileRewardsType::RawFileSASRewards:
-			for (auto state : *S) {
-				State *s = resolve(state);
-
-				for (auto action : *A) {
-					Action *a = resolve(action);
+			for (State *s : states) {
+				for (Action *a : actions) {
 					unsigned int i = 0;
 
-					for (auto nextState : *S) {
-						State *sp = resolve(nextState);
-
+					for (State *sp : states) {
 						RiSAS = dynamic_cast<SASRewards *>(Ri);
 						if (RiSAS == nullptr) {
 							throw CoreException();
@@ -466,30 +449,1422 @@ void RawFile::save_raw_mdp(MDP *mdp, std::string filename)
 	file.close();
 }
 
-void RawFile::load_data(std::ifstream &file, unsigned int rows, unsigned int cols, float *array, unsigned int offset)
+void RawFile::save_sparse_raw_mdp(MDP *mdp, std::string filename)
 {
-	// For each of the rows, attempt to read and parse the line.
-	for (unsigned int r = 0; r < rows; r++) {
-		if (file.eof()) {
+	if (mdp == nullptr) {
+		log_message("RawFile::save_sparse_raw_mdp", "Failed to save an invalid MDP to the file '" + filename + "'.");
+		throw CoreException();
+	}
+
+	StatesMap *S = dynamic_cast<StatesMap *>(mdp->get_states());
+	ActionsMap *A = dynamic_cast<ActionsMap *>(mdp->get_actions());
+	StateTransitions *T = mdp->get_state_transitions();
+	Horizon *h = mdp->get_horizon();
+
+	if (S == nullptr || S->get_num_states() == 0 || A == nullptr || A->get_num_actions() == 0 ||
+			T == nullptr || mdp->get_rewards() == nullptr || h == nullptr) {
+		log_message("RawFile::save_sparse_raw_mdp",
+				"Failed to parse the MDP provided and save the file '" + filename + "'.");
+		throw CoreException();
+	}
+
+	// Collect the reward factors, and determine their type. SA rewards are stored more compactly,
+	// so they are only used if every factor is one.
+	std::vector<Rewards *> factors;
+
+	FactoredRewards *RF = dynamic_cast<FactoredRewards *>(mdp->get_rewards());
+	if (RF != nullptr) {
+		for (unsigned int i = 0; i < RF->get_num_rewards(); i++) {
+			factors.push_back(RF->get(i));
+		}
+	} else {
+		factors.push_back(mdp->get_rewards());
+	}
+
+	bool allSA = true;
+	for (Rewards *Ri : factors) {
+		if (dynamic_cast<SASRewards *>(Ri) == nullptr) {
+			log_message("RawFile::save_sparse_raw_mdp",
+					"Unsupported type of rewards, and thus failed to save the file '" + filename + "'.");
 			throw CoreException();
 		}
+		allSA = allSA && (dynamic_cast<SARewards *>(Ri) != nullptr);
+	}
 
-		std::string line;
-		std::getline(file, line);
+	std::vector<State *> states = order_policy_states(S);
+	std::vector<Action *> actions = order_policy_actions(A);
 
-		// Split the line by ' ', attempt to convert each token into a float, and assign the value in
-		// the array, if successful.
-		std::vector<std::string> items = split_string_by_space(line);
-		if (items.size() != cols) {
+	unsigned int n = states.size();
+	unsigned int m = actions.size();
+	unsigned int k = factors.size();
+
+	// The position of each state in the file, since successors are not necessarily in order.
+	TableIndex<IndexedState, State> positions(states);
+
+	// Only the successors of each state-action pair are visited, so first collect the nonzero transitions,
+	// sorted by the position of the next state, to know their number.
+	StateTransitionsSparseArray *TS = dynamic_cast<StateTransitionsSparseArray *>(T);
+
+	std::vector<unsigned int> nextStates;
+	std::vector<float> probabilities;
+	std::vector<unsigned int> rowStarts(n * m + 1, 0);
+
+	for (unsigned int s = 0; s < n; s++) {
+		for (unsigned int a = 0; a < m; a++) {
+			const std::vector<State *> &successors = T->successors(S, states[s], actions[a]);
+
+			const std::vector<float> *successorProbabilities = nullptr;
+			if (TS != nullptr) {
+				successorProbabilities = &TS->probabilities(states[s], actions[a]);
+			}
+
+			std::vector<std::pair<unsigned int, float> > row;
+			for (unsigned int i = 0; i < successors.size(); i++) {
+				float p = 0.0f;
+				if (successorProbabilities != nullptr) {
+					p = (*successorProbabilities)[i];
+				} else {
+					p = (float)T->get(states[s], actions[a], successors[i]);
+				}
+
+				if (p > 0.0f) {
+					unsigned int sp = positions.find(successors[i]);
+					if (sp == n) {
+						log_message("RawFile::save_sparse_raw_mdp",
+								"A successor is not one of the states, and thus failed to save the file '" + filename + "'.");
+						throw CoreException();
+					}
+					row.push_back(std::pair<unsigned int, float>(sp, p));
+				}
+			}
+			std::sort(row.begin(), row.end());
+
+			for (auto entry : row) {
+				nextStates.push_back(entry.first);
+				probabilities.push_back(entry.second);
+			}
+
+			rowStarts[s * m + a + 1] = nextStates.size();
+		}
+	}
+
+	std::ofstream file(filename);
+
+	if (!file.is_open()) {
+		log_message("RawFile::save_sparse_raw_mdp", "Failed to create the file '" + filename + "'.");
+		throw CoreException();
+	}
+
+	// Use enough digits so that every float value is loaded exactly.
+	file.precision(std::numeric_limits<float>::max_digits10);
+
+	// Create the header, just like a dense raw file, but following the "sparse" line.
+	file << "sparse" << std::endl;
+	file << n << " " << m << " " << k << " ";
+	file << (allSA ? RawFileRewardsType::RawFileSARewards : RawFileRewardsType::RawFileSASRewards) << " 0 ";
+	file << h->get_horizon() << " " << h->get_discount_factor() << std::endl;
+
+	// Write the nonzero state transitions.
+	file << nextStates.size() << std::endl;
+
+	for (unsigned int s = 0; s < n; s++) {
+		for (unsigned int a = 0; a < m; a++) {
+			for (unsigned int i = rowStarts[s * m + a]; i < rowStarts[s * m + a + 1]; i++) {
+				file << s << " " << a << " " << nextStates[i] << " " << probabilities[i] << "\n";
+			}
+		}
+	}
+
+	// Write the rewards, with SAS rewards only for the nonzero state transitions.
+	for (Rewards *Ri : factors) {
+		if (allSA) {
+			SARewards *RiSA = dynamic_cast<SARewards *>(Ri);
+
+			for (unsigned int s = 0; s < n; s++) {
+				for (unsigned int a = 0; a < m; a++) {
+					file << RiSA->get(states[s], actions[a]);
+
+					if (a < m - 1) {
+						file << " ";
+					}
+				}
+				file << "\n";
+			}
+		} else {
+			SASRewards *RiSAS = dynamic_cast<SASRewards *>(Ri);
+
+			file << nextStates.size() << "\n";
+
+			for (unsigned int s = 0; s < n; s++) {
+				for (unsigned int a = 0; a < m; a++) {
+					for (unsigned int i = rowStarts[s * m + a]; i < rowStarts[s * m + a + 1]; i++) {
+						file << s << " " << a << " " << nextStates[i] << " " <<
+								RiSAS->get(states[s], actions[a], states[nextStates[i]]) << "\n";
+					}
+				}
+			}
+		}
+	}
+
+	if (!file.good()) {
+		log_message("RawFile::save_sparse_raw_mdp", "Failed to write the file '" + filename + "'.");
+		throw CoreException();
+	}
+
+	file.close();
+}
+
+MDP *RawFile::load_binary_mdp(std::string filename)
+{
+	// Map the file. The arrays created below share ownership of the mapping, so it is released
+	// once the last of them is destroyed.
+	std::shared_ptr<MappedFile> mapping(new MappedFile(filename));
+
+	char *data = mapping->get_data();
+	uint64_t size = mapping->get_size();
+
+	// Read and check the header.
+	if (size < sizeof(RawFileBinaryHeader)) {
+		log_message("RawFile::load_binary_mdp", "The file '" + filename + "' is too small to be a binary model.");
+		throw CoreException();
+	}
+
+	const RawFileBinaryHeader *header = (const RawFileBinaryHeader *)data;
+
+	if (std::memcmp(header->magic, "LIBRBR\0\0", 8) != 0) {
+		log_message("RawFile::load_binary_mdp", "The file '" + filename + "' is not a binary model.");
+		throw CoreException();
+	}
+
+	if (header->version != RAW_FILE_BINARY_VERSION) {
+		log_message("RawFile::load_binary_mdp",
+				"Unsupported version " + std::to_string(header->version) + " of the file '" + filename + "'.");
+		throw CoreException();
+	}
+
+	if (header->byteOrder != 0x01020304) {
+		log_message("RawFile::load_binary_mdp",
+				"The file '" + filename + "' was saved on a machine with a different byte order.");
+		throw CoreException();
+	}
+
+	if (header->modelType != RawFileBinaryModelType::RawFileBinaryMDP) {
+		log_message("RawFile::load_binary_mdp", "The file '" + filename + "' does not contain an MDP.");
+		throw CoreException();
+	}
+
+	unsigned int n = header->numStates;
+	unsigned int m = header->numActions;
+	unsigned int k = header->numRewardFactors;
+	unsigned int r = header->rewardsType;
+
+	if (n == 0 || m == 0 || k == 0) {
+		log_message("RawFile::load_binary_mdp",
+				"Invalid number of states, actions, or reward factors in the header for file '" + filename + "'.");
+		throw CoreException();
+	}
+
+	if (r != RawFileRewardsType::RawFileSARewards && r != RawFileRewardsType::RawFileSASRewards) {
+		log_message("RawFile::load_binary_mdp",
+				"Invalid rewards type in the header for file '" + filename + "'.");
+		throw CoreException();
+	}
+
+	if (header->initialState >= n) {
+		log_message("RawFile::load_binary_mdp",
+				"Invalid initial state in the header for file '" + filename + "'.");
+		throw CoreException();
+	}
+
+	if (header->discountFactor < 0.0 || header->discountFactor > 1.0) {
+		log_message("RawFile::load_binary_mdp",
+				"Invalid discount factor (gamma) in the header for file '" + filename + "'.");
+		throw CoreException();
+	}
+
+	// The arrays are indexed with unsigned ints, so their sizes must fit within one.
+	uint64_t numTransitions = (uint64_t)n * m * n;
+	uint64_t numRewards = (r == RawFileRewardsType::RawFileSARewards) ? (uint64_t)n * m : numTransitions;
+
+	if (numTransitions > std::numeric_limits<unsigned int>::max()) {
+		log_message("RawFile::load_binary_mdp", "The model in file '" + filename + "' is too large.");
+		throw CoreException();
+	}
+
+	// Check the table of blocks: the state transitions followed by each reward factor, each dense,
+	// aligned, and entirely within the file.
+	if (header->numBlocks != 1 + (uint64_t)k ||
+			size < sizeof(RawFileBinaryHeader) + header->numBlocks * sizeof(RawFileBinaryBlock)) {
+		log_message("RawFile::load_binary_mdp", "Invalid table of blocks for file '" + filename + "'.");
+		throw CoreException();
+	}
+
+	const RawFileBinaryBlock *blocks = (const RawFileBinaryBlock *)(data + sizeof(RawFileBinaryHeader));
+
+	for (unsigned int i = 0; i <= k; i++) {
+		uint32_t type = (i == 0) ? RawFileBinaryBlockType::RawFileBinaryStateTransitions :
+				RawFileBinaryBlockType::RawFileBinaryRewards;
+		uint64_t count = (i == 0) ? numTransitions : numRewards;
+
+		if (blocks[i].type != type || blocks[i].encoding != RawFileBinaryEncoding::RawFileBinaryDense ||
+				blocks[i].count != count || blocks[i].offset % RAW_FILE_BINARY_ALIGNMENT != 0 ||
+				blocks[i].offset > size || count > (size - blocks[i].offset) / sizeof(float)) {
+			log_message("RawFile::load_binary_mdp",
+					"Invalid block " + std::to_string(i) + " for file '" + filename + "'.");
 			throw CoreException();
 		}
+	}
 
-		for (unsigned int c = 0; c < cols; c++) {
-			try {
-				array[offset + (r * cols + c)] = std::stof(items[c]);
-			} catch (std::exception &err) {
-				throw CoreException();
+	// Create the states and actions.
+	StatesMap *states = new StatesMap();
+	for (unsigned int i = 0; i < n; i++) {
+		states->add(new IndexedState(i));
+	}
+
+	ActionsMap *actions = new ActionsMap();
+	for (unsigned int i = 0; i < m; i++) {
+		actions->add(new IndexedAction(i));
+	}
+
+	// Create the state transitions and rewards directly over the mapped blocks.
+	StateTransitionsArray *stateTransitions = new StateTransitionsArray(n, m,
+			(float *)(data + blocks[0].offset), mapping);
+
+	Rewards *rewards = nullptr;
+
+	for (unsigned int i = 0; i < k; i++) {
+		const RawFileBinaryBlock &block = blocks[1 + i];
+		float *R = (float *)(data + block.offset);
+
+		Rewards *Ri = nullptr;
+		if (r == RawFileRewardsType::RawFileSARewards) {
+			Ri = new SARewardsArray(n, m, R, block.min, block.max, mapping);
+		} else {
+			Ri = new SASRewardsArray(n, m, R, block.min, block.max, mapping);
+		}
+
+		// As with raw files, a single factor is the rewards; otherwise, they are factored rewards.
+		if (k == 1) {
+			rewards = Ri;
+		} else {
+			if (rewards == nullptr) {
+				rewards = new FactoredRewards();
 			}
+			dynamic_cast<FactoredRewards *>(rewards)->add_factor(Ri);
+		}
+	}
+
+	// Create the horizon.
+	Horizon *horizon = new Horizon();
+	horizon->set_discount_factor(header->discountFactor);
+	horizon->set_horizon(header->horizon);
+
+	return new MDP(states, actions, stateTransitions, rewards, horizon);
+}
+
+void RawFile::save_binary_mdp(MDP *mdp, std::string filename)
+{
+	if (mdp == nullptr) {
+		log_message("RawFile::save_binary_mdp", "Failed to save an invalid MDP to the file '" + filename + "'.");
+		throw CoreException();
+	}
+
+	StatesMap *S = dynamic_cast<StatesMap *>(mdp->get_states());
+	ActionsMap *A = dynamic_cast<ActionsMap *>(mdp->get_actions());
+	StateTransitions *T = mdp->get_state_transitions();
+	Horizon *h = mdp->get_horizon();
+
+	if (S == nullptr || S->get_num_states() == 0 || A == nullptr || A->get_num_actions() == 0 ||
+			T == nullptr || mdp->get_rewards() == nullptr || h == nullptr) {
+		log_message("RawFile::save_binary_mdp",
+				"Failed to parse the MDP provided and save the file '" + filename + "'.");
+		throw CoreException();
+	}
+
+	// Collect the reward factors, and determine their type. SA rewards are stored more compactly,
+	// so they are only used if every factor is one.
+	std::vector<Rewards *> factors;
+
+	FactoredRewards *RF = dynamic_cast<FactoredRewards *>(mdp->get_rewards());
+	if (RF != nullptr) {
+		for (unsigned int i = 0; i < RF->get_num_rewards(); i++) {
+			factors.push_back(RF->get(i));
+		}
+	} else {
+		factors.push_back(mdp->get_rewards());
+	}
+
+	bool allSA = true;
+	for (Rewards *Ri : factors) {
+		if (dynamic_cast<SASRewards *>(Ri) == nullptr) {
+			log_message("RawFile::save_binary_mdp",
+					"Unsupported type of rewards, and thus failed to save the file '" + filename + "'.");
+			throw CoreException();
 		}
+		allSA = allSA && (dynamic_cast<SARewards *>(Ri) != nullptr);
+	}
+
+	std::vector<State *> states = order_policy_states(S);
+	std::vector<Action *> actions = order_policy_actions(A);
+
+	unsigned int n = states.size();
+	unsigned int m = actions.size();
+	unsigned int k = factors.size();
+
+	// Create the header and the table of blocks, with each block aligned after the previous one.
+	RawFileBinaryHeader header;
+	std::memset(&header, 0, sizeof(RawFileBinaryHeader));
+	std::memcpy(header.magic, "LIBRBR\0\0", 8);
+	header.version = RAW_FILE_BINARY_VERSION;
+	header.byteOrder = 0x01020304;
+	header.modelType = RawFileBinaryModelType::RawFileBinaryMDP;
+	header.numStates = n;
+	header.numActions = m;
+	header.numRewardFactors = k;
+	header.rewardsType = allSA ? RawFileRewardsType::RawFileSARewards : RawFileRewardsType::RawFileSASRewards;
+	header.initialState = 0;
+	header.horizon = h->get_horizon();
+	header.discountFactor = h->get_discount_factor();
+	header.numBlocks = 1 + k;
+
+	std::vector<RawFileBinaryBlock> blocks(1 + k);
+
+	uint64_t offset = sizeof(RawFileBinaryHeader) + blocks.size() * sizeof(RawFileBinaryBlock);
+	for (unsigned int i = 0; i <= k; i++) {
+		offset = (offset + RAW_FILE_BINARY_ALIGNMENT - 1) / RAW_FILE_BINARY_ALIGNMENT * RAW_FILE_BINARY_ALIGNMENT;
+
+		blocks[i].type = (i == 0) ? RawFileBinaryBlockType::RawFileBinaryStateTransitions :
+				RawFileBinaryBlockType::RawFileBinaryRewards;
+		blocks[i].encoding = RawFileBinaryEncoding::RawFileBinaryDense;
+		blocks[i].offset = offset;
+		blocks[i].count = (i > 0 && allSA) ? (uint64_t)n * m : (uint64_t)n * m * n;
+		blocks[i].min = std::numeric_limits<double>::infinity();
+		blocks[i].max = -std::numeric_limits<double>::infinity();
+
+		offset += blocks[i].count * sizeof(float);
 	}
+
+	std::ofstream file(filename, std::ios::out | std::ios::binary);
+
+	if (!file.is_open()) {
+		log_message("RawFile::save_binary_mdp", "Failed to create the file '" + filename + "'.");
+		throw CoreException();
+	}
+
+	// The table is written again at the end, once the extreme value of each block is known.
+	file.write((const char *)&header, sizeof(RawFileBinaryHeader));
+	file.write((const char *)blocks.data(), blocks.size() * sizeof(RawFileBinaryBlock));
+
+	// Arrays over indexed states and actions (stored by index) are written directly, row by row.
+	bool indexed = TableIndex<IndexedState, State>(states).is_indexed() &&
+			TableIndex<IndexedAction, Action>(actions).is_indexed();
+
+	std::vector<float> row(n);
+	const char zeros[RAW_FILE_BINARY_ALIGNMENT] = { 0 };
+
+	for (unsigned int i = 0; i <= k; i++) {
+		RawFileBinaryBlock &block = blocks[i];
+		file.write(zeros, block.offset - (uint64_t)file.tellp());
+
+		const float *raw = nullptr;
+		StateTransitionsArray *TA = dynamic_cast<StateTransitionsArray *>(T);
+		SARewardsArray *RiSA = nullptr;
+		SASRewardsArray *RiSAS = nullptr;
+
+		if (i == 0) {
+			if (indexed && TA != nullptr && TA->get_num_states() == n && TA->get_num_actions() == m) {
+				raw = TA->get_state_transitions();
+			}
+		} else if (allSA) {
+			RiSA = dynamic_cast<SARewardsArray *>(factors[i - 1]);
+			if (indexed && RiSA != nullptr && RiSA->get_num_states() == n && RiSA->get_num_actions() == m) {
+				raw = RiSA->get_rewards();
+			}
+		} else {
+			RiSAS = dynamic_cast<SASRewardsArray *>(factors[i - 1]);
+			if (indexed && RiSAS != nullptr && RiSAS->get_num_states() == n && RiSAS->get_num_actions() == m) {
+				raw = RiSAS->get_rewards();
+			}
+		}
+
+		// Each row is over next states, or over actions for SA rewards.
+		unsigned int numRows = (i > 0 && allSA) ? n : n * m;
+		unsigned int numCols = (i > 0 && allSA) ? m : n;
+
+		for (unsigned int j = 0; j < numRows; j++) {
+			if (raw != nullptr) {
+				std::copy(raw + (uint64_t)j * numCols, raw + (uint64_t)(j + 1) * numCols, row.begin());
+			} else if (i > 0 && allSA) {
+				for (unsigned int a = 0; a < m; a++) {
+					row[a] = (float)dynamic_cast<SARewards *>(factors[i - 1])->get(states[j], actions[a]);
+				}
+			} else {
+				State *s = states[j / m];
+				Action *a = actions[j % m];
+				for (unsigned int sp = 0; sp < n; sp++) {
+					if (i == 0) {
+						row[sp] = (float)T->get(s, a, states[sp]);
+					} else {
+						row[sp] = (float)dynamic_cast<SASRewards *>(factors[i - 1])->get(s, a, states[sp]);
+					}
+				}
+			}
+
+			for (unsigned int c = 0; c < numCols; c++) {
+				block.min = std::min(block.min, (double)row[c]);
+				block.max = std::max(block.max, (double)row[c]);
+			}
+
+			file.write((const char *)row.data(), numCols * sizeof(float));
+		}
+	}
+
+	file.seekp(sizeof(RawFileBinaryHeader));
+	file.write((const char *)blocks.data(), blocks.size() * sizeof(RawFileBinaryBlock));
+
+	if (!file.good()) {
+		log_message("RawFile::save_binary_mdp", "Failed to write the file '" + filename + "'.");
+		throw CoreException();
+	}
+
+	file.close();
+}
+
+void RawFile::save_streamed_mdp(MDP *mdp, std::string filename)
+{
+	if (mdp == nullptr) {
+		log_message("RawFile::save_streamed_mdp", "Failed to save an invalid MDP to the file '" + filename + "'.");
+		throw CoreException();
+	}
+
+	StatesMap *S = dynamic_cast<StatesMap *>(mdp->get_states());
+	ActionsMap *A = dynamic_cast<ActionsMap *>(mdp->get_actions());
+	StateTransitions *T = mdp->get_state_transitions();
+	SASRewards *R = dynamic_cast<SASRewards *>(mdp->get_rewards());
+	Horizon *h = mdp->get_horizon();
+
+	if (S == nullptr || S->get_num_states() == 0 || A == nullptr || A->get_num_actions() == 0 ||
+			T == nullptr || R == nullptr || h == nullptr) {
+		log_message("RawFile::save_streamed_mdp",
+				"Failed to parse the MDP provided and save the file '" + filename + "'.");
+		throw CoreException();
+	}
+
+	std::vector<State *> states = order_policy_states(S);
+	std::vector<Action *> actions = order_policy_actions(A);
+
+	unsigned int n = states.size();
+	unsigned int m = actions.size();
+
+	TableIndex<IndexedState, State> stateIndexes(states);
+
+	RawFileBinaryHeader header;
+	std::memset(&header, 0, sizeof(RawFileBinaryHeader));
+	std::memcpy(header.magic, "LIBRBR\0\0", 8);
+	header.version = RAW_FILE_BINARY_VERSION;
+	header.byteOrder = 0x01020304;
+	header.modelType = RawFileBinaryModelType::RawFileBinaryStreamedMDP;
+	header.numStates = n;
+	header.numActions = m;
+	header.numRewardFactors = 1;
+	header.rewardsType = RawFileRewardsType::RawFileSASRewards;
+	header.initialState = 0;
+	header.horizon = h->get_horizon();
+	header.discountFactor = h->get_discount_factor();
+	header.numBlocks = 0;
+
+	std::ofstream file(filename, std::ios::out | std::ios::binary);
+
+	if (!file.is_open()) {
+		log_message("RawFile::save_streamed_mdp", "Failed to create the file '" + filename + "'.");
+		throw CoreException();
+	}
+
+	// The header is written again at the end, once the number of blocks is known.
+	file.write((const char *)&header, sizeof(RawFileBinaryHeader));
+
+	const char zeros[RAW_FILE_BINARY_ALIGNMENT] = { 0 };
+
+	RawFileStreamBlock block;
+	std::memset(&block, 0, sizeof(RawFileStreamBlock));
+
+	std::vector<uint64_t> rows(1, 0);
+	std::vector<RawFileStreamEntry> entries;
+
+	for (unsigned int s = 0; s < n; s++) {
+		for (unsigned int a = 0; a < m; a++) {
+			const std::vector<State *> *successors = &states;
+			try {
+				successors = &T->successors(S, states[s], actions[a]);
+			} catch (const StateTransitionException &err) { }
+
+			for (State *sp : *successors) {
+				double probability = T->get(states[s], actions[a], sp);
+				if (probability == 0.0) {
+					continue;
+				}
+
+				RawFileStreamEntry entry;
+				entry.state = stateIndexes.find(sp);
+				if (entry.state == n) {
+					log_message("RawFile::save_streamed_mdp",
+							"A successor is not one of the states, and thus failed to save the file '" + filename + "'.");
+					throw CoreException();
+				}
+				entry.probability = (float)probability;
+				entry.reward = (float)R->get(states[s], actions[a], sp);
+				entries.push_back(entry);
+			}
+
+			rows.push_back(entries.size());
+		}
+
+		// Write the block once it is large enough, or if this is the last state.
+		uint64_t size = sizeof(RawFileStreamBlock) + rows.size() * sizeof(uint64_t) +
+				entries.size() * sizeof(RawFileStreamEntry);
+		if (size < RAW_FILE_STREAM_BLOCK_SIZE && s + 1 < n) {
+			continue;
+		}
+
+		block.numStates = s + 1 - block.firstState;
+		block.numEntries = entries.size();
+		block.size = (size + RAW_FILE_BINARY_ALIGNMENT - 1) / RAW_FILE_BINARY_ALIGNMENT * RAW_FILE_BINARY_ALIGNMENT;
+
+		file.write((const char *)&block, sizeof(RawFileStreamBlock));
+		file.write((const char *)rows.data(), rows.size() * sizeof(uint64_t));
+		file.write((const char *)entries.data(), entries.size() * sizeof(RawFileStreamEntry));
+		file.write(zeros, block.size - size);
+
+		header.numBlocks++;
+
+		block.firstState = s + 1;
+		rows.assign(1, 0);
+		entries.clear();
+	}
+
+	file.seekp(0);
+	file.write((const char *)&header, sizeof(RawFileBinaryHeader));
+
+	if (!file.good()) {
+		log_message("RawFile::save_streamed_mdp", "Failed to write the file '" + filename + "'.");
+		throw CoreException();
+	}
+
+	file.close();
+}
+
+POMDP *RawFile::load_raw_pomdp(std::string filename)
+{
+	// The file is mapped and parsed line by line, directly into the arrays.
+	MappedFile mappedFile(filename);
+
+	Tokenizer tokenizer(mappedFile.get_data(), mappedFile.get_size());
+	unsigned int row = 0;
+
+	// Attempt to read the header information: number of states (n), number of actions (m), number of
+	// observations (z), number of reward factors (k), rewards type (r), the initial state (s0), the
+	// horizon (h), and the discount factor (g).
+	unsigned int header[7];
+	double g = 1.0;
+
+	if (next_values(tokenizer, row, header, 7, &g)) {
+		log_message("RawFile::load_raw_pomdp", "Failed to read the header from file '" + filename + "'.");
+		throw CoreException();
+	}
+
+	unsigned int n = header[0];
+	unsigned int m = header[1];
+	unsigned int z = header[2];
+	unsigned int k = header[3];
+	unsigned int r = header[4];
+	unsigned int s0 = header[5];
+	unsigned int h = header[6];
+
+	check_header(filename, n, m, k, r, s0, g);
+
+	if (z == 0) {
+		log_message("RawFile::load_raw_pomdp",
+				"Invalid number of observations in the header for file '" + filename + "'.");
+		throw CoreException();
+	}
+
+	if (r == RawFileRewardsType::RawFileSRewards) {
+		// ToDo: Implement this after creating SRewards.
+		log_message("RawFile::load_raw_pomdp", "Unsupported rewards type for the file '" + filename + "'.");
+		throw CoreException();
+	}
+
+	// Create all of the objects first, so that each block is loaded directly into its array.
+	StatesMap *states = create_states(n);
+	ActionsMap *actions = create_actions(m);
+	ObservationsMap *observations = create_observations(z);
+
+	StateTransitionsArray *stateTransitions = new StateTransitionsArray(n, m);
+	ObservationTransitionsArray *observationTransitions = new ObservationTransitionsArray(n, m, z);
+	std::vector<Rewards *> factors;
+
+	bool error = load_block(tokenizer, row, n * m, n, stateTransitions->get_state_transitions()) ||
+			load_block(tokenizer, row, m * n, z, observationTransitions->get_observation_transitions());
+
+	for (unsigned int i = 0; i < k && !error; i++) {
+		// Setting the rewards to themselves computes their minimum and maximum values.
+		if (r == RawFileRewardsType::RawFileSARewards) {
+			SARewardsArray *RiSA = new SARewardsArray(n, m);
+			factors.push_back(RiSA);
+
+			error = load_block(tokenizer, row, n, m, RiSA->get_rewards());
+			RiSA->set_rewards(RiSA->get_rewards());
+		} else if (r == RawFileRewardsType::RawFileSASRewards) {
+			SASRewardsArray *RiSAS = new SASRewardsArray(n, m);
+			factors.push_back(RiSAS);
+
+			error = load_block(tokenizer, row, n * m, n, RiSAS->get_rewards());
+			RiSAS->set_rewards(RiSAS->get_rewards());
+		} else {
+			SASORewardsArray *RiSASO = new SASORewardsArray(n, m, z);
+			factors.push_back(RiSASO);
+
+			error = load_block(tokenizer, row, n * m * n, z, RiSASO->get_rewards());
+			RiSASO->set_rewards(RiSASO->get_rewards());
+		}
+	}
+
+	if (error) {
+		log_message("RawFile::load_raw_pomdp", "Failed to load the data on line " + std::to_string(row) +
+				" of file '" + filename + "'.");
+
+		delete stateTransitions;
+		delete observationTransitions;
+		for (Rewards *Ri : factors) {
+			delete Ri;
+		}
+		delete states;
+		delete actions;
+		delete observations;
+
+		throw CoreException();
+	}
+
+	// Combine the reward factors, if there are more than one.
+	Rewards *rewards = factors[0];
+	if (k > 1) {
+		FactoredRewards *RF = new FactoredRewards();
+		for (Rewards *Ri : factors) {
+			RF->add_factor(Ri);
+		}
+		rewards = RF;
+	}
+
+	// Create the horizon.
+	Horizon *horizon = new Horizon();
+	horizon->set_discount_factor(g);
+	horizon->set_horizon(h);
+
+	return new POMDP(states, actions, observations, stateTransitions, observationTransitions, rewards, horizon);
+}
+
+void RawFile::save_raw_pomdp(POMDP *pomdp, std::string filename)
+{
+	if (pomdp == nullptr) {
+		log_message("RawFile::save_raw_pomdp", "Failed to save an invalid POMDP to the file '" + filename + "'.");
+		throw CoreException();
+	}
+
+	StatesMap *S = dynamic_cast<StatesMap *>(pomdp->get_states());
+	ActionsMap *A = dynamic_cast<ActionsMap *>(pomdp->get_actions());
+	ObservationsMap *Z = dynamic_cast<ObservationsMap *>(pomdp->get_observations());
+	StateTransitions *T = pomdp->get_state_transitions();
+	ObservationTransitions *O = pomdp->get_observation_transitions();
+	Horizon *h = pomdp->get_horizon();
+
+	if (S == nullptr || S->get_num_states() == 0 || A == nullptr || A->get_num_actions() == 0 ||
+			Z == nullptr || Z->get_num_observations() == 0 || T == nullptr || O == nullptr ||
+			pomdp->get_rewards() == nullptr || h == nullptr) {
+		log_message("RawFile::save_raw_pomdp",
+				"Failed to parse the POMDP provided and save the file '" + filename + "'.");
+		throw CoreException();
+	}
+
+	std::vector<Rewards *> factors;
+	unsigned int r = find_rewards_type(pomdp->get_rewards(), factors);
+
+	std::vector<State *> states = order_policy_states(S);
+	std::vector<Action *> actions = order_policy_actions(A);
+	std::vector<Observation *> observations = order_policy_observations(Z);
+
+	std::ofstream file(filename);
+
+	if (!file.is_open()) {
+		log_message("RawFile::save_raw_pomdp", "Failed to create the file '" + filename + "'.");
+		throw CoreException();
+	}
+
+	// Use enough digits so that every float value is loaded exactly.
+	file.precision(std::numeric_limits<float>::max_digits10);
+
+	file << states.size() << " " << actions.size() << " " << observations.size() << " " << factors.size() << " ";
+	file << r << " 0 " << h->get_horizon() << " " << h->get_discount_factor() << std::endl;
+
+	for (State *s : states) {
+		for (Action *a : actions) {
+			for (unsigned int sp = 0; sp < states.size(); sp++) {
+				file << (float)T->get(s, a, states[sp]) << ((sp < states.size() - 1) ? " " : "\n");
+			}
+		}
+	}
+
+	save_pomdp_blocks(file, O, factors, r, states, actions, observations);
+
+	if (!file.good()) {
+		log_message("RawFile::save_raw_pomdp", "Failed to write the file '" + filename + "'.");
+		throw CoreException();
+	}
+
+	file.close();
+}
+
+DecPOMDP *RawFile::load_raw_decpomdp(std::string filename)
+{
+	MappedFile mappedFile(filename);
+
+	Tokenizer tokenizer(mappedFile.get_data(), mappedFile.get_size());
+	unsigned int row = 0;
+
+	// Attempt to read the header information: number of agents (N), number of states (n), number of
+	// reward factors (k), rewards type (r), the initial state (s0), the horizon (h), and the discount
+	// factor (g). Then, the number of actions and observations of each agent follow on their own lines.
+	unsigned int header[6];
+	double g = 1.0;
+
+	if (next_values(tokenizer, row, header, 6, &g) || header[0] == 0) {
+		log_message("RawFile::load_raw_decpomdp", "Failed to read the header from file '" + filename + "'.");
+		throw CoreException();
+	}
+
+	unsigned int N = header[0];
+	unsigned int n = header[1];
+	unsigned int k = header[2];
+	unsigned int r = header[3];
+	unsigned int s0 = header[4];
+	unsigned int h = header[5];
+
+	std::vector<unsigned int> numActions(N);
+	std::vector<unsigned int> numObservations(N);
+
+	if (next_values(tokenizer, row, numActions.data(), N, nullptr) ||
+			next_values(tokenizer, row, numObservations.data(), N, nullptr)) {
+		log_message("RawFile::load_raw_decpomdp",
+				"Failed to read the numbers of actions and observations from file '" + filename + "'.");
+		throw CoreException();
+	}
+
+	unsigned int m = 1;
+	unsigned int z = 1;
+	for (unsigned int i = 0; i < N; i++) {
+		m *= numActions[i];
+		z *= numObservations[i];
+	}
+
+	check_header(filename, n, m, k, r, s0, g);
+
+	if (z == 0) {
+		log_message("RawFile::load_raw_decpomdp",
+				"Invalid number of observations in the header for file '" + filename + "'.");
+		throw CoreException();
+	}
+
+	if (r == RawFileRewardsType::RawFileSRewards) {
+		// ToDo: Implement this after creating SRewards.
+		log_message("RawFile::load_raw_decpomdp", "Unsupported rewards type for the file '" + filename + "'.");
+		throw CoreException();
+	}
+
+	// Create the agents, and their actions and observations, named by their indexes.
+	Agents *agents = new Agents();
+	JointActionsMap *actions = new JointActionsMap(N);
+	JointObservationsMap *observations = new JointObservationsMap(N);
+
+	for (unsigned int i = 0; i < N; i++) {
+		agents->add(new Agent(std::to_string(i)));
+
+		for (unsigned int j = 0; j < numActions[i]; j++) {
+			actions->add(i, new NamedAction(std::to_string(j)));
+		}
+		for (unsigned int j = 0; j < numObservations[i]; j++) {
+			observations->add(i, new NamedObservation(std::to_string(j)));
+		}
+	}
+
+	actions->update();
+	observations->update();
+
+	StatesMap *states = create_states(n);
+
+	std::vector<State *> S = order_policy_states(states);
+	std::vector<Action *> A = order_policy_actions(actions);
+	std::vector<Observation *> Z = order_policy_observations(observations);
+
+	StateTransitionsMap *stateTransitions = new StateTransitionsMap();
+	ObservationTransitionsMap *observationTransitions = new ObservationTransitionsMap();
+	std::vector<Rewards *> factors;
+
+	// Every row is loaded into this buffer, then each of its values is assigned in the maps.
+	std::vector<float> values(std::max(std::max(n, m), z));
+	bool error = false;
+
+	for (unsigned int s = 0; s < n && !error; s++) {
+		for (unsigned int a = 0; a < m && !error; a++) {
+			error = load_block(tokenizer, row, 1, n, values.data());
+			for (unsigned int sp = 0; sp < n && !error; sp++) {
+				stateTransitions->set(S[s], A[a], S[sp], values[sp]);
+			}
+		}
+	}
+
+	for (unsigned int a = 0; a < m && !error; a++) {
+		for (unsigned int sp = 0; sp < n && !error; sp++) {
+			error = load_block(tokenizer, row, 1, z, values.data());
+			for (unsigned int o = 0; o < z && !error; o++) {
+				observationTransitions->set(A[a], S[sp], Z[o], values[o]);
+			}
+		}
+	}
+
+	for (unsigned int i = 0; i < k && !error; i++) {
+		if (r == RawFileRewardsType::RawFileSARewards) {
+			SARewardsMap *RiSA = new SARewardsMap();
+			factors.push_back(RiSA);
+
+			for (unsigned int s = 0; s < n && !error; s++) {
+				error = load_block(tokenizer, row, 1, m, values.data());
+				for (unsigned int a = 0; a < m && !error; a++) {
+					RiSA->set(S[s], A[a], values[a]);
+				}
+			}
+		} else if (r == RawFileRewardsType::RawFileSASRewards) {
+			SASRewardsMap *RiSAS = new SASRewardsMap();
+			factors.push_back(RiSAS);
+
+			for (unsigned int s = 0; s < n && !error; s++) {
+				for (unsigned int a = 0; a < m && !error; a++) {
+					error = load_block(tokenizer, row, 1, n, values.data());
+					for (unsigned int sp = 0; sp < n && !error; sp++) {
+						RiSAS->set(S[s], A[a], S[sp], values[sp]);
+					}
+				}
+			}
+		} else {
+			SASORewardsMap *RiSASO = new SASORewardsMap();
+			factors.push_back(RiSASO);
+
+			for (unsigned int s = 0; s < n && !error; s++) {
+				for (unsigned int a = 0; a < m && !error; a++) {
+					for (unsigned int sp = 0; sp < n && !error; sp++) {
+						error = load_block(tokenizer, row, 1, z, values.data());
+						for (unsigned int o = 0; o < z && !error; o++) {
+							RiSASO->set(S[s], A[a], S[sp], Z[o], values[o]);
+						}
+					}
+				}
+			}
+		}
+	}
+
+	if (error) {
+		log_message("RawFile::load_raw_decpomdp", "Failed to load the data on line " + std::to_string(row) +
+				" of file '" + filename + "'.");
+
+		delete stateTransitions;
+		delete observationTransitions;
+		for (Rewards *Ri : factors) {
+			delete Ri;
+		}
+		delete agents;
+		delete states;
+		delete actions;
+		delete observations;
+
+		throw CoreException();
+	}
+
+	// Combine the reward factors, if there are more than one.
+	Rewards *rewards = factors[0];
+	if (k > 1) {
+		FactoredRewards *RF = new FactoredRewards();
+		for (Rewards *Ri : factors) {
+			RF->add_factor(Ri);
+		}
+		rewards = RF;
+	}
+
+	// Create the horizon.
+	Horizon *horizon = new Horizon();
+	horizon->set_discount_factor(g);
+	horizon->set_horizon(h);
+
+	return new DecPOMDP(agents, states, actions, observations, stateTransitions, observationTransitions,
+			rewards, horizon);
+}
+
+void RawFile::save_raw_decpomdp(DecPOMDP *decpomdp, std::string filename)
+{
+	if (decpomdp == nullptr) {
+		log_message("RawFile::save_raw_decpomdp",
+				"Failed to save an invalid Dec-POMDP to the file '" + filename + "'.");
+		throw CoreException();
+	}
+
+	Agents *N = decpomdp->get_agents();
+	StatesMap *S = dynamic_cast<StatesMap *>(decpomdp->get_states());
+	JointActionsMap *A = dynamic_cast<JointActionsMap *>(decpomdp->get_actions());
+	JointObservationsMap *Z = dynamic_cast<JointObservationsMap *>(decpomdp->get_observations());
+	StateTransitions *T = decpomdp->get_state_transitions();
+	ObservationTransitions *O = decpomdp->get_observation_transitions();
+	Horizon *h = decpomdp->get_horizon();
+
+	if (N == nullptr || N->get_num_agents() == 0 || S == nullptr || S->get_num_states() == 0 ||
+			A == nullptr || A->get_num_factors() != N->get_num_agents() ||
+			Z == nullptr || Z->get_num_factors() != N->get_num_agents() ||
+			T == nullptr || O == nullptr || decpomdp->get_rewards() == nullptr || h == nullptr) {
+		log_message("RawFile::save_raw_decpomdp",
+				"Failed to parse the Dec-POMDP provided and save the file '" + filename + "'.");
+		throw CoreException();
+	}
+
+	std::vector<Rewards *> factors;
+	unsigned int r = find_rewards_type(decpomdp->get_rewards(), factors);
+
+	std::vector<State *> states = order_policy_states(S);
+	std::vector<Action *> actions = order_policy_actions(A);
+	std::vector<Observation *> observations = order_policy_observations(Z);
+
+	std::ofstream file(filename);
+
+	if (!file.is_open()) {
+		log_message("RawFile::save_raw_decpomdp", "Failed to create the file '" + filename + "'.");
+		throw CoreException();
+	}
+
+	// Use enough digits so that every float value is loaded exactly.
+	file.precision(std::numeric_limits<float>::max_digits10);
+
+	file << N->get_num_agents() << " " << states.size() << " " << factors.size() << " " << r << " 0 ";
+	file << h->get_horizon() << " " << h->get_discount_factor() << std::endl;
+
+	for (unsigned int i = 0; i < N->get_num_agents(); i++) {
+		file << A->get_factor(i).size() << ((i < N->get_num_agents() - 1) ? " " : "\n");
+	}
+	for (unsigned int i = 0; i < N->get_num_agents(); i++) {
+		file << Z->get_factor(i).size() << ((i < N->get_num_agents() - 1) ? " " : "\n");
+	}
+
+	for (State *s : states) {
+		for (Action *a : actions) {
+			for (unsigned int sp = 0; sp < states.size(); sp++) {
+				file << (float)T->get(s, a, states[sp]) << ((sp < states.size() - 1) ? " " : "\n");
+			}
+		}
+	}
+
+	save_pomdp_blocks(file, O, factors, r, states, actions, observations);
+
+	if (!file.good()) {
+		log_message("RawFile::save_raw_decpomdp", "Failed to write the file '" + filename + "'.");
+		throw CoreException();
+	}
+
+	file.close();
+}
+
+void RawFile::load_data(std::ifstream &file, unsigned int rows, unsigned int cols, float *array, unsigned int offset)
+{
+	// For each of the rows, attempt to read and parse the line.
+	for (unsigned int r = 0; r < rows; r++) {
+		if (file.eof()) {
+			throw CoreException();
+		}
+
+		std::string line;
+		std::getline(file, line);
+
+		// Split the line by ' ', attempt to convert each token into a float, and assign the value in
+		// the array, if successful.
+		std::vector<std::string> items = split_string_by_space(line);
+		if (items.size() != cols) {
+			throw CoreException();
+		}
+
+		for (unsigned int c = 0; c < cols; c++) {
+			try {
+				array[offset + (r * cols + c)] = std::stof(items[c]);
+			} catch (std::exception &err) {
+				throw CoreException();
+			}
+		}
+	}
+}
+
+MDP *RawFile::load_sparse_raw_mdp(std::string filename)
+{
+	// The file is mapped and streamed line by line, without any intermediate copies.
+	MappedFile mappedFile(filename);
+
+	Tokenizer tokenizer(mappedFile.get_data(), mappedFile.get_size());
+	unsigned int row = 0;
+
+	Token items[4];
+	int values[4];
+
+	// Skip the "sparse" line, then read the header, just like a dense raw file.
+	unsigned int header[6];
+	double g = 1.0;
+
+	if (next_items(tokenizer, row, items, 1) || next_values(tokenizer, row, header, 6, &g)) {
+		log_message("RawFile::load_raw_mdp", "Failed to read the header from file '" + filename + "'.");
+		throw CoreException();
+	}
+
+	unsigned int n = header[0];
+	unsigned int m = header[1];
+	unsigned int k = header[2];
+	unsigned int r = header[3];
+	unsigned int s0 = header[4];
+	unsigned int h = header[5];
+
+	check_header(filename, n, m, k, r, s0, g);
+
+	if (r != RawFileRewardsType::RawFileSARewards && r != RawFileRewardsType::RawFileSASRewards) {
+		log_message("RawFile::load_raw_mdp", "Unsupported rewards type for the sparse file '" + filename + "'.");
+		throw CoreException();
+	}
+
+	// Create the states and actions first, so that the values can be assigned while streaming.
+	StatesMap *states = create_states(n);
+	ActionsMap *actions = create_actions(m);
+
+	std::vector<State *> S(n);
+	for (unsigned int i = 0; i < n; i++) {
+		S[i] = states->get(i);
+	}
+
+	std::vector<Action *> A(m);
+	for (unsigned int i = 0; i < m; i++) {
+		A[i] = actions->get(i);
+	}
+
+	StateTransitionsSparseArray *stateTransitions = new StateTransitionsSparseArray(n, m);
+	std::vector<Rewards *> factors;
+	std::vector<Token> rewardItems(m);
+
+	// Read one block of "s a s' value" lines, following a line with their number, and assign each value.
+	auto load_triples = [&](std::function<void(unsigned int, unsigned int, unsigned int, double)> assign) {
+		int count = 0;
+		if (next_items(tokenizer, row, items, 1) || !Tokenizer::parse_int(items[0], count) || count < 0) {
+			log_message("RawFile::load_raw_mdp", "Failed to read the number of values on line " +
+					std::to_string(row) + " of file '" + filename + "'.");
+			throw CoreException();
+		}
+
+		for (int i = 0; i < count; i++) {
+			double value = 0.0;
+
+			if (next_items(tokenizer, row, items, 4) ||
+					!Tokenizer::parse_int(items[0], values[0]) || values[0] < 0 || (unsigned int)values[0] >= n ||
+					!Tokenizer::parse_int(items[1], values[1]) || values[1] < 0 || (unsigned int)values[1] >= m ||
+					!Tokenizer::parse_int(items[2], values[2]) || values[2] < 0 || (unsigned int)values[2] >= n ||
+					!Tokenizer::parse_double(items[3], value)) {
+				log_message("RawFile::load_raw_mdp", "Failed to parse line " + std::to_string(row) +
+						" of file '" + filename + "'.");
+				throw CoreException();
+			}
+
+			assign(values[0], values[1], values[2], value);
+		}
+	};
+
+	try {
+		load_triples([&](unsigned int s, unsigned int a, unsigned int sp, double p) {
+			stateTransitions->set(S[s], A[a], S[sp], p);
+		});
+
+		for (unsigned int i = 0; i < k; i++) {
+			if (r == RawFileRewardsType::RawFileSARewards) {
+				// SA rewards are dense, with one line of rewards for each state.
+				SARewardsArray *RiSA = new SARewardsArray(n, m);
+				factors.push_back(RiSA);
+
+				for (unsigned int s = 0; s < n; s++) {
+					if (next_items(tokenizer, row, rewardItems.data(), m)) {
+						log_message("RawFile::load_raw_mdp", "Failed to load SA reward data on line " +
+								std::to_string(row) + " of file '" + filename + "'.");
+						throw CoreException();
+					}
+
+					for (unsigned int a = 0; a < m; a++) {
+						double reward = 0.0;
+						if (!Tokenizer::parse_double(rewardItems[a], reward)) {
+							log_message("RawFile::load_raw_mdp", "Failed to load SA reward data on line " +
+									std::to_string(row) + " of file '" + filename + "'.");
+							throw CoreException();
+						}
+						RiSA->set(S[s], A[a], reward);
+					}
+				}
+			} else {
+				SASRewardsMap *RiSAS = new SASRewardsMap();
+				factors.push_back(RiSAS);
+
+				load_triples([&](unsigned int s, unsigned int a, unsigned int sp, double reward) {
+					// Rewards are floats in every raw file, so this matches the original value exactly.
+					RiSAS->set(S[s], A[a], S[sp], (float)reward);
+				});
+			}
+		}
+	} catch (const CoreException &err) {
+		delete stateTransitions;
+		for (Rewards *Ri : factors) {
+			delete Ri;
+		}
+		delete states;
+		delete actions;
+		throw err;
+	}
+
+	// Combine the reward factors, if there are more than one.
+	Rewards *rewards = factors[0];
+	if (k > 1) {
+		FactoredRewards *RF = new FactoredRewards();
+		for (Rewards *Ri : factors) {
+			RF->add_factor(Ri);
+		}
+		rewards = RF;
+	}
+
+	// Create the horizon.
+	Horizon *horizon = new Horizon();
+	horizon->set_discount_factor(g);
+	horizon->set_horizon(h);
+
+	return new MDP(states, actions, stateTransitions, rewards, horizon);
+}
+
+bool RawFile::next_items(Tokenizer &tokenizer, unsigned int &row, Token *items, unsigned int numItems)
+{
+	Token line;
+
+	do {
+		if (!tokenizer.next_line(line)) {
+			return true;
+		}
+		row++;
+	} while (Tokenizer::count_items(line) == 0);
+
+	for (unsigned int i = 0; i < numItems; i++) {
+		if (!Tokenizer::next_item(line, items[i])) {
+			return true;
+		}
+	}
+
+	Token extra;
+	return Tokenizer::next_item(line, extra);
+}
+
+bool RawFile::next_values(Tokenizer &tokenizer, unsigned int &row, unsigned int *values, unsigned int numValues,
+		double *g)
+{
+	unsigned int numItems = numValues + (g != nullptr ? 1 : 0);
+	std::vector<Token> items(numItems);
+
+	if (next_items(tokenizer, row, items.data(), numItems)) {
+		return true;
+	}
+
+	for (unsigned int i = 0; i < numValues; i++) {
+		int value = 0;
+		if (!Tokenizer::parse_int(items[i], value) || value < 0) {
+			return true;
+		}
+		values[i] = value;
+	}
+
+	return (g != nullptr && !Tokenizer::parse_double(items[numValues], *g));
+}
+
+bool RawFile::load_block(Tokenizer &tokenizer, unsigned int &row, unsigned int rows, unsigned int cols, float *array)
+{
+	std::vector<Token> items(cols);
+
+	for (unsigned int r = 0; r < rows; r++) {
+		if (next_items(tokenizer, row, items.data(), cols)) {
+			return true;
+		}
+
+		for (unsigned int c = 0; c < cols; c++) {
+			double value = 0.0;
+			if (!Tokenizer::parse_double(items[c], value)) {
+				return true;
+			}
+			array[r * cols + c] = (float)value;
+		}
+	}
+
+	return false;
+}
+
+unsigned int RawFile::find_rewards_type(Rewards *R, std::vector<Rewards *> &factors)
+{
+	factors.clear();
+
+	FactoredRewards *RF = dynamic_cast<FactoredRewards *>(R);
+	if (RF != nullptr) {
+		for (unsigned int i = 0; i < RF->get_num_rewards(); i++) {
+			factors.push_back(RF->get(i));
+		}
+	} else {
+		factors.push_back(R);
+	}
+
+	// Use the most compact type which every factor has.
+	bool allSA = true;
+	bool allSAS = true;
+
+	for (Rewards *Ri : factors) {
+		if (dynamic_cast<SASORewards *>(Ri) == nullptr) {
+			log_message("RawFile::find_rewards_type", "Unsupported type of rewards.");
+			throw CoreException();
+		}
+		allSA = allSA && (dynamic_cast<SARewards *>(Ri) != nullptr);
+		allSAS = allSAS && (dynamic_cast<SASRewards *>(Ri) != nullptr);
+	}
+
+	if (allSA) {
+		return RawFileRewardsType::RawFileSARewards;
+	} else if (allSAS) {
+		return RawFileRewardsType::RawFileSASRewards;
+	} else {
+		return RawFileRewardsType::RawFileSASORewards;
+	}
+}
+
+void RawFile::save_pomdp_blocks(std::ofstream &file, ObservationTransitions *O, const std::vector<Rewards *> &factors,
+		unsigned int r, const std::vector<State *> &states, const std::vector<Action *> &actions,
+		const std::vector<Observation *> &observations)
+{
+	unsigned int n = states.size();
+	unsigned int m = actions.size();
+	unsigned int z = observations.size();
+
+	for (Action *a : actions) {
+		for (State *sp : states) {
+			for (unsigned int o = 0; o < z; o++) {
+				file << (float)O->get(a, sp, observations[o]) << ((o < z - 1) ? " " : "\n");
+			}
+		}
+	}
+
+	for (Rewards *Ri : factors) {
+		if (r == RawFileRewardsType::RawFileSARewards) {
+			SARewards *RiSA = dynamic_cast<SARewards *>(Ri);
+
+			for (State *s : states) {
+				for (unsigned int a = 0; a < m; a++) {
+					file << (float)RiSA->get(s, actions[a]) << ((a < m - 1) ? " " : "\n");
+				}
+			}
+		} else if (r == RawFileRewardsType::RawFileSASRewards) {
+			SASRewards *RiSAS = dynamic_cast<SASRewards *>(Ri);
+
+			for (State *s : states) {
+				for (Action *a : actions) {
+					for (unsigned int sp = 0; sp < n; sp++) {
+						file << (float)RiSAS->get(s, a, states[sp]) << ((sp < n - 1) ? " " : "\n");
+					}
+				}
+			}
+		} else {
+			SASORewards *RiSASO = dynamic_cast<SASORewards *>(Ri);
+
+			for (State *s : states) {
+				for (Action *a : actions) {
+					for (State *sp : states) {
+						for (unsigned int o = 0; o < z; o++) {
+							file << (float)RiSASO->get(s, a, sp, observations[o]) << ((o < z - 1) ? " " : "\n");
+						}
+					}
+				}
+			}
+		}
+	}
+}
+
+void RawFile::check_header(std::string filename, unsigned int n, unsigned int m, unsigned int k, unsigned int r,
+		unsigned int s0, double g)
+{
+	if (n == 0) {
+		log_message("RawFile::load_raw_mdp",
+				"Invalid number of states in the header for file '" + filename + "'.");
+		throw CoreException();
+	}
+
+	if (m == 0) {
+		log_message("RawFile::load_raw_mdp",
+				"Invalid number of actions in the header for file '" + filename + "'.");
+		throw CoreException();
+	}
+
+	if (k == 0) {
+		log_message("RawFile::load_raw_mdp",
+				"Invalid number of reward factors in the header for file '" + filename + "'.");
+		throw CoreException();
+	}
+
+	if (r >= RawFileRewardsType::NumRawFileRewardsTypes) {
+		log_message("RawFile::load_raw_mdp",
+				"Invalid rewards type in the header for file '" + filename + "'.");
+		throw CoreException();
+	}
+
+	if (s0 >= n) {
+		log_message("RawFile::load_raw_mdp",
+				"Invalid initial state in the header for file '" + filename + "'.");
+		throw CoreException();
+	}
+
+	// Note: All values of an unsigned int are valid horizon values.
+
+	if (g < 0.0 || g > 1.0) {
+		log_message("RawFile::load_raw_mdp",
+				"Invalid discount factor (gamma) in the header for file '" + filename + "'.");
+		throw CoreException();
+	}
+}
+
+StatesMap *RawFile::create_states(unsigned int n)
+{
+	StatesMap *states = new StatesMap();
+	for (unsigned int i = 0; i < n; i++) {
+		states->add(new IndexedState(i));
+	}
+
+	return states;
+}
+
+ActionsMap *RawFile::create_actions(unsigned int m)
+{
+	ActionsMap *actions = new ActionsMap();
+	for (unsigned int i = 0; i < m; i++) {
+		actions->add(new IndexedAction(i));
+	}
+
+	return actions;
+}
+
+ObservationsMap *RawFile::create_observations(unsigned int z)
+{
+	ObservationsMap *observations = new ObservationsMap();
+	for (unsigned int i = 0; i < z; i++) {
+		observations->add(new IndexedObservation(i));
+	}
+
+	return observations;
 }
@@ -0,0 +1,182 @@
+/**
+ *  The MIT License (MIT)
+ *
+ *  Copyright (c) 2014 Kyle Hollins Wray, University of Massachusetts
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy of
+ *  this software and associated documentation files (the "Software"), to deal in
+ *  the Software without restriction, including without limitation the rights to
+ *  use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ *  the Software, and to permit persons to whom the Software is furnished to do so,
+ *  subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included in all
+ *  copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ *  FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ *  COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ *  IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ *  CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+
+#include "../../include/management/raw_file_stream.h"
+
+#include "../../include/utilities/log.h"
+
+#include "../../include/core/core_exception.h"
+
+#include <cstring>
+
+RawFileStream::RawFileStream(std::string filename) : filename(filename), reading(0), offset(0), numStarted(0),
+		nextState(0), valid(true)
+{
+	file.open(filename, std::ios::in | std::ios::binary);
+	if (!file.is_open()) {
+		log_message("RawFileStream::RawFileStream", "Failed to open the file '" + filename + "'.");
+		throw CoreException();
+	}
+
+	std::memset(&header, 0, sizeof(RawFileBinaryHeader));
+	file.read((char *)&header, sizeof(RawFileBinaryHeader));
+
+	if (!file.good() || std::memcmp(header.magic, "LIBRBR\0\0", 8) != 0) {
+		log_message("RawFileStream::RawFileStream", "The file '" + filename + "' is not a binary model.");
+		throw CoreException();
+	}
+
+	if (header.version != RAW_FILE_BINARY_VERSION) {
+		log_message("RawFileStream::RawFileStream",
+				"Unsupported version " + std::to_string(header.version) + " of the file '" + filename + "'.");
+		throw CoreException();
+	}
+
+	if (header.byteOrder != 0x01020304) {
+		log_message("RawFileStream::RawFileStream",
+				"The file '" + filename + "' was saved on a machine with a different byte order.");
+		throw CoreException();
+	}
+
+	if (header.modelType != RawFileBinaryModelType::RawFileBinaryStreamedMDP) {
+		log_message("RawFileStream::RawFileStream", "The file '" + filename + "' does not contain a streamed MDP.");
+		throw CoreException();
+	}
+
+	if (header.numStates == 0 || header.numActions == 0 || header.numBlocks == 0 ||
+			header.discountFactor < 0.0 || header.discountFactor > 1.0) {
+		log_message("RawFileStream::RawFileStream", "Invalid header for file '" + filename + "'.");
+		throw CoreException();
+	}
+
+	rewind();
+}
+
+RawFileStream::~RawFileStream()
+{
+	wait();
+}
+
+const RawFileBinaryHeader &RawFileStream::get_header() const
+{
+	return header;
+}
+
+void RawFileStream::rewind()
+{
+	wait();
+
+	offset = sizeof(RawFileBinaryHeader);
+	numStarted = 0;
+	nextState = 0;
+	valid = true;
+
+	start();
+}
+
+const RawFileStreamBlock *RawFileStream::next()
+{
+	if (!reader.joinable()) {
+		return nullptr;
+	}
+
+	wait();
+
+	if (!valid) {
+		log_message("RawFileStream::next", "Failed to read block " + std::to_string(numStarted - 1) +
+				" of the file '" + filename + "'.");
+		throw CoreException();
+	}
+
+	// Start reading the following block into the other buffer, which the caller has finished with.
+	unsigned int ready = reading;
+	if (numStarted < header.numBlocks) {
+		reading = 1 - reading;
+		start();
+	}
+
+	return (const RawFileStreamBlock *)buffers[ready].data();
+}
+
+const uint64_t *RawFileStream::get_rows(const RawFileStreamBlock *block) const
+{
+	return (const uint64_t *)(block + 1);
+}
+
+const RawFileStreamEntry *RawFileStream::get_entries(const RawFileStreamBlock *block) const
+{
+	return (const RawFileStreamEntry *)(get_rows(block) + (uint64_t)block->numStates * header.numActions + 1);
+}
+
+void RawFileStream::start()
+{
+	numStarted++;
+	reader = std::thread(&RawFileStream::read, this, reading);
+}
+
+void RawFileStream::wait()
+{
+	if (reader.joinable()) {
+		reader.join();
+	}
+}
+
+void RawFileStream::read(unsigned int buffer)
+{
+	RawFileStreamBlock block;
+
+	file.clear();
+	file.seekg(offset);
+	file.read((char *)&block, sizeof(RawFileStreamBlock));
+
+	// The block must be aligned, hold the next states in order, and be large enough for its rows and entries.
+	uint64_t numRows = (uint64_t)block.numStates * header.numActions + 1;
+	valid = (file.good() && block.size % RAW_FILE_BINARY_ALIGNMENT == 0 && block.numStates > 0 &&
+			block.firstState == nextState && (uint64_t)block.firstState + block.numStates <= header.numStates &&
+			block.size >= sizeof(RawFileStreamBlock) + numRows * sizeof(uint64_t) +
+					block.numEntries * sizeof(RawFileStreamEntry));
+	if (!valid) {
+		return;
+	}
+
+	buffers[buffer].resize(block.size / sizeof(uint64_t));
+	std::memcpy(buffers[buffer].data(), &block, sizeof(RawFileStreamBlock));
+	file.read((char *)buffers[buffer].data() + sizeof(RawFileStreamBlock), block.size - sizeof(RawFileStreamBlock));
+
+	// The rows and entries are checked here, on the reading thread, so the solver may trust them.
+	const RawFileStreamBlock *data = (const RawFileStreamBlock *)buffers[buffer].data();
+	const uint64_t *rows = get_rows(data);
+	const RawFileStreamEntry *entries = get_entries(data);
+
+	valid = (file.good() && rows[0] == 0 && rows[numRows - 1] == block.numEntries);
+	for (uint64_t i = 1; valid && i < numRows; i++) {
+		valid = (rows[i - 1] <= rows[i]);
+	}
+	for (uint64_t i = 0; valid && i < block.numEntries; i++) {
+		valid = (entries[i].state < header.numStates);
+	}
+
+	offset += block.size;
+	nextState += block.numStates;
+}
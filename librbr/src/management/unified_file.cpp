@@ -36,16 +36,39 @@
 #include "../../include/core/rewards/reward_exception.h"
 
 #include "../../include/core/states/named_state.h"
+#include "../../include/core/states/factored_state.h"
 #include "../../include/core/states/state_utilities.h"
 
 #include "../../include/core/actions/named_action.h"
+#include "../../include/core/actions/joint_action.h"
 #include "../../include/core/actions/action_utilities.h"
 
 #include "../../include/core/observations/named_observation.h"
+#include "../../include/core/observations/joint_observation.h"
 #include "../../include/core/observations/observation_utilities.h"
 
+#include "../../include/management/mapped_file.h"
+
 #include <iostream>
 #include <fstream>
+#include <algorithm>
+#include <thread>
+
+/**
+ * The number of items of a keyword line which are stored; statements have at most five.
+ */
+#define UNIFIED_FILE_MAX_ITEMS 6
+
+/**
+ * The smallest run of T, O, and R statements, in bytes, given to each thread; smaller files are parsed
+ * by fewer threads, since starting a thread costs more than it saves.
+ */
+#define UNIFIED_FILE_MIN_CHUNK_SIZE 262144
+
+/**
+ * The number of values the first chunk parses before it sets them in the model.
+ */
+#define UNIFIED_FILE_FLUSH_SIZE 4096
 
 UnifiedFile::UnifiedFile()
 {
@@ -66,35 +89,42 @@ UnifiedFile::UnifiedFile()
 	loadingAction = nullptr;
 	loadingState = nullptr;
 	loadingObservation = nullptr;
+	loadingFactor = 0;
+
+	numThreads = std::max(1u, std::thread::hardware_concurrency());
 }
 
 UnifiedFile::UnifiedFile(std::string path)
 {
+	numThreads = std::max(1u, std::thread::hardware_concurrency());
+
 	load(path);
 }
 
 UnifiedFile::~UnifiedFile()
 { }
 
+void UnifiedFile::set_num_threads(unsigned int numThreads)
+{
+	if (numThreads == 0) {
+		throw CoreException();
+	}
+	this->numThreads = numThreads;
+}
+
+unsigned int UnifiedFile::get_num_threads() const
+{
+	return numThreads;
+}
+
 bool UnifiedFile::load(std::string path)
 {
 	reset();
 
 	filename = path;
 
-	// Open the file.
+	// Open the file, only to check that it exists and is not empty, since an empty file cannot be mapped.
 	std::ifstream file(filename);
-	std::string line;
-
-	// Two variables to help with loading proceeding lines into a particular variable,
-	// e.g., actions and observations in their joint form, and T, R, or O in their
-	// matrix representation.
-	// 0 = null, 1 = factored states, 2 = joint actions, 3 = joint observations
-	// 4 = T vector, 5 = T matrix
-	// 6 = O vector, 7 = O matrix
-	// 8 = R vector, 9 = R matrix
-	unsigned int loading = 0;
-	unsigned int loadingCounter = 0;
 
 	// If the file failed to open, then do not do anything.
 	if (!file.is_open()) {
@@ -103,191 +133,526 @@ bool UnifiedFile::load(std::string path)
 		return true;
 	}
 
-	while (std::getline(file, line)) {
+	file.seekg(0, std::ios::end);
+	if (file.tellg() <= 0) {
+		return false;
+	}
+	file.close();
+
+	// Map the file into memory, so that the tokenizer can walk over it without copying each line.
+	MappedFile *mappedFile = nullptr;
+	try {
+		mappedFile = new MappedFile(filename);
+	} catch (const CoreException &err) {
+		sprintf(error, "Failed to map file '%s'.", filename.c_str());
+		log_message("UnifiedFile::load", error);
+		return true;
+	}
+
+	bool result = load_lines(mappedFile->get_data(), mappedFile->get_size());
+
+	delete mappedFile;
+
+	return result;
+}
+
+bool UnifiedFile::load_lines(const char *data, std::size_t size)
+{
+	std::size_t position = 0;
+
+	// Statements other than T, O, and R may come in any order, and change how the following lines are read, so
+	// they are loaded one at a time. Each run of T, O, and R statements between them is loaded in parallel.
+	while (position < size) {
+		if (load_header(data, size, position)) {
+			return true;
+		}
+
+		if (position < size && load_body(data, size, position)) {
+			return true;
+		}
+	}
+
+	return false;
+}
+
+bool UnifiedFile::load_header(const char *data, std::size_t size, std::size_t &position)
+{
+	Tokenizer tokenizer(data + position, size - position);
+	Token line;
+
+	// The items of a keyword line. Statements have at most five items, so any more are only counted.
+	Token items[UNIFIED_FILE_MAX_ITEMS];
+
+	// Two variables to help with loading proceeding lines into a particular variable,
+	// e.g., factored states and actions and observations in their joint form.
+	// 0 = null, 1 = factored states, 2 = joint actions, 3 = joint observations,
+	// 4 = factored state transitions
+	unsigned int loading = 0;
+	unsigned int loadingCounter = 0;
+
+	while (tokenizer.next_line(line)) {
 		// Handle comments by removing all characters down to and including a '#'.
-		line = line.substr(0, line.find('#'));
+		Tokenizer::strip_comment(line);
 
 		// Skip over blank lines.
-		if (line.length() == 0) {
+		if (line.length == 0) {
 			rows++;
 			continue;
 		}
 
 		// Two cases, either this is a keyword line, or it is an information line.
-		if (line.find(':') != std::string::npos) {
+		if (Tokenizer::contains(line, ':')) {
 			// Reset these variables since we have started a new ":" statement.
 			loading = 0;
 			loadingCounter = 0;
 
-			loadingAction = nullptr;
-			loadingState = nullptr;
-			loadingObservation = nullptr;
-
 			// If this contains a colon, then it is a keyword line. For keyword lines,
 			// split the line based on the colon(s) and handle the keyword.
-			std::vector<std::string> items = split_string_by_colon(line);
+			unsigned int numItems = Tokenizer::split_by_colon(line, items, UNIFIED_FILE_MAX_ITEMS);
+			if (numItems == 0) {
+				rows++;
+				continue;
+			}
+
+			// The T, O, and R statements, which make up almost all of a large file, are left to load_body.
+			if (token_equals(items[0], "T") || token_equals(items[0], "O") || token_equals(items[0], "R")) {
+				position = line.data - data;
+				return false;
+			}
+
+			std::vector<std::string> stringItems = split_string_by_colon(token_to_string(line));
 
 			// Handle the specific case.
-			if (items[0].compare("horizon") == 0) {
-				if (load_horizon(items)) {
+			if (stringItems[0].compare("horizon") == 0) {
+				if (load_horizon(stringItems)) {
 					return true;
 				}
-			} else if (items[0].compare("discount") == 0) {
-				if (load_discount_factor(items)) {
+			} else if (stringItems[0].compare("discount") == 0) {
+				if (load_discount_factor(stringItems)) {
 					return true;
 				}
-			} else if (items[0].compare("start") == 0) {
-				if (load_initial_state(items)) {
+			} else if (stringItems[0].compare("start") == 0) {
+				if (load_initial_state(stringItems)) {
 					return true;
 				}
-			} else if (items[0].compare("start include") == 0) {
-				if (load_initial_state_inclusive(items)) {
+			} else if (stringItems[0].compare("start include") == 0) {
+				if (load_initial_state_inclusive(stringItems)) {
 					return true;
 				}
-			} else if (items[0].compare("start exclude") == 0) {
-				if (load_initial_state_exclusive(items)) {
+			} else if (stringItems[0].compare("start exclude") == 0) {
+				if (load_initial_state_exclusive(stringItems)) {
 					return true;
 				}
-			} else if (items[0].compare("values") == 0) {
-				if (load_value(items)) {
+			} else if (stringItems[0].compare("available") == 0) {
+				if (load_available(stringItems)) {
 					return true;
 				}
-			} else if (items[0].compare("agents") == 0) {
-				if (load_agents(items)) {
+			} else if (stringItems[0].compare("values") == 0) {
+				if (load_value(stringItems)) {
 					return true;
 				}
-			} else if (items[0].compare("states") == 0) {
-				int result = load_states(items);
+			} else if (stringItems[0].compare("agents") == 0) {
+				if (load_agents(stringItems)) {
+					return true;
+				}
+			} else if (stringItems[0].compare("states") == 0) {
+				int result = load_states(stringItems);
 				if (result == -1) {
 					return true;
 				} else if (result == 1) {
 					loading = 1;
 					loadingCounter = 0;
 				}
-			} else if (items[0].compare("actions") == 0) {
-				int result = load_actions(items);
+			} else if (stringItems[0].compare("actions") == 0) {
+				int result = load_actions(stringItems);
 				if (result == -1) {
 					return true;
 				} else if (result == 1) {
 					loading = 2;
 					loadingCounter = 0;
 				}
-			} else if (items[0].compare("observations") == 0) {
-				int result = load_observations(items);
+			} else if (stringItems[0].compare("observations") == 0) {
+				int result = load_observations(stringItems);
 				if (result == -1) {
 					return true;
 				} else if (result == 1) {
 					loading = 3;
 					loadingCounter = 0;
 				}
-			} else if (items[0].compare("T") == 0) {
-				int result = load_state_transition(items);
-				if (result == -1) {
-					return true;
-				} else if (result == 1) {
-					loading = 4;
-					loadingCounter = 0;
-				} else if (result == 2) {
-					loading = 5;
-					loadingCounter = 0;
-				}
-			} else if (items[0].compare("O") == 0) {
-				int result = load_observation_transition(items);
-				if (result == -1) {
+			} else if (stringItems[0].compare("T parents") == 0) {
+				if (load_factored_state_transition_parents(stringItems)) {
 					return true;
-				} else if (result == 1) {
-					loading = 6;
-					loadingCounter = 0;
-				} else if (result == 2) {
-					loading = 7;
-					loadingCounter = 0;
 				}
-			} else if (items[0].compare("R") == 0) {
-				int result = load_reward(items);
+			} else if (stringItems[0].compare("T factor") == 0) {
+				int result = load_factored_state_transition(stringItems);
 				if (result == -1) {
 					return true;
 				} else if (result == 1) {
-					loading = 8;
-					loadingCounter = 0;
-				} else if (result == 2) {
-					loading = 9;
+					loading = 4;
 					loadingCounter = 0;
 				}
 			}
 		} else {
 			// If this does not contain a colon (and is not blank), then it
 			// is an information line. For information lines, split the line based on
-			// spaces and read each double, creating the appropriate map.
+			// spaces and read each name, creating the appropriate factor or joint set.
 			switch (loading) {
 			case 1:
 				// Loading factored states.
-				if (load_factored_states(loadingCounter, line)) {
+				if (load_factored_states(loadingCounter, token_to_string(line))) {
 					return true;
 				}
 				break;
 			case 2:
 				// Loading an agent's actions.
-				if (load_agent_actions(loadingCounter, line)) {
+				if (load_agent_actions(loadingCounter, token_to_string(line))) {
 					return true;
 				}
 				break;
 			case 3:
 				// Loading an agent's observations.
-				if (load_agent_observations(loadingCounter, line)) {
+				if (load_agent_observations(loadingCounter, token_to_string(line))) {
 					return true;
 				}
 				break;
 			case 4:
-				// Loading a vector for T.
-				if (load_state_transition_vector(line)) {
+				// Loading a vector of a factor's state transitions.
+				if (loadingCounter > 0) {
+					sprintf(error, "Too many vectors for a factor on line %i in file '%s'.", rows, filename.c_str());
+					log_message("UnifiedFile::load", error);
+					return true;
+				}
+				if (load_factored_state_transition_vector(token_to_string(line))) {
 					return true;
 				}
 				break;
+			default:
+				sprintf(error, "Failed loading a factor, vector, or matrix on line %i in file '%s'.",
+						rows, filename.c_str());
+				log_message("UnifiedFile::load", error);
+				return true;
+				break;
+			}
+
+			loadingCounter++;
+		}
+
+		rows++;
+	}
+
+	position = size;
+
+	return false;
+}
+
+bool UnifiedFile::load_body(const char *data, std::size_t size, std::size_t &position)
+{
+	// Split the rest of the file into one chunk per thread, unless it is too small to be worth it.
+	std::size_t remaining = size - position;
+	unsigned int numChunks = (unsigned int)std::max((std::size_t)1,
+			std::min((std::size_t)numThreads, remaining / UNIFIED_FILE_MIN_CHUNK_SIZE));
+
+	std::vector<UnifiedFileChunk *> chunks;
+	std::size_t start = position;
+
+	for (unsigned int i = 0; i < numChunks; i++) {
+		std::size_t end = size;
+
+		// Move the end of each chunk (but the last) forward to the next statement, so that no vector or
+		// matrix is split between two chunks.
+		if (i + 1 < numChunks) {
+			end = std::max(start, position + remaining * (i + 1) / numChunks);
+
+			Tokenizer tokenizer(data + end, size - end);
+			Token line;
+
+			if (end > start && data[end - 1] != '\n') {
+				tokenizer.next_line(line);
+			}
+
+			std::size_t next = size;
+			while (tokenizer.next_line(line)) {
+				Tokenizer::strip_comment(line);
+				if (Tokenizer::contains(line, ':')) {
+					next = line.data - data;
+					break;
+				}
+			}
+			end = next;
+		}
+
+		UnifiedFileChunk *chunk = new UnifiedFileChunk();
+		chunk->start = start;
+		chunk->end = end;
+		chunk->rows = (i == 0) ? rows : 0;
+		chunk->flush = (i == 0);
+		chunks.push_back(chunk);
+
+		start = end;
+	}
+
+	// Parse the first chunk on this thread, and the others on their own threads. Only the first chunk
+	// knows its first line number, since the lines before the others have not been counted yet.
+	std::vector<std::thread> threads;
+	for (unsigned int i = 1; i < numChunks; i++) {
+		threads.push_back(std::thread(&UnifiedFile::parse_chunk, this, data, chunks[i]));
+	}
+
+	parse_chunk(data, chunks[0]);
+
+	for (std::thread &thread : threads) {
+		thread.join();
+	}
+
+	// Keep the chunks up to the first one which stopped at another statement; those after it are
+	// parsed again once that statement has been loaded. An error in any kept chunk but the first is
+	// found by parsing it again, now that its first line number is known, so that the message matches
+	// a sequential load.
+	unsigned int numMerged = 0;
+	bool failed = false;
+
+	for (unsigned int i = 0; i < numChunks; i++) {
+		UnifiedFileChunk *chunk = chunks[i];
+		numMerged++;
+
+		if (chunk->errorSource != nullptr) {
+			if (i > 0) {
+				chunk->rows = rows;
+				parse_chunk(data, chunk);
+			}
+
+			log_message(chunk->errorSource, chunk->error);
+			failed = true;
+			break;
+		}
+
+		rows = (i == 0) ? chunk->rows : rows + chunk->rows;
+		position = chunk->stop;
+
+		if (chunk->stop < chunk->end) {
+			break;
+		}
+	}
+
+	// Set the remaining values in the model in the order they appear, with each function on its own thread.
+	if (!failed) {
+		if (numThreads > 1 && numMerged > 1) {
+			std::thread observationTransitionsThread([this, &chunks, numMerged]() {
+				for (unsigned int i = 0; i < numMerged; i++) {
+					merge_observation_transitions(chunks[i]);
+				}
+			});
+			std::thread rewardsThread([this, &chunks, numMerged]() {
+				for (unsigned int i = 0; i < numMerged; i++) {
+					merge_rewards(chunks[i]);
+				}
+			});
+
+			for (unsigned int i = 0; i < numMerged; i++) {
+				merge_state_transitions(chunks[i]);
+			}
+
+			observationTransitionsThread.join();
+			rewardsThread.join();
+		} else {
+			for (unsigned int i = 0; i < numMerged; i++) {
+				merge_state_transitions(chunks[i]);
+				merge_observation_transitions(chunks[i]);
+				merge_rewards(chunks[i]);
+			}
+		}
+	}
+
+	for (UnifiedFileChunk *chunk : chunks) {
+		delete chunk;
+	}
+
+	return failed;
+}
+
+void UnifiedFile::parse_chunk(const char *data, UnifiedFileChunk *chunk)
+{
+	Tokenizer tokenizer(data + chunk->start, chunk->end - chunk->start);
+	Token line;
+
+	// The items of a keyword line. Statements have at most five items, so any more are only counted.
+	Token items[UNIFIED_FILE_MAX_ITEMS];
+
+	chunk->stop = chunk->end;
+
+	chunk->loading = 0;
+	chunk->loadingCounter = 0;
+	chunk->loadingAction = nullptr;
+	chunk->loadingState = nullptr;
+
+	chunk->hasStateTransitions = false;
+	chunk->hasObservationTransitions = false;
+	chunk->hasRewards = false;
+
+	chunk->stateTransitions.clear();
+	chunk->observationTransitions.clear();
+	chunk->rewards.clear();
+
+	chunk->errorSource = nullptr;
+
+	while (tokenizer.next_line(line)) {
+		// Handle comments by removing all characters down to and including a '#'.
+		Tokenizer::strip_comment(line);
+
+		// Skip over blank lines.
+		if (line.length == 0) {
+			chunk->rows++;
+			continue;
+		}
+
+		// Two cases, either this is a keyword line, or it is an information line.
+		if (Tokenizer::contains(line, ':')) {
+			// Reset these variables since we have started a new ":" statement.
+			chunk->loading = 0;
+			chunk->loadingCounter = 0;
+
+			chunk->loadingAction = nullptr;
+			chunk->loadingState = nullptr;
+
+			unsigned int numItems = Tokenizer::split_by_colon(line, items, UNIFIED_FILE_MAX_ITEMS);
+			if (numItems == 0) {
+				chunk->rows++;
+				continue;
+			}
+
+			if (token_equals(items[0], "T")) {
+				int result = load_state_transition(chunk, items, numItems);
+				if (result == -1) {
+					return;
+				} else if (result == 1) {
+					chunk->loading = 4;
+				} else if (result == 2) {
+					chunk->loading = 5;
+				}
+			} else if (token_equals(items[0], "O")) {
+				int result = load_observation_transition(chunk, items, numItems);
+				if (result == -1) {
+					return;
+				} else if (result == 1) {
+					chunk->loading = 6;
+				} else if (result == 2) {
+					chunk->loading = 7;
+				}
+			} else if (token_equals(items[0], "R")) {
+				int result = load_reward(chunk, items, numItems);
+				if (result == -1) {
+					return;
+				} else if (result == 1) {
+					chunk->loading = 8;
+				} else if (result == 2) {
+					chunk->loading = 9;
+				}
+			} else {
+				// Any other statement must be loaded by load_header, so the chunk stops here.
+				chunk->stop = line.data - data;
+				return;
+			}
+
+			// Vectors and matrices of values are given in the order of the states, so only list
+			// the states once one of these is about to be read.
+			if (chunk->loading != 0) {
+				order_states();
+			}
+		} else {
+			// If this does not contain a colon (and is not blank), then it is an information
+			// line: a vector or a row of a matrix of values.
+			bool failed = false;
+
+			switch (chunk->loading) {
+			case 4:
+				// Loading a vector for T.
+				failed = load_state_transition_vector(chunk, line);
+				break;
 			case 5:
 				// Loading a matrix for T.
-				if (load_state_transition_matrix(loadingCounter, line)) {
-					return true;
-				}
+				failed = load_state_transition_matrix(chunk, chunk->loadingCounter, line);
 				break;
 			case 6:
 				// Loading a vector for O.
-				if (load_observation_transition_vector(line)) {
-					return true;
-				}
+				failed = load_observation_transition_vector(chunk, line);
 				break;
 			case 7:
 				// Loading a matrix for O.
-				if (load_observation_transition_matrix(loadingCounter, line)) {
-					return true;
-				}
+				failed = load_observation_transition_matrix(chunk, chunk->loadingCounter, line);
 				break;
 			case 8:
 				// Loading a vector for R.
-				if (load_reward_vector(line)) {
-					return true;
-				}
+				failed = load_reward_vector(chunk, line);
 				break;
 			case 9:
 				// Loading a matrix for R.
-				if (load_reward_matrix(loadingCounter, line)) {
-					return true;
-				}
+				failed = load_reward_matrix(chunk, chunk->loadingCounter, line);
 				break;
 			default:
-				sprintf(error, "Failed loading a factor, vector, or matrix on line %i in file '%s'.",
-						rows, filename.c_str());
-				log_message("UnifiedFile::load", error);
-				return true;
+				sprintf(chunk->error, "Failed loading a factor, vector, or matrix on line %i in file '%s'.",
+						chunk->rows, filename.c_str());
+				chunk->errorSource = "UnifiedFile::load";
+				failed = true;
 				break;
 			}
 
-			loadingCounter++;
+			if (failed) {
+				return;
+			}
+
+			chunk->loadingCounter++;
 		}
 
-		rows++;
+		chunk->rows++;
+
+		// Setting the values in small batches keeps them in the cache, and the chunk's memory small.
+		if (chunk->flush && (chunk->stateTransitions.size() >= UNIFIED_FILE_FLUSH_SIZE ||
+				chunk->observationTransitions.size() >= UNIFIED_FILE_FLUSH_SIZE ||
+				chunk->rewards.size() >= UNIFIED_FILE_FLUSH_SIZE)) {
+			merge_state_transitions(chunk);
+			merge_observation_transitions(chunk);
+			merge_rewards(chunk);
+		}
 	}
+}
 
-	return false;
+void UnifiedFile::merge_state_transitions(UnifiedFileChunk *chunk)
+{
+	// Create the state transitions object if it has not been made yet.
+	if (chunk->hasStateTransitions && stateTransitions == nullptr) {
+		stateTransitions = new StateTransitionsMap();
+	}
+
+	for (const UnifiedFileTransition &entry : chunk->stateTransitions) {
+		stateTransitions->set(entry.state, entry.action, entry.nextState, entry.value);
+	}
+	chunk->stateTransitions.clear();
+}
+
+void UnifiedFile::merge_observation_transitions(UnifiedFileChunk *chunk)
+{
+	// Create the observation transitions object if it has not been made yet.
+	if (chunk->hasObservationTransitions && observationTransitions == nullptr) {
+		observationTransitions = new ObservationTransitionsMap();
+	}
+
+	for (const UnifiedFileObservation &entry : chunk->observationTransitions) {
+		observationTransitions->set(entry.action, entry.nextState, entry.observation, entry.value);
+	}
+	chunk->observationTransitions.clear();
+}
+
+void UnifiedFile::merge_rewards(UnifiedFileChunk *chunk)
+{
+	// Create the rewards object if it has not been made yet.
+	if (chunk->hasRewards && rewards == nullptr) {
+		rewards = new SASRewardsMap();
+	}
+
+	for (const UnifiedFileTransition &entry : chunk->rewards) {
+		rewards->set(entry.state, entry.action, entry.nextState, entry.value);
+	}
+	chunk->rewards.clear();
 }
 
 bool UnifiedFile::save(std::string path)
@@ -344,6 +709,8 @@ void UnifiedFile::reset()
 	loadingState = nullptr;
 	loadingAction = nullptr;
 	loadingObservation = nullptr;
+	loadingFactor = 0;
+	loadingParents.clear();
 
 	orderedStates.clear();
 	orderedObservations.clear();
@@ -481,6 +848,8 @@ bool UnifiedFile::load_initial_state(std::vector<std::string> items)
 		initialState->set_initial_belief(state, 1.0);
 	} else {
 		// This must be a full list of probabilities.
+		order_states();
+
 		unsigned int stateIndex = 0;
 		for (std::string probability : list) {
 			// Stop if too many probabilities are defined and return an error.
@@ -560,46 +929,97 @@ bool UnifiedFile::load_initial_state_inclusive(std::vector<std::string> items)
 	return false;
 }
 
-bool UnifiedFile::load_initial_state_exclusive(std::vector<std::string> items)
+bool UnifiedFile::load_available(std::vector<std::string> items)
 {
-	// Ensure states are defined, otherwise you cannot specify an initial distribution over states.
-	if (states == nullptr) {
-		sprintf(error, "Failed to define 'start exclude', since states are undefined, on line %i in file '%s'.",
+	// Ensure states and actions are defined, otherwise you cannot restrict the actions of a state.
+	if (states == nullptr || actions == nullptr) {
+		sprintf(error, "Failed to define 'available', since states or actions are undefined, on line %i in file '%s'.",
 				rows, filename.c_str());
-		log_message("UnifiedFile::load_initial_state_exclusive", error);
+		log_message("UnifiedFile::load_available", error);
 		return true;
 	}
 
-	// Raise an error if the item is not defined.
-	if (items.size() < 2) {
-		sprintf(error, "Missing state definition on line %i in file '%s'.", rows, filename.c_str());
-		log_message("UnifiedFile::load_initial_state_exclusive", error);
+	if (items.size() != 3) {
+		sprintf(error, "Expected a state and a list of actions on line %i in file '%s'.", rows, filename.c_str());
+		log_message("UnifiedFile::load_available", error);
 		return true;
 	}
 
-	// If the initial state is not yet defined, then create it.
-	if (initialState == nullptr) {
-		initialState = new Initial();
-	}
-
-	std::vector<std::string> list = split_string_by_space(items[1]);
+	State *state = nullptr;
 
-	if (list.size() == 0) {
-		sprintf(error, "No states provided on line %i in file '%s'.", rows, filename.c_str());
-		log_message("UnifiedFile::load_initial_state_exclusive", error);
+	try {
+		state = find_state(states, items[1]);
+	} catch (const StateException &err) {
+		sprintf(error, "State '%s' has not been defined on line %i in file '%s'.",
+				items[1].c_str(), rows, filename.c_str());
+		log_message("UnifiedFile::load_available", error);
 		return true;
 	}
 
-	double probability = 1.0 / (double)(states->get_num_states() - list.size());
-
-	std::vector<State *> subset;
-
-	for (std::string idString : list) {
-		State *state = nullptr;
+	std::vector<Action *> available;
 
+	for (std::string actionName : split_string_by_space(items[2])) {
 		try {
-			state = find_state(states, idString);
-		} catch (const StateException &err) {
+			available.push_back(find_action(actions, actionName));
+		} catch (const ActionException &err) {
+			sprintf(error, "Action '%s' has not been defined on line %i in file '%s'.",
+					actionName.c_str(), rows, filename.c_str());
+			log_message("UnifiedFile::load_available", error);
+			return true;
+		}
+	}
+
+	if (available.size() == 0) {
+		sprintf(error, "No actions provided on line %i in file '%s'.", rows, filename.c_str());
+		log_message("UnifiedFile::load_available", error);
+		return true;
+	}
+
+	actions->set_available(state, available);
+
+	return false;
+}
+
+bool UnifiedFile::load_initial_state_exclusive(std::vector<std::string> items)
+{
+	// Ensure states are defined, otherwise you cannot specify an initial distribution over states.
+	if (states == nullptr) {
+		sprintf(error, "Failed to define 'start exclude', since states are undefined, on line %i in file '%s'.",
+				rows, filename.c_str());
+		log_message("UnifiedFile::load_initial_state_exclusive", error);
+		return true;
+	}
+
+	// Raise an error if the item is not defined.
+	if (items.size() < 2) {
+		sprintf(error, "Missing state definition on line %i in file '%s'.", rows, filename.c_str());
+		log_message("UnifiedFile::load_initial_state_exclusive", error);
+		return true;
+	}
+
+	// If the initial state is not yet defined, then create it.
+	if (initialState == nullptr) {
+		initialState = new Initial();
+	}
+
+	std::vector<std::string> list = split_string_by_space(items[1]);
+
+	if (list.size() == 0) {
+		sprintf(error, "No states provided on line %i in file '%s'.", rows, filename.c_str());
+		log_message("UnifiedFile::load_initial_state_exclusive", error);
+		return true;
+	}
+
+	double probability = 1.0 / (double)(states->get_num_states() - list.size());
+
+	std::vector<State *> subset;
+
+	for (std::string idString : list) {
+		State *state = nullptr;
+
+		try {
+			state = find_state(states, idString);
+		} catch (const StateException &err) {
 			sprintf(error, "State '%s' has not been defined on line %i in file '%s'.",
 					idString.c_str(), rows, filename.c_str());
 			log_message("UnifiedFile::load_initial_state_exclusive", error);
@@ -822,12 +1242,9 @@ int UnifiedFile::load_factored_states(unsigned int factorIndex, std::string line
 	}
 	S->update();
 
-	// After the update, the internal states have been reset, so we need to remake
-	// the ordered list of states.
+	// After the update, the internal states have been reset, so the ordered list of states must be remade.
+	// This is only done once it is needed, since there are exponentially many factored states.
 	orderedStates.clear();
-	for (auto s : *states) {
-		orderedStates.push_back(resolve(s));
-	}
 
 	return 0;
 }
@@ -1095,143 +1512,154 @@ int UnifiedFile::load_agent_observations(unsigned int agentIndex, std::string li
 	return 0;
 }
 
-int UnifiedFile::load_state_transition(std::vector<std::string> items)
+int UnifiedFile::load_state_transition(UnifiedFileChunk *chunk, const Token *items, unsigned int numItems)
 {
 	// Ensure a valid number of items.
-	if (items.size() < 2 || items.size() > 5) {
-		sprintf(error, "Incomplete statement on line %i in file '%s'.", rows, filename.c_str());
-		log_message("UnifiedFile::load_state_transition", error);
+	if (numItems < 2 || numItems > 5) {
+		sprintf(chunk->error, "Incomplete statement on line %i in file '%s'.", chunk->rows, filename.c_str());
+		chunk->errorSource = "UnifiedFile::load_state_transition";
 		return -1;
 	}
 
-	// Create the state transitions object if it has not been made yet.
-	if (stateTransitions == nullptr) {
-		stateTransitions = new StateTransitionsMap();
+	// The factored state transitions are only given by "T factor" statements.
+	if (dynamic_cast<FactoredStateTransitions *>(stateTransitions) != nullptr) {
+		sprintf(chunk->error, "State transitions must be given by factor, as they are factored, on line %i in file '%s'.",
+				chunk->rows, filename.c_str());
+		chunk->errorSource = "UnifiedFile::load_state_transition";
+		return -1;
 	}
 
-	std::string actionName = split_string_by_space(items[1])[0];
+	// The state transitions object is created when the chunks are merged, even if this has no values.
+	chunk->hasStateTransitions = true;
+
+	Token remaining = items[1];
+	Token actionName = items[1];
+	Tokenizer::next_item(remaining, actionName);
 	Action *action = nullptr;
 
-	if (actionName.compare("*") != 0) {
-		try {
-			action = find_action(actions, actionName);
-		} catch (const ActionException &err) {
-			sprintf(error, "Action '%s' has not been defined on line %i in file '%s'.",
-					actionName.c_str(), rows, filename.c_str());
-			log_message("UnifiedFile::load_state_transition", error);
+	if (!token_equals(actionName, "*")) {
+		action = lookup_action(actionName, chunk->lookupKey);
+		if (action == nullptr) {
+			sprintf(chunk->error, "Action '%s' has not been defined on line %i in file '%s'.",
+					token_to_string(actionName).c_str(), chunk->rows, filename.c_str());
+			chunk->errorSource = "UnifiedFile::load_state_transition";
 			return -1;
 		}
 	}
 
 	// If this is of the form "T: action :" then a matrix follows.
-	if (items.size() == 2) {
-		loadingAction = action;
+	if (numItems == 2) {
+		chunk->loadingAction = action;
 		return 2;
 	}
 
-	std::string startStateName = split_string_by_space(items[2])[0];
+	remaining = items[2];
+	Token startStateName = items[2];
+	Tokenizer::next_item(remaining, startStateName);
 	State *startState = nullptr;
 
-	if (startStateName.compare("*") != 0) {
-		try {
-			startState = find_state(states, startStateName);
-		} catch (const StateException &err) {
-			sprintf(error, "State '%s' has not been defined on line %i in file '%s'.",
-					startStateName.c_str(), rows, filename.c_str());
-			log_message("UnifiedFile::load_state_transition", error);
+	if (!token_equals(startStateName, "*")) {
+		startState = lookup_state(startStateName, chunk->lookupKey);
+		if (startState == nullptr) {
+			sprintf(chunk->error, "State '%s' has not been defined on line %i in file '%s'.",
+					token_to_string(startStateName).c_str(), chunk->rows, filename.c_str());
+			chunk->errorSource = "UnifiedFile::load_state_transition";
 			return -1;
 		}
 	}
 
 	// If this is of the form "T: action : start-state :" then a vector follows.
-	if (items.size() == 3) {
-		loadingAction = action;
-		loadingState = startState;
+	if (numItems == 3) {
+		chunk->loadingAction = action;
+		chunk->loadingState = startState;
 		return 1;
 	}
 
-	std::string endStateName = split_string_by_space(items[3])[0];
+	remaining = items[3];
+	Token endStateName = items[3];
+	Tokenizer::next_item(remaining, endStateName);
 	State *endState = nullptr;
 
-	if (endStateName.compare("*") != 0) {
-		try {
-			endState = find_state(states, endStateName);
-		} catch (const StateException &err) {
-			sprintf(error, "State '%s' has not been defined on line %i in file '%s'.",
-					endStateName.c_str(), rows, filename.c_str());
-			log_message("UnifiedFile::load_state_transition", error);
+	if (!token_equals(endStateName, "*")) {
+		endState = lookup_state(endStateName, chunk->lookupKey);
+		if (endState == nullptr) {
+			sprintf(chunk->error, "State '%s' has not been defined on line %i in file '%s'.",
+					token_to_string(endStateName).c_str(), chunk->rows, filename.c_str());
+			chunk->errorSource = "UnifiedFile::load_state_transition";
 			return -1;
 		}
 	}
 
-	std::string probabilityString = split_string_by_space(items[4])[0];
+	remaining = items[4];
+	Token probabilityString = items[4];
+	Tokenizer::next_item(remaining, probabilityString);
 	double probability = 0.0;
 
-	try {
-		probability = std::stod(probabilityString);
-	} catch (const std::invalid_argument &err) {
-		sprintf(error, "Failed to convert '%s' to a double on line %i in file '%s'.",
-				probabilityString.c_str(), rows, filename.c_str());
-		log_message("UnifiedFile::load_state_transition", error);
+	if (!Tokenizer::parse_double(probabilityString, probability)) {
+		sprintf(chunk->error, "Failed to convert '%s' to a double on line %i in file '%s'.",
+				token_to_string(probabilityString).c_str(), chunk->rows, filename.c_str());
+		chunk->errorSource = "UnifiedFile::load_state_transition";
 		return -1;
 	}
 
 	if (probability < 0.0 || probability > 1.0) {
-		sprintf(error, "Invalid probability '%s' on line %i in file '%s'.",
-				probabilityString.c_str(), rows, filename.c_str());
-		log_message("UnifiedFile::load_state_transition", error);
+		sprintf(chunk->error, "Invalid probability '%s' on line %i in file '%s'.",
+				token_to_string(probabilityString).c_str(), chunk->rows, filename.c_str());
+		chunk->errorSource = "UnifiedFile::load_state_transition";
 		return true;
 	}
 
-	stateTransitions->set(startState, action, endState, probability);
+	chunk->stateTransitions.push_back({startState, action, endState, probability});
 
 	return 0;
 }
 
-bool UnifiedFile::load_state_transition_vector(std::string line)
+bool UnifiedFile::load_state_transition_vector(UnifiedFileChunk *chunk, const Token &line)
 {
-	// Split the line into a list of (hopefully) probabilities equal to the number of states.
-	std::vector<std::string> list = split_string_by_space(line);
+	// The line is a list of (hopefully) probabilities equal to the number of states.
+	Token remaining = line;
+	Token probabilityString = line;
+	Tokenizer::next_item(remaining, probabilityString);
 
 	// Handle the special case of "uniform".
-	if (list[0].compare("uniform") == 0) {
+	if (token_equals(probabilityString, "uniform")) {
 		double probability = 1.0 / (double)states->get_num_states();
 		for (unsigned int i = 0; i < states->get_num_states(); i++) {
-			stateTransitions->set(loadingState, loadingAction, orderedStates[i], probability);
+			chunk->stateTransitions.push_back({chunk->loadingState, chunk->loadingAction, orderedStates[i], probability});
 		}
 		return false;
 	}
 
-	if (list.size() != states->get_num_states()) {
-		sprintf(error, "Invalid number of probabilities given: %i != %i on line %i in file '%s'.",
-				(int)list.size(), states->get_num_states(), rows, filename.c_str());
-		log_message("UnifiedFile::load_state_transition_vector", error);
+	unsigned int numProbabilities = Tokenizer::count_items(line);
+	if (numProbabilities != states->get_num_states()) {
+		sprintf(chunk->error, "Invalid number of probabilities given: %i != %i on line %i in file '%s'.",
+				(int)numProbabilities, states->get_num_states(), chunk->rows, filename.c_str());
+		chunk->errorSource = "UnifiedFile::load_state_transition_vector";
 		return true;
 	}
 
-	// Attempt to convert each string to a probability and set the corresponding transition probability.
+	// Attempt to convert each item to a probability and set the corresponding transition probability.
 	unsigned int counter = 0;
+	remaining = line;
 
-	for (std::string probabilityString : list) {
+	while (Tokenizer::next_item(remaining, probabilityString)) {
 		double probability = 0.0;
 
-		try {
-			probability = std::stod(probabilityString);
-		} catch (const std::invalid_argument &err) {
-			sprintf(error, "Failed to convert '%s' to a double on line %i in file '%s'.",
-					probabilityString.c_str(), rows, filename.c_str());
-			log_message("UnifiedFile::load_state_transition_vector", error);
+		if (!Tokenizer::parse_double(probabilityString, probability)) {
+			sprintf(chunk->error, "Failed to convert '%s' to a double on line %i in file '%s'.",
+					token_to_string(probabilityString).c_str(), chunk->rows, filename.c_str());
+			chunk->errorSource = "UnifiedFile::load_state_transition_vector";
 			return true;
 		}
 
 		if (probability < 0.0 || probability > 1.0) {
-			sprintf(error, "Invalid probability '%s' on line %i in file '%s'.",
-					probabilityString.c_str(), rows, filename.c_str());
-			log_message("UnifiedFile::load_state_transition_vector", error);
+			sprintf(chunk->error, "Invalid probability '%s' on line %i in file '%s'.",
+					token_to_string(probabilityString).c_str(), chunk->rows, filename.c_str());
+			chunk->errorSource = "UnifiedFile::load_state_transition_vector";
 			return true;
 		}
 
-		stateTransitions->set(loadingState, loadingAction, orderedStates[counter], probability);
+		chunk->stateTransitions.push_back({chunk->loadingState, chunk->loadingAction, orderedStates[counter], probability});
 
 		counter++;
 	}
@@ -1239,64 +1667,66 @@ bool UnifiedFile::load_state_transition_vector(std::string line)
 	return false;
 }
 
-bool UnifiedFile::load_state_transition_matrix(unsigned int stateIndex, std::string line)
+bool UnifiedFile::load_state_transition_matrix(UnifiedFileChunk *chunk, unsigned int stateIndex, const Token &line)
 {
-	// Split the line into a list of (hopefully) probabilities equal to the number of states.
-	std::vector<std::string> list = split_string_by_space(line);
+	// The line is a list of (hopefully) probabilities equal to the number of states.
+	Token remaining = line;
+	Token probabilityString = line;
+	Tokenizer::next_item(remaining, probabilityString);
 
 	if (stateIndex < 0 || stateIndex >= states->get_num_states()) {
-		sprintf(error, "State index '%i' out of bounds on line %i in file '%s'.",
-				stateIndex, rows, filename.c_str());
-		log_message("UnifiedFile::load_state_transition_matrix", error);
+		sprintf(chunk->error, "State index '%i' out of bounds on line %i in file '%s'.",
+				stateIndex, chunk->rows, filename.c_str());
+		chunk->errorSource = "UnifiedFile::load_state_transition_matrix";
 		return true;
 	}
 
 	// Handle the special cases of "uniform" and "identity".
-	if (list[0].compare("uniform") == 0) {
+	if (token_equals(probabilityString, "uniform")) {
 		double probability = 1.0 / (double)states->get_num_states();
 		for (unsigned int i = 0; i < states->get_num_states(); i++) {
 			for (unsigned int j = 0; j < states->get_num_states(); j++) {
-				stateTransitions->set(orderedStates[i], loadingAction, orderedStates[j], probability);
+				chunk->stateTransitions.push_back({orderedStates[i], chunk->loadingAction, orderedStates[j], probability});
 			}
 		}
 		return false;
-	} else if (list[0].compare("identity") == 0) {
+	} else if (token_equals(probabilityString, "identity")) {
 		for (unsigned int i = 0; i < states->get_num_states(); i++) {
-			stateTransitions->set(orderedStates[i], loadingAction, orderedStates[i], 1.0);
+			chunk->stateTransitions.push_back({orderedStates[i], chunk->loadingAction, orderedStates[i], 1.0});
 		}
 		return false;
 	}
 
-	if (list.size() != states->get_num_states()) {
-		sprintf(error, "Invalid number of probabilities given: '%i != %i' on line %i in file '%s'.",
-				(int)list.size(), states->get_num_states(), rows, filename.c_str());
-		log_message("UnifiedFile::load_state_transition_matrix", error);
+	unsigned int numProbabilities = Tokenizer::count_items(line);
+	if (numProbabilities != states->get_num_states()) {
+		sprintf(chunk->error, "Invalid number of probabilities given: '%i != %i' on line %i in file '%s'.",
+				(int)numProbabilities, states->get_num_states(), chunk->rows, filename.c_str());
+		chunk->errorSource = "UnifiedFile::load_state_transition_matrix";
 		return true;
 	}
 
-	// Attempt to convert each string to a probability and set the corresponding transition probability.
+	// Attempt to convert each item to a probability and set the corresponding transition probability.
 	unsigned int counter = 0;
+	remaining = line;
 
-	for (std::string probabilityString : list) {
+	while (Tokenizer::next_item(remaining, probabilityString)) {
 		double probability = 0.0;
 
-		try {
-			probability = std::stod(probabilityString);
-		} catch (const std::invalid_argument &err) {
-			sprintf(error, "Failed to convert '%s' to a double on line %i in file '%s'.",
-					probabilityString.c_str(), rows, filename.c_str());
-			log_message("UnifiedFile::load_state_transition_matrix", error);
+		if (!Tokenizer::parse_double(probabilityString, probability)) {
+			sprintf(chunk->error, "Failed to convert '%s' to a double on line %i in file '%s'.",
+					token_to_string(probabilityString).c_str(), chunk->rows, filename.c_str());
+			chunk->errorSource = "UnifiedFile::load_state_transition_matrix";
 			return true;
 		}
 
 		if (probability < 0.0 || probability > 1.0) {
-			sprintf(error, "Invalid probability '%s' on line %i in file '%s'.",
-					probabilityString.c_str(), rows, filename.c_str());
-			log_message("UnifiedFile::load_state_transition_matrix", error);
+			sprintf(chunk->error, "Invalid probability '%s' on line %i in file '%s'.",
+					token_to_string(probabilityString).c_str(), chunk->rows, filename.c_str());
+			chunk->errorSource = "UnifiedFile::load_state_transition_matrix";
 			return true;
 		}
 
-		stateTransitions->set(orderedStates[stateIndex], loadingAction, orderedStates[counter], probability);
+		chunk->stateTransitions.push_back({orderedStates[stateIndex], chunk->loadingAction, orderedStates[counter], probability});
 
 		counter++;
 	}
@@ -1304,143 +1734,404 @@ bool UnifiedFile::load_state_transition_matrix(unsigned int stateIndex, std::str
 	return false;
 }
 
-int UnifiedFile::load_observation_transition(std::vector<std::string> items)
+bool UnifiedFile::load_factored_state_transition_parents(std::vector<std::string> items)
 {
-	// Ensure a valid number of items.
-	if (items.size() < 2 || items.size() > 5) {
+	if (items.size() < 2 || items.size() > 3) {
+		sprintf(error, "Expected a factor and a list of parent factors on line %i in file '%s'.",
+				rows, filename.c_str());
+		log_message("UnifiedFile::load_factored_state_transition_parents", error);
+		return true;
+	}
+
+	FactoredStateTransitions *T = get_factored_state_transitions("UnifiedFile::load_factored_state_transition_parents");
+	if (T == nullptr) {
+		return true;
+	}
+
+	// The list of parents is empty if only the factor is given.
+	std::vector<std::string> list;
+	list.push_back(items[1]);
+	if (items.size() == 3) {
+		std::vector<std::string> parentList = split_string_by_space(items[2]);
+		list.insert(list.end(), parentList.begin(), parentList.end());
+	}
+
+	std::vector<unsigned int> factors;
+
+	for (std::string factor : list) {
+		int n = -1;
+		try {
+			n = std::stoi(factor);
+		} catch (const std::invalid_argument &err) {
+			n = -1;
+		}
+
+		if (n < 0 || n >= (int)dynamic_cast<FactoredStatesMap *>(states)->get_num_factors()) {
+			sprintf(error, "Factor '%s' is not a valid factor index on line %i in file '%s'.",
+					factor.c_str(), rows, filename.c_str());
+			log_message("UnifiedFile::load_factored_state_transition_parents", error);
+			return true;
+		}
+
+		factors.push_back((unsigned int)n);
+	}
+
+	try {
+		T->set_parents(factors[0], std::vector<unsigned int>(factors.begin() + 1, factors.end()));
+	} catch (const StateTransitionException &err) {
+		sprintf(error, "Too many parents for factor '%s' on line %i in file '%s'.",
+				items[1].c_str(), rows, filename.c_str());
+		log_message("UnifiedFile::load_factored_state_transition_parents", error);
+		return true;
+	}
+
+	return false;
+}
+
+int UnifiedFile::load_factored_state_transition(std::vector<std::string> items)
+{
+	FactoredStateTransitions *T = get_factored_state_transitions("UnifiedFile::load_factored_state_transition");
+	if (T == nullptr) {
+		return -1;
+	}
+
+	if (items.size() < 3) {
 		sprintf(error, "Incomplete statement on line %i in file '%s'.", rows, filename.c_str());
-		log_message("UnifiedFile::load_observation_transition", error);
+		log_message("UnifiedFile::load_factored_state_transition", error);
 		return -1;
 	}
 
-	// Create the observation transitions object if it has not been made yet.
-	if (observationTransitions == nullptr) {
-		observationTransitions = new ObservationTransitionsMap();
+	int factorIndex = -1;
+	try {
+		factorIndex = std::stoi(items[1]);
+	} catch (const std::invalid_argument &err) {
+		factorIndex = -1;
+	}
+
+	if (factorIndex < 0 || factorIndex >= (int)dynamic_cast<FactoredStatesMap *>(states)->get_num_factors()) {
+		sprintf(error, "Factor '%s' is not a valid factor index on line %i in file '%s'.",
+				items[1].c_str(), rows, filename.c_str());
+		log_message("UnifiedFile::load_factored_state_transition", error);
+		return -1;
+	}
+
+	// The parent states are only given if the factor has parents.
+	const std::vector<unsigned int> &parents = T->get_parents(factorIndex);
+	unsigned int numParentItems = (parents.size() > 0) ? 1 : 0;
+
+	if (items.size() != 3 + numParentItems && items.size() != 5 + numParentItems) {
+		sprintf(error, "Incomplete statement on line %i in file '%s'.", rows, filename.c_str());
+		log_message("UnifiedFile::load_factored_state_transition", error);
+		return -1;
 	}
 
-	std::string actionName = split_string_by_space(items[1])[0];
 	Action *action = nullptr;
 
-	if (actionName.compare("*") != 0) {
+	if (items[2].compare("*") != 0) {
 		try {
-			action = find_action(actions, actionName);
+			action = find_action(actions, items[2]);
 		} catch (const ActionException &err) {
 			sprintf(error, "Action '%s' has not been defined on line %i in file '%s'.",
-					actionName.c_str(), rows, filename.c_str());
-			log_message("UnifiedFile::load_observation_transition", error);
+					items[2].c_str(), rows, filename.c_str());
+			log_message("UnifiedFile::load_factored_state_transition", error);
 			return -1;
 		}
 	}
 
-	// If this is of the form "O: action :" then a matrix follows.
-	if (items.size() == 2) {
+	std::vector<State *> parentStates;
+
+	if (numParentItems > 0) {
+		std::vector<std::string> list = split_string_by_space(items[3]);
+		if (list.size() != parents.size()) {
+			sprintf(error, "Expected a state for each of the %i parents on line %i in file '%s'.",
+					(int)parents.size(), rows, filename.c_str());
+			log_message("UnifiedFile::load_factored_state_transition", error);
+			return -1;
+		}
+
+		for (unsigned int i = 0; i < list.size(); i++) {
+			State *state = find_factor_state(parents[i], list[i]);
+			if (state == nullptr) {
+				sprintf(error, "State '%s' has not been defined in factor %i on line %i in file '%s'.",
+						list[i].c_str(), parents[i], rows, filename.c_str());
+				log_message("UnifiedFile::load_factored_state_transition", error);
+				return -1;
+			}
+			parentStates.push_back(state);
+		}
+	}
+
+	// If this is of the form "T factor: factor : action : parent states" then a vector follows.
+	if (items.size() == 3 + numParentItems) {
+		loadingFactor = (unsigned int)factorIndex;
 		loadingAction = action;
+		loadingParents = parentStates;
+		return 1;
+	}
+
+	std::string nextStateName = items[3 + numParentItems];
+	State *nextState = find_factor_state(factorIndex, nextStateName);
+	if (nextState == nullptr) {
+		sprintf(error, "State '%s' has not been defined in factor %i on line %i in file '%s'.",
+				nextStateName.c_str(), factorIndex, rows, filename.c_str());
+		log_message("UnifiedFile::load_factored_state_transition", error);
+		return -1;
+	}
+
+	std::string probabilityString = items[4 + numParentItems];
+	double probability = 0.0;
+
+	try {
+		probability = std::stod(probabilityString);
+	} catch (const std::invalid_argument &err) {
+		sprintf(error, "Failed to convert '%s' to a double on line %i in file '%s'.",
+				probabilityString.c_str(), rows, filename.c_str());
+		log_message("UnifiedFile::load_factored_state_transition", error);
+		return -1;
+	}
+
+	if (probability < 0.0 || probability > 1.0) {
+		sprintf(error, "Invalid probability '%s' on line %i in file '%s'.",
+				probabilityString.c_str(), rows, filename.c_str());
+		log_message("UnifiedFile::load_factored_state_transition", error);
+		return -1;
+	}
+
+	T->set(factorIndex, action, parentStates, nextState, probability);
+
+	return 0;
+}
+
+bool UnifiedFile::load_factored_state_transition_vector(std::string line)
+{
+	FactoredStatesMap *S = dynamic_cast<FactoredStatesMap *>(states);
+	FactoredStateTransitions *T = dynamic_cast<FactoredStateTransitions *>(stateTransitions);
+
+	std::vector<std::string> list = split_string_by_space(line);
+
+	if (list.size() != S->get_factor_size(loadingFactor)) {
+		sprintf(error, "Expected a probability for each of the %i states of factor %i on line %i in file '%s'.",
+				(int)S->get_factor_size(loadingFactor), loadingFactor, rows, filename.c_str());
+		log_message("UnifiedFile::load_factored_state_transition_vector", error);
+		return true;
+	}
+
+	for (unsigned int i = 0; i < list.size(); i++) {
+		double probability = 0.0;
+		try {
+			probability = std::stod(list[i]);
+		} catch (const std::invalid_argument &err) {
+			sprintf(error, "Failed to convert '%s' to a double on line %i in file '%s'.",
+					list[i].c_str(), rows, filename.c_str());
+			log_message("UnifiedFile::load_factored_state_transition_vector", error);
+			return true;
+		}
+
+		if (probability < 0.0 || probability > 1.0) {
+			sprintf(error, "Invalid probability '%s' on line %i in file '%s'.",
+					list[i].c_str(), rows, filename.c_str());
+			log_message("UnifiedFile::load_factored_state_transition_vector", error);
+			return true;
+		}
+
+		T->set(loadingFactor, loadingAction, loadingParents, S->get(loadingFactor, i), probability);
+	}
+
+	return false;
+}
+
+FactoredStateTransitions *UnifiedFile::get_factored_state_transitions(const char *source)
+{
+	FactoredStatesMap *S = dynamic_cast<FactoredStatesMap *>(states);
+	if (S == nullptr || S->get_num_states() == 0) {
+		sprintf(error, "Factored state transitions require factored states, on line %i in file '%s'.",
+				rows, filename.c_str());
+		log_message(source, error);
+		return nullptr;
+	}
+
+	if (stateTransitions == nullptr) {
+		stateTransitions = new FactoredStateTransitions(S);
+	}
+
+	FactoredStateTransitions *T = dynamic_cast<FactoredStateTransitions *>(stateTransitions);
+	if (T == nullptr) {
+		sprintf(error, "State transitions were already given by state, on line %i in file '%s'.",
+				rows, filename.c_str());
+		log_message(source, error);
+		return nullptr;
+	}
+
+	return T;
+}
+
+State *UnifiedFile::find_factor_state(unsigned int factorIndex, const std::string &name)
+{
+	FactoredStatesMap *S = dynamic_cast<FactoredStatesMap *>(states);
+
+	for (unsigned int i = 0; i < S->get_factor_size(factorIndex); i++) {
+		NamedState *state = dynamic_cast<NamedState *>(S->get(factorIndex, i));
+		if (state != nullptr && state->get_name().compare(name) == 0) {
+			return state;
+		}
+	}
+
+	return nullptr;
+}
+
+void UnifiedFile::order_states()
+{
+	std::lock_guard<std::mutex> lock(orderedStatesMutex);
+
+	if (states == nullptr || !orderedStates.empty()) {
+		return;
+	}
+
+	for (auto s : *states) {
+		orderedStates.push_back(resolve(s));
+	}
+}
+
+int UnifiedFile::load_observation_transition(UnifiedFileChunk *chunk, const Token *items, unsigned int numItems)
+{
+	// Ensure a valid number of items.
+	if (numItems < 2 || numItems > 5) {
+		sprintf(chunk->error, "Incomplete statement on line %i in file '%s'.", chunk->rows, filename.c_str());
+		chunk->errorSource = "UnifiedFile::load_observation_transition";
+		return -1;
+	}
+
+	// The observation transitions object is created when the chunks are merged, even if this has no values.
+	chunk->hasObservationTransitions = true;
+
+	Token remaining = items[1];
+	Token actionName = items[1];
+	Tokenizer::next_item(remaining, actionName);
+	Action *action = nullptr;
+
+	if (!token_equals(actionName, "*")) {
+		action = lookup_action(actionName, chunk->lookupKey);
+		if (action == nullptr) {
+			sprintf(chunk->error, "Action '%s' has not been defined on line %i in file '%s'.",
+					token_to_string(actionName).c_str(), chunk->rows, filename.c_str());
+			chunk->errorSource = "UnifiedFile::load_observation_transition";
+			return -1;
+		}
+	}
+
+	// If this is of the form "O: action :" then a matrix follows.
+	if (numItems == 2) {
+		chunk->loadingAction = action;
 		return 2;
 	}
 
-	std::string endStateName = split_string_by_space(items[2])[0];
+	remaining = items[2];
+	Token endStateName = items[2];
+	Tokenizer::next_item(remaining, endStateName);
 	State *endState = nullptr;
 
-	if (endStateName.compare("*") != 0) {
-		try {
-			endState = find_state(states, endStateName);
-		} catch (const StateException &err) {
-			sprintf(error, "State '%s' has not been defined on line %i in file '%s'.",
-					endStateName.c_str(), rows, filename.c_str());
-			log_message("UnifiedFile::load_observation_transition", error);
+	if (!token_equals(endStateName, "*")) {
+		endState = lookup_state(endStateName, chunk->lookupKey);
+		if (endState == nullptr) {
+			sprintf(chunk->error, "State '%s' has not been defined on line %i in file '%s'.",
+					token_to_string(endStateName).c_str(), chunk->rows, filename.c_str());
+			chunk->errorSource = "UnifiedFile::load_observation_transition";
 			return -1;
 		}
 	}
 
 	// If this is of the form "O: action : end-state :" then a vector follows.
-	if (items.size() == 3) {
-		loadingAction = action;
-		loadingState = endState;
+	if (numItems == 3) {
+		chunk->loadingAction = action;
+		chunk->loadingState = endState;
 		return 1;
 	}
 
-	std::string observationName = split_string_by_space(items[3])[0];
+	remaining = items[3];
+	Token observationName = items[3];
+	Tokenizer::next_item(remaining, observationName);
 	Observation *observation = nullptr;
 
-	if (observationName.compare("*") != 0) {
-		try {
-			observation = find_observation(observations, observationName);
-		} catch (const ObservationException &err) {
-			sprintf(error, "Observation '%s' has not been defined on line %i in file '%s'.",
-					observationName.c_str(), rows, filename.c_str());
-			log_message("UnifiedFile::load_observation_transition", error);
+	if (!token_equals(observationName, "*")) {
+		observation = lookup_observation(observationName, chunk->lookupKey);
+		if (observation == nullptr) {
+			sprintf(chunk->error, "Observation '%s' has not been defined on line %i in file '%s'.",
+					token_to_string(observationName).c_str(), chunk->rows, filename.c_str());
+			chunk->errorSource = "UnifiedFile::load_observation_transition";
 			return -1;
 		}
 	}
 
-	std::string probabilityString = split_string_by_space(items[4])[0];
+	remaining = items[4];
+	Token probabilityString = items[4];
+	Tokenizer::next_item(remaining, probabilityString);
 	double probability = 0.0;
 
-	try {
-		probability = std::stod(probabilityString);
-	} catch (const std::invalid_argument &err) {
-		sprintf(error, "Failed to convert '%s' to a double on line %i in file '%s'.",
-				probabilityString.c_str(), rows, filename.c_str());
-		log_message("UnifiedFile::load_observation_transition", error);
+	if (!Tokenizer::parse_double(probabilityString, probability)) {
+		sprintf(chunk->error, "Failed to convert '%s' to a double on line %i in file '%s'.",
+				token_to_string(probabilityString).c_str(), chunk->rows, filename.c_str());
+		chunk->errorSource = "UnifiedFile::load_observation_transition";
 		return -1;
 	}
 
 	if (probability < 0.0 || probability > 1.0) {
-		sprintf(error, "Invalid probability '%s' on line %i in file '%s'.",
-				probabilityString.c_str(), rows, filename.c_str());
-		log_message("UnifiedFile::load_observation_transition", error);
+		sprintf(chunk->error, "Invalid probability '%s' on line %i in file '%s'.",
+				token_to_string(probabilityString).c_str(), chunk->rows, filename.c_str());
+		chunk->errorSource = "UnifiedFile::load_observation_transition";
 		return true;
 	}
 
-	observationTransitions->set(action, endState, observation, probability);
+	chunk->observationTransitions.push_back({action, endState, observation, probability});
 
 	return 0;
 }
 
-bool UnifiedFile::load_observation_transition_vector(std::string line)
+bool UnifiedFile::load_observation_transition_vector(UnifiedFileChunk *chunk, const Token &line)
 {
-	// Split the line into a list of (hopefully) probabilities equal to the number of observations.
-	std::vector<std::string> list = split_string_by_space(line);
+	// The line is a list of (hopefully) probabilities equal to the number of observations.
+	Token remaining = line;
+	Token probabilityString = line;
+	Tokenizer::next_item(remaining, probabilityString);
 
 	// Handle the special case of "uniform".
-	if (list[0].compare("uniform") == 0) {
+	if (token_equals(probabilityString, "uniform")) {
 		double probability = 1.0 / (double)observations->get_num_observations();
 		for (unsigned int i = 0; i < observations->get_num_observations(); i++) {
-			observationTransitions->set(loadingAction, loadingState, orderedObservations[i], probability);
+			chunk->observationTransitions.push_back({chunk->loadingAction, chunk->loadingState, orderedObservations[i], probability});
 		}
 		return false;
 	}
 
-	if (list.size() != observations->get_num_observations()) {
-		sprintf(error, "Invalid number of probabilities given: %i != %i on line %i in file '%s'.",
-				(int)list.size(), observations->get_num_observations(), rows, filename.c_str());
-		log_message("UnifiedFile::load_observation_transition_vector", error);
+	unsigned int numProbabilities = Tokenizer::count_items(line);
+	if (numProbabilities != observations->get_num_observations()) {
+		sprintf(chunk->error, "Invalid number of probabilities given: %i != %i on line %i in file '%s'.",
+				(int)numProbabilities, observations->get_num_observations(), chunk->rows, filename.c_str());
+		chunk->errorSource = "UnifiedFile::load_observation_transition_vector";
 		return true;
 	}
 
-	// Attempt to convert each string to a probability and set the corresponding transition probability.
+	// Attempt to convert each item to a probability and set the corresponding transition probability.
 	unsigned int counter = 0;
+	remaining = line;
 
-	for (std::string probabilityString : list) {
+	while (Tokenizer::next_item(remaining, probabilityString)) {
 		double probability = 0.0;
 
-		try {
-			probability = std::stod(probabilityString);
-		} catch (const std::invalid_argument &err) {
-			sprintf(error, "Failed to convert '%s' to a double on line %i in file '%s'.",
-					probabilityString.c_str(), rows, filename.c_str());
-			log_message("UnifiedFile::load_observation_transition_vector", error);
+		if (!Tokenizer::parse_double(probabilityString, probability)) {
+			sprintf(chunk->error, "Failed to convert '%s' to a double on line %i in file '%s'.",
+					token_to_string(probabilityString).c_str(), chunk->rows, filename.c_str());
+			chunk->errorSource = "UnifiedFile::load_observation_transition_vector";
 			return true;
 		}
 
 		if (probability < 0.0 || probability > 1.0) {
-			sprintf(error, "Invalid probability '%s' on line %i in file '%s'.",
-					probabilityString.c_str(), rows, filename.c_str());
-			log_message("UnifiedFile::load_observation_transition_vector", error);
+			sprintf(chunk->error, "Invalid probability '%s' on line %i in file '%s'.",
+					token_to_string(probabilityString).c_str(), chunk->rows, filename.c_str());
+			chunk->errorSource = "UnifiedFile::load_observation_transition_vector";
 			return true;
 		}
 
-		observationTransitions->set(loadingAction, loadingState, orderedObservations[counter], probability);
+		chunk->observationTransitions.push_back({chunk->loadingAction, chunk->loadingState, orderedObservations[counter], probability});
 
 		counter++;
 	}
@@ -1448,60 +2139,62 @@ bool UnifiedFile::load_observation_transition_vector(std::string line)
 	return false;
 }
 
-bool UnifiedFile::load_observation_transition_matrix(unsigned int stateIndex, std::string line)
+bool UnifiedFile::load_observation_transition_matrix(UnifiedFileChunk *chunk, unsigned int stateIndex, const Token &line)
 {
-	// Split the line into a list of (hopefully) probabilities equal to the number of observations.
-	std::vector<std::string> list = split_string_by_space(line);
+	// The line is a list of (hopefully) probabilities equal to the number of observations.
+	Token remaining = line;
+	Token probabilityString = line;
+	Tokenizer::next_item(remaining, probabilityString);
 
 	if (stateIndex < 0 || stateIndex >= states->get_num_states()) {
-		sprintf(error, "State index '%i' out of bounds on line %i in file '%s'.",
-				stateIndex, rows, filename.c_str());
-		log_message("UnifiedFile::load_observation_transition_matrix", error);
+		sprintf(chunk->error, "State index '%i' out of bounds on line %i in file '%s'.",
+				stateIndex, chunk->rows, filename.c_str());
+		chunk->errorSource = "UnifiedFile::load_observation_transition_matrix";
 		return true;
 	}
 
 	// Handle the special case of "uniform". Note: "identity" does not make sense here, since the
 	// number of observations and states may not be equal.
-	if (list[0].compare("uniform") == 0) {
+	if (token_equals(probabilityString, "uniform")) {
 		double probability = 1.0 / (double)observations->get_num_observations();
 		for (unsigned int i = 0; i < states->get_num_states(); i++) {
 			for (unsigned int j = 0; j < observations->get_num_observations(); j++) {
-				observationTransitions->set(loadingAction, orderedStates[i], orderedObservations[j], probability);
+				chunk->observationTransitions.push_back({chunk->loadingAction, orderedStates[i], orderedObservations[j], probability});
 			}
 		}
 		return false;
 	}
 
-	if (list.size() != observations->get_num_observations()) {
-		sprintf(error, "Invalid number of probabilities given: '%i != %i' on line %i in file '%s'.",
-				(int)list.size(), observations->get_num_observations(), rows, filename.c_str());
-		log_message("UnifiedFile::load_observation_transition_matrix", error);
+	unsigned int numProbabilities = Tokenizer::count_items(line);
+	if (numProbabilities != observations->get_num_observations()) {
+		sprintf(chunk->error, "Invalid number of probabilities given: '%i != %i' on line %i in file '%s'.",
+				(int)numProbabilities, observations->get_num_observations(), chunk->rows, filename.c_str());
+		chunk->errorSource = "UnifiedFile::load_observation_transition_matrix";
 		return true;
 	}
 
-	// Attempt to convert each string to a probability and set the corresponding transition probability.
+	// Attempt to convert each item to a probability and set the corresponding transition probability.
 	unsigned int counter = 0;
+	remaining = line;
 
-	for (std::string probabilityString : list) {
+	while (Tokenizer::next_item(remaining, probabilityString)) {
 		double probability = 0.0;
 
-		try {
-			probability = std::stod(probabilityString);
-		} catch (const std::invalid_argument &err) {
-			sprintf(error, "Failed to convert '%s' to a double on line %i in file '%s'.",
-					probabilityString.c_str(), rows, filename.c_str());
-			log_message("UnifiedFile::load_observation_transition_matrix", error);
+		if (!Tokenizer::parse_double(probabilityString, probability)) {
+			sprintf(chunk->error, "Failed to convert '%s' to a double on line %i in file '%s'.",
+					token_to_string(probabilityString).c_str(), chunk->rows, filename.c_str());
+			chunk->errorSource = "UnifiedFile::load_observation_transition_matrix";
 			return true;
 		}
 
 		if (probability < 0.0 || probability > 1.0) {
-			sprintf(error, "Invalid probability '%s' on line %i in file '%s'.",
-					probabilityString.c_str(), rows, filename.c_str());
-			log_message("UnifiedFile::load_observation_transition_matrix", error);
+			sprintf(chunk->error, "Invalid probability '%s' on line %i in file '%s'.",
+					token_to_string(probabilityString).c_str(), chunk->rows, filename.c_str());
+			chunk->errorSource = "UnifiedFile::load_observation_transition_matrix";
 			return true;
 		}
 
-		observationTransitions->set(loadingAction, orderedStates[stateIndex], orderedObservations[counter], probability);
+		chunk->observationTransitions.push_back({chunk->loadingAction, orderedStates[stateIndex], orderedObservations[counter], probability});
 
 		counter++;
 	}
@@ -1509,128 +2202,128 @@ bool UnifiedFile::load_observation_transition_matrix(unsigned int stateIndex, st
 	return false;
 }
 
-int UnifiedFile::load_reward(std::vector<std::string> items)
+int UnifiedFile::load_reward(UnifiedFileChunk *chunk, const Token *items, unsigned int numItems)
 {
 	// Ensure a valid number of items.
-	if (items.size() < 2 || items.size() > 5) {
-		sprintf(error, "Incomplete statement on line %i in file '%s'.", rows, filename.c_str());
-		log_message("UnifiedFile::load_reward", error);
+	if (numItems < 2 || numItems > 5) {
+		sprintf(chunk->error, "Incomplete statement on line %i in file '%s'.", chunk->rows, filename.c_str());
+		chunk->errorSource = "UnifiedFile::load_reward";
 		return -1;
 	}
 
-	// Create the rewards object if it has not been made yet.
-	if (rewards == nullptr) {
-		rewards = new SASRewardsMap();
-	}
+	// The rewards object is created when the chunks are merged, even if this has no values.
+	chunk->hasRewards = true;
 
-	std::string actionName = split_string_by_space(items[1])[0];
+	Token remaining = items[1];
+	Token actionName = items[1];
+	Tokenizer::next_item(remaining, actionName);
 	Action *action = nullptr;
 
-	if (actionName.compare("*") != 0) {
-		try {
-			action = find_action(actions, actionName);
-		} catch (const ActionException &err) {
-			sprintf(error, "Action '%s' has not been defined on line %i in file '%s'.",
-					actionName.c_str(), rows, filename.c_str());
-			log_message("UnifiedFile::load_reward", error);
+	if (!token_equals(actionName, "*")) {
+		action = lookup_action(actionName, chunk->lookupKey);
+		if (action == nullptr) {
+			sprintf(chunk->error, "Action '%s' has not been defined on line %i in file '%s'.",
+					token_to_string(actionName).c_str(), chunk->rows, filename.c_str());
+			chunk->errorSource = "UnifiedFile::load_reward";
 			return -1;
 		}
 	}
 
 	// If this is of the form "R: action :" then a matrix follows.
-	if (items.size() == 2) {
-		loadingAction = action;
+	if (numItems == 2) {
+		chunk->loadingAction = action;
 		return 2;
 	}
 
-	std::string startStateName = split_string_by_space(items[2])[0];
+	remaining = items[2];
+	Token startStateName = items[2];
+	Tokenizer::next_item(remaining, startStateName);
 	State *startState = nullptr;
 
-	if (startStateName.compare("*") != 0) {
-		try {
-			startState = find_state(states, startStateName);
-		} catch (const StateException &err) {
-			sprintf(error, "State '%s' has not been defined on line %i in file '%s'.",
-					startStateName.c_str(), rows, filename.c_str());
-			log_message("UnifiedFile::load_reward", error);
+	if (!token_equals(startStateName, "*")) {
+		startState = lookup_state(startStateName, chunk->lookupKey);
+		if (startState == nullptr) {
+			sprintf(chunk->error, "State '%s' has not been defined on line %i in file '%s'.",
+					token_to_string(startStateName).c_str(), chunk->rows, filename.c_str());
+			chunk->errorSource = "UnifiedFile::load_reward";
 			return -1;
 		}
 	}
 
 	// If this is of the form "R: action : start-state :" then a vector follows.
-	if (items.size() == 3) {
-		loadingAction = action;
-		loadingState = startState;
+	if (numItems == 3) {
+		chunk->loadingAction = action;
+		chunk->loadingState = startState;
 		return 1;
 	}
 
-	std::string endStateName = split_string_by_space(items[3])[0];
+	remaining = items[3];
+	Token endStateName = items[3];
+	Tokenizer::next_item(remaining, endStateName);
 	State *endState = nullptr;
 
-	if (endStateName.compare("*") != 0) {
-		try {
-			endState = find_state(states, endStateName);
-		} catch (const StateException &err) {
-			sprintf(error, "State '%s' has not been defined on line %i in file '%s'.",
-					endStateName.c_str(), rows, filename.c_str());
-			log_message("UnifiedFile::load_reward", error);
+	if (!token_equals(endStateName, "*")) {
+		endState = lookup_state(endStateName, chunk->lookupKey);
+		if (endState == nullptr) {
+			sprintf(chunk->error, "State '%s' has not been defined on line %i in file '%s'.",
+					token_to_string(endStateName).c_str(), chunk->rows, filename.c_str());
+			chunk->errorSource = "UnifiedFile::load_reward";
 			return -1;
 		}
 	}
 
-	std::string rewardString = split_string_by_space(items[4])[0];
+	remaining = items[4];
+	Token rewardString = items[4];
+	Tokenizer::next_item(remaining, rewardString);
 	double reward = 0.0;
 
-	try {
-		reward = std::stod(rewardString);
-	} catch (const std::invalid_argument &err) {
-		sprintf(error, "Failed to convert '%s' to a double on line %i in file '%s'.",
-				rewardString.c_str(), rows, filename.c_str());
-		log_message("UnifiedFile::load_reward", error);
+	if (!Tokenizer::parse_double(rewardString, reward)) {
+		sprintf(chunk->error, "Failed to convert '%s' to a double on line %i in file '%s'.",
+				token_to_string(rewardString).c_str(), chunk->rows, filename.c_str());
+		chunk->errorSource = "UnifiedFile::load_reward";
 		return -1;
 	}
 
 	// Set the reward based on the previously loaded 'reward' or 'cost' specification.
 	if (rewardValue) {
-		rewards->set(startState, action, endState, reward);
+		chunk->rewards.push_back({startState, action, endState, reward});
 	} else {
-		rewards->set(startState, action, endState, -reward);
+		chunk->rewards.push_back({startState, action, endState, -reward});
 	}
 
 	return 0;
 }
 
-bool UnifiedFile::load_reward_vector(std::string line)
+bool UnifiedFile::load_reward_vector(UnifiedFileChunk *chunk, const Token &line)
 {
-	// Split the line into a list of (hopefully) rewards equal to the number of states.
-	std::vector<std::string> list = split_string_by_space(line);
-
-	if (list.size() != states->get_num_states()) {
-		sprintf(error, "Invalid number of rewards given: %i != %i on line %i in file '%s'.",
-				(int)list.size(), states->get_num_states(), rows, filename.c_str());
-		log_message("UnifiedFile::load_reward_vector", error);
+	// The line is a list of (hopefully) rewards equal to the number of states.
+	unsigned int numRewards = Tokenizer::count_items(line);
+	if (numRewards != states->get_num_states()) {
+		sprintf(chunk->error, "Invalid number of rewards given: %i != %i on line %i in file '%s'.",
+				(int)numRewards, states->get_num_states(), chunk->rows, filename.c_str());
+		chunk->errorSource = "UnifiedFile::load_reward_vector";
 		return true;
 	}
 
-	// Attempt to convert each string to a reward and set the corresponding value accordingly.
+	// Attempt to convert each item to a reward and set the corresponding value accordingly.
 	unsigned int counter = 0;
+	Token remaining = line;
+	Token rewardString;
 
-	for (std::string rewardString : list) {
+	while (Tokenizer::next_item(remaining, rewardString)) {
 		double reward = 0.0;
 
-		try {
-			reward = std::stod(rewardString);
-		} catch (const std::invalid_argument &err) {
-			sprintf(error, "Failed to convert '%s' to a double on line %i in file '%s'.",
-					rewardString.c_str(), rows, filename.c_str());
-			log_message("UnifiedFile::load_reward_vector", error);
+		if (!Tokenizer::parse_double(rewardString, reward)) {
+			sprintf(chunk->error, "Failed to convert '%s' to a double on line %i in file '%s'.",
+					token_to_string(rewardString).c_str(), chunk->rows, filename.c_str());
+			chunk->errorSource = "UnifiedFile::load_reward_vector";
 			return true;
 		}
 
 		if (rewardValue) {
-			rewards->set(orderedStates[counter], loadingAction, loadingState, reward);
+			chunk->rewards.push_back({orderedStates[counter], chunk->loadingAction, chunk->loadingState, reward});
 		} else {
-			rewards->set(orderedStates[counter], loadingAction, loadingState, -reward);
+			chunk->rewards.push_back({orderedStates[counter], chunk->loadingAction, chunk->loadingState, -reward});
 		}
 
 		counter++;
@@ -1639,44 +2332,43 @@ bool UnifiedFile::load_reward_vector(std::string line)
 	return false;
 }
 
-bool UnifiedFile::load_reward_matrix(unsigned int stateIndex, std::string line)
+bool UnifiedFile::load_reward_matrix(UnifiedFileChunk *chunk, unsigned int stateIndex, const Token &line)
 {
-	// Split the line into a list of (hopefully) rewards equal to the number of states.
-	std::vector<std::string> list = split_string_by_space(line);
-
 	if (stateIndex < 0 || stateIndex >= states->get_num_states()) {
-		sprintf(error, "State index '%i' out of bounds on line %i in file '%s'.",
-				stateIndex, rows, filename.c_str());
-		log_message("UnifiedFile::load_reward_matrix", error);
+		sprintf(chunk->error, "State index '%i' out of bounds on line %i in file '%s'.",
+				stateIndex, chunk->rows, filename.c_str());
+		chunk->errorSource = "UnifiedFile::load_reward_matrix";
 		return true;
 	}
 
-	if (list.size() != states->get_num_states()) {
-		sprintf(error, "Invalid number of rewards given: '%i != %i' on line %i in file '%s'.",
-				(int)list.size(), states->get_num_states(), rows, filename.c_str());
-		log_message("UnifiedFile::load_reward_matrix", error);
+	// The line is a list of (hopefully) rewards equal to the number of states.
+	unsigned int numRewards = Tokenizer::count_items(line);
+	if (numRewards != states->get_num_states()) {
+		sprintf(chunk->error, "Invalid number of rewards given: '%i != %i' on line %i in file '%s'.",
+				(int)numRewards, states->get_num_states(), chunk->rows, filename.c_str());
+		chunk->errorSource = "UnifiedFile::load_reward_matrix";
 		return true;
 	}
 
-	// Attempt to convert each string to a reward and set the corresponding value accordingly.
+	// Attempt to convert each item to a reward and set the corresponding value accordingly.
 	unsigned int counter = 0;
+	Token remaining = line;
+	Token rewardString;
 
-	for (std::string rewardString : list) {
+	while (Tokenizer::next_item(remaining, rewardString)) {
 		double reward = 0.0;
 
-		try {
-			reward = std::stod(rewardString);
-		} catch (const std::invalid_argument &err) {
-			sprintf(error, "Failed to convert '%s' to a double on line %i in file '%s'.",
-					rewardString.c_str(), rows, filename.c_str());
-			log_message("UnifiedFile::load_reward_matrix", error);
+		if (!Tokenizer::parse_double(rewardString, reward)) {
+			sprintf(chunk->error, "Failed to convert '%s' to a double on line %i in file '%s'.",
+					token_to_string(rewardString).c_str(), chunk->rows, filename.c_str());
+			chunk->errorSource = "UnifiedFile::load_reward_matrix";
 			return true;
 		}
 
 		if (rewardValue) {
-			rewards->set(orderedStates[stateIndex], loadingAction, orderedStates[counter], reward);
+			chunk->rewards.push_back({orderedStates[stateIndex], chunk->loadingAction, orderedStates[counter], reward});
 		} else {
-			rewards->set(orderedStates[stateIndex], loadingAction, orderedStates[counter], -reward);
+			chunk->rewards.push_back({orderedStates[stateIndex], chunk->loadingAction, orderedStates[counter], -reward});
 		}
 
 		counter++;
@@ -1685,6 +2377,74 @@ bool UnifiedFile::load_reward_matrix(unsigned int stateIndex, std::string line)
 	return false;
 }
 
+State *UnifiedFile::lookup_state(const Token &name, std::string &key) const
+{
+	if (states == nullptr) {
+		return nullptr;
+	}
+
+	set_lookup_key(name, key);
+
+	try {
+		return states->get_by_name(key);
+	} catch (const StateException &err) {
+		return nullptr;
+	}
+}
+
+Action *UnifiedFile::lookup_action(const Token &name, std::string &key) const
+{
+	if (actions == nullptr) {
+		return nullptr;
+	}
+
+	set_lookup_key(name, key);
+
+	try {
+		return actions->get_by_name(key);
+	} catch (const ActionException &err) {
+		return nullptr;
+	}
+}
+
+Observation *UnifiedFile::lookup_observation(const Token &name, std::string &key) const
+{
+	if (observations == nullptr) {
+		return nullptr;
+	}
+
+	set_lookup_key(name, key);
+
+	try {
+		return observations->get_by_name(key);
+	} catch (const ObservationException &err) {
+		return nullptr;
+	}
+}
+
+void UnifiedFile::set_lookup_key(const Token &name, std::string &key)
+{
+	// Joint names inside "<...>" may be separated by any number of spaces or tabs, but the index
+	// uses exactly one space. Assigning into the existing buffer avoids an allocation.
+	key.clear();
+
+	bool space = false;
+	for (unsigned int i = 0; i < name.length; i++) {
+		char c = name.data[i];
+		if (c == ' ' || c == '\t') {
+			space = true;
+			continue;
+		}
+
+		if (space && !key.empty()) {
+			key += ' ';
+		}
+		space = false;
+
+		key += c;
+	}
+}
+
 void UnifiedFile::release()
 {
 	agents = nullptr;
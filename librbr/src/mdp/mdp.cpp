@@ -85,3 +85,15 @@ Horizon *MDP::get_horizon()
 {
 	return horizon;
 }
+
+void MDP::freeze()
+{
+	if (stateTransitions != nullptr) {
+		stateTransitions->freeze(states, actions);
+	}
+}
+
+bool MDP::is_frozen() const
+{
+	return stateTransitions == nullptr || stateTransitions->is_frozen();
+}
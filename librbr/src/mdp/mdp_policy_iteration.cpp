@@ -25,6 +25,10 @@
 #include "../../include/mdp/mdp_policy_iteration.h"
 #include "../../include/mdp/mdp_utilities.h"
 
+#include "../../include/management/fingerprint.h"
+
+#include "../../include/core/actions/indexed_action.h"
+
 #include "../../include/core/states/state_exception.h"
 #include "../../include/core/actions/action_exception.h"
 #include "../../include/core/state_transitions/state_transition_exception.h"
@@ -33,16 +37,19 @@
 
 #include <unordered_map>
 #include <math.h>
+#include <cstdio>
 #include <eigen3/Eigen/Dense>
 
 MDPPolicyIteration::MDPPolicyIteration()
 {
 	modifiedK = 0;
+	cache = nullptr;
 }
 
 MDPPolicyIteration::MDPPolicyIteration(unsigned int k)
 {
 	modifiedK = k;
+	cache = nullptr;
 }
 
 MDPPolicyIteration::~MDPPolicyIteration()
@@ -67,9 +74,9 @@ PolicyMap *MDPPolicyIteration::solve(MDP *mdp)
 		throw ActionException();
 	}
 
-	// Attempt to convert the state transitions object into FiniteStateTransitions.
-	StateTransitionsMap *T =
-			dynamic_cast<StateTransitionsMap *>(mdp->get_state_transitions());
+	// Attempt to convert the state transitions object into StateTransitions.
+	StateTransitions *T =
+			dynamic_cast<StateTransitions *>(mdp->get_state_transitions());
 	if (T == nullptr) {
 		throw StateTransitionException();
 	}
@@ -86,20 +93,67 @@ PolicyMap *MDPPolicyIteration::solve(MDP *mdp)
 		throw PolicyException();
 	}
 
-	// Compute the optimal policy based on the desired version.
-	if (modifiedK == 0) {
-		return solve_exact(S, A, T, R, h);
-	} else {
-		return solve_modified(S, A, T, R, h);
+	// Consult the policy cache before solving.
+	uint64_t modelFingerprint = 0;
+	char key[64];
+	std::snprintf(key, sizeof(key), "MDPPolicyIteration k=%u", modifiedK);
+
+	if (cache != nullptr) {
+		modelFingerprint = fingerprint_model(mdp);
+		PolicyMap *policy = cache->load_policy_map(mdp, modelFingerprint, key);
+		if (policy != nullptr) {
+			V.clear();
+			return policy;
+		}
+	}
+
+	PolicyMap *policy = nullptr;
+
+	// Models stored as arrays are solved by index, without any casts in the inner loop.
+	StateTransitionsArray *Tarray = dynamic_cast<StateTransitionsArray *>(T);
+	SASRewardsArray *Rarray = dynamic_cast<SASRewardsArray *>(R);
+	if (Tarray != nullptr && Rarray != nullptr) {
+		policy = solve_array(S, A, Tarray, Rarray, h);
 	}
+
+	if (policy == nullptr) {
+		// Compute every list of successors, and their probabilities, once and in parallel before solving.
+		T->build_successors(S, A);
+
+		// Compute the optimal policy based on the desired version.
+		if (modifiedK == 0) {
+			policy = solve_exact(S, A, T, R, h);
+		} else {
+			policy = solve_modified(S, A, T, R, h);
+		}
+	}
+
+	if (cache != nullptr) {
+		cache->save_policy_map(mdp, modelFingerprint, key, policy);
+	}
+
+	return policy;
 }
 
-PolicyMap *MDPPolicyIteration::solve_exact(StatesMap *S, ActionsMap *A, StateTransitionsMap *T,
+void MDPPolicyIteration::set_policy_cache(PolicyCache *policyCache)
+{
+	cache = policyCache;
+}
+
+const std::unordered_map<State *, double> &MDPPolicyIteration::get_V() const
+{
+	return V;
+}
+
+PolicyMap *MDPPolicyIteration::solve_exact(StatesMap *S, ActionsMap *A, StateTransitions *T,
 		SASRewards *R, Horizon *h)
 {
+	// Start with the first available action in each state.
 	PolicyMap *policy = new PolicyMap(h);
-	for (auto s : *S) {
-		policy->set(resolve(s), A->begin()->second);
+	for (auto state : *S) {
+		State *s = resolve(state);
+		const std::vector<Action *> &available = A->available(s);
+		policy->set(s, available.empty() ? *A->begin() : available.front());
 	}
 
 	// Create the M matrix with each cell M(i, j) denoting the i-th starting state s_i and
@@ -156,7 +210,7 @@ PolicyMap *MDPPolicyIteration::solve_exact(StatesMap *S, ActionsMap *A, StateTra
 		x = M.colPivHouseholderQr().solve(b);
 
 		// Store updates in V.
-		std::unordered_map<State *, double> V;
+		V.clear();
 		i = 0;
 		for (auto s : *S) {
 			V[resolve(s)] = x(i);
@@ -185,14 +239,14 @@ PolicyMap *MDPPolicyIteration::solve_exact(StatesMap *S, ActionsMap *A, StateTra
 	return policy;
 }
 
-PolicyMap *MDPPolicyIteration::solve_modified(StatesMap *S, ActionsMap *A, StateTransitionsMap *T,
+PolicyMap *MDPPolicyIteration::solve_modified(StatesMap *S, ActionsMap *A, StateTransitions *T,
 		SASRewards *R, Horizon *h)
 {
 	// Create the policy based on the horizon.
 	PolicyMap *policy = new PolicyMap(h);
 
 	// The value of the states, which will be constantly improved over iterations.
-	std::unordered_map<State *, double> V;
+	V.clear();
 
 	// Continue to iterate until the policy is unchanged in between two iterations.
 	bool unchanged = false;
@@ -233,3 +287,103 @@ PolicyMap *MDPPolicyIteration::solve_modified(StatesMap *S, ActionsMap *A, State
 
 	return policy;
 }
+
+PolicyMap *MDPPolicyIteration::solve_array(StatesMap *S, ActionsMap *A, StateTransitionsArray *T,
+		SASRewardsArray *R, Horizon *h)
+{
+	// The states in the order of the set, with their indexes into the arrays, and the indexes of the
+	// actions available in each.
+	std::vector<State *> states;
+	std::vector<unsigned int> stateIndexes;
+	std::vector<Action *> actions;
+	std::vector<std::vector<unsigned int> > available;
+
+	if (!index_mdp_arrays(S, A, T, R, states, stateIndexes, actions, available)) {
+		return nullptr;
+	}
+
+	unsigned int n = T->get_num_states();
+	unsigned int m = T->get_num_actions();
+	double gamma = h->get_discount_factor();
+
+	// The values by state index, and the index of the policy's action in each of the states (initially
+	// none, i.e., m).
+	std::vector<double> Vs(n, 0.0);
+	std::vector<unsigned int> pi(states.size(), m);
+
+	// Continue to iterate until the policy is unchanged in between two iterations.
+	bool unchanged = false;
+
+	if (modifiedK == 0) {
+		// Start with the first available action in each state, as in solve_exact.
+		unsigned int first = dynamic_cast<IndexedAction *>(*A->begin())->get_index();
+		for (unsigned int i = 0; i < states.size(); i++) {
+			pi[i] = (available[i].empty() ? first : available[i].front());
+		}
+
+		Eigen::MatrixXd M(n, n);
+		Eigen::VectorXd b(n);
+
+		while (!unchanged) {
+			unchanged = true;
+
+			// Update M = gamma T^pi - I and b = -sum T^pi R^pi with the new policy, one row at a time.
+			for (unsigned int i = 0; i < states.size(); i++) {
+				unsigned int s = stateIndexes[i];
+				const float *Tsa = T->get_row(s, pi[i]);
+				const float *Rsa = R->get_row(s, pi[i]);
+
+				b(s) = 0.0;
+				for (unsigned int sp = 0; sp < n; sp++) {
+					M(s, sp) = gamma * Tsa[sp];
+					b(s) -= (double)Tsa[sp] * (double)Rsa[sp];
+				}
+				M(s, s) -= 1.0;
+			}
+
+			// Solve the system of linear equations to find V(s) for all states s in S.
+			Eigen::VectorXd x = M.colPivHouseholderQr().solve(b);
+			for (unsigned int s = 0; s < n; s++) {
+				Vs[s] = x(s);
+			}
+
+			// Compute the action which maximizes the expected reward, checking if any policy changes occur.
+			for (unsigned int i = 0; i < states.size(); i++) {
+				unsigned int aBest = pi[i];
+				bellman_update(T, R, gamma, stateIndexes[i], available[i], Vs, aBest);
+
+				if (aBest != pi[i]) {
+					pi[i] = aBest;
+					unchanged = false;
+				}
+			}
+		}
+	} else {
+		while (!unchanged) {
+			unchanged = true;
+
+			// Perform the Bellman update of every state k times, checking for policy changes on the last.
+			for (unsigned int k = 0; k < modifiedK; k++) {
+				for (unsigned int i = 0; i < states.size(); i++) {
+					unsigned int aBest = pi[i];
+					bellman_update(T, R, gamma, stateIndexes[i], available[i], Vs, aBest);
+
+					if (k == modifiedK - 1 && aBest != pi[i]) {
+						pi[i] = aBest;
+						unchanged = false;
+					}
+				}
+			}
+		}
+	}
+
+	PolicyMap *policy = new PolicyMap(h);
+
+	V.clear();
+	for (unsigned int i = 0; i < states.size(); i++) {
+		policy->set(states[i], pi[i] < m ? actions[pi[i]] : nullptr);
+		V[states[i]] = Vs[stateIndexes[i]];
+	}
+
+	return policy;
+}
@@ -24,9 +24,12 @@
 
 #include "../../include/mdp/mdp_utilities.h"
 
+#include "../../include/core/states/indexed_state.h"
+#include "../../include/core/actions/indexed_action.h"
 #include "../../include/core/state_transitions/state_transition_exception.h"
 
 #include <limits>
+#include <algorithm>
 #include <math.h>
 
 void bellman_update(StatesMap *S, ActionsMap *A, StateTransitions *T,
@@ -36,15 +39,16 @@ void bellman_update(StatesMap *S, ActionsMap *A, StateTransitions *T,
 	double maxQsa = std::numeric_limits<double>::lowest();
 
 	// For all the actions, compute max Q(s, a), and argmax Q(s, a), both over the set of available actions.
-	for (auto action : A->available(s)) {
-		Action *a = resolve(action);
-
+	for (Action *a : A->available(s)) {
 		// Compute the Q(s, a) estimate.
 		double Qsa = 0.0;
 
 		try {
-			for (State *sp : T->successors(S, s, a)) {
-				Qsa += T->get(s, a, sp) * (R->get(s, a, sp) + h->get_discount_factor() * V[sp]);
+			const std::vector<State *> &succ = T->successors(S, s, a);
+			const std::vector<float> &prob = T->probabilities(S, s, a);
+
+			for (unsigned int i = 0; i < succ.size(); i++) {
+				Qsa += prob[i] * (R->get(s, a, succ[i]) + h->get_discount_factor() * V[succ[i]]);
 			}
 		} catch (StateTransitionException &err) {
 			for (auto sPrime : *S) {
@@ -63,6 +67,93 @@ void bellman_update(StatesMap *S, ActionsMap *A, StateTransitions *T,
 	V[s] = maxQsa;
 }
 
+/**
+ * Compute Q(s, a) for an MDP stored as arrays, by index, over the non-zero state transitions.
+ * @param	T		The state transitions array.
+ * @param	R		The state-action-state rewards array.
+ * @param	gamma	The discount factor.
+ * @param	s		The index of the state.
+ * @param	a		The index of the action.
+ * @param	V		The values, by state index.
+ * @return	The value of taking the action in the state.
+ */
+static double compute_Q(StateTransitionsArray *T, SASRewardsArray *R, double gamma, unsigned int s,
+		unsigned int a, const std::vector<double> &V)
+{
+	unsigned int n = T->get_num_states();
+	const float *Tsa = T->get_row(s, a);
+	const float *Rsa = R->get_row(s, a);
+
+	double Qsa = 0.0;
+	for (unsigned int sp = 0; sp < n; sp++) {
+		if (Tsa[sp] > 0.0f) {
+			Qsa += (double)Tsa[sp] * ((double)Rsa[sp] + gamma * V[sp]);
+		}
+	}
+
+	return Qsa;
+}
+
+void bellman_update(StateTransitionsArray *T, SASRewardsArray *R, double gamma, unsigned int s,
+		const std::vector<unsigned int> &available, std::vector<double> &V, unsigned int &aBest)
+{
+	double maxQsa = std::numeric_limits<double>::lowest();
+
+	for (unsigned int a : available) {
+		double Qsa = compute_Q(T, R, gamma, s, a, V);
+		if (Qsa > maxQsa) {
+			maxQsa = Qsa;
+			aBest = a;
+		}
+	}
+
+	V[s] = maxQsa;
+}
+
+bool index_mdp_arrays(StatesMap *S, ActionsMap *A, StateTransitionsArray *T, SASRewardsArray *R,
+		std::vector<State *> &states, std::vector<unsigned int> &stateIndexes, std::vector<Action *> &actions,
+		std::vector<std::vector<unsigned int> > &available)
+{
+	unsigned int n = T->get_num_states();
+	unsigned int m = T->get_num_actions();
+
+	if (R->get_num_states() != n || R->get_num_actions() != m || S->get_num_states() != n) {
+		return false;
+	}
+
+	states.clear();
+	stateIndexes.clear();
+	std::vector<bool> found(n, false);
+	for (auto state : *S) {
+		IndexedState *s = dynamic_cast<IndexedState *>(resolve(state));
+		if (s == nullptr || s->get_index() >= n || found[s->get_index()]) {
+			return false;
+		}
+		found[s->get_index()] = true;
+		states.push_back(s);
+		stateIndexes.push_back(s->get_index());
+	}
+
+	actions.assign(m, nullptr);
+	for (auto action : *A) {
+		IndexedAction *a = dynamic_cast<IndexedAction *>(resolve(action));
+		if (a == nullptr || a->get_index() >= m || actions[a->get_index()] != nullptr) {
+			return false;
+		}
+		actions[a->get_index()] = a;
+	}
+
+	// The available actions are all within the set of actions, so each is indexed.
+	available.assign(states.size(), std::vector<unsigned int>());
+	for (unsigned int i = 0; i < states.size(); i++) {
+		for (Action *a : A->available(states[i])) {
+			available[i].push_back(dynamic_cast<IndexedAction *>(a)->get_index());
+		}
+	}
+
+	return true;
+}
+
 void compute_V_pi(StatesMap *S, ActionsMap *A, StateTransitions *T, SASRewards *R, Horizon *h,
 		double epsilon, PolicyMap *pi, std::unordered_map<State *, double> &V)
 {
@@ -74,6 +165,48 @@ void compute_V_pi(StatesMap *S, ActionsMap *A, StateTransitions *T, SASRewards *
 	double convergenceCriterion = epsilon * (1.0 - h->get_discount_factor()) / h->get_discount_factor();
 	double delta = convergenceCriterion + 1.0;
 
+	// Models stored as arrays are evaluated by index, in the same order as below.
+	StateTransitionsArray *Tarray = dynamic_cast<StateTransitionsArray *>(T);
+	SASRewardsArray *Rarray = dynamic_cast<SASRewardsArray *>(R);
+
+	std::vector<State *> states;
+	std::vector<unsigned int> stateIndexes;
+	std::vector<Action *> actions;
+	std::vector<std::vector<unsigned int> > available;
+
+	bool indexed = (Tarray != nullptr && Rarray != nullptr &&
+			index_mdp_arrays(S, A, Tarray, Rarray, states, stateIndexes, actions, available));
+
+	std::vector<unsigned int> actionIndexes;
+	for (unsigned int i = 0; indexed && i < states.size(); i++) {
+		IndexedAction *a = dynamic_cast<IndexedAction *>(pi->get(states[i]));
+		indexed = (a != nullptr && a->get_index() < actions.size());
+		if (indexed) {
+			actionIndexes.push_back(a->get_index());
+		}
+	}
+
+	if (indexed) {
+		std::vector<double> Vs(Tarray->get_num_states(), 0.0);
+
+		while (delta > convergenceCriterion) {
+			delta = 0.0;
+
+			for (unsigned int i = 0; i < states.size(); i++) {
+				unsigned int s = stateIndexes[i];
+				double QsPIs = compute_Q(Tarray, Rarray, h->get_discount_factor(), s, actionIndexes[i], Vs);
+				delta = std::max(delta, fabs(Vs[s] - QsPIs));
+				Vs[s] = QsPIs;
+			}
+		}
+
+		for (unsigned int i = 0; i < states.size(); i++) {
+			V[states[i]] = Vs[stateIndexes[i]];
+		}
+
+		return;
+	}
+
 	while (delta > convergenceCriterion) {
 		delta = 0.0;
 
@@ -84,8 +217,12 @@ void compute_V_pi(StatesMap *S, ActionsMap *A, StateTransitions *T, SASRewards *
 			double QsPIs = 0.0;
 
 			try {
-				for (State *sp : T->successors(S, s, pi->get(s))) {
-					QsPIs += T->get(s, pi->get(s), sp) * (R->get(s, pi->get(s), sp) + h->get_discount_factor() * V[sp]);
+				Action *a = pi->get(s);
+				const std::vector<State *> &succ = T->successors(S, s, a);
+				const std::vector<float> &prob = T->probabilities(S, s, a);
+
+				for (unsigned int i = 0; i < succ.size(); i++) {
+					QsPIs += prob[i] * (R->get(s, a, succ[i]) + h->get_discount_factor() * V[succ[i]]);
 				}
 			} catch (StateTransitionException &err) {
 				for (auto sPrime : *S) {
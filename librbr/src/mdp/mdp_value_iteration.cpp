@@ -25,6 +25,11 @@
 #include "../../include/mdp/mdp_value_iteration.h"
 #include "../../include/mdp/mdp_utilities.h"
 
+#include "../../include/management/fingerprint.h"
+#include "../../include/management/raw_file_stream.h"
+
+#include "../../include/core/core_exception.h"
+#include "../../include/core/policy/policy_binary.h"
 #include "../../include/core/states/state_exception.h"
 #include "../../include/core/actions/action_exception.h"
 #include "../../include/core/state_transitions/state_transition_exception.h"
@@ -32,15 +37,19 @@
 #include "../../include/core/policy/policy_exception.h"
 
 #include <math.h>
+#include <limits>
+#include <cstdio>
 
 MDPValueIteration::MDPValueIteration()
 {
 	epsilon = 0.001;
+	cache = nullptr;
 }
 
 MDPValueIteration::MDPValueIteration(double tolerance)
 {
 	epsilon = tolerance;
+	cache = nullptr;
 }
 
 MDPValueIteration::~MDPValueIteration()
@@ -78,13 +87,146 @@ PolicyMap *MDPValueIteration::solve(MDP *mdp)
 		throw RewardException();
 	}
 
-	// Obtain the horizon and return the correct value iteration.
+	// Consult the policy cache before solving. The key includes the tolerance, since it changes the policy.
+	uint64_t modelFingerprint = 0;
+	char key[64];
+	std::snprintf(key, sizeof(key), "MDPValueIteration epsilon=%.17g", epsilon);
+
+	if (cache != nullptr) {
+		modelFingerprint = fingerprint_model(mdp);
+		PolicyMap *policy = cache->load_policy_map(mdp, modelFingerprint, key);
+		if (policy != nullptr) {
+			V.clear();
+			return policy;
+		}
+	}
+
+	PolicyMap *policy = nullptr;
 	Horizon *h = mdp->get_horizon();
-	if (h->is_finite()) {
-		return solve_finite_horizon(S, A, T, R, h);
-	} else {
-		return solve_infinite_horizon(S, A, T, R, h);
+
+	// Models stored as arrays are solved by index, without any casts in the inner loop.
+	StateTransitionsArray *Tarray = dynamic_cast<StateTransitionsArray *>(T);
+	SASRewardsArray *Rarray = dynamic_cast<SASRewardsArray *>(R);
+	if (Tarray != nullptr && Rarray != nullptr) {
+		policy = solve_array(S, A, Tarray, Rarray, h);
+	}
+
+	if (policy == nullptr) {
+		// Compute every list of successors, and their probabilities, once and in parallel before solving.
+		T->build_successors(S, A);
+
+		// Obtain the horizon and return the correct value iteration.
+		if (h->is_finite()) {
+			policy = solve_finite_horizon(S, A, T, R, h);
+		} else {
+			policy = solve_infinite_horizon(S, A, T, R, h);
+		}
+	}
+
+	if (cache != nullptr) {
+		cache->save_policy_map(mdp, modelFingerprint, key, policy);
 	}
+
+	return policy;
+}
+
+void MDPValueIteration::set_policy_cache(PolicyCache *policyCache)
+{
+	cache = policyCache;
+}
+
+PolicyMap *MDPValueIteration::solve_out_of_core(std::string filename, StatesMap *S, ActionsMap *A)
+{
+	if (S == nullptr || A == nullptr) {
+		throw CoreException();
+	}
+
+	RawFileStream stream(filename);
+	const RawFileBinaryHeader &header = stream.get_header();
+
+	if (header.numStates != S->get_num_states() || header.numActions != A->get_num_actions()) {
+		throw CoreException();
+	}
+
+	std::vector<State *> states = order_policy_states(S);
+	std::vector<Action *> actions = order_policy_actions(A);
+
+	unsigned int n = header.numStates;
+	unsigned int m = header.numActions;
+	double gamma = header.discountFactor;
+
+	Horizon h(header.horizon);
+	h.set_discount_factor(gamma);
+
+	PolicyMap *policy = new PolicyMap(&h);
+
+	// The values of the previous iteration, the values being computed, and the best action of each state.
+	std::vector<double> Vprevious(n, 0.0);
+	std::vector<double> Vnext(n, 0.0);
+	std::vector<unsigned int> aBest(n, 0);
+
+	double convergenceCriterion = epsilon * (1.0 - gamma) / gamma;
+	double delta = convergenceCriterion + 1.0;
+
+	// Iterate over the horizon if it is finite, or until the maximum difference between two V[s]'s is
+	// less than the tolerance.
+	unsigned int t = 0;
+
+	while (h.is_finite() ? t < h.get_horizon() : delta > convergenceCriterion) {
+		delta = 0.0;
+
+		// Sweep over the blocks, while the next one is read.
+		stream.rewind();
+		for (const RawFileStreamBlock *block = stream.next(); block != nullptr; block = stream.next()) {
+			const uint64_t *rows = stream.get_rows(block);
+			const RawFileStreamEntry *entries = stream.get_entries(block);
+
+			for (unsigned int i = 0; i < block->numStates; i++) {
+				unsigned int s = block->firstState + i;
+				double maxQsa = std::numeric_limits<double>::lowest();
+
+				for (unsigned int a = 0; a < m; a++) {
+					double Qsa = 0.0;
+					const uint64_t *row = rows + (uint64_t)i * m + a;
+					for (uint64_t j = row[0]; j < row[1]; j++) {
+						Qsa += entries[j].probability * (entries[j].reward + gamma * Vprevious[entries[j].state]);
+					}
+
+					if (Qsa > maxQsa) {
+						maxQsa = Qsa;
+						aBest[s] = a;
+					}
+				}
+
+				Vnext[s] = maxQsa;
+				delta = std::max(delta, fabs(Vnext[s] - Vprevious[s]));
+			}
+		}
+
+		Vprevious.swap(Vnext);
+
+		// The policy of a finite horizon is set for each time step, counting down from the horizon.
+		if (h.is_finite()) {
+			for (unsigned int s = 0; s < n; s++) {
+				policy->set(h.get_horizon() - 1 - t, states[s], actions[aBest[s]]);
+			}
+		}
+
+		t++;
+	}
+
+	if (!h.is_finite()) {
+		for (unsigned int s = 0; s < n; s++) {
+			policy->set(states[s], actions[aBest[s]]);
+		}
+	}
+
+	V.clear();
+	for (unsigned int s = 0; s < n; s++) {
+		V[states[s]] = Vprevious[s];
+	}
+
+	return policy;
 }
 
 const std::unordered_map<State *, double> &MDPValueIteration::get_V() const
@@ -154,3 +296,65 @@ PolicyMap *MDPValueIteration::solve_infinite_horizon(StatesMap *S, ActionsMap *A
 
 	return policy;
 }
+
+PolicyMap *MDPValueIteration::solve_array(StatesMap *S, ActionsMap *A, StateTransitionsArray *T,
+		SASRewardsArray *R, Horizon *h)
+{
+	// The states in the order of the set, with their indexes into the arrays, and the indexes of the
+	// actions available in each.
+	std::vector<State *> states;
+	std::vector<unsigned int> stateIndexes;
+	std::vector<Action *> actions;
+	std::vector<std::vector<unsigned int> > available;
+
+	if (!index_mdp_arrays(S, A, T, R, states, stateIndexes, actions, available)) {
+		return nullptr;
+	}
+
+	// Create the policy based on the horizon.
+	PolicyMap *policy = new PolicyMap(h);
+
+	double gamma = h->get_discount_factor();
+	std::vector<double> Vs(T->get_num_states(), 0.0);
+	std::vector<unsigned int> aBest(states.size(), 0);
+
+	// Perform the Bellman update of every state in place, returning the maximum change in V(s).
+	auto sweep = [&]() {
+		double delta = 0.0;
+
+		for (unsigned int i = 0; i < states.size(); i++) {
+			unsigned int s = stateIndexes[i];
+			double Vprevious = Vs[s];
+
+			bellman_update(T, R, gamma, s, available[i], Vs, aBest[i]);
+
+			delta = std::max(delta, fabs(Vs[s] - Vprevious));
+		}
+
+		return delta;
+	};
+
+	if (h->is_finite()) {
+		for (int t = h->get_horizon() - 1; t >= 0; t--) {
+			sweep();
+
+			for (unsigned int i = 0; i < states.size(); i++) {
+				policy->set(t, states[i], actions[aBest[i]]);
+			}
+		}
+	} else {
+		double convergenceCriterion = epsilon * (1.0 - gamma) / gamma;
+		while (sweep() > convergenceCriterion) { }
+
+		for (unsigned int i = 0; i < states.size(); i++) {
+			policy->set(states[i], actions[aBest[i]]);
+		}
+	}
+
+	V.clear();
+	for (unsigned int i = 0; i < states.size(); i++) {
+		V[states[i]] = Vs[stateIndexes[i]];
+	}
+
+	return policy;
+}
@@ -56,3 +56,17 @@ ObservationTransitions *POMDP::get_observation_transitions()
 {
 	return observationTransitions;
 }
+
+void POMDP::freeze()
+{
+	MDP::freeze();
+
+	if (observationTransitions != nullptr) {
+		observationTransitions->freeze(observations, actions, states);
+	}
+}
+
+bool POMDP::is_frozen() const
+{
+	return MDP::is_frozen() && (observationTransitions == nullptr || observationTransitions->is_frozen());
+}
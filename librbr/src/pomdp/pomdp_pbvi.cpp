@@ -25,8 +25,11 @@
 #include "../../include/pomdp/pomdp_pbvi.h"
 #include "../../include/pomdp/pomdp_utilities.h"
 
+#include "../../include/management/fingerprint.h"
+
 #include "../../include/core/policy/policy_alpha_vectors.h"
 #include "../../include/core/policy/policy_alpha_vector.h"
+#include "../../include/core/policy/policy_binary.h"
 
 #include "../../include/core/core_exception.h"
 #include "../../include/core/states/state_exception.h"
@@ -41,12 +44,14 @@
 #include <math.h>
 #include <random>
 #include <algorithm>
+#include <cstdio>
 
 POMDPPBVI::POMDPPBVI()
 {
 	set_expansion_rule(POMDPPBVIExpansionRule::RANDOM_BELIEF_SELECTION);
 	set_num_update_iterations(1);
 	set_num_expansion_iterations(1);
+	cache = nullptr;
 }
 
 POMDPPBVI::POMDPPBVI(POMDPPBVIExpansionRule expansionRule, unsigned int updateIterations, unsigned int expansionIterations)
@@ -54,6 +59,7 @@ POMDPPBVI::POMDPPBVI(POMDPPBVIExpansionRule expansionRule, unsigned int updateIt
 	set_expansion_rule(expansionRule);
 	set_num_update_iterations(updateIterations);
 	set_num_expansion_iterations(expansionIterations);
+	cache = nullptr;
 }
 
 POMDPPBVI::~POMDPPBVI()
@@ -190,13 +196,53 @@ PolicyAlphaVectors *POMDPPBVI::solve(POMDP *pomdp)
 		throw RewardException();
 	}
 
+	// Consult the policy cache before solving. The key includes the initial belief states, hashed over
+	// the states in index order, since they are the starting point of the expansions.
+	uint64_t modelFingerprint = 0;
+	std::string key;
+
+	if (cache != nullptr) {
+		std::vector<State *> states = order_policy_states(S);
+
+		uint64_t beliefs = FINGERPRINT_OFFSET_BASIS;
+		for (BeliefState *b : initialB) {
+			for (State *s : states) {
+				double probability = b->get(s);
+				fingerprint_bytes(beliefs, &probability, sizeof(double));
+			}
+		}
+
+		char text[128];
+		std::snprintf(text, sizeof(text), "POMDPPBVI rule=%d updates=%u expansions=%u beliefs=%u:%016llx",
+				(int)rule, updates, expansions, (unsigned int)initialB.size(), (unsigned long long)beliefs);
+		key = text;
+
+		modelFingerprint = fingerprint_model(pomdp);
+		PolicyAlphaVectors *policy = cache->load_policy_alpha_vectors(pomdp, modelFingerprint, key);
+		if (policy != nullptr) {
+			return policy;
+		}
+	}
+
 	// Obtain the horizon and return the correct value iteration.
+	PolicyAlphaVectors *policy = nullptr;
 	Horizon *h = pomdp->get_horizon();
 	if (h->is_finite()) {
-		return solve_finite_horizon(S, A, Z, T, O, R, h);
+		policy = solve_finite_horizon(S, A, Z, T, O, R, h);
 	} else {
-		return solve_infinite_horizon(S, A, Z, T, O, R, h);
+		policy = solve_infinite_horizon(S, A, Z, T, O, R, h);
+	}
+
+	if (cache != nullptr) {
+		cache->save_policy_alpha_vectors(pomdp, modelFingerprint, key, policy);
 	}
+
+	return policy;
+}
+
+void POMDPPBVI::set_policy_cache(PolicyCache *policyCache)
+{
+	cache = policyCache;
 }
 
 void POMDPPBVI::reset() {
@@ -30,7 +30,107 @@
 #include "../../include/core/rewards/saso_rewards.h"
 #include "../../include/core/rewards/reward_exception.h"
 
+#include "../../include/core/states/indexed_state.h"
+#include "../../include/core/actions/indexed_action.h"
+#include "../../include/core/observations/indexed_observation.h"
+
+#include "../../include/core/state_transitions/state_transitions_array.h"
 #include "../../include/core/state_transitions/state_transition_exception.h"
+#include "../../include/core/observation_transitions/observation_transitions_array.h"
+
+#include "../../include/core/policy/policy_binary.h"
+
+#include "../../include/utilities/table_index.h"
+
+/**
+ * Check if the state and observation transitions are arrays over indexed states, observations, and
+ * actions, so that the Bellman updates below may work entirely by index.
+ * @param	S			The set of finite states.
+ * @param	Z			The set of finite observations.
+ * @param	T			The finite state transition function.
+ * @param	O			The finite observation transition function.
+ * @param	action		The action taken at this time step.
+ * @param	Tarray		The state transitions array. This will be updated.
+ * @param	Oarray		The observation transitions array. This will be updated.
+ * @param	states		The states by index. This will be updated.
+ * @param	a			The index of the action. This will be updated.
+ * @return	Returns @code{true} if the model may be used by index; @code{false} otherwise.
+ */
+static bool index_pomdp_arrays(StatesMap *S, ObservationsMap *Z, StateTransitions *T, ObservationTransitions *O,
+		Action *action, StateTransitionsArray *&Tarray, ObservationTransitionsArray *&Oarray,
+		std::vector<State *> &states, unsigned int &a)
+{
+	Tarray = dynamic_cast<StateTransitionsArray *>(T);
+	Oarray = dynamic_cast<ObservationTransitionsArray *>(O);
+	IndexedAction *indexedAction = dynamic_cast<IndexedAction *>(action);
+	if (Tarray == nullptr || Oarray == nullptr || indexedAction == nullptr) {
+		return false;
+	}
+
+	unsigned int n = Tarray->get_num_states();
+	a = indexedAction->get_index();
+	if (S->get_num_states() != n || Oarray->get_num_states() != n || a >= Tarray->get_num_actions() ||
+			a >= Oarray->get_num_actions()) {
+		return false;
+	}
+
+	states = order_policy_states(S);
+	if (!TableIndex<IndexedState, State>(states).is_indexed()) {
+		return false;
+	}
+
+	for (auto z : *Z) {
+		IndexedObservation *observation = dynamic_cast<IndexedObservation *>(resolve(z));
+		if (observation == nullptr || observation->get_index() >= Oarray->get_num_observations()) {
+			return false;
+		}
+	}
+
+	return true;
+}
+
+/**
+ * Weigh the values of an alpha vector by the probability of an observation in each state, by index.
+ * @param	O			The observation transitions array.
+ * @param	states		The states by index.
+ * @param	a			The index of the action taken.
+ * @param	z			The index of the observation.
+ * @param	alpha		The alpha vector.
+ * @param	w			The weighted values, O(a, s', z) alpha(s') by the index of s'. This will be updated.
+ */
+static void weigh_alpha_vector(ObservationTransitionsArray *O, const std::vector<State *> &states,
+		unsigned int a, unsigned int z, PolicyAlphaVector *alpha, std::vector<double> &w)
+{
+	w.resize(states.size());
+	for (unsigned int sp = 0; sp < states.size(); sp++) {
+		float p = O->get_row(a, sp)[z];
+		w[sp] = (p > 0.0f ? p * alpha->get(states[sp]) : 0.0);
+	}
+}
+
+/**
+ * Compute the discounted expected value of the weighted values after taking an action in a state, by index.
+ * @param	T			The state transitions array.
+ * @param	s			The index of the state.
+ * @param	a			The index of the action taken.
+ * @param	w			The weighted values, O(a, s', z) alpha(s') by the index of s'.
+ * @param	gamma		The discount factor.
+ * @return	The value gamma sum_{s'} T(s, a, s') w(s').
+ */
+static double backup_alpha_vector(StateTransitionsArray *T, unsigned int s, unsigned int a,
+		const std::vector<double> &w, double gamma)
+{
+	const float *Tsa = T->get_row(s, a);
+
+	double value = 0.0;
+	for (unsigned int sp = 0; sp < w.size(); sp++) {
+		if (Tsa[sp] > 0.0f) {
+			value += Tsa[sp] * w[sp];
+		}
+	}
+
+	return gamma * value;
+}
 
 PolicyAlphaVector *create_gamma_a_star(StatesMap *S,
 		ObservationsMap *Z, StateTransitions *T, ObservationTransitions *O,
@@ -140,6 +240,14 @@ std::vector<PolicyAlphaVector *> bellman_update_cross_sum(StatesMap *S, Observat
 		gammaA.push_back(new PolicyAlphaVector(*alphaVector));
 	}
 
+	// Models stored as arrays are backed up by index, over the rows of the arrays.
+	StateTransitionsArray *Tarray = nullptr;
+	ObservationTransitionsArray *Oarray = nullptr;
+	std::vector<State *> states;
+	unsigned int a = 0;
+	bool indexed = index_pomdp_arrays(S, Z, T, O, action, Tarray, Oarray, states, a);
+	std::vector<double> w;
+
 	// Iteratively compute and apply the cross-sum of the gamma.
 	for (auto z : *Z) {
 		Observation *observation = resolve(z);
@@ -152,17 +260,27 @@ std::vector<PolicyAlphaVector *> bellman_update_cross_sum(StatesMap *S, Observat
 			// Note: It doesn't matter if we set the action here, since cross_sum will create new alpha vectors anyway.
 			PolicyAlphaVector *newAlpha = new PolicyAlphaVector();
 
+			if (indexed) {
+				weigh_alpha_vector(Oarray, states, a, dynamic_cast<IndexedObservation *>(observation)->get_index(),
+						alphaGamma, w);
+			}
+
 			// For each of the columns in the alpha vector.
 			for (auto s : *S) {
 				State *state = resolve(s);
 
 				// Compute the value of an element of the alpha vector.
 				double value = 0.0;
-				for (auto sp : *S) {
-					State *nextState = resolve(sp);
-					value += T->get(state, action, nextState) * O->get(action, nextState, observation) * alphaGamma->get(nextState);
+				if (indexed) {
+					value = backup_alpha_vector(Tarray, dynamic_cast<IndexedState *>(state)->get_index(), a, w,
+							h->get_discount_factor());
+				} else {
+					for (auto sp : *S) {
+						State *nextState = resolve(sp);
+						value += T->get(state, action, nextState) * O->get(action, nextState, observation) * alphaGamma->get(nextState);
+					}
+					value *= h->get_discount_factor();
 				}
-				value *= h->get_discount_factor();
 
 				newAlpha->set(state, value);
 			}
@@ -207,6 +325,35 @@ PolicyAlphaVector *bellman_update_belief_state(StatesMap *S, ObservationsMap *Z,
 	PolicyAlphaVector *alphaBAStar = new PolicyAlphaVector(*gammaAStar[0]);
 	alphaBAStar->set_action(action);
 
+	// Models stored as arrays are backed up by index, over the rows of the arrays.
+	StateTransitionsArray *Tarray = nullptr;
+	ObservationTransitionsArray *Oarray = nullptr;
+	std::vector<State *> states;
+	unsigned int a = 0;
+	bool indexed = index_pomdp_arrays(S, Z, T, O, action, Tarray, Oarray, states, a);
+	std::vector<double> w;
+
+	// Compute the value of an element of the alpha vector for a state, observation, and alpha vector in Gamma^{t-1}.
+	auto compute_value = [&](State *state, Observation *observation, PolicyAlphaVector *alphaGamma) {
+		if (indexed) {
+			return backup_alpha_vector(Tarray, dynamic_cast<IndexedState *>(state)->get_index(), a, w,
+					h->get_discount_factor());
+		}
+
+		double value = 0.0;
+		try {
+			for (State *nextState : T->successors(S, state, action)) {
+				value += T->get(state, action, nextState) * O->get(action, nextState, observation) * alphaGamma->get(nextState);
+			}
+		} catch (StateTransitionException &err) {
+			for (auto sp : *S) {
+				State *nextState = resolve(sp);
+				value += T->get(state, action, nextState) * O->get(action, nextState, observation) * alphaGamma->get(nextState);
+			}
+		}
+		return value * h->get_discount_factor();
+	};
+
 	// Add to its value for each state following a summation, instead of the cross-sum. This operation iterates over the
 	// possible observations and selects the optimal policy for that subtree given the current set of alpha vectors in gamma.
 	for (auto z : *Z) {
@@ -221,24 +368,15 @@ PolicyAlphaVector *bellman_update_belief_state(StatesMap *S, ObservationsMap *Z,
 			// Note: It doesn't matter if we set the action here, since cross_sum will create new alpha vectors anyway.
 			PolicyAlphaVector *newAlpha = new PolicyAlphaVector();
 
+			if (indexed) {
+				weigh_alpha_vector(Oarray, states, a, dynamic_cast<IndexedObservation *>(observation)->get_index(),
+						alphaGamma, w);
+			}
+
 			// For each of the columns in the alpha vector. Note: This is only used in computing the dot
 			// product of "dot(alphaGamma, b)" so we skip over some states for now.
 			for (State *state : b->get_states()) {
-				// Compute the value of an element of the alpha vector.
-				double value = 0.0;
-				try {
-					for (State *nextState : T->successors(S, state, action)) {
-						value += T->get(state, action, nextState) * O->get(action, nextState, observation) * alphaGamma->get(nextState);
-					}
-				} catch (StateTransitionException &err) {
-					for (auto sp : *S) {
-						State *nextState = resolve(sp);
-						value += T->get(state, action, nextState) * O->get(action, nextState, observation) * alphaGamma->get(nextState);
-					}
-				}
-				value *= h->get_discount_factor();
-
-				newAlpha->set(state, value);
+				newAlpha->set(state, compute_value(state, observation, alphaGamma));
 			}
 
 			// Compute the value at the belief state for this alpha vector.
@@ -253,22 +391,7 @@ PolicyAlphaVector *bellman_update_belief_state(StatesMap *S, ObservationsMap *Z,
 				// Now you actually have to compute all the states' values, since we found a new max.
 				for (auto s : *S) {
 					State *state = resolve(s);
-
-					// Compute the value of an element of the alpha vector.
-					double value = 0.0;
-					try {
-						for (State *nextState : T->successors(S, state, action)) {
-							value += T->get(state, action, nextState) * O->get(action, nextState, observation) * alphaGamma->get(nextState);
-						}
-					} catch (StateTransitionException &err) {
-						for (auto sp : *S) {
-							State *nextState = resolve(sp);
-							value += T->get(state, action, nextState) * O->get(action, nextState, observation) * alphaGamma->get(nextState);
-						}
-					}
-					value *= h->get_discount_factor();
-
-					newAlpha->set(state, value);
+					newAlpha->set(state, compute_value(state, observation, alphaGamma));
 				}
 
 				maxAlphaBAOmega = newAlpha;
@@ -25,6 +25,8 @@
 #include "../../include/pomdp/pomdp_value_iteration.h"
 #include "../../include/pomdp/pomdp_utilities.h"
 
+#include "../../include/management/fingerprint.h"
+
 #include "../../include/core/policy/policy_alpha_vectors.h"
 #include "../../include/core/policy/policy_alpha_vector.h"
 
@@ -39,15 +41,18 @@
 
 #include <vector>
 #include <math.h>
+#include <cstdio>
 
 POMDPValueIteration::POMDPValueIteration()
 {
 	set_num_iterations(1);
+	cache = nullptr;
 }
 
 POMDPValueIteration::POMDPValueIteration(unsigned int numIterations)
 {
 	set_num_iterations(numIterations);
+	cache = nullptr;
 }
 
 POMDPValueIteration::~POMDPValueIteration()
@@ -116,16 +121,14 @@ PolicyAlphaVectors *POMDPValueIteration::solve(POMDP *pomdp)
 		throw ObservationException();
 	}
 
-	// Attempt to convert the state transitions object into FiniteStateTransitions.
-	StateTransitionsMap *T =
-			dynamic_cast<StateTransitionsMap *>(pomdp->get_state_transitions());
+	// The state transitions may be any finite state transitions, e.g., maps or arrays.
+	StateTransitions *T = pomdp->get_state_transitions();
 	if (T == nullptr) {
 		throw StateTransitionException();
 	}
 
-	// Attempt to convert the observation transitions object into FiniteObservationTransitions.
-	ObservationTransitionsMap *O =
-			dynamic_cast<ObservationTransitionsMap *>(pomdp->get_observation_transitions());
+	// The observation transitions may be any finite observation transitions, e.g., maps or arrays.
+	ObservationTransitions *O = pomdp->get_observation_transitions();
 	if (O == nullptr) {
 		throw ObservationTransitionException();
 	}
@@ -136,17 +139,42 @@ PolicyAlphaVectors *POMDPValueIteration::solve(POMDP *pomdp)
 		throw RewardException();
 	}
 
+	// Consult the policy cache before solving. The number of iterations only matters for infinite horizons.
+	uint64_t modelFingerprint = 0;
+	char key[64];
+	std::snprintf(key, sizeof(key), "POMDPValueIteration iterations=%u", iterations);
+
+	if (cache != nullptr) {
+		modelFingerprint = fingerprint_model(pomdp);
+		PolicyAlphaVectors *policy = cache->load_policy_alpha_vectors(pomdp, modelFingerprint, key);
+		if (policy != nullptr) {
+			return policy;
+		}
+	}
+
 	// Obtain the horizon and return the correct value iteration.
+	PolicyAlphaVectors *policy = nullptr;
 	Horizon *h = pomdp->get_horizon();
 	if (h->is_finite()) {
-		return solve_finite_horizon(S, A, Z, T, O, R, h);
+		policy = solve_finite_horizon(S, A, Z, T, O, R, h);
 	} else {
-		return solve_infinite_horizon(S, A, Z, T, O, R, h);
+		policy = solve_infinite_horizon(S, A, Z, T, O, R, h);
+	}
+
+	if (cache != nullptr) {
+		cache->save_policy_alpha_vectors(pomdp, modelFingerprint, key, policy);
 	}
+
+	return policy;
+}
+
+void POMDPValueIteration::set_policy_cache(PolicyCache *policyCache)
+{
+	cache = policyCache;
 }
 
 PolicyAlphaVectors *POMDPValueIteration::solve_finite_horizon(StatesMap *S, ActionsMap *A, ObservationsMap *Z,
-		StateTransitionsMap *T, ObservationTransitionsMap *O, Rewards *R,
+		StateTransitions *T, ObservationTransitions *O, Rewards *R,
 		Horizon *h)
 {
 	// Create the policy of alpha vectors variable. Set the horizon, to make the object's policy differ over time.
@@ -200,7 +228,7 @@ PolicyAlphaVectors *POMDPValueIteration::solve_finite_horizon(StatesMap *S, Acti
 }
 
 PolicyAlphaVectors *POMDPValueIteration::solve_infinite_horizon(StatesMap *S, ActionsMap *A, ObservationsMap *Z,
-		StateTransitionsMap *T, ObservationTransitionsMap *O, Rewards *R,
+		StateTransitions *T, ObservationTransitions *O, Rewards *R,
 		Horizon *h)
 {
 	// Create the policy of alpha vectors variable. Set the horizon, to make the object's policy differ over time.
@@ -25,103 +25,105 @@
 //#include "../../include/utilities/a_star.h"
 #include "../../include/utilities/utility_exception.h"
 
-#include <iostream>
-#include <set>
 #include <algorithm>
-#include <map>
 
-template <typename T>
-AStar<T>::AStar(double (*heuristic)(T node, T goal), double (*cost)(T n1, T n2), std::vector<T> (*successors)(T node))
+template <typename T, typename Hash>
+AStar<T, Hash>::AStar(std::function<double(T node, T goal)> heuristic, std::function<double(T n1, T n2)> cost,
+		std::function<std::vector<T>(T node)> successors)
 {
 	this->heuristic = heuristic;
 	this->cost = cost;
 	this->successors = successors;
+	pathCost = 0.0;
 	numNodesExpanded = 0;
 }
 
-template <typename T>
-AStar<T>::~AStar()
+template <typename T, typename Hash>
+AStar<T, Hash>::~AStar()
 { }
 
-template <typename T>
-void AStar<T>::solve(T start, T goal)
+template <typename T, typename Hash>
+void AStar<T, Hash>::solve(T start, T goal)
 {
-	// The closed set and open priority queue (vector w/ heap functions) used in A*.
-	std::set<T> closed;
-	std::vector<T> open;
-	open.push_back(start);
-
-	// The actual cost traversed.
-	std::map<T, double> g;
-	g[start] = 0.0;
-
-	// The expected value to reach the goal.
-	std::map<T, double> f;
-	f[start] = g[start] + heuristic(start, goal);
-
-	// Recall all parents of nodes.
-	std::map<T, T> trace;
+	records.clear();
+	indices.clear();
+	open.clear();
+	path.clear();
+	pathCost = 0.0;
 
 	// We will keep track of how many nodes were expanded.
 	numNodesExpanded = 0;
 
-	// Create a lambda comparison function for two nodes, using their f values.
-	auto node_compare = [&f] (T n1, T n2) { return f[n1] < f[n2]; };
-
-	// While there are nodes in the open set, we must explore them.
-	while (open.size() > 0) {
-		// Get the node with the highest cost in the open priority queue.
-		T current = open.back();
-
-		// Check if we are at the goal state, and return if we are.
-		if (current == goal) {
-			reconstruct_path(start, goal, trace);
+	// Create the start node's record, which is its own parent, and place it on the open list.
+	AStarRecord startRecord;
+	startRecord.node = start;
+	startRecord.g = 0.0;
+	startRecord.h = heuristic(start, goal);
+	startRecord.parent = 0;
+	startRecord.closed = false;
+
+	records.push_back(startRecord);
+	indices[start] = 0;
+	open.push(0, startRecord.h, 0.0);
+
+	// While there are nodes in the open list, we must explore them.
+	while (!open.empty()) {
+		// Get the node with the lowest f value in the open list.
+		unsigned int current = open.pop();
+
+		// Check if we are at the goal node, and return if we are.
+		if (records[current].node == goal) {
+			reconstruct_path(current);
 			return;
 		}
 
-		// Now the current node is expanded.
-		closed.insert(current);
-
-//		std::pop_heap(open.begin(), open.end());
-		open.pop_back();
-
+		// Now the current node is expanded. Copy what we need, since generating records may
+		// reallocate them.
+		records[current].closed = true;
 		numNodesExpanded++;
 
+		T currentNode = records[current].node;
+		double gCurrent = records[current].g;
+
 		// Iterate over the successors (i.e., neighbors) of this node.
-		for (T successor : successors(current)) {
-			bool update = false;
-			bool add = false;
-
-			// First, compute the g value for the successor.
-			double gSuccessor = g[current] + cost(current, successor);
-
-			// If successor is has not been explored, then add it to the open list.
-			if (std::find(closed.begin(), closed.end(), successor) == closed.end() &&
-					std::find(open.begin(), open.end(), successor) == open.end()) {
-				update = true;
-				add = true;
-			} else {
-				// Check if this has no g (or f) value yet, or if it needs an update. This
-				// has a separate find result variable to avoid two searches through g.
-				typename std::map<T, double>::const_iterator gSuccessorResult = g.find(successor);
-				if (gSuccessorResult == g.end() || gSuccessor < gSuccessorResult->second) {
-					update = true;
-				}
+		for (const T &successor : successors(currentNode)) {
+			double gSuccessor = gCurrent + cost(currentNode, successor);
+
+			typename std::unordered_map<T, unsigned int, Hash>::iterator result = indices.find(successor);
+
+			// If the successor is new, then create its record and add it to the open list.
+			if (result == indices.end()) {
+				AStarRecord record;
+				record.node = successor;
+				record.g = gSuccessor;
+				record.h = heuristic(successor, goal);
+				record.parent = current;
+				record.closed = false;
+
+				unsigned int index = records.size();
+				records.push_back(record);
+				indices[successor] = index;
+				open.push(index, record.g + record.h, -record.g);
+				continue;
 			}
 
-			// As we have determined, if successor is new or the g value of next is old, then store
-			// it and all other important data about it.
-			if (update) {
-				trace[successor] = current;
-				g[successor] = gSuccessor;
-				f[successor] = gSuccessor + heuristic(successor, goal);
+			// Otherwise, only a cheaper path changes anything. Decrease its key if it is on the open
+			// list, or reopen it if it was already expanded.
+			unsigned int index = result->second;
+			AStarRecord &record = records[index];
+
+			if (gSuccessor >= record.g) {
+				continue;
 			}
 
-			// If needed, add the node. This must be called after we have defined the f and g
-			// functions for successor due to the node compare function.
-			if (add) {
-				open.push_back(successor);
-				std::push_heap(open.begin(), open.end(), node_compare);
+			record.g = gSuccessor;
+			record.parent = current;
+
+			if (record.closed) {
+				record.closed = false;
+				open.push(index, record.g + record.h, -record.g);
+			} else {
+				open.update(index, record.g + record.h, -record.g);
 			}
 		}
 	}
@@ -130,38 +132,49 @@ void AStar<T>::solve(T start, T goal)
 	throw UtilityException();
 }
 
-template <typename T>
-const std::vector<T> &AStar<T>::get_path()
+template <typename T, typename Hash>
+const std::vector<T> &AStar<T, Hash>::get_path()
 {
 	return path;
 }
 
-template <typename T>
-int AStar<T>::get_num_nodes_expanded()
+template <typename T, typename Hash>
+double AStar<T, Hash>::get_path_cost()
+{
+	return pathCost;
+}
+
+template <typename T, typename Hash>
+int AStar<T, Hash>::get_num_nodes_expanded()
 {
 	return numNodesExpanded;
 }
 
-template <typename T>
-void AStar<T>::reconstruct_path(T start, T goal, std::map<T, T> &trace)
+template <typename T, typename Hash>
+int AStar<T, Hash>::get_num_nodes_generated()
+{
+	return records.size();
+}
+
+template <typename T, typename Hash>
+void AStar<T, Hash>::reconstruct_path(unsigned int goal)
 {
 	// This variable will hold the actual path traversed.
 	path.clear();
-	path.push_back(goal);
-
-	// Continue to iterate over the nodes until the start node is reached.
-	T current = goal;
-	while (current != start) {
-		// Attempt to find the parent, throwing an exception if it cannot do so.
-		typename std::map<T, T>::const_iterator result = trace.find(current);
-		if (result == trace.end()) {
+	pathCost = records[goal].g;
+
+	// Continue to follow the parents until the start node (its own parent) is reached. A path can
+	// never be longer than the number of records, so anything longer means the trace is corrupt.
+	unsigned int current = goal;
+	path.push_back(records[current].node);
+
+	while (current != 0) {
+		current = records[current].parent;
+		path.push_back(records[current].node);
+
+		if (path.size() > records.size()) {
 			throw UtilityException();
 		}
-
-		// Set the current node equal to the value found and push back the
-		// current node on the path.
-		current = result->second;
-		path.push_back(current);
 	}
 
 	// Since we used the "push_back" method for speed, at the end, reverse the order.
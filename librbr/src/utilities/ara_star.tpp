@@ -0,0 +1,349 @@
+/**
+ *  The MIT License (MIT)
+ *
+ *  Copyright (c) 2014 Kyle Hollins Wray, University of Massachusetts
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy of
+ *  this software and associated documentation files (the "Software"), to deal in
+ *  the Software without restriction, including without limitation the rights to
+ *  use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ *  the Software, and to permit persons to whom the Software is furnished to do so,
+ *  subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included in all
+ *  copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ *  FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ *  COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ *  IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ *  CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+
+//#include "../../include/utilities/ara_star.h"
+#include "../../include/utilities/utility_exception.h"
+
+#include <algorithm>
+#include <limits>
+
+template <typename T, typename Hash>
+ARAStar<T, Hash>::ARAStar(std::function<double(T node, T goal)> heuristic, std::function<double(T n1, T n2)> cost,
+		std::function<std::vector<T>(T node)> successors)
+{
+	this->heuristic = heuristic;
+	this->cost = cost;
+	this->successors = successors;
+
+	initialWeight = 3.0;
+	weightDecrement = 0.5;
+	weight = initialWeight;
+	deadline = 0.0;
+	nodeBudget = 0;
+
+	iteration = 0;
+	pathCost = std::numeric_limits<double>::infinity();
+	bound = std::numeric_limits<double>::infinity();
+	numNodesExpanded = 0;
+}
+
+template <typename T, typename Hash>
+ARAStar<T, Hash>::~ARAStar()
+{ }
+
+template <typename T, typename Hash>
+void ARAStar<T, Hash>::set_weights(double initialWeight, double weightDecrement)
+{
+	if (initialWeight < 1.0 || weightDecrement <= 0.0) {
+		throw UtilityException();
+	}
+
+	this->initialWeight = initialWeight;
+	this->weightDecrement = weightDecrement;
+}
+
+template <typename T, typename Hash>
+void ARAStar<T, Hash>::set_deadline(double seconds)
+{
+	deadline = std::max(0.0, seconds);
+}
+
+template <typename T, typename Hash>
+void ARAStar<T, Hash>::set_node_budget(unsigned int budget)
+{
+	nodeBudget = budget;
+}
+
+template <typename T, typename Hash>
+void ARAStar<T, Hash>::set_path_callback(std::function<void(const std::vector<T> &path, double cost, double bound)> callback)
+{
+	pathCallback = callback;
+}
+
+template <typename T, typename Hash>
+void ARAStar<T, Hash>::solve(T start, T goal)
+{
+	startTime = std::chrono::steady_clock::now();
+
+	records.clear();
+	indices.clear();
+	open.clear();
+	incons.clear();
+	path.clear();
+
+	pathCost = std::numeric_limits<double>::infinity();
+	bound = std::numeric_limits<double>::infinity();
+	numNodesExpanded = 0;
+	iteration = 0;
+	weight = initialWeight;
+
+	// Create the start node's record, which is its own parent, and place it on the open list.
+	ARAStarRecord startRecord;
+	startRecord.node = start;
+	startRecord.g = 0.0;
+	startRecord.h = heuristic(start, goal);
+	startRecord.parent = 0;
+	startRecord.closed = -1;
+	startRecord.inconsistent = false;
+
+	records.push_back(startRecord);
+	indices[start] = 0;
+	open.push(0, weight * startRecord.h, 0.0);
+
+	while (true) {
+		bool stopped = improve_path(goal);
+
+		// Publish the goal's path if it has been reached, even if the iteration was cut short; g
+		// values only decrease, so its cost is at most the goal's g value.
+		typename std::unordered_map<T, unsigned int, Hash>::iterator result = indices.find(goal);
+		if (result != indices.end()) {
+			publish_path(result->second, stopped);
+		}
+
+		if (stopped) {
+			break;
+		}
+
+		iteration++;
+
+		// The path is optimal once the weight is 1, or if nothing remains that could improve it.
+		if (weight <= 1.0 || bound <= 1.0) {
+			break;
+		}
+
+		// Decrease the weight, move the inconsistent nodes onto the open list, and reorder it. All
+		// nodes are reopened (closed is the iteration number), without touching their records.
+		weight = std::max(1.0, weight - weightDecrement);
+
+		std::vector<unsigned int> reopened = incons;
+		for (unsigned int index : incons) {
+			records[index].inconsistent = false;
+		}
+		incons.clear();
+
+		for (unsigned int i = 0; i < open.size(); i++) {
+			reopened.push_back(open.get(i));
+		}
+
+		open.clear();
+		for (unsigned int index : reopened) {
+			open.push(index, records[index].g + weight * records[index].h, -records[index].g);
+		}
+	}
+
+	if (path.empty()) {
+		throw UtilityException();
+	}
+}
+
+template <typename T, typename Hash>
+const std::vector<T> &ARAStar<T, Hash>::get_path()
+{
+	return path;
+}
+
+template <typename T, typename Hash>
+double ARAStar<T, Hash>::get_path_cost()
+{
+	return pathCost;
+}
+
+template <typename T, typename Hash>
+double ARAStar<T, Hash>::get_suboptimality_bound()
+{
+	return bound;
+}
+
+template <typename T, typename Hash>
+int ARAStar<T, Hash>::get_num_nodes_expanded()
+{
+	return numNodesExpanded;
+}
+
+template <typename T, typename Hash>
+int ARAStar<T, Hash>::get_num_iterations()
+{
+	return iteration;
+}
+
+template <typename T, typename Hash>
+bool ARAStar<T, Hash>::improve_path(const T &goal)
+{
+	while (!open.empty()) {
+		// Stop once no node on the open list can improve the goal's path with the current weight.
+		typename std::unordered_map<T, unsigned int, Hash>::iterator result = indices.find(goal);
+		if (result != indices.end() && records[result->second].g <= open.top_priority()) {
+			return false;
+		}
+
+		if (out_of_resources()) {
+			return true;
+		}
+
+		unsigned int current = open.pop();
+		records[current].closed = iteration;
+		numNodesExpanded++;
+
+		// Copy what we need, since generating records may reallocate them.
+		T currentNode = records[current].node;
+		double gCurrent = records[current].g;
+
+		for (const T &successor : successors(currentNode)) {
+			double gSuccessor = gCurrent + cost(currentNode, successor);
+
+			typename std::unordered_map<T, unsigned int, Hash>::iterator result = indices.find(successor);
+
+			// If the successor is new, then create its record and add it to the open list.
+			if (result == indices.end()) {
+				ARAStarRecord record;
+				record.node = successor;
+				record.g = gSuccessor;
+				record.h = heuristic(successor, goal);
+				record.parent = current;
+				record.closed = -1;
+				record.inconsistent = false;
+
+				unsigned int index = records.size();
+				records.push_back(record);
+				indices[successor] = index;
+				open.push(index, record.g + weight * record.h, -record.g);
+				continue;
+			}
+
+			unsigned int index = result->second;
+			ARAStarRecord &record = records[index];
+
+			if (gSuccessor >= record.g) {
+				continue;
+			}
+
+			record.g = gSuccessor;
+			record.parent = current;
+
+			// Nodes expanded in this iteration are not reopened; they wait for the next one.
+			if (record.closed == iteration) {
+				if (!record.inconsistent) {
+					record.inconsistent = true;
+					incons.push_back(index);
+				}
+			} else if (open.contains(index)) {
+				open.update(index, record.g + weight * record.h, -record.g);
+			} else {
+				open.push(index, record.g + weight * record.h, -record.g);
+			}
+		}
+	}
+
+	return false;
+}
+
+template <typename T, typename Hash>
+bool ARAStar<T, Hash>::out_of_resources()
+{
+	if (nodeBudget > 0 && numNodesExpanded >= nodeBudget) {
+		return true;
+	}
+
+	if (deadline > 0.0 && std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count() >= deadline) {
+		return true;
+	}
+
+	return false;
+}
+
+template <typename T, typename Hash>
+double ARAStar<T, Hash>::compute_lower_bound()
+{
+	// Any cheaper path must pass through an open or inconsistent node, so the smallest g + h among
+	// them is a lower bound on the optimal cost.
+	double lowerBound = std::numeric_limits<double>::infinity();
+
+	for (unsigned int i = 0; i < open.size(); i++) {
+		unsigned int index = open.get(i);
+		lowerBound = std::min(lowerBound, records[index].g + records[index].h);
+	}
+
+	for (unsigned int index : incons) {
+		lowerBound = std::min(lowerBound, records[index].g + records[index].h);
+	}
+
+	return lowerBound;
+}
+
+template <typename T, typename Hash>
+void ARAStar<T, Hash>::publish_path(unsigned int goalIndex, bool stopped)
+{
+	// Follow the parents until the start node (its own parent) is reached. A path can never be
+	// longer than the number of records, so anything longer means the trace is corrupt.
+	std::vector<T> newPath;
+	unsigned int current = goalIndex;
+	newPath.push_back(records[current].node);
+
+	while (current != 0) {
+		current = records[current].parent;
+		newPath.push_back(records[current].node);
+
+		if (newPath.size() > records.size()) {
+			throw UtilityException();
+		}
+	}
+
+	std::reverse(newPath.begin(), newPath.end());
+
+	// Compute the actual cost of the path; since g values only decrease, it is at most the goal's g value.
+	double newCost = 0.0;
+	for (unsigned int i = 1; i < newPath.size(); i++) {
+		newCost += cost(newPath[i - 1], newPath[i]);
+	}
+
+	bool improved = (newCost < pathCost);
+	if (improved) {
+		path = newPath;
+		pathCost = newCost;
+	}
+
+	// The optimal cost is at least the lower bound from the open and inconsistent nodes, and at most
+	// the best path's cost. A completed iteration also guarantees the goal's g value is within the
+	// weight of the optimal.
+	double lowerBound = std::min(pathCost, compute_lower_bound());
+	double newBound = std::numeric_limits<double>::infinity();
+	if (pathCost <= 0.0 || lowerBound >= pathCost) {
+		newBound = 1.0;
+	} else if (lowerBound > 0.0) {
+		newBound = pathCost / lowerBound;
+	}
+	if (!stopped) {
+		newBound = std::min(newBound, weight);
+	}
+
+	if (newBound < bound) {
+		bound = newBound;
+	} else if (!improved) {
+		return;
+	}
+
+	if (pathCallback) {
+		pathCallback(path, pathCost, bound);
+	}
+}
@@ -0,0 +1,360 @@
+/**
+ *  The MIT License (MIT)
+ *
+ *  Copyright (c) 2014 Kyle Hollins Wray, University of Massachusetts
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy of
+ *  this software and associated documentation files (the "Software"), to deal in
+ *  the Software without restriction, including without limitation the rights to
+ *  use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ *  the Software, and to permit persons to whom the Software is furnished to do so,
+ *  subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included in all
+ *  copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ *  FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ *  COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ *  IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ *  CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+
+//#include "../../include/utilities/hda_star.h"
+#include "../../include/utilities/utility_exception.h"
+
+#include <algorithm>
+#include <limits>
+#include <thread>
+
+template <typename T, typename Hash>
+HDAStar<T, Hash>::HDAStar(std::function<double(T node, T goal)> heuristic, std::function<double(T n1, T n2)> cost,
+		std::function<std::vector<T>(T node)> successors)
+{
+	this->heuristic = heuristic;
+	this->cost = cost;
+	this->successors = successors;
+
+	numThreads = std::max(1u, std::thread::hardware_concurrency());
+
+	goalThread = 0;
+	goalIndex = 0;
+	pathCost = std::numeric_limits<double>::infinity();
+	numNodesExpanded = 0;
+	numNodesGenerated = 0;
+}
+
+template <typename T, typename Hash>
+HDAStar<T, Hash>::HDAStar(std::function<double(T node, T goal)> heuristic, std::function<double(T n1, T n2)> cost,
+		std::function<std::vector<T>(T node)> successors, unsigned int numThreads)
+{
+	this->heuristic = heuristic;
+	this->cost = cost;
+	this->successors = successors;
+
+	set_num_threads(numThreads);
+
+	goalThread = 0;
+	goalIndex = 0;
+	pathCost = std::numeric_limits<double>::infinity();
+	numNodesExpanded = 0;
+	numNodesGenerated = 0;
+}
+
+template <typename T, typename Hash>
+HDAStar<T, Hash>::~HDAStar()
+{ }
+
+template <typename T, typename Hash>
+void HDAStar<T, Hash>::set_num_threads(unsigned int numThreads)
+{
+	if (numThreads == 0) {
+		throw UtilityException();
+	}
+	this->numThreads = numThreads;
+}
+
+template <typename T, typename Hash>
+unsigned int HDAStar<T, Hash>::get_num_threads()
+{
+	return numThreads;
+}
+
+template <typename T, typename Hash>
+void HDAStar<T, Hash>::solve(T start, T goal)
+{
+	path.clear();
+	pathCost = std::numeric_limits<double>::infinity();
+	numNodesExpanded = 0;
+	numNodesGenerated = 0;
+
+	for (unsigned int i = 0; i < numThreads; i++) {
+		HDAStarWorker *worker = new HDAStarWorker();
+		worker->outbox.resize(numThreads);
+		worker->numNodesExpanded = 0;
+		workers.push_back(worker);
+	}
+
+	// Every thread starts busy.
+	work.store(numThreads);
+	done.store(false);
+	incumbent.store(std::numeric_limits<double>::infinity());
+	goalThread = numThreads;
+	goalIndex = 0;
+
+	// Create the start node's record in the thread which owns it; it is its own parent.
+	HDAStarWorker *startWorker = workers[owner(start)];
+
+	HDAStarRecord startRecord;
+	startRecord.node = start;
+	startRecord.g = 0.0;
+	startRecord.h = heuristic(start, goal);
+	startRecord.parentThread = owner(start);
+	startRecord.parent = 0;
+	startRecord.closed = false;
+
+	startWorker->records.push_back(startRecord);
+	startWorker->indices[start] = 0;
+	startWorker->open.push(0, startRecord.h, 0.0);
+
+	std::vector<std::thread> threads;
+	for (unsigned int i = 1; i < numThreads; i++) {
+		threads.push_back(std::thread(&HDAStar<T, Hash>::run, this, i, goal));
+	}
+	run(0, goal);
+	for (std::thread &thread : threads) {
+		thread.join();
+	}
+
+	for (HDAStarWorker *worker : workers) {
+		numNodesExpanded += worker->numNodesExpanded;
+		numNodesGenerated += worker->records.size();
+	}
+
+	bool found = (goalThread < numThreads);
+	if (found) {
+		pathCost = workers[goalThread]->records[goalIndex].g;
+		try {
+			reconstruct_path();
+		} catch (const UtilityException &err) {
+			found = false;
+		}
+	}
+
+	for (HDAStarWorker *worker : workers) {
+		delete worker;
+	}
+	workers.clear();
+
+	if (!found) {
+		throw UtilityException();
+	}
+}
+
+template <typename T, typename Hash>
+const std::vector<T> &HDAStar<T, Hash>::get_path()
+{
+	return path;
+}
+
+template <typename T, typename Hash>
+double HDAStar<T, Hash>::get_path_cost()
+{
+	return pathCost;
+}
+
+template <typename T, typename Hash>
+int HDAStar<T, Hash>::get_num_nodes_expanded()
+{
+	return numNodesExpanded;
+}
+
+template <typename T, typename Hash>
+int HDAStar<T, Hash>::get_num_nodes_generated()
+{
+	return numNodesGenerated;
+}
+
+template <typename T, typename Hash>
+unsigned int HDAStar<T, Hash>::owner(const T &node)
+{
+	// Mix the hash (Fibonacci hashing), since many hashes (e.g., of integers) are the identity.
+	unsigned long long value = (unsigned long long)Hash()(node) * 11400714819323198485ull;
+	return (unsigned int)((value >> 32) % numThreads);
+}
+
+template <typename T, typename Hash>
+void HDAStar<T, Hash>::run(unsigned int thread, T goal)
+{
+	HDAStarWorker *worker = workers[thread];
+	bool busy = true;
+
+	std::vector<HDAStarMessage> batch;
+
+	while (!done.load()) {
+		// Mark this thread busy before uncounting the received messages, so the work never drops
+		// to zero while there is still something to do.
+		while (worker->inbox.try_pop(batch)) {
+			if (!busy) {
+				work.fetch_add(1);
+				busy = true;
+			}
+
+			for (const HDAStarMessage &message : batch) {
+				receive(thread, message, goal);
+			}
+			work.fetch_sub(batch.size());
+		}
+
+		// Only nodes which may improve on the incumbent are worth expanding. The incumbent only
+		// decreases, so an idle thread stays idle until it receives a message.
+		if (!worker->open.empty() && worker->open.top_priority() < incumbent.load()) {
+			expand(thread, goal);
+
+			for (unsigned int i = 0; i < numThreads; i++) {
+				if (!worker->outbox[i].empty()) {
+					work.fetch_add(worker->outbox[i].size());
+					workers[i]->inbox.push(std::move(worker->outbox[i]));
+					worker->outbox[i].clear();
+				}
+			}
+
+			continue;
+		}
+
+		if (busy) {
+			busy = false;
+			if (work.fetch_sub(1) == 1) {
+				done.store(true);
+			}
+		} else if (work.load() == 0) {
+			done.store(true);
+		} else {
+			std::this_thread::yield();
+		}
+	}
+}
+
+template <typename T, typename Hash>
+void HDAStar<T, Hash>::receive(unsigned int thread, const HDAStarMessage &message, const T &goal)
+{
+	HDAStarWorker *worker = workers[thread];
+
+	typename std::unordered_map<T, unsigned int, Hash>::iterator result = worker->indices.find(message.node);
+
+	// If the node is new, then create its record and add it to the open list, unless it cannot
+	// possibly improve on the incumbent.
+	if (result == worker->indices.end()) {
+		double h = heuristic(message.node, goal);
+		if (message.g + h >= incumbent.load()) {
+			return;
+		}
+
+		HDAStarRecord record;
+		record.node = message.node;
+		record.g = message.g;
+		record.h = h;
+		record.closed = false;
+
+		record.parentThread = message.parentThread;
+		record.parent = message.parent;
+
+		unsigned int index = worker->records.size();
+		worker->records.push_back(record);
+		worker->indices[message.node] = index;
+		worker->open.push(index, record.g + record.h, -record.g);
+		return;
+	}
+
+	unsigned int index = result->second;
+	HDAStarRecord &record = worker->records[index];
+
+	if (message.g >= record.g || message.g + record.h >= incumbent.load()) {
+		return;
+	}
+
+	// Expansion is not globally in order of f, so expanded nodes are reopened on a cheaper path.
+	record.g = message.g;
+	record.parentThread = message.parentThread;
+	record.parent = message.parent;
+
+	if (record.closed) {
+		record.closed = false;
+		worker->open.push(index, record.g + record.h, -record.g);
+	} else {
+		worker->open.update(index, record.g + record.h, -record.g);
+	}
+}
+
+template <typename T, typename Hash>
+void HDAStar<T, Hash>::expand(unsigned int thread, const T &goal)
+{
+	HDAStarWorker *worker = workers[thread];
+
+	unsigned int current = worker->open.pop();
+	worker->records[current].closed = true;
+
+	// Copy what we need, since receiving successors may reallocate the records.
+	T currentNode = worker->records[current].node;
+	double gCurrent = worker->records[current].g;
+
+	// The goal is not expanded; it becomes the incumbent if it is cheaper.
+	if (currentNode == goal) {
+		std::lock_guard<std::mutex> lock(incumbentMutex);
+		if (gCurrent < incumbent.load()) {
+			incumbent.store(gCurrent);
+			goalThread = thread;
+			goalIndex = current;
+		}
+		return;
+	}
+
+	worker->numNodesExpanded++;
+
+	for (const T &successor : successors(currentNode)) {
+		HDAStarMessage message;
+		message.node = successor;
+		message.g = gCurrent + cost(currentNode, successor);
+		message.parentThread = thread;
+		message.parent = current;
+
+		// Successors owned by this thread are received immediately; others are batched.
+		unsigned int destination = owner(successor);
+		if (destination == thread) {
+			receive(thread, message, goal);
+		} else {
+			worker->outbox[destination].push_back(message);
+		}
+	}
+}
+
+template <typename T, typename Hash>
+void HDAStar<T, Hash>::reconstruct_path()
+{
+	// Follow the parents until the start node (its own parent) is reached. A path can never be
+	// longer than the number of records, so anything longer means the trace is corrupt.
+	unsigned int thread = goalThread;
+	unsigned int index = goalIndex;
+
+	path.push_back(workers[thread]->records[index].node);
+
+	while (true) {
+		const HDAStarRecord &record = workers[thread]->records[index];
+		if (record.parentThread == thread && record.parent == index) {
+			break;
+		}
+
+		thread = record.parentThread;
+		index = record.parent;
+		path.push_back(workers[thread]->records[index].node);
+
+		if (path.size() > numNodesGenerated) {
+			path.clear();
+			throw UtilityException();
+		}
+	}
+
+	std::reverse(path.begin(), path.end());
+}
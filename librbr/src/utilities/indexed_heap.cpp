@@ -0,0 +1,226 @@
+/**
+ *  The MIT License (MIT)
+ *
+ *  Copyright (c) 2014 Kyle Hollins Wray, University of Massachusetts
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy of
+ *  this software and associated documentation files (the "Software"), to deal in
+ *  the Software without restriction, including without limitation the rights to
+ *  use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ *  the Software, and to permit persons to whom the Software is furnished to do so,
+ *  subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included in all
+ *  copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ *  FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ *  COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ *  IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ *  CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+
+#include "../../include/utilities/indexed_heap.h"
+#include "../../include/utilities/utility_exception.h"
+
+#include <limits>
+
+const unsigned int IndexedHeap::absent = std::numeric_limits<unsigned int>::max();
+
+IndexedHeap::IndexedHeap()
+{
+	d = 4;
+}
+
+IndexedHeap::IndexedHeap(unsigned int arity)
+{
+	if (arity < 2) {
+		throw UtilityException();
+	}
+	d = arity;
+}
+
+IndexedHeap::~IndexedHeap()
+{ }
+
+void IndexedHeap::push(unsigned int id, double priority, double tie)
+{
+	if (contains(id)) {
+		throw UtilityException();
+	}
+
+	if (id >= positions.size()) {
+		positions.resize(id + 1, absent);
+	}
+
+	IndexedHeapEntry entry;
+	entry.id = id;
+	entry.priority = priority;
+	entry.tie = tie;
+
+	positions[id] = heap.size();
+	heap.push_back(entry);
+	sift_up(heap.size() - 1);
+}
+
+void IndexedHeap::update(unsigned int id, double priority, double tie)
+{
+	if (!contains(id)) {
+		throw UtilityException();
+	}
+
+	unsigned int position = positions[id];
+	IndexedHeapEntry previous = heap[position];
+
+	heap[position].priority = priority;
+	heap[position].tie = tie;
+
+	if (before(heap[position], previous)) {
+		sift_up(position);
+	} else {
+		sift_down(position);
+	}
+}
+
+unsigned int IndexedHeap::pop()
+{
+	if (heap.empty()) {
+		throw UtilityException();
+	}
+
+	unsigned int id = heap[0].id;
+	positions[id] = absent;
+
+	// Move the last entry to the root and restore the heap property.
+	if (heap.size() > 1) {
+		heap[0] = heap.back();
+		positions[heap[0].id] = 0;
+		heap.pop_back();
+		sift_down(0);
+	} else {
+		heap.pop_back();
+	}
+
+	return id;
+}
+
+unsigned int IndexedHeap::top() const
+{
+	if (heap.empty()) {
+		throw UtilityException();
+	}
+	return heap[0].id;
+}
+
+double IndexedHeap::top_priority() const
+{
+	if (heap.empty()) {
+		throw UtilityException();
+	}
+	return heap[0].priority;
+}
+
+bool IndexedHeap::contains(unsigned int id) const
+{
+	return id < positions.size() && positions[id] != absent;
+}
+
+double IndexedHeap::get_priority(unsigned int id) const
+{
+	if (!contains(id)) {
+		throw UtilityException();
+	}
+	return heap[positions[id]].priority;
+}
+
+unsigned int IndexedHeap::size() const
+{
+	return heap.size();
+}
+
+bool IndexedHeap::empty() const
+{
+	return heap.empty();
+}
+
+unsigned int IndexedHeap::get(unsigned int position) const
+{
+	if (position >= heap.size()) {
+		throw UtilityException();
+	}
+	return heap[position].id;
+}
+
+unsigned int IndexedHeap::get_arity() const
+{
+	return d;
+}
+
+void IndexedHeap::clear()
+{
+	heap.clear();
+	positions.clear();
+}
+
+bool IndexedHeap::before(const IndexedHeapEntry &a, const IndexedHeapEntry &b) const
+{
+	if (a.priority == b.priority) {
+		return a.tie < b.tie;
+	}
+	return a.priority < b.priority;
+}
+
+void IndexedHeap::sift_up(unsigned int position)
+{
+	IndexedHeapEntry entry = heap[position];
+
+	// Move parents down into the hole until the entry's place is found.
+	while (position > 0) {
+		unsigned int parent = (position - 1) / d;
+		if (!before(entry, heap[parent])) {
+			break;
+		}
+
+		heap[position] = heap[parent];
+		positions[heap[position].id] = position;
+		position = parent;
+	}
+
+	heap[position] = entry;
+	positions[entry.id] = position;
+}
+
+void IndexedHeap::sift_down(unsigned int position)
+{
+	IndexedHeapEntry entry = heap[position];
+	unsigned int n = heap.size();
+
+	// Move the best child up into the hole until the entry's place is found.
+	while (true) {
+		unsigned int first = position * d + 1;
+		if (first >= n) {
+			break;
+		}
+
+		unsigned int best = first;
+		unsigned int last = (first + d < n) ? first + d : n;
+		for (unsigned int child = first + 1; child < last; child++) {
+			if (before(heap[child], heap[best])) {
+				best = child;
+			}
+		}
+
+		if (!before(heap[best], entry)) {
+			break;
+		}
+
+		heap[position] = heap[best];
+		positions[heap[position].id] = position;
+		position = best;
+	}
+
+	heap[position] = entry;
+	positions[entry.id] = position;
+}
@@ -0,0 +1,127 @@
+/**
+ *  The MIT License (MIT)
+ *
+ *  Copyright (c) 2014 Kyle Hollins Wray, University of Massachusetts
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy of
+ *  this software and associated documentation files (the "Software"), to deal in
+ *  the Software without restriction, including without limitation the rights to
+ *  use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ *  the Software, and to permit persons to whom the Software is furnished to do so,
+ *  subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included in all
+ *  copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ *  FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ *  COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ *  IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ *  CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+
+//#include "../../include/utilities/lazy_table.h"
+
+template <typename T>
+LazyTable<T>::LazyTable()
+{
+	pages = nullptr;
+	numPages = 0;
+	numObjects.store(0, std::memory_order_relaxed);
+}
+
+template <typename T>
+LazyTable<T>::~LazyTable()
+{
+	clear();
+}
+
+template <typename T>
+void LazyTable<T>::resize(unsigned int size)
+{
+	clear();
+
+	numPages = size / LAZY_TABLE_PAGE_SIZE + (size % LAZY_TABLE_PAGE_SIZE > 0 ? 1 : 0);
+	pages = new std::atomic<std::atomic<T *> *>[numPages];
+	for (unsigned int i = 0; i < numPages; i++) {
+		pages[i].store(nullptr, std::memory_order_relaxed);
+	}
+}
+
+template <typename T>
+void LazyTable<T>::clear()
+{
+	for (unsigned int i = 0; i < numPages; i++) {
+		std::atomic<T *> *page = pages[i].load(std::memory_order_acquire);
+		if (page == nullptr) {
+			continue;
+		}
+
+		for (unsigned int j = 0; j < LAZY_TABLE_PAGE_SIZE; j++) {
+			delete page[j].load(std::memory_order_relaxed);
+		}
+		delete [] page;
+	}
+
+	delete [] pages;
+	pages = nullptr;
+	numPages = 0;
+	numObjects.store(0, std::memory_order_relaxed);
+}
+
+template <typename T>
+T *LazyTable<T>::get(unsigned int index) const
+{
+	std::atomic<T *> *page = pages[index / LAZY_TABLE_PAGE_SIZE].load(std::memory_order_acquire);
+	if (page == nullptr) {
+		return nullptr;
+	}
+	return page[index % LAZY_TABLE_PAGE_SIZE].load(std::memory_order_acquire);
+}
+
+template <typename T>
+T *LazyTable<T>::insert(unsigned int index, T *object)
+{
+	std::atomic<T *> *page = find_page(index);
+
+	// The release publishes the new object; if another thread won, its object is used instead.
+	T *expected = nullptr;
+	if (page[index % LAZY_TABLE_PAGE_SIZE].compare_exchange_strong(expected, object,
+			std::memory_order_acq_rel, std::memory_order_acquire)) {
+		numObjects.fetch_add(1, std::memory_order_relaxed);
+		return object;
+	}
+
+	delete object;
+	return expected;
+}
+
+template <typename T>
+unsigned int LazyTable<T>::get_num_objects() const
+{
+	return numObjects.load(std::memory_order_relaxed);
+}
+
+template <typename T>
+std::atomic<T *> *LazyTable<T>::find_page(unsigned int index)
+{
+	std::atomic<T *> *page = pages[index / LAZY_TABLE_PAGE_SIZE].load(std::memory_order_acquire);
+	if (page != nullptr) {
+		return page;
+	}
+
+	std::atomic<T *> *newPage = new std::atomic<T *>[LAZY_TABLE_PAGE_SIZE];
+	for (unsigned int i = 0; i < LAZY_TABLE_PAGE_SIZE; i++) {
+		newPage[i].store(nullptr, std::memory_order_relaxed);
+	}
+
+	if (pages[index / LAZY_TABLE_PAGE_SIZE].compare_exchange_strong(page, newPage,
+			std::memory_order_acq_rel, std::memory_order_acquire)) {
+		return newPage;
+	}
+
+	delete [] newPage;
+	return page;
+}
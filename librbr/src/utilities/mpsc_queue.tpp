@@ -0,0 +1,74 @@
+/**
+ *  The MIT License (MIT)
+ *
+ *  Copyright (c) 2014 Kyle Hollins Wray, University of Massachusetts
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy of
+ *  this software and associated documentation files (the "Software"), to deal in
+ *  the Software without restriction, including without limitation the rights to
+ *  use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ *  the Software, and to permit persons to whom the Software is furnished to do so,
+ *  subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included in all
+ *  copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ *  FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ *  COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ *  IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ *  CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+
+//#include "../../include/utilities/mpsc_queue.h"
+
+#include <utility>
+
+template <typename T>
+MPSCQueue<T>::MPSCQueue()
+{
+	MPSCQueueNode *stub = new MPSCQueueNode();
+	stub->next.store(nullptr, std::memory_order_relaxed);
+	head.store(stub, std::memory_order_relaxed);
+	tail = stub;
+}
+
+template <typename T>
+MPSCQueue<T>::~MPSCQueue()
+{
+	while (tail != nullptr) {
+		MPSCQueueNode *next = tail->next.load(std::memory_order_relaxed);
+		delete tail;
+		tail = next;
+	}
+}
+
+template <typename T>
+void MPSCQueue<T>::push(T &&value)
+{
+	MPSCQueueNode *node = new MPSCQueueNode();
+	node->value = std::move(value);
+	node->next.store(nullptr, std::memory_order_relaxed);
+
+	// Claim the head, then link the previous head to this node; the release publishes the value.
+	MPSCQueueNode *previous = head.exchange(node, std::memory_order_acq_rel);
+	previous->next.store(node, std::memory_order_release);
+}
+
+template <typename T>
+bool MPSCQueue<T>::try_pop(T &value)
+{
+	MPSCQueueNode *next = tail->next.load(std::memory_order_acquire);
+	if (next == nullptr) {
+		return false;
+	}
+
+	// The next node becomes the new stub once its value is moved out.
+	value = std::move(next->value);
+	delete tail;
+	tail = next;
+
+	return true;
+}
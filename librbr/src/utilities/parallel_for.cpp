@@ -0,0 +1,58 @@
+/**
+ *  The MIT License (MIT)
+ *
+ *  Copyright (c) 2014 Kyle Hollins Wray, University of Massachusetts
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy of
+ *  this software and associated documentation files (the "Software"), to deal in
+ *  the Software without restriction, including without limitation the rights to
+ *  use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ *  the Software, and to permit persons to whom the Software is furnished to do so,
+ *  subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included in all
+ *  copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ *  FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ *  COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ *  IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ *  CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+
+#include "../../include/utilities/parallel_for.h"
+
+#include <algorithm>
+#include <thread>
+#include <vector>
+
+void parallel_for(unsigned int n, const std::function<void (unsigned int)> &f)
+{
+	unsigned int numThreads = std::max(1u, std::min(n, std::thread::hardware_concurrency()));
+
+	// With a single thread, or at most one index, simply run in the calling thread.
+	if (numThreads == 1) {
+		for (unsigned int i = 0; i < n; i++) {
+			f(i);
+		}
+		return;
+	}
+
+	std::vector<std::thread> threads;
+	for (unsigned int t = 0; t < numThreads; t++) {
+		unsigned int first = (unsigned int)((unsigned long long)n * t / numThreads);
+		unsigned int last = (unsigned int)((unsigned long long)n * (t + 1) / numThreads);
+
+		threads.push_back(std::thread([&f, first, last]() {
+			for (unsigned int i = first; i < last; i++) {
+				f(i);
+			}
+		}));
+	}
+
+	for (std::thread &thread : threads) {
+		thread.join();
+	}
+}
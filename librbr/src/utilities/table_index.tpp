@@ -0,0 +1,71 @@
+/**
+ *  The MIT License (MIT)
+ *
+ *  Copyright (c) 2014 Kyle Hollins Wray, University of Massachusetts
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy of
+ *  this software and associated documentation files (the "Software"), to deal in
+ *  the Software without restriction, including without limitation the rights to
+ *  use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ *  the Software, and to permit persons to whom the Software is furnished to do so,
+ *  subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included in all
+ *  copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ *  FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ *  COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ *  IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ *  CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+
+//#include "../../include/utilities/table_index.h"
+
+template <typename Indexed, typename T>
+TableIndex<Indexed, T>::TableIndex(const std::vector<T *> &table)
+{
+	size = table.size();
+
+	indexed = true;
+	for (unsigned int i = 0; indexed && i < size; i++) {
+		Indexed *object = dynamic_cast<Indexed *>(table[i]);
+		indexed = (object != nullptr && object->get_index() == i);
+	}
+
+	if (!indexed) {
+		for (unsigned int i = 0; i < size; i++) {
+			positions[table[i]] = i;
+		}
+	}
+}
+
+template <typename Indexed, typename T>
+TableIndex<Indexed, T>::~TableIndex()
+{ }
+
+template <typename Indexed, typename T>
+unsigned int TableIndex<Indexed, T>::find(T *object) const
+{
+	if (indexed) {
+		Indexed *o = dynamic_cast<Indexed *>(object);
+		if (o == nullptr || o->get_index() >= size) {
+			return size;
+		}
+		return o->get_index();
+	}
+
+	typename std::unordered_map<T *, unsigned int>::const_iterator result = positions.find(object);
+	if (result == positions.end()) {
+		return size;
+	}
+	return result->second;
+}
+
+template <typename Indexed, typename T>
+bool TableIndex<Indexed, T>::is_indexed() const
+{
+	return indexed;
+}
@@ -0,0 +1,336 @@
+/**
+ *  The MIT License (MIT)
+ *
+ *  Copyright (c) 2014 Kyle Hollins Wray, University of Massachusetts
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy of
+ *  this software and associated documentation files (the "Software"), to deal in
+ *  the Software without restriction, including without limitation the rights to
+ *  use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ *  the Software, and to permit persons to whom the Software is furnished to do so,
+ *  subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included in all
+ *  copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ *  FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ *  COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ *  IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ *  CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+
+#include "../../include/utilities/tokenizer.h"
+
+#include <cstring>
+#include <cstdlib>
+#include <climits>
+
+/**
+ * The longest token handed to strtod; longer numbers are truncated.
+ */
+#define TOKENIZER_MAX_NUMBER_LENGTH 128
+
+/**
+ * The powers of ten which are exactly representable as doubles.
+ */
+static const double TOKENIZER_POWERS_OF_TEN[] = {
+	1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+	1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+};
+
+bool token_equals(const Token &token, const char *text)
+{
+	unsigned int length = std::strlen(text);
+	return token.length == length && std::memcmp(token.data, text, length) == 0;
+}
+
+std::string token_to_string(const Token &token)
+{
+	return std::string(token.data, token.length);
+}
+
+Tokenizer::Tokenizer(const char *data, std::size_t size)
+{
+	this->data = data;
+	this->size = size;
+	position = 0;
+}
+
+Tokenizer::~Tokenizer()
+{ }
+
+bool Tokenizer::next_line(Token &line)
+{
+	if (position >= size) {
+		return false;
+	}
+
+	const char *start = data + position;
+	const char *end = (const char *)std::memchr(start, '\n', size - position);
+
+	std::size_t length = (end == nullptr) ? (size - position) : (std::size_t)(end - start);
+	position += length + 1;
+
+	if (length > 0 && start[length - 1] == '\r') {
+		length--;
+	}
+
+	line.data = start;
+	line.length = (unsigned int)length;
+
+	return true;
+}
+
+void Tokenizer::strip_comment(Token &line)
+{
+	const char *comment = (const char *)std::memchr(line.data, '#', line.length);
+	if (comment != nullptr) {
+		line.length = (unsigned int)(comment - line.data);
+	}
+}
+
+bool Tokenizer::contains(const Token &line, char c)
+{
+	return std::memchr(line.data, c, line.length) != nullptr;
+}
+
+unsigned int Tokenizer::split_by_colon(const Token &line, Token *items, unsigned int maxItems)
+{
+	unsigned int numItems = 0;
+	unsigned int start = 0;
+
+	for (unsigned int i = 0; i <= line.length; i++) {
+		if (i < line.length && line.data[i] != ':') {
+			continue;
+		}
+
+		// Trim the spaces on both sides of the item, then skip it if it is empty.
+		unsigned int left = start;
+		unsigned int right = i;
+		while (left < right && line.data[left] == ' ') {
+			left++;
+		}
+		while (right > left && line.data[right - 1] == ' ') {
+			right--;
+		}
+
+		if (right > left) {
+			if (numItems < maxItems) {
+				items[numItems].data = line.data + left;
+				items[numItems].length = right - left;
+			}
+			numItems++;
+		}
+
+		start = i + 1;
+	}
+
+	return numItems;
+}
+
+bool Tokenizer::next_item(Token &remaining, Token &item)
+{
+	const char *current = remaining.data;
+	const char *end = remaining.data + remaining.length;
+
+	while (current < end && (*current == ' ' || *current == '\t')) {
+		current++;
+	}
+
+	if (current == end) {
+		remaining.data = end;
+		remaining.length = 0;
+		return false;
+	}
+
+	const char *start = current;
+
+	if (*current == '<') {
+		// A bracketed item, e.g., a joint action, which may contain spaces.
+		start++;
+		const char *close = (const char *)std::memchr(start, '>', end - start);
+		if (close == nullptr) {
+			close = end;
+		}
+
+		item.data = start;
+		item.length = (unsigned int)(close - start);
+
+		current = (close < end) ? close + 1 : end;
+	} else {
+		while (current < end && *current != ' ' && *current != '\t') {
+			current++;
+		}
+
+		item.data = start;
+		item.length = (unsigned int)(current - start);
+	}
+
+	remaining.data = current;
+	remaining.length = (unsigned int)(end - current);
+
+	return true;
+}
+
+unsigned int Tokenizer::count_items(const Token &line)
+{
+	Token remaining = line;
+	Token item;
+
+	unsigned int count = 0;
+	while (next_item(remaining, item)) {
+		count++;
+	}
+
+	return count;
+}
+
+bool Tokenizer::parse_double(const Token &token, double &value)
+{
+	const char *current = token.data;
+	const char *end = token.data + token.length;
+
+	// Read the sign, and then the digits as an integer mantissa, keeping track of the decimal point.
+	bool negative = false;
+	if (current < end && (*current == '-' || *current == '+')) {
+		negative = (*current == '-');
+		current++;
+	}
+
+	unsigned long long mantissa = 0;
+	int numDigits = 0;
+	int exponent = 0;
+	bool exact = true;
+
+	const char *digitsStart = current;
+	while (current < end && *current >= '0' && *current <= '9') {
+		if (numDigits < 19) {
+			mantissa = mantissa * 10 + (*current - '0');
+			if (mantissa > 0) {
+				numDigits++;
+			}
+		} else {
+			exact = false;
+		}
+		current++;
+	}
+	bool hasDigits = (current > digitsStart);
+
+	if (current < end && *current == '.') {
+		current++;
+		const char *fractionStart = current;
+		while (current < end && *current >= '0' && *current <= '9') {
+			if (numDigits < 19) {
+				mantissa = mantissa * 10 + (*current - '0');
+				if (mantissa > 0) {
+					numDigits++;
+				}
+				exponent--;
+			} else {
+				exact = false;
+			}
+			current++;
+		}
+		hasDigits = hasDigits || (current > fractionStart);
+	}
+
+	// An exponent is only part of the number if it has digits.
+	if (hasDigits && current < end && (*current == 'e' || *current == 'E')) {
+		const char *exponentStart = current;
+		current++;
+
+		bool negativeExponent = false;
+		if (current < end && (*current == '-' || *current == '+')) {
+			negativeExponent = (*current == '-');
+			current++;
+		}
+
+		if (current < end && *current >= '0' && *current <= '9') {
+			int explicitExponent = 0;
+			while (current < end && *current >= '0' && *current <= '9') {
+				if (explicitExponent < 100000) {
+					explicitExponent = explicitExponent * 10 + (*current - '0');
+				}
+				current++;
+			}
+			exponent += negativeExponent ? -explicitExponent : explicitExponent;
+		} else {
+			current = exponentStart;
+		}
+	}
+
+	// Clinger's fast path: a mantissa and power of ten which are both exact doubles give a correctly
+	// rounded result with a single multiplication or division. A hexadecimal prefix ("0x") must go
+	// to strtod too.
+	bool hexadecimal = (current < end && (*current == 'x' || *current == 'X'));
+	if (hasDigits && exact && !hexadecimal && mantissa <= (1ull << 53) && exponent >= -22 && exponent <= 22) {
+		double result = (double)mantissa;
+		if (exponent < 0) {
+			result /= TOKENIZER_POWERS_OF_TEN[-exponent];
+		} else {
+			result *= TOKENIZER_POWERS_OF_TEN[exponent];
+		}
+		value = negative ? -result : result;
+		return true;
+	}
+
+	// Otherwise, hand a null-terminated copy of the token to strtod.
+	char buffer[TOKENIZER_MAX_NUMBER_LENGTH];
+	unsigned int length = token.length;
+	if (length >= TOKENIZER_MAX_NUMBER_LENGTH) {
+		length = TOKENIZER_MAX_NUMBER_LENGTH - 1;
+	}
+	std::memcpy(buffer, token.data, length);
+	buffer[length] = '\0';
+
+	char *parsed = nullptr;
+	double result = std::strtod(buffer, &parsed);
+	if (parsed == buffer) {
+		return false;
+	}
+
+	value = result;
+	return true;
+}
+
+bool Tokenizer::parse_int(const Token &token, int &value)
+{
+	const char *current = token.data;
+	const char *end = token.data + token.length;
+
+	while (current < end && (*current == ' ' || *current == '\t')) {
+		current++;
+	}
+
+	bool negative = false;
+	if (current < end && (*current == '-' || *current == '+')) {
+		negative = (*current == '-');
+		current++;
+	}
+
+	if (current == end || *current < '0' || *current > '9') {
+		return false;
+	}
+
+	long long result = 0;
+	while (current < end && *current >= '0' && *current <= '9') {
+		result = result * 10 + (*current - '0');
+		if (result > (long long)INT_MAX + 1) {
+			return false;
+		}
+		current++;
+	}
+
+	if (negative) {
+		result = -result;
+	}
+	if (result > INT_MAX || result < INT_MIN) {
+		return false;
+	}
+
+	value = (int)result;
+	return true;
+}
@@ -27,17 +27,20 @@
 
 
 #define NUM_AGENT_TESTS 8
-#define NUM_STATE_TESTS 22
-#define NUM_ACTION_TESTS 22
+#define NUM_STATE_TESTS 28
+#define NUM_ACTION_TESTS 25
 #define NUM_OBSERVATION_TESTS 22
 #define NUM_REWARD_TESTS 17
-#define NUM_STATE_TRANSITION_TESTS 6
+#define NUM_STATE_TRANSITION_TESTS 7
 #define NUM_OBSERVATION_TRANSITION_TESTS 6
-#define NUM_POLICY_TESTS 19
-#define NUM_UNIFIED_FILE_TESTS 20
-#define NUM_UTILITIES_TESTS 1
-#define NUM_MDP_TESTS 6
-#define NUM_POMDP_TESTS 6
+#define NUM_POLICY_TESTS 23
+#define NUM_UNIFIED_FILE_TESTS 26
+#define NUM_RAW_FILE_TESTS 8
+#define NUM_POMDP_FILE_TESTS 3
+#define NUM_UTILITIES_TESTS 12
+#define NUM_MDP_TESTS 14
+#define NUM_POMDP_TESTS 10
+#define NUM_DEC_POMDP_TESTS 8
 
 /**
  * Test the agents objects. Output the success or failure for each test.
@@ -93,6 +96,18 @@ int test_policy();
  */
 int test_unified_file();
 
+/**
+ * Test the RawFile object. Output the success or failure for each test.
+ * @return	The number of successes during execution.
+ */
+int test_raw_file();
+
+/**
+ * Test the POMDPFile object. Output the success or failure for each test.
+ * @return	The number of successes during execution.
+ */
+int test_pomdp_file();
+
 /**
  * Test the utilities objects. Output the success or failure for each test.
  * @return	The number of successes during execution.
@@ -111,5 +126,11 @@ int test_mdp();
  */
 int test_pomdp();
 
+/**
+ * Test the Dec-POMDP solvers. Output the success or failure for each test.
+ * @return	The number of successes during execution.
+ */
+int test_dec_pomdp();
+
 
 #endif // PERFORM_TESTS_H
@@ -25,6 +25,7 @@
 #include "../../include/perform_tests.h"
 
 #include <iostream>
+#include <thread>
 
 #include "../../../librbr/include/core/actions/named_action.h"
 #include "../../../librbr/include/core/actions/actions_map.h"
@@ -33,6 +34,8 @@
 #include "../../../librbr/include/core/actions/action_exception.h"
 #include "../../../librbr/include/core/actions/action_utilities.h"
 
+#include "../../../librbr/include/core/states/named_state.h"
+
 int test_actions()
 {
 	int numSuccesses = 0;
@@ -76,6 +79,32 @@ int test_actions()
 		std::cout << " Failure." << std::endl;
 	}
 
+	std::cout << "Actions: Test 'FiniteActions::set_available' and 'FiniteActions::available'... ";
+
+	NamedState *s1 = new NamedState("s1");
+	NamedState *s2 = new NamedState("s2");
+
+	try {
+		std::vector<Action *> available;
+		available.push_back(a3);
+		finiteActions->set_available(s2, available);
+
+		if (finiteActions->available(s1).size() == 3 && finiteActions->available(s2).size() == 1 &&
+				finiteActions->available(s2)[0] == a3 && finiteActions->has_state_dependent_actions()) {
+			std::cout << " Success." << std::endl;
+			numSuccesses++;
+		} else {
+			std::cout << " Failure." << std::endl;
+		}
+	} catch (const ActionException &err) {
+		std::cout << " Failure." << std::endl;
+	}
+
+	finiteActions->reset_available();
+
+	delete s1;
+	delete s2;
+
 	std::cout << "Actions: Test 'FiniteActions::remove'... ";
 	try {
 		finiteActions->remove(a2);
@@ -442,5 +471,83 @@ int test_actions()
 	delete finiteJointActions;
 	finiteJointActions = nullptr;
 
+	std::cout << "Actions: Test 'FiniteJointActions::get_action' (Many Agents)... ";
+
+	// Eight agents with ten actions each has 10^8 joint actions, which are only created when requested.
+	finiteJointActions = new JointActionsMap(8);
+	for (unsigned int i = 0; i < 8; i++) {
+		for (unsigned int j = 0; j < 10; j++) {
+			finiteJointActions->add(i, new NamedAction("b" + std::to_string(i) + "_" + std::to_string(j)));
+		}
+	}
+
+	try {
+		finiteJointActions->update();
+
+		JointAction *last = dynamic_cast<JointAction *>(finiteJointActions->get_action(99999999));
+		Action *named = finiteJointActions->get_by_name("b0_1 b1_2 b2_3 b3_4 b4_5 b5_6 b6_7 b7_8");
+
+		if (finiteJointActions->get_num_actions() == 100000000 &&
+				last != nullptr && last->get(0) == finiteJointActions->get(0, 9) &&
+				last->get(7) == finiteJointActions->get(7, 9) &&
+				finiteJointActions->get_index(last) == 99999999 &&
+				finiteJointActions->get_index(named) == 12345678 &&
+				finiteJointActions->get_action(12345678) == named &&
+				finiteJointActions->get(named->hash_value()) == named &&
+				finiteJointActions->exists(named)) {
+			std::cout << " Success." << std::endl;
+			numSuccesses++;
+		} else {
+			std::cout << " Failure." << std::endl;
+		}
+	} catch (const ActionException &err) {
+		std::cout << " Failure." << std::endl;
+	}
+
+	delete finiteJointActions;
+	finiteJointActions = nullptr;
+
+	std::cout << "Actions: Test 'FiniteJointActions::get_action' (Concurrent Creation)... ";
+
+	// Several threads create the same 1000 joint actions at once; each must get the same objects.
+	finiteJointActions = new JointActionsMap(3);
+	for (unsigned int i = 0; i < 3; i++) {
+		for (unsigned int j = 0; j < 10; j++) {
+			finiteJointActions->add(i, new NamedAction("c" + std::to_string(i) + "_" + std::to_string(j)));
+		}
+	}
+	finiteJointActions->update();
+
+	std::vector<std::vector<Action *> > createdActions(4, std::vector<Action *>(1000, nullptr));
+	std::vector<std::thread> creators;
+	for (unsigned int i = 0; i < 4; i++) {
+		creators.push_back(std::thread([finiteJointActions, &createdActions, i]() {
+			for (unsigned int j = 0; j < 1000; j++) {
+				createdActions[i][(j + 250 * i) % 1000] = finiteJointActions->get_action((j + 250 * i) % 1000);
+			}
+		}));
+	}
+	for (std::thread &creator : creators) {
+		creator.join();
+	}
+
+	bool valid = true;
+	for (unsigned int j = 0; valid && j < 1000; j++) {
+		for (unsigned int i = 1; i < 4; i++) {
+			valid = valid && (createdActions[i][j] == createdActions[0][j]);
+		}
+		valid = valid && (finiteJointActions->get_index(createdActions[0][j]) == j);
+	}
+
+	if (valid) {
+		std::cout << " Success." << std::endl;
+		numSuccesses++;
+	} else {
+		std::cout << " Failure." << std::endl;
+	}
+
+	delete finiteJointActions;
+	finiteJointActions = nullptr;
+
 	return numSuccesses;
 }
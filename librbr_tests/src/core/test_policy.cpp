@@ -148,6 +148,38 @@ int test_policy()
 		std::cout << " Failure." << std::endl;
 	}
 
+	std::cout << "Policy: 'PolicyMap::save_binary' and 'PolicyMap::load_binary' (Check Result)... ";
+	PolicyMap *binaryPolicyMap = new PolicyMap();
+	if (!policyMap->save_binary("tmp/test_03.policy_map_binary", states, actions, 0x0123456789abcdefULL) &&
+			!binaryPolicyMap->load_binary("tmp/test_03.policy_map_binary", states, actions, horizon,
+					0x0123456789abcdefULL)) {
+		try {
+			if (binaryPolicyMap->get(0, s1) == a2 && binaryPolicyMap->get(0, s2) == a1 &&
+					binaryPolicyMap->get(1, s1) == a1 && binaryPolicyMap->get(1, s2) == a2 &&
+					binaryPolicyMap->get(2, s1) == a1 && binaryPolicyMap->get(2, s2) == a1) {
+				std::cout << " Success." << std::endl;
+				numSuccesses++;
+			} else {
+				std::cout << " Failure." << std::endl;
+			}
+		} catch (const PolicyException &err) {
+			std::cout << " Failure." << std::endl;
+		}
+	} else {
+		std::cout << " Failure." << std::endl;
+	}
+
+	std::cout << "Policy: 'PolicyMap::load_binary' with a different fingerprint (Expecting Error)...\n\t";
+	if (binaryPolicyMap->load_binary("tmp/test_03.policy_map_binary", states, actions, horizon, 42)) {
+		std::cout << "\tSuccess." << std::endl;
+		numSuccesses++;
+	} else {
+		std::cout << "\tFailure." << std::endl;
+	}
+
+	delete binaryPolicyMap;
+	binaryPolicyMap = nullptr;
+
 	std::cout << "Policy: 'PolicyTree::load' file 'test_04.policy_tree'... ";
 
 	NamedObservation *o1 = new NamedObservation("o1");
@@ -223,6 +255,35 @@ int test_policy()
 		std::cout << " Failure." << std::endl;
 	}
 
+	std::cout << "Policy: 'PolicyTree::save_binary' and 'PolicyTree::load_binary' (Check Result)... ";
+	PolicyTree *binaryPolicyTree = new PolicyTree();
+	if (!policyTree->save_binary("tmp/test_04.policy_tree_binary", actions, observations, 0x0123456789abcdefULL) &&
+			!binaryPolicyTree->load_binary("tmp/test_04.policy_tree_binary", actions, observations, horizon,
+					0x0123456789abcdefULL)) {
+		try {
+			bool same = true;
+			for (const std::vector<Observation *> &h : {history, history1, history2, history11, history12,
+					history21, history22, history111, history112, history121, history122, history211,
+					history212, history221, history222}) {
+				same = same && (binaryPolicyTree->get(h) == policyTree->get(h));
+			}
+
+			if (same) {
+				std::cout << " Success." << std::endl;
+				numSuccesses++;
+			} else {
+				std::cout << " Failure." << std::endl;
+			}
+		} catch (const PolicyException &err) {
+			std::cout << " Failure." << std::endl;
+		}
+	} else {
+		std::cout << " Failure." << std::endl;
+	}
+
+	delete binaryPolicyTree;
+	binaryPolicyTree = nullptr;
+
 	std::cout << "Policy: Test 'PolicyAlphaVector::set' and 'PolicyAlphaVector::get'... ";
 
 	PolicyAlphaVector *policyAlphaVector = new PolicyAlphaVector(a1);
@@ -400,6 +461,26 @@ int test_policy()
 		std::cout << " Failure." << std::endl;
 	}
 
+	std::cout << "Policy: 'PolicyAlphaVectors::save_binary' and 'PolicyAlphaVectors::load_binary' (Check Result)... ";
+	PolicyAlphaVectors *binaryPolicyAlphaVectors = new PolicyAlphaVectors();
+	if (!policyAlphaVectors->save_binary("tmp/test_05.policy_alpha_vectors_binary", states, actions, 7) &&
+			!binaryPolicyAlphaVectors->load_binary("tmp/test_05.policy_alpha_vectors_binary", states, actions,
+					horizon, 7)) {
+		if (binaryPolicyAlphaVectors->get(0, b) == a2 && binaryPolicyAlphaVectors->get(1, b) == a1 &&
+				binaryPolicyAlphaVectors->compute_value(0, b) == policyAlphaVectors->compute_value(0, b) &&
+				binaryPolicyAlphaVectors->compute_value(1, b) == policyAlphaVectors->compute_value(1, b)) {
+			std::cout << " Success." << std::endl;
+			numSuccesses++;
+		} else {
+			std::cout << " Failure." << std::endl;
+		}
+	} else {
+		std::cout << " Failure." << std::endl;
+	}
+
+	delete binaryPolicyAlphaVectors;
+	binaryPolicyAlphaVectors = nullptr;
+
 	// Note: The state, action, and policy alpha vector variables are freed inside the deconstructors of states, actions,
 	// and policy alpha vectors classes, respectively.
 	delete states;
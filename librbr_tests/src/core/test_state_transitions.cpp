@@ -27,12 +27,15 @@
 #include <iostream>
 
 #include "../../../librbr/include/core/state_transitions/state_transitions_map.h"
+#include "../../../librbr/include/core/state_transitions/factored_state_transitions.h"
 #include "../../../librbr/include/core/state_transitions/state_transition_exception.h"
+#include "../../../librbr/include/core/states/state_exception.h"
 
 #include "../../../librbr/include/core/states/named_state.h"
 #include "../../../librbr/include/core/actions/named_action.h"
 
 #include "../../../librbr/include/core/states/states_map.h"
+#include "../../../librbr/include/core/states/factored_states_map.h"
 
 int test_state_transitions()
 {
@@ -230,5 +233,78 @@ int test_state_transitions()
 	delete a1;
 	delete a2;
 
+	std::cout << "StateTransitions: Test 'FactoredStateTransitions' (Many Factors)... ";
+
+	// Thirty binary factors, each of which turns on with probability 0.5 when the previous factor is on,
+	// and otherwise stays the same. The tables only need to store 236 probabilities for 2^30 states.
+	FactoredStatesMap *factoredStates = new FactoredStatesMap();
+	for (unsigned int i = 0; i < 30; i++) {
+		factoredStates->add_factor({new NamedState("off"), new NamedState("on")});
+	}
+	factoredStates->update();
+
+	FactoredStateTransitions *factoredStateTransitions = new FactoredStateTransitions(factoredStates);
+
+	Action *a = new NamedAction("a");
+
+	try {
+		factoredStateTransitions->set_parents(0, {0});
+		factoredStateTransitions->set(0, nullptr, {factoredStates->get(0, 0)}, factoredStates->get(0, 0), 1.0);
+		factoredStateTransitions->set(0, nullptr, {factoredStates->get(0, 1)}, factoredStates->get(0, 1), 1.0);
+
+		for (unsigned int i = 1; i < 30; i++) {
+			State *previousOff = factoredStates->get(i - 1, 0);
+			State *previousOn = factoredStates->get(i - 1, 1);
+			State *off = factoredStates->get(i, 0);
+			State *on = factoredStates->get(i, 1);
+
+			factoredStateTransitions->set_parents(i, {i - 1, i});
+			factoredStateTransitions->set(i, nullptr, {previousOff, off}, off, 1.0);
+			factoredStateTransitions->set(i, nullptr, {previousOff, on}, on, 1.0);
+			factoredStateTransitions->set(i, nullptr, {previousOn, off}, off, 0.5);
+			factoredStateTransitions->set(i, nullptr, {previousOn, off}, on, 0.5);
+			factoredStateTransitions->set(i, nullptr, {previousOn, on}, on, 1.0);
+		}
+
+		State *firstOn = factoredStates->get_by_name(
+				"on off off off off off off off off off off off off off off off off off off off off off off off off off off off off off");
+		State *firstTwoOn = factoredStates->get_by_name(
+				"on on off off off off off off off off off off off off off off off off off off off off off off off off off off off off");
+		State *firstThreeOn = factoredStates->get_by_name(
+				"on on on off off off off off off off off off off off off off off off off off off off off off off off off off off off");
+
+		const std::vector<State *> &successors = factoredStateTransitions->successors(factoredStates, firstOn, a);
+		const std::vector<float> &probabilities = factoredStateTransitions->probabilities(factoredStates, firstOn, a);
+
+		std::mt19937 generator(42);
+		bool sampled = true;
+		for (unsigned int i = 0; i < 10; i++) {
+			State *next = factoredStateTransitions->sample(firstOn, a, generator);
+			sampled = sampled && (next == firstOn || next == firstTwoOn);
+		}
+
+		if (factoredStates->get_num_states() == (1u << 30) &&
+				factoredStateTransitions->get_num_parameters() == 236 &&
+				factoredStateTransitions->get(firstOn, a, firstTwoOn) == 0.5 &&
+				factoredStateTransitions->get(firstOn, a, firstThreeOn) == 0.0 &&
+				factoredStateTransitions->get(firstTwoOn, a, firstThreeOn) == 0.5 &&
+				successors.size() == 2 && successors[0] == firstOn && successors[1] == firstTwoOn &&
+				probabilities.size() == 2 && probabilities[0] == 0.5f && probabilities[1] == 0.5f &&
+				sampled) {
+			std::cout << " Success." << std::endl;
+			numSuccesses++;
+		} else {
+			std::cout << " Failure." << std::endl;
+		}
+	} catch (const StateTransitionException &err) {
+		std::cout << " Failure." << std::endl;
+	} catch (const StateException &err) {
+		std::cout << " Failure." << std::endl;
+	}
+
+	delete factoredStateTransitions;
+	delete factoredStates;
+	delete a;
+
 	return numSuccesses;
 }
@@ -25,8 +25,12 @@
 #include "../../include/perform_tests.h"
 
 #include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
 
 #include "../../../librbr/include/core/states/named_state.h"
+#include "../../../librbr/include/core/states/indexed_state.h"
 #include "../../../librbr/include/core/states/states_map.h"
 #include "../../../librbr/include/core/states/factored_state.h"
 #include "../../../librbr/include/core/states/factored_states_map.h"
@@ -231,6 +235,75 @@ int test_states()
 		numSuccesses++;
 	}
 
+	std::cout << "States: Test 'FiniteStates::get_index' and 'FiniteStates::get_state'... ";
+	try {
+		bool valid = true;
+		unsigned int i = 0;
+		for (auto s : *finiteStates) {
+			State *state = resolve(s);
+			valid = valid && (finiteStates->get_index(state) == i) && (finiteStates->get_state(i) == state);
+			i++;
+		}
+
+		if (valid && i == finiteStates->get_num_states()) {
+			std::cout << " Success." << std::endl;
+			numSuccesses++;
+		} else {
+			std::cout << " Failure." << std::endl;
+		}
+	} catch (const StateException &err) {
+		std::cout << " Failure." << std::endl;
+	}
+
+	std::cout << "States: Test 'FiniteStates::add' (Hash Collision)... ";
+
+	// The names "Aa" and "BB" have the same hash value.
+	State *collision1 = new NamedState("Aa");
+	State *collision2 = new NamedState("BB");
+	State *duplicate = new NamedState("Aa");
+
+	try {
+		unsigned int numStates = finiteStates->get_num_states();
+		finiteStates->add(collision1);
+		finiteStates->add(collision2);
+
+		if (collision1->hash_value() == collision2->hash_value() &&
+				finiteStates->get_num_states() == numStates + 2 &&
+				finiteStates->get_index(collision2) == numStates + 1 &&
+				finiteStates->get_index(duplicate) == numStates &&
+				finiteStates->get(collision2->hash_value()) == collision1) {
+			std::cout << " Success." << std::endl;
+			numSuccesses++;
+		} else {
+			std::cout << " Failure." << std::endl;
+		}
+	} catch (const StateException &err) {
+		std::cout << " Failure." << std::endl;
+	}
+
+	delete duplicate;
+
+	std::cout << "States: Test 'FiniteStates::get_by_name' and 'FiniteStates::remove'... ";
+	try {
+		finiteStates->remove(collision1);
+
+		bool removed = false;
+		try {
+			finiteStates->get_by_name("Aa");
+		} catch (const StateException &err) {
+			removed = true;
+		}
+
+		if (removed && finiteStates->get_by_name("BB") == collision2) {
+			std::cout << " Success." << std::endl;
+			numSuccesses++;
+		} else {
+			std::cout << " Failure." << std::endl;
+		}
+	} catch (const StateException &err) {
+		std::cout << " Failure." << std::endl;
+	}
+
 	delete finiteStates;
 	finiteStates = nullptr;
 
@@ -433,5 +506,133 @@ int test_states()
 
 	delete finiteFactoredStates;
 
+	std::cout << "States: Test 'FactoredStatesMap' (Mixed-Radix Indexes Over 30 Factors)... ";
+
+	// There are 2^30 factored states, so they may only be created on demand.
+	finiteFactoredStates = new FactoredStatesMap();
+	for (unsigned int i = 0; i < 30; i++) {
+		finiteFactoredStates->add_factor({new NamedState("f" + std::to_string(i) + "a"),
+				new NamedState("f" + std::to_string(i) + "b")});
+	}
+
+	try {
+		finiteFactoredStates->update();
+
+		// The index 5 = 0b101 sets the last and third to last factors, the least significant ones.
+		std::string name = "";
+		for (unsigned int i = 0; i < 30; i++) {
+			name += "f" + std::to_string(i) + ((i == 27 || i == 29) ? "b" : "a");
+			if (i < 29) {
+				name += " ";
+			}
+		}
+
+		State *state = finiteFactoredStates->get_state(5);
+		FactoredState *fs = dynamic_cast<FactoredState *>(state);
+
+		if (finiteFactoredStates->get_num_states() == (1u << 30) &&
+				fs != nullptr && fs->get(29) == finiteFactoredStates->get(29, 1) &&
+				fs->get(28) == finiteFactoredStates->get(28, 0) &&
+				finiteFactoredStates->get_state(5) == state &&
+				finiteFactoredStates->get_index(state) == 5 &&
+				finiteFactoredStates->get_by_name(name) == state &&
+				finiteFactoredStates->get(state->hash_value()) == state &&
+				finiteFactoredStates->exists(state) &&
+				finiteFactoredStates->get_index(finiteFactoredStates->get_state((1u << 30) - 1)) == (1u << 30) - 1) {
+			std::cout << " Success." << std::endl;
+			numSuccesses++;
+		} else {
+			std::cout << " Failure." << std::endl;
+		}
+	} catch (const StateException &err) {
+		std::cout << " Failure." << std::endl;
+	}
+
+	delete finiteFactoredStates;
+
+	std::cout << "States: Test 'FactoredStatesMap' (Concurrent Creation)... ";
+
+	// Several threads create the same 8000 states at once; each must get the same objects.
+	finiteFactoredStates = new FactoredStatesMap();
+	for (unsigned int i = 0; i < 3; i++) {
+		std::vector<State *> factor;
+		for (unsigned int j = 0; j < 20; j++) {
+			factor.push_back(new NamedState("f" + std::to_string(i) + "s" + std::to_string(j)));
+		}
+		finiteFactoredStates->add_factor(factor);
+	}
+	finiteFactoredStates->update();
+
+	std::vector<std::vector<State *> > createdStates(4, std::vector<State *>(8000, nullptr));
+	std::vector<std::thread> creators;
+	for (unsigned int i = 0; i < 4; i++) {
+		creators.push_back(std::thread([finiteFactoredStates, &createdStates, i]() {
+			for (unsigned int j = 0; j < 8000; j++) {
+				createdStates[i][(j + 2000 * i) % 8000] = finiteFactoredStates->get_state((j + 2000 * i) % 8000);
+			}
+		}));
+	}
+	for (std::thread &creator : creators) {
+		creator.join();
+	}
+
+	bool valid = (finiteFactoredStates->get_num_created() == 8000);
+	for (unsigned int j = 0; valid && j < 8000; j++) {
+		for (unsigned int i = 1; i < 4; i++) {
+			valid = valid && (createdStates[i][j] == createdStates[0][j]);
+		}
+		valid = valid && (finiteFactoredStates->get_index(createdStates[0][j]) == j);
+	}
+	valid = valid && (finiteFactoredStates->get(createdStates[0][7999]->hash_value()) == createdStates[0][7999]) &&
+			(finiteFactoredStates->get(createdStates[0][4321]->hash_value()) == createdStates[0][4321]);
+
+	if (valid) {
+		std::cout << " Success." << std::endl;
+		numSuccesses++;
+	} else {
+		std::cout << " Failure." << std::endl;
+	}
+
+	delete finiteFactoredStates;
+
+	std::cout << "States: Test 'IndexedState' (Per-Model Indexers)... ";
+
+	// Build two models at once, each in its own thread with its own indexer.
+	unsigned int numStaticStates = IndexedState::get_num_states();
+
+	StatesMap *indexedStates[2];
+	std::vector<std::thread> threads;
+	for (unsigned int i = 0; i < 2; i++) {
+		indexedStates[i] = new StatesMap();
+		threads.push_back(std::thread([](StatesMap *S) {
+			Indexer indexer;
+			for (unsigned int j = 0; j < 1000; j++) {
+				S->add(new IndexedState(indexer));
+			}
+		}, indexedStates[i]));
+	}
+	for (std::thread &thread : threads) {
+		thread.join();
+	}
+
+	valid = (IndexedState::get_num_states() == numStaticStates);
+	for (unsigned int i = 0; i < 2; i++) {
+		unsigned int j = 0;
+		for (auto s : *indexedStates[i]) {
+			IndexedState *state = dynamic_cast<IndexedState *>(resolve(s));
+			valid = valid && (state != nullptr) && (state->get_index() == j);
+			j++;
+		}
+		valid = valid && (j == 1000);
+		delete indexedStates[i];
+	}
+
+	if (valid) {
+		std::cout << " Success." << std::endl;
+		numSuccesses++;
+	} else {
+		std::cout << " Failure." << std::endl;
+	}
+
 	return numSuccesses;
 }
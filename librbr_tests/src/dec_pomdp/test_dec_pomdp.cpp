@@ -0,0 +1,236 @@
+/**
+ *  The MIT License (MIT)
+ *
+ *  Copyright (c) 2014 Kyle Hollins Wray, University of Massachusetts
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy of
+ *  this software and associated documentation files (the "Software"), to deal in
+ *  the Software without restriction, including without limitation the rights to
+ *  use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ *  the Software, and to permit persons to whom the Software is furnished to do so,
+ *  subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included in all
+ *  copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ *  FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ *  COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ *  IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ *  CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+
+#include "../../include/perform_tests.h"
+
+#include <iostream>
+#include <math.h>
+
+#include "../../../librbr/include/management/unified_file.h"
+
+#include "../../../librbr/include/dec_pomdp/dec_pomdp.h"
+#include "../../../librbr/include/dec_pomdp/dec_pomdp_gmaa_star.h"
+#include "../../../librbr/include/dec_pomdp/dec_pomdp_policy_evaluation.h"
+
+#include "../../../librbr/include/core/states/belief_state.h"
+#include "../../../librbr/include/core/states/states_map.h"
+#include "../../../librbr/include/core/actions/named_action.h"
+#include "../../../librbr/include/core/actions/joint_actions_map.h"
+
+#include "../../../librbr/include/core/core_exception.h"
+#include "../../../librbr/include/core/states/state_exception.h"
+#include "../../../librbr/include/core/actions/action_exception.h"
+#include "../../../librbr/include/core/observations/observation_exception.h"
+#include "../../../librbr/include/core/state_transitions/state_transition_exception.h"
+#include "../../../librbr/include/core/observation_transitions/observation_transition_exception.h"
+#include "../../../librbr/include/core/rewards/reward_exception.h"
+#include "../../../librbr/include/core/policy/policy_exception.h"
+
+/**
+ * Solve a Dec-POMDP with GMAA* and check the optimal value against the expected one.
+ * @param	gmaa			The GMAA* solver.
+ * @param	decpomdp		The Dec-POMDP to solve.
+ * @param	expected		The expected optimal value.
+ * @param	policies		The resultant policy trees, one for each agent.
+ * @return	Return @code{true} if the solver succeeded and the value matched, @code{false} otherwise.
+ */
+static bool solve_gmaa_star(DecPOMDPGMAAStar &gmaa, DecPOMDP *decpomdp, double expected,
+		std::vector<PolicyTree *> &policies)
+{
+	try {
+		policies = gmaa.solve(decpomdp);
+	} catch (const CoreException &err) {
+		return false;
+	} catch (const StateException &err) {
+		return false;
+	} catch (const ActionException &err) {
+		return false;
+	} catch (const ObservationException &err) {
+		return false;
+	} catch (const StateTransitionException &err) {
+		return false;
+	} catch (const ObservationTransitionException &err) {
+		return false;
+	} catch (const RewardException &err) {
+		return false;
+	} catch (const PolicyException &err) {
+		return false;
+	}
+
+	return fabs(gmaa.get_value() - expected) < 0.0001;
+}
+
+int test_dec_pomdp()
+{
+	int numSuccesses = 0;
+	UnifiedFile file;
+
+	DecPOMDP *decpomdp = nullptr;
+
+	std::cout << "DecPOMDP: Loading 'dec_tiger_finite.dpomdp'...";
+	if (!file.load("resources/dec_pomdp/dec_tiger_finite.dpomdp")) {
+		try {
+			decpomdp = file.get_dec_pomdp();
+			std::cout << " Success." << std::endl;
+			numSuccesses++;
+		} catch (const CoreException &err) {
+			std::cout << " Failure." << std::endl;
+		}
+	} else {
+		std::cout << " Failure." << std::endl;
+	}
+
+	if (decpomdp == nullptr) {
+		return numSuccesses;
+	}
+
+	DecPOMDPGMAAStar gmaa;
+	std::vector<PolicyTree *> policies;
+
+	std::cout << "DecPOMDP: Solving 'dec_tiger_finite.dpomdp' (horizon 3) with DecPOMDPGMAAStar...";
+	if (solve_gmaa_star(gmaa, decpomdp, 5.19080, policies) && policies.size() == 2) {
+		std::cout << " Success." << std::endl;
+		numSuccesses++;
+	} else {
+		std::cout << " Failure." << std::endl;
+	}
+
+	std::cout << "DecPOMDP: Checking the first action of each agent's policy tree...";
+	bool listen = (policies.size() == 2);
+	for (PolicyTree *policy : policies) {
+		NamedAction *action = dynamic_cast<NamedAction *>(policy->get(std::vector<Observation *>()));
+		if (action == nullptr || action->get_name().compare("listen") != 0) {
+			listen = false;
+		}
+	}
+	if (listen) {
+		std::cout << " Success." << std::endl;
+		numSuccesses++;
+	} else {
+		std::cout << " Failure." << std::endl;
+	}
+
+	BeliefState uniform;
+	StatesMap *states = dynamic_cast<StatesMap *>(decpomdp->get_states());
+	for (auto s : *states) {
+		uniform.set(resolve(s), 1.0 / (double)states->get_num_states());
+	}
+
+	std::cout << "DecPOMDP: Evaluating the GMAA* joint policy with DecPOMDPPolicyEvaluation...";
+	try {
+		DecPOMDPPolicyEvaluation evaluation(decpomdp, 1);
+		evaluation.set_policies(policies);
+		if (fabs(evaluation.evaluate(uniform) - gmaa.get_value()) < 0.0001) {
+			std::cout << " Success." << std::endl;
+			numSuccesses++;
+		} else {
+			std::cout << " Failure." << std::endl;
+		}
+	} catch (const CoreException &err) {
+		std::cout << " Failure." << std::endl;
+	} catch (const PolicyException &err) {
+		std::cout << " Failure." << std::endl;
+	}
+
+	std::cout << "DecPOMDP: Re-evaluating after changing one agent's policy tree...";
+	try {
+		DecPOMDPPolicyEvaluation evaluation(decpomdp, 1);
+		evaluation.set_policies(policies);
+		evaluation.evaluate(uniform);
+		unsigned int numJointNodes = evaluation.get_num_joint_nodes();
+
+		// Make the first agent open the left door first, then re-evaluate only its new subtrees.
+		JointActionsMap *actions = dynamic_cast<JointActionsMap *>(decpomdp->get_actions());
+		policies[0]->set(std::vector<Observation *>(), actions->get(0, 1));
+		evaluation.set_policy(0, policies[0]);
+		double value = evaluation.evaluate(uniform);
+
+		DecPOMDPPolicyEvaluation fresh(decpomdp, 4);
+		fresh.set_policies(policies);
+
+		if (fabs(value - fresh.evaluate(uniform)) < 0.0001 && value < gmaa.get_value() &&
+				evaluation.get_num_joint_nodes() == numJointNodes + 1) {
+			std::cout << " Success." << std::endl;
+			numSuccesses++;
+		} else {
+			std::cout << " Failure." << std::endl;
+		}
+	} catch (const CoreException &err) {
+		std::cout << " Failure." << std::endl;
+	} catch (const PolicyException &err) {
+		std::cout << " Failure." << std::endl;
+	}
+
+	for (PolicyTree *policy : policies) {
+		delete policy;
+	}
+	policies.clear();
+
+	std::cout << "DecPOMDP: Solving 'dec_tiger_finite.dpomdp' (horizon 3) without incremental expansion...";
+	gmaa.set_incremental_expansion(false);
+	if (solve_gmaa_star(gmaa, decpomdp, 5.19080, policies)) {
+		std::cout << " Success." << std::endl;
+		numSuccesses++;
+	} else {
+		std::cout << " Failure." << std::endl;
+	}
+
+	for (PolicyTree *policy : policies) {
+		delete policy;
+	}
+	policies.clear();
+
+	std::cout << "DecPOMDP: Solving 'dec_tiger_finite.dpomdp' (horizon 2) with DecPOMDPGMAAStar...";
+	gmaa.set_incremental_expansion(true);
+	decpomdp->get_horizon()->set_horizon(2);
+	if (solve_gmaa_star(gmaa, decpomdp, -4.0, policies)) {
+		std::cout << " Success." << std::endl;
+		numSuccesses++;
+	} else {
+		std::cout << " Failure." << std::endl;
+	}
+
+	for (PolicyTree *policy : policies) {
+		delete policy;
+	}
+	policies.clear();
+
+	std::cout << "DecPOMDP: Solving 'dec_tiger_finite.dpomdp' (horizon 4) with DecPOMDPGMAAStar...";
+	decpomdp->get_horizon()->set_horizon(4);
+	if (solve_gmaa_star(gmaa, decpomdp, 4.80280, policies)) {
+		std::cout << " Success." << std::endl;
+		numSuccesses++;
+	} else {
+		std::cout << " Failure." << std::endl;
+	}
+
+	for (PolicyTree *policy : policies) {
+		delete policy;
+	}
+	policies.clear();
+
+	delete decpomdp;
+
+	return numSuccesses;
+}
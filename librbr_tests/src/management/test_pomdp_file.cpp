@@ -0,0 +1,284 @@
+/**
+ *  The MIT License (MIT)
+ *
+ *  Copyright (c) 2014 Kyle Hollins Wray, University of Massachusetts
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy of
+ *  this software and associated documentation files (the "Software"), to deal in
+ *  the Software without restriction, including without limitation the rights to
+ *  use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ *  the Software, and to permit persons to whom the Software is furnished to do so,
+ *  subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included in all
+ *  copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ *  FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ *  COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ *  IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ *  CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+
+#include "../../include/perform_tests.h"
+
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <cmath>
+#include <string>
+#include <vector>
+
+#include "../../../librbr/include/management/unified_file.h"
+#include "../../../librbr/include/management/pomdp_file.h"
+
+#include "../../../librbr/include/mdp/mdp.h"
+#include "../../../librbr/include/pomdp/pomdp.h"
+#include "../../../librbr/include/dec_pomdp/dec_pomdp.h"
+
+#include "../../../librbr/include/core/states/states_map.h"
+#include "../../../librbr/include/core/actions/actions_map.h"
+#include "../../../librbr/include/core/observations/observations_map.h"
+#include "../../../librbr/include/core/rewards/sa_rewards.h"
+#include "../../../librbr/include/core/rewards/sas_rewards.h"
+#include "../../../librbr/include/core/rewards/saso_rewards.h"
+
+#include "../../../librbr/include/core/state_transitions/state_transition_exception.h"
+#include "../../../librbr/include/core/observation_transitions/observation_transition_exception.h"
+
+#include "../../../librbr/include/core/core_exception.h"
+
+/**
+ * Count the statements of a saved file which begin with a keyword, and sum their values, i.e., the
+ * last item on each line.
+ * @param	filename	The name of the saved file.
+ * @param	keyword		The keyword, e.g., "T:".
+ * @param	count		The number of statements; this will be modified.
+ * @param	sum			The sum of the values; this will be modified.
+ * @return	Return @code{true} if a statement has a zero value, @code{false} otherwise.
+ */
+bool sum_statements(std::string filename, std::string keyword, unsigned int &count, double &sum)
+{
+	std::ifstream file(filename);
+	std::string line;
+
+	bool zero = false;
+	count = 0;
+	sum = 0.0;
+
+	while (std::getline(file, line)) {
+		if (line.compare(0, keyword.length(), keyword) != 0) {
+			continue;
+		}
+
+		double value = std::stod(line.substr(line.find_last_of(" ") + 1));
+		zero = zero || (value == 0.0);
+
+		count++;
+		sum += value;
+	}
+
+	return zero;
+}
+
+/**
+ * Count the non-zero state transitions, observation transitions, and rewards of a model, and sum them,
+ * restricting rewards to successor states and available observations.
+ * @param	mdp			The model.
+ * @param	counts		The number of non-zero values of T, O, and R; this will be modified.
+ * @param	sums		The sums of the values of T, O, and R; this will be modified.
+ */
+void sum_model(MDP *mdp, unsigned int counts[3], double sums[3])
+{
+	StatesMap *S = dynamic_cast<StatesMap *>(mdp->get_states());
+	ActionsMap *A = dynamic_cast<ActionsMap *>(mdp->get_actions());
+	StateTransitions *T = mdp->get_state_transitions();
+
+	POMDP *pomdp = dynamic_cast<POMDP *>(mdp);
+	Observations *Z = (pomdp != nullptr ? pomdp->get_observations() : nullptr);
+	ObservationTransitions *O = (pomdp != nullptr ? pomdp->get_observation_transitions() : nullptr);
+
+	SARewards *RSA = dynamic_cast<SARewards *>(mdp->get_rewards());
+	SASRewards *RSAS = dynamic_cast<SASRewards *>(mdp->get_rewards());
+	SASORewards *RSASO = dynamic_cast<SASORewards *>(mdp->get_rewards());
+
+	for (unsigned int i = 0; i < 3; i++) {
+		counts[i] = 0;
+		sums[i] = 0.0;
+	}
+
+	// Map objects without successor or available information fall back to every state or observation.
+	std::vector<State *> allStates;
+	for (auto state : *S) {
+		allStates.push_back(resolve(state));
+	}
+
+	std::vector<Observation *> allObservations;
+	if (Z != nullptr) {
+		for (auto observation : *dynamic_cast<ObservationsMap *>(Z)) {
+			allObservations.push_back(resolve(observation));
+		}
+	}
+
+	auto successors = [&](State *s, Action *a) -> const std::vector<State *> & {
+		try {
+			return T->successors(S, s, a);
+		} catch (const StateTransitionException &err) {
+			return allStates;
+		}
+	};
+
+	auto available = [&](Action *a, State *sp) -> const std::vector<Observation *> & {
+		try {
+			return O->available(Z, a, sp);
+		} catch (const ObservationTransitionException &err) {
+			return allObservations;
+		}
+	};
+
+	for (auto action : *A) {
+		Action *a = resolve(action);
+
+		for (auto state : *S) {
+			State *s = resolve(state);
+
+			if (RSA != nullptr && RSA->get(s, a) != 0.0) {
+				counts[2]++;
+				sums[2] += RSA->get(s, a);
+			}
+
+			for (State *sp : successors(s, a)) {
+				if (T->get(s, a, sp) != 0.0) {
+					counts[0]++;
+					sums[0] += T->get(s, a, sp);
+				}
+
+				if (RSA == nullptr && RSAS != nullptr && RSAS->get(s, a, sp) != 0.0) {
+					counts[2]++;
+					sums[2] += RSAS->get(s, a, sp);
+				} else if (RSAS == nullptr) {
+					for (Observation *z : available(a, sp)) {
+						if (RSASO->get(s, a, sp, z) != 0.0) {
+							counts[2]++;
+							sums[2] += RSASO->get(s, a, sp, z);
+						}
+					}
+				}
+			}
+
+			if (O == nullptr) {
+				continue;
+			}
+
+			for (Observation *z : available(a, s)) {
+				if (O->get(a, s, z) != 0.0) {
+					counts[1]++;
+					sums[1] += O->get(a, s, z);
+				}
+			}
+		}
+	}
+}
+
+/**
+ * Check that a saved file holds exactly the non-zero values of a model.
+ * @param	filename	The name of the saved file.
+ * @param	mdp			The model which was saved.
+ * @return	Return @code{true} if the file matches the model, @code{false} otherwise.
+ */
+bool check_saved_model(std::string filename, MDP *mdp)
+{
+	unsigned int counts[3];
+	double sums[3];
+	sum_model(mdp, counts, sums);
+
+	const char *keywords[3] = {"T:", "O:", "R:"};
+	for (unsigned int i = 0; i < 3; i++) {
+		unsigned int count = 0;
+		double sum = 0.0;
+		if (sum_statements(filename, keywords[i], count, sum) || count != counts[i] ||
+				std::fabs(sum - sums[i]) > 1e-9) {
+			return false;
+		}
+	}
+
+	return true;
+}
+
+int test_pomdp_file()
+{
+	int numSuccesses = 0;
+
+	UnifiedFile unifiedFile;
+	POMDPFile pomdpFile;
+
+	std::cout << "POMDPFile: Saving 'grid_world_infinite_horizon.mdp' as a Cassandra MDP...";
+
+	try {
+		if (unifiedFile.load("resources/mdp/grid_world_infinite_horizon.mdp")) {
+			throw CoreException();
+		}
+
+		MDP *mdp = unifiedFile.get_mdp();
+		pomdpFile.save_mdp(mdp, "tmp/test_pomdp_file.mdp");
+
+		if (check_saved_model("tmp/test_pomdp_file.mdp", mdp)) {
+			std::cout << " Success." << std::endl;
+			numSuccesses++;
+		} else {
+			std::cout << " Failure." << std::endl;
+		}
+
+		delete mdp;
+	} catch (const CoreException &err) {
+		std::cout << " Failure." << std::endl;
+	}
+
+	std::cout << "POMDPFile: Saving 'tiger_infinite.pomdp' as a Cassandra POMDP...";
+
+	try {
+		if (unifiedFile.load("resources/pomdp/tiger_infinite.pomdp")) {
+			throw CoreException();
+		}
+
+		POMDP *pomdp = unifiedFile.get_pomdp();
+		pomdpFile.save_pomdp(pomdp, "tmp/test_pomdp_file.pomdp", nullptr);
+
+		if (check_saved_model("tmp/test_pomdp_file.pomdp", pomdp)) {
+			std::cout << " Success." << std::endl;
+			numSuccesses++;
+		} else {
+			std::cout << " Failure." << std::endl;
+		}
+
+		delete pomdp;
+	} catch (const CoreException &err) {
+		std::cout << " Failure." << std::endl;
+	}
+
+	std::cout << "POMDPFile: Saving 'dec_tiger_finite.dpomdp' as a Dec-POMDP...";
+
+	try {
+		if (unifiedFile.load("resources/dec_pomdp/dec_tiger_finite.dpomdp")) {
+			throw CoreException();
+		}
+
+		DecPOMDP *decpomdp = unifiedFile.get_dec_pomdp();
+		pomdpFile.save_decpomdp(decpomdp, "tmp/test_pomdp_file.dpomdp", nullptr);
+
+		if (check_saved_model("tmp/test_pomdp_file.dpomdp", decpomdp)) {
+			std::cout << " Success." << std::endl;
+			numSuccesses++;
+		} else {
+			std::cout << " Failure." << std::endl;
+		}
+
+		delete decpomdp;
+	} catch (const CoreException &err) {
+		std::cout << " Failure." << std::endl;
+	}
+
+	return numSuccesses;
+}
@@ -0,0 +1,464 @@
+/**
+ *  The MIT License (MIT)
+ *
+ *  Copyright (c) 2014 Kyle Hollins Wray, University of Massachusetts
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy of
+ *  this software and associated documentation files (the "Software"), to deal in
+ *  the Software without restriction, including without limitation the rights to
+ *  use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ *  the Software, and to permit persons to whom the Software is furnished to do so,
+ *  subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included in all
+ *  copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ *  FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ *  COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ *  IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ *  CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+
+#include "../../include/perform_tests.h"
+
+#include <iostream>
+#include <fstream>
+#include <cmath>
+#include <string>
+#include <iterator>
+#include <vector>
+#include <algorithm>
+
+#include "../../../librbr/include/management/unified_file.h"
+#include "../../../librbr/include/management/raw_file.h"
+#include "../../../librbr/include/management/conversion.h"
+
+#include "../../../librbr/include/mdp/mdp.h"
+#include "../../../librbr/include/mdp/mdp_value_iteration.h"
+#include "../../../librbr/include/pomdp/pomdp.h"
+#include "../../../librbr/include/dec_pomdp/dec_pomdp.h"
+
+#include "../../../librbr/include/core/states/states_map.h"
+#include "../../../librbr/include/core/actions/actions_map.h"
+#include "../../../librbr/include/core/state_transitions/state_transitions_array.h"
+#include "../../../librbr/include/core/state_transitions/state_transitions_sparse_array.h"
+#include "../../../librbr/include/core/rewards/sas_rewards_array.h"
+#include "../../../librbr/include/core/observations/observations_map.h"
+#include "../../../librbr/include/core/observations/joint_observation.h"
+#include "../../../librbr/include/core/observations/joint_observations_map.h"
+#include "../../../librbr/include/core/actions/joint_action.h"
+#include "../../../librbr/include/core/actions/joint_actions_map.h"
+#include "../../../librbr/include/core/observation_transitions/observation_transitions_array.h"
+#include "../../../librbr/include/core/rewards/saso_rewards.h"
+
+#include "../../../librbr/include/core/core_exception.h"
+
+/**
+ * Order the joint actions or observations of a map by their mixed-radix index over the factors, with the
+ * first factor the most significant, as they are stored in raw Dec-POMDP files.
+ * @param	map		The joint actions or observations map.
+ * @return	The joint actions or observations in order.
+ */
+template <typename T, typename J, typename M>
+std::vector<T *> order_joint(M *map)
+{
+	std::vector<T *> result;
+
+	for (auto element : *map) {
+		J *joint = dynamic_cast<J *>(resolve(element));
+
+		unsigned int index = 0;
+		for (unsigned int i = 0; i < map->get_num_factors(); i++) {
+			const std::vector<T *> &factor = map->get_factor(i);
+			index = index * factor.size() + (std::find(factor.begin(), factor.end(), joint->get(i)) - factor.begin());
+		}
+
+		if (result.size() <= index) {
+			result.resize(index + 1, nullptr);
+		}
+		result[index] = joint;
+	}
+
+	return result;
+}
+
+int test_raw_file()
+{
+	int numSuccesses = 0;
+
+	UnifiedFile unifiedFile;
+	RawFile rawFile;
+
+	MDP *mdp = nullptr;
+	MDP *loadedMDP = nullptr;
+
+	std::cout << "RawFile: Saving 'grid_world_infinite_horizon.mdp' as a binary MDP...";
+
+	try {
+		if (unifiedFile.load("resources/mdp/grid_world_infinite_horizon.mdp")) {
+			throw CoreException();
+		}
+
+		MDP *mapMDP = unifiedFile.get_mdp();
+		mdp = convert_map_to_array(mapMDP);
+		delete mapMDP;
+
+		rawFile.save_binary_mdp(mdp, "tmp/test_raw_file.mdp_binary");
+
+		std::cout << " Success." << std::endl;
+		numSuccesses++;
+	} catch (const CoreException &err) {
+		std::cout << " Failure." << std::endl;
+	}
+
+	std::cout << "RawFile: Loading the memory-mapped binary MDP...";
+
+	try {
+		loadedMDP = rawFile.load_binary_mdp("tmp/test_raw_file.mdp_binary");
+
+		StatesMap *S = dynamic_cast<StatesMap *>(mdp->get_states());
+		ActionsMap *A = dynamic_cast<ActionsMap *>(mdp->get_actions());
+		StatesMap *loadedS = dynamic_cast<StatesMap *>(loadedMDP->get_states());
+		ActionsMap *loadedA = dynamic_cast<ActionsMap *>(loadedMDP->get_actions());
+
+		StateTransitionsArray *T = dynamic_cast<StateTransitionsArray *>(mdp->get_state_transitions());
+		StateTransitionsArray *loadedT = dynamic_cast<StateTransitionsArray *>(loadedMDP->get_state_transitions());
+		SASRewardsArray *R = dynamic_cast<SASRewardsArray *>(mdp->get_rewards());
+		SASRewardsArray *loadedR = dynamic_cast<SASRewardsArray *>(loadedMDP->get_rewards());
+
+		bool valid = (loadedS->get_num_states() == S->get_num_states() &&
+				loadedA->get_num_actions() == A->get_num_actions() &&
+				loadedT != nullptr && loadedR != nullptr &&
+				loadedR->get_min() == R->get_min() && loadedR->get_max() == R->get_max() &&
+				loadedMDP->get_horizon()->get_discount_factor() == mdp->get_horizon()->get_discount_factor());
+
+		// Every probability and reward must match, looked up through the states and actions.
+		for (unsigned int s = 0; valid && s < S->get_num_states(); s++) {
+			for (unsigned int a = 0; valid && a < A->get_num_actions(); a++) {
+				for (unsigned int sp = 0; valid && sp < S->get_num_states(); sp++) {
+					valid = (loadedT->get(loadedS->get(s), loadedA->get(a), loadedS->get(sp)) ==
+								T->get(S->get(s), A->get(a), S->get(sp)) &&
+							loadedR->get(loadedS->get(s), loadedA->get(a), loadedS->get(sp)) ==
+								R->get(S->get(s), A->get(a), S->get(sp)));
+				}
+			}
+		}
+
+		// The arrays point into the mapped file, so each must be aligned within it.
+		valid = valid && ((size_t)loadedT->get_state_transitions() % RAW_FILE_BINARY_ALIGNMENT == 0) &&
+				((size_t)loadedR->get_rewards() % RAW_FILE_BINARY_ALIGNMENT == 0);
+
+		if (valid) {
+			std::cout << " Success." << std::endl;
+			numSuccesses++;
+		} else {
+			std::cout << " Failure." << std::endl;
+		}
+	} catch (const CoreException &err) {
+		std::cout << " Failure." << std::endl;
+	}
+
+	std::cout << "RawFile: Solving the binary MDP with MDPValueIteration...";
+
+	try {
+		MDPValueIteration vi;
+		MDPValueIteration loadedVI;
+
+		delete vi.solve(mdp);
+		delete loadedVI.solve(loadedMDP);
+
+		StatesMap *S = dynamic_cast<StatesMap *>(mdp->get_states());
+		StatesMap *loadedS = dynamic_cast<StatesMap *>(loadedMDP->get_states());
+
+		bool valid = true;
+		for (unsigned int s = 0; valid && s < S->get_num_states(); s++) {
+			valid = (std::fabs(vi.get_V().at(S->get(s)) - loadedVI.get_V().at(loadedS->get(s))) < 1e-6);
+		}
+
+		if (valid) {
+			std::cout << " Success." << std::endl;
+			numSuccesses++;
+		} else {
+			std::cout << " Failure." << std::endl;
+		}
+	} catch (const std::exception &err) {
+		std::cout << " Failure." << std::endl;
+	}
+
+	if (loadedMDP != nullptr) {
+		delete loadedMDP;
+		loadedMDP = nullptr;
+	}
+
+	std::cout << "RawFile: Saving and loading 'grid_world_infinite_horizon.mdp' as a sparse raw MDP...";
+
+	try {
+		rawFile.save_sparse_raw_mdp(mdp, "tmp/test_raw_file_sparse.mdp_raw");
+		loadedMDP = rawFile.load_raw_mdp("tmp/test_raw_file_sparse.mdp_raw");
+
+		StatesMap *S = dynamic_cast<StatesMap *>(mdp->get_states());
+		ActionsMap *A = dynamic_cast<ActionsMap *>(mdp->get_actions());
+		StatesMap *loadedS = dynamic_cast<StatesMap *>(loadedMDP->get_states());
+		ActionsMap *loadedA = dynamic_cast<ActionsMap *>(loadedMDP->get_actions());
+
+		StateTransitions *T = mdp->get_state_transitions();
+		StateTransitionsSparseArray *loadedT =
+				dynamic_cast<StateTransitionsSparseArray *>(loadedMDP->get_state_transitions());
+		SASRewards *R = dynamic_cast<SASRewards *>(mdp->get_rewards());
+		SASRewards *loadedR = dynamic_cast<SASRewards *>(loadedMDP->get_rewards());
+
+		bool valid = (loadedS->get_num_states() == S->get_num_states() &&
+				loadedA->get_num_actions() == A->get_num_actions() &&
+				loadedT != nullptr && loadedR != nullptr &&
+				loadedMDP->get_horizon()->get_discount_factor() == mdp->get_horizon()->get_discount_factor());
+
+		// Every probability must match, and only the nonzero ones are stored, along with their rewards.
+		unsigned int numNonzero = 0;
+
+		for (unsigned int s = 0; valid && s < S->get_num_states(); s++) {
+			for (unsigned int a = 0; valid && a < A->get_num_actions(); a++) {
+				for (unsigned int sp = 0; valid && sp < S->get_num_states(); sp++) {
+					double p = T->get(S->get(s), A->get(a), S->get(sp));
+
+					valid = (loadedT->get(loadedS->get(s), loadedA->get(a), loadedS->get(sp)) == p);
+					if (p > 0.0) {
+						valid = valid && (loadedR->get(loadedS->get(s), loadedA->get(a), loadedS->get(sp)) ==
+								R->get(S->get(s), A->get(a), S->get(sp)));
+						numNonzero++;
+					}
+				}
+			}
+		}
+
+		valid = valid && (loadedT->get_num_nonzero() == numNonzero);
+
+		if (valid) {
+			std::cout << " Success." << std::endl;
+			numSuccesses++;
+		} else {
+			std::cout << " Failure." << std::endl;
+		}
+	} catch (const CoreException &err) {
+		std::cout << " Failure." << std::endl;
+	}
+
+	std::cout << "RawFile: Solving the sparse raw MDP with MDPValueIteration...";
+
+	try {
+		MDPValueIteration vi;
+		MDPValueIteration loadedVI;
+
+		delete vi.solve(mdp);
+		delete loadedVI.solve(loadedMDP);
+
+		StatesMap *S = dynamic_cast<StatesMap *>(mdp->get_states());
+		StatesMap *loadedS = dynamic_cast<StatesMap *>(loadedMDP->get_states());
+
+		bool valid = true;
+		for (unsigned int s = 0; valid && s < S->get_num_states(); s++) {
+			valid = (std::fabs(vi.get_V().at(S->get(s)) - loadedVI.get_V().at(loadedS->get(s))) < 1e-6);
+		}
+
+		if (valid) {
+			std::cout << " Success." << std::endl;
+			numSuccesses++;
+		} else {
+			std::cout << " Failure." << std::endl;
+		}
+	} catch (const std::exception &err) {
+		std::cout << " Failure." << std::endl;
+	}
+
+	if (mdp != nullptr) {
+		delete mdp;
+	}
+	if (loadedMDP != nullptr) {
+		delete loadedMDP;
+	}
+
+	std::cout << "RawFile: Rejecting a binary MDP with the wrong version...";
+
+	// Copy the saved file, but change the version which follows the magic bytes.
+	std::ifstream original("tmp/test_raw_file.mdp_binary", std::ios::binary);
+	std::string contents((std::istreambuf_iterator<char>(original)), std::istreambuf_iterator<char>());
+	original.close();
+
+	if (contents.size() > sizeof(RawFileBinaryHeader)) {
+		contents[8] = (char)(RAW_FILE_BINARY_VERSION + 1);
+	}
+
+	std::ofstream corrupt("tmp/test_raw_file_corrupt.mdp_binary", std::ios::binary);
+	corrupt.write(contents.data(), contents.size());
+	corrupt.close();
+
+	try {
+		delete rawFile.load_binary_mdp("tmp/test_raw_file_corrupt.mdp_binary");
+		std::cout << " Failure." << std::endl;
+	} catch (const CoreException &err) {
+		std::cout << " Success." << std::endl;
+		numSuccesses++;
+	}
+
+	std::cout << "RawFile: Saving and loading 'hallway.pomdp' as a raw POMDP...";
+
+	POMDP *pomdp = nullptr;
+	POMDP *loadedPOMDP = nullptr;
+
+	try {
+		if (unifiedFile.load("resources/pomdp/hallway.pomdp")) {
+			throw CoreException();
+		}
+		pomdp = unifiedFile.get_pomdp();
+
+		rawFile.save_raw_pomdp(pomdp, "tmp/test_raw_file.pomdp_raw");
+		loadedPOMDP = rawFile.load_raw_pomdp("tmp/test_raw_file.pomdp_raw");
+
+		// The states, actions, and observations are saved in the order of iteration, and loaded by index.
+		std::vector<State *> S;
+		for (auto state : *dynamic_cast<StatesMap *>(pomdp->get_states())) {
+			S.push_back(resolve(state));
+		}
+		std::vector<Action *> A;
+		for (auto action : *dynamic_cast<ActionsMap *>(pomdp->get_actions())) {
+			A.push_back(resolve(action));
+		}
+		std::vector<Observation *> Z;
+		for (auto observation : *dynamic_cast<ObservationsMap *>(pomdp->get_observations())) {
+			Z.push_back(resolve(observation));
+		}
+
+		StatesMap *loadedS = dynamic_cast<StatesMap *>(loadedPOMDP->get_states());
+		ActionsMap *loadedA = dynamic_cast<ActionsMap *>(loadedPOMDP->get_actions());
+		ObservationsMap *loadedZ = dynamic_cast<ObservationsMap *>(loadedPOMDP->get_observations());
+
+		StateTransitions *T = pomdp->get_state_transitions();
+		ObservationTransitions *O = pomdp->get_observation_transitions();
+		SASORewards *R = dynamic_cast<SASORewards *>(pomdp->get_rewards());
+		StateTransitionsArray *loadedT = dynamic_cast<StateTransitionsArray *>(loadedPOMDP->get_state_transitions());
+		ObservationTransitionsArray *loadedO =
+				dynamic_cast<ObservationTransitionsArray *>(loadedPOMDP->get_observation_transitions());
+		SASORewards *loadedR = dynamic_cast<SASORewards *>(loadedPOMDP->get_rewards());
+
+		bool valid = (loadedS->get_num_states() == S.size() && loadedA->get_num_actions() == A.size() &&
+				loadedZ->get_num_observations() == Z.size() &&
+				loadedT != nullptr && loadedO != nullptr && loadedR != nullptr &&
+				loadedPOMDP->get_horizon()->get_discount_factor() == pomdp->get_horizon()->get_discount_factor());
+
+		for (unsigned int s = 0; valid && s < S.size(); s++) {
+			for (unsigned int a = 0; valid && a < A.size(); a++) {
+				for (unsigned int sp = 0; valid && sp < S.size(); sp++) {
+					valid = (loadedT->get(loadedS->get(s), loadedA->get(a), loadedS->get(sp)) ==
+							(float)T->get(S[s], A[a], S[sp]));
+
+					for (unsigned int z = 0; valid && z < Z.size(); z++) {
+						valid = (loadedR->get(loadedS->get(s), loadedA->get(a), loadedS->get(sp), loadedZ->get(z)) ==
+								(float)R->get(S[s], A[a], S[sp], Z[z]));
+					}
+				}
+
+				for (unsigned int z = 0; valid && z < Z.size(); z++) {
+					valid = (loadedO->get(loadedA->get(a), loadedS->get(s), loadedZ->get(z)) ==
+							(float)O->get(A[a], S[s], Z[z]));
+				}
+			}
+		}
+
+		if (valid) {
+			std::cout << " Success." << std::endl;
+			numSuccesses++;
+		} else {
+			std::cout << " Failure." << std::endl;
+		}
+	} catch (const CoreException &err) {
+		std::cout << " Failure." << std::endl;
+	}
+
+	if (pomdp != nullptr) {
+		delete pomdp;
+	}
+	if (loadedPOMDP != nullptr) {
+		delete loadedPOMDP;
+	}
+
+	std::cout << "RawFile: Saving and loading 'dec_tiger_finite.dpomdp' as a raw Dec-POMDP...";
+
+	DecPOMDP *decpomdp = nullptr;
+	DecPOMDP *loadedDecPOMDP = nullptr;
+
+	try {
+		if (unifiedFile.load("resources/dec_pomdp/dec_tiger_finite.dpomdp")) {
+			throw CoreException();
+		}
+		decpomdp = unifiedFile.get_dec_pomdp();
+
+		rawFile.save_raw_decpomdp(decpomdp, "tmp/test_raw_file.dpomdp_raw");
+		loadedDecPOMDP = rawFile.load_raw_decpomdp("tmp/test_raw_file.dpomdp_raw");
+
+		std::vector<State *> S;
+		for (auto state : *dynamic_cast<StatesMap *>(decpomdp->get_states())) {
+			S.push_back(resolve(state));
+		}
+		std::vector<Action *> A = order_joint<Action, JointAction>(
+				dynamic_cast<JointActionsMap *>(decpomdp->get_actions()));
+		std::vector<Observation *> Z = order_joint<Observation, JointObservation>(
+				dynamic_cast<JointObservationsMap *>(decpomdp->get_observations()));
+
+		StatesMap *loadedS = dynamic_cast<StatesMap *>(loadedDecPOMDP->get_states());
+		std::vector<Action *> loadedA = order_joint<Action, JointAction>(
+				dynamic_cast<JointActionsMap *>(loadedDecPOMDP->get_actions()));
+		std::vector<Observation *> loadedZ = order_joint<Observation, JointObservation>(
+				dynamic_cast<JointObservationsMap *>(loadedDecPOMDP->get_observations()));
+
+		StateTransitions *T = decpomdp->get_state_transitions();
+		ObservationTransitions *O = decpomdp->get_observation_transitions();
+		SASORewards *R = dynamic_cast<SASORewards *>(decpomdp->get_rewards());
+		StateTransitions *loadedT = loadedDecPOMDP->get_state_transitions();
+		ObservationTransitions *loadedO = loadedDecPOMDP->get_observation_transitions();
+		SASORewards *loadedR = dynamic_cast<SASORewards *>(loadedDecPOMDP->get_rewards());
+
+		bool valid = (loadedDecPOMDP->get_agents()->get_num_agents() == decpomdp->get_agents()->get_num_agents() &&
+				loadedS->get_num_states() == S.size() && loadedA.size() == A.size() && loadedZ.size() == Z.size() &&
+				loadedR != nullptr &&
+				loadedDecPOMDP->get_horizon()->get_horizon() == decpomdp->get_horizon()->get_horizon());
+
+		for (unsigned int s = 0; valid && s < S.size(); s++) {
+			for (unsigned int a = 0; valid && a < A.size(); a++) {
+				for (unsigned int sp = 0; valid && sp < S.size(); sp++) {
+					valid = (loadedT->get(loadedS->get(s), loadedA[a], loadedS->get(sp)) ==
+							(float)T->get(S[s], A[a], S[sp]));
+
+					for (unsigned int z = 0; valid && z < Z.size(); z++) {
+						valid = (loadedR->get(loadedS->get(s), loadedA[a], loadedS->get(sp), loadedZ[z]) ==
+								(float)R->get(S[s], A[a], S[sp], Z[z]));
+					}
+				}
+
+				for (unsigned int z = 0; valid && z < Z.size(); z++) {
+					valid = (loadedO->get(loadedA[a], loadedS->get(s), loadedZ[z]) ==
+							(float)O->get(A[a], S[s], Z[z]));
+				}
+			}
+		}
+
+		if (valid) {
+			std::cout << " Success." << std::endl;
+			numSuccesses++;
+		} else {
+			std::cout << " Failure." << std::endl;
+		}
+	} catch (const CoreException &err) {
+		std::cout << " Failure." << std::endl;
+	}
+
+	if (decpomdp != nullptr) {
+		delete decpomdp;
+	}
+	if (loadedDecPOMDP != nullptr) {
+		delete loadedDecPOMDP;
+	}
+
+	return numSuccesses;
+}
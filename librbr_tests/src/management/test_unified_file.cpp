@@ -25,8 +25,84 @@
 #include "../../include/perform_tests.h"
 
 #include <iostream>
+#include <fstream>
+#include <string>
+#include <vector>
+#include <chrono>
 
 #include "../../../librbr/include/management/unified_file.h"
+#include "../../../librbr/include/core/states/state_utilities.h"
+#include "../../../librbr/include/core/actions/action_utilities.h"
+#include "../../../librbr/include/core/observations/observation_utilities.h"
+
+/**
+ * The number of states in the POMDP used to benchmark loading.
+ */
+#define UNIFIED_FILE_BENCHMARK_STATES 200
+
+/**
+ * The number of actions in the POMDP used to benchmark loading.
+ */
+#define UNIFIED_FILE_BENCHMARK_ACTIONS 4
+
+/**
+ * The number of observations in the POMDP used to benchmark loading.
+ */
+#define UNIFIED_FILE_BENCHMARK_OBSERVATIONS 9
+
+/**
+ * Write a large POMDP which uses each form of the T, O, and R statements, with the state
+ * transitions as matrices, the observation transitions as vectors, and the rewards as single
+ * values for every third successor.
+ * @param	filename	The name of the file to write.
+ * @return	The number of bytes written.
+ */
+long write_unified_file_benchmark(std::string filename)
+{
+	std::ofstream file(filename);
+
+	unsigned int n = UNIFIED_FILE_BENCHMARK_STATES;
+	unsigned int m = UNIFIED_FILE_BENCHMARK_ACTIONS;
+	unsigned int z = UNIFIED_FILE_BENCHMARK_OBSERVATIONS;
+
+	file << "discount: 0.95" << std::endl;
+	file << "values: reward" << std::endl;
+	file << "states: " << n << std::endl;
+	file << "actions: " << m << std::endl;
+	file << "observations: " << z << std::endl << std::endl;
+
+	std::string stay = "0.5";
+	std::string move = std::to_string(0.5 / (n - 1));
+
+	for (unsigned int a = 0; a < m; a++) {
+		file << "T: " << a << std::endl;
+		for (unsigned int s = 0; s < n; s++) {
+			for (unsigned int sp = 0; sp < n; sp++) {
+				file << (s == sp ? stay : move) << (sp + 1 < n ? " " : "\n");
+			}
+		}
+		file << std::endl;
+	}
+
+	for (unsigned int a = 0; a < m; a++) {
+		for (unsigned int sp = 0; sp < n; sp++) {
+			file << "O: " << a << " : " << sp << std::endl;
+			for (unsigned int o = 0; o < z; o++) {
+				file << (o == sp % z ? "0.92" : "0.01") << (o + 1 < z ? " " : "\n");
+			}
+		}
+	}
+
+	for (unsigned int a = 0; a < m; a++) {
+		for (unsigned int s = 0; s < n; s++) {
+			for (unsigned int sp = 0; sp < n; sp += 3) {
+				file << "R: " << a << " : " << s << " : " << sp << " : " << ((int)(a * n + s) - (int)sp) << ".25" << std::endl;
+			}
+		}
+	}
+
+	return (long)file.tellp();
+}
 
 int test_unified_file()
 {
@@ -193,5 +269,198 @@ int test_unified_file()
 		std::cout << " Failure." << std::endl;
 	}
 
+	std::cout << "UnifiedFile: 'test_21.mdp' (Check Result)...";
+	if (!file.load("resources/unified_file/test_21.mdp")) {
+		MDP *mdp = file.get_mdp();
+		StatesMap *S = dynamic_cast<StatesMap *>(mdp->get_states());
+		ActionsMap *A = dynamic_cast<ActionsMap *>(mdp->get_actions());
+
+		const std::vector<Action *> &available = A->available(find_state(S, "s2"));
+
+		if (A->available(find_state(S, "s1")).size() == 3 && available.size() == 1 &&
+				available[0] == find_action(A, "stay")) {
+			std::cout << " Success." << std::endl;
+			numSuccesses++;
+		} else {
+			std::cout << " Failure." << std::endl;
+		}
+
+		delete mdp;
+	} else {
+		std::cout << " Failure." << std::endl;
+	}
+
+	std::cout << "UnifiedFile: 'test_22.mdp' (Expecting Error)...\n\t";
+	if (file.load("resources/unified_file/test_22.mdp")) {
+		std::cout << "\tSuccess." << std::endl;
+		numSuccesses++;
+	} else {
+		std::cout << "\tFailure." << std::endl;
+	}
+
+	std::cout << "UnifiedFile: 'test_23.mdp' (Check Result)...";
+	if (!file.load("resources/unified_file/test_23.mdp")) {
+		MDP *mdp = file.get_mdp();
+		StatesMap *S = dynamic_cast<StatesMap *>(mdp->get_states());
+		ActionsMap *A = dynamic_cast<ActionsMap *>(mdp->get_actions());
+		FactoredStateTransitions *T = dynamic_cast<FactoredStateTransitions *>(mdp->get_state_transitions());
+
+		State *leftHigh = find_state(S, "left high");
+		Action *move = find_action(A, "move");
+
+		if (T != nullptr && T->get_parents(0).size() == 2 && T->get_parents(1).size() == 1 &&
+				T->get_num_parameters() == 3 * 6 * 3 + 2 * 2 * 2 &&
+				T->get(leftHigh, move, find_state(S, "middle low")) == 0.4 &&
+				T->get(find_state(S, "middle high"), move, find_state(S, "right high")) == 0.4 &&
+				T->get(find_state(S, "middle low"), find_action(A, "charge"), find_state(S, "middle high")) == 1.0 &&
+				T->successors(S, leftHigh, move).size() == 4) {
+			std::cout << " Success." << std::endl;
+			numSuccesses++;
+		} else {
+			std::cout << " Failure." << std::endl;
+		}
+
+		delete mdp;
+	} else {
+		std::cout << " Failure." << std::endl;
+	}
+
+	std::cout << "UnifiedFile: 'test_23.mdp' (No State Enumeration)...";
+	if (!file.load("resources/unified_file/test_23.mdp")) {
+		MDP *mdp = file.get_mdp();
+		FactoredStatesMap *S = dynamic_cast<FactoredStatesMap *>(mdp->get_states());
+
+		// Neither the factored transitions nor the wildcard reward should create every factored state.
+		if (S != nullptr && S->get_num_created() < S->get_num_states()) {
+			std::cout << " Success." << std::endl;
+			numSuccesses++;
+		} else {
+			std::cout << " Failure." << std::endl;
+		}
+
+		delete mdp;
+	} else {
+		std::cout << " Failure." << std::endl;
+	}
+
+	std::cout << "UnifiedFile: Loading a large POMDP with 1 thread...";
+	std::cout.flush();
+
+	long numBytes = write_unified_file_benchmark("tmp/test_unified_file_benchmark.pomdp");
+
+	file.set_num_threads(1);
+
+	std::chrono::steady_clock::time_point begin = std::chrono::steady_clock::now();
+	bool loadError = file.load("tmp/test_unified_file_benchmark.pomdp");
+	std::chrono::steady_clock::time_point end = std::chrono::steady_clock::now();
+
+	POMDP *pomdp = nullptr;
+	if (!loadError) {
+		pomdp = file.get_pomdp();
+	}
+
+	if (pomdp != nullptr) {
+		double seconds = std::chrono::duration<double>(end - begin).count();
+
+		StatesMap *S = dynamic_cast<StatesMap *>(pomdp->get_states());
+		ActionsMap *A = dynamic_cast<ActionsMap *>(pomdp->get_actions());
+		ObservationsMap *Z = dynamic_cast<ObservationsMap *>(pomdp->get_observations());
+		SASRewards *R = dynamic_cast<SASRewards *>(pomdp->get_rewards());
+
+		State *s7 = find_state(S, "7");
+		State *s9 = find_state(S, "9");
+		Action *a2 = find_action(A, "2");
+
+		if (S->get_num_states() == UNIFIED_FILE_BENCHMARK_STATES &&
+				A->get_num_actions() == UNIFIED_FILE_BENCHMARK_ACTIONS &&
+				Z->get_num_observations() == UNIFIED_FILE_BENCHMARK_OBSERVATIONS &&
+				pomdp->get_state_transitions()->get(s7, a2, s7) == 0.5 &&
+				pomdp->get_observation_transitions()->get(a2, s9, find_observation(Z, "0")) == 0.92 &&
+				R->get(s7, a2, s9) == 398.25 && R->get(s9, a2, s7) == 0.0) {
+			std::cout << " Success. (" << (numBytes / 1000000.0 / seconds) << " MB/s)" << std::endl;
+			numSuccesses++;
+		} else {
+			std::cout << " Failure." << std::endl;
+		}
+	} else {
+		std::cout << " Failure." << std::endl;
+	}
+
+	std::cout << "UnifiedFile: Loading a large POMDP with 4 threads...";
+	std::cout.flush();
+
+	file.set_num_threads(4);
+
+	begin = std::chrono::steady_clock::now();
+	loadError = file.load("tmp/test_unified_file_benchmark.pomdp");
+	end = std::chrono::steady_clock::now();
+
+	POMDP *parallelPOMDP = nullptr;
+	if (!loadError) {
+		parallelPOMDP = file.get_pomdp();
+	}
+
+	if (pomdp != nullptr && parallelPOMDP != nullptr) {
+		double seconds = std::chrono::duration<double>(end - begin).count();
+
+		// Every value must match the sequential load, since the chunks are merged in order.
+		std::vector<State *> states[2];
+		std::vector<Action *> actions[2];
+		std::vector<Observation *> observations[2];
+
+		POMDP *pomdps[2] = {pomdp, parallelPOMDP};
+		for (unsigned int k = 0; k < 2; k++) {
+			StatesMap *S = dynamic_cast<StatesMap *>(pomdps[k]->get_states());
+			ActionsMap *A = dynamic_cast<ActionsMap *>(pomdps[k]->get_actions());
+			ObservationsMap *Z = dynamic_cast<ObservationsMap *>(pomdps[k]->get_observations());
+
+			for (unsigned int i = 0; i < UNIFIED_FILE_BENCHMARK_STATES; i++) {
+				states[k].push_back(find_state(S, std::to_string(i)));
+			}
+			for (unsigned int i = 0; i < UNIFIED_FILE_BENCHMARK_ACTIONS; i++) {
+				actions[k].push_back(find_action(A, std::to_string(i)));
+			}
+			for (unsigned int i = 0; i < UNIFIED_FILE_BENCHMARK_OBSERVATIONS; i++) {
+				observations[k].push_back(find_observation(Z, std::to_string(i)));
+			}
+		}
+
+		SASRewards *R[2] = {dynamic_cast<SASRewards *>(pomdp->get_rewards()),
+				dynamic_cast<SASRewards *>(parallelPOMDP->get_rewards())};
+
+		bool valid = true;
+		for (unsigned int a = 0; valid && a < UNIFIED_FILE_BENCHMARK_ACTIONS; a++) {
+			for (unsigned int s = 0; valid && s < UNIFIED_FILE_BENCHMARK_STATES; s++) {
+				for (unsigned int sp = 0; valid && sp < UNIFIED_FILE_BENCHMARK_STATES; sp++) {
+					valid = (pomdp->get_state_transitions()->get(states[0][s], actions[0][a], states[0][sp]) ==
+								parallelPOMDP->get_state_transitions()->get(states[1][s], actions[1][a], states[1][sp]) &&
+							R[0]->get(states[0][s], actions[0][a], states[0][sp]) ==
+								R[1]->get(states[1][s], actions[1][a], states[1][sp]));
+				}
+
+				for (unsigned int z = 0; valid && z < UNIFIED_FILE_BENCHMARK_OBSERVATIONS; z++) {
+					valid = (pomdp->get_observation_transitions()->get(actions[0][a], states[0][s], observations[0][z]) ==
+							parallelPOMDP->get_observation_transitions()->get(actions[1][a], states[1][s], observations[1][z]));
+				}
+			}
+		}
+
+		if (valid) {
+			std::cout << " Success. (" << (numBytes / 1000000.0 / seconds) << " MB/s)" << std::endl;
+			numSuccesses++;
+		} else {
+			std::cout << " Failure." << std::endl;
+		}
+	} else {
+		std::cout << " Failure." << std::endl;
+	}
+
+	if (pomdp != nullptr) {
+		delete pomdp;
+	}
+	if (parallelPOMDP != nullptr) {
+		delete parallelPOMDP;
+	}
+
 	return numSuccesses;
 }
@@ -25,8 +25,17 @@
 #include "../../include/perform_tests.h"
 
 #include <iostream>
+#include <fstream>
+#include <cstdio>
+#include <cmath>
+#include <thread>
+#include <vector>
 
 #include "../../../librbr/include/management/unified_file.h"
+#include "../../../librbr/include/management/raw_file.h"
+#include "../../../librbr/include/management/fingerprint.h"
+#include "../../../librbr/include/management/policy_cache.h"
+#include "../../../librbr/include/management/conversion.h"
 
 #include "../../../librbr/include/mdp/mdp.h"
 #include "../../../librbr/include/mdp/mdp_value_iteration.h"
@@ -179,6 +188,385 @@ int test_mdp()
 	}
 	policyMap = nullptr;
 
+	std::cout << "MDP: Solving 'grid_world_infinite_horizon.mdp' with MDPValueIteration out-of-core...";
+
+	try {
+		RawFile rawFile;
+		rawFile.save_streamed_mdp(mdp, "tmp/test_mdp_value_iteration.mdp_streamed");
+
+		policyMap = vi.solve(mdp);
+		std::unordered_map<State *, double> V = vi.get_V();
+		delete policyMap;
+
+		StatesMap *S = dynamic_cast<StatesMap *>(mdp->get_states());
+		ActionsMap *A = dynamic_cast<ActionsMap *>(mdp->get_actions());
+		policyMap = vi.solve_out_of_core("tmp/test_mdp_value_iteration.mdp_streamed", S, A);
+
+		// The file stores floats, and the values converge differently, so they only match within a tolerance.
+		bool valid = (vi.get_V().size() == V.size());
+		for (auto state : *S) {
+			State *s = resolve(state);
+			valid = valid && (policyMap->get(s) != nullptr) && (std::fabs(vi.get_V().at(s) - V[s]) < 0.01);
+		}
+
+		if (valid) {
+			std::cout << " Success." << std::endl;
+			numSuccesses++;
+		} else {
+			std::cout << " Failure." << std::endl;
+		}
+	} catch (const CoreException &err) {
+		std::cout << " Failure." << std::endl;
+	} catch (const PolicyException &err) {
+		std::cout << " Failure." << std::endl;
+	}
+
+	if (policyMap != nullptr) {
+		delete policyMap;
+	}
+	policyMap = nullptr;
+
+	std::cout << "MDP: Fingerprinting 'grid_world_infinite_horizon.mdp' and 'grid_world_finite_horizon.mdp'...";
+
+	MDP *otherMDP = nullptr;
+
+	try {
+		// The same model loaded again has new objects at new addresses, but the same fingerprint.
+		if (file.load("resources/mdp/grid_world_infinite_horizon.mdp")) {
+			throw CoreException();
+		}
+		otherMDP = file.get_mdp();
+		bool same = (fingerprint_model(mdp) == fingerprint_model(otherMDP));
+		delete otherMDP;
+
+		if (file.load("resources/mdp/grid_world_finite_horizon.mdp")) {
+			throw CoreException();
+		}
+		otherMDP = file.get_mdp();
+		bool different = (fingerprint_model(mdp) != fingerprint_model(otherMDP));
+		delete otherMDP;
+		otherMDP = nullptr;
+
+		if (same && different) {
+			std::cout << " Success." << std::endl;
+			numSuccesses++;
+		} else {
+			std::cout << " Failure." << std::endl;
+		}
+	} catch (const CoreException &err) {
+		std::cout << " Failure." << std::endl;
+	}
+
+	std::cout << "MDP: Solving 'grid_world_infinite_horizon.mdp' with MDPValueIteration and a PolicyCache...";
+
+	PolicyCache cache("tmp");
+	PolicyMap *cachedPolicyMap = nullptr;
+
+	try {
+		std::string filename = cache.get_filename(fingerprint_model(mdp), "MDPValueIteration epsilon=0.001");
+		std::remove(filename.c_str());
+
+		// The first solve misses and saves the policy. The second is a hit, so no values are computed.
+		vi.set_policy_cache(&cache);
+		policyMap = vi.solve(mdp);
+		bool miss = (!vi.get_V().empty() && std::ifstream(filename).is_open());
+
+		cachedPolicyMap = vi.solve(mdp);
+		bool hit = vi.get_V().empty();
+
+		bool valid = (miss && hit);
+		StatesMap *S = dynamic_cast<StatesMap *>(mdp->get_states());
+		for (auto state : *S) {
+			valid = valid && (policyMap->get(resolve(state)) == cachedPolicyMap->get(resolve(state)));
+		}
+
+		if (valid) {
+			std::cout << " Success." << std::endl;
+			numSuccesses++;
+		} else {
+			std::cout << " Failure." << std::endl;
+		}
+	} catch (const CoreException &err) {
+		std::cout << " Failure." << std::endl;
+	} catch (const PolicyException &err) {
+		std::cout << " Failure." << std::endl;
+	}
+
+	vi.set_policy_cache(nullptr);
+
+	if (policyMap != nullptr) {
+		delete policyMap;
+	}
+	policyMap = nullptr;
+
+	if (cachedPolicyMap != nullptr) {
+		delete cachedPolicyMap;
+	}
+	cachedPolicyMap = nullptr;
+
+	std::cout << "MDP: Solving 'grid_world_infinite_horizon.mdp' as arrays with MDPValueIteration...";
+
+	MDP *arrayMDP = nullptr;
+
+	try {
+		arrayMDP = convert_map_to_array(mdp);
+
+		MDPValueIteration arrayVI;
+		policyMap = vi.solve(mdp);
+		PolicyMap *arrayPolicyMap = arrayVI.solve(arrayMDP);
+
+		// The converted states and actions are indexed in the order of the original sets.
+		StatesMap *S = dynamic_cast<StatesMap *>(mdp->get_states());
+		ActionsMap *A = dynamic_cast<ActionsMap *>(mdp->get_actions());
+		StatesMap *arrayS = dynamic_cast<StatesMap *>(arrayMDP->get_states());
+
+		std::unordered_map<Action *, unsigned int> actionIndexes;
+		for (auto action : *A) {
+			unsigned int index = actionIndexes.size();
+			actionIndexes[resolve(action)] = index;
+		}
+
+		bool valid = (arrayVI.get_V().size() == S->get_num_states());
+		for (unsigned int i = 0; valid && i < S->get_num_states(); i++) {
+			State *s = S->get_state(i);
+			State *arrayState = arrayS->get_state(i);
+			IndexedAction *arrayAction = dynamic_cast<IndexedAction *>(arrayPolicyMap->get(arrayState));
+
+			valid = (std::fabs(vi.get_V().at(s) - arrayVI.get_V().at(arrayState)) < 1e-6) &&
+					(arrayAction != nullptr) && (arrayAction->get_index() == actionIndexes[policyMap->get(s)]);
+		}
+
+		delete arrayPolicyMap;
+
+		if (valid) {
+			std::cout << " Success." << std::endl;
+			numSuccesses++;
+		} else {
+			std::cout << " Failure." << std::endl;
+		}
+	} catch (const CoreException &err) {
+		std::cout << " Failure." << std::endl;
+	} catch (const PolicyException &err) {
+		std::cout << " Failure." << std::endl;
+	}
+
+	if (policyMap != nullptr) {
+		delete policyMap;
+	}
+	policyMap = nullptr;
+
+	if (arrayMDP != nullptr) {
+		delete arrayMDP;
+	}
+	arrayMDP = nullptr;
+
+	std::cout << "MDP: Solving 'grid_world_infinite_horizon.mdp' as arrays with MDPPolicyIteration (Exact)...";
+
+	try {
+		arrayMDP = convert_map_to_array(mdp);
+
+		MDPPolicyIteration arrayPIExact;
+		policyMap = piExact.solve(mdp);
+		PolicyMap *arrayPolicyMap = arrayPIExact.solve(arrayMDP);
+
+		// The converted states and actions are indexed in the order of the original sets.
+		StatesMap *S = dynamic_cast<StatesMap *>(mdp->get_states());
+		ActionsMap *A = dynamic_cast<ActionsMap *>(mdp->get_actions());
+		StatesMap *arrayS = dynamic_cast<StatesMap *>(arrayMDP->get_states());
+
+		bool valid = (arrayPIExact.get_V().size() == S->get_num_states());
+		for (unsigned int i = 0; valid && i < S->get_num_states(); i++) {
+			State *s = S->get_state(i);
+			State *arrayState = arrayS->get_state(i);
+			IndexedAction *arrayAction = dynamic_cast<IndexedAction *>(arrayPolicyMap->get(arrayState));
+
+			valid = (std::fabs(piExact.get_V().at(s) - arrayPIExact.get_V().at(arrayState)) < 1e-6) &&
+					(arrayAction != nullptr) && (A->get_action(arrayAction->get_index()) == policyMap->get(s));
+		}
+
+		delete arrayPolicyMap;
+
+		if (valid) {
+			std::cout << " Success." << std::endl;
+			numSuccesses++;
+		} else {
+			std::cout << " Failure." << std::endl;
+		}
+	} catch (const CoreException &err) {
+		std::cout << " Failure." << std::endl;
+	} catch (const PolicyException &err) {
+		std::cout << " Failure." << std::endl;
+	}
+
+	if (policyMap != nullptr) {
+		delete policyMap;
+	}
+	policyMap = nullptr;
+
+	std::cout << "MDP: Solving 'grid_world_infinite_horizon.mdp' as arrays with state-dependent actions...";
+
+	try {
+		if (arrayMDP == nullptr) {
+			throw CoreException();
+		}
+
+		// Remove the first action from every other state, in both the original and the converted actions.
+		StatesMap *S = dynamic_cast<StatesMap *>(mdp->get_states());
+		ActionsMap *A = dynamic_cast<ActionsMap *>(mdp->get_actions());
+		StatesMap *arrayS = dynamic_cast<StatesMap *>(arrayMDP->get_states());
+		ActionsMap *arrayA = dynamic_cast<ActionsMap *>(arrayMDP->get_actions());
+
+		for (unsigned int i = 0; i < S->get_num_states(); i += 2) {
+			std::vector<Action *> available;
+			std::vector<Action *> arrayAvailable;
+			for (unsigned int j = 1; j < A->get_num_actions(); j++) {
+				available.push_back(A->get_action(j));
+				arrayAvailable.push_back(arrayA->get_action(j));
+			}
+			A->set_available(S->get_state(i), available);
+			arrayA->set_available(arrayS->get_state(i), arrayAvailable);
+		}
+
+		MDPValueIteration arrayVI;
+		policyMap = vi.solve(mdp);
+		PolicyMap *arrayPolicyMap = arrayVI.solve(arrayMDP);
+
+		bool valid = (arrayVI.get_V().size() == S->get_num_states());
+		for (unsigned int i = 0; valid && i < S->get_num_states(); i++) {
+			State *s = S->get_state(i);
+			State *arrayState = arrayS->get_state(i);
+			IndexedAction *arrayAction = dynamic_cast<IndexedAction *>(arrayPolicyMap->get(arrayState));
+
+			valid = (std::fabs(vi.get_V().at(s) - arrayVI.get_V().at(arrayState)) < 1e-6) &&
+					(arrayAction != nullptr) && (A->get_action(arrayAction->get_index()) == policyMap->get(s)) &&
+					(i % 2 == 1 || arrayAction->get_index() != 0);
+		}
+
+		delete arrayPolicyMap;
+
+		A->reset_available();
+		arrayA->reset_available();
+
+		if (valid) {
+			std::cout << " Success." << std::endl;
+			numSuccesses++;
+		} else {
+			std::cout << " Failure." << std::endl;
+		}
+	} catch (const CoreException &err) {
+		std::cout << " Failure." << std::endl;
+	} catch (const PolicyException &err) {
+		std::cout << " Failure." << std::endl;
+	}
+
+	if (policyMap != nullptr) {
+		delete policyMap;
+	}
+	policyMap = nullptr;
+
+	if (arrayMDP != nullptr) {
+		delete arrayMDP;
+	}
+	arrayMDP = nullptr;
+
+	std::cout << "MDP: Building the successors and probabilities of 'grid_world_infinite_horizon.mdp'...";
+
+	try {
+		StatesMap *S = dynamic_cast<StatesMap *>(mdp->get_states());
+		ActionsMap *A = dynamic_cast<ActionsMap *>(mdp->get_actions());
+		StateTransitions *T = dynamic_cast<StateTransitions *>(mdp->get_state_transitions());
+
+		T->build_successors(S, A);
+
+		// Every successor must have its nonzero probability, and every nonzero probability must be listed.
+		bool valid = true;
+		for (auto state : *S) {
+			for (auto action : *A) {
+				State *s = resolve(state);
+				Action *a = resolve(action);
+
+				const std::vector<State *> &succ = T->successors(S, s, a);
+				const std::vector<float> &prob = T->probabilities(S, s, a);
+
+				unsigned int numNonZero = 0;
+				for (auto nextState : *S) {
+					if (T->get(s, a, resolve(nextState)) > 0.0) {
+						numNonZero++;
+					}
+				}
+
+				valid = valid && (succ.size() == numNonZero) && (prob.size() == numNonZero);
+				for (unsigned int i = 0; valid && i < succ.size(); i++) {
+					valid = (prob[i] > 0.0f) && (std::fabs(prob[i] - T->get(s, a, succ[i])) < 1e-6);
+				}
+			}
+		}
+
+		if (valid) {
+			std::cout << " Success." << std::endl;
+			numSuccesses++;
+		} else {
+			std::cout << " Failure." << std::endl;
+		}
+	} catch (const StateTransitionException &err) {
+		std::cout << " Failure." << std::endl;
+	}
+
+	std::cout << "MDP: Solving a frozen 'grid_world_infinite_horizon.mdp' with MDPValueIteration in several threads...";
+
+	try {
+		policyMap = vi.solve(mdp);
+		mdp->freeze();
+
+		// Every thread shares the one frozen MDP, with its own solver.
+		PolicyMap *threadPolicyMaps[4];
+		std::vector<std::thread> threads;
+		for (unsigned int i = 0; i < 4; i++) {
+			threadPolicyMaps[i] = nullptr;
+			threads.push_back(std::thread([mdp](PolicyMap **threadPolicyMap) {
+				MDPValueIteration threadVI;
+				*threadPolicyMap = threadVI.solve(mdp);
+			}, &threadPolicyMaps[i]));
+		}
+		for (std::thread &thread : threads) {
+			thread.join();
+		}
+
+		bool valid = mdp->is_frozen();
+		StatesMap *S = dynamic_cast<StatesMap *>(mdp->get_states());
+		for (unsigned int i = 0; i < 4; i++) {
+			for (auto state : *S) {
+				valid = valid && (threadPolicyMaps[i] != nullptr) &&
+						(policyMap->get(resolve(state)) == threadPolicyMaps[i]->get(resolve(state)));
+			}
+			delete threadPolicyMaps[i];
+		}
+
+		// Modifying a frozen model is an error.
+		try {
+			mdp->get_state_transitions()->set(nullptr, nullptr, nullptr, 1.0);
+			valid = false;
+		} catch (const StateTransitionException &err) { }
+
+		if (valid) {
+			std::cout << " Success." << std::endl;
+			numSuccesses++;
+		} else {
+			std::cout << " Failure." << std::endl;
+		}
+	} catch (const CoreException &err) {
+		std::cout << " Failure." << std::endl;
+	} catch (const StateTransitionException &err) {
+		std::cout << " Failure." << std::endl;
+	} catch (const PolicyException &err) {
+		std::cout << " Failure." << std::endl;
+	}
+
+	if (policyMap != nullptr) {
+		delete policyMap;
+	}
+	policyMap = nullptr;
+
 	delete mdp;
 	mdp = nullptr;
 
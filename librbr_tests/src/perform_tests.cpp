@@ -30,7 +30,7 @@ int main(int argc, char *argv[])
 {
 	std::cout << "Performing Tests..." << std::endl;
 
-	const int numTests = 12;
+	const int numTests = 15;
 
 	int numSuccesses[numTests];
 	for (int i = 0; i < numTests; i++) {
@@ -52,6 +52,10 @@ int main(int argc, char *argv[])
 
 	numSuccesses[10] = test_mdp();
 	numSuccesses[11] = test_pomdp();
+	numSuccesses[12] = test_dec_pomdp();
+
+	numSuccesses[13] = test_raw_file();
+	numSuccesses[14] = test_pomdp_file();
 
 	std::cout << "Agents:                 " << numSuccesses[0] << " / " << NUM_AGENT_TESTS << std::endl;
 	std::cout << "States:                 " << numSuccesses[1] << " / " << NUM_STATE_TESTS << std::endl;
@@ -65,11 +69,15 @@ int main(int argc, char *argv[])
 	std::cout << "Utilities:              " << numSuccesses[9] << " / " << NUM_UTILITIES_TESTS << std::endl;
 	std::cout << "MDP:                    " << numSuccesses[10] << " / " << NUM_MDP_TESTS << std::endl;
 	std::cout << "POMDP:                  " << numSuccesses[11] << " / " << NUM_POMDP_TESTS << std::endl;
+	std::cout << "DecPOMDP:               " << numSuccesses[12] << " / " << NUM_DEC_POMDP_TESTS << std::endl;
+	std::cout << "RawFile:                " << numSuccesses[13] << " / " << NUM_RAW_FILE_TESTS << std::endl;
+	std::cout << "POMDPFile:              " << numSuccesses[14] << " / " << NUM_POMDP_FILE_TESTS << std::endl;
 
 	int total = 0;
 	int totalPossible = NUM_AGENT_TESTS + NUM_STATE_TESTS + NUM_ACTION_TESTS + NUM_OBSERVATION_TESTS +
 			NUM_REWARD_TESTS + NUM_STATE_TRANSITION_TESTS + NUM_OBSERVATION_TRANSITION_TESTS +
-			NUM_POLICY_TESTS + NUM_UNIFIED_FILE_TESTS + NUM_UTILITIES_TESTS + NUM_MDP_TESTS + NUM_POMDP_TESTS;
+			NUM_POLICY_TESTS + NUM_UNIFIED_FILE_TESTS + NUM_UTILITIES_TESTS + NUM_MDP_TESTS + NUM_POMDP_TESTS +
+			NUM_DEC_POMDP_TESTS + NUM_RAW_FILE_TESTS + NUM_POMDP_FILE_TESTS;
 	for (int i = 0; i < numTests; i++) {
 		total += numSuccesses[i];
 	}
@@ -25,8 +25,12 @@
 #include "../../include/perform_tests.h"
 
 #include <iostream>
+#include <vector>
+#include <cmath>
 
 #include "../../../librbr/include/management/unified_file.h"
+#include "../../../librbr/include/management/conversion.h"
+#include "../../../librbr/include/management/policy_cache.h"
 
 #include "../../../librbr/include/pomdp/pomdp.h"
 #include "../../../librbr/include/pomdp/pomdp_value_iteration.h"
@@ -34,6 +38,10 @@
 
 #include "../../../librbr/include/core/states/belief_state.h"
 #include "../../../librbr/include/core/states/states_map.h"
+#include "../../../librbr/include/core/actions/indexed_action.h"
+#include "../../../librbr/include/core/state_transitions/state_transitions_array.h"
+#include "../../../librbr/include/core/observation_transitions/observation_transitions_array.h"
+#include "../../../librbr/include/core/rewards/saso_rewards.h"
 
 #include "../../../librbr/include/core/core_exception.h"
 #include "../../../librbr/include/core/states/state_exception.h"
@@ -272,6 +280,46 @@ int test_pomdp()
 		std::cout << " Failure." << std::endl;
 	}
 
+	std::cout << "POMDP: Solving 'tiger_infinite.pomdp' with POMDPPBVI and a PolicyCache...";
+
+	PolicyCache cache("tmp");
+	PolicyAlphaVectors *solvedAlphaVectors = nullptr;
+	PolicyAlphaVectors *cachedAlphaVectors = nullptr;
+
+	try {
+		// Both solves have the same model and parameters, so at least the second is a cache hit.
+		pbvi.set_policy_cache(&cache);
+		solvedAlphaVectors = pbvi.solve(pomdp);
+		cachedAlphaVectors = pbvi.solve(pomdp);
+
+		StatesMap *states = dynamic_cast<StatesMap *>(pomdp->get_states());
+		BeliefState b;
+		for (auto s : *states) {
+			b.set(resolve(s), 1.0 / (double)states->get_num_states());
+		}
+
+		if (solvedAlphaVectors->get(&b) == cachedAlphaVectors->get(&b) &&
+				solvedAlphaVectors->compute_value(&b) == cachedAlphaVectors->compute_value(&b)) {
+			std::cout << " Success." << std::endl;
+			numSuccesses++;
+		} else {
+			std::cout << " Failure." << std::endl;
+		}
+	} catch (const CoreException &err) {
+		std::cout << " Failure." << std::endl;
+	} catch (const PolicyException &err) {
+		std::cout << " Failure." << std::endl;
+	}
+
+	pbvi.set_policy_cache(nullptr);
+
+	if (solvedAlphaVectors != nullptr) {
+		delete solvedAlphaVectors;
+	}
+	if (cachedAlphaVectors != nullptr) {
+		delete cachedAlphaVectors;
+	}
+
 	// Save and destroy the alpha vectors. Also, We are done with the tiger problem, so destroy it.
 	if (pomdp != nullptr) {
 		StatesMap *states = dynamic_cast<StatesMap *>(pomdp->get_states());
@@ -283,5 +331,177 @@ int test_pomdp()
 	delete policyAlphaVectors;
 	policyAlphaVectors = nullptr;
 
+	std::cout << "POMDP: Converting 'tiger_finite.pomdp' to arrays...";
+
+	POMDP *arrayPOMDP = nullptr;
+	std::vector<State *> originalStates;
+	std::vector<Action *> originalActions;
+	std::vector<Observation *> originalObservations;
+
+	try {
+		if (file.load("resources/pomdp/tiger_finite.pomdp")) {
+			throw CoreException();
+		}
+		pomdp = file.get_pomdp();
+		arrayPOMDP = convert_map_to_array(pomdp, originalStates, originalActions, originalObservations);
+
+		StatesMap *S = dynamic_cast<StatesMap *>(arrayPOMDP->get_states());
+		ActionsMap *A = dynamic_cast<ActionsMap *>(arrayPOMDP->get_actions());
+		ObservationsMap *Z = dynamic_cast<ObservationsMap *>(arrayPOMDP->get_observations());
+
+		StateTransitionsArray *T = dynamic_cast<StateTransitionsArray *>(arrayPOMDP->get_state_transitions());
+		ObservationTransitionsArray *O =
+				dynamic_cast<ObservationTransitionsArray *>(arrayPOMDP->get_observation_transitions());
+		SASORewards *R = dynamic_cast<SASORewards *>(arrayPOMDP->get_rewards());
+		SASORewards *originalR = dynamic_cast<SASORewards *>(pomdp->get_rewards());
+
+		bool valid = (T != nullptr && O != nullptr && R != nullptr &&
+				originalStates.size() == S->get_num_states() && originalActions.size() == A->get_num_actions() &&
+				originalObservations.size() == Z->get_num_observations());
+
+		// Every value must match that of the original objects of the indexes.
+		for (unsigned int s = 0; valid && s < originalStates.size(); s++) {
+			for (unsigned int a = 0; valid && a < originalActions.size(); a++) {
+				for (unsigned int sp = 0; valid && sp < originalStates.size(); sp++) {
+					valid = (T->get(S->get(s), A->get(a), S->get(sp)) == (float)pomdp->get_state_transitions()->get(
+							originalStates[s], originalActions[a], originalStates[sp]));
+
+					for (unsigned int z = 0; valid && z < originalObservations.size(); z++) {
+						valid = (R->get(S->get(s), A->get(a), S->get(sp), Z->get(z)) == (float)originalR->get(
+								originalStates[s], originalActions[a], originalStates[sp], originalObservations[z]));
+					}
+				}
+
+				for (unsigned int z = 0; valid && z < originalObservations.size(); z++) {
+					valid = (O->get(A->get(a), S->get(s), Z->get(z)) == (float)pomdp->get_observation_transitions()->get(
+							originalActions[a], originalStates[s], originalObservations[z]));
+				}
+			}
+		}
+
+		if (valid) {
+			std::cout << " Success." << std::endl;
+			numSuccesses++;
+		} else {
+			std::cout << " Failure." << std::endl;
+		}
+	} catch (const CoreException &err) {
+		std::cout << " Failure." << std::endl;
+	}
+
+	std::cout << "POMDP: Solving the converted 'tiger_finite.pomdp' with POMDPValueIteration...";
+
+	try {
+		POMDPValueIteration originalVI;
+		POMDPValueIteration arrayVI;
+
+		PolicyAlphaVectors *originalPolicy = originalVI.solve(pomdp);
+		PolicyAlphaVectors *arrayPolicy = arrayVI.solve(arrayPOMDP);
+
+		StatesMap *S = dynamic_cast<StatesMap *>(arrayPOMDP->get_states());
+
+		// The values and the actions, mapped back to the original actions, must match at a few beliefs.
+		bool valid = true;
+		double beliefs[3] = { 0.5, 0.25, 0.9 };
+
+		for (unsigned int i = 0; valid && i < 3; i++) {
+			BeliefState originalBelief;
+			BeliefState arrayBelief;
+
+			for (unsigned int s = 0; s < originalStates.size(); s++) {
+				double p = (s == 0) ? beliefs[i] : 1.0 - beliefs[i];
+				originalBelief.set(originalStates[s], p);
+				arrayBelief.set(S->get(s), p);
+			}
+
+			IndexedAction *a = dynamic_cast<IndexedAction *>(arrayPolicy->get(&arrayBelief));
+
+			valid = (std::fabs(originalPolicy->compute_value(&originalBelief) -
+						arrayPolicy->compute_value(&arrayBelief)) < 1e-4 &&
+					a != nullptr && originalActions[a->get_index()] == originalPolicy->get(&originalBelief));
+		}
+
+		delete originalPolicy;
+		delete arrayPolicy;
+
+		if (valid) {
+			std::cout << " Success." << std::endl;
+			numSuccesses++;
+		} else {
+			std::cout << " Failure." << std::endl;
+		}
+	} catch (const std::exception &err) {
+		std::cout << " Failure." << std::endl;
+	}
+
+	std::cout << "POMDP: Solving the converted 'tiger_finite.pomdp' with POMDPPBVI...";
+
+	try {
+		POMDPPBVI originalPBVI;
+		POMDPPBVI arrayPBVI;
+		originalPBVI.set_expansion_rule(POMDPPBVIExpansionRule::NONE);
+		arrayPBVI.set_expansion_rule(POMDPPBVIExpansionRule::NONE);
+
+		StatesMap *S = dynamic_cast<StatesMap *>(arrayPOMDP->get_states());
+
+		// Both expand the same belief points, of the original and the converted states.
+		double beliefs[3] = { 0.5, 0.25, 0.9 };
+		for (unsigned int i = 0; i < 3; i++) {
+			BeliefState *originalBelief = new BeliefState();
+			BeliefState *arrayBelief = new BeliefState();
+
+			for (unsigned int s = 0; s < originalStates.size(); s++) {
+				double p = (s == 0) ? beliefs[i] : 1.0 - beliefs[i];
+				originalBelief->set(originalStates[s], p);
+				arrayBelief->set(S->get(s), p);
+			}
+
+			originalPBVI.add_initial_belief_state(originalBelief);
+			arrayPBVI.add_initial_belief_state(arrayBelief);
+		}
+
+		PolicyAlphaVectors *originalPolicy = originalPBVI.solve(pomdp);
+		PolicyAlphaVectors *arrayPolicy = arrayPBVI.solve(arrayPOMDP);
+
+		bool valid = true;
+		for (unsigned int i = 0; valid && i < 3; i++) {
+			BeliefState originalBelief;
+			BeliefState arrayBelief;
+
+			for (unsigned int s = 0; s < originalStates.size(); s++) {
+				double p = (s == 0) ? beliefs[i] : 1.0 - beliefs[i];
+				originalBelief.set(originalStates[s], p);
+				arrayBelief.set(S->get(s), p);
+			}
+
+			IndexedAction *a = dynamic_cast<IndexedAction *>(arrayPolicy->get(&arrayBelief));
+
+			valid = (std::fabs(originalPolicy->compute_value(&originalBelief) -
+						arrayPolicy->compute_value(&arrayBelief)) < 1e-4 &&
+					a != nullptr && originalActions[a->get_index()] == originalPolicy->get(&originalBelief));
+		}
+
+		delete originalPolicy;
+		delete arrayPolicy;
+
+		if (valid) {
+			std::cout << " Success." << std::endl;
+			numSuccesses++;
+		} else {
+			std::cout << " Failure." << std::endl;
+		}
+	} catch (const std::exception &err) {
+		std::cout << " Failure." << std::endl;
+	}
+
+	if (pomdp != nullptr) {
+		delete pomdp;
+	}
+	pomdp = nullptr;
+
+	if (arrayPOMDP != nullptr) {
+		delete arrayPOMDP;
+	}
+
 	return numSuccesses;
 }
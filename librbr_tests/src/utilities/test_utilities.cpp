@@ -26,15 +26,253 @@
 
 #include <iostream>
 #include <tuple>
+#include <chrono>
+#include <deque>
+#include <string>
+#include <algorithm>
+#include <thread>
 #include <math.h>
+#include <stdlib.h>
+#include <string.h>
 
 #include "../../../librbr/include/utilities/a_star.h"
+#include "../../../librbr/include/utilities/ara_star.h"
+#include "../../../librbr/include/utilities/hda_star.h"
+#include "../../../librbr/include/utilities/mpsc_queue.h"
+#include "../../../librbr/include/utilities/lazy_table.h"
+#include "../../../librbr/include/utilities/table_index.h"
+#include "../../../librbr/include/utilities/indexed_heap.h"
+#include "../../../librbr/include/utilities/tokenizer.h"
+#include "../../../librbr/include/utilities/utility_exception.h"
+
+#include "../../../librbr/include/core/states/indexed_state.h"
+#include "../../../librbr/include/core/states/named_state.h"
+
+/**
+ * A hash for the knight problem's nodes.
+ */
+struct KnightHash {
+	/**
+	 * Compute the hash of a knight problem's node.
+	 * @param	node	The node (a position on the board).
+	 * @return	The hash value of the node.
+	 */
+	std::size_t operator()(const std::pair<int, int> &node) const {
+		return std::hash<int>()(node.first) * 31 + std::hash<int>()(node.second);
+	}
+};
+
+/**
+ * The width and height of the grid world used to benchmark A*.
+ */
+#define GRID_WORLD_SIZE 512
+
+/**
+ * Check if a cell in the benchmark grid world is blocked. Every eighth column is a wall with a
+ * single gap, alternating between the top and bottom rows, so paths must snake through it.
+ * @param	x	The column of the cell.
+ * @param	y	The row of the cell.
+ * @return	Returns @code{true} if the cell is blocked, @code{false} otherwise.
+ */
+static bool grid_world_blocked(int x, int y)
+{
+	if (x % 8 != 4) {
+		return false;
+	}
+
+	if ((x / 8) % 2 == 0) {
+		return y != GRID_WORLD_SIZE - 1;
+	} else {
+		return y != 0;
+	}
+}
+
+/**
+ * Generate the unblocked 4-connected neighbors of a cell in the benchmark grid world.
+ * @param	cell	The cell's index (y * GRID_WORLD_SIZE + x).
+ * @return	The indices of the neighboring cells.
+ */
+static std::vector<unsigned int> grid_world_successors(unsigned int cell)
+{
+	int x = cell % GRID_WORLD_SIZE;
+	int y = cell / GRID_WORLD_SIZE;
+
+	std::vector<unsigned int> result;
+	result.reserve(4);
+
+	int dx[4] = {1, -1, 0, 0};
+	int dy[4] = {0, 0, 1, -1};
+
+	for (int i = 0; i < 4; i++) {
+		int nx = x + dx[i];
+		int ny = y + dy[i];
+		if (nx >= 0 && nx < GRID_WORLD_SIZE && ny >= 0 && ny < GRID_WORLD_SIZE && !grid_world_blocked(nx, ny)) {
+			result.push_back(ny * GRID_WORLD_SIZE + nx);
+		}
+	}
+
+	return result;
+}
+
+/**
+ * The width and height of the swamp world used to test ARA*.
+ */
+#define SWAMP_WORLD_SIZE 64
+
+/**
+ * Check if a cell in the swamp world is in the swamp: a band between the start (top-left) and the
+ * goal (top-right) which is expensive to enter, but which the heuristic ignores.
+ * @param	cell	The cell's index (y * SWAMP_WORLD_SIZE + x).
+ * @return	Returns @code{true} if the cell is in the swamp, @code{false} otherwise.
+ */
+static bool swamp_world_swamp(unsigned int cell)
+{
+	int x = cell % SWAMP_WORLD_SIZE;
+	int y = cell / SWAMP_WORLD_SIZE;
+	return x >= 28 && x < 36 && y < 48;
+}
+
+/**
+ * The Manhattan distance between two cells in the swamp world.
+ * @param	cell	The cell's index.
+ * @param	goal	The goal's index.
+ * @return	The Manhattan distance between the cells.
+ */
+static double swamp_world_heuristic(unsigned int cell, unsigned int goal)
+{
+	return (double)(abs((int)(cell % SWAMP_WORLD_SIZE) - (int)(goal % SWAMP_WORLD_SIZE)) +
+			abs((int)(cell / SWAMP_WORLD_SIZE) - (int)(goal / SWAMP_WORLD_SIZE)));
+}
+
+/**
+ * The cost of moving between two cells in the swamp world: 20 to enter the swamp, 1 otherwise.
+ * @param	c1	The cell moved from.
+ * @param	c2	The cell moved to.
+ * @return	The cost of the move.
+ */
+static double swamp_world_cost(unsigned int c1, unsigned int c2)
+{
+	return swamp_world_swamp(c2) ? 20.0 : 1.0;
+}
+
+/**
+ * Generate the 4-connected neighbors of a cell in the swamp world.
+ * @param	cell	The cell's index.
+ * @return	The indices of the neighboring cells.
+ */
+static std::vector<unsigned int> swamp_world_successors(unsigned int cell)
+{
+	int x = cell % SWAMP_WORLD_SIZE;
+	int y = cell / SWAMP_WORLD_SIZE;
+
+	std::vector<unsigned int> result;
+
+	int dx[4] = {1, -1, 0, 0};
+	int dy[4] = {0, 0, 1, -1};
+
+	for (int i = 0; i < 4; i++) {
+		int nx = x + dx[i];
+		int ny = y + dy[i];
+		if (nx >= 0 && nx < SWAMP_WORLD_SIZE && ny >= 0 && ny < SWAMP_WORLD_SIZE) {
+			result.push_back(ny * SWAMP_WORLD_SIZE + nx);
+		}
+	}
+
+	return result;
+}
 
 int test_utilities() {
 	int numSuccesses = 0;
 
-	// TODO: Change AStar to be a class.
-	/*
+	std::cout << "Tokenizer: Splitting lines and parsing numbers...";
+
+	{
+		const char *text = "T : <a1  a2> : s1 :: 0.25 # c\r\n\n0.1 -2.5e-3\t1e400 .5 7x inf 123456789012345678901234 x";
+		Tokenizer tokenizer(text, strlen(text));
+
+		bool valid = true;
+		Token line;
+		Token items[3];
+
+		// The first line has its comment and line ending removed, and empty items are skipped.
+		valid = valid && tokenizer.next_line(line);
+		Tokenizer::strip_comment(line);
+		unsigned int numItems = Tokenizer::split_by_colon(line, items, 3);
+		valid = valid && (numItems == 4 && token_equals(items[0], "T") && token_equals(items[1], "<a1  a2>") &&
+				token_equals(items[2], "s1"));
+
+		Token remaining = items[1];
+		Token item;
+		valid = valid && Tokenizer::next_item(remaining, item) && token_equals(item, "a1  a2") &&
+				!Tokenizer::next_item(remaining, item);
+
+		valid = valid && tokenizer.next_line(line) && line.length == 0;
+
+		// Every number must be converted exactly as strtod converts it.
+		valid = valid && tokenizer.next_line(line) && Tokenizer::count_items(line) == 8;
+		remaining = line;
+		for (unsigned int i = 0; valid && i < 7; i++) {
+			Tokenizer::next_item(remaining, item);
+			std::string number = token_to_string(item);
+
+			double value = 0.0;
+			valid = Tokenizer::parse_double(item, value) && value == strtod(number.c_str(), nullptr);
+		}
+
+		double value = 0.0;
+		valid = valid && Tokenizer::next_item(remaining, item) && !Tokenizer::parse_double(item, value);
+		valid = valid && !tokenizer.next_line(line);
+
+		for (unsigned int i = 0; valid && i < 10000; i++) {
+			std::string number = std::to_string(rand() % 2000 - 1000) + "." + std::to_string(rand());
+			if (i % 3 == 0) {
+				number += "e" + std::to_string(rand() % 60 - 30);
+			}
+
+			Token token = {number.c_str(), (unsigned int)number.length()};
+			valid = Tokenizer::parse_double(token, value) && value == strtod(number.c_str(), nullptr);
+		}
+
+		int integer = 0;
+		Token integerToken = {"-42abc", 6};
+		valid = valid && Tokenizer::parse_int(integerToken, integer) && integer == -42;
+
+		if (valid) {
+			std::cout << " Success." << std::endl;
+			numSuccesses++;
+		} else {
+			std::cout << " Failure." << std::endl;
+		}
+	}
+
+	std::cout << "IndexedHeap: Sorting with decrease-key...";
+
+	IndexedHeap heap(3);
+	for (unsigned int i = 0; i < 100; i++) {
+		heap.push(i, (double)((i * 37) % 101), 0.0);
+	}
+	for (unsigned int i = 0; i < 100; i += 2) {
+		heap.update(i, heap.get_priority(i) - 50.0, 0.0);
+	}
+
+	bool sorted = (heap.size() == 100);
+	double previous = -1000.0;
+	while (!heap.empty()) {
+		double priority = heap.top_priority();
+		heap.pop();
+		if (priority < previous) {
+			sorted = false;
+		}
+		previous = priority;
+	}
+
+	if (sorted && !heap.contains(0)) {
+		std::cout << " Success." << std::endl;
+		numSuccesses++;
+	} else {
+		std::cout << " Failure." << std::endl;
+	}
+
 	// Setup the knight problem's functions.
 	auto knightHeuristic = [] (std::pair<int, int> node, std::pair<int, int> goal) {
 		return sqrt(pow((float)(node.first - goal.first), 2) + pow((float)(node.second - goal.second), 2));
@@ -57,35 +295,345 @@ int test_utilities() {
 		return nodes;
 	};
 
-	AStar<std::pair<int, int>> astar(knightHeuristic, knightCost, knightSuccessors);
+	AStar<std::pair<int, int>, KnightHash> astar(knightHeuristic, knightCost, knightSuccessors);
 
 	std::cout << "AStar: Solving Knight Problem #1...";
 	std::cout.flush();
 
 	std::pair<int, int> start(0, 0);
 	std::pair<int, int> goal(8, 19);
-	astar.solve(start, goal);
-	std::vector<std::pair<int, int> > solution = astar.get_path();
-
-	if (solution.size() == 12 &&
-			solution[0].first == 0 && solution[0].second == 0 &&
-			solution[1].first == 2 && solution[1].second == 1 &&
-			solution[2].first == 1 && solution[2].second == 3 &&
-			solution[3].first == 2 && solution[3].second == 5 &&
-			solution[4].first == 3 && solution[4].second == 7 &&
-			solution[5].first == 4 && solution[5].second == 9 &&
-			solution[6].first == 5 && solution[6].second == 11 &&
-			solution[7].first == 6 && solution[7].second == 13 &&
-			solution[8].first == 7 && solution[8].second == 15 &&
-			solution[9].first == 8 && solution[9].second == 17 &&
-			solution[10].first == 6 && solution[10].second == 18 &&
-			solution[11].first == 8 && solution[11].second == 19) {
+
+	try {
+		astar.solve(start, goal);
+		std::vector<std::pair<int, int> > solution = astar.get_path();
+
+		// The shortest path takes 11 moves; check that each step is a valid knight move.
+		bool valid = (solution.size() == 12 && solution.front() == start && solution.back() == goal &&
+				astar.get_path_cost() == 33.0);
+		for (unsigned int i = 1; valid && i < solution.size(); i++) {
+			int dx = abs(solution[i].first - solution[i - 1].first);
+			int dy = abs(solution[i].second - solution[i - 1].second);
+			valid = ((dx == 1 && dy == 2) || (dx == 2 && dy == 1));
+		}
+
+		if (valid) {
+			std::cout << " Success." << std::endl;
+			numSuccesses++;
+		} else {
+			std::cout << " Failure." << std::endl;
+		}
+	} catch (const UtilityException &err) {
+		std::cout << " Failure." << std::endl;
+	}
+
+	std::cout << "AStar: Solving the " << GRID_WORLD_SIZE << "x" << GRID_WORLD_SIZE << " grid world benchmark...";
+	std::cout.flush();
+
+	unsigned int gridStart = 0;
+	unsigned int gridGoal = GRID_WORLD_SIZE * GRID_WORLD_SIZE - 1;
+
+	// Compute the true shortest distance with a breadth-first search.
+	std::vector<int> distance(GRID_WORLD_SIZE * GRID_WORLD_SIZE, -1);
+	std::deque<unsigned int> frontier;
+	distance[gridStart] = 0;
+	frontier.push_back(gridStart);
+	while (!frontier.empty()) {
+		unsigned int cell = frontier.front();
+		frontier.pop_front();
+		for (unsigned int next : grid_world_successors(cell)) {
+			if (distance[next] < 0) {
+				distance[next] = distance[cell] + 1;
+				frontier.push_back(next);
+			}
+		}
+	}
+
+	auto gridHeuristic = [] (unsigned int cell, unsigned int goal) {
+		return (double)(abs((int)(cell % GRID_WORLD_SIZE) - (int)(goal % GRID_WORLD_SIZE)) +
+				abs((int)(cell / GRID_WORLD_SIZE) - (int)(goal / GRID_WORLD_SIZE)));
+	};
+
+	auto gridCost = [] (unsigned int c1, unsigned int c2) {
+		return 1.0;
+	};
+
+	AStar<unsigned int> gridAStar(gridHeuristic, gridCost, grid_world_successors);
+
+	try {
+		std::chrono::steady_clock::time_point begin = std::chrono::steady_clock::now();
+		gridAStar.solve(gridStart, gridGoal);
+		std::chrono::steady_clock::time_point end = std::chrono::steady_clock::now();
+
+		double seconds = std::chrono::duration<double>(end - begin).count();
+
+		if (gridAStar.get_path_cost() == (double)distance[gridGoal] &&
+				gridAStar.get_path().size() == (unsigned int)distance[gridGoal] + 1) {
+			std::cout << " Success. (" << gridAStar.get_num_nodes_expanded() << " expansions, " <<
+					(int)(gridAStar.get_num_nodes_expanded() / seconds) << " expansions/s)" << std::endl;
+			numSuccesses++;
+		} else {
+			std::cout << " Failure." << std::endl;
+		}
+	} catch (const UtilityException &err) {
+		std::cout << " Failure." << std::endl;
+	}
+
+	std::cout << "ARAStar: Improving paths on the swamp world...";
+	std::cout.flush();
+
+	ARAStar<unsigned int> arastar(swamp_world_heuristic, swamp_world_cost, swamp_world_successors);
+	arastar.set_weights(3.0, 0.5);
+
+	std::vector<std::pair<double, double> > published;
+	arastar.set_path_callback([&published] (const std::vector<unsigned int> &path, double cost, double bound) {
+		published.push_back(std::pair<double, double>(cost, bound));
+	});
+
+	try {
+		// The inflated heuristic first leads straight through the swamp (cost 215); the optimal path
+		// goes around it (cost 159). Neither the costs nor the bounds may ever get worse.
+		arastar.solve(0, SWAMP_WORLD_SIZE - 1);
+
+		bool valid = (published.size() >= 2 && published.front().first > 159.0 &&
+				arastar.get_path_cost() == 159.0 && arastar.get_suboptimality_bound() == 1.0 &&
+				arastar.get_path().size() == 160);
+		for (unsigned int i = 1; valid && i < published.size(); i++) {
+			valid = (published[i].first <= published[i - 1].first && published[i].second <= published[i - 1].second);
+		}
+		for (unsigned int i = 0; valid && i < published.size(); i++) {
+			valid = (published[i].first <= published[i].second * 159.0 + 1e-9);
+		}
+
+		if (valid) {
+			std::cout << " Success. (" << published.size() << " publications, first cost " << published.front().first <<
+					" with bound " << published.front().second << ")" << std::endl;
+			numSuccesses++;
+		} else {
+			std::cout << " Failure." << std::endl;
+		}
+	} catch (const UtilityException &err) {
+		std::cout << " Failure." << std::endl;
+	}
+
+	std::cout << "ARAStar: Stopping the grid world benchmark at a node budget...";
+	std::cout.flush();
+
+	ARAStar<unsigned int> gridARAStar(gridHeuristic, gridCost, grid_world_successors);
+	gridARAStar.set_weights(3.0, 0.5);
+
+	try {
+		// Without limits, the search must end with the optimal path.
+		gridARAStar.solve(gridStart, gridGoal);
+		bool valid = (gridARAStar.get_path_cost() == (double)distance[gridGoal] &&
+				gridARAStar.get_suboptimality_bound() == 1.0);
+		unsigned int fullExpansions = gridARAStar.get_num_nodes_expanded();
+
+		// With a budget, the search must stop early but still return a path within its bound.
+		gridARAStar.set_node_budget(fullExpansions / 2);
+		gridARAStar.solve(gridStart, gridGoal);
+		valid = valid && (gridARAStar.get_num_nodes_expanded() <= (int)(fullExpansions / 2) &&
+				gridARAStar.get_path().size() == (unsigned int)gridARAStar.get_path_cost() + 1 &&
+				gridARAStar.get_path_cost() >= (double)distance[gridGoal] &&
+				gridARAStar.get_path_cost() <= gridARAStar.get_suboptimality_bound() * distance[gridGoal]);
+
+		if (valid) {
+			std::cout << " Success. (" << fullExpansions << " expansions to optimal, bound " <<
+					gridARAStar.get_suboptimality_bound() << " at half)" << std::endl;
+			numSuccesses++;
+		} else {
+			std::cout << " Failure." << std::endl;
+		}
+	} catch (const UtilityException &err) {
+		std::cout << " Failure." << std::endl;
+	}
+
+	std::cout << "ARAStar: Stopping the grid world benchmark at a deadline...";
+	std::cout.flush();
+
+	// No path can be found in a microsecond, so the search must give up with an exception.
+	gridARAStar.set_node_budget(0);
+	gridARAStar.set_deadline(0.000001);
+
+	try {
+		gridARAStar.solve(gridStart, gridGoal);
+		std::cout << " Failure." << std::endl;
+	} catch (const UtilityException &err) {
+		std::cout << " Success." << std::endl;
+		numSuccesses++;
+	}
+
+	std::cout << "MPSCQueue: Receiving from concurrent producers...";
+	std::cout.flush();
+
+	MPSCQueue<std::pair<int, int> > queue;
+	std::vector<std::thread> producers;
+	for (int p = 0; p < 4; p++) {
+		producers.push_back(std::thread([&queue, p] () {
+			for (int i = 0; i < 10000; i++) {
+				queue.push(std::pair<int, int>(p, i));
+			}
+		}));
+	}
+
+	// Each producer's values must arrive exactly once and in order.
+	std::vector<int> nextValue(4, 0);
+	bool ordered = true;
+	int numReceived = 0;
+	while (numReceived < 40000 && ordered) {
+		std::pair<int, int> value;
+		if (queue.try_pop(value)) {
+			ordered = (value.second == nextValue[value.first]);
+			nextValue[value.first]++;
+			numReceived++;
+		} else {
+			std::this_thread::yield();
+		}
+	}
+	for (std::thread &producer : producers) {
+		producer.join();
+	}
+
+	std::pair<int, int> extra;
+	if (ordered && !queue.try_pop(extra)) {
 		std::cout << " Success." << std::endl;
 		numSuccesses++;
 	} else {
 		std::cout << " Failure." << std::endl;
 	}
-	*/
+
+	std::cout << "LazyTable: Inserting from concurrent threads...";
+	std::cout.flush();
+
+	// Every thread inserts into the same slots, over several pages; each slot must keep one object.
+	LazyTable<int> table;
+	table.resize(5000);
+	std::vector<std::vector<int *> > inserted(4, std::vector<int *>(3000, nullptr));
+	std::vector<std::thread> inserters;
+	for (int p = 0; p < 4; p++) {
+		inserters.push_back(std::thread([&table, &inserted, p] () {
+			for (int i = 0; i < 3000; i++) {
+				inserted[p][i] = table.insert(i, new int(i));
+			}
+		}));
+	}
+	for (std::thread &inserter : inserters) {
+		inserter.join();
+	}
+
+	bool consistent = (table.get_num_objects() == 3000 && table.get(4000) == nullptr);
+	for (int i = 0; consistent && i < 3000; i++) {
+		consistent = (table.get(i) != nullptr && *table.get(i) == i);
+		for (int p = 0; p < 4; p++) {
+			consistent = consistent && (inserted[p][i] == table.get(i));
+		}
+	}
+
+	if (consistent) {
+		std::cout << " Success." << std::endl;
+		numSuccesses++;
+	} else {
+		std::cout << " Failure." << std::endl;
+	}
+
+	std::cout << "TableIndex: Finding indexed and named states...";
+	std::cout.flush();
+
+	// Indexed states at their own index are found by index; otherwise, by a table of positions.
+	std::vector<State *> indexedStates;
+	std::vector<State *> namedStates;
+	for (unsigned int i = 0; i < 4; i++) {
+		indexedStates.push_back(new IndexedState(i));
+		namedStates.push_back(new NamedState("s" + std::to_string(i)));
+	}
+	std::reverse(namedStates.begin(), namedStates.end());
+
+	TableIndex<IndexedState, State> byIndex(indexedStates);
+	TableIndex<IndexedState, State> byPosition(namedStates);
+	State *missing = new NamedState("missing");
+
+	bool found = (byIndex.is_indexed() && !byPosition.is_indexed() && byPosition.find(missing) == 4 &&
+			byIndex.find(missing) == 4);
+	for (unsigned int i = 0; found && i < 4; i++) {
+		found = (byIndex.find(indexedStates[i]) == i && byPosition.find(namedStates[i]) == i);
+	}
+
+	if (found) {
+		std::cout << " Success." << std::endl;
+		numSuccesses++;
+	} else {
+		std::cout << " Failure." << std::endl;
+	}
+
+	for (unsigned int i = 0; i < 4; i++) {
+		delete indexedStates[i];
+		delete namedStates[i];
+	}
+	delete missing;
+
+	std::cout << "HDAStar: Solving Knight Problem #1 with 4 threads...";
+	std::cout.flush();
+
+	HDAStar<std::pair<int, int>, KnightHash> hdastar(knightHeuristic, knightCost, knightSuccessors, 4);
+
+	try {
+		hdastar.solve(start, goal);
+		std::vector<std::pair<int, int> > solution = hdastar.get_path();
+
+		bool valid = (solution.size() == 12 && solution.front() == start && solution.back() == goal &&
+				hdastar.get_path_cost() == 33.0);
+		for (unsigned int i = 1; valid && i < solution.size(); i++) {
+			int dx = abs(solution[i].first - solution[i - 1].first);
+			int dy = abs(solution[i].second - solution[i - 1].second);
+			valid = ((dx == 1 && dy == 2) || (dx == 2 && dy == 1));
+		}
+
+		if (valid) {
+			std::cout << " Success." << std::endl;
+			numSuccesses++;
+		} else {
+			std::cout << " Failure." << std::endl;
+		}
+	} catch (const UtilityException &err) {
+		std::cout << " Failure." << std::endl;
+	}
+
+	std::cout << "HDAStar: Solving the " << GRID_WORLD_SIZE << "x" << GRID_WORLD_SIZE << " grid world benchmark...";
+	std::cout.flush();
+
+	try {
+		bool valid = true;
+		std::vector<std::string> rates;
+
+		// Report the expansion rate as the number of threads grows (up to the number of cores).
+		unsigned int maxThreads = std::max(4u, std::thread::hardware_concurrency());
+		for (unsigned int numThreads = 1; valid && numThreads <= maxThreads; numThreads *= 2) {
+			HDAStar<unsigned int> gridHDAStar(gridHeuristic, gridCost, grid_world_successors, numThreads);
+
+			std::chrono::steady_clock::time_point begin = std::chrono::steady_clock::now();
+			gridHDAStar.solve(gridStart, gridGoal);
+			std::chrono::steady_clock::time_point end = std::chrono::steady_clock::now();
+
+			double seconds = std::chrono::duration<double>(end - begin).count();
+
+			valid = (gridHDAStar.get_path_cost() == (double)distance[gridGoal] &&
+					gridHDAStar.get_path().size() == (unsigned int)distance[gridGoal] + 1);
+			rates.push_back(std::to_string(numThreads) + " threads " +
+					std::to_string((int)(gridHDAStar.get_num_nodes_expanded() / seconds)) + " expansions/s");
+		}
+
+		if (valid) {
+			std::cout << " Success. (";
+			for (unsigned int i = 0; i < rates.size(); i++) {
+				std::cout << (i > 0 ? ", " : "") << rates[i];
+			}
+			std::cout << ")" << std::endl;
+			numSuccesses++;
+		} else {
+			std::cout << " Failure." << std::endl;
+		}
+	} catch (const UtilityException &err) {
+		std::cout << " Failure." << std::endl;
+	}
 
 	return numSuccesses;
 }
@@ -75,7 +75,7 @@ for d in directories:
 
 # Printing flags and directory wildcards.
 f.write('CC = g++\n' +
-        'CFLAGS = -std=c++11 -g\n' +
+        'CFLAGS = -std=c++11 -g -pthread\n' +
         'COINFLAGS = `pkg-config --cflags --libs Coin` ' +
         '`pkg-config --cflags --libs clp` ' +
         '`pkg-config --cflags --libs osi` ' +
@@ -88,7 +88,7 @@ f.write('tests: all.o ' +
         testdir + '/src/mdp/*.cpp ' +
         #testdir + '/src/ssp/*.cpp ' +
         testdir + '/src/pomdp/*.cpp ' +
-        #testdir + '/src/dec_pomdp/*.cpp' +
+        testdir + '/src/dec_pomdp/*.cpp ' +
         testdir + '/src/management/*.cpp ' +
         testdir + '/src/utilities/*.cpp\n')
 f.write('\tmkdir -p ' + testdir + '/obj\n')
@@ -97,7 +97,7 @@ f.write('\t$(CC) $(CFLAGS) -c -I.. ' +
         testdir + '/src/mdp/*.cpp ' +
         #testdir + '/src/ssp/*.cpp ' +
         testdir + '/src/pomdp/*.cpp ' +
-        #testdir + '/src/dec_pomdp/*.cpp' +
+        testdir + '/src/dec_pomdp/*.cpp ' +
         testdir + '/src/management/*.cpp ' +
         testdir + '/src/utilities/*.cpp ' +
         testdir + '/src/*.cpp\n')